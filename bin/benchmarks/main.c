@@ -0,0 +1,460 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/**
+ * Steady-state microbenchmarks for the encoder/decoder hot paths.
+ *
+ * Each benchmark repeats a single representative operation (decode a large
+ * header block, stream out a chunked body, Huffman-code an HPACK string,
+ * encode a masked websocket frame) and reports ns/op and MiB/s. Each loop is
+ * preceded by a warmup phase so lazy one-time initialization (CPU feature
+ * dispatch, static tables) and cold caches don't pollute the numbers.
+ *
+ * Run standalone with no arguments. Numbers from different commits on the
+ * same machine are directly comparable.
+ */
+
+#include <aws/http/http.h>
+#include <aws/http/request_response.h>
+
+#include <aws/http/private/h1_decoder.h>
+#include <aws/http/private/h1_encoder.h>
+#include <aws/http/private/hpack.h>
+#include <aws/http/private/websocket_encoder.h>
+#include <aws/http/private/websocket_mask.h>
+
+#include <aws/common/clock.h>
+#include <aws/io/stream.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#ifdef _MSC_VER
+#    pragma warning(disable : 4204) /* Declared initializers */
+#    pragma warning(disable : 4221) /* Local var in declared initializer */
+#endif
+
+/* Run each timed loop for about this long. Long enough that per-iteration
+ * timer overhead is noise, short enough that the full suite stays quick. */
+#define BENCHMARK_WARMUP_NS (250ULL * 1000 * 1000)
+#define BENCHMARK_MEASURE_NS (1000ULL * 1000 * 1000)
+
+typedef int(benchmark_iteration_fn)(void *ctx);
+
+static int s_run_benchmark(
+    const char *name,
+    benchmark_iteration_fn *iteration,
+    void *ctx,
+    size_t bytes_per_iteration) {
+
+    uint64_t start;
+    uint64_t now;
+
+    aws_high_res_clock_get_ticks(&start);
+    do {
+        if (iteration(ctx)) {
+            goto error;
+        }
+        aws_high_res_clock_get_ticks(&now);
+    } while (now - start < BENCHMARK_WARMUP_NS);
+
+    uint64_t iterations = 0;
+    aws_high_res_clock_get_ticks(&start);
+    do {
+        if (iteration(ctx)) {
+            goto error;
+        }
+        ++iterations;
+        aws_high_res_clock_get_ticks(&now);
+    } while (now - start < BENCHMARK_MEASURE_NS);
+
+    uint64_t elapsed_ns = now - start;
+    double ns_per_op = (double)elapsed_ns / (double)iterations;
+    double bytes_per_sec = ((double)bytes_per_iteration * (double)iterations) / ((double)elapsed_ns / 1e9);
+    printf(
+        "%-32s %10" PRIu64 " ops %12.1f ns/op %10.1f MiB/s\n",
+        name,
+        iterations,
+        ns_per_op,
+        bytes_per_sec / (1024.0 * 1024.0));
+    return AWS_OP_SUCCESS;
+
+error:
+    fprintf(stderr, "%s: iteration failed with error %s\n", name, aws_error_debug_str(aws_last_error()));
+    return AWS_OP_ERR;
+}
+
+/**********************************************************************************************************************
+ * HTTP/1.1 decoder: large response header block.
+ *********************************************************************************************************************/
+
+/* Modeled on a storage-service GET response: long opaque ids, signed values, lots of x- headers. */
+static const char *s_large_response =
+    "HTTP/1.1 200 OK\r\n"
+    "x-amz-id-2: 9WzmBkLuQvYnSrL9z1pSlMLmBm9sWs0rzRANpsRjTwn0ph1erJK0GW9cu2mPmHQ8LoSHRnB2c4M=\r\n"
+    "x-amz-request-id: 8A6F7C2D5E4B3A19\r\n"
+    "x-amz-replication-status: COMPLETED\r\n"
+    "x-amz-server-side-encryption: aws:kms\r\n"
+    "x-amz-server-side-encryption-aws-kms-key-id: arn:aws:kms:us-west-2:123456789012:key/"
+    "1a2b3c4d-5e6f-7a8b-9c0d-1e2f3a4b5c6d\r\n"
+    "x-amz-storage-class: INTELLIGENT_TIERING\r\n"
+    "x-amz-version-id: 3HL4kqtJvjVBH40Nrjfkd9lkjasdf8V2d\r\n"
+    "x-amz-meta-origin: upload-service-prod-pdx-7\r\n"
+    "x-amz-meta-sha256: e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855\r\n"
+    "Date: Wed, 27 Mar 2019 12:00:00 GMT\r\n"
+    "Last-Modified: Tue, 26 Mar 2019 23:59:59 GMT\r\n"
+    "ETag: \"fba9dede5f27731c9771645a39863328\"\r\n"
+    "Cache-Control: max-age=31536000, immutable\r\n"
+    "Expires: Thu, 26 Mar 2020 12:00:00 GMT\r\n"
+    "Vary: Accept-Encoding, Origin\r\n"
+    "Accept-Ranges: bytes\r\n"
+    "Content-Type: application/octet-stream\r\n"
+    "Content-Disposition: attachment; filename=\"quarterly-report-2019-q1-final-v2.bin\"\r\n"
+    "Server: AmazonS3\r\n"
+    "Connection: keep-alive\r\n"
+    "Content-Length: 0\r\n"
+    "\r\n";
+
+struct decoder_benchmark_ctx {
+    struct aws_h1_decoder *decoder;
+    struct aws_byte_cursor message;
+    size_t sink; /* consumed by callbacks so the work can't be optimized away */
+};
+
+static int s_decoder_on_header(const struct aws_http_decoded_header *header, void *user_data) {
+    struct decoder_benchmark_ctx *ctx = user_data;
+    ctx->sink += header->name_data.len + header->value_data.len;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_decoder_on_body(const struct aws_byte_cursor *data, bool finished, void *user_data) {
+    (void)finished;
+    struct decoder_benchmark_ctx *ctx = user_data;
+    ctx->sink += data->len;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_decoder_on_response(int status_code, void *user_data) {
+    (void)status_code;
+    (void)user_data;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_decoder_on_done(void *user_data) {
+    (void)user_data;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_benchmark_h1_decode_iteration(void *arg) {
+    struct decoder_benchmark_ctx *ctx = arg;
+    struct aws_byte_cursor data = ctx->message;
+    /* Decoder resets itself after each complete message. */
+    return aws_h1_decode(ctx->decoder, &data);
+}
+
+static int s_benchmark_h1_decode(struct aws_allocator *allocator) {
+    struct decoder_benchmark_ctx ctx = {
+        .message = aws_byte_cursor_from_c_str(s_large_response),
+    };
+
+    struct aws_h1_decoder_params params = {
+        .alloc = allocator,
+        .is_decoding_requests = false,
+        .user_data = &ctx,
+        .vtable =
+            {
+                .on_header = s_decoder_on_header,
+                .on_body = s_decoder_on_body,
+                .on_response = s_decoder_on_response,
+                .on_done = s_decoder_on_done,
+            },
+    };
+    ctx.decoder = aws_h1_decoder_new(&params);
+    if (!ctx.decoder) {
+        return AWS_OP_ERR;
+    }
+
+    int err = s_run_benchmark("h1_decode_response_headers", s_benchmark_h1_decode_iteration, &ctx, ctx.message.len);
+
+    aws_h1_decoder_destroy(ctx.decoder);
+    return err;
+}
+
+/**********************************************************************************************************************
+ * HTTP/1.1 encoder: chunked request body.
+ *********************************************************************************************************************/
+
+struct encoder_benchmark_ctx {
+    struct aws_h1_encoder encoder;
+    struct aws_h1_encoder_message message;
+    struct aws_input_stream *body_stream;
+    struct aws_byte_buf out_buf;
+};
+
+static int s_benchmark_h1_encode_chunked_iteration(void *arg) {
+    struct encoder_benchmark_ctx *ctx = arg;
+
+    if (aws_input_stream_seek(ctx->body_stream, 0, AWS_SSB_BEGIN)) {
+        return AWS_OP_ERR;
+    }
+    if (aws_h1_encoder_start_message(&ctx->encoder, &ctx->message, NULL)) {
+        return AWS_OP_ERR;
+    }
+    while (aws_h1_encoder_is_message_in_progress(&ctx->encoder)) {
+        ctx->out_buf.len = 0;
+        if (aws_h1_encoder_process(&ctx->encoder, &ctx->out_buf)) {
+            return AWS_OP_ERR;
+        }
+    }
+    return AWS_OP_SUCCESS;
+}
+
+static int s_benchmark_h1_encode_chunked(struct aws_allocator *allocator) {
+    enum { BODY_SIZE = 16 * 1024 };
+
+    int err = AWS_OP_ERR;
+    struct encoder_benchmark_ctx ctx;
+    AWS_ZERO_STRUCT(ctx);
+
+    struct aws_byte_buf body_buf;
+    if (aws_byte_buf_init(&body_buf, allocator, BODY_SIZE)) {
+        return AWS_OP_ERR;
+    }
+    for (size_t i = 0; i < BODY_SIZE; ++i) {
+        body_buf.buffer[i] = (uint8_t)('a' + (i % 26));
+    }
+    body_buf.len = BODY_SIZE;
+
+    struct aws_byte_cursor body_cursor = aws_byte_cursor_from_buf(&body_buf);
+    ctx.body_stream = aws_input_stream_new_from_cursor(allocator, &body_cursor);
+    if (!ctx.body_stream) {
+        goto clean_up;
+    }
+
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    if (!request) {
+        goto clean_up;
+    }
+    bool request_ok = !aws_http_message_set_request_method(request, aws_byte_cursor_from_c_str("PUT")) &&
+                      !aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/upload")) &&
+                      !aws_http_message_add_header(
+                          request,
+                          (struct aws_http_header){
+                              .name = aws_byte_cursor_from_c_str("Host"),
+                              .value = aws_byte_cursor_from_c_str("example.com"),
+                          }) &&
+                      !aws_http_message_add_header(
+                          request,
+                          (struct aws_http_header){
+                              .name = aws_byte_cursor_from_c_str("Transfer-Encoding"),
+                              .value = aws_byte_cursor_from_c_str("chunked"),
+                          });
+    if (request_ok) {
+        aws_http_message_set_body_stream(request, ctx.body_stream);
+        request_ok = !aws_h1_encoder_message_init_from_request(&ctx.message, allocator, request);
+    }
+    aws_http_message_destroy(request);
+    if (!request_ok) {
+        goto clean_up;
+    }
+
+    aws_h1_encoder_init(&ctx.encoder, allocator);
+
+    /* Encoder sizes chunks to the space available, so a mid-sized buffer
+     * exercises the multi-chunk framing path. */
+    if (aws_byte_buf_init(&ctx.out_buf, allocator, 4 * 1024)) {
+        goto clean_up;
+    }
+
+    err = s_run_benchmark("h1_encode_chunked_body", s_benchmark_h1_encode_chunked_iteration, &ctx, BODY_SIZE);
+
+clean_up:
+    aws_byte_buf_clean_up(&ctx.out_buf);
+    aws_h1_encoder_clean_up(&ctx.encoder);
+    aws_h1_encoder_message_clean_up(&ctx.message);
+    aws_input_stream_destroy(ctx.body_stream);
+    aws_byte_buf_clean_up(&body_buf);
+    return err;
+}
+
+/**********************************************************************************************************************
+ * HPACK: Huffman string coding.
+ *********************************************************************************************************************/
+
+/* Typical header values: heavily weighted toward the short Huffman codes. */
+static const char *s_hpack_string =
+    "max-age=31536000, public, immutable; report-uri=\"https://telemetry.example.com/v1/csp?c=1\"; "
+    "sig=9WzmBkLuQvYnSrL9z1pSlMLmBm9sWs0rzRANpsRjTwn0";
+
+struct hpack_benchmark_ctx {
+    struct aws_hpack_context *context;
+    struct aws_byte_cursor plain;
+    struct aws_byte_buf encoded;
+    struct aws_byte_buf output;
+};
+
+static int s_benchmark_hpack_encode_iteration(void *arg) {
+    struct hpack_benchmark_ctx *ctx = arg;
+    ctx->output.len = 0;
+    struct aws_byte_cursor to_encode = ctx->plain;
+    return aws_hpack_encode_string(ctx->context, &to_encode, true /*huffman_encode*/, &ctx->output);
+}
+
+static int s_benchmark_hpack_decode_iteration(void *arg) {
+    struct hpack_benchmark_ctx *ctx = arg;
+    ctx->output.len = 0;
+    struct aws_byte_cursor to_decode = aws_byte_cursor_from_buf(&ctx->encoded);
+    return aws_hpack_decode_string(ctx->context, &to_decode, &ctx->output);
+}
+
+static int s_benchmark_hpack_strings(struct aws_allocator *allocator) {
+    int err = AWS_OP_ERR;
+    struct hpack_benchmark_ctx ctx = {
+        .plain = aws_byte_cursor_from_c_str(s_hpack_string),
+    };
+
+    ctx.context = aws_hpack_context_new(allocator, 8);
+    if (!ctx.context) {
+        return AWS_OP_ERR;
+    }
+    if (aws_byte_buf_init(&ctx.encoded, allocator, ctx.plain.len + 4) ||
+        aws_byte_buf_init(&ctx.output, allocator, ctx.plain.len + 4)) {
+        goto clean_up;
+    }
+
+    /* Pre-encode the corpus for the decode benchmark. */
+    struct aws_byte_cursor to_encode = ctx.plain;
+    if (aws_hpack_encode_string(ctx.context, &to_encode, true /*huffman_encode*/, &ctx.encoded)) {
+        goto clean_up;
+    }
+
+    err = s_run_benchmark("hpack_encode_string_huffman", s_benchmark_hpack_encode_iteration, &ctx, ctx.plain.len);
+    if (!err) {
+        err = s_run_benchmark("hpack_decode_string_huffman", s_benchmark_hpack_decode_iteration, &ctx, ctx.plain.len);
+    }
+
+clean_up:
+    aws_byte_buf_clean_up(&ctx.output);
+    aws_byte_buf_clean_up(&ctx.encoded);
+    aws_hpack_context_destroy(ctx.context);
+    return err;
+}
+
+/**********************************************************************************************************************
+ * Websocket: masked frame encoding.
+ *********************************************************************************************************************/
+
+enum { WEBSOCKET_PAYLOAD_SIZE = 16 * 1024 };
+
+struct websocket_benchmark_ctx {
+    struct aws_websocket_encoder encoder;
+    struct aws_byte_cursor payload;
+    struct aws_byte_cursor payload_progress;
+    struct aws_byte_buf out_buf;
+    uint8_t payload_storage[WEBSOCKET_PAYLOAD_SIZE];
+};
+
+static int s_websocket_stream_payload(struct aws_byte_buf *out_buf, void *user_data) {
+    struct websocket_benchmark_ctx *ctx = user_data;
+    size_t space = out_buf->capacity - out_buf->len;
+    size_t chunk_size = space < ctx->payload_progress.len ? space : ctx->payload_progress.len;
+    struct aws_byte_cursor chunk = aws_byte_cursor_advance(&ctx->payload_progress, chunk_size);
+    if (!aws_byte_buf_write_from_whole_cursor(out_buf, chunk)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+    return AWS_OP_SUCCESS;
+}
+
+static int s_benchmark_websocket_encode_iteration(void *arg) {
+    struct websocket_benchmark_ctx *ctx = arg;
+
+    ctx->payload_progress = ctx->payload;
+    struct aws_websocket_frame frame = {
+        .fin = true,
+        .masked = true,
+        .opcode = AWS_WEBSOCKET_OPCODE_TEXT,
+        .payload_length = ctx->payload.len,
+        .masking_key = {0x37, 0xfa, 0x21, 0x3d},
+    };
+    if (aws_websocket_encoder_start_frame(&ctx->encoder, &frame)) {
+        return AWS_OP_ERR;
+    }
+    while (aws_websocket_encoder_is_frame_in_progress(&ctx->encoder)) {
+        ctx->out_buf.len = 0;
+        if (aws_websocket_encoder_process(&ctx->encoder, &ctx->out_buf)) {
+            return AWS_OP_ERR;
+        }
+    }
+    return AWS_OP_SUCCESS;
+}
+
+static int s_benchmark_websocket_mask_iteration(void *arg) {
+    struct websocket_benchmark_ctx *ctx = arg;
+    static const uint8_t masking_key[4] = {0x37, 0xfa, 0x21, 0x3d};
+    aws_websocket_mask_apply(ctx->payload_storage, sizeof(ctx->payload_storage), masking_key, 0 /*phase*/);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_benchmark_websocket(struct aws_allocator *allocator) {
+    int err = AWS_OP_ERR;
+    struct websocket_benchmark_ctx ctx;
+    AWS_ZERO_STRUCT(ctx);
+
+    for (size_t i = 0; i < sizeof(ctx.payload_storage); ++i) {
+        ctx.payload_storage[i] = (uint8_t)('a' + (i % 26));
+    }
+    ctx.payload = aws_byte_cursor_from_array(ctx.payload_storage, sizeof(ctx.payload_storage));
+
+    aws_websocket_encoder_init(&ctx.encoder, s_websocket_stream_payload, &ctx);
+
+    if (aws_byte_buf_init(&ctx.out_buf, allocator, WEBSOCKET_PAYLOAD_SIZE + 16)) {
+        return AWS_OP_ERR;
+    }
+
+    err = s_run_benchmark(
+        "websocket_encode_masked_frame",
+        s_benchmark_websocket_encode_iteration,
+        &ctx,
+        sizeof(ctx.payload_storage));
+    if (!err) {
+        err = s_run_benchmark(
+            "websocket_mask_apply", s_benchmark_websocket_mask_iteration, &ctx, sizeof(ctx.payload_storage));
+    }
+
+    aws_byte_buf_clean_up(&ctx.out_buf);
+    return err;
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+
+    struct aws_allocator *allocator = aws_default_allocator();
+    aws_http_library_init(allocator);
+
+    int err = s_benchmark_h1_decode(allocator);
+    if (!err) {
+        err = s_benchmark_h1_encode_chunked(allocator);
+    }
+    if (!err) {
+        err = s_benchmark_hpack_strings(allocator);
+    }
+    if (!err) {
+        err = s_benchmark_websocket(allocator);
+    }
+
+    aws_http_library_clean_up();
+    return err ? 1 : 0;
+}
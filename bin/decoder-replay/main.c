@@ -0,0 +1,545 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/**
+ * Decoder throughput regression harness.
+ *
+ * Runs the h1 and h2 decoders over a fixed set of synthesized worst-case
+ * workloads (1-byte feeds, maximal header counts, tiny chunks) plus any
+ * corpus files given on the command line (ex: accumulated fuzz corpora),
+ * in a timed loop, and reports bytes/sec per workload class.
+ *
+ * With --baseline, results are compared against a checked-in baseline file
+ * and the run exits nonzero if any class regresses beyond the tolerance,
+ * so CI can use the corpora as a performance safety net rather than only
+ * for crash hunting. Record a baseline on a quiet machine with
+ * --write-baseline, and compare on the same machine; absolute numbers are
+ * not portable across hosts.
+ *
+ * Usage: decoder-replay [--h2] [--baseline FILE] [--write-baseline FILE]
+ *                       [--tolerance PCT] [corpus-file...]
+ */
+
+#include <aws/http/http.h>
+
+#include <aws/http/private/h1_decoder.h>
+#include <aws/http/private/h2_decoder.h>
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/clock.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#    pragma warning(disable : 4204) /* Declared initializers */
+#    pragma warning(disable : 4221) /* Local var in declared initializer */
+#endif
+
+/* Same loop shape as the microbenchmarks in bin/benchmarks: warm up first so
+ * lazy one-time initialization and cold caches don't pollute the numbers. */
+#define REPLAY_WARMUP_NS (250ULL * 1000 * 1000)
+#define REPLAY_MEASURE_NS (1000ULL * 1000 * 1000)
+
+#define MAX_RESULTS 16
+#define MAX_CORPUS_FILES 1024
+
+struct replay_result {
+    const char *name;
+    uint64_t bytes_per_sec;
+};
+
+static struct replay_result s_results[MAX_RESULTS];
+static size_t s_num_results;
+
+typedef int(replay_iteration_fn)(void *ctx);
+
+static int s_run_replay(const char *name, replay_iteration_fn *iteration, void *ctx, size_t bytes_per_iteration) {
+    uint64_t start;
+    uint64_t now;
+
+    aws_high_res_clock_get_ticks(&start);
+    do {
+        if (iteration(ctx)) {
+            goto error;
+        }
+        aws_high_res_clock_get_ticks(&now);
+    } while (now - start < REPLAY_WARMUP_NS);
+
+    uint64_t iterations = 0;
+    aws_high_res_clock_get_ticks(&start);
+    do {
+        if (iteration(ctx)) {
+            goto error;
+        }
+        ++iterations;
+        aws_high_res_clock_get_ticks(&now);
+    } while (now - start < REPLAY_MEASURE_NS);
+
+    uint64_t elapsed_ns = now - start;
+    double bytes_per_sec = ((double)bytes_per_iteration * (double)iterations) / ((double)elapsed_ns / 1e9);
+
+    printf("%-24s %12.1f MiB/s\n", name, bytes_per_sec / (1024.0 * 1024.0));
+
+    if (s_num_results < MAX_RESULTS) {
+        s_results[s_num_results].name = name;
+        s_results[s_num_results].bytes_per_sec = (uint64_t)bytes_per_sec;
+        s_num_results++;
+    }
+    return AWS_OP_SUCCESS;
+
+error:
+    fprintf(stderr, "%s: iteration failed with error %s\n", name, aws_error_debug_str(aws_last_error()));
+    return AWS_OP_ERR;
+}
+
+/**********************************************************************************************************************
+ * h1 workload classes
+ *********************************************************************************************************************/
+
+static int s_h1_on_header(const struct aws_http_decoded_header *header, void *user_data) {
+    size_t *sink = user_data;
+    *sink += header->name_data.len + header->value_data.len;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_h1_on_body(const struct aws_byte_cursor *data, bool finished, void *user_data) {
+    (void)finished;
+    size_t *sink = user_data;
+    *sink += data->len;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_h1_on_response(int status_code, void *user_data) {
+    (void)status_code;
+    (void)user_data;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_h1_on_done(void *user_data) {
+    (void)user_data;
+    return AWS_OP_SUCCESS;
+}
+
+struct h1_replay_ctx {
+    struct aws_h1_decoder *decoder;
+    struct aws_byte_cursor message;
+    size_t feed_size; /* 0 = feed the whole message at once */
+    size_t sink;      /* consumed by callbacks so the work can't be optimized away */
+};
+
+static int s_h1_replay_iteration(void *arg) {
+    struct h1_replay_ctx *ctx = arg;
+    struct aws_byte_cursor remaining = ctx->message;
+
+    /* Decoder resets itself after each complete message. */
+    if (ctx->feed_size == 0) {
+        return aws_h1_decode(ctx->decoder, &remaining);
+    }
+
+    while (remaining.len) {
+        size_t feed = remaining.len < ctx->feed_size ? remaining.len : ctx->feed_size;
+        struct aws_byte_cursor chunk = aws_byte_cursor_advance(&remaining, feed);
+        if (aws_h1_decode(ctx->decoder, &chunk)) {
+            return AWS_OP_ERR;
+        }
+    }
+    return AWS_OP_SUCCESS;
+}
+
+static int s_run_h1_class(
+    struct aws_allocator *allocator,
+    const char *name,
+    struct aws_byte_cursor message,
+    size_t feed_size) {
+
+    struct h1_replay_ctx ctx = {
+        .message = message,
+        .feed_size = feed_size,
+    };
+
+    struct aws_h1_decoder_params params = {
+        .alloc = allocator,
+        .is_decoding_requests = false,
+        .user_data = &ctx.sink,
+        .vtable =
+            {
+                .on_header = s_h1_on_header,
+                .on_body = s_h1_on_body,
+                .on_response = s_h1_on_response,
+                .on_done = s_h1_on_done,
+            },
+    };
+    ctx.decoder = aws_h1_decoder_new(&params);
+    if (!ctx.decoder) {
+        return AWS_OP_ERR;
+    }
+
+    int err = s_run_replay(name, s_h1_replay_iteration, &ctx, message.len);
+
+    aws_h1_decoder_destroy(ctx.decoder);
+    return err;
+}
+
+/* Response with a maximal header count: many short fields, so per-header overhead dominates. */
+static int s_build_max_headers_message(struct aws_byte_buf *out, struct aws_allocator *allocator) {
+    enum { NUM_HEADERS = 100 };
+
+    if (aws_byte_buf_init(out, allocator, NUM_HEADERS * 32 + 64)) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_byte_cursor status = aws_byte_cursor_from_c_str("HTTP/1.1 200 OK\r\n");
+    aws_byte_buf_append_dynamic(out, &status);
+    for (size_t i = 0; i < NUM_HEADERS; ++i) {
+        char header[64];
+        int len = snprintf(header, sizeof(header), "x-header-%zu: value-%zu\r\n", i, i);
+        struct aws_byte_cursor header_cursor = aws_byte_cursor_from_array(header, (size_t)len);
+        if (aws_byte_buf_append_dynamic(out, &header_cursor)) {
+            return AWS_OP_ERR;
+        }
+    }
+    struct aws_byte_cursor end = aws_byte_cursor_from_c_str("Content-Length: 0\r\n\r\n");
+    return aws_byte_buf_append_dynamic(out, &end);
+}
+
+/* Chunked response of 1-byte chunks: maximal per-chunk framing overhead. */
+static int s_build_tiny_chunks_message(struct aws_byte_buf *out, struct aws_allocator *allocator) {
+    enum { NUM_CHUNKS = 2048 };
+
+    if (aws_byte_buf_init(out, allocator, NUM_CHUNKS * 8 + 128)) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_byte_cursor head = aws_byte_cursor_from_c_str("HTTP/1.1 200 OK\r\n"
+                                                             "Transfer-Encoding: chunked\r\n"
+                                                             "\r\n");
+    aws_byte_buf_append_dynamic(out, &head);
+    for (size_t i = 0; i < NUM_CHUNKS; ++i) {
+        struct aws_byte_cursor chunk = aws_byte_cursor_from_c_str("1\r\nz\r\n");
+        if (aws_byte_buf_append_dynamic(out, &chunk)) {
+            return AWS_OP_ERR;
+        }
+    }
+    struct aws_byte_cursor end = aws_byte_cursor_from_c_str("0\r\n\r\n");
+    return aws_byte_buf_append_dynamic(out, &end);
+}
+
+/* Modeled on a storage-service GET response: long values, lots of x- headers. */
+static const char *s_typical_response =
+    "HTTP/1.1 200 OK\r\n"
+    "x-amz-id-2: 9WzmBkLuQvYnSrL9z1pSlMLmBm9sWs0rzRANpsRjTwn0ph1erJK0GW9cu2mPmHQ8LoSHRnB2c4M=\r\n"
+    "x-amz-request-id: 8A6F7C2D5E4B3A19\r\n"
+    "Date: Wed, 27 Mar 2019 12:00:00 GMT\r\n"
+    "Last-Modified: Tue, 26 Mar 2019 23:59:59 GMT\r\n"
+    "ETag: \"fba9dede5f27731c9771645a39863328\"\r\n"
+    "Accept-Ranges: bytes\r\n"
+    "Content-Type: application/octet-stream\r\n"
+    "Server: AmazonS3\r\n"
+    "Content-Length: 0\r\n"
+    "\r\n";
+
+/**********************************************************************************************************************
+ * h2 workload class
+ *********************************************************************************************************************/
+
+struct h2_replay_ctx {
+    struct aws_allocator *allocator;
+    struct aws_byte_cursor frames;
+};
+
+static int s_h2_replay_iteration(void *arg) {
+    struct h2_replay_ctx *ctx = arg;
+
+    /* No reset API: recreate the decoder each pass. The frame buffer is large
+     * enough that decoding dominates the create/destroy overhead. */
+    struct aws_h2_decoder_params params = {
+        .alloc = ctx->allocator,
+    };
+    struct aws_h2_decoder *decoder = aws_h2_decoder_new(&params);
+    if (!decoder) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_byte_cursor to_decode = ctx->frames;
+    int err = aws_h2_decode(decoder, &to_decode);
+
+    aws_h2_decoder_destroy(decoder);
+    return err;
+}
+
+/* A run of DATA frames on stream 1: 9-byte frame header (length, type 0x0, flags, stream id)
+ * followed by the payload. */
+static int s_build_h2_data_frames(
+    struct aws_byte_buf *out,
+    struct aws_allocator *allocator,
+    size_t num_frames,
+    size_t payload_size) {
+
+    if (aws_byte_buf_init(out, allocator, num_frames * (payload_size + 9))) {
+        return AWS_OP_ERR;
+    }
+
+    uint8_t payload[1024];
+    AWS_FATAL_ASSERT(payload_size <= sizeof(payload));
+    for (size_t b = 0; b < payload_size; ++b) {
+        payload[b] = (uint8_t)('a' + (b % 26));
+    }
+    struct aws_byte_cursor payload_cursor = aws_byte_cursor_from_array(payload, payload_size);
+
+    for (size_t i = 0; i < num_frames; ++i) {
+        uint8_t frame_header[9] = {0};
+        frame_header[0] = (uint8_t)(payload_size >> 16);
+        frame_header[1] = (uint8_t)(payload_size >> 8);
+        frame_header[2] = (uint8_t)payload_size;
+        frame_header[8] = 1; /* stream id */
+        struct aws_byte_cursor header_cursor = aws_byte_cursor_from_array(frame_header, sizeof(frame_header));
+        if (aws_byte_buf_append_dynamic(out, &header_cursor) || aws_byte_buf_append_dynamic(out, &payload_cursor)) {
+            return AWS_OP_ERR;
+        }
+    }
+    return AWS_OP_SUCCESS;
+}
+
+/**********************************************************************************************************************
+ * Corpus replay
+ *********************************************************************************************************************/
+
+struct corpus_replay_ctx {
+    struct aws_allocator *allocator;
+    struct aws_byte_buf files[MAX_CORPUS_FILES];
+    size_t num_files;
+    size_t total_bytes;
+    bool is_h2;
+};
+
+static int s_corpus_replay_iteration(void *arg) {
+    struct corpus_replay_ctx *ctx = arg;
+    size_t sink = 0;
+
+    /* Corpus inputs are often invalid (that's their job), which poisons decoder state,
+     * so each file gets a fresh decoder and decode errors are expected. */
+    for (size_t i = 0; i < ctx->num_files; ++i) {
+        struct aws_byte_cursor to_decode = aws_byte_cursor_from_buf(&ctx->files[i]);
+
+        if (ctx->is_h2) {
+            struct aws_h2_decoder_params params = {
+                .alloc = ctx->allocator,
+            };
+            struct aws_h2_decoder *decoder = aws_h2_decoder_new(&params);
+            if (!decoder) {
+                return AWS_OP_ERR;
+            }
+            aws_h2_decode(decoder, &to_decode);
+            aws_h2_decoder_destroy(decoder);
+        } else {
+            struct aws_h1_decoder_params params = {
+                .alloc = ctx->allocator,
+                .is_decoding_requests = false,
+                .user_data = &sink,
+                .vtable =
+                    {
+                        .on_header = s_h1_on_header,
+                        .on_body = s_h1_on_body,
+                        .on_response = s_h1_on_response,
+                        .on_done = s_h1_on_done,
+                    },
+            };
+            struct aws_h1_decoder *decoder = aws_h1_decoder_new(&params);
+            if (!decoder) {
+                return AWS_OP_ERR;
+            }
+            aws_h1_decode(decoder, &to_decode);
+            aws_h1_decoder_destroy(decoder);
+        }
+    }
+    return AWS_OP_SUCCESS;
+}
+
+static int s_load_corpus_file(struct corpus_replay_ctx *ctx, const char *path) {
+    if (ctx->num_files >= MAX_CORPUS_FILES) {
+        fprintf(stderr, "too many corpus files (max %d), skipping %s\n", MAX_CORPUS_FILES, path);
+        return AWS_OP_SUCCESS;
+    }
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "failed to open corpus file %s\n", path);
+        return AWS_OP_ERR;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(file);
+        return AWS_OP_ERR;
+    }
+
+    struct aws_byte_buf *buf = &ctx->files[ctx->num_files];
+    if (aws_byte_buf_init(buf, ctx->allocator, (size_t)size)) {
+        fclose(file);
+        return AWS_OP_ERR;
+    }
+    buf->len = fread(buf->buffer, 1, (size_t)size, file);
+    fclose(file);
+
+    ctx->num_files++;
+    ctx->total_bytes += buf->len;
+    return AWS_OP_SUCCESS;
+}
+
+/**********************************************************************************************************************
+ * Baseline comparison
+ *********************************************************************************************************************/
+
+static int s_write_baseline(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "failed to open baseline file %s for writing\n", path);
+        return AWS_OP_ERR;
+    }
+    for (size_t i = 0; i < s_num_results; ++i) {
+        fprintf(file, "%s %" PRIu64 "\n", s_results[i].name, s_results[i].bytes_per_sec);
+    }
+    fclose(file);
+    printf("wrote baseline to %s\n", path);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_compare_baseline(const char *path, unsigned tolerance_pct) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "failed to open baseline file %s\n", path);
+        return AWS_OP_ERR;
+    }
+
+    int num_regressions = 0;
+    char name[64];
+    uint64_t baseline_bytes_per_sec;
+    while (fscanf(file, "%63s %" SCNu64, name, &baseline_bytes_per_sec) == 2) {
+        for (size_t i = 0; i < s_num_results; ++i) {
+            if (strcmp(s_results[i].name, name) != 0) {
+                continue;
+            }
+            uint64_t floor = baseline_bytes_per_sec - (baseline_bytes_per_sec * tolerance_pct) / 100;
+            if (s_results[i].bytes_per_sec < floor) {
+                fprintf(
+                    stderr,
+                    "REGRESSION %s: %" PRIu64 " bytes/sec vs baseline %" PRIu64 " (tolerance %u%%)\n",
+                    name,
+                    s_results[i].bytes_per_sec,
+                    baseline_bytes_per_sec,
+                    tolerance_pct);
+                num_regressions++;
+            }
+            break;
+        }
+    }
+    fclose(file);
+
+    if (num_regressions) {
+        return AWS_OP_ERR;
+    }
+    printf("all classes within %u%% of baseline\n", tolerance_pct);
+    return AWS_OP_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    aws_http_library_init(allocator);
+
+    const char *baseline_path = NULL;
+    const char *write_baseline_path = NULL;
+    unsigned tolerance_pct = 20;
+    bool corpus_is_h2 = false;
+
+    struct corpus_replay_ctx corpus;
+    AWS_ZERO_STRUCT(corpus);
+    corpus.allocator = allocator;
+
+    int err = AWS_OP_SUCCESS;
+    for (int i = 1; i < argc && !err; ++i) {
+        if (strcmp(argv[i], "--h2") == 0) {
+            corpus_is_h2 = true;
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc) {
+            write_baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance_pct = (unsigned)atoi(argv[++i]);
+        } else {
+            err = s_load_corpus_file(&corpus, argv[i]);
+        }
+    }
+    corpus.is_h2 = corpus_is_h2;
+
+    struct aws_byte_buf max_headers_message;
+    AWS_ZERO_STRUCT(max_headers_message);
+    struct aws_byte_buf tiny_chunks_message;
+    AWS_ZERO_STRUCT(tiny_chunks_message);
+    struct aws_byte_buf h2_frames;
+    AWS_ZERO_STRUCT(h2_frames);
+
+    if (!err) {
+        err = s_build_max_headers_message(&max_headers_message, allocator) ||
+              s_build_tiny_chunks_message(&tiny_chunks_message, allocator) ||
+              s_build_h2_data_frames(&h2_frames, allocator, 64 /*num_frames*/, 1024 /*payload_size*/);
+    }
+
+    struct aws_byte_cursor typical = aws_byte_cursor_from_c_str(s_typical_response);
+    if (!err) {
+        err = s_run_h1_class(allocator, "h1_typical", typical, 0 /*feed_size*/);
+    }
+    if (!err) {
+        err = s_run_h1_class(allocator, "h1_split_1byte", typical, 1 /*feed_size*/);
+    }
+    if (!err) {
+        err = s_run_h1_class(allocator, "h1_max_headers", aws_byte_cursor_from_buf(&max_headers_message), 0);
+    }
+    if (!err) {
+        err = s_run_h1_class(allocator, "h1_tiny_chunks", aws_byte_cursor_from_buf(&tiny_chunks_message), 0);
+    }
+    if (!err) {
+        struct h2_replay_ctx h2_ctx = {
+            .allocator = allocator,
+            .frames = aws_byte_cursor_from_buf(&h2_frames),
+        };
+        err = s_run_replay("h2_data_frames", s_h2_replay_iteration, &h2_ctx, h2_frames.len);
+    }
+    if (!err && corpus.num_files) {
+        err = s_run_replay(
+            corpus_is_h2 ? "corpus_h2" : "corpus_h1", s_corpus_replay_iteration, &corpus, corpus.total_bytes);
+    }
+
+    if (!err && write_baseline_path) {
+        err = s_write_baseline(write_baseline_path);
+    }
+    if (!err && baseline_path) {
+        err = s_compare_baseline(baseline_path, tolerance_pct);
+    }
+
+    for (size_t i = 0; i < corpus.num_files; ++i) {
+        aws_byte_buf_clean_up(&corpus.files[i]);
+    }
+    aws_byte_buf_clean_up(&max_headers_message);
+    aws_byte_buf_clean_up(&tiny_chunks_message);
+    aws_byte_buf_clean_up(&h2_frames);
+
+    aws_http_library_clean_up();
+    return err ? 1 : 0;
+}
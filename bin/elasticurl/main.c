@@ -13,8 +13,11 @@
  * permissions and limitations under the License.
  */
 #include <aws/http/connection.h>
+#include <aws/http/connection_manager.h>
+#include <aws/http/private/mmap_stream.h>
 #include <aws/http/request_response.h>
 
+#include <aws/common/clock.h>
 #include <aws/common/command_line_parser.h>
 #include <aws/common/condition_variable.h>
 #include <aws/common/hash_table.h>
@@ -55,6 +58,8 @@ struct elasticurl_ctx {
     const char *cert;
     const char *key;
     int connect_timeout;
+    size_t bench_connections;
+    size_t bench_requests;
     const char *header_lines[10];
     size_t header_line_count;
     FILE *input_file;
@@ -92,6 +97,11 @@ static void s_usage(int exit_code) {
     fprintf(stderr, "  -G, --get: uses GET for the verb.\n");
     fprintf(stderr, "  -P, --post: uses POST for the verb.\n");
     fprintf(stderr, "  -I, --head: uses HEAD for the verb.\n");
+    fprintf(stderr, "  -n, --bench-connections INT: benchmark mode: number of concurrent connections. Default is 1.\n");
+    fprintf(stderr, "  -r, --bench-requests INT: benchmark mode: requests to send per connection.\n");
+    fprintf(stderr, "          Setting either benchmark option enables benchmark mode: the request is issued\n");
+    fprintf(stderr, "          repeatedly through aws_http_connection_manager and a latency/throughput report\n");
+    fprintf(stderr, "          is printed at exit. Request bodies and signing are not supported in this mode.\n");
     fprintf(stderr, "  -i, --include: includes headers in output.\n");
     fprintf(stderr, "  -k, --insecure: turns off SSL/TLS validation.\n");
     fprintf(stderr, "      --signing-lib: path to a shared library with an exported signing function to use\n");
@@ -121,6 +131,8 @@ static struct aws_cli_option s_long_options[] = {
     {"get", AWS_CLI_OPTIONS_NO_ARGUMENT, NULL, 'G'},
     {"post", AWS_CLI_OPTIONS_NO_ARGUMENT, NULL, 'P'},
     {"head", AWS_CLI_OPTIONS_NO_ARGUMENT, NULL, 'I'},
+    {"bench-connections", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, NULL, 'n'},
+    {"bench-requests", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, NULL, 'r'},
     {"signing-lib", AWS_CLI_OPTIONS_REQUIRED_ARGUMENT, NULL, 'j'},
     {"include", AWS_CLI_OPTIONS_NO_ARGUMENT, NULL, 'i'},
     {"insecure", AWS_CLI_OPTIONS_NO_ARGUMENT, NULL, 'k'},
@@ -165,7 +177,8 @@ static int s_parse_signing_context(
 static void s_parse_options(int argc, char **argv, struct elasticurl_ctx *ctx) {
     while (true) {
         int option_index = 0;
-        int c = aws_cli_getopt_long(argc, argv, "a:b:c:e:f:H:d:g:j:l:m:M:GPHiko:t:v:Vh", s_long_options, &option_index);
+        int c =
+            aws_cli_getopt_long(argc, argv, "a:b:c:e:f:H:d:g:j:l:m:M:n:r:GPHiko:t:v:Vh", s_long_options, &option_index);
         if (c == -1) {
             break;
         }
@@ -202,11 +215,16 @@ static void s_parse_options(int argc, char **argv, struct elasticurl_ctx *ctx) {
                 break;
             }
             case 'g':
-                ctx->input_file = fopen(aws_cli_optarg, "rb");
-                ctx->input_body = aws_input_stream_new_from_open_file(ctx->allocator, ctx->input_file);
-                if (!ctx->input_file) {
-                    fprintf(stderr, "unable to open file %s.\n", aws_cli_optarg);
-                    s_usage(1);
+                /* Prefer a memory-mapped body so large uploads skip the stdio copy;
+                 * fall back to a plain file stream if mapping isn't possible */
+                ctx->input_body = aws_http_mmap_input_stream_new(ctx->allocator, aws_cli_optarg);
+                if (!ctx->input_body) {
+                    ctx->input_file = fopen(aws_cli_optarg, "rb");
+                    ctx->input_body = aws_input_stream_new_from_open_file(ctx->allocator, ctx->input_file);
+                    if (!ctx->input_file) {
+                        fprintf(stderr, "unable to open file %s.\n", aws_cli_optarg);
+                        s_usage(1);
+                    }
                 }
                 break;
             case 'j':
@@ -228,6 +246,12 @@ static void s_parse_options(int argc, char **argv, struct elasticurl_ctx *ctx) {
             case 'M':
                 ctx->verb = aws_cli_optarg;
                 break;
+            case 'n':
+                ctx->bench_connections = (size_t)atoi(aws_cli_optarg);
+                break;
+            case 'r':
+                ctx->bench_requests = (size_t)atoi(aws_cli_optarg);
+                break;
             case 'G':
                 ctx->verb = "GET";
                 break;
@@ -300,6 +324,20 @@ static void s_parse_options(int argc, char **argv, struct elasticurl_ctx *ctx) {
         }
     }
 
+    /* Either benchmark option implies the other, defaulting to 1 */
+    if (ctx->bench_connections || ctx->bench_requests) {
+        if (!ctx->bench_connections) {
+            ctx->bench_connections = 1;
+        }
+        if (!ctx->bench_requests) {
+            ctx->bench_requests = 1;
+        }
+        if (ctx->input_body || ctx->signing_library_path) {
+            fprintf(stderr, "benchmark mode does not support request bodies or signing.\n");
+            s_usage(1);
+        }
+    }
+
     if (ctx->input_body == NULL) {
         struct aws_byte_cursor empty_cursor;
         AWS_ZERO_STRUCT(empty_cursor);
@@ -442,6 +480,321 @@ static struct aws_http_message *s_build_http_request(struct elasticurl_ctx *app_
     return request;
 }
 
+/* ---------------------------------------------------------------------------
+ * Benchmark mode.
+ * N concurrent connections are acquired from an aws_http_connection_manager and
+ * each issues M requests back-to-back. Latencies land in an HDR-style histogram:
+ * log2 major buckets with 32 linear sub-buckets each (<= ~1.6% relative error),
+ * so percentiles stay accurate without storing every sample.
+ * ------------------------------------------------------------------------- */
+
+#define BENCH_HISTO_SUB_BITS 5
+#define BENCH_HISTO_SUB_BUCKETS (1 << BENCH_HISTO_SUB_BITS)
+#define BENCH_HISTO_BUCKETS ((64 - BENCH_HISTO_SUB_BITS + 1) * BENCH_HISTO_SUB_BUCKETS)
+
+struct bench_ctx {
+    struct elasticurl_ctx *app_ctx;
+    struct aws_http_connection_manager *manager;
+    struct bench_connection *connections;
+
+    uint64_t start_ns;
+
+    /* guarded by app_ctx->mutex */
+    uint64_t histogram[BENCH_HISTO_BUCKETS];
+    uint64_t max_latency_us;
+    uint64_t requests_completed;
+    uint64_t requests_failed;
+    uint64_t connections_failed;
+    size_t connections_done;
+    bool manager_shutdown_completed;
+};
+
+/* One driver per concurrent connection. Only ever touched from its own
+ * callback chain, so no locking needed outside the shared counters. */
+struct bench_connection {
+    struct bench_ctx *bench;
+    struct aws_http_connection *connection;
+    struct aws_http_message *request;
+    size_t requests_remaining;
+    uint64_t request_start_ns;
+};
+
+static size_t s_bench_histo_bucket(uint64_t latency_us) {
+    if (latency_us < BENCH_HISTO_SUB_BUCKETS) {
+        return (size_t)latency_us;
+    }
+
+    size_t major = 0;
+    for (uint64_t v = latency_us; v > 1; v >>= 1) {
+        major++;
+    }
+
+    size_t sub = (size_t)((latency_us >> (major - BENCH_HISTO_SUB_BITS)) & (BENCH_HISTO_SUB_BUCKETS - 1));
+    return (major - BENCH_HISTO_SUB_BITS + 1) * BENCH_HISTO_SUB_BUCKETS + sub;
+}
+
+/* Representative latency (bucket midpoint) for a histogram index */
+static uint64_t s_bench_histo_value(size_t index) {
+    size_t group = index >> BENCH_HISTO_SUB_BITS;
+    if (group == 0) {
+        return (uint64_t)index;
+    }
+
+    size_t major = group + BENCH_HISTO_SUB_BITS - 1;
+    uint64_t base = (uint64_t)1 << major;
+    uint64_t width = base >> BENCH_HISTO_SUB_BITS;
+    return base + (uint64_t)(index & (BENCH_HISTO_SUB_BUCKETS - 1)) * width + width / 2;
+}
+
+static uint64_t s_bench_percentile(const uint64_t *histogram, uint64_t total, double quantile) {
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t target = (uint64_t)((double)total * quantile);
+    if (target >= total) {
+        target = total - 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BENCH_HISTO_BUCKETS; ++i) {
+        seen += histogram[i];
+        if (seen > target) {
+            return s_bench_histo_value(i);
+        }
+    }
+
+    return s_bench_histo_value(BENCH_HISTO_BUCKETS - 1);
+}
+
+static void s_bench_connection_done(struct bench_connection *conn) {
+    struct bench_ctx *bench = conn->bench;
+    struct elasticurl_ctx *app_ctx = bench->app_ctx;
+
+    if (conn->connection) {
+        aws_http_connection_manager_release_connection(bench->manager, conn->connection);
+        conn->connection = NULL;
+    }
+
+    aws_mutex_lock(&app_ctx->mutex);
+    bench->connections_done++;
+    bool all_done = bench->connections_done == app_ctx->bench_connections;
+    if (all_done) {
+        app_ctx->exchange_completed = true;
+    }
+    aws_mutex_unlock(&app_ctx->mutex);
+
+    if (all_done) {
+        aws_condition_variable_notify_all(&app_ctx->c_var);
+    }
+}
+
+static void s_bench_on_connection_setup(struct aws_http_connection *connection, int error_code, void *user_data);
+static void s_bench_send_next_request(struct bench_connection *conn);
+
+static void s_bench_on_stream_complete(struct aws_http_stream *stream, int error_code, void *user_data) {
+    struct bench_connection *conn = user_data;
+    struct bench_ctx *bench = conn->bench;
+
+    uint64_t now_ns = 0;
+    aws_high_res_clock_get_ticks(&now_ns);
+    uint64_t latency_us =
+        aws_timestamp_convert(now_ns - conn->request_start_ns, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MICROS, NULL);
+
+    aws_http_stream_release(stream);
+    conn->requests_remaining--;
+
+    aws_mutex_lock(&bench->app_ctx->mutex);
+    if (error_code) {
+        bench->requests_failed++;
+    } else {
+        bench->requests_completed++;
+        bench->histogram[s_bench_histo_bucket(latency_us)]++;
+        if (latency_us > bench->max_latency_us) {
+            bench->max_latency_us = latency_us;
+        }
+    }
+    aws_mutex_unlock(&bench->app_ctx->mutex);
+
+    /* A dead connection goes back to the manager; if work remains, acquire a
+     * replacement (this is where the pool's connection reuse shows up). */
+    if (error_code || !aws_http_connection_is_open(conn->connection)) {
+        aws_http_connection_manager_release_connection(bench->manager, conn->connection);
+        conn->connection = NULL;
+
+        if (conn->requests_remaining > 0) {
+            aws_http_connection_manager_acquire_connection(bench->manager, s_bench_on_connection_setup, conn);
+        } else {
+            s_bench_connection_done(conn);
+        }
+        return;
+    }
+
+    s_bench_send_next_request(conn);
+}
+
+static void s_bench_send_next_request(struct bench_connection *conn) {
+    struct bench_ctx *bench = conn->bench;
+
+    if (conn->requests_remaining == 0) {
+        s_bench_connection_done(conn);
+        return;
+    }
+
+    struct aws_http_make_request_options request_options = {
+        .self_size = sizeof(request_options),
+        .user_data = conn,
+        .request = conn->request,
+        .on_complete = s_bench_on_stream_complete,
+    };
+
+    aws_high_res_clock_get_ticks(&conn->request_start_ns);
+
+    struct aws_http_stream *stream = aws_http_connection_make_request(conn->connection, &request_options);
+    if (!stream) {
+        aws_mutex_lock(&bench->app_ctx->mutex);
+        bench->requests_failed += conn->requests_remaining;
+        aws_mutex_unlock(&bench->app_ctx->mutex);
+        conn->requests_remaining = 0;
+        s_bench_connection_done(conn);
+    }
+}
+
+static void s_bench_on_connection_setup(struct aws_http_connection *connection, int error_code, void *user_data) {
+    struct bench_connection *conn = user_data;
+    struct bench_ctx *bench = conn->bench;
+
+    if (error_code) {
+        aws_mutex_lock(&bench->app_ctx->mutex);
+        bench->connections_failed++;
+        bench->requests_failed += conn->requests_remaining;
+        aws_mutex_unlock(&bench->app_ctx->mutex);
+        conn->requests_remaining = 0;
+        s_bench_connection_done(conn);
+        return;
+    }
+
+    conn->connection = connection;
+    s_bench_send_next_request(conn);
+}
+
+static void s_bench_on_manager_shutdown(void *user_data) {
+    struct bench_ctx *bench = user_data;
+    struct elasticurl_ctx *app_ctx = bench->app_ctx;
+
+    aws_mutex_lock(&app_ctx->mutex);
+    bench->manager_shutdown_completed = true;
+    aws_mutex_unlock(&app_ctx->mutex);
+    aws_condition_variable_notify_all(&app_ctx->c_var);
+}
+
+static bool s_bench_manager_shutdown_predicate(void *arg) {
+    struct bench_ctx *bench = arg;
+    return bench->manager_shutdown_completed;
+}
+
+static bool s_bench_completion_predicate(void *arg) {
+    struct bench_ctx *bench = arg;
+    return bench->app_ctx->exchange_completed;
+}
+
+static void s_bench_print_report(struct bench_ctx *bench, uint64_t duration_ns) {
+    struct elasticurl_ctx *app_ctx = bench->app_ctx;
+
+    struct aws_http_connection_manager_metrics metrics;
+    AWS_ZERO_STRUCT(metrics);
+    aws_http_connection_manager_fetch_metrics(bench->manager, &metrics);
+
+    double duration_s = (double)duration_ns / 1000000000.0;
+    double rate = duration_s > 0.0 ? (double)bench->requests_completed / duration_s : 0.0;
+
+    fprintf(stderr, "\nBenchmark complete\n");
+    fprintf(
+        stderr,
+        "  connections:  %zu concurrent (%" PRIu64 " opened, %" PRIu64 " pool hits, %" PRIu64 " failed)\n",
+        app_ctx->bench_connections,
+        metrics.connect_count,
+        metrics.pool_hit_count,
+        bench->connections_failed);
+    fprintf(
+        stderr,
+        "  requests:     %" PRIu64 " completed, %" PRIu64 " failed\n",
+        bench->requests_completed,
+        bench->requests_failed);
+    fprintf(stderr, "  duration:     %.3f s (%.0f req/s)\n", duration_s, rate);
+    fprintf(
+        stderr,
+        "  latency (us): p50=%" PRIu64 " p90=%" PRIu64 " p99=%" PRIu64 " p99.9=%" PRIu64 " max=%" PRIu64 "\n",
+        s_bench_percentile(bench->histogram, bench->requests_completed, 0.50),
+        s_bench_percentile(bench->histogram, bench->requests_completed, 0.90),
+        s_bench_percentile(bench->histogram, bench->requests_completed, 0.99),
+        s_bench_percentile(bench->histogram, bench->requests_completed, 0.999),
+        bench->max_latency_us);
+}
+
+static void s_run_benchmark(
+    struct elasticurl_ctx *app_ctx,
+    struct aws_client_bootstrap *bootstrap,
+    const struct aws_socket_options *socket_options,
+    const struct aws_tls_connection_options *tls_options,
+    uint16_t port) {
+
+    struct bench_ctx bench;
+    AWS_ZERO_STRUCT(bench);
+    bench.app_ctx = app_ctx;
+
+    struct aws_http_connection_manager_options manager_options = {
+        .bootstrap = bootstrap,
+        .initial_window_size = SIZE_MAX,
+        .socket_options = socket_options,
+        .tls_connection_options = tls_options,
+        .host = app_ctx->uri.host_name,
+        .port = port,
+        .max_connections = app_ctx->bench_connections,
+        .shutdown_complete_callback = s_bench_on_manager_shutdown,
+        .shutdown_complete_user_data = &bench,
+    };
+
+    bench.manager = aws_http_connection_manager_new(app_ctx->allocator, &manager_options);
+    if (!bench.manager) {
+        fprintf(stderr, "Failed to create connection manager with error %s\n", aws_error_debug_str(aws_last_error()));
+        exit(1);
+    }
+
+    bench.connections =
+        aws_mem_calloc(app_ctx->allocator, app_ctx->bench_connections, sizeof(struct bench_connection));
+    AWS_FATAL_ASSERT(bench.connections);
+
+    aws_high_res_clock_get_ticks(&bench.start_ns);
+
+    for (size_t i = 0; i < app_ctx->bench_connections; ++i) {
+        struct bench_connection *conn = &bench.connections[i];
+        conn->bench = &bench;
+        conn->requests_remaining = app_ctx->bench_requests;
+        conn->request = s_build_http_request(app_ctx);
+        aws_http_connection_manager_acquire_connection(bench.manager, s_bench_on_connection_setup, conn);
+    }
+
+    aws_mutex_lock(&app_ctx->mutex);
+    aws_condition_variable_wait_pred(&app_ctx->c_var, &app_ctx->mutex, s_bench_completion_predicate, &bench);
+    aws_mutex_unlock(&app_ctx->mutex);
+
+    uint64_t end_ns = 0;
+    aws_high_res_clock_get_ticks(&end_ns);
+
+    s_bench_print_report(&bench, end_ns - bench.start_ns);
+
+    aws_http_connection_manager_release(bench.manager);
+    aws_mutex_lock(&app_ctx->mutex);
+    aws_condition_variable_wait_pred(&app_ctx->c_var, &app_ctx->mutex, s_bench_manager_shutdown_predicate, &bench);
+    aws_mutex_unlock(&app_ctx->mutex);
+
+    for (size_t i = 0; i < app_ctx->bench_connections; ++i) {
+        aws_http_message_destroy(bench.connections[i].request);
+    }
+    aws_mem_release(app_ctx->allocator, bench.connections);
+}
+
 static void s_on_signing_complete(struct aws_http_message *request, int error_code, void *user_data);
 
 static void s_on_client_connection_setup(struct aws_http_connection *connection, int error_code, void *user_data) {
@@ -673,8 +1026,13 @@ int main(int argc, char **argv) {
         }
     }
 
+    uint16_t el_thread_count = 1;
+    if (app_ctx.bench_connections > 1) {
+        el_thread_count = (uint16_t)(app_ctx.bench_connections < 8 ? app_ctx.bench_connections : 8);
+    }
+
     struct aws_event_loop_group el_group;
-    aws_event_loop_group_default_init(&el_group, allocator, 1);
+    aws_event_loop_group_default_init(&el_group, allocator, el_thread_count);
 
     struct aws_host_resolver resolver;
     aws_host_resolver_init_default(&resolver, allocator, 8, &el_group);
@@ -695,24 +1053,28 @@ int main(int argc, char **argv) {
         .keep_alive_interval_sec = 0,
     };
 
-    struct aws_http_client_connection_options http_client_options = {
-        .self_size = sizeof(struct aws_http_client_connection_options),
-        .socket_options = &socket_options,
-        .allocator = allocator,
-        .port = port,
-        .host_name = app_ctx.uri.host_name,
-        .bootstrap = bootstrap,
-        .initial_window_size = SIZE_MAX,
-        .tls_options = tls_options,
-        .user_data = &app_ctx,
-        .on_setup = s_on_client_connection_setup,
-        .on_shutdown = s_on_client_connection_shutdown,
-    };
+    if (app_ctx.bench_requests > 0) {
+        s_run_benchmark(&app_ctx, bootstrap, &socket_options, tls_options, port);
+    } else {
+        struct aws_http_client_connection_options http_client_options = {
+            .self_size = sizeof(struct aws_http_client_connection_options),
+            .socket_options = &socket_options,
+            .allocator = allocator,
+            .port = port,
+            .host_name = app_ctx.uri.host_name,
+            .bootstrap = bootstrap,
+            .initial_window_size = SIZE_MAX,
+            .tls_options = tls_options,
+            .user_data = &app_ctx,
+            .on_setup = s_on_client_connection_setup,
+            .on_shutdown = s_on_client_connection_shutdown,
+        };
 
-    aws_http_client_connect(&http_client_options);
-    aws_mutex_lock(&app_ctx.mutex);
-    aws_condition_variable_wait_pred(&app_ctx.c_var, &app_ctx.mutex, s_completion_predicate, &app_ctx);
-    aws_mutex_unlock(&app_ctx.mutex);
+        aws_http_client_connect(&http_client_options);
+        aws_mutex_lock(&app_ctx.mutex);
+        aws_condition_variable_wait_pred(&app_ctx.c_var, &app_ctx.mutex, s_completion_predicate, &app_ctx);
+        aws_mutex_unlock(&app_ctx.mutex);
+    }
 
     aws_client_bootstrap_release(bootstrap);
     aws_mutex_lock(&app_ctx.mutex);
@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+"""
+Generates source/hpack_header_static.c from include/aws/http/private/hpack_header_static_table.def.
+
+The generated file contains a minimal perfect-hash lookup over the HPACK static table's
+names and name+value pairs (RFC-7541 Appendix A), so the encoder resolves a static-table
+hit with one hash computation and one memcmp instead of runtime hash-table probes.
+
+Run from the repository root:
+    python3 bin/generate-hpack-static-lookup.py
+
+Commit the regenerated file whenever the .def changes (the same workflow as
+source/hpack_huffman_static.c).
+"""
+
+import os
+import re
+import sys
+
+DEF_PATH = os.path.join("include", "aws", "http", "private", "hpack_header_static_table.def")
+OUT_PATH = os.path.join("source", "hpack_header_static.c")
+
+FNV_OFFSET_BASIS = 0x811C9DC5
+FNV_PRIME = 0x01000193
+MASK = 0xFFFFFFFF
+
+
+def fnv1a(data, h=FNV_OFFSET_BASIS):
+    for byte in data:
+        h = ((h ^ byte) * FNV_PRIME) & MASK
+    return h
+
+
+def pair_hash(name, value):
+    # Continue the name hash through a separator byte, then the value
+    return fnv1a(value, fnv1a(b"\x00", fnv1a(name)))
+
+
+def parse_def(path):
+    entries = []  # (index, name, value-or-None)
+    pattern = re.compile(r'^HEADER(_WITH_VALUE)?\((\d+),\s*"([^"]*)"(?:,\s*"([^"]*)")?\)')
+    with open(path) as def_file:
+        for line in def_file:
+            match = pattern.match(line.strip())
+            if match:
+                index = int(match.group(2))
+                name = match.group(3)
+                value = match.group(4) if match.group(1) else None
+                entries.append((index, name, value))
+    return entries
+
+
+def build_slot_table(hashes_to_index):
+    """Finds the smallest table size where every hash lands in its own slot."""
+    count = len(hashes_to_index)
+    for size in range(count, 4096):
+        slots = [0] * size
+        for h, index in hashes_to_index.items():
+            slot = h % size
+            if slots[slot]:
+                break
+            slots[slot] = index
+        else:
+            return size, slots
+    raise RuntimeError("no collision-free table size found below 4096")
+
+
+def c_array(values, per_line=20):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(str(v) for v in values[i : i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    entries = parse_def(DEF_PATH)
+    if not entries:
+        sys.exit("no entries parsed from " + DEF_PATH)
+    max_index = max(index for index, _, _ in entries)
+
+    # Lowest index per distinct name
+    name_to_index = {}
+    for index, name, _ in entries:
+        name_to_index.setdefault(name, index)
+
+    name_hashes = {}
+    for name, index in name_to_index.items():
+        h = fnv1a(name.encode())
+        assert h not in name_hashes, "FNV collision between names"
+        name_hashes[h] = index
+
+    pair_hashes = {}
+    for index, name, value in entries:
+        if value is None:
+            continue
+        h = pair_hash(name.encode(), value.encode())
+        assert h not in pair_hashes, "FNV collision between name+value pairs"
+        pair_hashes[h] = index
+
+    name_table_size, name_slots = build_slot_table(name_hashes)
+    pair_table_size, pair_slots = build_slot_table(pair_hashes)
+
+    entry_rows = ["    {NULL, 0, NULL, 0}, /* index 0 is unused */"]
+    by_index = {index: (name, value) for index, name, value in entries}
+    for index in range(1, max_index + 1):
+        name, value = by_index[index]
+        entry_rows.append(
+            '    {{"{0}", {1}, "{2}", {3}}},'.format(name, len(name), value or "", len(value or ""))
+        )
+
+    with open(OUT_PATH, "w") as out:
+        out.write(
+            """/*
+ * Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* WARNING: THIS FILE WAS AUTOMATICALLY GENERATED BY bin/generate-hpack-static-lookup.py
+ * FROM include/aws/http/private/hpack_header_static_table.def. DO NOT EDIT. */
+/* clang-format off */
+
+#include <aws/common/byte_buf.h>
+
+#include <string.h>
+
+/* Minimal perfect-hash lookup over the HPACK static table [RFC-7541 Appendix A].
+ * An FNV-1a hash of the header's name (continued through the value for name+value pairs)
+ * indexes a slot table sized, at generation time, so that no two table entries share a
+ * slot; a single memcmp then confirms or rejects the one possible candidate. */
+
+struct hpack_static_table_entry {
+    const char *name;
+    uint16_t name_len;
+    const char *value;
+    uint16_t value_len;
+};
+
+static const struct hpack_static_table_entry s_static_entries[%(entry_count)d] = {
+%(entry_rows)s
+};
+
+/* hash %% table-size -> static table index of the sole entry that can hash there (0 = no entry) */
+static const uint8_t s_name_slot_to_index[%(name_table_size)d] = {
+%(name_slots)s
+};
+
+static const uint8_t s_pair_slot_to_index[%(pair_table_size)d] = {
+%(pair_slots)s
+};
+
+static uint32_t s_fnv1a(const uint8_t *bytes, size_t len, uint32_t hash) {
+    for (size_t i = 0; i < len; ++i) {
+        hash = (hash ^ bytes[i]) * 0x01000193U;
+    }
+    return hash;
+}
+
+size_t hpack_static_table_find(
+    const struct aws_byte_cursor *name,
+    const struct aws_byte_cursor *value,
+    bool *out_found_value) {
+
+    static const uint8_t s_separator = 0;
+
+    *out_found_value = false;
+
+    const uint32_t name_hash = s_fnv1a(name->ptr, name->len, 0x811C9DC5U);
+
+    /* Exact name+value match first */
+    const uint32_t pair_hash = s_fnv1a(value->ptr, value->len, s_fnv1a(&s_separator, 1, name_hash));
+    uint8_t candidate = s_pair_slot_to_index[pair_hash %% %(pair_table_size)d];
+    if (candidate) {
+        const struct hpack_static_table_entry *entry = &s_static_entries[candidate];
+        if (entry->name_len == name->len && entry->value_len == value->len &&
+            memcmp(entry->name, name->ptr, name->len) == 0 && memcmp(entry->value, value->ptr, value->len) == 0) {
+
+            *out_found_value = true;
+            return candidate;
+        }
+    }
+
+    /* Fall back to the lowest-indexed entry with a matching name */
+    candidate = s_name_slot_to_index[name_hash %% %(name_table_size)d];
+    if (candidate) {
+        const struct hpack_static_table_entry *entry = &s_static_entries[candidate];
+        if (entry->name_len == name->len && memcmp(entry->name, name->ptr, name->len) == 0) {
+            return candidate;
+        }
+    }
+
+    return 0;
+}
+"""
+            % {
+                "entry_count": max_index + 1,
+                "entry_rows": "\n".join(entry_rows),
+                "name_table_size": name_table_size,
+                "name_slots": c_array(name_slots),
+                "pair_table_size": pair_table_size,
+                "pair_slots": c_array(pair_slots),
+            }
+        )
+
+    print(
+        "wrote {0}: {1} entries, name table {2} slots, pair table {3} slots".format(
+            OUT_PATH, max_index, name_table_size, pair_table_size
+        )
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -56,6 +56,14 @@ typedef void(
 typedef void(
     aws_http_on_client_connection_shutdown_fn)(struct aws_http_connection *connection, int error_code, void *user_data);
 
+/**
+ * Invoked when the connection begins draining: the peer has signaled that it will accept no
+ * further requests (HTTP/2 GOAWAY, or an HTTP/1 response carrying "Connection: close"), but
+ * streams already in flight may still run to completion. Invoked at most once per connection,
+ * on the connection's event-loop thread, and always before on_shutdown.
+ */
+typedef void(aws_http_on_client_connection_draining_fn)(struct aws_http_connection *connection, void *user_data);
+
 /**
  * Supported proxy authentication modes
  */
@@ -104,6 +112,47 @@ struct aws_http_proxy_options {
     struct aws_byte_cursor auth_password;
 };
 
+/**
+ * Invoked by the connection monitor when a transfer has stayed below the configured
+ * minimum throughput for the allowable interval.
+ * Invoked on the connection's event-loop thread, just before the connection is closed.
+ */
+typedef void(aws_http_connection_monitoring_unhealthy_fn)(struct aws_http_connection *connection, void *user_data);
+
+/**
+ * Configuration for connection-level throughput monitoring.
+ * While a stream is in progress, a lightweight task samples the connection's bytes-in/bytes-out
+ * counters roughly once per second. If throughput stays below minimum_throughput_bytes_per_second
+ * for allowable_throughput_failure_interval_seconds in a row, the connection is deemed unhealthy
+ * and closed, so a stalled peer is recycled in seconds instead of waiting for application timeouts.
+ * Idle connections (no streams in progress) are never deemed unhealthy.
+ */
+struct aws_http_connection_monitoring_options {
+    /**
+     * Required (must be non-zero).
+     * A transfer is failing while the connection moves fewer bytes per second than this.
+     */
+    uint32_t minimum_throughput_bytes_per_second;
+
+    /**
+     * Required (must be non-zero).
+     * How many consecutive seconds a transfer may keep failing before the connection is closed.
+     */
+    uint32_t allowable_throughput_failure_interval_seconds;
+
+    /**
+     * Optional.
+     * Invoked just before an unhealthy connection is closed.
+     */
+    aws_http_connection_monitoring_unhealthy_fn *on_unhealthy;
+
+    /**
+     * Optional.
+     * User data for on_unhealthy.
+     */
+    void *on_unhealthy_user_data;
+};
+
 /**
  * Options for creating an HTTP client connection.
  * Initialize with AWS_HTTP_CLIENT_CONNECTION_OPTIONS_INIT to set default values.
@@ -164,6 +213,70 @@ struct aws_http_client_connection_options {
      */
     size_t initial_window_size;
 
+    /**
+     * Optional (HTTP/1.1 only).
+     * If non-zero, limits how many fully-sent requests may be awaiting their responses
+     * before the connection pauses sending further pipelined requests.
+     * If zero, requests are sent as soon as the wire is free (no limit).
+     */
+    size_t max_pipelined_requests;
+
+    /**
+     * Optional (HTTP/1.1 only).
+     * If non-zero, window updates issued from off the connection's event-loop thread are
+     * coalesced: they accumulate until the pending amount reaches this many bytes (or a
+     * brief deadline passes), and are then applied with a single task. A reasonable value
+     * is a fraction (say 1/8th) of initial_window_size.
+     * If zero, each off-thread window update schedules a task immediately.
+     */
+    size_t window_update_threshold;
+
+    /**
+     * Optional (HTTP/1.1 only).
+     * If true, the connection sizes its read window automatically instead of holding it at
+     * initial_window_size. The window is sized to the application's measured consumption
+     * rate (observed from the timing of aws_http_stream_update_window() calls) multiplied
+     * by the observed consumption delay, with hysteresis so the size doesn't chase noise.
+     * Fast readers get the full pipe, slow readers buffer a bounded amount, and no
+     * per-deployment tuning of initial_window_size is needed; initial_window_size still
+     * acts as the upper bound. Streams on the connection must set manual_window_management,
+     * since the measurements come from their window updates.
+     */
+    bool adaptive_window_management;
+
+    /**
+     * Optional (HTTP/1.1 only).
+     * Preferred size in bytes of the I/O messages the connection writes to the channel,
+     * including per-channel overhead. Tune this down for tiny-request workloads, or up
+     * for bulk uploads. If zero, a 16KB default is used.
+     */
+    size_t preferred_write_message_size;
+
+    /**
+     * Optional (HTTP/2 only).
+     * If non-zero, the connection sends a PING probe whenever it has been active but quiet
+     * for this many milliseconds. A probe that isn't acknowledged within
+     * `http2_ping_timeout_ms` closes the connection with AWS_ERROR_HTTP_PING_TIMEOUT, so a
+     * pooled connection that silently died (ex: NAT timeout) is evicted instead of vended.
+     * Acknowledged probes feed the connection's smoothed round-trip-time estimate.
+     */
+    uint64_t http2_ping_period_ms;
+
+    /**
+     * Optional (HTTP/2 only).
+     * How long a keepalive PING may remain unacknowledged before the connection is
+     * considered dead. If zero, a 3 second default is used.
+     */
+    uint64_t http2_ping_timeout_ms;
+
+    /**
+     * Optional.
+     * If set, enables throughput monitoring on the connection.
+     * Contents are copied internally.
+     * See `aws_http_connection_monitoring_options`.
+     */
+    const struct aws_http_connection_monitoring_options *monitoring_options;
+
     /**
      * User data for callbacks
      * Optional.
@@ -184,6 +297,13 @@ struct aws_http_client_connection_options {
      * See `aws_http_on_client_connection_shutdown_fn`.
      */
     aws_http_on_client_connection_shutdown_fn *on_shutdown;
+
+    /**
+     * Invoked when the peer signals that it will accept no further requests.
+     * Optional.
+     * See `aws_http_on_client_connection_draining_fn`.
+     */
+    aws_http_on_client_connection_draining_fn *on_draining;
 };
 
 /**
@@ -192,6 +312,29 @@ struct aws_http_client_connection_options {
 #define AWS_HTTP_CLIENT_CONNECTION_OPTIONS_INIT                                                                        \
     { .self_size = sizeof(struct aws_http_client_connection_options), .initial_window_size = SIZE_MAX, }
 
+/**
+ * Timestamps recorded while a client connection was being established, so slow connects can
+ * be attributed to the right layer without packet captures.
+ *
+ * All values are monotonic nanoseconds from aws_high_res_clock_get_ticks().
+ * A value of 0 means the connection never reached that transition (always the case on
+ * server connections, which are accepted rather than established).
+ * The bootstrap does not report DNS, TCP, and TLS boundaries individually, so the span from
+ * connect_start to channel_complete covers all of name resolution, the TCP handshake, and
+ * TLS negotiation; setup_complete adds the time to install the HTTP handler and settle on a
+ * protocol version.
+ */
+struct aws_http_connection_setup_timing {
+    /* aws_http_client_connect() was called */
+    uint64_t connect_start_timestamp_ns;
+
+    /* The bootstrap delivered the negotiated channel (DNS + TCP + TLS complete) */
+    uint64_t channel_complete_timestamp_ns;
+
+    /* The HTTP handler was installed; the setup callback fires immediately after */
+    uint64_t setup_complete_timestamp_ns;
+};
+
 AWS_EXTERN_C_BEGIN
 
 /**
@@ -229,6 +372,15 @@ void aws_http_connection_close(struct aws_http_connection *connection);
 AWS_HTTP_API
 bool aws_http_connection_is_open(const struct aws_http_connection *connection);
 
+/**
+ * Returns true if the peer has signaled that it will accept no further requests
+ * (HTTP/2 GOAWAY, or an HTTP/1 response carrying "Connection: close").
+ * A draining connection may still be open while in-flight streams finish,
+ * but it must not be given new work.
+ */
+AWS_HTTP_API
+bool aws_http_connection_is_draining(const struct aws_http_connection *connection);
+
 /**
  * Returns true if this is a client connection.
  */
@@ -241,6 +393,32 @@ bool aws_http_connection_is_client(const struct aws_http_connection *connection)
 AWS_HTTP_API
 void aws_http_connection_update_window(struct aws_http_connection *connection, size_t increment_size);
 
+/**
+ * Convert the connection into a raw passthrough (midchannel) channel handler.
+ *
+ * Once a protocol switch has been negotiated over HTTP (an Upgrade handshake, or a CONNECT
+ * tunnel established through a proxy), call this so further traffic skips HTTP processing
+ * entirely: the connection stops servicing streams and forwards aws_io_messages unmodified in
+ * both directions between its channel neighbors. Install a channel handler for the new
+ * protocol downstream (right) of the connection to send and receive the raw data.
+ *
+ * An HTTP/1 client connection enters this mode automatically when a stream completes with a
+ * 101 Switching Protocols response; this function exists for tunnels negotiated by other means.
+ * Must be called on the connection's channel thread, with no streams pending or in progress.
+ * The conversion cannot be undone. HTTP/1 connections only.
+ */
+AWS_HTTP_API
+int aws_http_connection_convert_to_midchannel_handler(struct aws_http_connection *connection);
+
+/**
+ * Copy out the timestamps recorded while this client connection was established.
+ * See `aws_http_connection_setup_timing`.
+ */
+AWS_HTTP_API
+void aws_http_connection_get_setup_timing(
+    const struct aws_http_connection *connection,
+    struct aws_http_connection_setup_timing *out_timing);
+
 AWS_HTTP_API
 enum aws_http_version aws_http_connection_get_version(const struct aws_http_connection *connection);
 
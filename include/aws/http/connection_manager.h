@@ -17,6 +17,7 @@
  */
 
 #include <aws/http/http.h>
+#include <aws/http/request_response.h>
 
 #include <aws/common/byte_buf.h>
 
@@ -31,8 +32,75 @@ typedef void(aws_http_connection_manager_on_connection_setup_fn)(
     int error_code,
     void *user_data);
 
+/*
+ * Invoked when both halves of a transformed acquisition (see
+ * aws_http_connection_manager_acquire_transformed_connection) have resolved.  On success,
+ * `connection` is an acquired connection and `message` is the fully transformed message,
+ * ready to send.  On failure, `connection` is NULL (any connection acquired despite the
+ * failure has already been released back to the manager) and `message` is in whatever
+ * state the transform left it.
+ */
+typedef void(aws_http_connection_manager_on_transformed_connection_setup_fn)(
+    struct aws_http_connection *connection,
+    struct aws_http_message *message,
+    int error_code,
+    void *user_data);
+
 typedef void(aws_http_connection_manager_shutdown_complete_fn)(void *user_data);
 
+enum {
+    /*
+     * Number of buckets in the acquire-latency histogram.  Bucket i counts acquisitions that
+     * completed in [2^i, 2^(i+1)) microseconds; bucket 0 also absorbs sub-microsecond
+     * completions and the final bucket absorbs everything slower than its lower bound.
+     */
+    AWS_HTTP_CONNECTION_MANAGER_METRICS_LATENCY_BUCKETS = 16,
+};
+
+/*
+ * A snapshot of connection manager health, filled in by
+ * aws_http_connection_manager_fetch_metrics.
+ *
+ * The gauges are instantaneous values and may be slightly stale with respect to the
+ * manager's lock-free fast paths; the counters and histogram are cumulative since manager
+ * creation and only ever increase.  Fetching is cheap (a brief lock plus atomic loads) and
+ * is intended to be safe to call on a once-per-second sampling cadence in production.
+ */
+struct aws_http_connection_manager_metrics {
+    /*
+     * Gauges
+     */
+    size_t held_connection_count; /* idle connections in the pool, including fast-path slots */
+    size_t pending_acquisition_count;
+    size_t pending_connects_count;
+    size_t vended_connection_count;
+    size_t open_connection_count;
+
+    /*
+     * Cumulative counters
+     */
+    uint64_t total_acquisition_count;
+    uint64_t pool_hit_count;          /* acquisitions satisfied by an already-open connection */
+    uint64_t connect_count;           /* new connections requested from the http layer */
+    uint64_t failed_acquisition_count;
+
+    /*
+     * Histogram of time from acquire call to completion callback, bucketed as described on
+     * AWS_HTTP_CONNECTION_MANAGER_METRICS_LATENCY_BUCKETS.
+     */
+    uint64_t acquire_latency_buckets[AWS_HTTP_CONNECTION_MANAGER_METRICS_LATENCY_BUCKETS];
+
+    /*
+     * Cumulative connection-establishment time for connects this manager requested, summed
+     * from each connection's aws_http_connection_setup_timing.  Divide by connect_count for
+     * averages.  connect_channel_time_ns covers DNS + TCP + TLS (connect start to negotiated
+     * channel); connect_total_time_ns additionally includes HTTP handler setup, so the
+     * difference attributes slow connects to transport vs protocol layers.
+     */
+    uint64_t connect_total_time_ns;
+    uint64_t connect_channel_time_ns;
+};
+
 /*
  * Connection manager configuration struct.
  *
@@ -56,6 +124,34 @@ struct aws_http_connection_manager_options {
      */
     size_t max_connections;
 
+    /*
+     * If non-zero, a periodic reaper task closes connections that have sat idle in the pool
+     * for at least this long, shrinking the pool back down after a traffic spike.
+     * If zero, idle connections are kept until the manager shuts down.
+     */
+    uint64_t max_connection_idle_in_milliseconds;
+
+    /*
+     * If non-zero, the manager keeps at least this many connections warm: the full floor
+     * is brought up on first use, replenished whenever a connection dies, and the idle
+     * reaper never culls below it.  Clamped to max_connections.
+     *
+     * Most valuable when proxy_options are set: each pooled connection is then a fully
+     * established CONNECT tunnel to this manager's (proxy, host:port) pair, so acquisitions
+     * skip the multi-round-trip proxy handshake entirely.
+     */
+    size_t min_connections;
+
+    /*
+     * If non-zero, the manager speculatively opens connections ahead of demand, keeping up to
+     * this many spare connections (idle, or already connecting) available while acquisitions
+     * are arriving.  The spare target scales with the observed acquisition rate, so a quiet
+     * manager holds no extra connections.  Bursts then mostly hit the pool instead of each
+     * paying full TCP+TLS handshake latency.
+     * If zero, connections are only opened in response to acquisitions.
+     */
+    size_t prewarm_headroom;
+
     /*
      * Callback and associated user data to invoke when the connection manager has
      * completely shutdown and has finished deleting itself.
@@ -65,6 +161,60 @@ struct aws_http_connection_manager_options {
     aws_http_connection_manager_shutdown_complete_fn *shutdown_complete_callback;
 };
 
+/*
+ * A pool of connection managers keyed by (host, port), for fleets that talk to many
+ * distinct hosts.  Per-host managers are created lazily on first acquisition and cached;
+ * the pool holds at most max_hosts of them, splitting max_total_connections evenly among
+ * the host slots, so the fleet-wide connection count stays bounded no matter how many
+ * hosts are touched.  When every slot is taken and a new host arrives, the coldest host
+ * with no vended connections is evicted to make room; if no slot can be freed, the
+ * acquisition fails with AWS_ERROR_HTTP_HOST_POOL_BUDGET_EXCEEDED.
+ *
+ * Combine with max_connection_idle_in_milliseconds so an idle host's slot stops holding
+ * actual sockets long before the slot itself is evicted.
+ */
+struct aws_http_host_pool;
+
+struct aws_http_host_pool_options {
+    /*
+     * Connection configuration applied to every per-host manager.
+     */
+    struct aws_client_bootstrap *bootstrap;
+    size_t initial_window_size;
+    const struct aws_socket_options *socket_options;
+
+    /*
+     * Optional TLS template.  If set, every host is connected with TLS: the template is
+     * copied per host with its server name replaced by that host, so SNI and certificate
+     * validation work without a hand-built config per host.
+     */
+    const struct aws_tls_connection_options *tls_connection_options;
+
+    /*
+     * Global connection ceiling across all hosts.  Required (must be non-zero).
+     */
+    size_t max_total_connections;
+
+    /*
+     * Maximum number of per-host managers cached at once.  Each host slot gets an equal
+     * share of max_total_connections (at least 1).  Optional; defaults to 16.
+     */
+    size_t max_hosts;
+
+    /*
+     * Passed through to every per-host manager; see
+     * aws_http_connection_manager_options.max_connection_idle_in_milliseconds.
+     */
+    uint64_t max_connection_idle_in_milliseconds;
+
+    /*
+     * Callback and associated user data to invoke when the pool has completely shut down
+     * and finished deleting itself.
+     */
+    void *shutdown_complete_user_data;
+    aws_http_connection_manager_shutdown_complete_fn *shutdown_complete_callback;
+};
+
 AWS_EXTERN_C_BEGIN
 
 /*
@@ -109,6 +259,70 @@ void aws_http_connection_manager_acquire_connection(
     aws_http_connection_manager_on_connection_setup_fn *callback,
     void *user_data);
 
+/*
+ * Requests `count` connections from the manager at once; the callback is invoked once per
+ * connection (or per failure), exactly as if aws_http_connection_manager_acquire_connection
+ * had been called `count` times.
+ *
+ * Unlike issuing individual acquisitions, the whole batch takes the manager's lock a single
+ * time: available connections are vended in one pass and the remainder is queued in one
+ * pass, with completions that resolve together delivered back-to-back rather than one
+ * scheduled callback at a time.  Intended for fan-out workloads that scatter a request
+ * across many connections.
+ */
+AWS_HTTP_API
+void aws_http_connection_manager_acquire_connections(
+    struct aws_http_connection_manager *manager,
+    size_t count,
+    aws_http_connection_manager_on_connection_setup_fn *callback,
+    void *user_data);
+
+/*
+ * Same contract as aws_http_connection_manager_acquire_connection, but prefers to vend a
+ * pooled connection whose channel runs on the calling thread, falling back to the normal
+ * most-recently-released choice when no such connection is pooled.
+ *
+ * Call this from the event loop thread that the stream's callbacks should land on: a
+ * thread-affine connection keeps every callback on-loop instead of paying a cross-loop
+ * task hop (and the associated cache traffic) per event.  Unlike the plain acquire, this
+ * variant always takes the manager's lock, since affinity cannot be inspected on the
+ * lock-free path.
+ */
+AWS_HTTP_API
+void aws_http_connection_manager_acquire_affine_connection(
+    struct aws_http_connection_manager *manager,
+    aws_http_connection_manager_on_connection_setup_fn *callback,
+    void *user_data);
+
+/*
+ * Acquires a connection while a message transform (ex: request signing) runs concurrently,
+ * invoking the callback once both have completed.  Serializing "acquire, then sign, then
+ * send" puts the transform's full cost on every request's critical path; overlapping the
+ * two hides it entirely under connection-pool or handshake latency.
+ *
+ * The transform is started immediately on the calling thread and may complete
+ * asynchronously; its contract is that of aws_http_message_transform_fn.  The message must
+ * remain valid until the callback fires, and the caller must keep the manager alive until
+ * then (the same lifetime contract as aws_http_connection_manager_acquire_connection).
+ */
+AWS_HTTP_API
+void aws_http_connection_manager_acquire_transformed_connection(
+    struct aws_http_connection_manager *manager,
+    struct aws_http_message *message,
+    aws_http_message_transform_fn *transform,
+    void *transform_user_data,
+    aws_http_connection_manager_on_transformed_connection_setup_fn *callback,
+    void *user_data);
+
+/*
+ * Fills in a metrics snapshot for the manager; see struct aws_http_connection_manager_metrics
+ * for semantics.  May be called from any thread.
+ */
+AWS_HTTP_API
+void aws_http_connection_manager_fetch_metrics(
+    struct aws_http_connection_manager *manager,
+    struct aws_http_connection_manager_metrics *metrics);
+
 /*
  * Returns a connection back to the manager.  All acquired connections must
  * eventually be released back to the manager in order to avoid a resource leak.
@@ -118,6 +332,42 @@ int aws_http_connection_manager_release_connection(
     struct aws_http_connection_manager *manager,
     struct aws_http_connection *connection);
 
+/*
+ * Creates a new host pool with the supplied configuration options.
+ */
+AWS_HTTP_API
+struct aws_http_host_pool *aws_http_host_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_http_host_pool_options *options);
+
+/*
+ * Begins the pool's shutdown.  All cached per-host managers are released; the pool
+ * destroys itself (and invokes shutdown_complete_callback) once every manager has
+ * finished its own asynchronous shutdown.
+ */
+AWS_HTTP_API
+void aws_http_host_pool_release(struct aws_http_host_pool *pool);
+
+/*
+ * Requests a connection to the given host from the pool, lazily creating and caching a
+ * per-host connection manager as needed.  Same callback contract as
+ * aws_http_connection_manager_acquire_connection; connections must be released back via
+ * aws_http_host_pool_release_connection.
+ */
+AWS_HTTP_API
+void aws_http_host_pool_acquire_connection(
+    struct aws_http_host_pool *pool,
+    struct aws_byte_cursor host,
+    uint16_t port,
+    aws_http_connection_manager_on_connection_setup_fn *callback,
+    void *user_data);
+
+/*
+ * Returns a connection acquired through the pool back to its owning per-host manager.
+ */
+AWS_HTTP_API
+int aws_http_host_pool_release_connection(struct aws_http_host_pool *pool, struct aws_http_connection *connection);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_HTTP_CONNECTION_MANAGER_H */
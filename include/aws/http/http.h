@@ -49,6 +49,12 @@ enum aws_http_errors {
     AWS_ERROR_HTTP_PROTOCOL_ERROR,
     AWS_ERROR_HTTP_STREAM_CLOSED,
     AWS_ERROR_HTTP_INVALID_FRAME_SIZE,
+    AWS_ERROR_HTTP_STREAM_TIMEOUT,
+    AWS_ERROR_HTTP_HEADER_LINE_TOO_LARGE,
+    AWS_ERROR_HTTP_SERVER_BUDGET_EXCEEDED,
+    AWS_ERROR_HTTP_HOST_POOL_BUDGET_EXCEEDED,
+    AWS_ERROR_HTTP_PING_TIMEOUT,
+    AWS_ERROR_HTTP_GOAWAY_RECEIVED,
 
     AWS_ERROR_HTTP_END_RANGE = 0x0C00,
 };
@@ -19,6 +19,7 @@
 #include <aws/http/connection.h>
 
 #include <aws/http/private/http_impl.h>
+#include <aws/http/private/stream_pool.h>
 #include <aws/http/server.h>
 
 #include <aws/common/atomics.h>
@@ -67,6 +68,14 @@ struct aws_http_connection_vtable {
     void (*close)(struct aws_http_connection *connection);
     bool (*is_open)(const struct aws_http_connection *connection);
     void (*update_window)(struct aws_http_connection *connection, size_t increment_size);
+
+    /* True if any stream is currently in progress on the connection.
+     * Must be called on the connection's channel thread. */
+    bool (*is_transfer_active)(const struct aws_http_connection *connection);
+
+    /* Stop servicing HTTP streams and forward raw aws_io_messages between channel neighbors.
+     * NULL for protocols with no notion of upgrade. */
+    int (*convert_to_midchannel_handler)(struct aws_http_connection *connection);
 };
 
 typedef int(aws_http_proxy_request_transform_fn)(struct aws_http_message *request, void *user_data);
@@ -83,13 +92,32 @@ struct aws_http_connection {
     enum aws_http_version http_version;
     size_t initial_window_size;
 
+    /* Running totals of bytes read from, and written to, the channel.
+     * Only touched on the channel thread. Sampled by the optional connection monitor. */
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+
+    /* Written once during client connection establishment, before the setup callback fires.
+     * All zero on server connections. */
+    struct aws_http_connection_setup_timing setup_timing;
+
     aws_http_proxy_request_transform_fn *proxy_request_transform;
     void *user_data;
 
+    /* Set (once) when the peer signals it will accept no further requests
+     * (HTTP/2 GOAWAY, or an HTTP/1 response carrying "Connection: close").
+     * In-flight streams may still finish, but the connection must not be vended for new work. */
+    struct aws_atomic_var is_draining;
+    aws_http_on_client_connection_draining_fn *on_draining;
+    void *on_draining_user_data;
+
     /* Connection starts with 1 hold for the user.
      * aws_http_streams will also acquire holds on their connection for the duration of their lifetime */
     struct aws_atomic_var refcount;
 
+    /* Recycles this connection's stream objects, so back-to-back requests don't hit the allocator. */
+    struct aws_http_stream_pool stream_pool;
+
     union {
         struct aws_http_connection_client_data {
             uint8_t delete_me; /* exists to prevent "empty struct" errors */
@@ -113,11 +141,26 @@ struct aws_http_client_bootstrap {
     struct aws_allocator *alloc;
     bool is_using_tls;
     size_t initial_window_size;
+    size_t max_pipelined_requests;
+    size_t window_update_threshold;
+    size_t preferred_write_message_size;
+    bool adaptive_window_management;
+    uint64_t http2_ping_period_ms;
+    uint64_t http2_ping_timeout_ms;
+
+    /* Enabled when monitoring_options.minimum_throughput_bytes_per_second is non-zero. */
+    struct aws_http_connection_monitoring_options monitoring_options;
+
     void *user_data;
     aws_http_on_client_connection_setup_fn *on_setup;
     aws_http_on_client_connection_shutdown_fn *on_shutdown;
+    aws_http_on_client_connection_draining_fn *on_draining;
     aws_http_proxy_request_transform_fn *proxy_request_transform;
 
+    /* Carried here until the connection object exists to hold the full setup timing */
+    uint64_t connect_start_timestamp_ns;
+    uint64_t channel_complete_timestamp_ns;
+
     struct aws_http_connection *connection;
 };
 
@@ -137,6 +180,13 @@ int aws_http_client_connect_internal(
 AWS_HTTP_API
 void aws_http_connection_acquire(struct aws_http_connection *connection);
 
+/**
+ * Called by protocol implementations when the peer signals it will accept no further requests.
+ * Idempotent; the first call marks the connection draining and fires the on_draining callback.
+ */
+AWS_HTTP_API
+void aws_http_connection_signal_draining(struct aws_http_connection *connection);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_HTTP_CONNECTION_IMPL_H */
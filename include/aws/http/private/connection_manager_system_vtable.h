@@ -20,10 +20,18 @@
 
 #include <aws/http/connection.h>
 
+struct aws_http_connection_manager;
+struct aws_http_host_pool;
+
 typedef int(aws_http_connection_manager_create_connection_fn)(const struct aws_http_client_connection_options *options);
 typedef void(aws_http_connection_manager_close_connection_fn)(struct aws_http_connection *connection);
 typedef void(aws_http_connection_manager_release_connection_fn)(struct aws_http_connection *connection);
 typedef bool(aws_http_connection_manager_is_connection_open_fn)(const struct aws_http_connection *connection);
+typedef bool(aws_http_connection_manager_is_connection_draining_fn)(const struct aws_http_connection *connection);
+typedef uint64_t(aws_http_connection_manager_get_thread_id_fn)(void);
+typedef void(aws_http_connection_manager_get_setup_timing_fn)(
+    const struct aws_http_connection *connection,
+    struct aws_http_connection_setup_timing *out_timing);
 
 struct aws_http_connection_manager_system_vtable {
     /*
@@ -33,6 +41,30 @@ struct aws_http_connection_manager_system_vtable {
     aws_http_connection_manager_close_connection_fn *close_connection;
     aws_http_connection_manager_release_connection_fn *release_connection;
     aws_http_connection_manager_is_connection_open_fn *is_connection_open;
+
+    /*
+     * Whether the peer has signaled it will accept no further requests on the connection.
+     * Optional; if NULL, connections are assumed not to be draining.
+     */
+    aws_http_connection_manager_is_connection_draining_fn *is_connection_draining;
+
+    /*
+     * Clock used to timestamp idle connections for the reaper.  Optional; if NULL,
+     * aws_high_res_clock_get_ticks is used.  Overridable so tests can control time.
+     */
+    aws_io_clock_fn *get_monotonic_time;
+
+    /*
+     * Thread identity used for event-loop-affine vending.  Optional; if NULL,
+     * aws_thread_current_thread_id is used.  Overridable so tests can fake threads.
+     */
+    aws_http_connection_manager_get_thread_id_fn *get_current_thread_id;
+
+    /*
+     * Connection-establishment timestamps recorded by the http layer.  Optional; if NULL,
+     * connect timing is not accumulated into the manager's metrics.
+     */
+    aws_http_connection_manager_get_setup_timing_fn *get_connection_setup_timing;
 };
 
 AWS_HTTP_API
@@ -43,6 +75,15 @@ void aws_http_connection_manager_set_system_vtable(
     struct aws_http_connection_manager *manager,
     const struct aws_http_connection_manager_system_vtable *system_vtable);
 
+/*
+ * Applied to every per-host manager the pool creates from this point on; managers
+ * created before the call keep whatever vtable they already have.
+ */
+AWS_HTTP_API
+void aws_http_host_pool_set_system_vtable(
+    struct aws_http_host_pool *pool,
+    const struct aws_http_connection_manager_system_vtable *system_vtable);
+
 AWS_HTTP_API
 extern const struct aws_http_connection_manager_system_vtable *g_aws_http_connection_manager_default_system_vtable_ptr;
 
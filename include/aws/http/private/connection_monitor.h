@@ -0,0 +1,74 @@
+#ifndef AWS_HTTP_CONNECTION_MONITOR_H
+#define AWS_HTTP_CONNECTION_MONITOR_H
+
+/*
+ * Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/connection.h>
+
+#include <aws/io/channel.h>
+
+/**
+ * Watches throughput on an HTTP connection.
+ * Created at connection establishment when monitoring options were passed to aws_http_client_connect().
+ * A repeating channel task samples the connection's byte counters roughly once per second and closes
+ * the connection when a transfer stays below the configured minimum throughput for too long.
+ * The monitor frees itself when the connection closes or the channel shuts down;
+ * it does not hold a reference on the connection (same lifetime rules as the connection's own channel tasks).
+ */
+struct aws_http_connection_monitor {
+    struct aws_allocator *alloc;
+    struct aws_http_connection *connection;
+    struct aws_http_connection_monitoring_options options;
+    struct aws_channel_task task;
+
+    /* State of the previous sampling tick. */
+    uint64_t last_total_bytes;
+    uint64_t last_sample_time_ns;
+    uint32_t consecutive_throughput_failures;
+};
+
+AWS_EXTERN_C_BEGIN
+
+AWS_HTTP_API
+bool aws_http_connection_monitoring_options_is_valid(const struct aws_http_connection_monitoring_options *options);
+
+/**
+ * Creates a monitor and schedules its first sampling tick.
+ * Must be called on the connection's channel thread (before channel shutdown has begun).
+ */
+AWS_HTTP_API
+struct aws_http_connection_monitor *aws_http_connection_monitor_new(
+    struct aws_allocator *alloc,
+    struct aws_http_connection *connection,
+    const struct aws_http_connection_monitoring_options *options);
+
+/**
+ * Feeds one sample into the monitor's failure tracking. Exposed for testing.
+ * total_bytes is the connection's lifetime bytes-in plus bytes-out, elapsed_ns the time since the
+ * previous sample, and transfer_active whether any stream was in progress when the sample was taken.
+ * Returns true if the transfer has now stayed below the minimum throughput for longer than the
+ * allowable failure interval.
+ */
+AWS_HTTP_API
+bool aws_http_connection_monitor_process_sample(
+    struct aws_http_connection_monitor *monitor,
+    uint64_t total_bytes,
+    uint64_t elapsed_ns,
+    bool transfer_active);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_HTTP_CONNECTION_MONITOR_H */
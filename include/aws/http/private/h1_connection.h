@@ -28,7 +28,11 @@ struct aws_http_connection *aws_http_connection_new_http1_1_server(
 AWS_HTTP_API
 struct aws_http_connection *aws_http_connection_new_http1_1_client(
     struct aws_allocator *allocator,
-    size_t initial_window_size);
+    size_t initial_window_size,
+    size_t max_pipelined_requests,
+    size_t window_update_threshold,
+    size_t preferred_write_message_size,
+    bool adaptive_window_management);
 
 AWS_EXTERN_C_END
 
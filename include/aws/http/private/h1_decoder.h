@@ -25,6 +25,9 @@
 struct aws_h1_decoder_params {
     struct aws_allocator *alloc;
     size_t scratch_space_initial_size;
+    /* Max bytes one incoming line (and with it, the scratch buffer) may grow to.
+     * Breaching it fails decoding with AWS_ERROR_HTTP_HEADER_LINE_TOO_LARGE. 0 means no limit. */
+    size_t max_scratch_size;
     /* Set false if decoding responses */
     bool is_decoding_requests;
     void *user_data;
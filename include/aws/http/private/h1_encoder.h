@@ -18,6 +18,8 @@
 #include <aws/http/private/http_impl.h>
 #include <aws/http/private/request_response_impl.h>
 
+#include <aws/common/array_list.h>
+
 /**
  * Message to be submitted to encoder.
  * Contains data necessary for encoder to write an outgoing request or response.
@@ -26,14 +28,51 @@ struct aws_h1_encoder_message {
     /* Upon creation, the "head" (everything preceding body) is buffered here. */
     struct aws_byte_buf outgoing_head_buf;
     struct aws_input_stream *body;
+    /* Vectored alternative to `body`: aws_http_body_segment entries, pulled in order
+     * (see aws_http_message_add_body_segment_stream()). Unused unless has_body_segments. */
+    struct aws_array_list body_segments;
+    bool has_body_segments;
+    uint64_t content_length;
+    bool has_connection_close_header;
+    /* True if message has "Transfer-Encoding: chunked" header. Body is framed as chunks as it streams out. */
+    bool has_chunked_encoding_header;
+    /* True if request has "Expect: 100-continue" header. The encoder pauses after the head
+     * and withholds the body until aws_h1_encoder_continue_message() is called. */
+    bool has_expect_continue_header;
+};
+
+/**
+ * A request head pre-serialized once and reused across many streams.
+ *
+ * The fixed parts of the request line and headers are cached as serialized bytes; headers
+ * whose values change per request are left as patchable slots.  Building an encoder message
+ * from a template is then just a handful of memcpys instead of a full header serialization,
+ * which matters for workloads that send near-identical requests at high rates.
+ */
+struct aws_h1_encoder_message_template {
+    /* Serialized head bytes with the variable header values omitted */
+    struct aws_byte_buf head_template;
+
+    /* Insertion points for the variable values, as `struct aws_h1_encoder_template_slot`,
+     * ordered by position in the head */
+    struct aws_array_list variable_slots;
+
+    /* Body-framing facts captured from the template request */
     uint64_t content_length;
     bool has_connection_close_header;
+    bool has_chunked_encoding_header;
+    bool has_expect_continue_header;
 };
 
 enum aws_h1_encoder_state {
     AWS_H1_ENCODER_STATE_INIT,
     AWS_H1_ENCODER_STATE_HEAD,
+    /* Head sent, body withheld until the server's interim 100 response (or a timeout).
+     * The encoder writes nothing in this state. */
+    AWS_H1_ENCODER_STATE_WAIT_FOR_CONTINUE,
     AWS_H1_ENCODER_STATE_BODY,
+    AWS_H1_ENCODER_STATE_CHUNKED_BODY,
+    AWS_H1_ENCODER_STATE_CHUNK_TERMINATOR,
     AWS_H1_ENCODER_STATE_DONE,
 };
 
@@ -43,18 +82,27 @@ struct aws_h1_encoder {
     enum aws_h1_encoder_state state;
     struct aws_h1_encoder_message *message;
     uint64_t progress_bytes;
+    /* For vectored bodies: which segment is being sent, and progress within it
+     * (cursor segments only; stream segments track their own position) */
+    size_t body_segment_index;
+    size_t body_segment_progress;
     void *logging_id;
 };
 
 AWS_EXTERN_C_BEGIN
 
-/* Validate request and cache any info the encoder will need later in the "encoder message". */
+/* Validate request and cache any info the encoder will need later in the "encoder message".
+ * If optional_head_storage is non-NULL and large enough for the encoded head, it is used as
+ * the head buffer instead of a fresh allocation; the caller's storage must then outlive the
+ * message (clean_up knows not to free it). */
 AWS_HTTP_API
 int aws_h1_encoder_message_init_from_request(
     struct aws_h1_encoder_message *message,
     struct aws_allocator *allocator,
-    const struct aws_http_message *request);
+    const struct aws_http_message *request,
+    struct aws_byte_buf *optional_head_storage);
 
+AWS_HTTP_API
 int aws_h1_encoder_message_init_from_response(
     struct aws_h1_encoder_message *message,
     struct aws_allocator *allocator,
@@ -64,6 +112,48 @@ int aws_h1_encoder_message_init_from_response(
 AWS_HTTP_API
 void aws_h1_encoder_message_clean_up(struct aws_h1_encoder_message *message);
 
+/**
+ * Get the current date formatted for a Date header value (ex: "Tue, 15 Nov 1994 08:12:31 GMT").
+ * The rendered value is cached process-wide and re-formatted at most once per second, so a
+ * server can stamp every response without paying for date formatting each time.
+ * Use the cursor promptly (ex: pass it straight to aws_http_message_add_header, which copies);
+ * it is only guaranteed stable until the clock ticks over the second after next.
+ */
+AWS_HTTP_API
+int aws_h1_encoder_cached_date(struct aws_byte_cursor *out_date);
+
+/**
+ * Pre-encode a request into a reusable template.  Each name in variable_header_names marks a
+ * header whose value will be supplied per request; every such name must match exactly one
+ * header of the request (matching is case-insensitive).  The request's own values for those
+ * headers act only as placeholders for validation and are not cached.
+ */
+AWS_HTTP_API
+int aws_h1_encoder_message_template_init_from_request(
+    struct aws_h1_encoder_message_template *message_template,
+    struct aws_allocator *allocator,
+    const struct aws_http_message *request,
+    const struct aws_byte_cursor *variable_header_names,
+    size_t variable_header_count);
+
+/**
+ * Build an encoder message from a template by patching in this request's variable header
+ * values, supplied in the order the corresponding headers appear in the original request.
+ * If Content-Length is one of the variable headers, its supplied value also sets the
+ * message's body framing.  The body stream may be NULL for bodyless requests.
+ */
+AWS_HTTP_API
+int aws_h1_encoder_message_init_from_template(
+    struct aws_h1_encoder_message *message,
+    struct aws_allocator *allocator,
+    const struct aws_h1_encoder_message_template *message_template,
+    const struct aws_byte_cursor *variable_header_values,
+    size_t variable_header_count,
+    struct aws_input_stream *body);
+
+AWS_HTTP_API
+void aws_h1_encoder_message_template_clean_up(struct aws_h1_encoder_message_template *message_template);
+
 AWS_HTTP_API
 void aws_h1_encoder_init(struct aws_h1_encoder *encoder, struct aws_allocator *allocator);
 
@@ -82,6 +172,30 @@ int aws_h1_encoder_process(struct aws_h1_encoder *encoder, struct aws_byte_buf *
 AWS_HTTP_API
 bool aws_h1_encoder_is_message_in_progress(const struct aws_h1_encoder *encoder);
 
+/**
+ * True if the encoder has sent the head of an "Expect: 100-continue" request and is
+ * withholding its body.
+ */
+AWS_HTTP_API
+bool aws_h1_encoder_is_waiting_for_continue(const struct aws_h1_encoder *encoder);
+
+/**
+ * Release a withheld body: the next aws_h1_encoder_process() call resumes in the body state.
+ * Call when the interim 100 response arrives, or when tired of waiting for one.
+ */
+AWS_HTTP_API
+void aws_h1_encoder_continue_message(struct aws_h1_encoder *encoder);
+
+/**
+ * Abandon a withheld body: the message finishes without it.
+ * Call when a final response arrives instead of the interim 100; the server has already
+ * judged the request, so streaming the body would be wasted bandwidth.
+ * Note that an unsent body leaves the message shorter than its declared framing, so the
+ * caller must not reuse the connection for further requests.
+ */
+AWS_HTTP_API
+void aws_h1_encoder_abandon_waiting_body(struct aws_h1_encoder *encoder);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_HTTP_H1_ENCODER_H */
@@ -18,12 +18,21 @@
 #include <aws/http/private/h1_encoder.h>
 #include <aws/http/private/http_impl.h>
 #include <aws/http/private/request_response_impl.h>
+#include <aws/http/private/timing_wheel.h>
+
+enum {
+    AWS_H1_STREAM_OUTGOING_HEAD_STORAGE_SIZE = 1024,
+};
 
 struct aws_h1_stream {
     struct aws_http_stream base;
 
     struct aws_linked_list_node node;
 
+    /* Link in the connection's lock-free new-stream queue. Only touched between
+     * aws_http_connection_make_request() and the connection's drain task. */
+    struct aws_h1_stream *new_stream_next;
+
     /* Message (derived from outgoing request or response) to be submitted to encoder */
     struct aws_h1_encoder_message encoder_message;
 
@@ -39,11 +48,29 @@ struct aws_h1_stream {
     /* Buffer for incoming data that needs to stick around. */
     struct aws_byte_buf incoming_storage_buf;
 
+    /* Optional response deadlines (0 = none), measured from when the request begins to send.
+     * The timers live in the connection's timing wheel and are only touched on the channel thread. */
+    uint64_t response_first_byte_timeout_ms;
+    uint64_t response_timeout_ms;
+    struct aws_http_timing_wheel_timer first_byte_timer;
+    struct aws_http_timing_wheel_timer response_timer;
+
+    /* How long an "Expect: 100-continue" request waits for a response before sending its
+     * body anyway (0 = wait indefinitely). The timer is only armed while the encoder is
+     * withholding this stream's body. */
+    uint64_t expect_100_continue_timeout_ms;
+    struct aws_http_timing_wheel_timer continue_timer;
+
     /* Any thread may touch this data, but the lock must be held */
     struct {
         /* Whether a "request handler" stream has a response to send. */
         bool has_outgoing_response;
     } synced_data;
+
+    /* Inline storage for the encoder message's head buffer. Most request heads fit here,
+     * so submitting a request touches only the stream's own (pooled) allocation; heads
+     * that don't fit fall back to a heap buffer. */
+    uint8_t outgoing_head_storage[AWS_H1_STREAM_OUTGOING_HEAD_STORAGE_SIZE];
 };
 
 AWS_EXTERN_C_BEGIN
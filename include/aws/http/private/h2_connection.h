@@ -16,17 +16,121 @@
  * permissions and limitations under the License.
  */
 
+#include <aws/common/array_list.h>
 #include <aws/common/atomics.h>
+#include <aws/common/hash_table.h>
+#include <aws/common/linked_list.h>
 #include <aws/common/mutex.h>
 
 #include <aws/http/private/connection_impl.h>
+#include <aws/http/private/h2_frames.h>
+
+enum {
+    /* Default SETTINGS_MAX_FRAME_SIZE [RFC-7540 6.5.2] */
+    AWS_H2_DEFAULT_MAX_FRAME_SIZE = 16384,
+
+    /* PING frames always carry exactly 8 bytes of opaque data [RFC-7540 6.7] */
+    AWS_H2_PING_DATA_SIZE = 8,
+};
+
+/**
+ * Snapshot of the connection's flow-control auto-tuning state.
+ * Lets callers verify that the advertised windows have actually grown to saturate the link.
+ */
+struct aws_http2_window_stats {
+    /* Receive window the connection currently advertises to the peer */
+    size_t window_target;
+
+    /* Bytes delivered during the most recent RTT sample (the bandwidth-delay product estimate) */
+    size_t bdp_estimate;
+
+    /* Smoothed round-trip time measured via PING frames, in nanoseconds */
+    uint64_t rtt_ns;
+};
 
 struct aws_h2_connection {
     struct aws_http_connection base;
 
+    /* Single task used repeatedly for writing frames from streams. */
+    struct aws_channel_task outgoing_frames_task;
+
+    /* Periodic task driving PING keepalive/liveness probing. */
+    struct aws_channel_task keepalive_task;
+
     /* Only the event-loop thread may touch this data */
     struct {
-        struct aws_h2_decoder *decoder;
+        struct aws_h2_frame_decoder frame_decoder;
+        struct aws_h2_frame_encoder frame_encoder;
+
+        /* Map of stream-id -> aws_h2_stream* for O(1) routing of incoming frames.
+         * Holds 1 refcount on each stream until the stream completes. */
+        struct aws_hash_table active_streams;
+
+        /* Streams that still have frames to send, serviced round-robin by the outgoing-frames task */
+        struct aws_linked_list outgoing_streams;
+
+        /* Reassembles a frame whose bytes were split across multiple io messages.
+         * The frame codec operates on one whole contiguous frame at a time. */
+        struct aws_byte_buf frame_assembly_buf;
+
+        /* Scratch for lowercasing header names and for reading one DATA frame's worth of request body */
+        struct aws_byte_buf encode_scratch_buf;
+
+        /* Peer's SETTINGS_MAX_FRAME_SIZE. We never exceed it when encoding DATA. */
+        uint32_t remote_max_frame_size;
+
+        /* Control frames the read path owes the peer, written by the next run of the outgoing-frames task */
+        bool settings_ack_pending;
+        bool ping_ack_pending;
+        uint8_t ping_ack_payload[AWS_H2_PING_DATA_SIZE];
+
+        /**
+         * Receive flow-control auto-tuning. Incoming DATA consumes the advertised windows;
+         * replenishing WINDOW_UPDATE frames are queued here and flushed by the outgoing-frames
+         * task. PING round-trips sample the path RTT, the bytes delivered during a sample
+         * estimate the bandwidth-delay product, and window_target tracks the estimate so long
+         * fat links don't stall while short links don't hoard memory.
+         */
+        struct aws_array_list pending_window_updates; /* contains struct aws_h2_pending_window_update */
+        size_t window_target;
+        size_t connection_window_advertised;
+        bool window_settings_pending;
+
+        bool bdp_ping_pending;
+        bool bdp_ping_in_flight;
+        uint8_t bdp_ping_payload[AWS_H2_PING_DATA_SIZE];
+        uint64_t bdp_ping_send_time_ns;
+        uint64_t bdp_ping_counter;
+        size_t bdp_bytes_this_sample;
+
+        /**
+         * PING keepalive/liveness probing (see aws_http_connection_new_http2_client).
+         * A dedicated PING (distinct from the BDP-sampling one, so idle probes don't
+         * perturb window tuning) is sent every ping_period_ns; a probe that isn't acked
+         * within ping_timeout_ns closes the connection, so pooled connections that died
+         * across a NAT timeout are evicted instead of vended. Acks also feed the
+         * smoothed RTT in window_stats.
+         */
+        uint64_t ping_period_ns; /* 0 = keepalive disabled */
+        uint64_t ping_timeout_ns;
+        bool keepalive_ping_pending;
+        bool keepalive_ping_in_flight;
+        uint8_t keepalive_ping_payload[AWS_H2_PING_DATA_SIZE];
+        uint64_t keepalive_ping_send_time_ns;
+        uint64_t keepalive_ping_counter;
+        bool is_keepalive_task_scheduled;
+
+        /**
+         * Peer sent GOAWAY with NO_ERROR: no new streams may start, but streams at or below
+         * goaway_last_stream_id may run to completion. The connection shuts down once the
+         * last of them finishes.
+         */
+        bool goaway_received;
+        uint32_t goaway_last_stream_id;
+
+        bool is_preface_sent;
+        bool is_reading_stopped;
+        bool is_writing_stopped;
     } thread_data;
 
     /* Any thread may touch this data, but the lock must be held */
@@ -35,6 +139,19 @@ struct aws_h2_connection {
 
         /* Refers to the next stream id to vend */
         uint32_t next_stream_id;
+
+        /* New streams that have not been moved to `active_streams` yet */
+        struct aws_linked_list pending_stream_list;
+
+        bool is_outgoing_frames_task_active;
+        bool is_open;
+
+        /* If non-zero, reason to immediately reject new streams. (ex: closing) */
+        int new_stream_error_code;
+
+        /* Latest auto-tuning measurements, readable from any thread via
+         * aws_h2_connection_get_window_stats() */
+        struct aws_http2_window_stats window_stats;
     } synced_data;
 };
 
@@ -45,14 +162,30 @@ struct aws_http_connection *aws_http_connection_new_http2_server(
     struct aws_allocator *allocator,
     size_t initial_window_size);
 
+/**
+ * `ping_period_ms` enables PING keepalive: a probe is sent whenever the connection has been
+ * quiet for that long, and the connection is closed with AWS_ERROR_HTTP_PING_TIMEOUT if an
+ * ack doesn't arrive within `ping_timeout_ms` (0 picks a default). 0 disables keepalive.
+ */
 AWS_HTTP_API
 struct aws_http_connection *aws_http_connection_new_http2_client(
     struct aws_allocator *allocator,
-    size_t initial_window_size);
+    size_t initial_window_size,
+    uint64_t ping_period_ms,
+    uint64_t ping_timeout_ms);
 
 AWS_HTTP_API
 uint32_t aws_h2_connection_get_next_stream_id(struct aws_h2_connection *connection);
 
+/**
+ * Copies out the latest flow-control auto-tuning measurements. Safe to call from any thread.
+ * The connection must be an HTTP/2 connection.
+ */
+AWS_HTTP_API
+void aws_h2_connection_get_window_stats(
+    struct aws_http_connection *connection,
+    struct aws_http2_window_stats *out_stats);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_HTTP_H2_CONNECTION_H */
@@ -18,9 +18,16 @@
 
 #include <aws/http/private/http_impl.h>
 
+struct aws_http_header;
+
 struct aws_h2_decoder_vtable {
 
     int (*on_headers)(uint32_t stream_id, void *userdata);
+
+    /* Fired per header field, as soon as its bytes have arrived. A header block split
+     * across HEADERS and CONTINUATION frames streams out without waiting for END_HEADERS. */
+    int (*on_header)(uint32_t stream_id, const struct aws_http_header *header, void *userdata);
+
     int (*on_end_headers)(uint32_t stream_id, void *userdata);
 
     int (*on_data)(uint32_t stream_id, const struct aws_byte_cursor *data, void *userdata);
@@ -229,12 +229,26 @@ struct aws_h2_frame_continuation {
     struct aws_h2_frame_header_block header_block;
 };
 
+/* Controls when the encoder Huffman-codes header strings */
+enum aws_h2_frame_huffman_mode {
+    AWS_H2_HUFFMAN_MODE_NEVER = 0,
+    AWS_H2_HUFFMAN_MODE_ALWAYS,
+
+    /* Decide per string: Huffman-code only when it's shorter than the raw bytes.
+     * Compressible text shrinks, while base64-ish values skip the coding cost. */
+    AWS_H2_HUFFMAN_MODE_AUTO,
+};
+
 /* Used to encode a frame */
 struct aws_h2_frame_encoder {
     /* Larger state */
     struct aws_allocator *allocator;
     struct aws_hpack_context *hpack;
-    bool use_huffman;
+    enum aws_h2_frame_huffman_mode huffman_mode;
+
+    /* Reusable staging buffer for single-pass header-block encoding; holds the block
+     * staged by aws_h2_frame_header_block_encode until it is written to a frame. */
+    struct aws_byte_buf header_block_scratch;
 };
 
 /* Used to decode a frame */
@@ -260,16 +274,18 @@ AWS_HTTP_API
 int aws_h2_frame_header_block_init(struct aws_h2_frame_header_block *header_block, struct aws_allocator *allocator);
 AWS_HTTP_API
 void aws_h2_frame_header_block_clean_up(struct aws_h2_frame_header_block *header_block);
-AWS_HTTP_API
-int aws_h2_frame_header_block_get_encoded_length(
-    const struct aws_h2_frame_header_block *header_block,
-    const struct aws_h2_frame_encoder *encoder,
-    size_t *length);
+/* Encode the block in a single HPACK pass into the encoder's staging buffer, reporting the
+ * exact encoded length so the enclosing frame's header can be written first.  Each field pays
+ * for one table lookup and one Huffman cost computation; dynamic-table insertions take effect
+ * immediately, so the reported length always matches the staged bytes. */
 AWS_HTTP_API
 int aws_h2_frame_header_block_encode(
     const struct aws_h2_frame_header_block *header_block,
     struct aws_h2_frame_encoder *encoder,
-    struct aws_byte_buf *output);
+    size_t *out_length);
+/* Copy the block staged by aws_h2_frame_header_block_encode into output */
+AWS_HTTP_API
+int aws_h2_frame_header_block_write(struct aws_h2_frame_encoder *encoder, struct aws_byte_buf *output);
 AWS_HTTP_API
 int aws_h2_frame_header_block_decode(
     struct aws_h2_frame_header_block *header_block,
@@ -425,6 +441,40 @@ int aws_h2_frame_continuation_encode(
 AWS_HTTP_API
 int aws_h2_frame_continuation_decode(struct aws_h2_frame_continuation *frame, struct aws_h2_frame_decoder *decoder);
 
+/*
+ * Direct encoding.
+ * The functions below serialize small fixed-layout frames straight into the output buffer,
+ * with no frame object to init/clean up and no allocation. Use these on hot paths that emit
+ * many control frames (acks, WINDOW_UPDATE, RST_STREAM); multiple frames written back-to-back
+ * into the same buffer travel in one channel message. On failure the output buffer is
+ * restored to its prior length.
+ */
+
+/* A single identifier/value pair for aws_h2_frame_settings_encode_direct */
+struct aws_h2_frame_setting {
+    uint16_t identifier;
+    uint32_t value;
+};
+
+AWS_HTTP_API
+int aws_h2_frame_ping_encode_direct(bool ack, const uint8_t *opaque_data, struct aws_byte_buf *output);
+AWS_HTTP_API
+int aws_h2_frame_window_update_encode_direct(
+    uint32_t stream_id,
+    uint32_t window_size_increment,
+    struct aws_byte_buf *output);
+AWS_HTTP_API
+int aws_h2_frame_rst_stream_encode_direct(
+    uint32_t stream_id,
+    enum aws_h2_error_codes error_code,
+    struct aws_byte_buf *output);
+AWS_HTTP_API
+int aws_h2_frame_settings_encode_direct(
+    bool ack,
+    const struct aws_h2_frame_setting *settings,
+    size_t num_settings,
+    struct aws_byte_buf *output);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_HTTP_H2_FRAMES_H */
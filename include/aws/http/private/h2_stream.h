@@ -19,8 +19,14 @@
 #include <aws/http/private/h2_frames.h>
 #include <aws/http/private/request_response_impl.h>
 
+#include <aws/common/linked_list.h>
 #include <aws/common/mutex.h>
 
+enum {
+    /* Weight assigned to streams that don't request one [RFC-7540 5.3.5] */
+    AWS_H2_STREAM_DEFAULT_WEIGHT = 16,
+};
+
 enum aws_h2_stream_state {
     AWS_H2_STREAM_STATE_IDLE,
     AWS_H2_STREAM_STATE_RESERVED_LOCAL,
@@ -38,11 +44,40 @@ struct aws_h2_stream {
 
     const uint32_t id;
 
+    /* The connection files this stream in its pending/outgoing lists via this node */
+    struct aws_linked_list_node node;
+
     /* Only the event-loop thread may touch this data */
     struct {
         bool expects_continuation;
         enum aws_h2_stream_state state;
         uint64_t window_size; /* #TODO try to figure out how this actually works, and then implement it */
+
+        /* Request being sent on this stream. Stream keeps a reference until it's destroyed. */
+        struct aws_http_message *request;
+        struct aws_input_stream *request_body;
+
+        bool sent_headers;
+        bool sent_end_stream;
+
+        /* Deficit-round-robin scheduling of outgoing DATA [RFC-7540 5.3.2 weights].
+         * Each scheduler pass earns the stream weight-proportional byte credit;
+         * sending spends it. */
+        uint32_t weight;
+        size_t data_deficit;
+
+        /* DATA bytes received since the last stream-level WINDOW_UPDATE the connection queued for us */
+        size_t recv_window_consumed;
+
+        /* END_STREAM arrived on a HEADERS frame whose block continues in CONTINUATION frames.
+         * Applied to the state machine once the block completes. */
+        bool pending_received_end_stream;
+
+        /* True while the connection's outgoing-streams list contains this stream */
+        bool in_outgoing_list;
+
+        /* Error code to deliver via on_complete once the connection notices the stream is CLOSED */
+        int completion_error_code;
     } thread_data;
 
     /* Any thread may touch this data, but the lock must be held */
@@ -60,13 +95,21 @@ AWS_HTTP_API
 const char *aws_h2_stream_state_to_str(enum aws_h2_stream_state state);
 
 AWS_HTTP_API
-struct aws_h2_stream *aws_h1_stream_new_request(
+struct aws_h2_stream *aws_h2_stream_new(
     struct aws_http_connection *client_connection,
     const struct aws_http_make_request_options *options);
 
 AWS_HTTP_API
 int aws_h2_stream_handle_frame(struct aws_h2_stream *stream, struct aws_h2_frame_decoder *decoder);
 
+/**
+ * Informs the stream's state machine that the connection just wrote one of its frames to the wire.
+ * Drives the send-side transitions of RFC-7540 5.1 (IDLE -> OPEN on HEADERS,
+ * -> HALF_CLOSED_LOCAL/CLOSED when END_STREAM is sent).
+ */
+AWS_HTTP_API
+void aws_h2_stream_on_frame_sent(struct aws_h2_stream *stream, enum aws_h2_frame_type type, bool end_stream);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_HTTP_H2_STREAM_H */
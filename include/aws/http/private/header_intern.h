@@ -0,0 +1,61 @@
+#ifndef AWS_HTTP_HEADER_INTERN_H
+#define AWS_HTTP_HEADER_INTERN_H
+
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/http_impl.h>
+
+/**
+ * An entry in the global read-only table of common header names.
+ * `name` holds the conventional capitalization (ex: "Content-Length") and `lowercase`
+ * the case-folded form used on the HTTP/2 wire. Both cursors remain valid until
+ * aws_http_library_clean_up(), so callers may store them instead of copying the bytes.
+ */
+struct aws_http_interned_header {
+    struct aws_byte_cursor name;
+    struct aws_byte_cursor lowercase;
+
+    /* aws_http_header_name_hash() of the name */
+    uint32_t hash;
+
+    /* AWS_HTTP_HEADER_UNKNOWN unless internal processing cares about this header */
+    enum aws_http_header_name name_enum;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/* Called from aws_http_library_init() / aws_http_library_clean_up() */
+void aws_http_header_intern_table_init(struct aws_allocator *alloc);
+void aws_http_header_intern_table_clean_up(void);
+
+/**
+ * Case-folded FNV-1a hash of a header name.
+ * Equal for names that differ only in capitalization.
+ */
+AWS_HTTP_API
+uint32_t aws_http_header_name_hash(struct aws_byte_cursor name);
+
+/**
+ * Find the interned entry whose name matches `name`, ignoring case.
+ * Returns NULL if the name is not a common header.
+ * Costs a single hash probe; the spellings seen in practice are confirmed with one memcmp.
+ */
+AWS_HTTP_API
+const struct aws_http_interned_header *aws_http_header_intern_lookup(struct aws_byte_cursor name);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_HTTP_HEADER_INTERN_H */
@@ -23,6 +23,22 @@ struct aws_byte_cursor;
 struct aws_http_header;
 struct aws_hpack_context;
 
+/**
+ * Result of one aws_hpack_decode() call.
+ * A header block may be split across frames at any byte, so a call may consume input
+ * without yet completing an entry.
+ */
+struct aws_hpack_decode_result {
+    enum aws_hpack_decode_type {
+        AWS_HPACK_DECODE_T_ONGOING,      /* all input consumed, entry not complete yet */
+        AWS_HPACK_DECODE_T_HEADER_FIELD, /* a whole header field was decoded */
+    } type;
+
+    /* Valid when type is AWS_HPACK_DECODE_T_HEADER_FIELD.
+     * The cursors are valid until the next aws_hpack_decode() call. */
+    struct aws_http_header header_field;
+};
+
 AWS_EXTERN_C_BEGIN
 
 /* Library-level init and shutdown */
@@ -79,6 +95,19 @@ int aws_hpack_decode_string(
     struct aws_byte_cursor *to_decode,
     struct aws_byte_buf *output);
 
+/**
+ * Decode the next entry of a header block, resuming wherever the previous call left off.
+ * Partial-integer, partial-string, and partial-Huffman-code state is carried in the context,
+ * so the input may be cut at any byte (ex: at a HEADERS/CONTINUATION frame boundary) with no
+ * reassembly buffer. Consumes input until either one header field completes (input may remain)
+ * or the input runs dry mid-entry. Dynamic table size updates are applied internally.
+ */
+AWS_HTTP_API
+int aws_hpack_decode(
+    struct aws_hpack_context *context,
+    struct aws_byte_cursor *to_decode,
+    struct aws_hpack_decode_result *result);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_HTTP_HPACK_H */
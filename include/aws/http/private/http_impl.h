@@ -54,6 +54,13 @@ enum aws_http_status {
     AWS_HTTP_STATUS_304_NOT_MODIFIED = 304,
 };
 
+/**
+ * The cursors in this struct are borrowed, not copied.
+ * If the entire header line arrived within a single `aws_h*_decode` call they point directly
+ * into the caller's input buffer; a header that straddled calls is assembled in the decoder's
+ * scratch buffer and the cursors point there instead. Either way they are only valid for the
+ * duration of the callback.
+ */
 struct aws_http_decoded_header {
     /* Name of the header. If the type is `AWS_HTTP_HEADER_NAME_UNKNOWN` then `name_data` must be parsed manually. */
     enum aws_http_header_name name;
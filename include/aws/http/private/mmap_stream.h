@@ -0,0 +1,42 @@
+#ifndef AWS_HTTP_MMAP_STREAM_H
+#define AWS_HTTP_MMAP_STREAM_H
+
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/http.h>
+
+struct aws_input_stream;
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Creates a body input stream backed by a memory-mapped file.
+ *
+ * Reading a file body through a stdio-backed stream copies each byte twice before it even
+ * reaches the channel: page cache to stdio buffer, stdio buffer to the outgoing message.
+ * Mapping the file instead lets the encoder copy straight from the page cache, which
+ * roughly halves memory bandwidth for large uploads.  The mapping is read-only and is
+ * advised for sequential access; it lives until the stream is destroyed.
+ *
+ * Intended for use as an aws_http_message body stream.  Supports seeking, so the same
+ * stream can be reused across request retries.
+ */
+AWS_HTTP_API
+struct aws_input_stream *aws_http_mmap_input_stream_new(struct aws_allocator *allocator, const char *file_path);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_HTTP_MMAP_STREAM_H */
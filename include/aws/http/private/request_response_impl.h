@@ -40,10 +40,17 @@ struct aws_http_stream {
 
     void *user_data;
     aws_http_on_incoming_headers_fn *on_incoming_headers;
+    aws_http_on_incoming_headers_fn *on_incoming_trailers;
     aws_http_on_incoming_header_block_done_fn *on_incoming_header_block_done;
     aws_http_on_incoming_body_fn *on_incoming_body;
     aws_http_on_stream_complete_fn *on_complete;
 
+    /* If set, incoming body bytes are appended here instead of invoking on_incoming_body */
+    struct aws_byte_buf *incoming_body_sink;
+
+    /* Lifecycle timestamps, written on the connection's thread as transitions happen */
+    struct aws_http_stream_metrics metrics;
+
     struct aws_atomic_var refcount;
     enum aws_http_method request_method;
 
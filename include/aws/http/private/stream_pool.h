@@ -0,0 +1,68 @@
+#ifndef AWS_HTTP_STREAM_POOL_H
+#define AWS_HTTP_STREAM_POOL_H
+
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/http.h>
+
+#include <aws/common/atomics.h>
+
+enum { AWS_HTTP_STREAM_POOL_SLOTS = 8 };
+
+/**
+ * Lock-free recycling pool for a connection's stream objects.
+ *
+ * Every request allocates and frees one stream struct; on a busy connection that is steady
+ * malloc/free churn for objects of a single fixed size. The pool keeps a handful of freed
+ * stream allocations in atomic slots so the next request reuses hot memory instead of going
+ * back to the allocator. Slots are compare-and-swapped, so a stream whose final release
+ * happens off the channel thread can still be recycled safely.
+ *
+ * The owning connection must outlive all of its streams (the stream's final release happens
+ * before its hold on the connection is dropped), so the pool needs no lifetime management of
+ * its own beyond clean_up at connection destruction.
+ */
+struct aws_http_stream_pool {
+    struct aws_allocator *alloc;
+
+    /* All objects in a pool are the same size; fixed when the connection is created. */
+    size_t object_size;
+
+    /* Each slot holds a freed stream allocation, or NULL. */
+    struct aws_atomic_var slots[AWS_HTTP_STREAM_POOL_SLOTS];
+};
+
+AWS_EXTERN_C_BEGIN
+
+AWS_HTTP_API
+void aws_http_stream_pool_init(struct aws_http_stream_pool *pool, struct aws_allocator *alloc, size_t object_size);
+
+/* Frees any recycled objects still parked in the pool. */
+AWS_HTTP_API
+void aws_http_stream_pool_clean_up(struct aws_http_stream_pool *pool);
+
+/* Returns a zeroed object of the pool's object_size, recycled if possible.
+ * Returns NULL on allocation failure. */
+AWS_HTTP_API
+void *aws_http_stream_pool_acquire(struct aws_http_stream_pool *pool);
+
+/* Returns an object to the pool, or frees it if all slots are occupied. */
+AWS_HTTP_API
+void aws_http_stream_pool_release(struct aws_http_stream_pool *pool, void *object);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_HTTP_STREAM_POOL_H */
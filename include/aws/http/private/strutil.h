@@ -69,5 +69,27 @@ int aws_strutil_read_unsigned_hex(struct aws_byte_cursor cursor, uint64_t *dst);
 AWS_HTTP_API
 struct aws_byte_cursor aws_strutil_trim_http_whitespace(struct aws_byte_cursor cursor);
 
+/**
+ * True if cursor is a valid HTTP token: one or more "tchar" characters.
+ * Header field names (among other things) are required to be tokens.
+ * RFC7230 section 3.2.6 Field Value Components
+ */
+AWS_HTTP_API
+bool aws_strutil_is_http_token(struct aws_byte_cursor cursor);
+
+/**
+ * True if cursor contains any uppercase ASCII character (A-Z).
+ */
+AWS_HTTP_API
+bool aws_strutil_ascii_has_uppercase(struct aws_byte_cursor cursor);
+
+/**
+ * Copy `len` bytes from src to dst, folding uppercase ASCII (A-Z) to lowercase.
+ * All other bytes are copied unchanged. dst and src may be the same buffer,
+ * but must not otherwise overlap.
+ */
+AWS_HTTP_API
+void aws_strutil_ascii_tolower(uint8_t *dst, const uint8_t *src, size_t len);
+
 AWS_EXTERN_C_END
 #endif /* AWS_HTTP_STRUTIL_H */
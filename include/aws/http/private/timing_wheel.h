@@ -0,0 +1,108 @@
+#ifndef AWS_HTTP_TIMING_WHEEL_H
+#define AWS_HTTP_TIMING_WHEEL_H
+
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/http.h>
+
+#include <aws/common/linked_list.h>
+
+struct aws_http_timing_wheel_timer;
+
+/**
+ * Invoked when an armed timer's deadline passes.
+ * The timer has already been disarmed when this fires.
+ */
+typedef void(aws_http_timing_wheel_on_timeout_fn)(struct aws_http_timing_wheel_timer *timer, void *user_data);
+
+/**
+ * One timer, embedded in the object it times (no allocation per timer).
+ * Zero it (or the struct containing it) before first use.
+ */
+struct aws_http_timing_wheel_timer {
+    /* Lives in a wheel slot's list while armed. */
+    struct aws_linked_list_node node;
+    uint64_t deadline_ns;
+    aws_http_timing_wheel_on_timeout_fn *fn;
+    void *user_data;
+    bool is_armed;
+};
+
+/**
+ * A hashed timing wheel [Varghese & Lauck].
+ * Timers hash into a slot by deadline; arming and canceling are O(1) linked-list operations.
+ * The owner drives the wheel by calling aws_http_timing_wheel_run() as time advances
+ * (in this library, from a channel task that only runs while timers are armed).
+ * Not thread-safe; intended to be owned by a single event-loop thread.
+ */
+struct aws_http_timing_wheel {
+    struct aws_allocator *alloc;
+    struct aws_linked_list *slots;
+    size_t num_slots; /* power of 2 */
+    uint64_t tick_ns;
+
+    /* Absolute tick index up to which the wheel has been run. */
+    uint64_t current_tick;
+
+    size_t armed_count;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * num_slots must be a power of 2, tick_ns non-zero.
+ * now_ns establishes the wheel's starting position.
+ */
+AWS_HTTP_API
+int aws_http_timing_wheel_init(
+    struct aws_http_timing_wheel *wheel,
+    struct aws_allocator *alloc,
+    uint64_t tick_ns,
+    size_t num_slots,
+    uint64_t now_ns);
+
+AWS_HTTP_API
+void aws_http_timing_wheel_clean_up(struct aws_http_timing_wheel *wheel);
+
+/**
+ * Arms (or re-arms) a timer to fire once deadline_ns passes.
+ * Timers fire with tick granularity: up to one tick later than the exact deadline.
+ */
+AWS_HTTP_API
+void aws_http_timing_wheel_arm(
+    struct aws_http_timing_wheel *wheel,
+    struct aws_http_timing_wheel_timer *timer,
+    uint64_t deadline_ns,
+    aws_http_timing_wheel_on_timeout_fn *fn,
+    void *user_data);
+
+/**
+ * Disarms a timer. Harmless if the timer is not armed.
+ */
+AWS_HTTP_API
+void aws_http_timing_wheel_cancel(struct aws_http_timing_wheel *wheel, struct aws_http_timing_wheel_timer *timer);
+
+/**
+ * Advances the wheel to now_ns, firing every armed timer whose deadline has passed.
+ * Callbacks are invoked after the due timers have been collected, so they may
+ * safely arm or cancel timers on this wheel.
+ */
+AWS_HTTP_API
+void aws_http_timing_wheel_run(struct aws_http_timing_wheel *wheel, uint64_t now_ns);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_HTTP_TIMING_WHEEL_H */
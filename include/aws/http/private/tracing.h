@@ -0,0 +1,63 @@
+#ifndef AWS_HTTP_TRACING_H
+#define AWS_HTTP_TRACING_H
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/**
+ * Static tracepoints (USDT probes) on the library's hot paths, so per-request flow can be
+ * traced in production with perf/bpftrace/dtrace without rebuilding or enabling logging.
+ *
+ * The probes exist only when the library is built with -DENABLE_USDT_TRACING=ON; otherwise
+ * every macro below expands to nothing. Even when compiled in, a probe site costs a single
+ * nop instruction until a tracer attaches to it, so tracing-enabled builds are safe to ship.
+ *
+ * All probes use provider "aws_http":
+ *
+ *   h1_outgoing_stream_send(connection, stream, bytes)
+ *       One filled aws_io_message leaving the HTTP/1.1 write path. `stream` is the stream
+ *       still mid-message, NULL if every stream in the message completed.
+ *   h1_read_message(connection, stream, bytes)
+ *       One aws_io_message entering the HTTP/1.1 read path. `stream` is the stream receiving
+ *       the response when the message arrived, NULL if between responses.
+ *   h1_decode_line(decoder, buffered_bytes, input_bytes)
+ *       The HTTP/1.1 decoder's line-scanning state ran: `buffered_bytes` were carried over
+ *       from earlier deliveries, `input_bytes` remain to scan.
+ *   connection_manager_acquire(manager, count)
+ *       A user asked the connection manager for `count` connections.
+ *   connection_manager_release(manager, connection)
+ *       A user returned a connection to the manager.
+ *   connection_manager_vend(manager, connection, error_code)
+ *       The manager completed one acquisition (connection NULL if error_code non-zero).
+ *   h2_frame_encode(type, stream_id, payload_len)
+ *       An HTTP/2 frame header was written to the wire.
+ *   h2_frame_decode(decoder, type, stream_id, payload_len)
+ *       An HTTP/2 frame header was read off the wire.
+ *
+ * Example:
+ *   bpftrace -e 'usdt:./libaws-c-http.so:aws_http:h1_read_message { @bytes[arg0] = sum(arg2); }'
+ */
+
+#ifdef AWS_HTTP_ENABLE_USDT_TRACING
+#    include <sys/sdt.h>
+#    define AWS_HTTP_TRACE2(name, a1, a2) DTRACE_PROBE2(aws_http, name, (a1), (a2))
+#    define AWS_HTTP_TRACE3(name, a1, a2, a3) DTRACE_PROBE3(aws_http, name, (a1), (a2), (a3))
+#    define AWS_HTTP_TRACE4(name, a1, a2, a3, a4) DTRACE_PROBE4(aws_http, name, (a1), (a2), (a3), (a4))
+#else
+#    define AWS_HTTP_TRACE2(name, a1, a2)
+#    define AWS_HTTP_TRACE3(name, a1, a2, a3)
+#    define AWS_HTTP_TRACE4(name, a1, a2, a3, a4)
+#endif
+
+#endif /* AWS_HTTP_TRACING_H */
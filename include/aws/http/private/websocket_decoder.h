@@ -48,6 +48,15 @@ struct aws_websocket_decoder {
 
     bool expecting_continuation_data_frame; /* True when the next data frame must be CONTINUATION frame */
 
+    /* Incremental UTF-8 validation of TEXT messages (RFC-6455 Section 8.1).
+     * Set validate_utf8 true after init to enable it; invalid text fails the decoder.
+     * A codepoint may be split across chunks or even frames, so its state is carried here. */
+    bool validate_utf8;
+    bool processing_text_message; /* True while decoding a TEXT frame and the CONTINUATION frames that follow it */
+    uint8_t utf8_bytes_remaining; /* Continuation bytes still expected for the current codepoint */
+    uint8_t utf8_next_byte_min;   /* Valid range for the next continuation byte */
+    uint8_t utf8_next_byte_max;
+
     void *user_data;
     aws_websocket_decoder_frame_fn *on_frame;
     aws_websocket_decoder_payload_fn *on_payload;
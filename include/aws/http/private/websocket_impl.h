@@ -75,6 +75,11 @@ struct aws_websocket_handler_options {
 
     bool is_server;
     bool manual_window_update;
+    bool skip_utf8_validation;
+
+    /* Result of permessage-deflate negotiation. `permessage_deflate` is ignored unless negotiated is true. */
+    bool permessage_deflate_negotiated;
+    struct aws_websocket_permessage_deflate_options permessage_deflate;
 };
 
 struct aws_websocket_client_bootstrap_system_vtable {
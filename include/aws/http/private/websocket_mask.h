@@ -0,0 +1,37 @@
+#ifndef AWS_HTTP_WEBSOCKET_MASK_H
+#define AWS_HTTP_WEBSOCKET_MASK_H
+
+/*
+ * Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/http.h>
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * XOR `len` bytes in-place against the 4-byte masking-key (RFC-6455 Section 5.3).
+ *
+ * `phase` is the number of payload bytes already masked with this key, so the key
+ * stays correctly aligned when a frame's payload arrives in arbitrary-sized pieces.
+ *
+ * Uses a vectorized kernel (SSE2/AVX2/NEON, selected at runtime) for the bulk of
+ * the data, with a scalar fallback for short runs and unsupported targets.
+ */
+AWS_HTTP_API
+void aws_websocket_mask_apply(uint8_t *bytes, size_t len, const uint8_t masking_key[4], uint64_t phase);
+
+AWS_EXTERN_C_END
+
+#endif /* AWS_HTTP_WEBSOCKET_MASK_H */
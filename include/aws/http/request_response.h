@@ -202,6 +202,25 @@ struct aws_http_make_request_options {
      */
     aws_http_on_incoming_body_fn *on_response_body;
 
+    /**
+     * Alternative to `on_response_body` for callers that buffer the whole response in memory.
+     * Body bytes are appended straight into this buffer as they are decoded, skipping the
+     * per-chunk callback. Pre-reserve the expected content length to avoid reallocation.
+     * Optional. The buffer must stay valid until on_complete is invoked.
+     * It is an error to set both this and `on_response_body`.
+     */
+    struct aws_byte_buf *response_body_sink;
+
+    /**
+     * Invoked for each trailing header of a chunked response, as it arrives.
+     * Trailers are streamed one field at a time and are never accumulated,
+     * so arbitrarily large trailer blocks (ex: trailing checksums) cost no extra memory.
+     * Optional. If not set, trailers are delivered through `on_response_headers`
+     * with block type AWS_HTTP_HEADER_BLOCK_TRAILING.
+     * See `aws_http_on_incoming_headers_fn`.
+     */
+    aws_http_on_incoming_headers_fn *on_incoming_trailers;
+
     /**
      * Invoked when request/response stream is complete, whether successful or unsuccessful
      * Optional.
@@ -219,6 +238,44 @@ struct aws_http_make_request_options {
      * reaches 0, no further data will be received.
      */
     bool manual_window_management;
+
+    /**
+     * Scheduling weight of this stream's body, relative to other streams on the same connection.
+     * Valid values are 1-256, matching HTTP/2 stream weights [RFC-7540 5.3.2].
+     * Set to 0 to use the default weight (16).
+     * Only used by HTTP/2 connections; HTTP/1 sends requests strictly in order.
+     */
+    uint16_t stream_weight;
+
+    /**
+     * Optional.
+     * If non-zero, the connection is terminated and the stream completes with
+     * AWS_ERROR_HTTP_STREAM_TIMEOUT if the first byte of the response has not arrived
+     * within this many milliseconds of the request beginning to send.
+     * Currently only honored by HTTP/1.1 connections.
+     */
+    uint64_t response_first_byte_timeout_ms;
+
+    /**
+     * Optional.
+     * If non-zero, the connection is terminated and the stream completes with
+     * AWS_ERROR_HTTP_STREAM_TIMEOUT if the entire response has not arrived
+     * within this many milliseconds of the request beginning to send.
+     * Currently only honored by HTTP/1.1 connections.
+     */
+    uint64_t response_timeout_ms;
+
+    /**
+     * Optional.
+     * Only matters if the request has an "Expect: 100-continue" header, in which case the
+     * connection sends the request head and withholds the body until the server's interim
+     * 100 response arrives (or a final response arrives, in which case the body is never
+     * sent at all). If non-zero and no response of any kind arrives within this many
+     * milliseconds, the body is sent anyway, per RFC-7231 Section 5.1.1.
+     * If zero, the connection waits indefinitely (response_timeout_ms still applies).
+     * Currently only honored by HTTP/1.1 connections.
+     */
+    uint64_t expect_100_continue_timeout_ms;
 };
 
 struct aws_http_request_handler_options {
@@ -286,6 +343,31 @@ struct aws_http_request_handler_options {
 #define AWS_HTTP_REQUEST_HANDLER_OPTIONS_INIT                                                                          \
     { .self_size = sizeof(struct aws_http_request_handler_options), }
 
+/**
+ * Timestamps recorded at a stream's lifecycle transitions, so server latency can be separated
+ * from client-side queueing and write time without wrapping every callback.
+ *
+ * All values are monotonic nanoseconds from the connection's clock (aws_high_res_clock_get_ticks).
+ * A value of 0 means the stream has not reached that transition (yet).
+ * Currently only HTTP/1 connections record the send and receive transitions.
+ */
+struct aws_http_stream_metrics {
+    /* Stream was created and queued for sending */
+    uint64_t activated_timestamp_ns;
+
+    /* First byte of the outgoing message was written by the encoder */
+    uint64_t send_start_timestamp_ns;
+
+    /* Last byte of the outgoing message (including any body) was written by the encoder */
+    uint64_t send_end_timestamp_ns;
+
+    /* First byte of the incoming message reached the decoder */
+    uint64_t receive_start_timestamp_ns;
+
+    /* Stream completed (successfully or not) */
+    uint64_t complete_timestamp_ns;
+};
+
 AWS_EXTERN_C_BEGIN
 
 /**
@@ -437,6 +519,21 @@ struct aws_http_message *aws_http_message_new_request_with_headers(
 AWS_HTTP_API
 struct aws_http_message *aws_http_message_new_response(struct aws_allocator *allocator);
 
+/**
+ * Create a cheap copy of a message, for sending the same request on several connections
+ * (ex: hedging, retries) without re-building the headers per attempt.
+ *
+ * The headers are shared with the original in O(1) and copied lazily: whichever message is
+ * mutated first (through the message API, or aws_http_message_get_headers()) pays for a
+ * private copy at that point, so purely-read snapshots never copy at all. Method, path, and
+ * status are copied eagerly; the body stream pointer is shared, so the caller must either
+ * leave it unset on one of the messages or ensure the attempts don't read it concurrently.
+ *
+ * The caller has a hold on the new message and must call aws_http_message_release() on it.
+ */
+AWS_HTTP_API
+struct aws_http_message *aws_http_message_snapshot(struct aws_http_message *message);
+
 /**
  * Acquire a hold on the object, preventing it from being deleted until
  * aws_http_message_release() is called by all those with a hold on it.
@@ -520,11 +617,65 @@ struct aws_input_stream *aws_http_message_get_body_stream(const struct aws_http_
 AWS_HTTP_API
 void aws_http_message_set_body_stream(struct aws_http_message *message, struct aws_input_stream *body_stream);
 
+/**
+ * One piece of a vectored message body (see aws_http_message_add_body_segment_stream()).
+ */
+struct aws_http_body_segment {
+    enum aws_http_body_segment_type {
+        AWS_HTTP_BODY_SEGMENT_STREAM,
+        AWS_HTTP_BODY_SEGMENT_CURSOR,
+    } type;
+
+    /* Valid when type is AWS_HTTP_BODY_SEGMENT_STREAM */
+    struct aws_input_stream *stream;
+
+    /* Valid when type is AWS_HTTP_BODY_SEGMENT_CURSOR */
+    struct aws_byte_cursor cursor;
+};
+
+/**
+ * Append a stream segment to a vectored message body.
+ * Segments are sent in the order they were added, with no intermediate copy, so a body
+ * assembled from several sources (prefix + payload + trailer) need not be coalesced into
+ * one stream first. A message uses either body segments or a body stream, never both.
+ * Note: The message does NOT take ownership of the stream.
+ * The stream must not be destroyed until the message is complete.
+ */
+AWS_HTTP_API
+int aws_http_message_add_body_segment_stream(struct aws_http_message *message, struct aws_input_stream *stream);
+
+/**
+ * Append a borrowed-bytes segment to a vectored message body.
+ * The bytes are NOT copied; the memory the cursor points to must remain valid until the
+ * message is complete. Suited to small fixed-size pieces such as checksums or framing.
+ */
+AWS_HTTP_API
+int aws_http_message_add_body_segment_cursor(struct aws_http_message *message, struct aws_byte_cursor segment_data);
+
+/**
+ * Get the number of segments in a vectored message body.
+ * Returns 0 for messages with no body or a plain body stream.
+ */
+AWS_HTTP_API
+size_t aws_http_message_get_body_segment_count(const struct aws_http_message *message);
+
+/**
+ * Get the body segment at the given index.
+ */
+AWS_HTTP_API
+int aws_http_message_get_body_segment(
+    const struct aws_http_message *message,
+    size_t index,
+    struct aws_http_body_segment *out_segment);
+
 /**
  * Get the message's aws_http_headers.
  *
  * This datastructure has more functions for inspecting and modifying headers than
  * are available on the aws_http_message datastructure.
+ *
+ * If the message shares its headers with a snapshot (see aws_http_message_snapshot()),
+ * this triggers the copy-on-write copy, and returns NULL if that copy cannot be allocated.
  */
 AWS_HTTP_API
 struct aws_http_headers *aws_http_message_get_headers(struct aws_http_message *message);
@@ -619,6 +770,15 @@ void aws_http_stream_release(struct aws_http_stream *stream);
 AWS_HTTP_API
 struct aws_http_connection *aws_http_stream_get_connection(const struct aws_http_stream *stream);
 
+/**
+ * Copy out the stream's lifecycle timestamps.  See `aws_http_stream_metrics`.
+ * The timestamps are written from the connection's thread as the stream progresses;
+ * it is always safe to call this from the stream's callbacks, or from any thread
+ * once on_complete has fired.
+ */
+AWS_HTTP_API
+void aws_http_stream_get_metrics(const struct aws_http_stream *stream, struct aws_http_stream_metrics *out_metrics);
+
 /* Only valid in "request" streams, once response headers start arriving */
 AWS_HTTP_API
 int aws_http_stream_get_incoming_response_status(const struct aws_http_stream *stream, int *out_status);
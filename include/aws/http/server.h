@@ -85,6 +85,30 @@ struct aws_http_server_options {
      */
     size_t initial_window_size;
 
+    /**
+     * Number of listening sockets to create, all bound to the same endpoint.
+     * Optional. 0 or 1 means a single listener (the default).
+     *
+     * Each listener is serviced by a different event loop from the bootstrap's event loop
+     * group, so with one listener per event loop the kernel load-balances accept processing
+     * and handshakes across cores instead of funneling them through a single loop. Sharing
+     * the port requires SO_REUSEPORT support from the platform's socket layer; listeners
+     * beyond the first that fail to bind are skipped with a warning, so the server still
+     * comes up where sharing isn't supported.
+     */
+    size_t num_listeners;
+
+    /**
+     * Maximum number of connections the server will hold open at once.
+     * Optional. 0 means no limit (the default).
+     *
+     * Incoming connections beyond the limit are shut down immediately and reported to
+     * on_incoming_connection with AWS_ERROR_HTTP_SERVER_BUDGET_EXCEEDED. Combined with the
+     * per-connection caps on decoder scratch, this turns a memory budget into a deterministic
+     * ceiling: divide the budget by the per-connection bound to pick this value.
+     */
+    size_t max_incoming_connections;
+
     /**
      * User data passed to callbacks.
      * Optional.
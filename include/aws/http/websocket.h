@@ -129,6 +129,47 @@ typedef bool(aws_websocket_on_incoming_frame_complete_fn)(
     int error_code,
     void *user_data);
 
+/**
+ * Configuration for the permessage-deflate extension (RFC-7692).
+ * The extension is offered during the opening handshake, and the server's response determines
+ * whether it is in effect and with which parameters.
+ *
+ * Note that this library negotiates the extension but does not apply the DEFLATE transform itself.
+ * Frames carrying a compressed message have the RSV1 bit set (visible on
+ * aws_websocket_incoming_frame and settable on aws_websocket_send_frame_options),
+ * and it is up to the application to compress/decompress those payloads.
+ * The context-takeover and max-window-bits parameters exist so that an endpoint can bound
+ * the memory its compression contexts consume per connection.
+ */
+struct aws_websocket_permessage_deflate_options {
+    /**
+     * If true, demand that the server reset its compression context after each message.
+     * The handshake fails if the server does not agree.
+     */
+    bool server_no_context_takeover;
+
+    /**
+     * If true, this endpoint resets its compression context after each message.
+     * The server may also demand this in its handshake response, so always check the
+     * negotiated value via aws_websocket_get_negotiated_permessage_deflate().
+     */
+    bool client_no_context_takeover;
+
+    /**
+     * Maximum size of the server's LZ77 sliding window, expressed as a base-2 logarithm (8-15).
+     * Set to 0 to place no limit on the server's window.
+     * If non-zero, the handshake fails unless the server agrees to this limit (or a lower one).
+     */
+    uint8_t server_max_window_bits;
+
+    /**
+     * Maximum size of this endpoint's LZ77 sliding window, expressed as a base-2 logarithm (8-15).
+     * Set to 0 to omit the parameter from the offer entirely (the default window of 15 is used,
+     * and the server is not permitted to demand a smaller one).
+     */
+    uint8_t client_max_window_bits;
+};
+
 /**
  * Options for creating a websocket client connection.
  */
@@ -194,6 +235,16 @@ struct aws_websocket_client_connection_options {
      */
     struct aws_http_message *handshake_request;
 
+    /**
+     * Optional.
+     * If set, the permessage-deflate extension (RFC-7692) is offered with these parameters
+     * and the server's handshake response is validated against the offer.
+     * The Sec-WebSocket-Extensions header is added to the handshake request automatically.
+     * aws_websocket_client_connect() makes a copy.
+     * Query the outcome with aws_websocket_get_negotiated_permessage_deflate().
+     */
+    const struct aws_websocket_permessage_deflate_options *permessage_deflate;
+
     /**
      * Initial window size for websocket.
      * Required.
@@ -257,6 +308,182 @@ struct aws_websocket_client_connection_options {
      * reaches 0, no further data will be received.
      */
     bool manual_window_management;
+
+    /**
+     * Set to true to skip UTF-8 validation of incoming TEXT messages (RFC-6455 Section 8.1).
+     * Validation is performed by default, and a peer that sends invalid UTF-8 text
+     * fails the connection with AWS_ERROR_HTTP_PROTOCOL_ERROR.
+     * Skipping it saves a pass over the payload when the peer is trusted.
+     */
+    bool skip_utf8_validation;
+};
+
+/**
+ * Result of one connection attempt within a bulk connect (see aws_websocket_client_connect_bulk()).
+ */
+struct aws_websocket_bulk_connect_result {
+    /**
+     * Position of this connection within the batch, 0 to target_count-1,
+     * in the order the connections were launched.
+     */
+    size_t index;
+
+    /**
+     * Valid websocket if this connection succeeded, NULL if it failed.
+     * The user is responsible for each successful websocket and must call aws_websocket_release() on it.
+     */
+    struct aws_websocket *websocket;
+
+    /**
+     * Zero if this connection succeeded.
+     */
+    int error_code;
+
+    /**
+     * The response status code of the HTTP handshake, 101 if successful,
+     * -1 if the connection failed before a response was received.
+     */
+    int handshake_response_status;
+};
+
+/**
+ * Called once when every connection of a bulk connect has finished setup (successfully or not).
+ * result_array has one entry per requested connection, ordered by index.
+ * The array becomes invalid once the callback completes; copy if necessary.
+ * Invoked on one of the event-loop threads that drove the connections.
+ */
+typedef void(aws_websocket_on_bulk_connection_setup_fn)(
+    const struct aws_websocket_bulk_connect_result *result_array,
+    size_t num_results,
+    void *user_data);
+
+/**
+ * Options for creating a batch of websocket client connections to one endpoint.
+ * See aws_websocket_client_connect_bulk().
+ */
+struct aws_websocket_bulk_client_connection_options {
+    /**
+     * Required.
+     * Must outlive the operation.
+     */
+    struct aws_allocator *allocator;
+
+    /**
+     * Required.
+     * Must outlive the operation.
+     */
+    struct aws_client_bootstrap *bootstrap;
+
+    /**
+     * Required.
+     * Connections launch over time, so this must remain valid until on_bulk_connection_setup fires.
+     */
+    struct aws_socket_options *socket_options;
+
+    /**
+     * Optional.
+     * Must remain valid until on_bulk_connection_setup fires.
+     */
+    struct aws_tls_connection_options *tls_options;
+
+    /**
+     * Optional.
+     * Must remain valid until on_bulk_connection_setup fires.
+     */
+    struct aws_http_proxy_options *proxy_options;
+
+    /**
+     * Required.
+     * aws_websocket_client_connect_bulk() makes a copy.
+     */
+    struct aws_byte_cursor host;
+
+    /**
+     * Optional.
+     * Defaults to 443 if tls_options is present, 80 if it is not.
+     */
+    uint16_t port;
+
+    /**
+     * Required.
+     * Handshake request shared by every connection in the batch.
+     * Requirements are identical to aws_websocket_client_connection_options.handshake_request,
+     * except the Sec-WebSocket-Key value is only a placeholder: each connection sends a
+     * copy-on-write snapshot of this template (see aws_http_message_snapshot()) with a fresh
+     * random key patched in, so the template itself is never mutated or sent.
+     * Must remain valid until on_bulk_connection_setup fires.
+     */
+    struct aws_http_message *handshake_template;
+
+    /**
+     * Optional.
+     * If set, every connection offers the permessage-deflate extension with these parameters.
+     * See aws_websocket_client_connection_options.permessage_deflate.
+     * aws_websocket_client_connect_bulk() makes a copy.
+     */
+    const struct aws_websocket_permessage_deflate_options *permessage_deflate;
+
+    /**
+     * Required.
+     * Total number of connections to establish.
+     */
+    size_t target_count;
+
+    /**
+     * Maximum number of connections being set up at any one time.
+     * Optional.
+     * A zero defaults to a reasonable value. The client bootstrap spreads the
+     * connections across its event loop group as usual.
+     */
+    size_t concurrency_window;
+
+    /**
+     * Initial window size for each websocket.
+     * Required.
+     * See aws_websocket_client_connection_options.initial_window_size.
+     */
+    size_t initial_window_size;
+
+    /**
+     * User data for callbacks.
+     * Optional.
+     * Shared by every connection in the batch.
+     */
+    void *user_data;
+
+    /**
+     * Called once when every connection has finished setup.
+     * Required.
+     * Connections that succeeded are live (and may be in use) before this fires;
+     * the batch callback only reports the results in one place.
+     */
+    aws_websocket_on_bulk_connection_setup_fn *on_bulk_connection_setup;
+
+    /**
+     * Called as each successfully-established connection finishes shutting down.
+     * Optional.
+     * Never called for connections whose setup failed.
+     */
+    aws_websocket_on_connection_shutdown_fn *on_connection_shutdown;
+
+    /**
+     * Incoming frame callbacks, shared by every connection in the batch.
+     * Optional, but either all three are set or none are.
+     * See aws_websocket_client_connection_options.
+     */
+    aws_websocket_on_incoming_frame_begin_fn *on_incoming_frame_begin;
+    aws_websocket_on_incoming_frame_payload_fn *on_incoming_frame_payload;
+    aws_websocket_on_incoming_frame_complete_fn *on_incoming_frame_complete;
+
+    /**
+     * See aws_websocket_client_connection_options.manual_window_management.
+     */
+    bool manual_window_management;
+
+    /**
+     * See aws_websocket_client_connection_options.skip_utf8_validation.
+     */
+    bool skip_utf8_validation;
 };
 
 /**
@@ -352,6 +579,17 @@ bool aws_websocket_is_data_frame(uint8_t opcode);
 AWS_HTTP_API
 int aws_websocket_client_connect(const struct aws_websocket_client_connection_options *options);
 
+/**
+ * Asynchronously establish many client websocket connections to the same endpoint.
+ * Each connection clones the shared handshake template (an O(1) copy-on-write snapshot)
+ * and patches in its own random Sec-WebSocket-Key, rather than re-building the request
+ * per connection. Up to concurrency_window connections are set up at a time until
+ * target_count have completed, then on_bulk_connection_setup fires once with every result.
+ * Individual connection failures do not abort the batch.
+ */
+AWS_HTTP_API
+int aws_websocket_client_connect_bulk(const struct aws_websocket_bulk_client_connection_options *options);
+
 /**
  * Users must release the websocket when they are done with it.
  * The websocket's memory cannot be reclaimed until this is done.
@@ -421,6 +659,17 @@ int aws_websocket_convert_to_midchannel_handler(struct aws_websocket *websocket)
 AWS_HTTP_API
 struct aws_channel *aws_websocket_get_channel(const struct aws_websocket *websocket);
 
+/**
+ * Query the result of permessage-deflate negotiation (RFC-7692).
+ * Returns true if the extension is in effect for this connection.
+ * If `out_options` is non-NULL, it receives the negotiated parameters
+ * (zeroed out if the extension was not negotiated).
+ */
+AWS_HTTP_API
+bool aws_websocket_get_negotiated_permessage_deflate(
+    const struct aws_websocket *websocket,
+    struct aws_websocket_permessage_deflate_options *out_options);
+
 /**
  * Generate value for a Sec-WebSocket-Key header and write it into `dst` buffer.
  * The buffer should have at least AWS_WEBSOCKET_MAX_HANDSHAKE_KEY_LENGTH space available.
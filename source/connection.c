@@ -13,10 +13,13 @@
  * permissions and limitations under the License.
  */
 
+#include <aws/http/private/connection_monitor.h>
 #include <aws/http/private/h1_connection.h>
 #include <aws/http/private/h2_connection.h>
 #include <aws/http/private/proxy_impl.h>
 
+#include <aws/common/atomics.h>
+#include <aws/common/clock.h>
 #include <aws/common/hash_table.h>
 #include <aws/common/mutex.h>
 #include <aws/common/string.h>
@@ -49,10 +52,20 @@ struct aws_http_server {
     struct aws_server_bootstrap *bootstrap;
     bool is_using_tls;
     size_t initial_window_size;
+    size_t max_incoming_connections;
     void *user_data;
     aws_http_server_on_incoming_connection_fn *on_incoming_connection;
     aws_http_server_on_destroy_fn *on_destroy_complete;
-    struct aws_socket *socket;
+
+    /* Listening sockets bound to the same endpoint, each serviced by a different event loop
+     * (see aws_http_server_options.num_listeners). [0] always exists; the extras rely on the
+     * socket layer permitting a shared port (SO_REUSEPORT). */
+    struct aws_socket **listeners;
+    size_t num_listeners;
+
+    /* Listener-destroy callbacks still outstanding during shutdown.
+     * The callback that drops this to zero cleans the server up. */
+    struct aws_atomic_var num_listeners_alive;
 
     /* Any thread may touch this data, but the lock must be held */
     struct {
@@ -80,7 +93,13 @@ static struct aws_http_connection *s_connection_new(
     struct aws_channel *channel,
     bool is_server,
     bool is_using_tls,
-    size_t initial_window_size) {
+    size_t initial_window_size,
+    size_t max_pipelined_requests,
+    size_t window_update_threshold,
+    size_t preferred_write_message_size,
+    bool adaptive_window_management,
+    uint64_t http2_ping_period_ms,
+    uint64_t http2_ping_timeout_ms) {
 
     struct aws_channel_slot *connection_slot = NULL;
     struct aws_http_connection *connection = NULL;
@@ -145,7 +164,13 @@ static struct aws_http_connection *s_connection_new(
             if (is_server) {
                 connection = aws_http_connection_new_http1_1_server(alloc, initial_window_size);
             } else {
-                connection = aws_http_connection_new_http1_1_client(alloc, initial_window_size);
+                connection = aws_http_connection_new_http1_1_client(
+                    alloc,
+                    initial_window_size,
+                    max_pipelined_requests,
+                    window_update_threshold,
+                    preferred_write_message_size,
+                    adaptive_window_management);
             }
             break;
         case AWS_HTTP_VERSION_2:
@@ -153,7 +178,8 @@ static struct aws_http_connection *s_connection_new(
             if (is_server) {
                 connection = aws_http_connection_new_http2_server(alloc, initial_window_size);
             } else {
-                connection = aws_http_connection_new_http2_client(alloc, initial_window_size);
+                connection = aws_http_connection_new_http2_client(
+                    alloc, initial_window_size, http2_ping_period_ms, http2_ping_timeout_ms);
             }
             break;
         default:
@@ -221,6 +247,30 @@ bool aws_http_connection_is_open(const struct aws_http_connection *connection) {
     return connection->vtable->is_open(connection);
 }
 
+bool aws_http_connection_is_draining(const struct aws_http_connection *connection) {
+    AWS_ASSERT(connection);
+    return aws_atomic_load_int(&connection->is_draining) != 0;
+}
+
+void aws_http_connection_signal_draining(struct aws_http_connection *connection) {
+    AWS_ASSERT(connection);
+
+    size_t expected = 0;
+    if (!aws_atomic_compare_exchange_int(&connection->is_draining, &expected, 1)) {
+        /* Already draining, the callback has fired */
+        return;
+    }
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_HTTP_CONNECTION,
+        "id=%p: Connection is draining, peer will accept no further requests.",
+        (void *)connection);
+
+    if (connection->on_draining) {
+        connection->on_draining(connection, connection->on_draining_user_data);
+    }
+}
+
 bool aws_http_connection_is_client(const struct aws_http_connection *connection) {
     return connection->client_data;
 }
@@ -234,6 +284,20 @@ void aws_http_connection_update_window(struct aws_http_connection *connection, s
     connection->vtable->update_window(connection, increment_size);
 }
 
+int aws_http_connection_convert_to_midchannel_handler(struct aws_http_connection *connection) {
+    AWS_ASSERT(connection);
+
+    if (!connection->vtable->convert_to_midchannel_handler) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_CONNECTION,
+            "id=%p: This connection's protocol does not support midchannel conversion.",
+            (void *)connection);
+        return aws_raise_error(AWS_ERROR_UNIMPLEMENTED);
+    }
+
+    return connection->vtable->convert_to_midchannel_handler(connection);
+}
+
 struct aws_channel *aws_http_connection_get_channel(struct aws_http_connection *connection) {
     AWS_ASSERT(connection);
     return connection->channel_slot->channel;
@@ -270,7 +334,7 @@ void aws_http_connection_release(struct aws_http_connection *connection) {
 
 /* At this point, the server bootstrapper has accepted an incoming connection from a client and set up a channel.
  * Now we need to create an aws_http_connection and insert it into the channel as a channel-handler.
- * Note: Be careful not to access server->socket until lock is acquired to avoid race conditions */
+ * Note: Be careful not to access server->listeners until lock is acquired to avoid race conditions */
 static void s_server_bootstrap_on_accept_channel_setup(
     struct aws_server_bootstrap *bootstrap,
     int error_code,
@@ -293,7 +357,18 @@ static void s_server_bootstrap_on_accept_channel_setup(
         goto error;
     }
     /* Create connection */
-    connection = s_connection_new(server->alloc, channel, true, server->is_using_tls, server->initial_window_size);
+    connection = s_connection_new(
+        server->alloc,
+        channel,
+        true,
+        server->is_using_tls,
+        server->initial_window_size,
+        0 /*max_pipelined_requests*/,
+        0 /*window_update_threshold*/,
+        0 /*preferred_write_message_size*/,
+        false /*adaptive_window_management*/,
+        0 /*http2_ping_period_ms*/,
+        0 /*http2_ping_timeout_ms*/);
     if (!connection) {
         AWS_LOGF_ERROR(
             AWS_LS_HTTP_SERVER,
@@ -311,11 +386,24 @@ static void s_server_bootstrap_on_accept_channel_setup(
     if (server->synced_data.is_shutting_down) {
         error_code = AWS_ERROR_HTTP_CONNECTION_CLOSED;
     }
+    if (!error_code && server->max_incoming_connections &&
+        aws_hash_table_get_entry_count(&server->synced_data.channel_to_connection_map) >=
+            server->max_incoming_connections) {
+        error_code = AWS_ERROR_HTTP_SERVER_BUDGET_EXCEEDED;
+    }
     if (!error_code) {
         put_err = aws_hash_table_put(&server->synced_data.channel_to_connection_map, channel, connection, NULL);
     }
     s_server_unlock_synced_data(server);
     /* END CRITICAL SECTION */
+    if (error_code == AWS_ERROR_HTTP_SERVER_BUDGET_EXCEEDED) {
+        AWS_LOGF_WARN(
+            AWS_LS_HTTP_SERVER,
+            "id=%p: Incoming connection shed: the server is at its %zu connection budget.",
+            (void *)server,
+            server->max_incoming_connections);
+        goto error;
+    }
     if (error_code) {
         AWS_LOGF_ERROR(
             AWS_ERROR_HTTP_SERVER_CLOSED,
@@ -329,8 +417,8 @@ static void s_server_bootstrap_on_accept_channel_setup(
             AWS_LS_HTTP_SERVER,
             "%p: %s:%d: Failed to store connection object, error %d (%s).",
             (void *)server,
-            server->socket->local_endpoint.address,
-            server->socket->local_endpoint.port,
+            server->listeners[0]->local_endpoint.address,
+            server->listeners[0]->local_endpoint.port,
             aws_last_error(),
             aws_error_name(aws_last_error()));
 
@@ -344,8 +432,8 @@ static void s_server_bootstrap_on_accept_channel_setup(
         (void *)connection,
         AWS_BYTE_CURSOR_PRI(aws_http_version_to_str(connection->http_version)),
         (void *)server,
-        server->socket->local_endpoint.address,
-        server->socket->local_endpoint.port);
+        server->listeners[0]->local_endpoint.address,
+        server->listeners[0]->local_endpoint.port);
 
     server->on_incoming_connection(server, connection, AWS_ERROR_SUCCESS, server->user_data);
     user_cb_invoked = true;
@@ -392,6 +480,9 @@ static void s_http_server_clean_up(struct aws_http_server *server) {
     if (server->on_destroy_complete) {
         server->on_destroy_complete(server->user_data);
     }
+    if (server->listeners) {
+        aws_mem_release(server->alloc, server->listeners);
+    }
     aws_hash_table_clean_up(&server->synced_data.channel_to_connection_map);
     aws_mutex_clean_up(&server->synced_data.lock);
     aws_mem_release(server->alloc, server);
@@ -430,13 +521,15 @@ static void s_server_bootstrap_on_accept_channel_shutdown(
     }
 }
 
-/* the server listener has finished the destroy process, no existing connections
- * finally safe to clean the server up */
+/* a server listener has finished the destroy process. Once every listener is destroyed there
+ * are no existing connections and it's finally safe to clean the server up */
 static void s_server_bootstrap_on_server_listener_destroy(struct aws_server_bootstrap *bootstrap, void *user_data) {
     (void)bootstrap;
     AWS_ASSERT(user_data);
     struct aws_http_server *server = user_data;
-    s_http_server_clean_up(server);
+    if (aws_atomic_fetch_sub(&server->num_listeners_alive, 1) == 1) {
+        s_http_server_clean_up(server);
+    }
 }
 
 struct aws_http_server *aws_http_server_new(const struct aws_http_server_options *options) {
@@ -463,6 +556,7 @@ struct aws_http_server *aws_http_server_new(const struct aws_http_server_options
     server->bootstrap = options->bootstrap;
     server->is_using_tls = options->tls_options != NULL;
     server->initial_window_size = options->initial_window_size;
+    server->max_incoming_connections = options->max_incoming_connections;
     server->user_data = options->server_user_data;
     server->on_incoming_connection = options->on_incoming_connection;
     server->on_destroy_complete = options->on_destroy_complete;
@@ -483,33 +577,62 @@ struct aws_http_server *aws_http_server_new(const struct aws_http_server_options
             aws_error_name(aws_last_error()));
         goto hash_table_error;
     }
-    /* Protect against callbacks firing before server->socket is set */
+    size_t num_listeners = options->num_listeners ? options->num_listeners : 1;
+    server->listeners = aws_mem_calloc(server->alloc, num_listeners, sizeof(struct aws_socket *));
+    if (!server->listeners) {
+        goto listener_array_error;
+    }
+
+    /* Protect against callbacks firing before server->listeners is populated.
+     * Each listener is serviced by the next event loop in the bootstrap's group, so the
+     * kernel load-balances accepts across them when the port is shared. */
     s_server_lock_synced_data(server);
-    if (options->tls_options) {
-        server->is_using_tls = true;
+    for (size_t i = 0; i < num_listeners; ++i) {
+        struct aws_socket *listener;
+        if (options->tls_options) {
+            server->is_using_tls = true;
+
+            listener = aws_server_bootstrap_new_tls_socket_listener(
+                options->bootstrap,
+                options->endpoint,
+                options->socket_options,
+                options->tls_options,
+                s_server_bootstrap_on_accept_channel_setup,
+                s_server_bootstrap_on_accept_channel_shutdown,
+                s_server_bootstrap_on_server_listener_destroy,
+                server);
+        } else {
+            listener = aws_server_bootstrap_new_socket_listener(
+                options->bootstrap,
+                options->endpoint,
+                options->socket_options,
+                s_server_bootstrap_on_accept_channel_setup,
+                s_server_bootstrap_on_accept_channel_shutdown,
+                s_server_bootstrap_on_server_listener_destroy,
+                server);
+        }
 
-        server->socket = aws_server_bootstrap_new_tls_socket_listener(
-            options->bootstrap,
-            options->endpoint,
-            options->socket_options,
-            options->tls_options,
-            s_server_bootstrap_on_accept_channel_setup,
-            s_server_bootstrap_on_accept_channel_shutdown,
-            s_server_bootstrap_on_server_listener_destroy,
-            server);
-    } else {
-        server->socket = aws_server_bootstrap_new_socket_listener(
-            options->bootstrap,
-            options->endpoint,
-            options->socket_options,
-            s_server_bootstrap_on_accept_channel_setup,
-            s_server_bootstrap_on_accept_channel_shutdown,
-            s_server_bootstrap_on_server_listener_destroy,
-            server);
-    }
-    s_server_unlock_synced_data(server);
+        if (listener) {
+            server->listeners[server->num_listeners++] = listener;
+            continue;
+        }
+
+        if (i > 0) {
+            /* The platform or socket type won't share the port. Run with what we have. */
+            AWS_LOGF_WARN(
+                AWS_LS_HTTP_SERVER,
+                "%p: Failed creating listener %zu of %zu, error %d (%s). Continuing with %zu listener(s).",
+                (void *)server,
+                i + 1,
+                num_listeners,
+                aws_last_error(),
+                aws_error_name(aws_last_error()),
+                i);
+            break;
+        }
+
+        s_server_unlock_synced_data(server);
 
-    if (!server->socket) {
         AWS_LOGF_ERROR(
             AWS_LS_HTTP_SERVER,
             "static: Failed creating new socket listener, error %d (%s). Cannot create server.",
@@ -518,17 +641,22 @@ struct aws_http_server *aws_http_server_new(const struct aws_http_server_options
 
         goto socket_error;
     }
+    aws_atomic_init_int(&server->num_listeners_alive, server->num_listeners);
+    s_server_unlock_synced_data(server);
 
     AWS_LOGF_INFO(
         AWS_LS_HTTP_SERVER,
-        "%p %s:%d: Server setup complete, listening for incoming connections.",
+        "%p %s:%d: Server setup complete, listening for incoming connections on %zu socket(s).",
         (void *)server,
-        server->socket->local_endpoint.address,
-        server->socket->local_endpoint.port);
+        server->listeners[0]->local_endpoint.address,
+        server->listeners[0]->local_endpoint.port,
+        server->num_listeners);
 
     return server;
 
 socket_error:
+    aws_mem_release(server->alloc, server->listeners);
+listener_array_error:
     aws_hash_table_clean_up(&server->synced_data.channel_to_connection_map);
 hash_table_error:
     aws_mutex_clean_up(&server->synced_data.lock);
@@ -567,16 +695,19 @@ void aws_http_server_release(struct aws_http_server *server) {
         return;
     }
 
-    /* stop listening, clean up the socket, after all existing connections finish shutting down, the
-     * s_server_bootstrap_on_server_listener_destroy will be invoked, clean up of the server will be there */
+    /* stop listening, clean up the sockets, after all existing connections finish shutting down, the
+     * s_server_bootstrap_on_server_listener_destroy will be invoked per listener, the last one
+     * cleans the server up */
     AWS_LOGF_INFO(
         AWS_LS_HTTP_SERVER,
         "%p %s:%d: Shutting down the server.",
         (void *)server,
-        server->socket->local_endpoint.address,
-        server->socket->local_endpoint.port);
+        server->listeners[0]->local_endpoint.address,
+        server->listeners[0]->local_endpoint.port);
 
-    aws_server_bootstrap_destroy_socket_listener(server->bootstrap, server->socket);
+    for (size_t i = 0; i < server->num_listeners; ++i) {
+        aws_server_bootstrap_destroy_socket_listener(server->bootstrap, server->listeners[i]);
+    }
 
     /* wait for connections to finish shutting down
      * clean up will be called from eventloop */
@@ -615,8 +746,20 @@ static void s_client_bootstrap_on_channel_setup(
 
     AWS_LOGF_TRACE(AWS_LS_HTTP_CONNECTION, "static: Socket connected, creating client connection object.");
 
+    aws_high_res_clock_get_ticks(&http_bootstrap->channel_complete_timestamp_ns);
+
     http_bootstrap->connection = s_connection_new(
-        http_bootstrap->alloc, channel, false, http_bootstrap->is_using_tls, http_bootstrap->initial_window_size);
+        http_bootstrap->alloc,
+        channel,
+        false,
+        http_bootstrap->is_using_tls,
+        http_bootstrap->initial_window_size,
+        http_bootstrap->max_pipelined_requests,
+        http_bootstrap->window_update_threshold,
+        http_bootstrap->preferred_write_message_size,
+        http_bootstrap->adaptive_window_management,
+        http_bootstrap->http2_ping_period_ms,
+        http_bootstrap->http2_ping_timeout_ms);
     if (!http_bootstrap->connection) {
         AWS_LOGF_ERROR(
             AWS_LS_HTTP_CONNECTION,
@@ -629,6 +772,24 @@ static void s_client_bootstrap_on_channel_setup(
 
     http_bootstrap->connection->proxy_request_transform = http_bootstrap->proxy_request_transform;
     http_bootstrap->connection->user_data = http_bootstrap->user_data;
+    http_bootstrap->connection->on_draining = http_bootstrap->on_draining;
+    http_bootstrap->connection->on_draining_user_data = http_bootstrap->user_data;
+
+    if (http_bootstrap->monitoring_options.minimum_throughput_bytes_per_second) {
+        if (!aws_http_connection_monitor_new(
+                http_bootstrap->alloc, http_bootstrap->connection, &http_bootstrap->monitoring_options)) {
+            AWS_LOGF_ERROR(
+                AWS_LS_HTTP_CONNECTION,
+                "static: Failed to create connection monitor, error %d (%s).",
+                aws_last_error(),
+                aws_error_name(aws_last_error()));
+
+            /* User never saw the connection, so its refcount is ours to release. */
+            aws_http_connection_release(http_bootstrap->connection);
+            http_bootstrap->connection = NULL;
+            goto error;
+        }
+    }
 
     AWS_LOGF_INFO(
         AWS_LS_HTTP_CONNECTION,
@@ -636,6 +797,11 @@ static void s_client_bootstrap_on_channel_setup(
         (void *)http_bootstrap->connection,
         AWS_BYTE_CURSOR_PRI(aws_http_version_to_str(http_bootstrap->connection->http_version)));
 
+    struct aws_http_connection_setup_timing *setup_timing = &http_bootstrap->connection->setup_timing;
+    setup_timing->connect_start_timestamp_ns = http_bootstrap->connect_start_timestamp_ns;
+    setup_timing->channel_complete_timestamp_ns = http_bootstrap->channel_complete_timestamp_ns;
+    aws_high_res_clock_get_ticks(&setup_timing->setup_complete_timestamp_ns);
+
     /* Tell user of successful connection.
      * Then clear the on_setup callback so that we know it's been called */
     http_bootstrap->on_setup(http_bootstrap->connection, AWS_ERROR_SUCCESS, http_bootstrap->user_data);
@@ -711,6 +877,12 @@ int aws_http_client_connect_internal(
         goto error;
     }
 
+    if (options->monitoring_options && !aws_http_connection_monitoring_options_is_valid(options->monitoring_options)) {
+        AWS_LOGF_ERROR(AWS_LS_HTTP_CONNECTION, "static: Invalid monitoring options, cannot create client connection.");
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        goto error;
+    }
+
     /* bootstrap_new() functions requires a null-terminated c-str */
     host_name = aws_string_new_from_array(options->allocator, options->host_name.ptr, options->host_name.len);
     if (!host_name) {
@@ -725,10 +897,21 @@ int aws_http_client_connect_internal(
     http_bootstrap->alloc = options->allocator;
     http_bootstrap->is_using_tls = options->tls_options != NULL;
     http_bootstrap->initial_window_size = options->initial_window_size;
+    http_bootstrap->max_pipelined_requests = options->max_pipelined_requests;
+    http_bootstrap->window_update_threshold = options->window_update_threshold;
+    http_bootstrap->preferred_write_message_size = options->preferred_write_message_size;
+    http_bootstrap->adaptive_window_management = options->adaptive_window_management;
+    http_bootstrap->http2_ping_period_ms = options->http2_ping_period_ms;
+    http_bootstrap->http2_ping_timeout_ms = options->http2_ping_timeout_ms;
+    if (options->monitoring_options) {
+        http_bootstrap->monitoring_options = *options->monitoring_options;
+    }
     http_bootstrap->user_data = options->user_data;
     http_bootstrap->on_setup = options->on_setup;
     http_bootstrap->on_shutdown = options->on_shutdown;
+    http_bootstrap->on_draining = options->on_draining;
     http_bootstrap->proxy_request_transform = proxy_request_transform;
+    aws_high_res_clock_get_ticks(&http_bootstrap->connect_start_timestamp_ns);
 
     AWS_LOGF_TRACE(
         AWS_LS_HTTP_CONNECTION,
@@ -792,6 +975,14 @@ int aws_http_client_connect(const struct aws_http_client_connection_options *opt
     }
 }
 
+void aws_http_connection_get_setup_timing(
+    const struct aws_http_connection *connection,
+    struct aws_http_connection_setup_timing *out_timing) {
+
+    AWS_ASSERT(connection && out_timing);
+    *out_timing = connection->setup_timing;
+}
+
 enum aws_http_version aws_http_connection_get_version(const struct aws_http_connection *connection) {
     return connection->http_version;
 }
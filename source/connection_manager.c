@@ -16,18 +16,24 @@
 #include <aws/http/connection_manager.h>
 
 #include <aws/common/atomics.h>
+#include <aws/common/clock.h>
 #include <aws/common/hash_table.h>
 #include <aws/common/linked_list.h>
 #include <aws/common/mutex.h>
+#include <aws/common/thread.h>
 #include <aws/http/connection.h>
 #include <aws/http/private/connection_manager_system_vtable.h>
 #include <aws/http/private/http_impl.h>
 #include <aws/http/private/proxy_impl.h>
+#include <aws/http/private/tracing.h>
 #include <aws/io/channel_bootstrap.h>
+#include <aws/io/event_loop.h>
 #include <aws/io/logging.h>
 #include <aws/io/socket.h>
 #include <aws/io/tls_channel_handler.h>
 
+#include <inttypes.h>
+
 /*
  * System vtable to use under normal circumstances
  */
@@ -35,7 +41,11 @@ static struct aws_http_connection_manager_system_vtable s_default_system_vtable
     .create_connection = aws_http_client_connect,
     .release_connection = aws_http_connection_release,
     .close_connection = aws_http_connection_close,
-    .is_connection_open = aws_http_connection_is_open};
+    .is_connection_open = aws_http_connection_is_open,
+    .is_connection_draining = aws_http_connection_is_draining,
+    .get_monotonic_time = aws_high_res_clock_get_ticks,
+    .get_current_thread_id = aws_thread_current_thread_id,
+    .get_connection_setup_timing = aws_http_connection_get_setup_timing};
 
 const struct aws_http_connection_manager_system_vtable *g_aws_http_connection_manager_default_system_vtable_ptr =
     &s_default_system_vtable;
@@ -47,6 +57,41 @@ bool aws_http_connection_manager_system_vtable_is_valid(const struct aws_http_co
 
 enum aws_http_connection_manager_state_type { AWS_HCMST_UNINITIALIZED, AWS_HCMST_READY, AWS_HCMST_SHUTTING_DOWN };
 
+enum {
+    /*
+     * Number of atomic slots making up the lock-free idle-connection pool that fronts
+     * the mutex-guarded state.  Small on purpose: it only needs to cover the number of
+     * cores that might be acquiring simultaneously, not max_connections.
+     */
+    AWS_HTTP_CONNECTION_MANAGER_FAST_POOL_SLOTS = 8,
+
+    /*
+     * Upper bound (in milliseconds) on how long the idle-connection reaper sleeps between
+     * checks.  Checking is just a timestamp comparison against the oldest pooled connection,
+     * so a short period is cheap, keeps reaping reasonably punctual for short idle timeouts,
+     * and bounds how long manager shutdown can stall waiting for the task's next tick.
+     */
+    AWS_HTTP_CONNECTION_MANAGER_CULL_PERIOD_MAX_MS = 1000,
+
+    /*
+     * Width (in milliseconds) of the window over which the acquisition rate is measured
+     * for pre-warming decisions.
+     */
+    AWS_HTTP_CONNECTION_MANAGER_ACQUIRE_RATE_WINDOW_MS = 1000,
+};
+
+/*
+ * An idle connection held by the manager, tagged with the time at which the reaper may
+ * close it (cull_timestamp is zero, never culled, when no idle timeout is configured) and
+ * with the thread id of the event loop its channel runs on (home_thread_id is zero when
+ * unknown), which drives thread-affine vending.
+ */
+struct aws_idle_connection {
+    struct aws_http_connection *connection;
+    uint64_t cull_timestamp;
+    uint64_t home_thread_id;
+};
+
 /**
  * Vocabulary
  *    Acquisition - a request by a user for a connection
@@ -98,8 +143,10 @@ enum aws_http_connection_manager_state_type { AWS_HCMST_UNINITIALIZED, AWS_HCMST
  *
  *   pending_connect_count - the # of unresolved calls to the http layer's connect logic
  *   open_connection_count - the # of connections for whom the release callback (from http) has not been invoked
- *   vended_connection_count - the # of connections held by external users that haven't been released.  Under correct
- *      usage this should be zero before SHUTTING_DOWN is entered, but we attempt to handle incorrect usage gracefully.
+ *   vended_connection_count - the # of connections held by external users that haven't been released, plus any
+ *      parked in the fast-path slots (those only stop counting when a locked path reclaims them; see the
+ *      fast_pool_slots comment).  Under correct usage this should be zero before SHUTTING_DOWN is entered,
+ *      but we attempt to handle incorrect usage gracefully.
  *
  *  While shutting down, as pending connects resolve, we immediately release new incoming (from http) connections
  *
@@ -139,10 +186,42 @@ struct aws_http_connection_manager {
     enum aws_http_connection_manager_state_type state;
 
     /*
-     * The set of all available, ready-to-be-used connections
+     * The set of all available, ready-to-be-used connections, as `struct aws_idle_connection`.
+     * Vending pops from the back (most-recently released first); the front entry is therefore
+     * always the one that has been idle the longest, which is where the reaper looks.
      */
     struct aws_array_list connections;
 
+    /*
+     * Maps each open connection (pointer) to the thread id of the event loop its channel
+     * runs on, captured when the connection-setup callback runs on that loop.  Entries are
+     * added on setup and removed on shutdown.  The id is stored in the value pointer
+     * directly (thread ids originate from pointer-sized handles on supported platforms).
+     */
+    struct aws_hash_table connection_home_threads;
+
+    /*
+     * A lock-free fast path in front of `connections`: a small array of atomic slots,
+     * each either NULL or an idle connection.  The uncontended acquire/release pair is
+     * an atomic swap in each direction; the mutex-guarded path is only taken when the
+     * slots are empty, or when bookkeeping must change (pending acquisitions, new
+     * connects, shutdown).  Both fast paths double-check the conditions that sent them
+     * down the fast path after publishing, and undo themselves if they lost a race.
+     *
+     * A connection parked in a slot still counts toward vended_connection_count: the fast
+     * paths never touch that counter, so the locked logic's max_connections invariant
+     * (vended + pending connects <= max) can't observe a slot operation mid-flight.  The
+     * count only moves from "vended" to the idle list under the lock, when a locked path
+     * reclaims the slots.
+     */
+    struct aws_atomic_var fast_pool_slots[AWS_HTTP_CONNECTION_MANAGER_FAST_POOL_SLOTS];
+
+    /*
+     * Mirrors (state == AWS_HCMST_READY).  Written under the lock, readable by the
+     * fast paths without it.
+     */
+    struct aws_atomic_var is_ready;
+
     /*
      * The set of all incomplete connection acquisition requests
      */
@@ -151,8 +230,10 @@ struct aws_http_connection_manager {
     /*
      * The number of all incomplete connection acquisition requests.  So
      * that we don't have compute the size of a linked list every time.
+     *
+     * Atomic because the fast paths consult it without taking the lock.
      */
-    size_t pending_acquisition_count;
+    struct aws_atomic_var pending_acquisition_count;
 
     /*
      * The number of pending new connection requests we have outstanding to the http
@@ -162,8 +243,10 @@ struct aws_http_connection_manager {
 
     /*
      * The number of connections currently being used by external users.
+     *
+     * Atomic because the fast paths adjust it without taking the lock.
      */
-    size_t vended_connection_count;
+    struct aws_atomic_var vended_connection_count;
 
     /*
      * Always equal to # of connection shutdown callbacks not yet invoked
@@ -189,6 +272,59 @@ struct aws_http_connection_manager {
      */
     size_t max_connections;
 
+    /*
+     * If non-zero, connections idle in the pool for at least this long are closed by the
+     * periodic cull task.  Immutable after creation.
+     */
+    uint64_t max_connection_idle_in_milliseconds;
+
+    /*
+     * Warm floor: the number of connections the manager establishes eagerly and keeps alive
+     * (the cull task never dips below it, and build_transaction re-opens replacements when
+     * connections die).  For proxied managers each floor connection is an established
+     * CONNECT tunnel.  Immutable after creation.
+     */
+    size_t min_connections;
+
+    /*
+     * Maximum number of spare connections pre-warming may hold ahead of demand.  Zero
+     * disables pre-warming.  Immutable after creation.
+     */
+    size_t prewarm_headroom;
+
+    /*
+     * Pre-warming's view of demand, maintained under the lock: acquisitions observed in the
+     * current measurement window, and the count from the last completed window.  Only
+     * acquisitions that miss the lock-free fast path are counted - which is exactly the
+     * demand that pre-warming could have absorbed.
+     */
+    uint64_t acquire_rate_window_start;
+    size_t acquire_rate_window_count;
+    size_t measured_acquire_rate;
+
+    /*
+     * Cumulative activity counters and the acquire-latency histogram backing
+     * aws_http_connection_manager_fetch_metrics.  All atomic so the lock-free fast paths
+     * can record without taking the lock, and so fetching is just a series of loads.
+     */
+    struct aws_atomic_var total_acquisition_count;
+    struct aws_atomic_var pool_hit_count;
+    struct aws_atomic_var connect_count;
+    struct aws_atomic_var failed_acquisition_count;
+    struct aws_atomic_var acquire_latency_buckets[AWS_HTTP_CONNECTION_MANAGER_METRICS_LATENCY_BUCKETS];
+    struct aws_atomic_var connect_total_time_ns;
+    struct aws_atomic_var connect_channel_time_ns;
+
+    /*
+     * Periodic task that reaps idle connections, and the event loop it runs on.  The task
+     * is only ever armed while is_cull_task_scheduled is true; that flag keeps the manager
+     * alive (via s_aws_http_connection_manager_should_destroy) until the task's final run
+     * or cancellation has observed the shutdown.
+     */
+    struct aws_task cull_task;
+    struct aws_event_loop *cull_event_loop;
+    bool is_cull_task_scheduled;
+
     /*
      * Lifecycle tracking for the connection manager.  Starts at 1.
      *
@@ -212,6 +348,7 @@ struct aws_http_connection_manager_snapshot {
     size_t pending_connects_count;
     size_t vended_connection_count;
     size_t open_connection_count;
+    size_t measured_acquire_rate;
 
     size_t external_ref_count;
 };
@@ -225,10 +362,11 @@ static void s_aws_http_connection_manager_get_snapshot(
 
     snapshot->state = manager->state;
     snapshot->held_connection_count = aws_array_list_length(&manager->connections);
-    snapshot->pending_acquisition_count = manager->pending_acquisition_count;
+    snapshot->pending_acquisition_count = aws_atomic_load_int(&manager->pending_acquisition_count);
     snapshot->pending_connects_count = manager->pending_connects_count;
-    snapshot->vended_connection_count = manager->vended_connection_count;
+    snapshot->vended_connection_count = aws_atomic_load_int(&manager->vended_connection_count);
     snapshot->open_connection_count = manager->open_connection_count;
+    snapshot->measured_acquire_rate = manager->measured_acquire_rate;
 
     snapshot->external_ref_count = manager->external_ref_count;
 }
@@ -240,7 +378,8 @@ static void s_aws_http_connection_manager_log_snapshot(
         AWS_LOGF_DEBUG(
             AWS_LS_HTTP_CONNECTION_MANAGER,
             "id=%p: snapshot - state=%d, held_connection_count=%zu, pending_acquire_count=%zu, "
-            "pending_connect_count=%zu, vended_connection_count=%zu, open_connection_count=%zu, ref_count=%zu",
+            "pending_connect_count=%zu, vended_connection_count=%zu, open_connection_count=%zu, "
+            "measured_acquire_rate=%zu, ref_count=%zu",
             (void *)manager,
             (int)snapshot->state,
             snapshot->held_connection_count,
@@ -248,6 +387,7 @@ static void s_aws_http_connection_manager_log_snapshot(
             snapshot->pending_connects_count,
             snapshot->vended_connection_count,
             snapshot->open_connection_count,
+            snapshot->measured_acquire_rate,
             snapshot->external_ref_count);
     } else {
         AWS_LOGF_DEBUG(
@@ -279,11 +419,16 @@ static bool s_aws_http_connection_manager_should_destroy(struct aws_http_connect
         return false;
     }
 
-    if (manager->vended_connection_count > 0 || manager->pending_connects_count > 0 ||
+    if (aws_atomic_load_int(&manager->vended_connection_count) > 0 || manager->pending_connects_count > 0 ||
         manager->open_connection_count > 0) {
         return false;
     }
 
+    /* The cull task's arg is the manager; it must run (or be cancelled) before we can go away */
+    if (manager->is_cull_task_scheduled) {
+        return false;
+    }
+
     return true;
 }
 
@@ -301,13 +446,43 @@ static bool s_aws_http_connection_manager_should_destroy(struct aws_http_connect
  */
 struct aws_http_connection_acquisition {
     struct aws_linked_list_node node;
-    struct aws_http_connection_manager *manager; /* Only used by logging */
+    struct aws_http_connection_manager *manager; /* Only used by logging and metrics */
     aws_http_connection_manager_on_connection_setup_fn *callback;
     void *user_data;
     struct aws_http_connection *connection;
     int error_code;
+
+    /* When set, vending prefers a pooled connection homed on caller_thread_id */
+    bool prefer_callers_thread;
+    uint64_t caller_thread_id;
+
+    /* Timestamp of the acquire call, for the latency histogram.  Zero = not measured. */
+    uint64_t acquire_start_timestamp;
 };
 
+static int s_aws_http_connection_manager_get_monotonic_time(
+    struct aws_http_connection_manager *manager,
+    uint64_t *current_time);
+
+/*
+ * Adds one completed acquisition to the acquire-latency histogram.  Bucket i covers
+ * [2^i, 2^(i+1)) microseconds; durations past the top bucket's lower bound land in the
+ * top bucket.
+ */
+static void s_aws_http_connection_manager_record_acquire_latency(
+    struct aws_http_connection_manager *manager,
+    uint64_t elapsed_ns) {
+
+    const uint64_t elapsed_us = aws_timestamp_convert(elapsed_ns, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MICROS, NULL);
+
+    size_t bucket = 0;
+    while (bucket + 1 < AWS_HTTP_CONNECTION_MANAGER_METRICS_LATENCY_BUCKETS && (elapsed_us >> (bucket + 1)) != 0) {
+        ++bucket;
+    }
+
+    aws_atomic_fetch_add(&manager->acquire_latency_buckets[bucket], 1);
+}
+
 /*
  * Invokes a set of connection acquisition completion callbacks.
  *
@@ -320,15 +495,39 @@ static void s_aws_http_connection_manager_complete_acquisitions(
     struct aws_linked_list *acquisitions,
     struct aws_allocator *allocator) {
 
+    uint64_t completion_time = 0;
+    bool have_completion_time = false;
+
     while (!aws_linked_list_empty(acquisitions)) {
         struct aws_linked_list_node *node = aws_linked_list_pop_front(acquisitions);
         struct aws_http_connection_acquisition *pending_acquisition =
             AWS_CONTAINER_OF(node, struct aws_http_connection_acquisition, node);
 
+        AWS_HTTP_TRACE3(
+            connection_manager_vend,
+            pending_acquisition->manager,
+            pending_acquisition->connection,
+            pending_acquisition->error_code);
+
         pending_acquisition->callback(
             pending_acquisition->connection, pending_acquisition->error_code, pending_acquisition->user_data);
 
+        if (pending_acquisition->acquire_start_timestamp != 0) {
+            /* One clock read covers the whole completion batch */
+            if (!have_completion_time) {
+                s_aws_http_connection_manager_get_monotonic_time(pending_acquisition->manager, &completion_time);
+                have_completion_time = true;
+            }
+
+            uint64_t elapsed_ns = 0;
+            if (completion_time > pending_acquisition->acquire_start_timestamp) {
+                elapsed_ns = completion_time - pending_acquisition->acquire_start_timestamp;
+            }
+            s_aws_http_connection_manager_record_acquire_latency(pending_acquisition->manager, elapsed_ns);
+        }
+
         if (pending_acquisition->error_code != 0) {
+            aws_atomic_fetch_add(&pending_acquisition->manager->failed_acquisition_count, 1);
             AWS_LOGF_WARN(
                 AWS_LS_HTTP_CONNECTION_MANAGER,
                 "id=%p: Failed to completed connection acquisition with error_code %d(%s)",
@@ -366,8 +565,8 @@ static void s_aws_http_connection_manager_move_front_acquisition(
     AWS_FATAL_ASSERT(!aws_linked_list_empty(&manager->pending_acquisitions));
     struct aws_linked_list_node *node = aws_linked_list_pop_front(&manager->pending_acquisitions);
 
-    AWS_FATAL_ASSERT(manager->pending_acquisition_count > 0);
-    --manager->pending_acquisition_count;
+    AWS_FATAL_ASSERT(aws_atomic_load_int(&manager->pending_acquisition_count) > 0);
+    aws_atomic_fetch_sub(&manager->pending_acquisition_count, 1);
 
     if (error_code == AWS_ERROR_SUCCESS && connection == NULL) {
         AWS_LOGF_FATAL(
@@ -402,10 +601,16 @@ struct aws_connection_management_transaction {
     struct aws_allocator *allocator;
     struct aws_linked_list completions;
     struct aws_http_connection *connection_to_release;
-    struct aws_array_list connections_to_release;
+    struct aws_array_list connections_to_release; /* holds `struct aws_idle_connection` */
     struct aws_http_connection_manager_snapshot snapshot;
     size_t new_connections;
     bool should_destroy_manager;
+
+    /*
+     * Set by the connection-setup path before building, so that vending the
+     * just-established connection is not counted as a pool hit in the metrics.
+     */
+    bool vending_fresh_connection;
 };
 
 static void s_aws_connection_management_transaction_init(
@@ -416,7 +621,7 @@ static void s_aws_connection_management_transaction_init(
     /* 0-size, does no allocation, cannot fail */
     AWS_FATAL_ASSERT(
         aws_array_list_init_dynamic(
-            &work->connections_to_release, manager->allocator, 0, sizeof(struct aws_http_connection *)) ==
+            &work->connections_to_release, manager->allocator, 0, sizeof(struct aws_idle_connection)) ==
         AWS_OP_SUCCESS);
 
     aws_linked_list_init(&work->completions);
@@ -428,17 +633,269 @@ static void s_aws_connection_management_transaction_clean_up(struct aws_connecti
     aws_array_list_clean_up(&work->connections_to_release);
 }
 
+/*
+ * Attempts to pop an idle connection from the fast-path slots.  Does not require the lock.
+ *
+ * Scans from the highest slot downward while pushes fill the lowest empty slot, making the
+ * slots behave as a stack: the most recently released connection is vended first.  LIFO
+ * vending matters for latency - it concentrates traffic on a small hot subset whose TCP
+ * congestion windows and TLS sessions stay warm, while the cold tail sits idle long enough
+ * for the reaper to close it.  (The locked pool vends LIFO as well, by popping the back.)
+ */
+static struct aws_http_connection *s_aws_http_connection_manager_fast_pool_pop(
+    struct aws_http_connection_manager *manager) {
+
+    for (size_t i = AWS_HTTP_CONNECTION_MANAGER_FAST_POOL_SLOTS; i > 0; --i) {
+        struct aws_atomic_var *slot = &manager->fast_pool_slots[i - 1];
+        void *connection = aws_atomic_load_ptr(slot);
+        if (connection != NULL && aws_atomic_compare_exchange_ptr(slot, &connection, NULL)) {
+            return connection;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Attempts to publish an idle connection into an empty fast-path slot.  Does not require the lock.
+ */
+static bool s_aws_http_connection_manager_fast_pool_push(
+    struct aws_http_connection_manager *manager,
+    struct aws_http_connection *connection) {
+
+    for (size_t i = 0; i < AWS_HTTP_CONNECTION_MANAGER_FAST_POOL_SLOTS; ++i) {
+        struct aws_atomic_var *slot = &manager->fast_pool_slots[i];
+        void *expected = NULL;
+        if (aws_atomic_load_ptr(slot) == NULL && aws_atomic_compare_exchange_ptr(slot, &expected, connection)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Attempts to remove a specific connection from the fast-path slots.  Does not require the lock.
+ */
+static bool s_aws_http_connection_manager_fast_pool_steal(
+    struct aws_http_connection_manager *manager,
+    struct aws_http_connection *connection) {
+
+    for (size_t i = 0; i < AWS_HTTP_CONNECTION_MANAGER_FAST_POOL_SLOTS; ++i) {
+        struct aws_atomic_var *slot = &manager->fast_pool_slots[i];
+        void *expected = connection;
+        if (aws_atomic_load_ptr(slot) == connection && aws_atomic_compare_exchange_ptr(slot, &expected, NULL)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static int s_aws_http_connection_manager_get_monotonic_time(
+    struct aws_http_connection_manager *manager,
+    uint64_t *current_time) {
+
+    if (manager->system_vtable->get_monotonic_time != NULL) {
+        return manager->system_vtable->get_monotonic_time(current_time);
+    }
+
+    return aws_high_res_clock_get_ticks(current_time);
+}
+
+static bool s_aws_http_connection_manager_is_connection_draining(
+    struct aws_http_connection_manager *manager,
+    const struct aws_http_connection *connection) {
+
+    if (manager->system_vtable->is_connection_draining != NULL) {
+        return manager->system_vtable->is_connection_draining(connection);
+    }
+
+    return false;
+}
+
+static uint64_t s_aws_http_connection_manager_get_current_thread_id(struct aws_http_connection_manager *manager) {
+    if (manager->system_vtable->get_current_thread_id != NULL) {
+        return manager->system_vtable->get_current_thread_id();
+    }
+
+    return aws_thread_current_thread_id();
+}
+
+/*
+ * Looks up the thread id of the event loop a connection's channel runs on, as recorded when
+ * the connection's setup callback ran.  Returns zero (unknown) if there is no record.
+ *
+ * Hard Requirement: Manager's lock must held somewhere in the call stack
+ */
+static uint64_t s_aws_http_connection_manager_home_thread_for_connection(
+    struct aws_http_connection_manager *manager,
+    struct aws_http_connection *connection) {
+
+    struct aws_hash_element *element = NULL;
+    if (aws_hash_table_find(&manager->connection_home_threads, connection, &element) || element == NULL) {
+        return 0;
+    }
+
+    return (uint64_t)(uintptr_t)element->value;
+}
+
+/*
+ * Computes the time at which a connection going idle right now becomes eligible for
+ * culling.  Returns zero (never culled) if no idle timeout is configured.
+ */
+static uint64_t s_aws_http_connection_manager_compute_cull_timestamp(struct aws_http_connection_manager *manager) {
+    if (manager->max_connection_idle_in_milliseconds == 0) {
+        return 0;
+    }
+
+    uint64_t now = 0;
+    if (s_aws_http_connection_manager_get_monotonic_time(manager, &now)) {
+        return 0;
+    }
+
+    return now + aws_timestamp_convert(
+                     manager->max_connection_idle_in_milliseconds, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
+}
+
+/*
+ * Rolls the acquisition-rate measurement window over if it has elapsed.  Called both when
+ * recording an acquisition and when the pre-warm policy reads the rate, so that the rate
+ * decays to zero once traffic stops rather than keeping stale connections warm.
+ *
+ * Hard Requirement: Manager's lock must held somewhere in the call stack
+ */
+static void s_aws_http_connection_manager_roll_acquire_rate_window(struct aws_http_connection_manager *manager) {
+    uint64_t now = 0;
+    if (s_aws_http_connection_manager_get_monotonic_time(manager, &now)) {
+        return;
+    }
+
+    const uint64_t window_ns = aws_timestamp_convert(
+        AWS_HTTP_CONNECTION_MANAGER_ACQUIRE_RATE_WINDOW_MS, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
+
+    if (manager->acquire_rate_window_start == 0) {
+        manager->acquire_rate_window_start = now;
+    } else if (now - manager->acquire_rate_window_start >= window_ns) {
+        /* If the manager sat quiet for more than a full window, the stale count is not
+         * evidence of current demand; let the rate decay to zero. */
+        if (now - manager->acquire_rate_window_start >= 2 * window_ns) {
+            manager->measured_acquire_rate = 0;
+        } else {
+            manager->measured_acquire_rate = manager->acquire_rate_window_count;
+        }
+
+        manager->acquire_rate_window_start = now;
+        manager->acquire_rate_window_count = 0;
+    }
+}
+
+/*
+ * Records `count` acquisitions toward the rate measurement that drives pre-warming.
+ *
+ * Hard Requirement: Manager's lock must held somewhere in the call stack
+ */
+static void s_aws_http_connection_manager_record_acquisitions(
+    struct aws_http_connection_manager *manager,
+    size_t count) {
+
+    if (manager->prewarm_headroom == 0) {
+        return;
+    }
+
+    s_aws_http_connection_manager_roll_acquire_rate_window(manager);
+    manager->acquire_rate_window_count += count;
+}
+
+/*
+ * Moves all connections parked in the fast-path slots into the `connections` list, stamping
+ * them as if they went idle just now.  (Parked connections are the manager's hottest ones;
+ * the slight idle-clock reset this gives them is harmless.)
+ *
+ * Parked connections still count as vended (see the fast_pool_slots comment), so this is
+ * also the one place the count transfers out of vended_connection_count - under the lock,
+ * where the invariant checks that read the counter can't interleave.
+ *
+ * Hard Requirement: Manager's lock must held somewhere in the call stack
+ */
+static void s_aws_http_connection_manager_reclaim_parked_connections(struct aws_http_connection_manager *manager) {
+    struct aws_http_connection *parked_connection = NULL;
+    uint64_t cull_timestamp = 0;
+    bool have_cull_timestamp = false;
+
+    while ((parked_connection = s_aws_http_connection_manager_fast_pool_pop(manager)) != NULL) {
+        aws_atomic_fetch_sub(&manager->vended_connection_count, 1);
+
+        if (!have_cull_timestamp) {
+            cull_timestamp = s_aws_http_connection_manager_compute_cull_timestamp(manager);
+            have_cull_timestamp = true;
+        }
+
+        struct aws_idle_connection idle_connection = {
+            .connection = parked_connection,
+            .cull_timestamp = cull_timestamp,
+            .home_thread_id = s_aws_http_connection_manager_home_thread_for_connection(manager, parked_connection),
+        };
+        AWS_FATAL_ASSERT(aws_array_list_push_back(&manager->connections, &idle_connection) == AWS_OP_SUCCESS);
+    }
+}
+
 static void s_aws_http_connection_manager_build_transaction(struct aws_connection_management_transaction *work) {
     struct aws_http_connection_manager *manager = work->manager;
 
+    /*
+     * Step 0 - Reclaim connections parked in the fast-path slots, so the locked logic below
+     * sees every idle connection.  Every path that creates a pending acquisition, or moves
+     * toward shutdown, runs through here while holding the lock, which (together with the
+     * fast paths' double-checks) guarantees a parked connection can't strand a waiter.
+     */
+    s_aws_http_connection_manager_reclaim_parked_connections(manager);
+
     if (manager->state == AWS_HCMST_READY) {
         /*
          * Step 1 - If there's free connections, complete acquisition requests
          */
-        while (aws_array_list_length(&manager->connections) > 0 && manager->pending_acquisition_count > 0) {
-            struct aws_http_connection *connection = NULL;
-            aws_array_list_back(&manager->connections, &connection);
+        while (aws_array_list_length(&manager->connections) > 0 &&
+               aws_atomic_load_int(&manager->pending_acquisition_count) > 0) {
+            const size_t held_count = aws_array_list_length(&manager->connections);
+
+            /*
+             * Default choice is the back (most recently released); an acquisition that asked
+             * for thread affinity instead gets the most recently released connection homed on
+             * its thread, if one is pooled.
+             */
+            size_t chosen_index = held_count - 1;
+
+            struct aws_http_connection_acquisition *front_acquisition = AWS_CONTAINER_OF(
+                aws_linked_list_front(&manager->pending_acquisitions), struct aws_http_connection_acquisition, node);
+            if (front_acquisition->prefer_callers_thread && front_acquisition->caller_thread_id != 0) {
+                for (size_t i = held_count; i > 0; --i) {
+                    struct aws_idle_connection candidate;
+                    AWS_ZERO_STRUCT(candidate);
+                    aws_array_list_get_at(&manager->connections, &candidate, i - 1);
+                    if (candidate.home_thread_id == front_acquisition->caller_thread_id) {
+                        chosen_index = i - 1;
+                        break;
+                    }
+                }
+            }
 
+            struct aws_idle_connection idle_connection;
+            AWS_ZERO_STRUCT(idle_connection);
+            aws_array_list_get_at(&manager->connections, &idle_connection, chosen_index);
+            struct aws_http_connection *connection = idle_connection.connection;
+
+            /*
+             * Remove the chosen entry by shifting the entries behind it forward, preserving
+             * the oldest-first ordering the cull task relies on.  chosen_index is the back
+             * except for affine hits, so the shift is almost always empty.
+             */
+            for (size_t i = chosen_index + 1; i < held_count; ++i) {
+                struct aws_idle_connection shifted;
+                AWS_ZERO_STRUCT(shifted);
+                aws_array_list_get_at(&manager->connections, &shifted, i);
+                aws_array_list_set_at(&manager->connections, &shifted, i - 1);
+            }
             aws_array_list_pop_back(&manager->connections);
 
             AWS_LOGF_DEBUG(
@@ -448,19 +905,23 @@ static void s_aws_http_connection_manager_build_transaction(struct aws_connectio
                 (void *)connection);
             s_aws_http_connection_manager_move_front_acquisition(
                 manager, connection, AWS_ERROR_SUCCESS, &work->completions);
-            ++manager->vended_connection_count;
+            aws_atomic_fetch_add(&manager->vended_connection_count, 1);
+            if (!work->vending_fresh_connection) {
+                aws_atomic_fetch_add(&manager->pool_hit_count, 1);
+            }
         }
 
         /*
          * Step 2 - if there's excess pending acquisitions and we have room to make more, make more
          */
-        if (manager->pending_acquisition_count > manager->pending_connects_count) {
-            AWS_FATAL_ASSERT(
-                manager->max_connections >= manager->vended_connection_count + manager->pending_connects_count);
+        const size_t pending_acquisition_count = aws_atomic_load_int(&manager->pending_acquisition_count);
+        const size_t vended_connection_count = aws_atomic_load_int(&manager->vended_connection_count);
+        if (pending_acquisition_count > manager->pending_connects_count) {
+            AWS_FATAL_ASSERT(manager->max_connections >= vended_connection_count + manager->pending_connects_count);
 
-            work->new_connections = manager->pending_acquisition_count - manager->pending_connects_count;
+            work->new_connections = pending_acquisition_count - manager->pending_connects_count;
             size_t max_new_connections =
-                manager->max_connections - (manager->vended_connection_count + manager->pending_connects_count);
+                manager->max_connections - (vended_connection_count + manager->pending_connects_count);
 
             if (work->new_connections > max_new_connections) {
                 work->new_connections = max_new_connections;
@@ -468,6 +929,63 @@ static void s_aws_http_connection_manager_build_transaction(struct aws_connectio
 
             manager->pending_connects_count += work->new_connections;
         }
+
+        /*
+         * Step 3 - optional pre-warming: on top of the strictly demand-driven connects above,
+         * speculatively open connections so that some spares (idle, or already connecting)
+         * are available for the next wave of acquisitions.  The spare target is bounded both
+         * by the configured headroom and by the observed demand, so an idle manager holds
+         * nothing extra.
+         */
+        if (manager->prewarm_headroom > 0) {
+            s_aws_http_connection_manager_roll_acquire_rate_window(manager);
+
+            const size_t held_count = aws_array_list_length(&manager->connections);
+            const size_t unmet_acquisitions = aws_atomic_load_int(&manager->pending_acquisition_count);
+            const size_t committed = aws_atomic_load_int(&manager->vended_connection_count) +
+                                     manager->pending_connects_count + held_count;
+
+            size_t spare_target = manager->measured_acquire_rate + unmet_acquisitions;
+            if (spare_target > manager->prewarm_headroom) {
+                spare_target = manager->prewarm_headroom;
+            }
+
+            size_t spare_count = held_count + manager->pending_connects_count;
+            if (spare_count > unmet_acquisitions) {
+                spare_count -= unmet_acquisitions;
+            } else {
+                spare_count = 0;
+            }
+
+            if (spare_target > spare_count && manager->max_connections > committed) {
+                size_t prewarm_connections = spare_target - spare_count;
+                size_t room = manager->max_connections - committed;
+                if (prewarm_connections > room) {
+                    prewarm_connections = room;
+                }
+
+                work->new_connections += prewarm_connections;
+                manager->pending_connects_count += prewarm_connections;
+            }
+        }
+
+        /*
+         * Step 4 - maintain the warm floor.  Everything the manager holds or is in the
+         * middle of opening counts toward it, so this only kicks in at creation time and
+         * when connections die.  Especially important for proxied managers, where each
+         * replacement connection is a fresh CONNECT tunnel costing several round trips.
+         */
+        if (manager->min_connections > 0) {
+            const size_t committed = aws_atomic_load_int(&manager->vended_connection_count) +
+                                     manager->pending_connects_count + aws_array_list_length(&manager->connections);
+
+            if (committed < manager->min_connections) {
+                size_t floor_connections = manager->min_connections - committed;
+
+                work->new_connections += floor_connections;
+                manager->pending_connects_count += floor_connections;
+            }
+        }
     } else {
         /*
          * swap our internal connection set with the zeroed work set
@@ -490,8 +1008,8 @@ static void s_aws_http_connection_manager_build_transaction(struct aws_connectio
             AWS_LS_HTTP_CONNECTION_MANAGER,
             "id=%p: manager release, failing %zu pending acquisitions",
             (void *)manager,
-            manager->pending_acquisition_count);
-        manager->pending_acquisition_count = 0;
+            aws_atomic_load_int(&manager->pending_acquisition_count));
+        aws_atomic_store_int(&manager->pending_acquisition_count, 0);
 
         work->should_destroy_manager = s_aws_http_connection_manager_should_destroy(manager);
     }
@@ -509,13 +1027,16 @@ static void s_aws_http_connection_manager_destroy(struct aws_http_connection_man
     AWS_LOGF_INFO(AWS_LS_HTTP_CONNECTION_MANAGER, "id=%p: Destroying self", (void *)manager);
 
     AWS_ASSERT(manager->pending_connects_count == 0);
-    AWS_ASSERT(manager->vended_connection_count == 0);
-    AWS_ASSERT(manager->pending_acquisition_count == 0);
+    AWS_ASSERT(aws_atomic_load_int(&manager->vended_connection_count) == 0);
+    AWS_ASSERT(aws_atomic_load_int(&manager->pending_acquisition_count) == 0);
     AWS_ASSERT(manager->open_connection_count == 0);
     AWS_ASSERT(aws_linked_list_empty(&manager->pending_acquisitions));
     AWS_ASSERT(aws_array_list_length(&manager->connections) == 0);
+    AWS_ASSERT(s_aws_http_connection_manager_fast_pool_pop(manager) == NULL);
+    AWS_ASSERT(!manager->is_cull_task_scheduled);
 
     aws_array_list_clean_up(&manager->connections);
+    aws_hash_table_clean_up(&manager->connection_home_threads);
 
     aws_string_destroy(manager->host);
     if (manager->tls_connection_options) {
@@ -536,60 +1057,204 @@ static void s_aws_http_connection_manager_destroy(struct aws_http_connection_man
     aws_mem_release(manager->allocator, manager);
 }
 
-struct aws_http_connection_manager *aws_http_connection_manager_new(
-    struct aws_allocator *allocator,
-    struct aws_http_connection_manager_options *options) {
-
-    aws_http_fatal_assert_library_initialized();
-
-    if (!options || !options->socket_options || options->max_connections == 0) {
-        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-        return NULL;
+/*
+ * Arms the cull task for its next run.  The caller must have set is_cull_task_scheduled
+ * beforehand (under the lock, unless the manager hasn't been published yet).
+ */
+static void s_aws_http_connection_manager_schedule_culling(struct aws_http_connection_manager *manager) {
+    uint64_t period_ms = manager->max_connection_idle_in_milliseconds;
+    if (period_ms > AWS_HTTP_CONNECTION_MANAGER_CULL_PERIOD_MAX_MS) {
+        period_ms = AWS_HTTP_CONNECTION_MANAGER_CULL_PERIOD_MAX_MS;
     }
 
-    struct aws_http_connection_manager *manager =
-        aws_mem_acquire(allocator, sizeof(struct aws_http_connection_manager));
-    if (manager == NULL) {
-        return NULL;
-    }
+    uint64_t now = 0;
+    s_aws_http_connection_manager_get_monotonic_time(manager, &now);
 
-    AWS_ZERO_STRUCT(*manager);
-    manager->allocator = allocator;
+    aws_event_loop_schedule_task_future(
+        manager->cull_event_loop,
+        &manager->cull_task,
+        now + aws_timestamp_convert(period_ms, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL));
+}
 
-    if (aws_mutex_init(&manager->lock)) {
-        goto on_error;
-    }
+/*
+ * Runs periodically on an event loop, closing connections at the idle end of the pool whose
+ * cull timestamps have passed.  Also serves as the final gate of manager shutdown: once the
+ * task wakes (or is cancelled) and observes the SHUTTING_DOWN state, it stops rescheduling
+ * itself and lets the normal destruction check run with is_cull_task_scheduled now false.
+ */
+static void s_aws_http_connection_manager_cull_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
 
-    if (aws_array_list_init_dynamic(
-            &manager->connections, allocator, options->max_connections, sizeof(struct aws_http_connection *))) {
-        goto on_error;
-    }
+    struct aws_http_connection_manager *manager = arg;
 
-    aws_linked_list_init(&manager->pending_acquisitions);
+    struct aws_connection_management_transaction work;
+    s_aws_connection_management_transaction_init(&work, manager);
 
-    manager->host = aws_string_new_from_array(allocator, options->host.ptr, options->host.len);
-    if (manager->host == NULL) {
-        goto on_error;
-    }
+    /* On clock failure, now stays zero and nothing gets culled this tick */
+    uint64_t now = 0;
+    s_aws_http_connection_manager_get_monotonic_time(manager, &now);
 
-    if (options->tls_connection_options) {
-        manager->tls_connection_options = aws_mem_calloc(allocator, 1, sizeof(struct aws_tls_connection_options));
-        if (aws_tls_connection_options_copy(manager->tls_connection_options, options->tls_connection_options)) {
-            goto on_error;
-        }
-    }
+    bool should_reschedule = false;
 
-    if (options->proxy_options) {
-        manager->proxy_config = aws_http_proxy_config_new(allocator, options->proxy_options);
-        if (manager->proxy_config == NULL) {
-            goto on_error;
-        }
-    }
+    aws_mutex_lock(&manager->lock);
+
+    manager->is_cull_task_scheduled = false;
+
+    if (status == AWS_TASK_STATUS_RUN_READY && manager->state == AWS_HCMST_READY) {
+        /*
+         * Connections parked in the fast-path slots are invisible to the scan below; pull
+         * them in (freshly stamped) so a fully-idle manager still drains down to the floor.
+         */
+        s_aws_http_connection_manager_reclaim_parked_connections(manager);
+
+        /*
+         * Oldest connections sit at the front of the list.  Stop at the first one that is
+         * too young, or when culling further would dip below the configured floor.
+         */
+        const size_t held_count = aws_array_list_length(&manager->connections);
+        size_t cull_count = 0;
+        while (held_count - cull_count > manager->min_connections) {
+            struct aws_idle_connection idle_connection;
+            AWS_ZERO_STRUCT(idle_connection);
+            aws_array_list_get_at(&manager->connections, &idle_connection, cull_count);
+
+            if (idle_connection.cull_timestamp == 0 || idle_connection.cull_timestamp > now) {
+                break;
+            }
+
+            AWS_FATAL_ASSERT(
+                aws_array_list_push_back(&work.connections_to_release, &idle_connection) == AWS_OP_SUCCESS);
+            ++cull_count;
+        }
+
+        if (cull_count > 0) {
+            /* Shift the survivors down and trim; culling is rare, so O(n) is fine */
+            for (size_t i = cull_count; i < held_count; ++i) {
+                struct aws_idle_connection survivor;
+                AWS_ZERO_STRUCT(survivor);
+                aws_array_list_get_at(&manager->connections, &survivor, i);
+                aws_array_list_set_at(&manager->connections, &survivor, i - cull_count);
+            }
+            for (size_t i = 0; i < cull_count; ++i) {
+                aws_array_list_pop_back(&manager->connections);
+            }
+        }
+
+        manager->is_cull_task_scheduled = true;
+        should_reschedule = true;
+    } else {
+        work.should_destroy_manager = s_aws_http_connection_manager_should_destroy(manager);
+    }
+
+    s_aws_http_connection_manager_get_snapshot(manager, &work.snapshot);
+
+    aws_mutex_unlock(&manager->lock);
+
+    size_t culled_count = aws_array_list_length(&work.connections_to_release);
+    if (culled_count > 0) {
+        AWS_LOGF_DEBUG(
+            AWS_LS_HTTP_CONNECTION_MANAGER,
+            "id=%p: Culling %zu connection(s) idle for more than %" PRIu64 " milliseconds",
+            (void *)manager,
+            culled_count,
+            manager->max_connection_idle_in_milliseconds);
+    }
+
+    if (should_reschedule) {
+        s_aws_http_connection_manager_schedule_culling(manager);
+    }
+
+    s_aws_http_connection_manager_execute_transaction(&work);
+}
+
+struct aws_http_connection_manager *aws_http_connection_manager_new(
+    struct aws_allocator *allocator,
+    struct aws_http_connection_manager_options *options) {
+
+    aws_http_fatal_assert_library_initialized();
+
+    if (!options || !options->socket_options || options->max_connections == 0) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    struct aws_http_connection_manager *manager =
+        aws_mem_acquire(allocator, sizeof(struct aws_http_connection_manager));
+    if (manager == NULL) {
+        return NULL;
+    }
+
+    AWS_ZERO_STRUCT(*manager);
+    manager->allocator = allocator;
+
+    if (aws_mutex_init(&manager->lock)) {
+        goto on_error;
+    }
+
+    if (aws_array_list_init_dynamic(
+            &manager->connections, allocator, options->max_connections, sizeof(struct aws_idle_connection))) {
+        goto on_error;
+    }
+
+    if (aws_hash_table_init(
+            &manager->connection_home_threads,
+            allocator,
+            options->max_connections,
+            aws_hash_ptr,
+            aws_ptr_eq,
+            NULL,
+            NULL)) {
+        goto on_error;
+    }
+
+    aws_linked_list_init(&manager->pending_acquisitions);
+    aws_atomic_init_int(&manager->pending_acquisition_count, 0);
+    aws_atomic_init_int(&manager->vended_connection_count, 0);
+    aws_atomic_init_int(&manager->is_ready, 0);
+    for (size_t i = 0; i < AWS_HTTP_CONNECTION_MANAGER_FAST_POOL_SLOTS; ++i) {
+        aws_atomic_init_ptr(&manager->fast_pool_slots[i], NULL);
+    }
+
+    aws_atomic_init_int(&manager->total_acquisition_count, 0);
+    aws_atomic_init_int(&manager->pool_hit_count, 0);
+    aws_atomic_init_int(&manager->connect_count, 0);
+    aws_atomic_init_int(&manager->failed_acquisition_count, 0);
+    for (size_t i = 0; i < AWS_HTTP_CONNECTION_MANAGER_METRICS_LATENCY_BUCKETS; ++i) {
+        aws_atomic_init_int(&manager->acquire_latency_buckets[i], 0);
+    }
+    aws_atomic_init_int(&manager->connect_total_time_ns, 0);
+    aws_atomic_init_int(&manager->connect_channel_time_ns, 0);
+
+    manager->host = aws_string_new_from_array(allocator, options->host.ptr, options->host.len);
+    if (manager->host == NULL) {
+        goto on_error;
+    }
+
+    if (options->tls_connection_options) {
+        manager->tls_connection_options = aws_mem_calloc(allocator, 1, sizeof(struct aws_tls_connection_options));
+        if (aws_tls_connection_options_copy(manager->tls_connection_options, options->tls_connection_options)) {
+            goto on_error;
+        }
+    }
+
+    if (options->proxy_options) {
+        manager->proxy_config = aws_http_proxy_config_new(allocator, options->proxy_options);
+        if (manager->proxy_config == NULL) {
+            goto on_error;
+        }
+    }
 
     manager->state = AWS_HCMST_READY;
+    aws_atomic_store_int(&manager->is_ready, 1);
     manager->initial_window_size = options->initial_window_size;
     manager->port = options->port;
     manager->max_connections = options->max_connections;
+    manager->max_connection_idle_in_milliseconds = options->max_connection_idle_in_milliseconds;
+    manager->min_connections = options->min_connections;
+    if (manager->min_connections > manager->max_connections) {
+        manager->min_connections = manager->max_connections;
+    }
+    manager->prewarm_headroom = options->prewarm_headroom;
     manager->socket_options = *options->socket_options;
     manager->bootstrap = options->bootstrap;
     manager->system_vtable = g_aws_http_connection_manager_default_system_vtable_ptr;
@@ -597,6 +1262,21 @@ struct aws_http_connection_manager *aws_http_connection_manager_new(
     manager->shutdown_complete_callback = options->shutdown_complete_callback;
     manager->shutdown_complete_user_data = options->shutdown_complete_user_data;
 
+    if (manager->max_connection_idle_in_milliseconds > 0 && manager->bootstrap != NULL) {
+        manager->cull_event_loop = aws_event_loop_group_get_next_loop(manager->bootstrap->event_loop_group);
+        if (manager->cull_event_loop != NULL) {
+            aws_task_init(
+                &manager->cull_task,
+                s_aws_http_connection_manager_cull_task,
+                manager,
+                "connection_manager_cull_idle_connections");
+
+            /* No lock needed; the manager hasn't been published to anyone yet */
+            manager->is_cull_task_scheduled = true;
+            s_aws_http_connection_manager_schedule_culling(manager);
+        }
+    }
+
     AWS_LOGF_INFO(AWS_LS_HTTP_CONNECTION_MANAGER, "id=%p: Successfully created", (void *)manager);
 
     return manager;
@@ -632,6 +1312,7 @@ void aws_http_connection_manager_release(struct aws_http_connection_manager *man
                 "id=%p: ref count now zero, starting shut down process",
                 (void *)manager);
             manager->state = AWS_HCMST_SHUTTING_DOWN;
+            aws_atomic_store_int(&manager->is_ready, 0);
             s_aws_http_connection_manager_build_transaction(&work);
         }
     } else {
@@ -656,6 +1337,10 @@ static void s_aws_http_connection_manager_on_connection_shutdown(
     int error_code,
     void *user_data);
 
+static void s_aws_http_connection_manager_on_connection_draining(
+    struct aws_http_connection *connection,
+    void *user_data);
+
 static int s_aws_http_connection_manager_new_connection(struct aws_http_connection_manager *manager) {
     struct aws_http_client_connection_options options;
     AWS_ZERO_STRUCT(options);
@@ -670,6 +1355,7 @@ static int s_aws_http_connection_manager_new_connection(struct aws_http_connecti
     options.socket_options = &manager->socket_options;
     options.on_setup = s_aws_http_connection_manager_on_connection_setup;
     options.on_shutdown = s_aws_http_connection_manager_on_connection_shutdown;
+    options.on_draining = s_aws_http_connection_manager_on_connection_draining;
 
     struct aws_http_proxy_options proxy_options;
     AWS_ZERO_STRUCT(proxy_options);
@@ -710,14 +1396,18 @@ static void s_aws_http_connection_manager_execute_transaction(struct aws_connect
      */
     size_t release_count = aws_array_list_length(&work->connections_to_release);
     for (size_t i = 0; i < release_count; ++i) {
-        struct aws_http_connection *connection = NULL;
-        if (aws_array_list_get_at(&work->connections_to_release, &connection, i)) {
+        struct aws_idle_connection idle_connection;
+        AWS_ZERO_STRUCT(idle_connection);
+        if (aws_array_list_get_at(&work->connections_to_release, &idle_connection, i)) {
             continue;
         }
 
         AWS_LOGF_INFO(
-            AWS_LS_HTTP_CONNECTION_MANAGER, "id=%p: Releasing connection (id=%p)", (void *)manager, (void *)connection);
-        manager->system_vtable->release_connection(connection);
+            AWS_LS_HTTP_CONNECTION_MANAGER,
+            "id=%p: Releasing connection (id=%p)",
+            (void *)manager,
+            (void *)idle_connection.connection);
+        manager->system_vtable->release_connection(idle_connection.connection);
     }
 
     if (work->connection_to_release) {
@@ -743,6 +1433,7 @@ static void s_aws_http_connection_manager_execute_transaction(struct aws_connect
             "id=%p: Requesting %zu new connections from http",
             (void *)manager,
             work->new_connections);
+        aws_atomic_fetch_add(&manager->connect_count, work->new_connections);
         push_errors = aws_array_list_init_dynamic(&errors, work->allocator, work->new_connections, sizeof(int)) ==
                       AWS_ERROR_SUCCESS;
     }
@@ -776,7 +1467,7 @@ static void s_aws_http_connection_manager_execute_transaction(struct aws_connect
          * representative error.
          */
         size_t i = 0;
-        while (manager->pending_acquisition_count > manager->pending_connects_count) {
+        while (aws_atomic_load_int(&manager->pending_acquisition_count) > manager->pending_connects_count) {
             int error = representative_error;
             if (i < aws_array_list_length(&errors)) {
                 aws_array_list_get_at(&errors, &error, i);
@@ -816,23 +1507,103 @@ static void s_aws_http_connection_manager_execute_transaction(struct aws_connect
     s_aws_connection_management_transaction_clean_up(work);
 }
 
-void aws_http_connection_manager_acquire_connection(
+/*
+ * Shared implementation of single and batch acquisition.  However large the batch, the
+ * manager's lock is taken at most once: available connections are vended in one pass and
+ * the rest of the batch is queued in one pass, so completions that resolve together are
+ * delivered back-to-back from a single transaction.
+ */
+static void s_aws_http_connection_manager_acquire_connection_batch(
     struct aws_http_connection_manager *manager,
+    size_t count,
+    bool prefer_callers_thread,
     aws_http_connection_manager_on_connection_setup_fn *callback,
     void *user_data) {
 
-    AWS_LOGF_DEBUG(AWS_LS_HTTP_CONNECTION_MANAGER, "id=%p: Acquire connection", (void *)manager);
+    AWS_HTTP_TRACE2(connection_manager_acquire, manager, count);
 
-    struct aws_http_connection_acquisition *request =
-        aws_mem_acquire(manager->allocator, sizeof(struct aws_http_connection_acquisition));
-    if (request == NULL) {
-        callback(NULL, aws_last_error(), user_data);
+    /*
+     * Fast path: atomically pop idle connections from the slots without taking the lock.
+     * Correct usage guarantees the caller holds a manager ref, so the manager is READY.
+     *
+     * Affine acquisitions skip it: a connection's home thread can only be inspected safely
+     * under the lock, where build_transaction first drains the slots into the locked pool.
+     */
+    if (!prefer_callers_thread && aws_atomic_load_int(&manager->is_ready)) {
+        while (count > 0) {
+            struct aws_http_connection *fast_connection = s_aws_http_connection_manager_fast_pool_pop(manager);
+            if (fast_connection == NULL) {
+                break;
+            }
+
+            /* A parked connection was never un-counted from vended_connection_count, so
+             * vending it touches only the metrics counters */
+            aws_atomic_fetch_add(&manager->total_acquisition_count, 1);
+            aws_atomic_fetch_add(&manager->pool_hit_count, 1);
+            /* A lock-free vend completes in well under a microsecond; charge bucket zero
+             * directly rather than paying two clock reads on the hot path */
+            aws_atomic_fetch_add(&manager->acquire_latency_buckets[0], 1);
+
+            AWS_LOGF_DEBUG(
+                AWS_LS_HTTP_CONNECTION_MANAGER,
+                "id=%p: Grabbing pooled connection (%p) via fast path",
+                (void *)manager,
+                (void *)fast_connection);
+
+            AWS_HTTP_TRACE3(connection_manager_vend, manager, fast_connection, AWS_ERROR_SUCCESS);
+            callback(fast_connection, AWS_ERROR_SUCCESS, user_data);
+            --count;
+        }
+    }
+
+    if (count == 0) {
         return;
     }
 
-    AWS_ZERO_STRUCT(*request);
-    request->callback = callback;
-    request->user_data = user_data;
+    /*
+     * Allocate every tracker up front; they are freed individually as completions fire.
+     */
+    struct aws_linked_list requests;
+    aws_linked_list_init(&requests);
+
+    const uint64_t caller_thread_id =
+        prefer_callers_thread ? s_aws_http_connection_manager_get_current_thread_id(manager) : 0;
+
+    /* On clock failure the stamp stays zero and these acquisitions just aren't measured */
+    uint64_t acquire_start_timestamp = 0;
+    s_aws_http_connection_manager_get_monotonic_time(manager, &acquire_start_timestamp);
+
+    aws_atomic_fetch_add(&manager->total_acquisition_count, count);
+
+    size_t allocated_count = 0;
+    for (size_t i = 0; i < count; ++i) {
+        struct aws_http_connection_acquisition *request =
+            aws_mem_acquire(manager->allocator, sizeof(struct aws_http_connection_acquisition));
+        if (request == NULL) {
+            break;
+        }
+
+        AWS_ZERO_STRUCT(*request);
+        request->manager = manager;
+        request->callback = callback;
+        request->user_data = user_data;
+        request->prefer_callers_thread = prefer_callers_thread;
+        request->caller_thread_id = caller_thread_id;
+        request->acquire_start_timestamp = acquire_start_timestamp;
+
+        aws_linked_list_push_back(&requests, &request->node);
+        ++allocated_count;
+    }
+
+    /* Immediately fail any acquisitions we could not even allocate trackers for */
+    for (size_t i = allocated_count; i < count; ++i) {
+        aws_atomic_fetch_add(&manager->failed_acquisition_count, 1);
+        callback(NULL, aws_last_error(), user_data);
+    }
+
+    if (allocated_count == 0) {
+        return;
+    }
 
     struct aws_connection_management_transaction work;
     s_aws_connection_management_transaction_init(&work, manager);
@@ -845,11 +1616,20 @@ void aws_http_connection_manager_acquire_connection(
             "id=%p: Acquire connection called when manager in shut down state",
             (void *)manager);
 
-        request->error_code = AWS_ERROR_HTTP_CONNECTION_MANAGER_INVALID_STATE_FOR_ACQUIRE;
+        struct aws_linked_list_node *node = aws_linked_list_begin(&requests);
+        for (; node != aws_linked_list_end(&requests); node = aws_linked_list_next(node)) {
+            struct aws_http_connection_acquisition *request =
+                AWS_CONTAINER_OF(node, struct aws_http_connection_acquisition, node);
+            request->error_code = AWS_ERROR_HTTP_CONNECTION_MANAGER_INVALID_STATE_FOR_ACQUIRE;
+        }
+    }
+
+    while (!aws_linked_list_empty(&requests)) {
+        aws_linked_list_push_back(&manager->pending_acquisitions, aws_linked_list_pop_front(&requests));
     }
+    aws_atomic_fetch_add(&manager->pending_acquisition_count, allocated_count);
 
-    aws_linked_list_push_back(&manager->pending_acquisitions, &request->node);
-    ++manager->pending_acquisition_count;
+    s_aws_http_connection_manager_record_acquisitions(manager, allocated_count);
 
     s_aws_http_connection_manager_build_transaction(&work);
 
@@ -858,23 +1638,271 @@ void aws_http_connection_manager_acquire_connection(
     s_aws_http_connection_manager_execute_transaction(&work);
 }
 
+void aws_http_connection_manager_acquire_connection(
+    struct aws_http_connection_manager *manager,
+    aws_http_connection_manager_on_connection_setup_fn *callback,
+    void *user_data) {
+
+    AWS_LOGF_DEBUG(AWS_LS_HTTP_CONNECTION_MANAGER, "id=%p: Acquire connection", (void *)manager);
+
+    s_aws_http_connection_manager_acquire_connection_batch(manager, 1, false, callback, user_data);
+}
+
+void aws_http_connection_manager_acquire_affine_connection(
+    struct aws_http_connection_manager *manager,
+    aws_http_connection_manager_on_connection_setup_fn *callback,
+    void *user_data) {
+
+    AWS_LOGF_DEBUG(AWS_LS_HTTP_CONNECTION_MANAGER, "id=%p: Acquire thread-affine connection", (void *)manager);
+
+    s_aws_http_connection_manager_acquire_connection_batch(manager, 1, true, callback, user_data);
+}
+
+void aws_http_connection_manager_acquire_connections(
+    struct aws_http_connection_manager *manager,
+    size_t count,
+    aws_http_connection_manager_on_connection_setup_fn *callback,
+    void *user_data) {
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_HTTP_CONNECTION_MANAGER, "id=%p: Acquire batch of %zu connections", (void *)manager, count);
+
+    if (count == 0) {
+        return;
+    }
+
+    s_aws_http_connection_manager_acquire_connection_batch(manager, count, false, callback, user_data);
+}
+
+/*
+ * Join state for a transformed acquisition: the transform and the connection acquisition
+ * run concurrently, each completion decrements `remaining`, and whichever side finishes
+ * last invokes the user's callback.  The atomic counter provides the ordering guarantee:
+ * each side publishes its result before the fetch_sub, so the finishing side reads both.
+ */
+struct aws_http_transformed_acquisition {
+    struct aws_allocator *allocator;
+    struct aws_http_connection_manager *manager;
+    struct aws_http_message *message;
+    aws_http_connection_manager_on_transformed_connection_setup_fn *callback;
+    void *user_data;
+
+    struct aws_atomic_var remaining;
+
+    struct aws_http_connection *connection;
+    int acquisition_error_code;
+    int transform_error_code;
+};
+
+static void s_aws_http_transformed_acquisition_on_half_complete(struct aws_http_transformed_acquisition *transaction) {
+    if (aws_atomic_fetch_sub(&transaction->remaining, 1) != 1) {
+        return;
+    }
+
+    int error_code = transaction->acquisition_error_code;
+    if (error_code == AWS_ERROR_SUCCESS) {
+        error_code = transaction->transform_error_code;
+    }
+
+    struct aws_http_connection *connection = transaction->connection;
+    if (error_code != AWS_ERROR_SUCCESS && connection != NULL) {
+        /* One half failed after the other acquired; don't strand the connection */
+        aws_http_connection_manager_release_connection(transaction->manager, connection);
+        connection = NULL;
+    }
+
+    transaction->callback(connection, transaction->message, error_code, transaction->user_data);
+
+    aws_mem_release(transaction->allocator, transaction);
+}
+
+static void s_aws_http_transformed_acquisition_on_connection_setup(
+    struct aws_http_connection *connection,
+    int error_code,
+    void *user_data) {
+
+    struct aws_http_transformed_acquisition *transaction = user_data;
+
+    transaction->connection = connection;
+    transaction->acquisition_error_code = error_code;
+
+    s_aws_http_transformed_acquisition_on_half_complete(transaction);
+}
+
+static void s_aws_http_transformed_acquisition_on_transform_complete(
+    struct aws_http_message *message,
+    int error_code,
+    void *complete_ctx) {
+
+    struct aws_http_transformed_acquisition *transaction = complete_ctx;
+    AWS_FATAL_ASSERT(message == transaction->message);
+
+    transaction->transform_error_code = error_code;
+
+    s_aws_http_transformed_acquisition_on_half_complete(transaction);
+}
+
+void aws_http_connection_manager_acquire_transformed_connection(
+    struct aws_http_connection_manager *manager,
+    struct aws_http_message *message,
+    aws_http_message_transform_fn *transform,
+    void *transform_user_data,
+    aws_http_connection_manager_on_transformed_connection_setup_fn *callback,
+    void *user_data) {
+
+    AWS_FATAL_ASSERT(transform != NULL);
+    AWS_FATAL_ASSERT(callback != NULL);
+
+    AWS_LOGF_DEBUG(AWS_LS_HTTP_CONNECTION_MANAGER, "id=%p: Acquire transformed connection", (void *)manager);
+
+    struct aws_http_transformed_acquisition *transaction =
+        aws_mem_calloc(manager->allocator, 1, sizeof(struct aws_http_transformed_acquisition));
+    if (transaction == NULL) {
+        callback(NULL, message, aws_last_error(), user_data);
+        return;
+    }
+
+    transaction->allocator = manager->allocator;
+    transaction->manager = manager;
+    transaction->message = message;
+    transaction->callback = callback;
+    transaction->user_data = user_data;
+    aws_atomic_init_int(&transaction->remaining, 2);
+
+    /*
+     * Kick off the acquisition first: if a pooled connection is available the fast path
+     * completes it inline, and the transform (often ~100s of microseconds of HMAC work for
+     * signing) becomes the only thing on the critical path - exactly the work we couldn't
+     * avoid.  When no connection is pooled, the transform runs entirely under the
+     * connect/handshake latency.
+     */
+    aws_http_connection_manager_acquire_connection(
+        manager, s_aws_http_transformed_acquisition_on_connection_setup, transaction);
+
+    transform(message, transform_user_data, s_aws_http_transformed_acquisition_on_transform_complete, transaction);
+}
+
+void aws_http_connection_manager_fetch_metrics(
+    struct aws_http_connection_manager *manager,
+    struct aws_http_connection_manager_metrics *metrics) {
+
+    AWS_ZERO_STRUCT(*metrics);
+
+    aws_mutex_lock(&manager->lock);
+    metrics->held_connection_count = aws_array_list_length(&manager->connections);
+    metrics->pending_connects_count = manager->pending_connects_count;
+    metrics->open_connection_count = manager->open_connection_count;
+    aws_mutex_unlock(&manager->lock);
+
+    /*
+     * Connections parked in the fast-path slots are held too, but internally remain counted
+     * as vended (see the fast_pool_slots comment); shift them between the two gauges so the
+     * reported values keep their documented meanings.  Counting them is racy with respect to
+     * concurrent acquires/releases, which is acceptable for a sampled gauge.
+     */
+    size_t parked_connection_count = 0;
+    for (size_t i = 0; i < AWS_HTTP_CONNECTION_MANAGER_FAST_POOL_SLOTS; ++i) {
+        if (aws_atomic_load_ptr(&manager->fast_pool_slots[i]) != NULL) {
+            ++parked_connection_count;
+        }
+    }
+    metrics->held_connection_count += parked_connection_count;
+
+    metrics->pending_acquisition_count = aws_atomic_load_int(&manager->pending_acquisition_count);
+    metrics->vended_connection_count = aws_atomic_load_int(&manager->vended_connection_count);
+    if (metrics->vended_connection_count > parked_connection_count) {
+        metrics->vended_connection_count -= parked_connection_count;
+    } else {
+        metrics->vended_connection_count = 0;
+    }
+
+    metrics->total_acquisition_count = aws_atomic_load_int(&manager->total_acquisition_count);
+    metrics->pool_hit_count = aws_atomic_load_int(&manager->pool_hit_count);
+    metrics->connect_count = aws_atomic_load_int(&manager->connect_count);
+    metrics->failed_acquisition_count = aws_atomic_load_int(&manager->failed_acquisition_count);
+
+    for (size_t i = 0; i < AWS_HTTP_CONNECTION_MANAGER_METRICS_LATENCY_BUCKETS; ++i) {
+        metrics->acquire_latency_buckets[i] = aws_atomic_load_int(&manager->acquire_latency_buckets[i]);
+    }
+
+    metrics->connect_total_time_ns = aws_atomic_load_int(&manager->connect_total_time_ns);
+    metrics->connect_channel_time_ns = aws_atomic_load_int(&manager->connect_channel_time_ns);
+}
+
+/*
+ * Adds one proactive connect to the work, so losing a connection (ex: the peer began draining
+ * it) doesn't cost a future acquisition the full connection-establishment latency.
+ *
+ * Hard Requirement: Manager's lock must be held, and build_transaction must already have run
+ * so pending_connects_count reflects the demand-driven connects.
+ */
+static void s_aws_http_connection_manager_schedule_replacement_connection(
+    struct aws_http_connection_manager *manager,
+    struct aws_connection_management_transaction *work) {
+
+    if (manager->state != AWS_HCMST_READY) {
+        return;
+    }
+
+    const size_t committed = aws_atomic_load_int(&manager->vended_connection_count) +
+                             manager->pending_connects_count + aws_array_list_length(&manager->connections);
+    if (committed >= manager->max_connections) {
+        return;
+    }
+
+    ++work->new_connections;
+    ++manager->pending_connects_count;
+}
+
 int aws_http_connection_manager_release_connection(
     struct aws_http_connection_manager *manager,
     struct aws_http_connection *connection) {
 
-    struct aws_connection_management_transaction work;
-    s_aws_connection_management_transaction_init(&work, manager);
+    AWS_HTTP_TRACE2(connection_manager_release, manager, connection);
 
-    int result = AWS_OP_ERR;
-    bool should_release_connection = !manager->system_vtable->is_connection_open(connection);
+    const bool is_draining = s_aws_http_connection_manager_is_connection_draining(manager, connection);
+    bool should_release_connection = is_draining || !manager->system_vtable->is_connection_open(connection);
 
     AWS_LOGF_DEBUG(
         AWS_LS_HTTP_CONNECTION_MANAGER, "id=%p: Releasing connection (id=%p)", (void *)manager, (void *)connection);
 
+    /*
+     * Fast path: if the connection is still healthy and nobody is waiting, atomically park it
+     * in an empty slot without taking the lock.  A parked connection stays counted in
+     * vended_connection_count (only a locked reclaim transfers the count), so publishing
+     * involves no counter update the locked invariant checks could observe half-done.
+     * After publishing, double-check the conditions that made the fast path legal; if we
+     * lost a race (a waiter appeared, or shutdown began), steal the connection back and run
+     * the locked path.  If the steal fails, an acquirer already took the connection, which
+     * is an equally valid outcome.
+     */
+    if (!should_release_connection && aws_atomic_load_int(&manager->is_ready) &&
+        aws_atomic_load_int(&manager->pending_acquisition_count) == 0 &&
+        aws_atomic_load_int(&manager->vended_connection_count) > 0 &&
+        s_aws_http_connection_manager_fast_pool_push(manager, connection)) {
+
+        if (aws_atomic_load_int(&manager->is_ready) &&
+            aws_atomic_load_int(&manager->pending_acquisition_count) == 0) {
+            return AWS_OP_SUCCESS;
+        }
+
+        if (!s_aws_http_connection_manager_fast_pool_steal(manager, connection)) {
+            /* Someone else (an acquirer or the locked drain) claimed the connection */
+            return AWS_OP_SUCCESS;
+        }
+
+        /* Stole it back still counted as vended; fall through to the locked path */
+    }
+
+    struct aws_connection_management_transaction work;
+    s_aws_connection_management_transaction_init(&work, manager);
+
+    int result = AWS_OP_ERR;
+
     aws_mutex_lock(&manager->lock);
 
     /* We're probably hosed in this case, but let's not underflow */
-    if (manager->vended_connection_count == 0) {
+    if (aws_atomic_load_int(&manager->vended_connection_count) == 0) {
         AWS_LOGF_FATAL(
             AWS_LS_HTTP_CONNECTION_MANAGER,
             "id=%p: Connection released when vended connection count is zero",
@@ -885,10 +1913,15 @@ int aws_http_connection_manager_release_connection(
 
     result = AWS_OP_SUCCESS;
 
-    --manager->vended_connection_count;
+    aws_atomic_fetch_sub(&manager->vended_connection_count, 1);
 
     if (!should_release_connection) {
-        if (aws_array_list_push_back(&manager->connections, &connection)) {
+        struct aws_idle_connection idle_connection = {
+            .connection = connection,
+            .cull_timestamp = s_aws_http_connection_manager_compute_cull_timestamp(manager),
+            .home_thread_id = s_aws_http_connection_manager_home_thread_for_connection(manager, connection),
+        };
+        if (aws_array_list_push_back(&manager->connections, &idle_connection)) {
             should_release_connection = true;
         }
     }
@@ -898,6 +1931,10 @@ int aws_http_connection_manager_release_connection(
         work.connection_to_release = connection;
     }
 
+    if (is_draining) {
+        s_aws_http_connection_manager_schedule_replacement_connection(manager, &work);
+    }
+
 release:
 
     aws_mutex_unlock(&manager->lock);
@@ -922,6 +1959,21 @@ static void s_aws_http_connection_manager_on_connection_setup(
             "id=%p: Received new connection (id=%p) from http layer",
             (void *)manager,
             (void *)connection);
+
+        if (manager->system_vtable->get_connection_setup_timing) {
+            struct aws_http_connection_setup_timing setup_timing;
+            manager->system_vtable->get_connection_setup_timing(connection, &setup_timing);
+            if (setup_timing.setup_complete_timestamp_ns > setup_timing.connect_start_timestamp_ns) {
+                aws_atomic_fetch_add(
+                    &manager->connect_total_time_ns,
+                    (size_t)(setup_timing.setup_complete_timestamp_ns - setup_timing.connect_start_timestamp_ns));
+            }
+            if (setup_timing.channel_complete_timestamp_ns > setup_timing.connect_start_timestamp_ns) {
+                aws_atomic_fetch_add(
+                    &manager->connect_channel_time_ns,
+                    (size_t)(setup_timing.channel_complete_timestamp_ns - setup_timing.connect_start_timestamp_ns));
+            }
+        }
     } else {
         AWS_LOGF_WARN(
             AWS_LS_HTTP_CONNECTION_MANAGER,
@@ -940,8 +1992,25 @@ static void s_aws_http_connection_manager_on_connection_setup(
 
     if (connection != NULL) {
         if (!is_shutting_down) {
+            /*
+             * This callback runs on the thread of the event loop the new channel was assigned
+             * to, so the current thread id *is* the connection's home; record it for affine
+             * vending.  Failure to record just means the connection is never an affine match.
+             */
+            uint64_t home_thread_id = s_aws_http_connection_manager_get_current_thread_id(manager);
+            if (aws_hash_table_put(
+                    &manager->connection_home_threads, connection, (void *)(uintptr_t)home_thread_id, NULL)) {
+                home_thread_id = 0;
+            }
+
+            struct aws_idle_connection idle_connection = {
+                .connection = connection,
+                .cull_timestamp = s_aws_http_connection_manager_compute_cull_timestamp(manager),
+                .home_thread_id = home_thread_id,
+            };
             /* We reserved enough room for max_connections, this should never fail */
-            AWS_FATAL_ASSERT(aws_array_list_push_back(&manager->connections, &connection) == AWS_OP_SUCCESS);
+            AWS_FATAL_ASSERT(aws_array_list_push_back(&manager->connections, &idle_connection) == AWS_OP_SUCCESS);
+            work.vending_fresh_connection = true;
         } else {
             /*
              * We won't add the connection to the pool; just release it immediately
@@ -962,7 +2031,7 @@ static void s_aws_http_connection_manager_on_connection_setup(
          *
          * This won't happen during shutdown since there are no pending acquisitions at that point.
          */
-        while (manager->pending_acquisition_count > manager->pending_connects_count) {
+        while (aws_atomic_load_int(&manager->pending_acquisition_count) > manager->pending_connects_count) {
             AWS_LOGF_DEBUG(
                 AWS_LS_HTTP_CONNECTION_MANAGER,
                 "id=%p: Failing excess connection acquisition with error code %d",
@@ -1003,6 +2072,8 @@ static void s_aws_http_connection_manager_on_connection_shutdown(
     AWS_FATAL_ASSERT(manager->open_connection_count > 0);
     --manager->open_connection_count;
 
+    aws_hash_table_remove(&manager->connection_home_threads, connection, NULL, NULL);
+
     size_t connection_count = aws_array_list_length(&manager->connections);
 
     /*
@@ -1011,17 +2082,23 @@ static void s_aws_http_connection_manager_on_connection_shutdown(
     if (connection_count > 0) {
         AWS_ASSERT(manager->state == AWS_HCMST_READY);
 
-        struct aws_http_connection *last_connection = NULL;
-        AWS_FATAL_ASSERT(
-            aws_array_list_get_at(&manager->connections, &last_connection, connection_count - 1) == AWS_OP_SUCCESS);
-
         for (size_t i = 0; i < connection_count; ++i) {
-            struct aws_http_connection *current_connection = NULL;
-            aws_array_list_get_at(&manager->connections, &current_connection, i);
+            struct aws_idle_connection current_idle_connection;
+            AWS_ZERO_STRUCT(current_idle_connection);
+            aws_array_list_get_at(&manager->connections, &current_idle_connection, i);
 
-            if (current_connection == connection) {
+            if (current_idle_connection.connection == connection) {
                 should_release_connection = true;
-                aws_array_list_set_at(&manager->connections, &last_connection, i);
+                /*
+                 * Remove by shifting the entries behind it forward; this preserves the
+                 * oldest-first ordering that the cull task's front-of-list scan relies on.
+                 */
+                for (size_t j = i + 1; j < connection_count; ++j) {
+                    struct aws_idle_connection shifted_idle_connection;
+                    AWS_ZERO_STRUCT(shifted_idle_connection);
+                    aws_array_list_get_at(&manager->connections, &shifted_idle_connection, j);
+                    aws_array_list_set_at(&manager->connections, &shifted_idle_connection, j - 1);
+                }
                 break;
             }
         }
@@ -1032,9 +2109,576 @@ static void s_aws_http_connection_manager_on_connection_shutdown(
         }
     }
 
+    /*
+     * The connection may also be parked in a fast-path slot; a parked connection is still
+     * counted as vended, so stealing it here (under the lock) transfers the count out
+     */
+    if (!should_release_connection && s_aws_http_connection_manager_fast_pool_steal(manager, connection)) {
+        aws_atomic_fetch_sub(&manager->vended_connection_count, 1);
+        should_release_connection = true;
+        work.connection_to_release = connection;
+    }
+
+    s_aws_http_connection_manager_build_transaction(&work);
+
+    aws_mutex_unlock(&manager->lock);
+
+    s_aws_http_connection_manager_execute_transaction(&work);
+}
+
+/*
+ * Invoked by the http layer, on the connection's event-loop thread, when the peer signals it
+ * will accept no further requests (HTTP/2 GOAWAY, or an HTTP/1 response carrying
+ * "Connection: close").  If the connection is sitting idle in the pool, pull it out right away
+ * and open a replacement, so the next acquisition isn't handed a doomed connection and forced
+ * to eat a retry.  If it's currently vended, nothing to do here: the release path checks the
+ * draining flag and takes the same action then.
+ */
+static void s_aws_http_connection_manager_on_connection_draining(
+    struct aws_http_connection *connection,
+    void *user_data) {
+
+    struct aws_http_connection_manager *manager = user_data;
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_HTTP_CONNECTION_MANAGER,
+        "id=%p: Connection (id=%p) is draining, removing it from the pool",
+        (void *)manager,
+        (void *)connection);
+
+    bool removed_from_pool = false;
+
+    struct aws_connection_management_transaction work;
+    s_aws_connection_management_transaction_init(&work, manager);
+
+    aws_mutex_lock(&manager->lock);
+
+    /*
+     * The connection may be parked in a fast-path slot; reclaim everything so the scan
+     * below sees it.
+     */
+    s_aws_http_connection_manager_reclaim_parked_connections(manager);
+
+    const size_t connection_count = aws_array_list_length(&manager->connections);
+    for (size_t i = 0; i < connection_count; ++i) {
+        struct aws_idle_connection current_idle_connection;
+        AWS_ZERO_STRUCT(current_idle_connection);
+        aws_array_list_get_at(&manager->connections, &current_idle_connection, i);
+
+        if (current_idle_connection.connection == connection) {
+            removed_from_pool = true;
+            /*
+             * Remove by shifting the entries behind it forward; this preserves the
+             * oldest-first ordering that the cull task's front-of-list scan relies on.
+             */
+            for (size_t j = i + 1; j < connection_count; ++j) {
+                struct aws_idle_connection shifted_idle_connection;
+                AWS_ZERO_STRUCT(shifted_idle_connection);
+                aws_array_list_get_at(&manager->connections, &shifted_idle_connection, j);
+                aws_array_list_set_at(&manager->connections, &shifted_idle_connection, j - 1);
+            }
+            aws_array_list_pop_back(&manager->connections);
+            break;
+        }
+    }
+
     s_aws_http_connection_manager_build_transaction(&work);
 
+    if (removed_from_pool) {
+        work.connection_to_release = connection;
+        s_aws_http_connection_manager_schedule_replacement_connection(manager, &work);
+    }
+
     aws_mutex_unlock(&manager->lock);
 
     s_aws_http_connection_manager_execute_transaction(&work);
 }
+
+/**********************************************************************************************************************
+ * Host pool: per-host managers behind one global connection budget
+ *********************************************************************************************************************/
+
+enum {
+    AWS_HTTP_HOST_POOL_DEFAULT_MAX_HOSTS = 16,
+};
+
+/*
+ * One cached per-host manager.  vended_count counts vended connections plus in-flight
+ * acquisitions; a nonzero count pins the entry against eviction, since releasing a
+ * connection has to find its owning manager here.
+ */
+struct aws_http_host_pool_entry {
+    struct aws_string *key; /* "host:port", owned, doubles as the hash-table key */
+    struct aws_http_connection_manager *manager;
+    uint64_t last_acquire_timestamp;
+    size_t vended_count;
+};
+
+struct aws_http_host_pool {
+    struct aws_allocator *allocator;
+    struct aws_mutex lock;
+
+    /* Immutable after creation; configuration stamped onto every per-host manager */
+    struct aws_client_bootstrap *bootstrap;
+    size_t initial_window_size;
+    struct aws_socket_options socket_options;
+    struct aws_tls_connection_options *tls_template;
+    size_t max_hosts;
+    size_t per_host_max_connections;
+    uint64_t max_connection_idle_in_milliseconds;
+
+    /* Applied to each manager the pool creates; tests override it with mocks */
+    const struct aws_http_connection_manager_system_vtable *system_vtable;
+
+    /* aws_string* "host:port" -> aws_http_host_pool_entry* */
+    struct aws_hash_table entries;
+
+    /* aws_http_connection* -> aws_http_host_pool_entry*, so release can find the owner */
+    struct aws_hash_table connection_to_entry;
+
+    bool is_shutting_down;
+
+    /* Managers created by the pool whose asynchronous shutdown hasn't completed yet.
+     * The callback that drops this to zero during pool shutdown destroys the pool. */
+    size_t managers_outstanding;
+
+    void *shutdown_complete_user_data;
+    aws_http_connection_manager_shutdown_complete_fn *shutdown_complete_callback;
+};
+
+/* Pairs an in-flight acquisition with its entry so the setup callback can do bookkeeping */
+struct aws_http_host_pool_acquisition {
+    struct aws_http_host_pool *pool;
+    struct aws_http_host_pool_entry *entry;
+    aws_http_connection_manager_on_connection_setup_fn *callback;
+    void *user_data;
+};
+
+static void s_host_pool_destroy(struct aws_http_host_pool *pool) {
+    AWS_LOGF_INFO(AWS_LS_HTTP_CONNECTION_MANAGER, "id=%p: Host pool destroying self", (void *)pool);
+
+    aws_http_connection_manager_shutdown_complete_fn *shutdown_callback = pool->shutdown_complete_callback;
+    void *shutdown_user_data = pool->shutdown_complete_user_data;
+
+    aws_hash_table_clean_up(&pool->connection_to_entry);
+    aws_hash_table_clean_up(&pool->entries);
+    if (pool->tls_template) {
+        aws_tls_connection_options_clean_up(pool->tls_template);
+        aws_mem_release(pool->allocator, pool->tls_template);
+    }
+    aws_mutex_clean_up(&pool->lock);
+    aws_mem_release(pool->allocator, pool);
+
+    if (shutdown_callback) {
+        shutdown_callback(shutdown_user_data);
+    }
+}
+
+static void s_host_pool_on_manager_shutdown(void *user_data) {
+    struct aws_http_host_pool *pool = user_data;
+
+    aws_mutex_lock(&pool->lock);
+    AWS_FATAL_ASSERT(pool->managers_outstanding > 0);
+    --pool->managers_outstanding;
+    bool should_destroy = pool->is_shutting_down && pool->managers_outstanding == 0;
+    aws_mutex_unlock(&pool->lock);
+
+    if (should_destroy) {
+        s_host_pool_destroy(pool);
+    }
+}
+
+struct aws_http_host_pool *aws_http_host_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_http_host_pool_options *options) {
+
+    aws_http_fatal_assert_library_initialized();
+
+    if (!options || !options->socket_options || options->max_total_connections == 0) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    struct aws_http_host_pool *pool = aws_mem_calloc(allocator, 1, sizeof(struct aws_http_host_pool));
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pool->allocator = allocator;
+
+    if (aws_mutex_init(&pool->lock)) {
+        goto on_error;
+    }
+
+    pool->max_hosts = options->max_hosts ? options->max_hosts : AWS_HTTP_HOST_POOL_DEFAULT_MAX_HOSTS;
+    pool->per_host_max_connections = options->max_total_connections / pool->max_hosts;
+    if (pool->per_host_max_connections == 0) {
+        pool->per_host_max_connections = 1;
+    }
+
+    if (aws_hash_table_init(
+            &pool->entries, allocator, pool->max_hosts, aws_hash_string, aws_hash_callback_string_eq, NULL, NULL)) {
+        goto on_error;
+    }
+
+    if (aws_hash_table_init(
+            &pool->connection_to_entry,
+            allocator,
+            options->max_total_connections,
+            aws_hash_ptr,
+            aws_ptr_eq,
+            NULL,
+            NULL)) {
+        goto on_error;
+    }
+
+    if (options->tls_connection_options) {
+        pool->tls_template = aws_mem_calloc(allocator, 1, sizeof(struct aws_tls_connection_options));
+        if (pool->tls_template == NULL ||
+            aws_tls_connection_options_copy(pool->tls_template, options->tls_connection_options)) {
+            goto on_error;
+        }
+    }
+
+    pool->bootstrap = options->bootstrap;
+    pool->initial_window_size = options->initial_window_size;
+    pool->socket_options = *options->socket_options;
+    pool->max_connection_idle_in_milliseconds = options->max_connection_idle_in_milliseconds;
+    pool->system_vtable = NULL;
+    pool->shutdown_complete_callback = options->shutdown_complete_callback;
+    pool->shutdown_complete_user_data = options->shutdown_complete_user_data;
+
+    AWS_LOGF_INFO(
+        AWS_LS_HTTP_CONNECTION_MANAGER,
+        "id=%p: Successfully created host pool, %zu host slots of %zu connections each",
+        (void *)pool,
+        pool->max_hosts,
+        pool->per_host_max_connections);
+
+    return pool;
+
+on_error:
+
+    aws_hash_table_clean_up(&pool->connection_to_entry);
+    aws_hash_table_clean_up(&pool->entries);
+    if (pool->tls_template) {
+        aws_tls_connection_options_clean_up(pool->tls_template);
+        aws_mem_release(allocator, pool->tls_template);
+    }
+    aws_mutex_clean_up(&pool->lock);
+    aws_mem_release(allocator, pool);
+    return NULL;
+}
+
+void aws_http_host_pool_set_system_vtable(
+    struct aws_http_host_pool *pool,
+    const struct aws_http_connection_manager_system_vtable *system_vtable) {
+    AWS_FATAL_ASSERT(aws_http_connection_manager_system_vtable_is_valid(system_vtable));
+    pool->system_vtable = system_vtable;
+}
+
+static void s_host_pool_entry_destroy(struct aws_http_host_pool *pool, struct aws_http_host_pool_entry *entry) {
+    aws_string_destroy(entry->key);
+    aws_mem_release(pool->allocator, entry);
+}
+
+void aws_http_host_pool_release(struct aws_http_host_pool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    AWS_LOGF_INFO(AWS_LS_HTTP_CONNECTION_MANAGER, "id=%p: Host pool shutting down", (void *)pool);
+
+    struct aws_http_connection_manager *managers_to_release[AWS_HTTP_HOST_POOL_DEFAULT_MAX_HOSTS];
+    struct aws_http_connection_manager **managers = managers_to_release;
+    size_t num_managers = 0;
+
+    /* Releasing the last manager below can destroy the pool re-entrantly via the
+     * shutdown fan-in; don't touch pool after the release loop starts */
+    struct aws_allocator *allocator = pool->allocator;
+
+    aws_mutex_lock(&pool->lock);
+
+    if (pool->is_shutting_down) {
+        aws_mutex_unlock(&pool->lock);
+        return;
+    }
+    pool->is_shutting_down = true;
+
+    if (pool->max_hosts > AWS_ARRAY_SIZE(managers_to_release)) {
+        managers =
+            aws_mem_calloc(pool->allocator, pool->max_hosts, sizeof(struct aws_http_connection_manager *));
+        AWS_FATAL_ASSERT(managers != NULL);
+    }
+
+    for (struct aws_hash_iter iter = aws_hash_iter_begin(&pool->entries); !aws_hash_iter_done(&iter);
+         aws_hash_iter_next(&iter)) {
+        struct aws_http_host_pool_entry *entry = iter.element.value;
+        managers[num_managers++] = entry->manager;
+        s_host_pool_entry_destroy(pool, entry);
+    }
+    aws_hash_table_clear(&pool->entries);
+    aws_hash_table_clear(&pool->connection_to_entry);
+
+    bool should_destroy = pool->managers_outstanding == 0;
+
+    aws_mutex_unlock(&pool->lock);
+
+    if (should_destroy) {
+        s_host_pool_destroy(pool);
+    }
+
+    for (size_t i = 0; i < num_managers; ++i) {
+        aws_http_connection_manager_release(managers[i]);
+    }
+    if (managers != managers_to_release) {
+        aws_mem_release(allocator, managers);
+    }
+}
+
+static void s_host_pool_on_connection_setup(struct aws_http_connection *connection, int error_code, void *user_data) {
+    struct aws_http_host_pool_acquisition *acquisition = user_data;
+    struct aws_http_host_pool *pool = acquisition->pool;
+
+    aws_mutex_lock(&pool->lock);
+    if (connection != NULL) {
+        if (aws_hash_table_put(&pool->connection_to_entry, connection, acquisition->entry, NULL)) {
+            /* Can't track it, so release can't find the owner; hand it straight back instead */
+            --acquisition->entry->vended_count;
+            aws_mutex_unlock(&pool->lock);
+
+            error_code = aws_last_error();
+            aws_http_connection_manager_release_connection(acquisition->entry->manager, connection);
+            connection = NULL;
+            goto complete;
+        }
+    } else {
+        --acquisition->entry->vended_count;
+    }
+    aws_mutex_unlock(&pool->lock);
+
+complete:
+    acquisition->callback(connection, error_code, acquisition->user_data);
+    aws_mem_release(pool->allocator, acquisition);
+}
+
+/* Caller must hold the lock.  Returns the manager to release outside the lock, or NULL. */
+static struct aws_http_connection_manager *s_host_pool_evict_coldest_idle_entry(struct aws_http_host_pool *pool) {
+    struct aws_http_host_pool_entry *coldest = NULL;
+
+    for (struct aws_hash_iter iter = aws_hash_iter_begin(&pool->entries); !aws_hash_iter_done(&iter);
+         aws_hash_iter_next(&iter)) {
+        struct aws_http_host_pool_entry *entry = iter.element.value;
+        if (entry->vended_count > 0) {
+            continue;
+        }
+        if (coldest == NULL || entry->last_acquire_timestamp < coldest->last_acquire_timestamp) {
+            coldest = entry;
+        }
+    }
+
+    if (coldest == NULL) {
+        return NULL;
+    }
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_HTTP_CONNECTION_MANAGER,
+        "id=%p: Evicting cold host %s to make room",
+        (void *)pool,
+        aws_string_c_str(coldest->key));
+
+    struct aws_http_connection_manager *manager = coldest->manager;
+    aws_hash_table_remove(&pool->entries, coldest->key, NULL, NULL);
+    s_host_pool_entry_destroy(pool, coldest);
+    return manager;
+}
+
+/* Caller must hold the lock.  On success the entry takes ownership of key; on failure
+ * ownership stays with the caller. */
+static struct aws_http_host_pool_entry *s_host_pool_entry_new(
+    struct aws_http_host_pool *pool,
+    struct aws_string *key,
+    struct aws_byte_cursor host,
+    uint16_t port) {
+
+    struct aws_http_host_pool_entry *entry =
+        aws_mem_calloc(pool->allocator, 1, sizeof(struct aws_http_host_pool_entry));
+    if (entry == NULL) {
+        return NULL;
+    }
+    entry->key = key;
+
+    /* Per-host TLS: copy the template and point its server name at this host, so SNI and
+     * certificate validation match the host actually being connected to */
+    struct aws_tls_connection_options tls_options;
+    AWS_ZERO_STRUCT(tls_options);
+    bool have_tls_options = false;
+    if (pool->tls_template) {
+        if (aws_tls_connection_options_copy(&tls_options, pool->tls_template)) {
+            goto on_error;
+        }
+        if (aws_tls_connection_options_set_server_name(&tls_options, pool->allocator, &host)) {
+            aws_tls_connection_options_clean_up(&tls_options);
+            goto on_error;
+        }
+        have_tls_options = true;
+    }
+
+    struct aws_http_connection_manager_options manager_options = {
+        .bootstrap = pool->bootstrap,
+        .initial_window_size = pool->initial_window_size,
+        .socket_options = &pool->socket_options,
+        .tls_connection_options = have_tls_options ? &tls_options : NULL,
+        .host = host,
+        .port = port,
+        .max_connections = pool->per_host_max_connections,
+        .max_connection_idle_in_milliseconds = pool->max_connection_idle_in_milliseconds,
+        .shutdown_complete_callback = s_host_pool_on_manager_shutdown,
+        .shutdown_complete_user_data = pool,
+    };
+    entry->manager = aws_http_connection_manager_new(pool->allocator, &manager_options);
+    if (have_tls_options) {
+        aws_tls_connection_options_clean_up(&tls_options);
+    }
+    if (entry->manager == NULL) {
+        goto on_error;
+    }
+    if (pool->system_vtable) {
+        aws_http_connection_manager_set_system_vtable(entry->manager, pool->system_vtable);
+    }
+
+    if (aws_hash_table_put(&pool->entries, entry->key, entry, NULL)) {
+        aws_http_connection_manager_release(entry->manager);
+        /* The manager's shutdown callback will still fire; count it */
+        ++pool->managers_outstanding;
+        goto on_error;
+    }
+
+    ++pool->managers_outstanding;
+    return entry;
+
+on_error:
+    aws_mem_release(pool->allocator, entry);
+    return NULL;
+}
+
+void aws_http_host_pool_acquire_connection(
+    struct aws_http_host_pool *pool,
+    struct aws_byte_cursor host,
+    uint16_t port,
+    aws_http_connection_manager_on_connection_setup_fn *callback,
+    void *user_data) {
+
+    int error_code = AWS_ERROR_SUCCESS;
+    struct aws_http_connection_manager *manager_to_release = NULL;
+    struct aws_http_connection_manager *manager = NULL;
+
+    struct aws_http_host_pool_acquisition *acquisition =
+        aws_mem_calloc(pool->allocator, 1, sizeof(struct aws_http_host_pool_acquisition));
+    if (acquisition == NULL) {
+        callback(NULL, aws_last_error(), user_data);
+        return;
+    }
+    acquisition->pool = pool;
+    acquisition->callback = callback;
+    acquisition->user_data = user_data;
+
+    /* Build the "host:port" key outside the lock */
+    char key_storage[300];
+    int key_len = snprintf(key_storage, sizeof(key_storage), PRInSTR ":%u", AWS_BYTE_CURSOR_PRI(host), port);
+    struct aws_string *key = NULL;
+    if (key_len <= 0 || (size_t)key_len >= sizeof(key_storage)) {
+        error_code = AWS_ERROR_INVALID_ARGUMENT;
+        goto on_error;
+    }
+    key = aws_string_new_from_array(pool->allocator, (uint8_t *)key_storage, (size_t)key_len);
+    if (key == NULL) {
+        error_code = aws_last_error();
+        goto on_error;
+    }
+
+    aws_mutex_lock(&pool->lock);
+
+    if (pool->is_shutting_down) {
+        aws_mutex_unlock(&pool->lock);
+        error_code = AWS_ERROR_HTTP_CONNECTION_MANAGER_SHUTTING_DOWN;
+        goto on_error;
+    }
+
+    struct aws_hash_element *element = NULL;
+    aws_hash_table_find(&pool->entries, key, &element);
+    struct aws_http_host_pool_entry *entry = element ? element->value : NULL;
+
+    if (entry == NULL) {
+        if (aws_hash_table_get_entry_count(&pool->entries) >= pool->max_hosts) {
+            manager_to_release = s_host_pool_evict_coldest_idle_entry(pool);
+            if (manager_to_release == NULL) {
+                aws_mutex_unlock(&pool->lock);
+                error_code = AWS_ERROR_HTTP_HOST_POOL_BUDGET_EXCEEDED;
+                goto on_error;
+            }
+        }
+
+        entry = s_host_pool_entry_new(pool, key, host, port);
+        if (entry == NULL) {
+            aws_mutex_unlock(&pool->lock);
+            error_code = aws_last_error() ? aws_last_error() : AWS_ERROR_UNKNOWN;
+            goto on_error;
+        }
+        key = NULL; /* owned by the entry now */
+    } else {
+        aws_string_destroy(key);
+        key = NULL;
+    }
+
+    ++entry->vended_count;
+    aws_high_res_clock_get_ticks(&entry->last_acquire_timestamp);
+    acquisition->entry = entry;
+    manager = entry->manager;
+
+    aws_mutex_unlock(&pool->lock);
+
+    if (manager_to_release) {
+        aws_http_connection_manager_release(manager_to_release);
+    }
+
+    aws_http_connection_manager_acquire_connection(manager, s_host_pool_on_connection_setup, acquisition);
+    return;
+
+on_error:
+    if (key) {
+        aws_string_destroy(key);
+    }
+    if (manager_to_release) {
+        aws_http_connection_manager_release(manager_to_release);
+    }
+    aws_mem_release(pool->allocator, acquisition);
+    callback(NULL, error_code, user_data);
+}
+
+int aws_http_host_pool_release_connection(struct aws_http_host_pool *pool, struct aws_http_connection *connection) {
+    aws_mutex_lock(&pool->lock);
+
+    struct aws_hash_element *element = NULL;
+    aws_hash_table_find(&pool->connection_to_entry, connection, &element);
+    if (element == NULL) {
+        aws_mutex_unlock(&pool->lock);
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct aws_http_host_pool_entry *entry = element->value;
+    aws_hash_table_remove(&pool->connection_to_entry, connection, NULL, NULL);
+    AWS_FATAL_ASSERT(entry->vended_count > 0);
+    --entry->vended_count;
+
+    /* Pin the manager across the downstream call; an eviction on another thread could
+     * otherwise drop the pool's ref out from under us */
+    struct aws_http_connection_manager *manager = entry->manager;
+    aws_http_connection_manager_acquire(manager);
+
+    aws_mutex_unlock(&pool->lock);
+
+    int result = aws_http_connection_manager_release_connection(manager, connection);
+    aws_http_connection_manager_release(manager);
+    return result;
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/connection_monitor.h>
+
+#include <aws/http/private/connection_impl.h>
+
+#include <aws/common/clock.h>
+#include <aws/common/math.h>
+#include <aws/io/logging.h>
+
+/* Time between samples of the connection's byte counters. */
+static const uint64_t s_monitor_sample_interval_ns = AWS_TIMESTAMP_NANOS; /* 1 sec */
+
+bool aws_http_connection_monitoring_options_is_valid(const struct aws_http_connection_monitoring_options *options) {
+    return options && options->minimum_throughput_bytes_per_second > 0 &&
+           options->allowable_throughput_failure_interval_seconds > 0;
+}
+
+bool aws_http_connection_monitor_process_sample(
+    struct aws_http_connection_monitor *monitor,
+    uint64_t total_bytes,
+    uint64_t elapsed_ns,
+    bool transfer_active) {
+
+    const uint64_t bytes_this_interval = total_bytes - monitor->last_total_bytes;
+    monitor->last_total_bytes = total_bytes;
+
+    /* An idle connection moves no bytes, but it isn't stalled either. */
+    if (!transfer_active) {
+        monitor->consecutive_throughput_failures = 0;
+        return false;
+    }
+
+    /* How many bytes the minimum throughput demands over this interval. Saturate on overflow. */
+    uint64_t required_bytes = 0;
+    if (aws_mul_u64_checked(monitor->options.minimum_throughput_bytes_per_second, elapsed_ns, &required_bytes)) {
+        required_bytes = UINT64_MAX;
+    } else {
+        required_bytes /= AWS_TIMESTAMP_NANOS;
+    }
+
+    if (bytes_this_interval >= required_bytes) {
+        monitor->consecutive_throughput_failures = 0;
+        return false;
+    }
+
+    ++monitor->consecutive_throughput_failures;
+    return monitor->consecutive_throughput_failures >= monitor->options.allowable_throughput_failure_interval_seconds;
+}
+
+static void s_monitor_task(struct aws_channel_task *channel_task, void *arg, enum aws_task_status status) {
+    (void)channel_task;
+    struct aws_http_connection_monitor *monitor = arg;
+
+    /* Channel is shutting down, or connection already closed. The monitor's job is done. */
+    if (status != AWS_TASK_STATUS_RUN_READY || !aws_http_connection_is_open(monitor->connection)) {
+        aws_mem_release(monitor->alloc, monitor);
+        return;
+    }
+
+    struct aws_http_connection *connection = monitor->connection;
+    struct aws_channel *channel = connection->channel_slot->channel;
+
+    uint64_t now_ns = 0;
+    if (aws_channel_current_clock_time(channel, &now_ns)) {
+        AWS_LOGF_WARN(
+            AWS_LS_HTTP_CONNECTION,
+            "id=%p: Failed to read channel clock, error %d (%s). Throughput monitoring stopped.",
+            (void *)connection,
+            aws_last_error(),
+            aws_error_name(aws_last_error()));
+
+        aws_mem_release(monitor->alloc, monitor);
+        return;
+    }
+
+    const uint64_t total_bytes = connection->bytes_read + connection->bytes_written;
+    const uint64_t elapsed_ns = now_ns - monitor->last_sample_time_ns;
+    const bool transfer_active = connection->vtable->is_transfer_active(connection);
+    monitor->last_sample_time_ns = now_ns;
+
+    if (aws_http_connection_monitor_process_sample(monitor, total_bytes, elapsed_ns, transfer_active)) {
+        AWS_LOGF_WARN(
+            AWS_LS_HTTP_CONNECTION,
+            "id=%p: Throughput below %" PRIu32 " bytes/sec for %" PRIu32 " consecutive seconds. Closing connection.",
+            (void *)connection,
+            monitor->options.minimum_throughput_bytes_per_second,
+            monitor->options.allowable_throughput_failure_interval_seconds);
+
+        if (monitor->options.on_unhealthy) {
+            monitor->options.on_unhealthy(connection, monitor->options.on_unhealthy_user_data);
+        }
+
+        aws_http_connection_close(connection);
+        aws_mem_release(monitor->alloc, monitor);
+        return;
+    }
+
+    aws_channel_schedule_task_future(channel, &monitor->task, now_ns + s_monitor_sample_interval_ns);
+}
+
+struct aws_http_connection_monitor *aws_http_connection_monitor_new(
+    struct aws_allocator *alloc,
+    struct aws_http_connection *connection,
+    const struct aws_http_connection_monitoring_options *options) {
+
+    AWS_PRECONDITION(alloc);
+    AWS_PRECONDITION(connection);
+
+    if (!aws_http_connection_monitoring_options_is_valid(options)) {
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    struct aws_http_connection_monitor *monitor =
+        aws_mem_calloc(alloc, 1, sizeof(struct aws_http_connection_monitor));
+    if (!monitor) {
+        return NULL;
+    }
+
+    monitor->alloc = alloc;
+    monitor->connection = connection;
+    monitor->options = *options;
+    aws_channel_task_init(&monitor->task, s_monitor_task, monitor, "http_connection_monitor");
+
+    struct aws_channel *channel = connection->channel_slot->channel;
+
+    uint64_t now_ns = 0;
+    if (aws_channel_current_clock_time(channel, &now_ns)) {
+        goto error;
+    }
+
+    monitor->last_sample_time_ns = now_ns;
+    aws_channel_schedule_task_future(channel, &monitor->task, now_ns + s_monitor_sample_interval_ns);
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_HTTP_CONNECTION,
+        "id=%p: Throughput monitoring enabled: minimum %" PRIu32 " bytes/sec, failure interval %" PRIu32 " sec.",
+        (void *)connection,
+        options->minimum_throughput_bytes_per_second,
+        options->allowable_throughput_failure_interval_seconds);
+
+    return monitor;
+
+error:
+    aws_mem_release(alloc, monitor);
+    return NULL;
+}
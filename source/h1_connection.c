@@ -14,6 +14,7 @@
  */
 #include <aws/http/private/h1_connection.h>
 
+#include <aws/common/clock.h>
 #include <aws/common/math.h>
 #include <aws/common/mutex.h>
 #include <aws/common/string.h>
@@ -21,6 +22,7 @@
 #include <aws/http/private/h1_encoder.h>
 #include <aws/http/private/h1_stream.h>
 #include <aws/http/private/request_response_impl.h>
+#include <aws/http/private/tracing.h>
 #include <aws/io/logging.h>
 
 #if _MSC_VER
@@ -30,8 +32,23 @@
 enum {
     MESSAGE_SIZE_HINT = 16 * 1024,
     DECODER_INITIAL_SCRATCH_SIZE = 256,
+    /* Cap on one incoming request line when acting as a server, so an abusive client can't
+     * grow the decoder's scratch without bound. Far beyond any legitimate header line. */
+    DECODER_MAX_SCRATCH_SIZE_SERVER = 64 * 1024,
+    TIMEOUT_WHEEL_NUM_SLOTS = 32,
+    /* Bounds for adaptive window mode. The window starts at the initial size and is re-sized
+     * between the floor and initial_window_size as the app's consumption rate is measured. */
+    ADAPTIVE_WINDOW_MIN_SIZE = 16 * 1024,
+    ADAPTIVE_WINDOW_INITIAL_SIZE = 256 * 1024,
 };
 
+/* Granularity of the response-timeout timing wheel (and of the task that drives it). */
+static const uint64_t s_timeout_wheel_tick_ns = 250000000; /* 250ms */
+
+/* When coalescing is enabled and pending off-thread window updates haven't reached the threshold,
+ * flush them after this long anyway, so the effective window never stays shrunk indefinitely. */
+static const uint64_t s_window_update_coalescing_deadline_ns = 1000000; /* 1ms */
+
 static int s_handler_process_read_message(
     struct aws_channel_handler *handler,
     struct aws_channel_slot *slot,
@@ -66,6 +83,9 @@ static int s_stream_send_response(struct aws_http_stream *stream, struct aws_htt
 static void s_connection_close(struct aws_http_connection *connection_base);
 static bool s_connection_is_open(const struct aws_http_connection *connection_base);
 static void s_connection_update_window(struct aws_http_connection *connection_base, size_t increment_size);
+static bool s_connection_is_transfer_active(const struct aws_http_connection *connection_base);
+static int s_connection_convert_to_midchannel_handler(struct aws_http_connection *connection_base);
+static int s_connection_switch_protocols(struct h1_connection *connection);
 static int s_decoder_on_request(
     enum aws_http_method method_enum,
     const struct aws_byte_cursor *method_str,
@@ -75,6 +95,7 @@ static int s_decoder_on_response(int status_code, void *user_data);
 static int s_decoder_on_header(const struct aws_http_decoded_header *header, void *user_data);
 static int s_decoder_on_body(const struct aws_byte_cursor *data, bool finished, void *user_data);
 static int s_decoder_on_done(void *user_data);
+static void s_client_resume_outgoing_stream_task(struct h1_connection *connection);
 
 static struct aws_http_connection_vtable s_h1_connection_vtable = {
     .channel_handler_vtable =
@@ -94,6 +115,8 @@ static struct aws_http_connection_vtable s_h1_connection_vtable = {
     .close = s_connection_close,
     .is_open = s_connection_is_open,
     .update_window = s_connection_update_window,
+    .is_transfer_active = s_connection_is_transfer_active,
+    .convert_to_midchannel_handler = s_connection_convert_to_midchannel_handler,
 };
 
 static const struct aws_http_decoder_vtable s_h1_decoder_vtable = {
@@ -113,6 +136,35 @@ struct h1_connection {
     /* Single task used for issuing window updates from off-thread */
     struct aws_channel_task window_update_task;
 
+    /* Single task that moves newly made request streams from new_stream_queue to
+     * synced_data.pending_stream_list. Client-only. */
+    struct aws_channel_task new_stream_drain_task;
+
+    /* Single task that drives the timeout_wheel. Only scheduled while timers are armed. */
+    struct aws_channel_task timeout_wheel_task;
+
+    /* Client-only. Immutable after creation.
+     * If non-zero, max number of fully-sent requests that may be awaiting their responses
+     * before the outgoing stream task stops starting new requests.
+     * If zero, there is no limit. */
+    size_t max_pipelined_requests;
+
+    /* Immutable after creation.
+     * If non-zero, off-thread window updates accumulate until the pending amount reaches
+     * this size (or a brief deadline passes) before the window_update_task is scheduled.
+     * If zero, the task is scheduled by the first update. */
+    size_t window_update_threshold;
+
+    /* Immutable after creation.
+     * Preferred size (including channel overhead) of the aws_io_messages written to the channel.
+     * If zero, MESSAGE_SIZE_HINT is used. */
+    size_t preferred_write_message_size;
+
+    /* Client-only. Immutable after creation.
+     * If true, the read window is sized to the app's measured consumption rate instead of
+     * being held at initial_window_size. See thread_data.adaptive. */
+    bool adaptive_window_management;
+
     /* Only the event-loop thread may touch this data */
     struct {
         /* List of streams being worked on. */
@@ -134,6 +186,10 @@ struct h1_connection {
         /* Used to encode requests and responses */
         struct aws_h1_encoder encoder;
 
+        /* A message the outgoing stream task acquired but had no data for.
+         * Kept warm so the next run doesn't bounce it off the channel's pool. */
+        struct aws_io_message *cached_outgoing_message;
+
         /* Amount to let read-window shrink after a channel message has been processed. */
         size_t incoming_message_window_shrink_size;
 
@@ -152,8 +208,55 @@ struct h1_connection {
 
         /* Server-only. Request-handler streams can only be created while this is true. */
         bool can_create_request_handler_stream;
+
+        /* Hashed timing wheel holding the response-deadline timers of this connection's streams. */
+        struct aws_http_timing_wheel timeout_wheel;
+
+        /* True while timeout_wheel_task is scheduled. */
+        bool is_timeout_wheel_task_scheduled;
+
+        /* Adaptive window mode (see aws_http_client_connection_options.adaptive_window_management).
+         * The target window is the consumption rate times the consumption delay (a
+         * bandwidth-delay product, doubled for headroom). Both factors are smoothed, and the
+         * target only moves on a 25% change, so it doesn't chase per-chunk noise. */
+        struct {
+            /* When body bytes were last delivered with no delay sample armed. 0 = no sample armed. */
+            uint64_t last_delivery_timestamp_ns;
+
+            /* Smoothed delivery-to-window-credit delay: how long the app sits on received data. */
+            uint64_t smoothed_delay_ns;
+
+            /* When the previous window credit arrived, for rate measurement. */
+            uint64_t last_credit_timestamp_ns;
+
+            /* Smoothed rate at which the app credits the window back. */
+            uint64_t smoothed_bytes_per_sec;
+
+            /* Window size currently applied to the channel. */
+            size_t window_target;
+
+            /* Credits withheld so the channel window drains down to a reduced target. */
+            size_t shrink_debt;
+        } adaptive;
     } thread_data;
 
+    /* Cross-thread new-stream queue (client only). aws_http_connection_make_request() pushes
+     * with lock-free atomic ops and the drain task moves the whole batch to
+     * synced_data.pending_stream_list per wake-up, so producer threads submitting bursts of
+     * requests cost one task-queue insertion, not one per request. */
+    struct {
+        /* Head of an intrusive MPSC stack (struct aws_h1_stream *), most-recently-pushed first.
+         * The drain task exchanges it for NULL and reverses the chain into submission order. */
+        struct aws_atomic_var head;
+
+        /* bool: whether new_stream_drain_task is scheduled */
+        struct aws_atomic_var is_drain_task_scheduled;
+
+        /* int: AWS_ERROR_SUCCESS while streams may be made; once non-zero, the reason new
+         * streams are rejected (ex: closing, switched protocols) */
+        struct aws_atomic_var new_stream_error_code;
+    } new_stream_queue;
+
     /* Any thread may touch this data, but the lock must be held */
     struct {
         struct aws_mutex lock;
@@ -166,11 +269,11 @@ struct h1_connection {
         /* For checking status from outside the event-loop thread. */
         bool is_open;
 
-        /* If non-zero, reason to immediately reject new streams. (ex: closing, switched protocols) */
-        int new_stream_error_code;
-
-        /* If non-zero, then window_update_task is scheduled */
+        /* Off-thread window updates accumulated here until window_update_task applies them */
         size_t window_update_size;
+
+        /* True while window_update_task is scheduled */
+        bool is_window_update_task_scheduled;
     } synced_data;
 };
 
@@ -212,14 +315,13 @@ static void s_stop(
         AWS_ASSERT(aws_channel_thread_is_callers_thread(connection->base.channel_slot->channel));
         connection->thread_data.is_writing_stopped = true;
     }
+    /* Even if we're not scheduling shutdown just yet (ex: sent final request but waiting to read final response)
+     * we don't consider the connection "open" anymore so user can't create more streams */
+    aws_atomic_store_int(&connection->new_stream_queue.new_stream_error_code, AWS_ERROR_HTTP_CONNECTION_CLOSED);
+
     { /* BEGIN CRITICAL SECTION */
         s_h1_connection_lock_synced_data(connection);
-
-        /* Even if we're not scheduling shutdown just yet (ex: sent final request but waiting to read final response)
-         * we don't consider the connection "open" anymore so user can't create more streams */
-        connection->synced_data.new_stream_error_code = AWS_ERROR_HTTP_CONNECTION_CLOSED;
         connection->synced_data.is_open = false;
-
         s_h1_connection_unlock_synced_data(connection);
     } /* END CRITICAL SECTION */
 
@@ -275,6 +377,55 @@ static bool s_connection_is_open(const struct aws_http_connection *connection_ba
     return is_open;
 }
 
+/* Queried by the connection monitor, on the channel thread, to tell a stalled transfer from an idle connection. */
+static bool s_connection_is_transfer_active(const struct aws_http_connection *connection_base) {
+    struct h1_connection *connection = AWS_CONTAINER_OF(connection_base, struct h1_connection, base);
+    AWS_ASSERT(aws_channel_thread_is_callers_thread(connection_base->channel_slot->channel));
+
+    return !aws_linked_list_empty(&connection->thread_data.stream_list);
+}
+
+/* Public function (via vtable) for deliberately entering passthrough mode, for tunnels
+ * negotiated by means other than a client stream completing with a 101 response
+ * (ex: a CONNECT tunnel established through a proxy, or a server-side upgrade). */
+static int s_connection_convert_to_midchannel_handler(struct aws_http_connection *connection_base) {
+    struct h1_connection *connection = AWS_CONTAINER_OF(connection_base, struct h1_connection, base);
+
+    if (!aws_channel_thread_is_callers_thread(connection_base->channel_slot->channel)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_CONNECTION,
+            "id=%p: Cannot convert to midchannel handler on this thread.",
+            (void *)connection_base);
+        return aws_raise_error(AWS_ERROR_IO_EVENT_LOOP_THREAD_ONLY);
+    }
+
+    if (connection->thread_data.has_switched_protocols) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_CONNECTION,
+            "id=%p: Connection has already converted to midchannel handler.",
+            (void *)connection_base);
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    if (connection->thread_data.is_reading_stopped || connection->thread_data.is_writing_stopped) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_CONNECTION,
+            "id=%p: Cannot convert to midchannel handler because connection is closed or closing.",
+            (void *)connection_base);
+        return aws_raise_error(AWS_ERROR_HTTP_CONNECTION_CLOSED);
+    }
+
+    if (connection->thread_data.incoming_stream) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_CONNECTION,
+            "id=%p: Cannot convert to midchannel handler in the middle of an incoming message.",
+            (void *)connection_base);
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    return s_connection_switch_protocols(connection);
+}
+
 static int s_stream_send_response(struct aws_http_stream *stream, struct aws_http_message *response) {
     AWS_PRECONDITION(stream);
     AWS_PRECONDITION(response);
@@ -342,7 +493,97 @@ response_error:
     return AWS_OP_ERR;
 }
 
+/* Adaptive window mode: take a measurement from this credit, re-derive the target window size,
+ * and return the credit to actually apply (grown toward a larger target, or partially withheld
+ * so the channel window drains down to a smaller one). Runs on the event-loop thread. */
+static size_t s_adaptive_window_shape_credit(struct h1_connection *connection, size_t increment_size) {
+    struct h1_connection *c = connection;
+
+    uint64_t now_ns = 0;
+    if (aws_channel_current_clock_time(c->base.channel_slot->channel, &now_ns)) {
+        /* No clock, no measurement. Pass the credit through unchanged. */
+        return increment_size;
+    }
+
+    /* Delay sample: time from body delivery to the app crediting the window back. */
+    if (c->thread_data.adaptive.last_delivery_timestamp_ns &&
+        now_ns > c->thread_data.adaptive.last_delivery_timestamp_ns) {
+
+        uint64_t delay_ns = now_ns - c->thread_data.adaptive.last_delivery_timestamp_ns;
+        uint64_t smoothed = c->thread_data.adaptive.smoothed_delay_ns;
+        c->thread_data.adaptive.smoothed_delay_ns = smoothed ? (smoothed * 7 + delay_ns) / 8 : delay_ns;
+        c->thread_data.adaptive.last_delivery_timestamp_ns = 0;
+    }
+
+    /* Rate sample: bytes credited since the previous credit. */
+    if (c->thread_data.adaptive.last_credit_timestamp_ns && now_ns > c->thread_data.adaptive.last_credit_timestamp_ns) {
+        uint64_t elapsed_ns = now_ns - c->thread_data.adaptive.last_credit_timestamp_ns;
+        uint64_t rate = aws_mul_u64_saturating((uint64_t)increment_size, AWS_TIMESTAMP_NANOS) / elapsed_ns;
+        uint64_t smoothed = c->thread_data.adaptive.smoothed_bytes_per_sec;
+        c->thread_data.adaptive.smoothed_bytes_per_sec = smoothed ? (smoothed * 7 + rate) / 8 : rate;
+    }
+    c->thread_data.adaptive.last_credit_timestamp_ns = now_ns;
+
+    if (c->thread_data.adaptive.smoothed_bytes_per_sec && c->thread_data.adaptive.smoothed_delay_ns) {
+        /* Bandwidth-delay product, doubled for headroom, clamped to [floor, initial_window_size]. */
+        uint64_t desired64 = aws_mul_u64_saturating(
+                                 c->thread_data.adaptive.smoothed_bytes_per_sec,
+                                 c->thread_data.adaptive.smoothed_delay_ns) /
+                             AWS_TIMESTAMP_NANOS;
+        desired64 = aws_mul_u64_saturating(desired64, 2);
+
+        size_t desired = (size_t)aws_min_u64(desired64, SIZE_MAX);
+        desired = aws_max_size(desired, ADAPTIVE_WINDOW_MIN_SIZE);
+        desired = aws_min_size(desired, c->base.initial_window_size);
+
+        size_t target = c->thread_data.adaptive.window_target;
+        if (desired > target + target / 4) {
+            /* Grow: any growth first cancels debt; the rest rides along with this credit. */
+            size_t grow = desired - target;
+            if (grow <= c->thread_data.adaptive.shrink_debt) {
+                c->thread_data.adaptive.shrink_debt -= grow;
+            } else {
+                increment_size = aws_add_size_saturating(increment_size, grow - c->thread_data.adaptive.shrink_debt);
+                c->thread_data.adaptive.shrink_debt = 0;
+            }
+            c->thread_data.adaptive.window_target = desired;
+
+            AWS_LOGF_TRACE(
+                AWS_LS_HTTP_CONNECTION,
+                "id=%p: Adaptive window grew to %zu.",
+                (void *)&c->base,
+                c->thread_data.adaptive.window_target);
+        } else if (desired < target - target / 4) {
+            c->thread_data.adaptive.shrink_debt =
+                aws_add_size_saturating(c->thread_data.adaptive.shrink_debt, target - desired);
+            c->thread_data.adaptive.window_target = desired;
+
+            AWS_LOGF_TRACE(
+                AWS_LS_HTTP_CONNECTION,
+                "id=%p: Adaptive window shrank to %zu.",
+                (void *)&c->base,
+                c->thread_data.adaptive.window_target);
+        }
+    }
+
+    /* Pay down debt by withholding credit. */
+    if (c->thread_data.adaptive.shrink_debt) {
+        size_t pay = aws_min_size(c->thread_data.adaptive.shrink_debt, increment_size);
+        c->thread_data.adaptive.shrink_debt -= pay;
+        increment_size -= pay;
+    }
+
+    return increment_size;
+}
+
 static void s_update_window_action(struct h1_connection *connection, size_t increment_size) {
+    if (connection->adaptive_window_management) {
+        increment_size = s_adaptive_window_shape_credit(connection, increment_size);
+        if (increment_size == 0) {
+            return;
+        }
+    }
+
     int err = aws_channel_slot_increment_read_window(connection->base.channel_slot, increment_size);
     if (err) {
         AWS_LOGF_ERROR(
@@ -375,22 +616,31 @@ static void s_connection_update_window(struct aws_http_connection *connection_ba
         return;
     }
 
-    /* Otherwise, schedule a task to do it.
-     * If task is already scheduled, just increase size to be updated */
+    /* Otherwise, accumulate the increment and schedule a task to apply it.
+     * If a task is already scheduled, or the pending amount is still below the coalescing
+     * threshold, no immediate task is needed; the pending update rides along with a later one. */
 
     /* BEGIN CRITICAL SECTION */
     s_h1_connection_lock_synced_data(connection);
 
-    /* if this is not volatile, gcc-4x will load window_update_size's address into a register
-     * and then read it as should_schedule_task down below, which will invert its meaning */
-    volatile bool should_schedule_task = (connection->synced_data.window_update_size == 0);
     connection->synced_data.window_update_size =
         aws_add_size_saturating(connection->synced_data.window_update_size, increment_size);
 
+    bool schedule_now = false;
+    bool schedule_at_deadline = false;
+    if (!connection->synced_data.is_window_update_task_scheduled) {
+        if (connection->synced_data.window_update_size >= connection->window_update_threshold) {
+            schedule_now = true;
+        } else {
+            schedule_at_deadline = true;
+        }
+        connection->synced_data.is_window_update_task_scheduled = true;
+    }
+
     s_h1_connection_unlock_synced_data(connection);
     /* END CRITICAL SECTION */
 
-    if (should_schedule_task) {
+    if (schedule_now) {
         AWS_LOGF_TRACE(
             AWS_LS_HTTP_CONNECTION,
             "id=%p: Scheduling task for window update of %zu.",
@@ -398,10 +648,28 @@ static void s_connection_update_window(struct aws_http_connection *connection_ba
             increment_size);
 
         aws_channel_schedule_task_now(connection->base.channel_slot->channel, &connection->window_update_task);
+    } else if (schedule_at_deadline) {
+        /* Below the coalescing threshold. Schedule the task for slightly later, so that further
+         * updates accumulate into it, but the window never stays shrunk for long. */
+        uint64_t now_ns = 0;
+        if (aws_channel_current_clock_time(connection->base.channel_slot->channel, &now_ns)) {
+            aws_channel_schedule_task_now(connection->base.channel_slot->channel, &connection->window_update_task);
+        } else {
+            AWS_LOGF_TRACE(
+                AWS_LS_HTTP_CONNECTION,
+                "id=%p: Scheduling deadline task for coalesced window update of %zu.",
+                (void *)&connection->base,
+                increment_size);
+
+            aws_channel_schedule_task_future(
+                connection->base.channel_slot->channel,
+                &connection->window_update_task,
+                now_ns + s_window_update_coalescing_deadline_ns);
+        }
     } else {
         AWS_LOGF_TRACE(
             AWS_LS_HTTP_CONNECTION,
-            "id=%p: Window update must already scheduled, increased scheduled size by %zu.",
+            "id=%p: Window update already scheduled, increased scheduled size by %zu.",
             (void *)&connection->base,
             increment_size);
     }
@@ -424,26 +692,7 @@ struct aws_http_stream *s_make_request(
 
     struct h1_connection *connection = AWS_CONTAINER_OF(client_connection, struct h1_connection, base);
 
-    /* Insert new stream into pending list, and schedule outgoing_stream_task if it's not already running. */
-    int new_stream_error_code = AWS_ERROR_SUCCESS;
-    bool should_schedule_task = false;
-
-    { /* BEGIN CRITICAL SECTION */
-        s_h1_connection_lock_synced_data(connection);
-
-        if (connection->synced_data.new_stream_error_code) {
-            new_stream_error_code = connection->synced_data.new_stream_error_code;
-        } else {
-            aws_linked_list_push_back(&connection->synced_data.pending_stream_list, &stream->node);
-            if (!connection->synced_data.is_outgoing_stream_task_active) {
-                connection->synced_data.is_outgoing_stream_task_active = true;
-                should_schedule_task = true;
-            }
-        }
-
-        s_h1_connection_unlock_synced_data(connection);
-    } /* END CRITICAL SECTION */
-
+    const int new_stream_error_code = (int)aws_atomic_load_int(&connection->new_stream_queue.new_stream_error_code);
     if (new_stream_error_code) {
         AWS_LOGF_ERROR(
             AWS_LS_HTTP_CONNECTION,
@@ -471,9 +720,18 @@ struct aws_http_stream *s_make_request(
         AWS_BYTE_CURSOR_PRI(path),
         AWS_BYTE_CURSOR_PRI(aws_http_version_to_str(connection->base.http_version)));
 
-    if (should_schedule_task) {
-        AWS_LOGF_TRACE(AWS_LS_HTTP_CONNECTION, "id=%p: Scheduling outgoing stream task.", (void *)&connection->base);
-        aws_channel_schedule_task_now(connection->base.channel_slot->channel, &connection->outgoing_stream_task);
+    /* Lock-free push onto the new-stream queue. If the connection closed between the check
+     * above and this push, the drain task still runs (even canceled during channel shutdown)
+     * and completes the stream with an error. The queue owns the stream once the push lands,
+     * so don't touch it past this point. */
+    void *expected_head = aws_atomic_load_ptr(&connection->new_stream_queue.head);
+    do {
+        stream->new_stream_next = expected_head;
+    } while (!aws_atomic_compare_exchange_ptr(&connection->new_stream_queue.head, &expected_head, stream));
+
+    if (aws_atomic_exchange_int(&connection->new_stream_queue.is_drain_task_scheduled, 1) == 0) {
+        AWS_LOGF_TRACE(AWS_LS_HTTP_CONNECTION, "id=%p: Scheduling new stream drain task.", (void *)&connection->base);
+        aws_channel_schedule_task_now(connection->base.channel_slot->channel, &connection->new_stream_drain_task);
     }
 
     return &stream->base;
@@ -502,6 +760,7 @@ static void s_update_window_task(struct aws_channel_task *channel_task, void *ar
         (void *)&connection->base,
         window_update_size);
     connection->synced_data.window_update_size = 0;
+    connection->synced_data.is_window_update_task_scheduled = false;
 
     s_h1_connection_unlock_synced_data(connection);
     /* END CRITICAL SECTION */
@@ -509,9 +768,187 @@ static void s_update_window_task(struct aws_channel_task *channel_task, void *ar
     s_update_window_action(connection, window_update_size);
 }
 
+static void s_stream_first_byte_timeout(struct aws_http_timing_wheel_timer *timer, void *user_data) {
+    (void)timer;
+    struct aws_h1_stream *stream = user_data;
+    struct h1_connection *connection = AWS_CONTAINER_OF(stream->base.owning_connection, struct h1_connection, base);
+
+    AWS_LOGF_ERROR(
+        AWS_LS_HTTP_STREAM,
+        "id=%p: First byte of response did not arrive within %" PRIu64 "ms. Closing connection.",
+        (void *)&stream->base,
+        stream->response_first_byte_timeout_ms);
+
+    s_shutdown_due_to_error(connection, AWS_ERROR_HTTP_STREAM_TIMEOUT);
+}
+
+static void s_stream_response_timeout(struct aws_http_timing_wheel_timer *timer, void *user_data) {
+    (void)timer;
+    struct aws_h1_stream *stream = user_data;
+    struct h1_connection *connection = AWS_CONTAINER_OF(stream->base.owning_connection, struct h1_connection, base);
+
+    AWS_LOGF_ERROR(
+        AWS_LS_HTTP_STREAM,
+        "id=%p: Response did not complete within %" PRIu64 "ms. Closing connection.",
+        (void *)&stream->base,
+        stream->response_timeout_ms);
+
+    s_shutdown_due_to_error(connection, AWS_ERROR_HTTP_STREAM_TIMEOUT);
+}
+
+static void s_stream_continue_timeout(struct aws_http_timing_wheel_timer *timer, void *user_data) {
+    (void)timer;
+    struct aws_h1_stream *stream = user_data;
+    struct h1_connection *connection = AWS_CONTAINER_OF(stream->base.owning_connection, struct h1_connection, base);
+
+    /* The timer is only armed while the encoder is withholding this stream's body,
+     * and it's canceled when any response arrives or the stream completes. */
+    AWS_ASSERT(connection->thread_data.outgoing_stream == stream);
+    AWS_ASSERT(aws_h1_encoder_is_waiting_for_continue(&connection->thread_data.encoder));
+
+    AWS_LOGF_WARN(
+        AWS_LS_HTTP_STREAM,
+        "id=%p: No response to 'Expect: 100-continue' within %" PRIu64 "ms, sending request body anyway.",
+        (void *)&stream->base,
+        stream->expect_100_continue_timeout_ms);
+
+    aws_h1_encoder_continue_message(&connection->thread_data.encoder);
+    s_client_resume_outgoing_stream_task(connection);
+}
+
+static void s_timeout_wheel_task(struct aws_channel_task *channel_task, void *arg, enum aws_task_status status) {
+    (void)channel_task;
+    struct h1_connection *connection = arg;
+
+    if (status != AWS_TASK_STATUS_RUN_READY) {
+        return;
+    }
+
+    uint64_t now_ns = 0;
+    if (aws_channel_current_clock_time(connection->base.channel_slot->channel, &now_ns)) {
+        connection->thread_data.is_timeout_wheel_task_scheduled = false;
+        return;
+    }
+
+    aws_http_timing_wheel_run(&connection->thread_data.timeout_wheel, now_ns);
+
+    if (connection->thread_data.timeout_wheel.armed_count > 0) {
+        aws_channel_schedule_task_future(
+            connection->base.channel_slot->channel, &connection->timeout_wheel_task, now_ns + s_timeout_wheel_tick_ns);
+    } else {
+        connection->thread_data.is_timeout_wheel_task_scheduled = false;
+    }
+}
+
+/* Arm a client stream's response deadlines as its request begins to send.
+ * Called on the channel thread. */
+static void s_stream_arm_response_timeouts(struct h1_connection *connection, struct aws_h1_stream *stream) {
+    if (!stream->response_first_byte_timeout_ms && !stream->response_timeout_ms) {
+        return;
+    }
+
+    uint64_t now_ns = 0;
+    if (aws_channel_current_clock_time(connection->base.channel_slot->channel, &now_ns)) {
+        AWS_LOGF_WARN(
+            AWS_LS_HTTP_STREAM,
+            "id=%p: Failed to read channel clock, error %d (%s). Response timeouts not armed.",
+            (void *)&stream->base,
+            aws_last_error(),
+            aws_error_name(aws_last_error()));
+        return;
+    }
+
+    struct aws_http_timing_wheel *wheel = &connection->thread_data.timeout_wheel;
+
+    if (stream->response_first_byte_timeout_ms) {
+        const uint64_t timeout_ns = aws_timestamp_convert(
+            stream->response_first_byte_timeout_ms, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
+        aws_http_timing_wheel_arm(
+            wheel, &stream->first_byte_timer, now_ns + timeout_ns, s_stream_first_byte_timeout, stream);
+    }
+
+    if (stream->response_timeout_ms) {
+        const uint64_t timeout_ns =
+            aws_timestamp_convert(stream->response_timeout_ms, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
+        aws_http_timing_wheel_arm(
+            wheel, &stream->response_timer, now_ns + timeout_ns, s_stream_response_timeout, stream);
+    }
+
+    if (!connection->thread_data.is_timeout_wheel_task_scheduled) {
+        connection->thread_data.is_timeout_wheel_task_scheduled = true;
+        aws_channel_schedule_task_future(
+            connection->base.channel_slot->channel, &connection->timeout_wheel_task, now_ns + s_timeout_wheel_tick_ns);
+    }
+}
+
+/* Record a metric timestamp the first time its transition happens.
+ * Called on the channel thread.  A clock failure just leaves the metric unset. */
+static void s_stream_record_metric_timestamp(struct h1_connection *connection, uint64_t *out_timestamp) {
+    if (*out_timestamp != 0) {
+        return;
+    }
+
+    uint64_t now_ns = 0;
+    if (aws_channel_current_clock_time(connection->base.channel_slot->channel, &now_ns) == AWS_OP_SUCCESS) {
+        *out_timestamp = now_ns;
+    }
+}
+
+/* Take the connection out of HTTP service: no further streams may be created, and raw
+ * aws_io_messages are forwarded in both directions between the neighboring channel handlers.
+ * Fails if any stream is in progress or pending. */
+static int s_connection_switch_protocols(struct h1_connection *connection) {
+    AWS_ASSERT(aws_channel_thread_is_callers_thread(connection->base.channel_slot->channel));
+
+    /* Switching protocols while there are pending streams is too complex to deal with. */
+    bool has_pending_streams = false;
+    if (!aws_linked_list_empty(&connection->thread_data.stream_list) ||
+        aws_atomic_load_ptr(&connection->new_stream_queue.head) != NULL) {
+        has_pending_streams = true;
+    } else {
+        { /* BEGIN CRITICAL SECTION */
+            s_h1_connection_lock_synced_data(connection);
+
+            if (aws_linked_list_empty(&connection->synced_data.pending_stream_list)) {
+                aws_atomic_store_int(
+                    &connection->new_stream_queue.new_stream_error_code, AWS_ERROR_HTTP_SWITCHED_PROTOCOLS);
+            } else {
+                has_pending_streams = true;
+            }
+
+            s_h1_connection_unlock_synced_data(connection);
+        } /* END CRITICAL SECTION */
+    }
+
+    if (has_pending_streams) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_CONNECTION,
+            "id=%p: Cannot switch protocols while streams are pending.",
+            (void *)&connection->base);
+
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    AWS_LOGF_TRACE(
+        AWS_LS_HTTP_CONNECTION,
+        "id=%p: Connection has switched protocols, another channel handler must be installed to"
+        " deal with further data.",
+        (void *)&connection->base);
+
+    connection->thread_data.has_switched_protocols = true;
+    return AWS_OP_SUCCESS;
+}
+
 static void s_stream_complete(struct aws_h1_stream *stream, int error_code) {
     struct h1_connection *connection = AWS_CONTAINER_OF(stream->base.owning_connection, struct h1_connection, base);
 
+    s_stream_record_metric_timestamp(connection, &stream->base.metrics.complete_timestamp_ns);
+
+    /* The stream is done; its response deadlines no longer apply. */
+    aws_http_timing_wheel_cancel(&connection->thread_data.timeout_wheel, &stream->first_byte_timer);
+    aws_http_timing_wheel_cancel(&connection->thread_data.timeout_wheel, &stream->response_timer);
+    aws_http_timing_wheel_cancel(&connection->thread_data.timeout_wheel, &stream->continue_timer);
+
     /* Remove stream from list. */
     aws_linked_list_remove(&stream->node);
 
@@ -526,40 +963,14 @@ static void s_stream_complete(struct aws_h1_stream *stream, int error_code) {
             stream->base.client_data->response_status == AWS_HTTP_STATUS_101_SWITCHING_PROTOCOLS) {
             /* TODO: confirm that request had sent "Connection: Upgrade" header */
 
-            /* Switching protocols while there are pending streams is too complex to deal with. */
-            bool has_pending_streams = false;
-            if (!aws_linked_list_empty(&connection->thread_data.stream_list)) {
-                has_pending_streams = true;
-            } else {
-                { /* BEGIN CRITICAL SECTION */
-                    s_h1_connection_lock_synced_data(connection);
-
-                    if (aws_linked_list_empty(&connection->synced_data.pending_stream_list)) {
-                        connection->synced_data.new_stream_error_code = AWS_ERROR_HTTP_SWITCHED_PROTOCOLS;
-                    } else {
-                        has_pending_streams = true;
-                    }
-
-                    s_h1_connection_unlock_synced_data(connection);
-                } /* END CRITICAL SECTION */
-            }
-
-            if (has_pending_streams) {
+            if (s_connection_switch_protocols(connection)) {
                 AWS_LOGF_ERROR(
                     AWS_LS_HTTP_CONNECTION,
-                    "id=%p: Cannot switch protocols while streams are pending, closing connection.",
+                    "id=%p: Failed to switch protocols, closing connection.",
                     (void *)&connection->base);
 
                 error_code = AWS_ERROR_INVALID_STATE;
                 goto finish_up;
-            } else {
-                AWS_LOGF_TRACE(
-                    AWS_LS_HTTP_CONNECTION,
-                    "id=%p: Connection has switched protocols, another channel handler must be installed to"
-                    " deal with further data.",
-                    (void *)&connection->base);
-
-                connection->thread_data.has_switched_protocols = true;
             }
         }
     }
@@ -642,6 +1053,118 @@ static void s_client_update_incoming_stream_ptr(struct h1_connection *connection
     connection->thread_data.incoming_stream = desired;
 }
 
+/**
+ * True if the connection has reached its limit of fully-sent requests awaiting responses,
+ * and must not start sending another request yet.
+ * Client-only. Called from event-loop thread.
+ */
+static bool s_client_pipeline_is_full(struct h1_connection *connection) {
+    if (connection->max_pipelined_requests == 0) {
+        return false;
+    }
+
+    size_t outstanding_responses = 0;
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&connection->thread_data.stream_list);
+         node != aws_linked_list_end(&connection->thread_data.stream_list);
+         node = aws_linked_list_next(node)) {
+
+        struct aws_h1_stream *stream = AWS_CONTAINER_OF(node, struct aws_h1_stream, node);
+        if (stream->is_outgoing_message_done && !stream->is_incoming_message_done) {
+            if (++outstanding_responses >= connection->max_pipelined_requests) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * If the outgoing stream task went idle (ex: pipeline limit reached), get it running again.
+ * Client-only. Called from event-loop thread.
+ */
+static void s_client_resume_outgoing_stream_task(struct h1_connection *connection) {
+    AWS_ASSERT(aws_channel_thread_is_callers_thread(connection->base.channel_slot->channel));
+
+    if (connection->thread_data.is_writing_stopped) {
+        return;
+    }
+
+    bool should_schedule_task = false;
+
+    /* BEGIN CRITICAL SECTION */
+    s_h1_connection_lock_synced_data(connection);
+    if (!connection->synced_data.is_outgoing_stream_task_active) {
+        connection->synced_data.is_outgoing_stream_task_active = true;
+        should_schedule_task = true;
+    }
+    s_h1_connection_unlock_synced_data(connection);
+    /* END CRITICAL SECTION */
+
+    if (should_schedule_task) {
+        AWS_LOGF_TRACE(
+            AWS_LS_HTTP_CONNECTION, "id=%p: Resuming outgoing stream task.", (void *)&connection->base);
+        aws_channel_schedule_task_now(connection->base.channel_slot->channel, &connection->outgoing_stream_task);
+    }
+}
+
+/* Move any streams other threads have made onto the pending stream list, in one batch,
+ * and get the outgoing stream task running. Runs on the event-loop thread. */
+static void s_new_stream_drain_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct h1_connection *connection = arg;
+
+    /* Clear the flag before draining, so a producer that pushes mid-drain reschedules us */
+    aws_atomic_store_int(&connection->new_stream_queue.is_drain_task_scheduled, 0);
+
+    struct aws_h1_stream *stream = aws_atomic_exchange_ptr(&connection->new_stream_queue.head, NULL);
+    if (!stream) {
+        return;
+    }
+
+    /* The chain is newest-first; reverse it back into submission order */
+    struct aws_h1_stream *reversed = NULL;
+    while (stream) {
+        struct aws_h1_stream *next = stream->new_stream_next;
+        stream->new_stream_next = reversed;
+        reversed = stream;
+        stream = next;
+    }
+
+    const int new_stream_error_code = (int)aws_atomic_load_int(&connection->new_stream_queue.new_stream_error_code);
+    if (status != AWS_TASK_STATUS_RUN_READY || new_stream_error_code) {
+        /* Channel is shutting down, or the connection stopped taking streams (ex: switched
+         * protocols) after these streams were pushed. Complete them now so their callbacks
+         * still fire; nothing would ever send them. */
+        const int completion_error =
+            new_stream_error_code ? new_stream_error_code : AWS_ERROR_HTTP_CONNECTION_CLOSED;
+        while (reversed) {
+            struct aws_h1_stream *next = reversed->new_stream_next;
+            aws_linked_list_push_back(&connection->thread_data.stream_list, &reversed->node);
+            s_stream_complete(reversed, completion_error);
+            reversed = next;
+        }
+        return;
+    }
+
+    AWS_LOGF_TRACE(
+        AWS_LS_HTTP_CONNECTION, "id=%p: Draining new stream queue to pending list.", (void *)&connection->base);
+
+    { /* BEGIN CRITICAL SECTION */
+        s_h1_connection_lock_synced_data(connection);
+
+        while (reversed) {
+            struct aws_h1_stream *next = reversed->new_stream_next;
+            aws_linked_list_push_back(&connection->synced_data.pending_stream_list, &reversed->node);
+            reversed = next;
+        }
+
+        s_h1_connection_unlock_synced_data(connection);
+    } /* END CRITICAL SECTION */
+
+    s_client_resume_outgoing_stream_task(connection);
+}
+
 /**
  * If necessary, update `outgoing_stream` so it is pointing at a stream
  * with data to send, or NULL if all streams are done sending data.
@@ -692,7 +1215,22 @@ static struct aws_h1_stream *s_update_outgoing_stream_ptr(struct h1_connection *
      * - Client side: look in synced_data.pending_stream_list for more work
      * - Server side: look in thread_data.waiting_stream_list for more work */
     if (!current && !connection->thread_data.is_writing_stopped) {
-        if (next_node && next_node != aws_linked_list_end(&connection->thread_data.stream_list)) {
+        if (connection->base.client_data && s_client_pipeline_is_full(connection)) {
+            /* Too many responses are outstanding to start sending another request.
+             * Stop the task, it's resumed when a response completes. */
+            AWS_LOGF_TRACE(
+                AWS_LS_HTTP_CONNECTION,
+                "id=%p: Pipeline limit of %zu outstanding responses reached, pausing outgoing stream task.",
+                (void *)&connection->base,
+                connection->max_pipelined_requests);
+
+            /* BEGIN CRITICAL SECTION */
+            s_h1_connection_lock_synced_data(connection);
+            connection->synced_data.is_outgoing_stream_task_active = false;
+            s_h1_connection_unlock_synced_data(connection);
+            /* END CRITICAL SECTION */
+
+        } else if (next_node && next_node != aws_linked_list_end(&connection->thread_data.stream_list)) {
             current = AWS_CONTAINER_OF(next_node, struct aws_h1_stream, node);
 
         } else if (connection->base.server_data) {
@@ -731,28 +1269,45 @@ static struct aws_h1_stream *s_update_outgoing_stream_ptr(struct h1_connection *
             s_h1_connection_unlock_synced_data(connection);
             /* END CRITICAL SECTION */
         } else {
-            /* BEGIN CRITICAL SECTION */
-            s_h1_connection_lock_synced_data(connection);
+            /* The pipeline limit may have paused the task with unsent streams still in stream_list,
+             * check for those before pulling new streams from pending_stream_list. */
+            for (struct aws_linked_list_node *node = aws_linked_list_begin(&connection->thread_data.stream_list);
+                 node != aws_linked_list_end(&connection->thread_data.stream_list);
+                 node = aws_linked_list_next(node)) {
+
+                struct aws_h1_stream *stream = AWS_CONTAINER_OF(node, struct aws_h1_stream, node);
+                if (!stream->is_outgoing_message_done) {
+                    current = stream;
+                    break;
+                }
+            }
 
-            if (aws_linked_list_empty(&connection->synced_data.pending_stream_list)) {
-                /* No more work to do. Set this false while we're holding the lock. */
-                connection->synced_data.is_outgoing_stream_task_active = false;
+            if (!current) {
+                /* BEGIN CRITICAL SECTION */
+                s_h1_connection_lock_synced_data(connection);
 
-            } else {
-                current = AWS_CONTAINER_OF(
-                    aws_linked_list_front(&connection->synced_data.pending_stream_list), struct aws_h1_stream, node);
+                if (aws_linked_list_empty(&connection->synced_data.pending_stream_list)) {
+                    /* No more work to do. Set this false while we're holding the lock. */
+                    connection->synced_data.is_outgoing_stream_task_active = false;
 
-                /* Move contents from pending_stream_list to stream_list. */
-                do {
-                    aws_linked_list_push_back(
-                        &connection->thread_data.stream_list,
-                        aws_linked_list_pop_front(&connection->synced_data.pending_stream_list));
+                } else {
+                    current = AWS_CONTAINER_OF(
+                        aws_linked_list_front(&connection->synced_data.pending_stream_list),
+                        struct aws_h1_stream,
+                        node);
+
+                    /* Move contents from pending_stream_list to stream_list. */
+                    do {
+                        aws_linked_list_push_back(
+                            &connection->thread_data.stream_list,
+                            aws_linked_list_pop_front(&connection->synced_data.pending_stream_list));
+
+                    } while (!aws_linked_list_empty(&connection->synced_data.pending_stream_list));
+                }
 
-                } while (!aws_linked_list_empty(&connection->synced_data.pending_stream_list));
+                s_h1_connection_unlock_synced_data(connection);
+                /* END CRITICAL SECTION */
             }
-
-            s_h1_connection_unlock_synced_data(connection);
-            /* END CRITICAL SECTION */
         }
     }
 
@@ -771,6 +1326,10 @@ static struct aws_h1_stream *s_update_outgoing_stream_ptr(struct h1_connection *
                 &connection->thread_data.encoder, &current->encoder_message, &current->base);
             (void)err;
             AWS_ASSERT(!err);
+
+            if (connection->base.client_data) {
+                s_stream_arm_response_timeouts(connection, current);
+            }
         }
 
         /* incoming_stream update is only for client */
@@ -782,6 +1341,51 @@ static struct aws_h1_stream *s_update_outgoing_stream_ptr(struct h1_connection *
     return current;
 }
 
+/* Park the outgoing stream task while the encoder withholds an "Expect: 100-continue" body.
+ * The task is resumed when the server's response arrives or the continue timer fires.
+ * Called on the channel thread. */
+static void s_stream_pause_for_continue(struct h1_connection *connection, struct aws_h1_stream *stream) {
+    AWS_LOGF_TRACE(
+        AWS_LS_HTTP_STREAM,
+        "id=%p: Request head sent, pausing outgoing stream task until 100-continue response.",
+        (void *)&stream->base);
+
+    if (stream->expect_100_continue_timeout_ms && !stream->continue_timer.is_armed) {
+        uint64_t now_ns = 0;
+        if (aws_channel_current_clock_time(connection->base.channel_slot->channel, &now_ns) == AWS_OP_SUCCESS) {
+            const uint64_t timeout_ns = aws_timestamp_convert(
+                stream->expect_100_continue_timeout_ms, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
+            aws_http_timing_wheel_arm(
+                &connection->thread_data.timeout_wheel,
+                &stream->continue_timer,
+                now_ns + timeout_ns,
+                s_stream_continue_timeout,
+                stream);
+
+            if (!connection->thread_data.is_timeout_wheel_task_scheduled) {
+                connection->thread_data.is_timeout_wheel_task_scheduled = true;
+                aws_channel_schedule_task_future(
+                    connection->base.channel_slot->channel,
+                    &connection->timeout_wheel_task,
+                    now_ns + s_timeout_wheel_tick_ns);
+            }
+        } else {
+            AWS_LOGF_WARN(
+                AWS_LS_HTTP_STREAM,
+                "id=%p: Failed to read channel clock, error %d (%s). Continue timeout not armed.",
+                (void *)&stream->base,
+                aws_last_error(),
+                aws_error_name(aws_last_error()));
+        }
+    }
+
+    /* BEGIN CRITICAL SECTION */
+    s_h1_connection_lock_synced_data(connection);
+    connection->synced_data.is_outgoing_stream_task_active = false;
+    s_h1_connection_unlock_synced_data(connection);
+    /* END CRITICAL SECTION */
+}
+
 static void s_outgoing_stream_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
     if (status != AWS_TASK_STATUS_RUN_READY) {
         return;
@@ -800,8 +1404,13 @@ static void s_outgoing_stream_task(struct aws_channel_task *task, void *arg, enu
     AWS_LOGF_TRACE(AWS_LS_HTTP_CONNECTION, "id=%p: Outgoing stream task is running.", (void *)&connection->base);
 
     /* If outgoing_message_size_hint isn't set yet, calculate it */
+    size_t message_size = connection->preferred_write_message_size;
+    if (message_size == 0) {
+        message_size = MESSAGE_SIZE_HINT;
+    }
+
     size_t overhead = aws_channel_slot_upstream_message_overhead(connection->base.channel_slot);
-    if (overhead >= MESSAGE_SIZE_HINT) {
+    if (overhead >= message_size) {
         AWS_LOGF_ERROR(
             AWS_LS_HTTP_CONNECTION,
             "id=%p: Unexpected error while calculating message size, closing connection.",
@@ -811,17 +1420,24 @@ static void s_outgoing_stream_task(struct aws_channel_task *task, void *arg, enu
         goto error;
     }
 
-    size_t outgoing_message_size_hint = MESSAGE_SIZE_HINT - overhead;
+    size_t outgoing_message_size_hint = message_size - overhead;
 
-    msg = aws_channel_acquire_message_from_pool(channel, AWS_IO_MESSAGE_APPLICATION_DATA, outgoing_message_size_hint);
-    if (!msg) {
-        AWS_LOGF_ERROR(
-            AWS_LS_HTTP_CONNECTION,
-            "id=%p: Failed to acquire message from pool, error %d (%s). Closing connection.",
-            (void *)&connection->base,
-            aws_last_error(),
-            aws_error_name(aws_last_error()));
-        goto error;
+    /* Prefer the message cached by a previous run (it's still empty, and was acquired with the same hint). */
+    if (connection->thread_data.cached_outgoing_message) {
+        msg = connection->thread_data.cached_outgoing_message;
+        connection->thread_data.cached_outgoing_message = NULL;
+    } else {
+        msg = aws_channel_acquire_message_from_pool(
+            channel, AWS_IO_MESSAGE_APPLICATION_DATA, outgoing_message_size_hint);
+        if (!msg) {
+            AWS_LOGF_ERROR(
+                AWS_LS_HTTP_CONNECTION,
+                "id=%p: Failed to acquire message from pool, error %d (%s). Closing connection.",
+                (void *)&connection->base,
+                aws_last_error(),
+                aws_error_name(aws_last_error()));
+            goto error;
+        }
     }
 
     /**
@@ -832,11 +1448,24 @@ static void s_outgoing_stream_task(struct aws_channel_task *task, void *arg, enu
      */
     struct aws_h1_stream *outgoing_stream;
     while ((outgoing_stream = s_update_outgoing_stream_ptr(connection)) != NULL) {
+        const size_t msg_len_before = msg->message_data.len;
         if (aws_h1_encoder_process(&connection->thread_data.encoder, &msg->message_data)) {
             /* Error sending data, abandon ship */
             goto error;
         }
 
+        if (msg->message_data.len > msg_len_before) {
+            s_stream_record_metric_timestamp(connection, &outgoing_stream->base.metrics.send_start_timestamp_ns);
+        }
+
+        /* An "Expect: 100-continue" request stops here with its head written and body withheld.
+         * Park the task; it's resumed when the server responds or the continue timer fires. */
+        if (aws_h1_encoder_is_waiting_for_continue(&connection->thread_data.encoder)) {
+            s_stream_pause_for_continue(connection, outgoing_stream);
+            outgoing_stream = NULL; /* Don't reschedule the task */
+            break;
+        }
+
         /* If there is a stream in progress, it means msg filled up before we finished a stream */
         if (aws_h1_encoder_is_message_in_progress(&connection->thread_data.encoder)) {
             break;
@@ -844,6 +1473,7 @@ static void s_outgoing_stream_task(struct aws_channel_task *task, void *arg, enu
 
         /* If stream is done sending data, mark as done sending, loop, and start sending the next stream's data */
         outgoing_stream->is_outgoing_message_done = true;
+        s_stream_record_metric_timestamp(connection, &outgoing_stream->base.metrics.send_end_timestamp_ns);
     }
 
     if (msg->message_data.len > 0) {
@@ -853,6 +1483,13 @@ static void s_outgoing_stream_task(struct aws_channel_task *task, void *arg, enu
             (void *)&connection->base,
             msg->message_data.len);
 
+        const size_t outgoing_message_size = msg->message_data.len;
+        AWS_HTTP_TRACE3(
+            h1_outgoing_stream_send,
+            &connection->base,
+            outgoing_stream ? &outgoing_stream->base : NULL,
+            outgoing_message_size);
+
         err = aws_channel_slot_send_message(connection->base.channel_slot, msg, AWS_CHANNEL_DIR_WRITE);
         if (err) {
             AWS_LOGF_ERROR(
@@ -864,6 +1501,8 @@ static void s_outgoing_stream_task(struct aws_channel_task *task, void *arg, enu
 
             goto error;
         }
+
+        connection->base.bytes_written += outgoing_message_size;
     } else {
         /* If message is empty, warn that no work is being done.
          * It's likely that body isn't ready, so body streaming function has no data to write yet.
@@ -874,7 +1513,8 @@ static void s_outgoing_stream_task(struct aws_channel_task *task, void *arg, enu
             (void *)&connection->base,
             outgoing_stream ? (void *)&outgoing_stream->base : NULL);
 
-        aws_mem_release(msg->allocator, msg);
+        /* The message is untouched; cache it for the next run instead of releasing it. */
+        connection->thread_data.cached_outgoing_message = msg;
     }
 
     /* Reschedule task if there's still more work to do. */
@@ -969,7 +1609,43 @@ static int s_decoder_on_response(int status_code, void *user_data) {
         status_code,
         aws_http_status_text(status_code));
 
-    connection->thread_data.incoming_stream->base.client_data->response_status = status_code;
+    struct aws_h1_stream *incoming_stream = connection->thread_data.incoming_stream;
+    incoming_stream->base.client_data->response_status = status_code;
+
+    /* The response has begun arriving; its first-byte deadline no longer applies. */
+    aws_http_timing_wheel_cancel(&connection->thread_data.timeout_wheel, &incoming_stream->first_byte_timer);
+
+    /* If the encoder is withholding this stream's "Expect: 100-continue" body, the server has
+     * now spoken: an interim 100 releases the body, any final status means the server has
+     * already judged the request and streaming the body would be wasted bandwidth. */
+    if (incoming_stream == connection->thread_data.outgoing_stream &&
+        aws_h1_encoder_is_waiting_for_continue(&connection->thread_data.encoder)) {
+
+        if (status_code == AWS_HTTP_STATUS_100_CONTINUE) {
+            AWS_LOGF_TRACE(
+                AWS_LS_HTTP_STREAM,
+                "id=%p: Received interim 100 response, sending request body.",
+                (void *)&incoming_stream->base);
+
+            aws_http_timing_wheel_cancel(&connection->thread_data.timeout_wheel, &incoming_stream->continue_timer);
+            aws_h1_encoder_continue_message(&connection->thread_data.encoder);
+            s_client_resume_outgoing_stream_task(connection);
+        } else if (status_code / 100 != 1) {
+            AWS_LOGF_DEBUG(
+                AWS_LS_HTTP_STREAM,
+                "id=%p: Received final response %d before interim 100, request body will not be sent.",
+                (void *)&incoming_stream->base,
+                status_code);
+
+            /* The unsent body leaves the request shorter than its declared framing,
+             * so this connection can't be reused for further requests. */
+            aws_http_timing_wheel_cancel(&connection->thread_data.timeout_wheel, &incoming_stream->continue_timer);
+            aws_h1_encoder_abandon_waiting_body(&connection->thread_data.encoder);
+            incoming_stream->is_final_stream = true;
+            s_client_resume_outgoing_stream_task(connection);
+        }
+        /* Other interim responses (ex: 103) keep the body withheld and the timer running */
+    }
 
     /* No user callbacks, so we're not checking for shutdown */
     return AWS_OP_SUCCESS;
@@ -999,17 +1675,28 @@ static int s_decoder_on_header(const struct aws_http_decoded_header *header, voi
                 (void *)&incoming_stream->base);
 
             incoming_stream->is_final_stream = true;
+
+            /* Tell anyone pooling this connection (ex: connection manager) to stop vending it now,
+             * rather than discovering at shutdown time that the peer was done with it. */
+            aws_http_connection_signal_draining(&connection->base);
         }
     }
 
-    if (incoming_stream->base.on_incoming_headers) {
+    /* Trailing fields of a chunked message go to the dedicated trailer callback, if set.
+     * Each field is delivered as it's decoded, nothing accumulates. */
+    aws_http_on_incoming_headers_fn *deliver_fn = incoming_stream->base.on_incoming_headers;
+    if (header_block == AWS_HTTP_HEADER_BLOCK_TRAILING && incoming_stream->base.on_incoming_trailers) {
+        deliver_fn = incoming_stream->base.on_incoming_trailers;
+    }
+
+    if (deliver_fn) {
         struct aws_http_header deliver = {
             .name = header->name_data,
             .value = header->value_data,
         };
 
-        int err = incoming_stream->base.on_incoming_headers(
-            &incoming_stream->base, header_block, &deliver, 1, incoming_stream->base.user_data);
+        int err =
+            deliver_fn(&incoming_stream->base, header_block, &deliver, 1, incoming_stream->base.user_data);
 
         if (err) {
             AWS_LOGF_TRACE(
@@ -1090,9 +1777,29 @@ static int s_decoder_on_body(const struct aws_byte_cursor *data, bool finished,
     /* If the user wishes to manually increment windows, by default shrink the window by the amount of data read. */
     if (incoming_stream->base.manual_window_management) {
         connection->thread_data.incoming_message_window_shrink_size += data->len;
+
+        /* Adaptive window mode: arm a consumption-delay sample. The clock is read when the
+         * app credits the window back; only one sample is in flight at a time. */
+        if (connection->adaptive_window_management && !connection->thread_data.adaptive.last_delivery_timestamp_ns) {
+            aws_channel_current_clock_time(
+                connection->base.channel_slot->channel, &connection->thread_data.adaptive.last_delivery_timestamp_ns);
+        }
     }
 
-    if (incoming_stream->base.on_incoming_body) {
+    if (incoming_stream->base.incoming_body_sink) {
+        /* Deliver straight into the user's buffer, no callback per chunk */
+        if (aws_byte_buf_append_dynamic(incoming_stream->base.incoming_body_sink, data)) {
+            AWS_LOGF_ERROR(
+                AWS_LS_HTTP_STREAM,
+                "id=%p: Failed to append %zu bytes of incoming body to sink buffer, error %d (%s).",
+                (void *)&incoming_stream->base,
+                data->len,
+                aws_last_error(),
+                aws_error_name(aws_last_error()));
+
+            return AWS_OP_ERR;
+        }
+    } else if (incoming_stream->base.on_incoming_body) {
         err = incoming_stream->base.on_incoming_body(&incoming_stream->base, data, incoming_stream->base.user_data);
         if (err) {
             AWS_LOGF_TRACE(
@@ -1171,6 +1878,12 @@ static int s_decoder_on_done(void *user_data) {
         s_client_update_incoming_stream_ptr(connection);
     }
 
+    /* Client side: completing a response may free up room in the pipeline,
+     * wake the outgoing stream task in case it paused while waiting for that. */
+    if (connection->base.client_data && connection->max_pipelined_requests) {
+        s_client_resume_outgoing_stream_task(connection);
+    }
+
     /* Report success even if user's on_complete() callback shuts down on the connection.
      * We don't want it to look like something went wrong while decoding.
      * The decode() function returns after each message completes,
@@ -1179,7 +1892,14 @@ static int s_decoder_on_done(void *user_data) {
 }
 
 /* Common new() logic for server & client */
-static struct h1_connection *s_connection_new(struct aws_allocator *alloc, size_t initial_window_size, bool server) {
+static struct h1_connection *s_connection_new(
+    struct aws_allocator *alloc,
+    size_t initial_window_size,
+    size_t max_pipelined_requests,
+    size_t window_update_threshold,
+    size_t preferred_write_message_size,
+    bool adaptive_window_management,
+    bool server) {
 
     struct h1_connection *connection = aws_mem_calloc(alloc, 1, sizeof(struct h1_connection));
     if (!connection) {
@@ -1192,15 +1912,32 @@ static struct h1_connection *s_connection_new(struct aws_allocator *alloc, size_
     connection->base.channel_handler.impl = connection;
     connection->base.http_version = AWS_HTTP_VERSION_1_1;
     connection->base.initial_window_size = initial_window_size;
+    connection->max_pipelined_requests = max_pipelined_requests;
+    connection->window_update_threshold = window_update_threshold;
+    connection->preferred_write_message_size = preferred_write_message_size;
+    connection->adaptive_window_management = adaptive_window_management;
+    if (adaptive_window_management) {
+        connection->thread_data.adaptive.window_target =
+            aws_min_size(initial_window_size, ADAPTIVE_WINDOW_INITIAL_SIZE);
+    }
 
     /* 1 refcount for user */
     aws_atomic_init_int(&connection->base.refcount, 1);
+    aws_atomic_init_int(&connection->base.is_draining, 0);
+
+    aws_http_stream_pool_init(&connection->base.stream_pool, alloc, sizeof(struct aws_h1_stream));
 
     aws_h1_encoder_init(&connection->thread_data.encoder, alloc);
 
     aws_channel_task_init(
         &connection->outgoing_stream_task, s_outgoing_stream_task, connection, "http1_outgoing_stream");
     aws_channel_task_init(&connection->window_update_task, s_update_window_task, connection, "http1_update_window");
+    aws_channel_task_init(&connection->timeout_wheel_task, s_timeout_wheel_task, connection, "http1_timeout_wheel");
+    aws_channel_task_init(
+        &connection->new_stream_drain_task, s_new_stream_drain_task, connection, "http1_new_stream_drain");
+    aws_atomic_init_ptr(&connection->new_stream_queue.head, NULL);
+    aws_atomic_init_int(&connection->new_stream_queue.is_drain_task_scheduled, 0);
+    aws_atomic_init_int(&connection->new_stream_queue.new_stream_error_code, AWS_ERROR_SUCCESS);
     aws_linked_list_init(&connection->thread_data.stream_list);
     aws_linked_list_init(&connection->thread_data.waiting_stream_list);
     aws_linked_list_init(&connection->thread_data.midchannel_read_messages);
@@ -1222,6 +1959,7 @@ static struct h1_connection *s_connection_new(struct aws_allocator *alloc, size_
         .user_data = connection,
         .vtable = s_h1_decoder_vtable,
         .scratch_space_initial_size = DECODER_INITIAL_SCRATCH_SIZE,
+        .max_scratch_size = server ? DECODER_MAX_SCRATCH_SIZE_SERVER : 0,
     };
     connection->thread_data.incoming_stream_decoder = aws_h1_decoder_new(&options);
     if (!connection->thread_data.incoming_stream_decoder) {
@@ -1234,8 +1972,22 @@ static struct h1_connection *s_connection_new(struct aws_allocator *alloc, size_
         goto error_decoder;
     }
 
+    /* Wheel position syncs to the channel clock the first time a timer is armed. */
+    if (aws_http_timing_wheel_init(
+            &connection->thread_data.timeout_wheel, alloc, s_timeout_wheel_tick_ns, TIMEOUT_WHEEL_NUM_SLOTS, 0)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_CONNECTION,
+            "static: Failed to create timing wheel, error %d (%s).",
+            aws_last_error(),
+            aws_error_name(aws_last_error()));
+
+        goto error_timing_wheel;
+    }
+
     return connection;
 
+error_timing_wheel:
+    aws_h1_decoder_destroy(connection->thread_data.incoming_stream_decoder);
 error_decoder:
     aws_mutex_clean_up(&connection->synced_data.lock);
 error_mutex:
@@ -1248,7 +2000,14 @@ struct aws_http_connection *aws_http_connection_new_http1_1_server(
     struct aws_allocator *allocator,
     size_t initial_window_size) {
 
-    struct h1_connection *connection = s_connection_new(allocator, initial_window_size, true);
+    struct h1_connection *connection = s_connection_new(
+        allocator,
+        initial_window_size,
+        0 /*max_pipelined_requests*/,
+        0 /*window_update_threshold*/,
+        0 /*preferred_write_message_size*/,
+        false /*adaptive_window_management*/,
+        true);
     if (!connection) {
         return NULL;
     }
@@ -1260,9 +2019,20 @@ struct aws_http_connection *aws_http_connection_new_http1_1_server(
 
 struct aws_http_connection *aws_http_connection_new_http1_1_client(
     struct aws_allocator *allocator,
-    size_t initial_window_size) {
-
-    struct h1_connection *connection = s_connection_new(allocator, initial_window_size, false);
+    size_t initial_window_size,
+    size_t max_pipelined_requests,
+    size_t window_update_threshold,
+    size_t preferred_write_message_size,
+    bool adaptive_window_management) {
+
+    struct h1_connection *connection = s_connection_new(
+        allocator,
+        initial_window_size,
+        max_pipelined_requests,
+        window_update_threshold,
+        preferred_write_message_size,
+        adaptive_window_management,
+        false);
     if (!connection) {
         return NULL;
     }
@@ -1281,9 +2051,18 @@ static void s_handler_destroy(struct aws_channel_handler *handler) {
     AWS_ASSERT(aws_linked_list_empty(&connection->thread_data.stream_list));
     AWS_ASSERT(aws_linked_list_empty(&connection->thread_data.waiting_stream_list));
     AWS_ASSERT(aws_linked_list_empty(&connection->synced_data.pending_stream_list));
+    AWS_ASSERT(aws_atomic_load_ptr(&connection->new_stream_queue.head) == NULL);
+
+    if (connection->thread_data.cached_outgoing_message) {
+        aws_mem_release(
+            connection->thread_data.cached_outgoing_message->allocator,
+            connection->thread_data.cached_outgoing_message);
+    }
 
+    aws_http_timing_wheel_clean_up(&connection->thread_data.timeout_wheel);
     aws_h1_decoder_destroy(connection->thread_data.incoming_stream_decoder);
     aws_h1_encoder_clean_up(&connection->thread_data.encoder);
+    aws_http_stream_pool_clean_up(&connection->base.stream_pool);
     aws_mutex_clean_up(&connection->synced_data.lock);
     aws_mem_release(connection->base.alloc, connection);
 }
@@ -1465,6 +2244,13 @@ static int s_handler_process_read_message(
     int err;
 
     const size_t incoming_message_size = message->message_data.len;
+    connection->base.bytes_read += incoming_message_size;
+
+    AWS_HTTP_TRACE3(
+        h1_read_message,
+        &connection->base,
+        connection->thread_data.incoming_stream ? &connection->thread_data.incoming_stream->base : NULL,
+        incoming_message_size);
 
     /* By default, after processing message, we will increment the read window by the same amount we just read in. */
     connection->thread_data.incoming_message_window_shrink_size = 0;
@@ -1556,6 +2342,9 @@ static int s_handler_process_read_message(
             aws_h1_decoder_set_body_headers_ignored(
                 connection->thread_data.incoming_stream_decoder, body_headers_ignored);
 
+            s_stream_record_metric_timestamp(
+                connection, &connection->thread_data.incoming_stream->base.metrics.receive_start_timestamp_ns);
+
             /* Decoder will stop once it hits the end of the request/response OR the end of the message data. */
             err = aws_h1_decode(connection->thread_data.incoming_stream_decoder, &message_cursor);
             if (err) {
@@ -1620,11 +2409,14 @@ static int s_handler_process_write_message(
     }
 
     /* Pass the message right along. */
+    const size_t outgoing_message_size = message->message_data.len;
     int err = aws_channel_slot_send_message(slot, message, AWS_CHANNEL_DIR_WRITE);
     if (err) {
         goto error;
     }
 
+    connection->base.bytes_written += outgoing_message_size;
+
     return AWS_OP_SUCCESS;
 
 error:
@@ -1736,6 +2528,16 @@ static int s_handler_shutdown(
             struct aws_linked_list_node *node = aws_linked_list_front(&connection->synced_data.pending_stream_list);
             s_stream_complete(AWS_CONTAINER_OF(node, struct aws_h1_stream, node), stream_error_code);
         }
+
+        /* Streams pushed onto the new-stream queue that the drain task never picked up.
+         * A racing producer saw is_open before s_stop() flipped it, so drain here too. */
+        struct aws_h1_stream *new_stream = aws_atomic_exchange_ptr(&connection->new_stream_queue.head, NULL);
+        while (new_stream) {
+            struct aws_h1_stream *next = new_stream->new_stream_next;
+            aws_linked_list_push_back(&connection->thread_data.stream_list, &new_stream->node);
+            s_stream_complete(new_stream, stream_error_code);
+            new_stream = next;
+        }
     }
 
     aws_channel_slot_on_handler_shutdown_complete(slot, dir, error_code, free_scarce_resources_immediately);
@@ -1744,6 +2546,12 @@ static int s_handler_shutdown(
 
 static size_t s_handler_initial_window_size(struct aws_channel_handler *handler) {
     struct h1_connection *connection = handler->impl;
+
+    /* Adaptive mode: the channel starts at the adaptive target, not the (possibly huge) cap. */
+    if (connection->adaptive_window_management) {
+        return connection->thread_data.adaptive.window_target;
+    }
+
     return connection->base.initial_window_size;
 }
 
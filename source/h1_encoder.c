@@ -14,6 +14,8 @@
  */
 #include <aws/http/private/h1_encoder.h>
 
+#include <aws/common/date_time.h>
+#include <aws/common/mutex.h>
 #include <aws/http/private/strutil.h>
 #include <aws/io/logging.h>
 #include <aws/io/stream.h>
@@ -24,6 +26,43 @@
     AWS_LOGF_##level(AWS_LS_HTTP_STREAM, "id=%p: " text, encoder->logging_id, __VA_ARGS__)
 #define ENCODER_LOG(level, encoder, text) ENCODER_LOGF(level, encoder, "%s", text)
 
+/* Chunk framing: fixed-width hex size, CRLF, data, CRLF */
+enum {
+    CHUNK_SIZE_HEX_DIGITS = 8,
+    CHUNK_OVERHEAD = CHUNK_SIZE_HEX_DIGITS + 2 + 2,
+    /* Don't bother emitting a chunk unless it can hold at least a few payload bytes */
+    CHUNK_MIN_SPACE = CHUNK_OVERHEAD + 4,
+};
+
+/* Copy a vectored body's segment list onto the encoder message. Segments are small value
+ * types (cursors and stream pointers); the underlying bytes and streams stay caller-owned. */
+static int s_encoder_message_copy_body_segments(
+    struct aws_h1_encoder_message *encoder_message,
+    struct aws_allocator *allocator,
+    const struct aws_http_message *message) {
+
+    const size_t num_segments = aws_http_message_get_body_segment_count(message);
+    if (num_segments == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    if (aws_array_list_init_dynamic(
+            &encoder_message->body_segments, allocator, num_segments, sizeof(struct aws_http_body_segment))) {
+        return AWS_OP_ERR;
+    }
+    encoder_message->has_body_segments = true;
+
+    for (size_t i = 0; i < num_segments; ++i) {
+        struct aws_http_body_segment segment;
+        aws_http_message_get_body_segment(message, i, &segment);
+        if (aws_array_list_push_back(&encoder_message->body_segments, &segment)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
 /**
  * Scan headers to detect errors and determine anything we'll need to know later (ex: total length).
  */
@@ -35,8 +74,10 @@ static int s_scan_outgoing_headers(
     bool body_headers_forbidden) {
 
     size_t total = 0;
-    bool has_body_stream = aws_http_message_get_body_stream(message);
+    bool has_body_stream =
+        aws_http_message_get_body_stream(message) || aws_http_message_get_body_segment_count(message);
     bool has_body_headers = false;
+    bool has_content_length_header = false;
 
     const size_t num_headers = aws_http_message_get_header_count(message);
     for (size_t i = 0; i < num_headers; ++i) {
@@ -57,13 +98,31 @@ static int s_scan_outgoing_headers(
                     AWS_LOGF_ERROR(AWS_LS_HTTP_STREAM, "id=static: Invalid Content-Length");
                     return aws_raise_error(AWS_ERROR_HTTP_INVALID_HEADER_VALUE);
                 }
+                has_content_length_header = true;
                 if (encoder_message->content_length > 0) {
                     has_body_headers = true;
                 }
             } break;
-            case AWS_HTTP_HEADER_TRANSFER_ENCODING:
-                AWS_LOGF_ERROR(AWS_LS_HTTP_STREAM, "id=static: Sending of chunked messages not yet implemented");
-                return aws_raise_error(AWS_ERROR_UNIMPLEMENTED);
+            case AWS_HTTP_HEADER_EXPECT: {
+                struct aws_byte_cursor trimmed_value = aws_strutil_trim_http_whitespace(header.value);
+                /* RFC-7231 Section 5.1.1: 100-continue is the only expectation defined */
+                if (!aws_byte_cursor_eq_c_str_ignore_case(&trimmed_value, "100-continue")) {
+                    AWS_LOGF_ERROR(AWS_LS_HTTP_STREAM, "id=static: Unsupported Expect header value");
+                    return aws_raise_error(AWS_ERROR_UNIMPLEMENTED);
+                }
+                encoder_message->has_expect_continue_header = true;
+            } break;
+            case AWS_HTTP_HEADER_TRANSFER_ENCODING: {
+                struct aws_byte_cursor trimmed_value = aws_strutil_trim_http_whitespace(header.value);
+                /* RFC-7230 Section 3.3.1: chunked must be the final (here, only) transfer-coding applied.
+                 * It's the only coding the encoder knows how to produce. */
+                if (!aws_byte_cursor_eq_c_str_ignore_case(&trimmed_value, "chunked")) {
+                    AWS_LOGF_ERROR(AWS_LS_HTTP_STREAM, "id=static: Unsupported Transfer-Encoding");
+                    return aws_raise_error(AWS_ERROR_UNIMPLEMENTED);
+                }
+                encoder_message->has_chunked_encoding_header = true;
+                has_body_headers = true;
+            } break;
             default:
                 break;
         }
@@ -81,10 +140,18 @@ static int s_scan_outgoing_headers(
         return aws_raise_error(AWS_ERROR_HTTP_INVALID_HEADER_FIELD);
     }
 
+    /* RFC-7230 Section 3.3.2: A sender MUST NOT send a Content-Length header field
+     * in any message that contains a Transfer-Encoding header field. */
+    if (has_content_length_header && encoder_message->has_chunked_encoding_header) {
+        AWS_LOGF_ERROR(AWS_LS_HTTP_STREAM, "id=static: Both Content-Length and Transfer-Encoding set");
+        return aws_raise_error(AWS_ERROR_HTTP_INVALID_HEADER_FIELD);
+    }
+
     if (body_headers_ignored) {
         /* Don't send body, no matter what the headers are */
         has_body_headers = false;
         encoder_message->content_length = 0;
+        encoder_message->has_chunked_encoding_header = false;
     }
 
     if (has_body_headers && !has_body_stream) {
@@ -118,11 +185,15 @@ static void s_write_headers(struct aws_byte_buf *dst, const struct aws_http_mess
 int aws_h1_encoder_message_init_from_request(
     struct aws_h1_encoder_message *message,
     struct aws_allocator *allocator,
-    const struct aws_http_message *request) {
+    const struct aws_http_message *request,
+    struct aws_byte_buf *optional_head_storage) {
 
     AWS_ZERO_STRUCT(*message);
 
     message->body = aws_http_message_get_body_stream(request);
+    if (s_encoder_message_copy_body_segments(message, allocator, request)) {
+        goto error;
+    }
 
     struct aws_byte_cursor method;
     int err = aws_http_message_get_request_method(request, &method);
@@ -167,9 +238,16 @@ int aws_h1_encoder_message_init_from_request(
         goto error;
     }
 
-    err = aws_byte_buf_init(&message->outgoing_head_buf, allocator, head_total_len);
-    if (err) {
-        goto error;
+    if (optional_head_storage && optional_head_storage->capacity >= head_total_len) {
+        /* Caller-provided storage (ex: carved from the stream's own allocation).
+         * Its allocator is NULL, so clean_up leaves it alone. */
+        AWS_ASSERT(optional_head_storage->allocator == NULL && optional_head_storage->len == 0);
+        message->outgoing_head_buf = *optional_head_storage;
+    } else {
+        err = aws_byte_buf_init(&message->outgoing_head_buf, allocator, head_total_len);
+        if (err) {
+            goto error;
+        }
     }
 
     bool wrote_all = true;
@@ -195,6 +273,37 @@ error:
     return AWS_OP_ERR;
 }
 
+/* Fully pre-rendered response lines for the most common status codes, so a typical response
+ * head begins with one buffer write instead of snprintf formatting.
+ * Bytes must match exactly what the formatted path in init_from_response would produce. */
+static struct aws_byte_cursor s_cached_response_line(int status_int) {
+    struct aws_byte_cursor line;
+    switch (status_int) {
+        case 200:
+            line = aws_byte_cursor_from_c_str("HTTP/1.1 200 OK\r\n");
+            break;
+        case 204:
+            line = aws_byte_cursor_from_c_str("HTTP/1.1 204 No Content\r\n");
+            break;
+        case 301:
+            line = aws_byte_cursor_from_c_str("HTTP/1.1 301 Moved Permanently\r\n");
+            break;
+        case 304:
+            line = aws_byte_cursor_from_c_str("HTTP/1.1 304 Not Modified\r\n");
+            break;
+        case 404:
+            line = aws_byte_cursor_from_c_str("HTTP/1.1 404 Not Found\r\n");
+            break;
+        case 500:
+            line = aws_byte_cursor_from_c_str("HTTP/1.1 500 Internal Server Error\r\n");
+            break;
+        default:
+            AWS_ZERO_STRUCT(line);
+            break;
+    }
+    return line;
+}
+
 int aws_h1_encoder_message_init_from_response(
     struct aws_h1_encoder_message *message,
     struct aws_allocator *allocator,
@@ -204,22 +313,35 @@ int aws_h1_encoder_message_init_from_response(
     AWS_ZERO_STRUCT(*message);
 
     message->body = aws_http_message_get_body_stream(response);
+    if (s_encoder_message_copy_body_segments(message, allocator, response)) {
+        goto error;
+    }
 
     struct aws_byte_cursor version = aws_http_version_to_str(AWS_HTTP_VERSION_1_1);
 
     int status_int;
     int err = aws_http_message_get_response_status(response, &status_int);
     if (err) {
-        return aws_raise_error(AWS_ERROR_HTTP_INVALID_STATUS_CODE);
+        aws_raise_error(AWS_ERROR_HTTP_INVALID_STATUS_CODE);
+        goto error;
     }
 
     /* Status code must fit in 3 digits */
     AWS_ASSERT(status_int >= 0 && status_int <= 999); /* aws_http_message should have already checked this */
-    char status_code_str[4] = "XXX";
-    snprintf(status_code_str, sizeof(status_code_str), "%03d", status_int);
-    struct aws_byte_cursor status_code = aws_byte_cursor_from_c_str(status_code_str);
 
-    struct aws_byte_cursor status_text = aws_byte_cursor_from_c_str(aws_http_status_text(status_int));
+    /* Common codes have a fully pre-rendered response line; anything else is formatted below */
+    struct aws_byte_cursor cached_response_line = s_cached_response_line(status_int);
+
+    char status_code_str[4] = "XXX";
+    struct aws_byte_cursor status_code;
+    struct aws_byte_cursor status_text;
+    AWS_ZERO_STRUCT(status_code);
+    AWS_ZERO_STRUCT(status_text);
+    if (!cached_response_line.len) {
+        snprintf(status_code_str, sizeof(status_code_str), "%03d", status_int);
+        status_code = aws_byte_cursor_from_c_str(status_code_str);
+        status_text = aws_byte_cursor_from_c_str(aws_http_status_text(status_int));
+    }
 
     /**
      * Calculate total size needed for outgoing_head_buffer, then write to buffer.
@@ -237,12 +359,20 @@ int aws_h1_encoder_message_init_from_response(
         goto error;
     }
 
+    /* Expect is a request-only header; a response must never pause the encoder */
+    message->has_expect_continue_header = false;
+
     /* valid status must be three digital code, change it into byte_cursor */
     /* response-line: "{version} {status} {status_text}\r\n" */
-    size_t response_line_len = 4; /* 2 spaces + "\r\n" */
-    err |= aws_add_size_checked(version.len, response_line_len, &response_line_len);
-    err |= aws_add_size_checked(status_code.len, response_line_len, &response_line_len);
-    err |= aws_add_size_checked(status_text.len, response_line_len, &response_line_len);
+    size_t response_line_len;
+    if (cached_response_line.len) {
+        response_line_len = cached_response_line.len;
+    } else {
+        response_line_len = 4; /* 2 spaces + "\r\n" */
+        err |= aws_add_size_checked(version.len, response_line_len, &response_line_len);
+        err |= aws_add_size_checked(status_code.len, response_line_len, &response_line_len);
+        err |= aws_add_size_checked(status_text.len, response_line_len, &response_line_len);
+    }
 
     /* head-end: "\r\n" */
     size_t head_end_len = 2;
@@ -255,18 +385,22 @@ int aws_h1_encoder_message_init_from_response(
 
     err = aws_byte_buf_init(&message->outgoing_head_buf, allocator, head_total_len);
     if (err) {
-        return AWS_OP_ERR;
+        goto error;
     }
 
     bool wrote_all = true;
 
-    wrote_all &= aws_byte_buf_write_from_whole_cursor(&message->outgoing_head_buf, version);
-    wrote_all &= aws_byte_buf_write_u8(&message->outgoing_head_buf, ' ');
-    wrote_all &= aws_byte_buf_write_from_whole_cursor(&message->outgoing_head_buf, status_code);
-    wrote_all &= aws_byte_buf_write_u8(&message->outgoing_head_buf, ' ');
-    wrote_all &= aws_byte_buf_write_from_whole_cursor(&message->outgoing_head_buf, status_text);
-    wrote_all &= aws_byte_buf_write_u8(&message->outgoing_head_buf, '\r');
-    wrote_all &= aws_byte_buf_write_u8(&message->outgoing_head_buf, '\n');
+    if (cached_response_line.len) {
+        wrote_all &= aws_byte_buf_write_from_whole_cursor(&message->outgoing_head_buf, cached_response_line);
+    } else {
+        wrote_all &= aws_byte_buf_write_from_whole_cursor(&message->outgoing_head_buf, version);
+        wrote_all &= aws_byte_buf_write_u8(&message->outgoing_head_buf, ' ');
+        wrote_all &= aws_byte_buf_write_from_whole_cursor(&message->outgoing_head_buf, status_code);
+        wrote_all &= aws_byte_buf_write_u8(&message->outgoing_head_buf, ' ');
+        wrote_all &= aws_byte_buf_write_from_whole_cursor(&message->outgoing_head_buf, status_text);
+        wrote_all &= aws_byte_buf_write_u8(&message->outgoing_head_buf, '\r');
+        wrote_all &= aws_byte_buf_write_u8(&message->outgoing_head_buf, '\n');
+    }
 
     s_write_headers(&message->outgoing_head_buf, response);
 
@@ -285,7 +419,301 @@ error:
 
 void aws_h1_encoder_message_clean_up(struct aws_h1_encoder_message *message) {
     aws_byte_buf_clean_up(&message->outgoing_head_buf);
+    aws_array_list_clean_up(&message->body_segments);
+    AWS_ZERO_STRUCT(*message);
+}
+
+/* Big enough for "Tue, 15 Nov 1994 08:12:31 GMT" with room to spare */
+enum { CACHED_DATE_CAPACITY = 32 };
+
+/* The Date header value, re-rendered at most once per second and shared process-wide.
+ * Two slots alternate so a cursor already handed out stays stable while the next second's
+ * value is rendered into the other slot. */
+static struct {
+    struct aws_mutex lock;
+    struct {
+        char value[CACHED_DATE_CAPACITY];
+        size_t len;
+        time_t timestamp;
+    } slots[2];
+    size_t current;
+} s_cached_date = {
+    .lock = AWS_MUTEX_INIT,
+};
+
+int aws_h1_encoder_cached_date(struct aws_byte_cursor *out_date) {
+    struct aws_date_time now;
+    aws_date_time_init_now(&now);
+
+    aws_mutex_lock(&s_cached_date.lock);
+
+    if (s_cached_date.slots[s_cached_date.current].len == 0 ||
+        s_cached_date.slots[s_cached_date.current].timestamp != now.timestamp) {
+
+        const size_t next = s_cached_date.current ^ 1;
+        struct aws_byte_buf value_buf =
+            aws_byte_buf_from_empty_array(s_cached_date.slots[next].value, CACHED_DATE_CAPACITY);
+        if (aws_date_time_to_utc_time_str(&now, AWS_DATE_FORMAT_RFC822, &value_buf)) {
+            aws_mutex_unlock(&s_cached_date.lock);
+            return AWS_OP_ERR;
+        }
+        s_cached_date.slots[next].len = value_buf.len;
+        s_cached_date.slots[next].timestamp = now.timestamp;
+        s_cached_date.current = next;
+    }
+
+    *out_date = aws_byte_cursor_from_array(
+        s_cached_date.slots[s_cached_date.current].value, s_cached_date.slots[s_cached_date.current].len);
+
+    aws_mutex_unlock(&s_cached_date.lock);
+    return AWS_OP_SUCCESS;
+}
+
+/* An insertion point for one variable header value within head_template */
+struct aws_h1_encoder_template_slot {
+    /* Byte offset in head_template where the value goes (between "name: " and "\r\n") */
+    size_t offset;
+    /* So Content-Length slots can update the message's body framing when patched */
+    enum aws_http_header_name name_enum;
+};
+
+static bool s_is_variable_header(
+    struct aws_byte_cursor header_name,
+    const struct aws_byte_cursor *variable_header_names,
+    size_t variable_header_count) {
+
+    for (size_t i = 0; i < variable_header_count; ++i) {
+        if (aws_byte_cursor_eq_ignore_case(&header_name, &variable_header_names[i])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int aws_h1_encoder_message_template_init_from_request(
+    struct aws_h1_encoder_message_template *message_template,
+    struct aws_allocator *allocator,
+    const struct aws_http_message *request,
+    const struct aws_byte_cursor *variable_header_names,
+    size_t variable_header_count) {
+
+    AWS_ZERO_STRUCT(*message_template);
+
+    const size_t num_headers = aws_http_message_get_header_count(request);
+
+    /*
+     * Each variable name must match exactly one header, or the positional pairing between
+     * slots and the values supplied later would be ambiguous.
+     */
+    for (size_t i = 0; i < variable_header_count; ++i) {
+        size_t match_count = 0;
+        for (size_t j = 0; j < num_headers; ++j) {
+            struct aws_http_header header;
+            aws_http_message_get_header(request, &header, j);
+            if (aws_byte_cursor_eq_ignore_case(&header.name, &variable_header_names[i])) {
+                ++match_count;
+            }
+        }
+
+        if (match_count != 1) {
+            AWS_LOGF_ERROR(
+                AWS_LS_HTTP_STREAM, "id=static: Variable template header must match exactly one request header");
+            return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
+    struct aws_byte_cursor method;
+    int err = aws_http_message_get_request_method(request, &method);
+    if (err) {
+        aws_raise_error(AWS_ERROR_HTTP_INVALID_METHOD);
+        goto error;
+    }
+
+    struct aws_byte_cursor uri;
+    err = aws_http_message_get_request_path(request, &uri);
+    if (err) {
+        aws_raise_error(AWS_ERROR_HTTP_INVALID_PATH);
+        goto error;
+    }
+
+    struct aws_byte_cursor version = aws_http_version_to_str(AWS_HTTP_VERSION_1_1);
+
+    /*
+     * Validate headers and capture body framing exactly as a direct encode would.  The
+     * request's values for variable headers serve as placeholders here; a Content-Length
+     * slot gets re-parsed from the real value when the template is instantiated.
+     */
+    struct aws_h1_encoder_message scan_message;
+    AWS_ZERO_STRUCT(scan_message);
+
+    size_t header_lines_len;
+    err = s_scan_outgoing_headers(
+        &scan_message, request, &header_lines_len, false /*body_headers_ignored*/, false /*body_headers_forbidden*/);
+    if (err) {
+        goto error;
+    }
+
+    message_template->content_length = scan_message.content_length;
+    message_template->has_connection_close_header = scan_message.has_connection_close_header;
+    message_template->has_chunked_encoding_header = scan_message.has_chunked_encoding_header;
+    message_template->has_expect_continue_header = scan_message.has_expect_continue_header;
+
+    if (aws_array_list_init_dynamic(
+            &message_template->variable_slots,
+            allocator,
+            variable_header_count,
+            sizeof(struct aws_h1_encoder_template_slot))) {
+        goto error;
+    }
+
+    /* request-line: "{method} {uri} {version}\r\n" */
+    size_t request_line_len = 4; /* 2 spaces + "\r\n" */
+    err |= aws_add_size_checked(method.len, request_line_len, &request_line_len);
+    err |= aws_add_size_checked(uri.len, request_line_len, &request_line_len);
+    err |= aws_add_size_checked(version.len, request_line_len, &request_line_len);
+
+    /* Upper bound; the placeholder values of variable headers are not actually written */
+    size_t head_total_len = request_line_len;
+    err |= aws_add_size_checked(header_lines_len, head_total_len, &head_total_len);
+    err |= aws_add_size_checked(2 /*head-end "\r\n"*/, head_total_len, &head_total_len);
+    if (err) {
+        goto error;
+    }
+
+    err = aws_byte_buf_init(&message_template->head_template, allocator, head_total_len);
+    if (err) {
+        goto error;
+    }
+
+    bool wrote_all = true;
+
+    wrote_all &= aws_byte_buf_write_from_whole_cursor(&message_template->head_template, method);
+    wrote_all &= aws_byte_buf_write_u8(&message_template->head_template, ' ');
+    wrote_all &= aws_byte_buf_write_from_whole_cursor(&message_template->head_template, uri);
+    wrote_all &= aws_byte_buf_write_u8(&message_template->head_template, ' ');
+    wrote_all &= aws_byte_buf_write_from_whole_cursor(&message_template->head_template, version);
+    wrote_all &= aws_byte_buf_write_u8(&message_template->head_template, '\r');
+    wrote_all &= aws_byte_buf_write_u8(&message_template->head_template, '\n');
+
+    for (size_t i = 0; i < num_headers; ++i) {
+        struct aws_http_header header;
+        aws_http_message_get_header(request, &header, i);
+
+        /* header-line: "{name}: {value}\r\n", with variable values left out */
+        wrote_all &= aws_byte_buf_write_from_whole_cursor(&message_template->head_template, header.name);
+        wrote_all &= aws_byte_buf_write_u8(&message_template->head_template, ':');
+        wrote_all &= aws_byte_buf_write_u8(&message_template->head_template, ' ');
+
+        if (s_is_variable_header(header.name, variable_header_names, variable_header_count)) {
+            struct aws_h1_encoder_template_slot slot = {
+                .offset = message_template->head_template.len,
+                .name_enum = aws_http_str_to_header_name(header.name),
+            };
+            AWS_FATAL_ASSERT(aws_array_list_push_back(&message_template->variable_slots, &slot) == AWS_OP_SUCCESS);
+        } else {
+            wrote_all &= aws_byte_buf_write_from_whole_cursor(&message_template->head_template, header.value);
+        }
+
+        wrote_all &= aws_byte_buf_write_u8(&message_template->head_template, '\r');
+        wrote_all &= aws_byte_buf_write_u8(&message_template->head_template, '\n');
+    }
+
+    wrote_all &= aws_byte_buf_write_u8(&message_template->head_template, '\r');
+    wrote_all &= aws_byte_buf_write_u8(&message_template->head_template, '\n');
+    (void)wrote_all;
+    AWS_ASSERT(wrote_all);
+
+    return AWS_OP_SUCCESS;
+error:
+    aws_h1_encoder_message_template_clean_up(message_template);
+    return AWS_OP_ERR;
+}
+
+int aws_h1_encoder_message_init_from_template(
+    struct aws_h1_encoder_message *message,
+    struct aws_allocator *allocator,
+    const struct aws_h1_encoder_message_template *message_template,
+    const struct aws_byte_cursor *variable_header_values,
+    size_t variable_header_count,
+    struct aws_input_stream *body) {
+
     AWS_ZERO_STRUCT(*message);
+
+    const size_t slot_count = aws_array_list_length(&message_template->variable_slots);
+    if (variable_header_count != slot_count) {
+        AWS_LOGF_ERROR(AWS_LS_HTTP_STREAM, "id=static: Value count does not match template's variable header count");
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    message->body = body;
+    message->content_length = message_template->content_length;
+    message->has_connection_close_header = message_template->has_connection_close_header;
+    message->has_chunked_encoding_header = message_template->has_chunked_encoding_header;
+    message->has_expect_continue_header = message_template->has_expect_continue_header;
+
+    size_t head_total_len = message_template->head_template.len;
+    int err = 0;
+    for (size_t i = 0; i < slot_count; ++i) {
+        err |= aws_add_size_checked(variable_header_values[i].len, head_total_len, &head_total_len);
+    }
+    if (err) {
+        return AWS_OP_ERR;
+    }
+
+    if (aws_byte_buf_init(&message->outgoing_head_buf, allocator, head_total_len)) {
+        return AWS_OP_ERR;
+    }
+
+    /*
+     * Stitch the head together: cached bytes up to each slot, then that slot's value.
+     */
+    size_t template_pos = 0;
+    bool wrote_all = true;
+    for (size_t i = 0; i < slot_count; ++i) {
+        struct aws_h1_encoder_template_slot slot;
+        AWS_ZERO_STRUCT(slot);
+        aws_array_list_get_at(&message_template->variable_slots, &slot, i);
+
+        wrote_all &= aws_byte_buf_write(
+            &message->outgoing_head_buf,
+            message_template->head_template.buffer + template_pos,
+            slot.offset - template_pos);
+        wrote_all &= aws_byte_buf_write_from_whole_cursor(&message->outgoing_head_buf, variable_header_values[i]);
+        template_pos = slot.offset;
+
+        if (slot.name_enum == AWS_HTTP_HEADER_CONTENT_LENGTH) {
+            struct aws_byte_cursor trimmed_value = aws_strutil_trim_http_whitespace(variable_header_values[i]);
+            if (aws_strutil_read_unsigned_num(trimmed_value, &message->content_length)) {
+                AWS_LOGF_ERROR(AWS_LS_HTTP_STREAM, "id=static: Invalid Content-Length");
+                aws_raise_error(AWS_ERROR_HTTP_INVALID_HEADER_VALUE);
+                goto error;
+            }
+        }
+    }
+
+    wrote_all &= aws_byte_buf_write(
+        &message->outgoing_head_buf,
+        message_template->head_template.buffer + template_pos,
+        message_template->head_template.len - template_pos);
+    (void)wrote_all;
+    AWS_ASSERT(wrote_all);
+
+    if ((message->has_chunked_encoding_header || message->content_length > 0) && !message->body) {
+        aws_raise_error(AWS_ERROR_HTTP_MISSING_BODY_STREAM);
+        goto error;
+    }
+
+    return AWS_OP_SUCCESS;
+error:
+    aws_h1_encoder_message_clean_up(message);
+    return AWS_OP_ERR;
+}
+
+void aws_h1_encoder_message_template_clean_up(struct aws_h1_encoder_message_template *message_template) {
+    aws_byte_buf_clean_up(&message_template->head_template);
+    aws_array_list_clean_up(&message_template->variable_slots);
+    AWS_ZERO_STRUCT(*message_template);
 }
 
 void aws_h1_encoder_init(struct aws_h1_encoder *encoder, struct aws_allocator *allocator) {
@@ -315,7 +743,88 @@ int aws_h1_encoder_start_message(
     encoder->message = message;
     encoder->state = AWS_H1_ENCODER_STATE_HEAD;
     encoder->progress_bytes = 0;
+    encoder->body_segment_index = 0;
+    encoder->body_segment_progress = 0;
+
+    return AWS_OP_SUCCESS;
+}
+
+static bool s_message_has_body(const struct aws_h1_encoder_message *message) {
+    return message->body || message->has_body_segments;
+}
+
+/* Pull body bytes into dst, from either the message's single body stream or, for a vectored
+ * body, from each segment in order. Cursor segments are written straight from the caller's
+ * memory; stream segments are read until they report end-of-stream, then the encoder moves to
+ * the next segment. Sets *out_end_of_body once no further bytes will ever be produced. */
+static int s_encoder_read_body(struct aws_h1_encoder *encoder, struct aws_byte_buf *dst, bool *out_end_of_body) {
+
+    struct aws_h1_encoder_message *message = encoder->message;
+    *out_end_of_body = false;
+
+    if (!message->has_body_segments) {
+        const size_t prev_len = dst->len;
+        if (aws_input_stream_read(message->body, dst)) {
+            return AWS_OP_ERR;
+        }
+        if (dst->len == prev_len) {
+            struct aws_stream_status status;
+            if (aws_input_stream_get_status(message->body, &status)) {
+                return AWS_OP_ERR;
+            }
+            *out_end_of_body = status.is_end_of_stream;
+        }
+        return AWS_OP_SUCCESS;
+    }
 
+    const size_t num_segments = aws_array_list_length(&message->body_segments);
+    while (encoder->body_segment_index < num_segments) {
+        struct aws_http_body_segment *segment = NULL;
+        aws_array_list_get_at_ptr(&message->body_segments, (void **)&segment, encoder->body_segment_index);
+        AWS_ASSUME(segment);
+
+        if (segment->type == AWS_HTTP_BODY_SEGMENT_CURSOR) {
+            /* Borrowed bytes: write the caller's memory directly, no intermediate stream */
+            struct aws_byte_cursor remaining = segment->cursor;
+            aws_byte_cursor_advance(&remaining, encoder->body_segment_progress);
+
+            const size_t dst_available = dst->capacity - dst->len;
+            if (remaining.len > dst_available) {
+                remaining.len = dst_available;
+            }
+
+            aws_byte_buf_write_from_whole_cursor(dst, remaining);
+            encoder->body_segment_progress += remaining.len;
+
+            if (encoder->body_segment_progress < segment->cursor.len) {
+                /* dst is full, rest of this segment goes in the next message */
+                return AWS_OP_SUCCESS;
+            }
+        } else {
+            const size_t prev_len = dst->len;
+            if (aws_input_stream_read(segment->stream, dst)) {
+                return AWS_OP_ERR;
+            }
+            if (dst->len > prev_len || dst->len == dst->capacity) {
+                return AWS_OP_SUCCESS;
+            }
+
+            struct aws_stream_status status;
+            if (aws_input_stream_get_status(segment->stream, &status)) {
+                return AWS_OP_ERR;
+            }
+            if (!status.is_end_of_stream) {
+                /* This segment's data isn't ready yet */
+                return AWS_OP_SUCCESS;
+            }
+        }
+
+        /* Segment exhausted, on to the next */
+        encoder->body_segment_index++;
+        encoder->body_segment_progress = 0;
+    }
+
+    *out_end_of_body = true;
     return AWS_OP_SUCCESS;
 }
 
@@ -362,14 +871,29 @@ int aws_h1_encoder_process(struct aws_h1_encoder *encoder, struct aws_byte_buf *
             aws_byte_buf_clean_up(&encoder->message->outgoing_head_buf);
 
             encoder->progress_bytes = 0;
-            encoder->state++;
+
+            if (encoder->message->has_expect_continue_header &&
+                (encoder->message->has_chunked_encoding_header ||
+                 (s_message_has_body(encoder->message) && encoder->message->content_length))) {
+                ENCODER_LOG(TRACE, encoder, "Head sent, withholding body until interim 100 response.");
+                encoder->state = AWS_H1_ENCODER_STATE_WAIT_FOR_CONTINUE;
+            } else {
+                encoder->state = AWS_H1_ENCODER_STATE_BODY;
+            }
         }
     }
 
+    if (encoder->state == AWS_H1_ENCODER_STATE_WAIT_FOR_CONTINUE) {
+        /* Nothing to write until the connection hears back from the server */
+        return AWS_OP_SUCCESS;
+    }
+
     if (encoder->state == AWS_H1_ENCODER_STATE_BODY) {
-        if (!encoder->message->body || !encoder->message->content_length) {
+        if (encoder->message->has_chunked_encoding_header) {
+            encoder->state = AWS_H1_ENCODER_STATE_CHUNKED_BODY;
+        } else if (!s_message_has_body(encoder->message) || !encoder->message->content_length) {
             ENCODER_LOG(TRACE, encoder, "Skipping body")
-            encoder->state++;
+            encoder->state = AWS_H1_ENCODER_STATE_DONE;
         } else {
             while (true) {
                 if (dst->capacity == dst->len) {
@@ -381,7 +905,8 @@ int aws_h1_encoder_process(struct aws_h1_encoder *encoder, struct aws_byte_buf *
                 }
 
                 const size_t prev_len = dst->len;
-                int err = aws_input_stream_read(encoder->message->body, dst);
+                bool end_of_body = false;
+                int err = s_encoder_read_body(encoder, dst, &end_of_body);
                 const size_t amount_read = dst->len - prev_len;
 
                 if (err) {
@@ -412,26 +937,14 @@ int aws_h1_encoder_process(struct aws_h1_encoder *encoder, struct aws_byte_buf *
                 if (encoder->progress_bytes == encoder->message->content_length) {
                     ENCODER_LOG(TRACE, encoder, "Done sending body.");
                     encoder->progress_bytes = 0;
-                    encoder->state++;
+                    encoder->state = AWS_H1_ENCODER_STATE_DONE;
                     break;
                 }
 
                 /* Return if user failed to write anything. Maybe their data isn't ready yet. */
                 if (amount_read == 0) {
                     /* Ensure we're not at end-of-stream too early */
-                    struct aws_stream_status status;
-                    err = aws_input_stream_get_status(encoder->message->body, &status);
-                    if (err) {
-                        ENCODER_LOGF(
-                            TRACE,
-                            encoder,
-                            "Failed to query body stream status, error %d (%s)",
-                            aws_last_error(),
-                            aws_error_name(aws_last_error()));
-
-                        return AWS_OP_ERR;
-                    }
-                    if (status.is_end_of_stream) {
+                    if (end_of_body) {
                         ENCODER_LOGF(
                             ERROR,
                             encoder,
@@ -451,6 +964,110 @@ int aws_h1_encoder_process(struct aws_h1_encoder *encoder, struct aws_byte_buf *
         }
     }
 
+    if (encoder->state == AWS_H1_ENCODER_STATE_CHUNKED_BODY) {
+        while (true) {
+            /* A chunk is framed as: "{hex-size}\r\n{data}\r\n".
+             * The size is written with a fixed number of hex digits (leading zeros are legal
+             * per the 1*HEXDIG grammar in RFC-7230 Section 4.1), so the chunk header can be
+             * reserved before we know how much the body stream will deliver, and the data
+             * streams directly into its final position with no copying. */
+            size_t space_available = dst->capacity - dst->len;
+            if (space_available < CHUNK_MIN_SPACE) {
+                ENCODER_LOG(TRACE, encoder, "Cannot fit a chunk in this message");
+
+                /* Return success because we want to try again later */
+                return AWS_OP_SUCCESS;
+            }
+
+            size_t max_chunk_size = space_available - CHUNK_OVERHEAD;
+            if (max_chunk_size > UINT32_MAX) {
+                /* Size must fit in the fixed-width hex digits */
+                max_chunk_size = UINT32_MAX;
+            }
+
+            const size_t chunk_start = dst->len;
+
+            /* Read body bytes directly into the data section of the reserved chunk */
+            struct aws_byte_buf chunk_data_buf = {
+                .buffer = dst->buffer + chunk_start + CHUNK_SIZE_HEX_DIGITS + 2,
+                .capacity = max_chunk_size,
+            };
+            bool end_of_body = false;
+            int err = s_encoder_read_body(encoder, &chunk_data_buf, &end_of_body);
+            if (err) {
+                ENCODER_LOGF(
+                    ERROR,
+                    encoder,
+                    "Failed to read body stream, error %d (%s)",
+                    aws_last_error(),
+                    aws_error_name(aws_last_error()));
+
+                return AWS_OP_ERR;
+            }
+
+            const size_t amount_read = chunk_data_buf.len;
+            if (amount_read == 0) {
+                if (end_of_body) {
+                    ENCODER_LOG(TRACE, encoder, "Done sending chunked body.");
+                    encoder->progress_bytes = 0;
+                    encoder->state = AWS_H1_ENCODER_STATE_CHUNK_TERMINATOR;
+                    break;
+                }
+
+                ENCODER_LOG(
+                    TRACE,
+                    encoder,
+                    "No body data written, concluding this message. "
+                    "Will try to write body data again in the next message.");
+                return AWS_OP_SUCCESS;
+            }
+
+            /* Now that the size is known, fill in the reserved chunk header and commit the chunk */
+            char chunk_size_str[CHUNK_SIZE_HEX_DIGITS + 1];
+            snprintf(chunk_size_str, sizeof(chunk_size_str), "%08zX", amount_read);
+
+            bool wrote_all = true;
+            wrote_all &= aws_byte_buf_write(dst, (const uint8_t *)chunk_size_str, CHUNK_SIZE_HEX_DIGITS);
+            wrote_all &= aws_byte_buf_write_u8(dst, '\r');
+            wrote_all &= aws_byte_buf_write_u8(dst, '\n');
+            dst->len += amount_read;
+            wrote_all &= aws_byte_buf_write_u8(dst, '\r');
+            wrote_all &= aws_byte_buf_write_u8(dst, '\n');
+            (void)wrote_all;
+            AWS_ASSERT(wrote_all);
+
+            encoder->progress_bytes += amount_read;
+
+            ENCODER_LOGF(TRACE, encoder, "Writing chunk of %zu body bytes to message", amount_read);
+        }
+    }
+
+    if (encoder->state == AWS_H1_ENCODER_STATE_CHUNK_TERMINATOR) {
+        /* last-chunk: "0\r\n" followed by empty trailer-part: "\r\n" */
+        struct aws_byte_cursor terminator = aws_byte_cursor_from_c_str("0\r\n\r\n");
+        const size_t terminator_len = terminator.len;
+
+        /* Advance cursor if some bytes already written */
+        aws_byte_cursor_advance(&terminator, (size_t)encoder->progress_bytes);
+
+        /* Shorten cursor if it won't all fit in dst */
+        size_t space_available = dst->capacity - dst->len;
+        if (terminator.len > space_available) {
+            terminator.len = space_available;
+        }
+
+        aws_byte_buf_write_from_whole_cursor(dst, terminator);
+        encoder->progress_bytes += terminator.len;
+
+        if (encoder->progress_bytes == terminator_len) {
+            encoder->progress_bytes = 0;
+            encoder->state = AWS_H1_ENCODER_STATE_DONE;
+        } else {
+            /* Return success because we want to try again later */
+            return AWS_OP_SUCCESS;
+        }
+    }
+
     if (encoder->state == AWS_H1_ENCODER_STATE_DONE) {
         ENCODER_LOG(TRACE, encoder, "Done sending data.");
 
@@ -463,3 +1080,22 @@ int aws_h1_encoder_process(struct aws_h1_encoder *encoder, struct aws_byte_buf *
 bool aws_h1_encoder_is_message_in_progress(const struct aws_h1_encoder *encoder) {
     return encoder->message;
 }
+
+bool aws_h1_encoder_is_waiting_for_continue(const struct aws_h1_encoder *encoder) {
+    return encoder->state == AWS_H1_ENCODER_STATE_WAIT_FOR_CONTINUE;
+}
+
+void aws_h1_encoder_continue_message(struct aws_h1_encoder *encoder) {
+    AWS_PRECONDITION(encoder->state == AWS_H1_ENCODER_STATE_WAIT_FOR_CONTINUE);
+
+    ENCODER_LOG(TRACE, encoder, "Releasing withheld body.");
+    encoder->state = AWS_H1_ENCODER_STATE_BODY;
+}
+
+void aws_h1_encoder_abandon_waiting_body(struct aws_h1_encoder *encoder) {
+    AWS_PRECONDITION(encoder->state == AWS_H1_ENCODER_STATE_WAIT_FOR_CONTINUE);
+
+    ENCODER_LOG(TRACE, encoder, "Abandoning withheld body, message will finish without it.");
+    encoder->progress_bytes = 0;
+    encoder->state = AWS_H1_ENCODER_STATE_DONE;
+}
@@ -15,6 +15,8 @@
 #include <aws/http/private/h1_stream.h>
 
 #include <aws/http/private/connection_impl.h>
+
+#include <aws/common/clock.h>
 #include <aws/io/logging.h>
 
 static void s_stream_destroy(struct aws_http_stream *stream_base) {
@@ -22,7 +24,10 @@ static void s_stream_destroy(struct aws_http_stream *stream_base) {
 
     aws_h1_encoder_message_clean_up(&stream->encoder_message);
     aws_byte_buf_clean_up(&stream->incoming_storage_buf);
-    aws_mem_release(stream->base.alloc, stream);
+
+    /* Park the allocation for the connection's next stream. The connection is guaranteed to
+     * outlive this stream, so the pool is still valid even if this is the final user release. */
+    aws_http_stream_pool_release(&stream->base.owning_connection->stream_pool, stream);
 }
 
 static void s_stream_update_window(struct aws_http_stream *stream, size_t increment_size) {
@@ -43,7 +48,7 @@ static struct aws_h1_stream *s_stream_new_common(
     aws_http_on_incoming_body_fn *on_incoming_body,
     aws_http_on_stream_complete_fn on_complete) {
 
-    struct aws_h1_stream *stream = aws_mem_calloc(owning_connection->alloc, 1, sizeof(struct aws_h1_stream));
+    struct aws_h1_stream *stream = aws_http_stream_pool_acquire(&owning_connection->stream_pool);
     if (!stream) {
         return NULL;
     }
@@ -61,6 +66,9 @@ static struct aws_h1_stream *s_stream_new_common(
     /* Stream refcount starts at 2. 1 for user and 1 for connection to release it's done with the stream */
     aws_atomic_init_int(&stream->base.refcount, 2);
 
+    /* Same clock the channel uses, so the other metric timestamps are comparable */
+    aws_high_res_clock_get_ticks(&stream->base.metrics.activated_timestamp_ns);
+
     return stream;
 }
 
@@ -80,6 +88,9 @@ struct aws_h1_stream *aws_h1_stream_new_request(
         return NULL;
     }
 
+    stream->base.on_incoming_trailers = options->on_incoming_trailers;
+    stream->base.incoming_body_sink = options->response_body_sink;
+
     /* Transform request if necessary */
     if (client_connection->proxy_request_transform) {
         if (client_connection->proxy_request_transform(options->request, client_connection->user_data)) {
@@ -90,9 +101,17 @@ struct aws_h1_stream *aws_h1_stream_new_request(
     stream->base.client_data = &stream->base.client_or_server_data.client;
     stream->base.client_data->response_status = AWS_HTTP_STATUS_UNKNOWN;
 
-    /* Validate request and cache info that the encoder will eventually need */
-    int err =
-        aws_h1_encoder_message_init_from_request(&stream->encoder_message, client_connection->alloc, options->request);
+    stream->response_first_byte_timeout_ms = options->response_first_byte_timeout_ms;
+    stream->response_timeout_ms = options->response_timeout_ms;
+    stream->expect_100_continue_timeout_ms = options->expect_100_continue_timeout_ms;
+
+    /* Validate request and cache info that the encoder will eventually need.
+     * The head buffer is carved from the stream's own allocation when it fits, so the
+     * typical request needs no further allocations past this point. */
+    struct aws_byte_buf head_storage =
+        aws_byte_buf_from_empty_array(stream->outgoing_head_storage, sizeof(stream->outgoing_head_storage));
+    int err = aws_h1_encoder_message_init_from_request(
+        &stream->encoder_message, client_connection->alloc, options->request, &head_storage);
     if (err) {
         goto error;
     }
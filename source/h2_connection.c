@@ -14,9 +14,16 @@
  */
 
 #include <aws/http/private/h2_connection.h>
-#include <aws/http/private/h2_decoder.h>
+#include <aws/http/private/h2_stream.h>
+#include <aws/http/private/request_response_impl.h>
+#include <aws/http/private/strutil.h>
 
+#include <aws/common/clock.h>
 #include <aws/common/logging.h>
+#include <aws/io/channel.h>
+#include <aws/io/stream.h>
+
+#include <inttypes.h>
 
 #if _MSC_VER
 #    pragma warning(disable : 4204) /* non-constant aggregate initializer */
@@ -29,38 +36,297 @@
 /* Stream IDs are only 31 bits [5.1.1] */
 static const uint32_t MAX_STREAM_ID = UINT32_MAX >> 1;
 
+/* Client connection preface [RFC-7540 3.5] */
+static const char *s_connection_preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+enum {
+    /* Bytes of frame header preceding every frame's payload [RFC-7540 4.1] */
+    FRAME_PREFIX_SIZE = 9,
+
+    /* Room for one max-size frame, plus slack for frame prefixes and control frames */
+    MESSAGE_SIZE_HINT = FRAME_PREFIX_SIZE + AWS_H2_DEFAULT_MAX_FRAME_SIZE + 1024,
+
+    /* Byte credit earned per unit of stream weight each scheduler pass.
+     * A default-weight (16) stream earns 1KB per pass; a max-weight (256) stream earns
+     * a full default-max-size frame. */
+    DATA_SCHEDULER_QUANTUM = 64,
+
+    /* Don't let an idle stream bank more than one max-size frame of credit */
+    DATA_SCHEDULER_MAX_DEFICIT = AWS_H2_DEFAULT_MAX_FRAME_SIZE,
+
+    /* Receive windows start at the RFC default and are auto-tuned from there [RFC-7540 6.5.2] */
+    INITIAL_WINDOW_TARGET = 65535,
+
+    /* Never advertise more than this, no matter what the link measures */
+    MAX_WINDOW_TARGET = 16 * 1024 * 1024,
+
+    /* Keepalive PINGs are declared lost after this long if the caller didn't pick a timeout */
+    DEFAULT_PING_TIMEOUT_MS = 3000,
+};
+
+/* A WINDOW_UPDATE the read path owes the peer, flushed by the outgoing-frames task */
+struct aws_h2_pending_window_update {
+    uint32_t stream_id; /* 0 for the connection itself */
+    uint32_t window_size_increment;
+};
+
+static int s_handler_process_read_message(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_io_message *message);
+
+static int s_handler_process_write_message(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_io_message *message);
+
+static int s_handler_increment_read_window(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    size_t size);
+
+static int s_handler_shutdown(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    enum aws_channel_direction dir,
+    int error_code,
+    bool free_scarce_resources_immediately);
+
+static size_t s_handler_initial_window_size(struct aws_channel_handler *handler);
+static size_t s_handler_message_overhead(struct aws_channel_handler *handler);
+static void s_handler_destroy(struct aws_channel_handler *handler);
+static struct aws_http_stream *s_make_request(
+    struct aws_http_connection *client_connection,
+    const struct aws_http_make_request_options *options);
+static void s_connection_close(struct aws_http_connection *connection_base);
+static bool s_connection_is_open(const struct aws_http_connection *connection_base);
+static void s_connection_update_window(struct aws_http_connection *connection_base, size_t increment_size);
+static bool s_connection_is_transfer_active(const struct aws_http_connection *connection_base);
+static void s_outgoing_frames_task(struct aws_channel_task *task, void *arg, enum aws_task_status status);
+static void s_keepalive_task(struct aws_channel_task *task, void *arg, enum aws_task_status status);
+
 static struct aws_http_connection_vtable s_h2_connection_vtable = {
     .channel_handler_vtable =
         {
-            .process_read_message = NULL,
-            .process_write_message = NULL,
-            .increment_read_window = NULL,
-            .shutdown = NULL,
-            .initial_window_size = NULL,
-            .message_overhead = NULL,
-            .destroy = NULL,
+            .process_read_message = s_handler_process_read_message,
+            .process_write_message = s_handler_process_write_message,
+            .increment_read_window = s_handler_increment_read_window,
+            .shutdown = s_handler_shutdown,
+            .initial_window_size = s_handler_initial_window_size,
+            .message_overhead = s_handler_message_overhead,
+            .destroy = s_handler_destroy,
         },
 
-    .make_request = NULL,
-    .new_server_request_handler_stream = NULL,
-    .stream_send_response = NULL,
-    .close = NULL,
-    .is_open = NULL,
-    .update_window = NULL,
+    .make_request = s_make_request,
+    .new_server_request_handler_stream = NULL, /* #TODO server-side h2 */
+    .stream_send_response = NULL,              /* #TODO server-side h2 */
+    .close = s_connection_close,
+    .is_open = s_connection_is_open,
+    .update_window = s_connection_update_window,
+    .is_transfer_active = s_connection_is_transfer_active,
+    .convert_to_midchannel_handler = NULL, /* h2 has no protocol upgrade */
 };
 
-static const struct aws_h2_decoder_vtable s_h2_decoder_vtable = {
-    .on_data = NULL,
-};
+static void s_h2_connection_lock_synced_data(struct aws_h2_connection *connection) {
+    int err = aws_mutex_lock(&connection->synced_data.lock);
+    AWS_ASSERT(!err);
+    (void)err;
+}
+
+static void s_h2_connection_unlock_synced_data(struct aws_h2_connection *connection) {
+    int err = aws_mutex_unlock(&connection->synced_data.lock);
+    AWS_ASSERT(!err);
+    (void)err;
+}
+
+/**
+ * Internal function for bringing connection to a stop.
+ * Invoked multiple times, including when:
+ * - Channel is shutting down in the read direction.
+ * - Channel is shutting down in the write direction.
+ * - An error occurs.
+ * - User wishes to close the connection (this is the only case where the function may run off-thread).
+ */
+static void s_stop(
+    struct aws_h2_connection *connection,
+    bool stop_reading,
+    bool stop_writing,
+    bool schedule_shutdown,
+    int error_code) {
+
+    AWS_ASSERT(stop_reading || stop_writing || schedule_shutdown); /* You are required to stop at least 1 thing */
+
+    if (stop_reading) {
+        AWS_ASSERT(aws_channel_thread_is_callers_thread(connection->base.channel_slot->channel));
+        connection->thread_data.is_reading_stopped = true;
+    }
+
+    if (stop_writing) {
+        AWS_ASSERT(aws_channel_thread_is_callers_thread(connection->base.channel_slot->channel));
+        connection->thread_data.is_writing_stopped = true;
+    }
+    { /* BEGIN CRITICAL SECTION */
+        s_h2_connection_lock_synced_data(connection);
+
+        /* Even if we're not scheduling shutdown just yet (ex: streams are still draining)
+         * we don't consider the connection "open" anymore so user can't create more streams */
+        connection->synced_data.new_stream_error_code = AWS_ERROR_HTTP_CONNECTION_CLOSED;
+        connection->synced_data.is_open = false;
+
+        s_h2_connection_unlock_synced_data(connection);
+    } /* END CRITICAL SECTION */
+
+    if (schedule_shutdown) {
+        CONNECTION_LOGF(
+            INFO,
+            &connection->base,
+            "Shutting down connection with error code %d (%s).",
+            error_code,
+            aws_error_name(error_code));
+
+        aws_channel_shutdown(connection->base.channel_slot->channel, error_code);
+    }
+}
+
+static void s_shutdown_due_to_error(struct aws_h2_connection *connection, int error_code) {
+    AWS_ASSERT(aws_channel_thread_is_callers_thread(connection->base.channel_slot->channel));
+
+    if (!error_code) {
+        error_code = AWS_ERROR_UNKNOWN;
+    }
+
+    /* Stop reading AND writing. A connection error is fatal to every stream multiplexed on it [RFC-7540 5.4.1] */
+    s_stop(connection, true /*stop_reading*/, true /*stop_writing*/, true /*schedule_shutdown*/, error_code);
+}
+
+/* After a graceful GOAWAY the connection lingers only for the streams the peer is still
+ * processing; once the last one completes there's nothing left to wait for. */
+static void s_shutdown_if_goaway_drained(struct aws_h2_connection *connection) {
+    if (!connection->thread_data.goaway_received || connection->thread_data.is_writing_stopped) {
+        return;
+    }
+
+    if (aws_hash_table_get_entry_count(&connection->thread_data.active_streams) > 0) {
+        return;
+    }
+
+    /* Clear the flag so repeat calls (ex: the stream-complete hook, then our caller) don't
+     * schedule shutdown twice */
+    connection->thread_data.goaway_received = false;
+
+    CONNECTION_LOG(INFO, &connection->base, "GOAWAY drain complete, shutting down connection.");
+    s_stop(connection, false /*stop_reading*/, false /*stop_writing*/, true /*schedule_shutdown*/, AWS_ERROR_SUCCESS);
+}
+
+/* Schedules the outgoing-frames task, unless it's already scheduled/running. Safe from any thread. */
+static void s_try_schedule_outgoing_frames_task(struct aws_h2_connection *connection) {
+    bool should_schedule_task = false;
+
+    { /* BEGIN CRITICAL SECTION */
+        s_h2_connection_lock_synced_data(connection);
+        if (!connection->synced_data.is_outgoing_frames_task_active) {
+            connection->synced_data.is_outgoing_frames_task_active = true;
+            should_schedule_task = true;
+        }
+        s_h2_connection_unlock_synced_data(connection);
+    } /* END CRITICAL SECTION */
+
+    if (should_schedule_task) {
+        CONNECTION_LOG(TRACE, &connection->base, "Scheduling outgoing frames task.");
+        aws_channel_schedule_task_now(connection->base.channel_slot->channel, &connection->outgoing_frames_task);
+    }
+}
+
+/* Fold one PING round-trip into the smoothed RTT that window_stats reports */
+static void s_record_rtt_sample(struct aws_h2_connection *connection, uint64_t rtt_ns) {
+    if (rtt_ns == 0) {
+        return;
+    }
+
+    { /* BEGIN CRITICAL SECTION */
+        s_h2_connection_lock_synced_data(connection);
+        const uint64_t smoothed_rtt_ns = connection->synced_data.window_stats.rtt_ns;
+        connection->synced_data.window_stats.rtt_ns =
+            smoothed_rtt_ns == 0 ? rtt_ns : (smoothed_rtt_ns * 7 + rtt_ns) / 8;
+        s_h2_connection_unlock_synced_data(connection);
+    } /* END CRITICAL SECTION */
+}
+
+/* Kick off periodic keepalive probing, if configured and not already running.
+ * Called on the channel thread the first time the connection shows any activity. */
+static void s_arm_keepalive_task(struct aws_h2_connection *connection) {
+    if (!connection->thread_data.ping_period_ns || connection->thread_data.is_keepalive_task_scheduled) {
+        return;
+    }
+
+    uint64_t now_ns = 0;
+    if (aws_channel_current_clock_time(connection->base.channel_slot->channel, &now_ns)) {
+        return;
+    }
+
+    connection->thread_data.is_keepalive_task_scheduled = true;
+    aws_channel_schedule_task_future(
+        connection->base.channel_slot->channel,
+        &connection->keepalive_task,
+        now_ns + connection->thread_data.ping_period_ns);
+}
+
+static void s_keepalive_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
+    struct aws_h2_connection *connection = arg;
+
+    if (status != AWS_TASK_STATUS_RUN_READY) {
+        return;
+    }
+
+    if (connection->thread_data.is_reading_stopped || connection->thread_data.is_writing_stopped) {
+        connection->thread_data.is_keepalive_task_scheduled = false;
+        return;
+    }
+
+    uint64_t now_ns = 0;
+    if (aws_channel_current_clock_time(connection->base.channel_slot->channel, &now_ns)) {
+        connection->thread_data.is_keepalive_task_scheduled = false;
+        return;
+    }
+
+    /* A probe that's been in flight longer than the timeout means the peer (or the path) is dead */
+    if (connection->thread_data.keepalive_ping_in_flight &&
+        now_ns - connection->thread_data.keepalive_ping_send_time_ns >= connection->thread_data.ping_timeout_ns) {
+
+        CONNECTION_LOGF(
+            ERROR,
+            &connection->base,
+            "Keepalive PING was not acknowledged within %" PRIu64 "ms, closing connection.",
+            aws_timestamp_convert(
+                connection->thread_data.ping_timeout_ns, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MILLIS, NULL));
+
+        connection->thread_data.is_keepalive_task_scheduled = false;
+        aws_raise_error(AWS_ERROR_HTTP_PING_TIMEOUT);
+        s_shutdown_due_to_error(connection, AWS_ERROR_HTTP_PING_TIMEOUT);
+        return;
+    }
+
+    if (!connection->thread_data.keepalive_ping_in_flight && !connection->thread_data.keepalive_ping_pending) {
+        connection->thread_data.keepalive_ping_pending = true;
+        s_try_schedule_outgoing_frames_task(connection);
+    }
+
+    /* Wake early enough to notice a missed ack promptly */
+    uint64_t delay_ns = connection->thread_data.ping_period_ns;
+    if (connection->thread_data.ping_timeout_ns < delay_ns) {
+        delay_ns = connection->thread_data.ping_timeout_ns;
+    }
+    aws_channel_schedule_task_future(connection->base.channel_slot->channel, task, now_ns + delay_ns);
+}
 
 /* Common new() logic for server & client */
 static struct aws_h2_connection *s_connection_new(
     struct aws_allocator *alloc,
     size_t initial_window_size,
+    uint64_t ping_period_ms,
+    uint64_t ping_timeout_ms,
     bool server) {
 
-    (void)server;
-
     struct aws_h2_connection *connection = aws_mem_calloc(alloc, 1, sizeof(struct aws_h2_connection));
     if (!connection) {
         goto error_connection_alloc;
@@ -75,17 +341,75 @@ static struct aws_h2_connection *s_connection_new(
 
     /* 1 refcount for user */
     aws_atomic_init_int(&connection->base.refcount, 1);
+    aws_atomic_init_int(&connection->base.is_draining, 0);
+
+    aws_http_stream_pool_init(&connection->base.stream_pool, alloc, sizeof(struct aws_h2_stream));
+
+    aws_channel_task_init(
+        &connection->outgoing_frames_task, s_outgoing_frames_task, connection, "http2_outgoing_frames");
+    aws_channel_task_init(&connection->keepalive_task, s_keepalive_task, connection, "http2_keepalive");
+
+    if (ping_period_ms) {
+        connection->thread_data.ping_period_ns =
+            aws_timestamp_convert(ping_period_ms, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL);
+        connection->thread_data.ping_timeout_ns = aws_timestamp_convert(
+            ping_timeout_ms ? ping_timeout_ms : DEFAULT_PING_TIMEOUT_MS,
+            AWS_TIMESTAMP_MILLIS,
+            AWS_TIMESTAMP_NANOS,
+            NULL);
+    }
+
+    /* Start the keepalive counter far from the BDP counter so the two PING payloads never collide */
+    connection->thread_data.keepalive_ping_counter = UINT64_MAX / 2;
 
     /* Init the next stream id (server must use odd ids, client even [RFC 7540 5.1.1])*/
     connection->synced_data.next_stream_id = (server ? 2 : 1);
+    connection->synced_data.is_open = true;
+    aws_linked_list_init(&connection->synced_data.pending_stream_list);
 
-    /* Create a new decoder */
-    struct aws_h2_decoder_params params = {
-        .alloc = alloc,
-        .user_data = connection,
-        .vtable = s_h2_decoder_vtable,
-    };
-    connection->thread_data.decoder = aws_h2_decoder_new(&params);
+    aws_linked_list_init(&connection->thread_data.outgoing_streams);
+
+    /* Until the peer's SETTINGS arrive, assume the default limits [RFC-7540 6.5.2] */
+    connection->thread_data.remote_max_frame_size = AWS_H2_DEFAULT_MAX_FRAME_SIZE;
+
+    connection->thread_data.window_target = INITIAL_WINDOW_TARGET;
+    connection->thread_data.connection_window_advertised = INITIAL_WINDOW_TARGET;
+    connection->synced_data.window_stats.window_target = INITIAL_WINDOW_TARGET;
+
+    if (aws_h2_frame_decoder_init(&connection->thread_data.frame_decoder, alloc)) {
+        CONNECTION_LOG(ERROR, connection, "static: Failed to initialize frame decoder");
+        goto error_decoder;
+    }
+
+    if (aws_h2_frame_encoder_init(&connection->thread_data.frame_encoder, alloc)) {
+        CONNECTION_LOG(ERROR, connection, "static: Failed to initialize frame encoder");
+        goto error_encoder;
+    }
+    /* Huffman-code each header string only when it actually shrinks */
+    connection->thread_data.frame_encoder.huffman_mode = AWS_H2_HUFFMAN_MODE_AUTO;
+
+    if (aws_hash_table_init(
+            &connection->thread_data.active_streams, alloc, 8, aws_hash_ptr, aws_ptr_eq, NULL, NULL)) {
+        goto error_streams_map;
+    }
+
+    /* We only advertise the default max frame size, so any legal incoming frame fits here */
+    if (aws_byte_buf_init(
+            &connection->thread_data.frame_assembly_buf, alloc, FRAME_PREFIX_SIZE + AWS_H2_DEFAULT_MAX_FRAME_SIZE)) {
+        goto error_assembly_buf;
+    }
+
+    if (aws_byte_buf_init(&connection->thread_data.encode_scratch_buf, alloc, AWS_H2_DEFAULT_MAX_FRAME_SIZE)) {
+        goto error_scratch_buf;
+    }
+
+    if (aws_array_list_init_dynamic(
+            &connection->thread_data.pending_window_updates,
+            alloc,
+            8,
+            sizeof(struct aws_h2_pending_window_update))) {
+        goto error_window_updates;
+    }
 
     int err = aws_mutex_init(&connection->synced_data.lock);
     if (err) {
@@ -98,6 +422,19 @@ static struct aws_h2_connection *s_connection_new(
     return connection;
 
 error_mutex:
+    aws_array_list_clean_up(&connection->thread_data.pending_window_updates);
+error_window_updates:
+    aws_byte_buf_clean_up(&connection->thread_data.encode_scratch_buf);
+error_scratch_buf:
+    aws_byte_buf_clean_up(&connection->thread_data.frame_assembly_buf);
+error_assembly_buf:
+    aws_hash_table_clean_up(&connection->thread_data.active_streams);
+error_streams_map:
+    aws_h2_frame_encoder_clean_up(&connection->thread_data.frame_encoder);
+error_encoder:
+    aws_h2_frame_decoder_clean_up(&connection->thread_data.frame_decoder);
+error_decoder:
+    aws_http_stream_pool_clean_up(&connection->base.stream_pool);
     aws_mem_release(alloc, connection);
 error_connection_alloc:
     return NULL;
@@ -107,7 +444,8 @@ struct aws_http_connection *aws_http_connection_new_http2_server(
     struct aws_allocator *allocator,
     size_t initial_window_size) {
 
-    struct aws_h2_connection *connection = s_connection_new(allocator, initial_window_size, true);
+    struct aws_h2_connection *connection =
+        s_connection_new(allocator, initial_window_size, 0 /*ping_period_ms*/, 0 /*ping_timeout_ms*/, true);
     if (!connection) {
         return NULL;
     }
@@ -119,9 +457,12 @@ struct aws_http_connection *aws_http_connection_new_http2_server(
 
 struct aws_http_connection *aws_http_connection_new_http2_client(
     struct aws_allocator *allocator,
-    size_t initial_window_size) {
+    size_t initial_window_size,
+    uint64_t ping_period_ms,
+    uint64_t ping_timeout_ms) {
 
-    struct aws_h2_connection *connection = s_connection_new(allocator, initial_window_size, false);
+    struct aws_h2_connection *connection =
+        s_connection_new(allocator, initial_window_size, ping_period_ms, ping_timeout_ms, false);
     if (!connection) {
         return NULL;
     }
@@ -136,8 +477,7 @@ uint32_t aws_h2_connection_get_next_stream_id(struct aws_h2_connection *connecti
     uint32_t next_id = 0;
 
     { /* BEGIN CRITICAL SECTION */
-        int err = aws_mutex_lock(&connection->synced_data.lock);
-        AWS_FATAL_ASSERT(err == AWS_OP_SUCCESS);
+        s_h2_connection_lock_synced_data(connection);
 
         next_id = connection->synced_data.next_stream_id;
         connection->synced_data.next_stream_id += 2;
@@ -150,9 +490,1337 @@ uint32_t aws_h2_connection_get_next_stream_id(struct aws_h2_connection *connecti
             aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
         }
 
-        err = aws_mutex_unlock(&connection->synced_data.lock);
-        AWS_FATAL_ASSERT(err == AWS_OP_SUCCESS);
+        s_h2_connection_unlock_synced_data(connection);
     } /* END CRITICAL SECTION */
 
     return next_id;
 }
+
+void aws_h2_connection_get_window_stats(
+    struct aws_http_connection *connection_base,
+    struct aws_http2_window_stats *out_stats) {
+
+    AWS_ASSERT(connection_base->http_version == AWS_HTTP_VERSION_2);
+    struct aws_h2_connection *connection = AWS_CONTAINER_OF(connection_base, struct aws_h2_connection, base);
+
+    { /* BEGIN CRITICAL SECTION */
+        s_h2_connection_lock_synced_data(connection);
+        *out_stats = connection->synced_data.window_stats;
+        s_h2_connection_unlock_synced_data(connection);
+    } /* END CRITICAL SECTION */
+}
+
+/**
+ * Public function for closing connection.
+ */
+static void s_connection_close(struct aws_http_connection *connection_base) {
+    struct aws_h2_connection *connection = AWS_CONTAINER_OF(connection_base, struct aws_h2_connection, base);
+
+    /* Don't stop reading/writing immediately, let that happen naturally during the channel shutdown process. */
+    s_stop(connection, false /*stop_reading*/, false /*stop_writing*/, true /*schedule_shutdown*/, AWS_ERROR_SUCCESS);
+}
+
+static bool s_connection_is_open(const struct aws_http_connection *connection_base) {
+    struct aws_h2_connection *connection = AWS_CONTAINER_OF(connection_base, struct aws_h2_connection, base);
+    bool is_open;
+
+    { /* BEGIN CRITICAL SECTION */
+        s_h2_connection_lock_synced_data(connection);
+        is_open = connection->synced_data.is_open;
+        s_h2_connection_unlock_synced_data(connection);
+    } /* END CRITICAL SECTION */
+
+    return is_open;
+}
+
+/* Queried by the connection monitor, on the channel thread, to tell a stalled transfer from an idle connection. */
+static bool s_connection_is_transfer_active(const struct aws_http_connection *connection_base) {
+    struct aws_h2_connection *connection = AWS_CONTAINER_OF(connection_base, struct aws_h2_connection, base);
+    AWS_ASSERT(aws_channel_thread_is_callers_thread(connection_base->channel_slot->channel));
+
+    return aws_hash_table_get_entry_count(&connection->thread_data.active_streams) > 0;
+}
+
+static void s_connection_update_window(struct aws_http_connection *connection_base, size_t increment_size) {
+    /* The channel read window is auto-incremented as messages are processed.
+     * #TODO h2 flow-control WINDOW_UPDATE frames (connection and per-stream). */
+    CONNECTION_LOGF(
+        TRACE,
+        connection_base,
+        "Ignoring window update of %zu, h2 flow-control windows are not wired up yet.",
+        increment_size);
+}
+
+static struct aws_http_stream *s_make_request(
+    struct aws_http_connection *client_connection,
+    const struct aws_http_make_request_options *options) {
+
+    struct aws_h2_stream *stream = aws_h2_stream_new(client_connection, options);
+    if (!stream) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_CONNECTION,
+            "id=%p: Cannot create request stream, error %d (%s)",
+            (void *)client_connection,
+            aws_last_error(),
+            aws_error_name(aws_last_error()));
+
+        return NULL;
+    }
+
+    struct aws_h2_connection *connection = AWS_CONTAINER_OF(client_connection, struct aws_h2_connection, base);
+
+    /* Insert new stream into pending list, and schedule outgoing_frames_task if it's not already running. */
+    int new_stream_error_code = AWS_ERROR_SUCCESS;
+    bool should_schedule_task = false;
+
+    { /* BEGIN CRITICAL SECTION */
+        s_h2_connection_lock_synced_data(connection);
+
+        if (connection->synced_data.new_stream_error_code) {
+            new_stream_error_code = connection->synced_data.new_stream_error_code;
+        } else {
+            aws_linked_list_push_back(&connection->synced_data.pending_stream_list, &stream->node);
+            if (!connection->synced_data.is_outgoing_frames_task_active) {
+                connection->synced_data.is_outgoing_frames_task_active = true;
+                should_schedule_task = true;
+            }
+        }
+
+        s_h2_connection_unlock_synced_data(connection);
+    } /* END CRITICAL SECTION */
+
+    if (new_stream_error_code) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_CONNECTION,
+            "id=%p: Cannot create request stream, error %d (%s)",
+            (void *)client_connection,
+            new_stream_error_code,
+            aws_error_name(new_stream_error_code));
+
+        aws_raise_error(new_stream_error_code);
+        goto error;
+    }
+
+    /* Success! */
+    struct aws_byte_cursor method;
+    aws_http_message_get_request_method(options->request, &method);
+    stream->base.request_method = aws_http_str_to_method(method);
+    struct aws_byte_cursor path;
+    aws_http_message_get_request_path(options->request, &path);
+    AWS_LOGF_DEBUG(
+        AWS_LS_HTTP_STREAM,
+        "id=%p: Created client request on connection=%p: " PRInSTR " " PRInSTR " " PRInSTR,
+        (void *)&stream->base,
+        (void *)client_connection,
+        AWS_BYTE_CURSOR_PRI(method),
+        AWS_BYTE_CURSOR_PRI(path),
+        AWS_BYTE_CURSOR_PRI(aws_http_version_to_str(connection->base.http_version)));
+
+    if (should_schedule_task) {
+        CONNECTION_LOG(TRACE, &connection->base, "Scheduling outgoing frames task.");
+        aws_channel_schedule_task_now(connection->base.channel_slot->channel, &connection->outgoing_frames_task);
+    }
+
+    return &stream->base;
+
+error:
+    /* Force destruction of the stream, avoiding ref counting */
+    stream->base.vtable->destroy(&stream->base);
+    return NULL;
+}
+
+/* Stream is done on this connection. Fires on_complete and drops the connection's refcount on the stream.
+ * The stream must already be removed from the pending list if it was there. */
+static void s_stream_complete(struct aws_h2_connection *connection, struct aws_h2_stream *stream, int error_code) {
+    if (stream->thread_data.in_outgoing_list) {
+        aws_linked_list_remove(&stream->node);
+        stream->thread_data.in_outgoing_list = false;
+    }
+
+    /* No-op if the stream never made it into the map (ex: still pending at shutdown) */
+    aws_hash_table_remove(&connection->thread_data.active_streams, (void *)(size_t)stream->id, NULL, NULL);
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_HTTP_STREAM,
+        "id=%p: Stream complete with error code %d (%s).",
+        (void *)&stream->base,
+        error_code,
+        aws_error_name(error_code));
+
+    if (stream->base.metrics.complete_timestamp_ns == 0) {
+        aws_high_res_clock_get_ticks(&stream->base.metrics.complete_timestamp_ns);
+    }
+
+    if (stream->base.on_complete) {
+        stream->base.on_complete(&stream->base, error_code, stream->base.user_data);
+    }
+
+    aws_http_stream_release(&stream->base);
+
+    s_shutdown_if_goaway_drained(connection);
+}
+
+/***********************************************************************************************************************
+ * Outgoing frames
+ **********************************************************************************************************************/
+
+/* Move any streams the user created since the last run into the active map and outgoing list */
+static int s_move_pending_streams(struct aws_h2_connection *connection) {
+    struct aws_linked_list pending;
+    aws_linked_list_init(&pending);
+
+    { /* BEGIN CRITICAL SECTION */
+        s_h2_connection_lock_synced_data(connection);
+        aws_linked_list_swap_contents(&connection->synced_data.pending_stream_list, &pending);
+        s_h2_connection_unlock_synced_data(connection);
+    } /* END CRITICAL SECTION */
+
+    while (!aws_linked_list_empty(&pending)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&pending);
+        struct aws_h2_stream *stream = AWS_CONTAINER_OF(node, struct aws_h2_stream, node);
+
+        if (aws_hash_table_put(
+                &connection->thread_data.active_streams, (void *)(size_t)stream->id, stream, NULL /*was_created*/)) {
+
+            CONNECTION_LOG(ERROR, &connection->base, "Failed to insert stream into map");
+            s_stream_complete(connection, stream, aws_last_error());
+            return AWS_OP_ERR;
+        }
+
+        aws_linked_list_push_back(&connection->thread_data.outgoing_streams, &stream->node);
+        stream->thread_data.in_outgoing_list = true;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Write the connection preface magic and our initial SETTINGS [RFC-7540 3.5] */
+static int s_encode_connection_preface(struct aws_h2_connection *connection, struct aws_byte_buf *output) {
+    (void)connection;
+
+    if (!aws_byte_buf_write_from_whole_cursor(output, aws_byte_cursor_from_c_str(s_connection_preface))) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    /* We're a client and don't support PUSH_PROMISE, tell the server not to bother [RFC-7540 6.5.2] */
+    const struct aws_h2_frame_setting initial_settings[] = {
+        {.identifier = AWS_H2_SETTINGS_ENABLE_PUSH, .value = 0},
+    };
+
+    return aws_h2_frame_settings_encode_direct(
+        false /*ack*/, initial_settings, AWS_ARRAY_SIZE(initial_settings), output);
+}
+
+/* Write any control frames the read path has promised to the peer (SETTINGS ack, PING ack) */
+static int s_encode_pending_control_frames(struct aws_h2_connection *connection, struct aws_byte_buf *output) {
+    if (connection->thread_data.settings_ack_pending) {
+        if (aws_h2_frame_settings_encode_direct(true /*ack*/, NULL, 0, output)) {
+            return AWS_OP_ERR;
+        }
+
+        connection->thread_data.settings_ack_pending = false;
+        CONNECTION_LOG(TRACE, &connection->base, "Wrote SETTINGS ack.");
+    }
+
+    if (connection->thread_data.ping_ack_pending) {
+        if (aws_h2_frame_ping_encode_direct(true /*ack*/, connection->thread_data.ping_ack_payload, output)) {
+            return AWS_OP_ERR;
+        }
+
+        connection->thread_data.ping_ack_pending = false;
+        CONNECTION_LOG(TRACE, &connection->base, "Wrote PING ack.");
+    }
+
+    struct aws_array_list *window_updates = &connection->thread_data.pending_window_updates;
+    while (aws_array_list_length(window_updates) > 0) {
+        struct aws_h2_pending_window_update *pending = NULL;
+        aws_array_list_get_at_ptr(window_updates, (void **)&pending, 0);
+
+        if (aws_h2_frame_window_update_encode_direct(pending->stream_id, pending->window_size_increment, output)) {
+            return AWS_OP_ERR;
+        }
+
+        CONNECTION_LOGF(
+            TRACE,
+            &connection->base,
+            "Wrote WINDOW_UPDATE of %" PRIu32 " for stream %" PRIu32 ".",
+            pending->window_size_increment,
+            pending->stream_id);
+
+        aws_array_list_pop_front(window_updates);
+    }
+
+    /* A changed window target is pushed to every stream at once via SETTINGS_INITIAL_WINDOW_SIZE;
+     * the peer adjusts each stream's window by the delta itself [RFC-7540 6.9.2] */
+    if (connection->thread_data.window_settings_pending) {
+        const struct aws_h2_frame_setting window_setting = {
+            .identifier = AWS_H2_SETTINGS_INITIAL_WINDOW_SIZE,
+            .value = (uint32_t)connection->thread_data.window_target,
+        };
+
+        if (aws_h2_frame_settings_encode_direct(false /*ack*/, &window_setting, 1, output)) {
+            return AWS_OP_ERR;
+        }
+
+        connection->thread_data.window_settings_pending = false;
+        CONNECTION_LOGF(
+            TRACE,
+            &connection->base,
+            "Wrote SETTINGS_INITIAL_WINDOW_SIZE of %zu.",
+            connection->thread_data.window_target);
+    }
+
+    if (connection->thread_data.bdp_ping_pending) {
+        connection->thread_data.bdp_ping_counter++;
+        memcpy(
+            connection->thread_data.bdp_ping_payload,
+            &connection->thread_data.bdp_ping_counter,
+            AWS_H2_PING_DATA_SIZE);
+
+        if (aws_h2_frame_ping_encode_direct(false /*ack*/, connection->thread_data.bdp_ping_payload, output)) {
+            return AWS_OP_ERR;
+        }
+
+        uint64_t now_ns = 0;
+        if (aws_channel_current_clock_time(connection->base.channel_slot->channel, &now_ns)) {
+            return AWS_OP_ERR;
+        }
+
+        connection->thread_data.bdp_ping_pending = false;
+        connection->thread_data.bdp_ping_in_flight = true;
+        connection->thread_data.bdp_ping_send_time_ns = now_ns;
+        CONNECTION_LOG(TRACE, &connection->base, "Wrote RTT-sampling PING.");
+    }
+
+    if (connection->thread_data.keepalive_ping_pending) {
+        connection->thread_data.keepalive_ping_counter++;
+        memcpy(
+            connection->thread_data.keepalive_ping_payload,
+            &connection->thread_data.keepalive_ping_counter,
+            AWS_H2_PING_DATA_SIZE);
+
+        if (aws_h2_frame_ping_encode_direct(false /*ack*/, connection->thread_data.keepalive_ping_payload, output)) {
+            return AWS_OP_ERR;
+        }
+
+        uint64_t now_ns = 0;
+        if (aws_channel_current_clock_time(connection->base.channel_slot->channel, &now_ns)) {
+            return AWS_OP_ERR;
+        }
+
+        connection->thread_data.keepalive_ping_pending = false;
+        connection->thread_data.keepalive_ping_in_flight = true;
+        connection->thread_data.keepalive_ping_send_time_ns = now_ns;
+        CONNECTION_LOG(TRACE, &connection->base, "Wrote keepalive PING.");
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static bool s_header_name_eq(struct aws_byte_cursor name, const char *match) {
+    return aws_byte_cursor_eq_c_str_ignore_case(&name, match);
+}
+
+/* Headers that describe the HTTP/1 connection must not travel in an h2 header block [RFC-7540 8.1.2.2] */
+static bool s_header_is_connection_specific(struct aws_byte_cursor name) {
+    return s_header_name_eq(name, "connection") || s_header_name_eq(name, "keep-alive") ||
+           s_header_name_eq(name, "proxy-connection") || s_header_name_eq(name, "transfer-encoding") ||
+           s_header_name_eq(name, "upgrade");
+}
+
+/* Returns a cursor to a lowercased copy of name in the scratch buf (h2 requires lowercase field names
+ * [RFC-7540 8.1.2]). Falls back to the original cursor if scratch space runs out. */
+static struct aws_byte_cursor s_lowercase_header_name(struct aws_byte_buf *scratch, struct aws_byte_cursor name) {
+    if (!aws_strutil_ascii_has_uppercase(name) || scratch->capacity - scratch->len < name.len) {
+        return name;
+    }
+
+    uint8_t *copy = scratch->buffer + scratch->len;
+    aws_strutil_ascii_tolower(copy, name.ptr, name.len);
+    scratch->len += name.len;
+
+    return aws_byte_cursor_from_array(copy, name.len);
+}
+
+/* Build and encode the HEADERS frame for a stream's request.
+ * On success the stream's send-side state machine is advanced. */
+static int s_encode_stream_headers(
+    struct aws_h2_connection *connection,
+    struct aws_h2_stream *stream,
+    struct aws_byte_buf *output) {
+
+    struct aws_http_message *request = stream->thread_data.request;
+    struct aws_byte_buf *scratch = &connection->thread_data.encode_scratch_buf;
+    scratch->len = 0;
+
+    struct aws_h2_frame_headers frame;
+    if (aws_h2_frame_headers_init(&frame, connection->base.alloc)) {
+        return AWS_OP_ERR;
+    }
+
+    frame.header.stream_id = stream->id;
+    frame.end_headers = true;
+    const bool end_stream = (stream->thread_data.request_body == NULL);
+    frame.end_stream = end_stream;
+
+    int err = 0;
+
+    /* Pseudo-headers must precede regular fields [RFC-7540 8.1.2.1] */
+    struct aws_byte_cursor method;
+    struct aws_byte_cursor path;
+    err |= aws_http_message_get_request_method(request, &method);
+    err |= aws_http_message_get_request_path(request, &path);
+    if (err) {
+        aws_raise_error(AWS_ERROR_HTTP_INVALID_METHOD);
+        goto error;
+    }
+
+    /* :authority comes from the Host header, which must not itself be forwarded */
+    struct aws_byte_cursor authority = {0};
+    const size_t num_headers = aws_http_message_get_header_count(request);
+    for (size_t i = 0; i < num_headers; ++i) {
+        struct aws_http_header header;
+        aws_http_message_get_header(request, &header, i);
+        if (s_header_name_eq(header.name, "host")) {
+            authority = header.value;
+            break;
+        }
+    }
+
+    struct aws_h2_frame_header_field pseudo_headers[] = {
+        {.header = {.name = aws_byte_cursor_from_c_str(":method"), .value = method}},
+        {.header = {.name = aws_byte_cursor_from_c_str(":scheme"), .value = aws_byte_cursor_from_c_str("https")}},
+        {.header = {.name = aws_byte_cursor_from_c_str(":path"), .value = path}},
+        {.header = {.name = aws_byte_cursor_from_c_str(":authority"), .value = authority}},
+    };
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(pseudo_headers); ++i) {
+        if (pseudo_headers[i].header.value.len == 0) {
+            continue;
+        }
+        if (aws_array_list_push_back(&frame.header_block.header_fields, &pseudo_headers[i])) {
+            goto error;
+        }
+    }
+
+    for (size_t i = 0; i < num_headers; ++i) {
+        struct aws_http_header header;
+        aws_http_message_get_header(request, &header, i);
+
+        if (s_header_name_eq(header.name, "host") || s_header_is_connection_specific(header.name)) {
+            continue;
+        }
+
+        struct aws_h2_frame_header_field field = {
+            .header =
+                {
+                    .name = s_lowercase_header_name(scratch, header.name),
+                    .value = header.value,
+                },
+            .hpack_behavior = AWS_H2_HEADER_BEHAVIOR_SAVE,
+        };
+
+        if (aws_array_list_push_back(&frame.header_block.header_fields, &field)) {
+            goto error;
+        }
+    }
+
+    if (aws_h2_frame_headers_encode(&frame, &connection->thread_data.frame_encoder, output)) {
+        goto error;
+    }
+
+    aws_h2_frame_headers_clean_up(&frame);
+
+    AWS_LOGF_TRACE(AWS_LS_HTTP_STREAM, "id=%p: Sent HEADERS frame.", (void *)&stream->base);
+    aws_h2_stream_on_frame_sent(stream, AWS_H2_FRAME_T_HEADERS, end_stream);
+    return AWS_OP_SUCCESS;
+
+error:
+    aws_h2_frame_headers_clean_up(&frame);
+    return AWS_OP_ERR;
+}
+
+/* Read a chunk of request body and encode it as a DATA frame.
+ * out_wrote_data is false if the body had nothing available this tick. */
+static int s_encode_stream_data(
+    struct aws_h2_connection *connection,
+    struct aws_h2_stream *stream,
+    struct aws_byte_buf *output,
+    bool *out_wrote_data) {
+
+    *out_wrote_data = false;
+
+    const size_t space = output->capacity - output->len;
+    if (space <= FRAME_PREFIX_SIZE) {
+        /* Not even room for a frame prefix; flush this message and try again with an empty one */
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    /* Deficit round robin: each pass the stream earns weight-proportional byte credit,
+     * and may send no more DATA than it has credit for. Interactive (high-weight) streams
+     * therefore get a proportionally larger slice of every outgoing message than bulk
+     * (low-weight) streams, instead of FIFO head-of-line blocking. */
+    stream->thread_data.data_deficit += (size_t)stream->thread_data.weight * DATA_SCHEDULER_QUANTUM;
+    if (stream->thread_data.data_deficit > DATA_SCHEDULER_MAX_DEFICIT) {
+        stream->thread_data.data_deficit = DATA_SCHEDULER_MAX_DEFICIT;
+    }
+
+    size_t max_payload = space - FRAME_PREFIX_SIZE;
+    if (max_payload > stream->thread_data.data_deficit) {
+        max_payload = stream->thread_data.data_deficit;
+    }
+    if (max_payload > connection->thread_data.remote_max_frame_size) {
+        max_payload = connection->thread_data.remote_max_frame_size;
+    }
+    if (max_payload > connection->thread_data.encode_scratch_buf.capacity) {
+        max_payload = connection->thread_data.encode_scratch_buf.capacity;
+    }
+
+    /* Alias the scratch buffer, capped so the body can't hand us more than one frame's worth */
+    struct aws_byte_buf dst = {
+        .buffer = connection->thread_data.encode_scratch_buf.buffer,
+        .capacity = max_payload,
+    };
+
+    if (aws_input_stream_read(stream->thread_data.request_body, &dst)) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_stream_status status;
+    if (aws_input_stream_get_status(stream->thread_data.request_body, &status)) {
+        return AWS_OP_ERR;
+    }
+
+    if (dst.len == 0 && !status.is_end_of_stream) {
+        /* Body has no data available yet. Classic DRR: an empty queue forfeits its credit,
+         * so a stalled body can't bank an unfairly large burst for later. */
+        stream->thread_data.data_deficit = 0;
+        return AWS_OP_SUCCESS;
+    }
+
+    struct aws_h2_frame_data frame;
+    if (aws_h2_frame_data_init(&frame, connection->base.alloc)) {
+        return AWS_OP_ERR;
+    }
+
+    frame.header.stream_id = stream->id;
+    frame.end_stream = status.is_end_of_stream;
+    frame.data = aws_byte_cursor_from_buf(&dst);
+
+    int err = aws_h2_frame_data_encode(&frame, &connection->thread_data.frame_encoder, output);
+    aws_h2_frame_data_clean_up(&frame);
+    if (err) {
+        return AWS_OP_ERR;
+    }
+
+    /* Spend the credit for what was actually sent */
+    stream->thread_data.data_deficit -= dst.len;
+
+    AWS_LOGF_TRACE(
+        AWS_LS_HTTP_STREAM,
+        "id=%p: Sent DATA frame of size %zu%s.",
+        (void *)&stream->base,
+        dst.len,
+        status.is_end_of_stream ? " (END_STREAM)" : "");
+
+    *out_wrote_data = true;
+    aws_h2_stream_on_frame_sent(stream, AWS_H2_FRAME_T_DATA, status.is_end_of_stream);
+    return AWS_OP_SUCCESS;
+}
+
+static void s_outgoing_frames_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
+    if (status != AWS_TASK_STATUS_RUN_READY) {
+        return;
+    }
+
+    struct aws_h2_connection *connection = arg;
+    struct aws_channel *channel = connection->base.channel_slot->channel;
+    struct aws_io_message *msg = NULL;
+
+    if (connection->thread_data.is_writing_stopped) {
+        return;
+    }
+
+    CONNECTION_LOG(TRACE, &connection->base, "Outgoing frames task is running.");
+
+    /* An active connection is one worth probing; first write (or read) arms the keepalive */
+    s_arm_keepalive_task(connection);
+
+    if (s_move_pending_streams(connection)) {
+        goto error;
+    }
+
+    size_t overhead = aws_channel_slot_upstream_message_overhead(connection->base.channel_slot);
+    if (overhead >= MESSAGE_SIZE_HINT) {
+        CONNECTION_LOG(ERROR, &connection->base, "Unexpected error while calculating message size, closing connection.");
+        aws_raise_error(AWS_ERROR_INVALID_STATE);
+        goto error;
+    }
+
+    msg = aws_channel_acquire_message_from_pool(
+        channel, AWS_IO_MESSAGE_APPLICATION_DATA, MESSAGE_SIZE_HINT - overhead);
+    if (!msg) {
+        goto error;
+    }
+
+    struct aws_byte_buf *output = &msg->message_data;
+
+    /* A client opens with the preface magic and its SETTINGS before anything else [RFC-7540 3.5] */
+    if (!connection->thread_data.is_preface_sent && connection->base.client_data) {
+        if (s_encode_connection_preface(connection, output)) {
+            goto error;
+        }
+        connection->thread_data.is_preface_sent = true;
+        CONNECTION_LOG(DEBUG, &connection->base, "Sent connection preface and initial SETTINGS.");
+    }
+
+    if (s_encode_pending_control_frames(connection, output)) {
+        goto error;
+    }
+
+    /**
+     * Service each outgoing stream once, round-robin, so one stream with a large body
+     * can't starve the others. A stream that still has data after its turn goes to the
+     * back of the line; a stream that finishes sending leaves the line.
+     */
+    struct aws_linked_list *outgoing = &connection->thread_data.outgoing_streams;
+    size_t streams_to_service = 0;
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(outgoing); node != aws_linked_list_end(outgoing);
+         node = aws_linked_list_next(node)) {
+        ++streams_to_service;
+    }
+
+    bool message_is_full = false;
+
+    for (; streams_to_service > 0 && !aws_linked_list_empty(outgoing); --streams_to_service) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(outgoing);
+        struct aws_h2_stream *stream = AWS_CONTAINER_OF(node, struct aws_h2_stream, node);
+
+        const size_t output_len_before = output->len;
+        int err;
+        bool wrote_data = true;
+
+        if (!stream->thread_data.sent_headers) {
+            err = s_encode_stream_headers(connection, stream, output);
+        } else {
+            err = s_encode_stream_data(connection, stream, output, &wrote_data);
+        }
+
+        if (err) {
+            /* The frame encoders roll the output buffer back on failure, so a frame that didn't fit
+             * can simply be re-attempted in the next (empty) message. Anything else is fatal. */
+            if (output_len_before > 0) {
+                aws_linked_list_push_front(outgoing, &stream->node);
+                message_is_full = true;
+                break;
+            }
+
+            AWS_LOGF_ERROR(
+                AWS_LS_HTTP_STREAM,
+                "id=%p: Failed to encode frame, error %d (%s). Closing connection.",
+                (void *)&stream->base,
+                aws_last_error(),
+                aws_error_name(aws_last_error()));
+            goto error;
+        }
+
+        if (stream->thread_data.sent_end_stream) {
+            /* Done sending. Stream stays in the map awaiting the peer's response. */
+            stream->thread_data.in_outgoing_list = false;
+
+            if (stream->thread_data.state == AWS_H2_STREAM_STATE_CLOSED) {
+                s_stream_complete(connection, stream, stream->thread_data.completion_error_code);
+            }
+        } else {
+            if (!wrote_data) {
+                /* If this scenario turns out to be common we should implement a "pause" feature. */
+                AWS_LOGF_WARN(
+                    AWS_LS_HTTP_STREAM,
+                    "id=%p: Stream's body sent no data, will try again next tick.",
+                    (void *)&stream->base);
+            }
+            aws_linked_list_push_back(outgoing, &stream->node);
+        }
+    }
+
+    if (output->len > 0) {
+        CONNECTION_LOGF(
+            TRACE, &connection->base, "Outgoing frames task is sending message of size %zu.", output->len);
+
+        const size_t outgoing_message_size = msg->message_data.len;
+        if (aws_channel_slot_send_message(connection->base.channel_slot, msg, AWS_CHANNEL_DIR_WRITE)) {
+            CONNECTION_LOGF(
+                ERROR,
+                &connection->base,
+                "Failed to send message up channel, error %d (%s). Closing connection.",
+                aws_last_error(),
+                aws_error_name(aws_last_error()));
+            goto error;
+        }
+        connection->base.bytes_written += outgoing_message_size;
+        msg = NULL;
+    } else {
+        aws_mem_release(msg->allocator, msg);
+        msg = NULL;
+    }
+
+    /* Reschedule task if there's still more work to do. */
+    bool should_reschedule = message_is_full || !aws_linked_list_empty(outgoing);
+    if (!should_reschedule) {
+        { /* BEGIN CRITICAL SECTION */
+            s_h2_connection_lock_synced_data(connection);
+            if (aws_linked_list_empty(&connection->synced_data.pending_stream_list)) {
+                /* No work to do. Set this false while we're holding the lock. */
+                connection->synced_data.is_outgoing_frames_task_active = false;
+            } else {
+                should_reschedule = true;
+            }
+            s_h2_connection_unlock_synced_data(connection);
+        } /* END CRITICAL SECTION */
+    }
+
+    if (should_reschedule) {
+        CONNECTION_LOG(TRACE, &connection->base, "Outgoing frames task has more work to do, rescheduling.");
+        aws_channel_schedule_task_now(channel, task);
+    } else {
+        CONNECTION_LOG(TRACE, &connection->base, "Outgoing frames task complete.");
+    }
+
+    return;
+error:
+    if (msg) {
+        aws_mem_release(msg->allocator, msg);
+    }
+
+    s_shutdown_due_to_error(connection, aws_last_error());
+}
+
+/***********************************************************************************************************************
+ * Incoming frames
+ **********************************************************************************************************************/
+
+/* Queue a WINDOW_UPDATE for the peer; the outgoing-frames task writes it */
+static int s_queue_window_update(struct aws_h2_connection *connection, uint32_t stream_id, size_t increment) {
+    if (increment == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    struct aws_h2_pending_window_update pending = {
+        .stream_id = stream_id,
+        .window_size_increment = (uint32_t)increment,
+    };
+    if (aws_array_list_push_back(&connection->thread_data.pending_window_updates, &pending)) {
+        return AWS_OP_ERR;
+    }
+
+    s_try_schedule_outgoing_frames_task(connection);
+    return AWS_OP_SUCCESS;
+}
+
+/**
+ * Account an incoming DATA payload against the advertised flow-control windows,
+ * replenishing them with WINDOW_UPDATEs once half the window is consumed.
+ * Also starts an RTT sample if one isn't already in flight.
+ * `stream` is NULL when the DATA arrived for an unknown stream (it still consumed
+ * the connection window [RFC-7540 6.9]).
+ */
+static int s_account_incoming_data(
+    struct aws_h2_connection *connection,
+    struct aws_h2_stream *stream,
+    size_t payload_len) {
+
+    /* Sample the RTT whenever data is flowing and no sample is in progress.
+     * The bytes that arrive before the PING's ack are the bandwidth-delay product estimate. */
+    if (!connection->thread_data.bdp_ping_in_flight && !connection->thread_data.bdp_ping_pending) {
+        connection->thread_data.bdp_ping_pending = true;
+        connection->thread_data.bdp_bytes_this_sample = 0;
+        s_try_schedule_outgoing_frames_task(connection);
+    }
+    connection->thread_data.bdp_bytes_this_sample += payload_len;
+
+    const size_t window_target = connection->thread_data.window_target;
+
+    size_t advertised = connection->thread_data.connection_window_advertised;
+    advertised = payload_len > advertised ? 0 : advertised - payload_len;
+    if (advertised < window_target / 2) {
+        if (s_queue_window_update(connection, 0, window_target - advertised)) {
+            return AWS_OP_ERR;
+        }
+        advertised = window_target;
+    }
+    connection->thread_data.connection_window_advertised = advertised;
+
+    if (stream) {
+        stream->thread_data.recv_window_consumed += payload_len;
+        if (stream->thread_data.recv_window_consumed >= window_target / 2) {
+            if (s_queue_window_update(connection, stream->id, stream->thread_data.recv_window_consumed)) {
+                return AWS_OP_ERR;
+            }
+            stream->thread_data.recv_window_consumed = 0;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* The peer acked our RTT-sampling PING: fold the sample into the smoothed RTT
+ * and grow/shrink the window target toward 2x the measured bandwidth-delay product */
+static void s_complete_bdp_sample(struct aws_h2_connection *connection) {
+    connection->thread_data.bdp_ping_in_flight = false;
+
+    uint64_t now_ns = 0;
+    if (aws_channel_current_clock_time(connection->base.channel_slot->channel, &now_ns)) {
+        return;
+    }
+
+    const uint64_t send_time_ns = connection->thread_data.bdp_ping_send_time_ns;
+    const uint64_t rtt_ns = now_ns > send_time_ns ? now_ns - send_time_ns : 0;
+    const size_t bdp_estimate = connection->thread_data.bdp_bytes_this_sample;
+
+    size_t window_target = connection->thread_data.window_target;
+    size_t new_target = window_target;
+    if (bdp_estimate > window_target / 2) {
+        /* The link delivered more than half a window per RTT: we're probably the bottleneck.
+         * Target 2x the BDP so the peer never drains the window mid-flight. */
+        new_target = bdp_estimate > MAX_WINDOW_TARGET / 2 ? MAX_WINDOW_TARGET : bdp_estimate * 2;
+    } else if (window_target > INITIAL_WINDOW_TARGET && bdp_estimate < window_target / 8) {
+        /* Delivery collapsed well below the window: release the memory we're not using */
+        new_target = window_target / 2 > INITIAL_WINDOW_TARGET ? window_target / 2 : INITIAL_WINDOW_TARGET;
+    }
+
+    if (new_target != window_target) {
+        CONNECTION_LOGF(
+            DEBUG,
+            &connection->base,
+            "BDP estimate %zu over RTT %" PRIu64 "ns, window target %zu -> %zu.",
+            bdp_estimate,
+            rtt_ns,
+            window_target,
+            new_target);
+
+        connection->thread_data.window_target = new_target;
+        connection->thread_data.window_settings_pending = true;
+
+        if (new_target > connection->thread_data.connection_window_advertised) {
+            /* Hand the peer the extra connection-level credit right away */
+            if (s_queue_window_update(
+                    connection, 0, new_target - connection->thread_data.connection_window_advertised)) {
+                return;
+            }
+            connection->thread_data.connection_window_advertised = new_target;
+        }
+        s_try_schedule_outgoing_frames_task(connection);
+    }
+
+    { /* BEGIN CRITICAL SECTION */
+        s_h2_connection_lock_synced_data(connection);
+        connection->synced_data.window_stats.window_target = connection->thread_data.window_target;
+        connection->synced_data.window_stats.bdp_estimate = bdp_estimate;
+        if (rtt_ns > 0) {
+            const uint64_t smoothed_rtt_ns = connection->synced_data.window_stats.rtt_ns;
+            connection->synced_data.window_stats.rtt_ns =
+                smoothed_rtt_ns == 0 ? rtt_ns : (smoothed_rtt_ns * 7 + rtt_ns) / 8;
+        }
+        s_h2_connection_unlock_synced_data(connection);
+    } /* END CRITICAL SECTION */
+}
+
+/* Peer sent GOAWAY with NO_ERROR [RFC-7540 6.8]: drain instead of dropping in-flight work.
+ * Streams the peer never processed (id above last_stream_id) complete immediately, so the caller
+ * can retry them elsewhere without waiting out a timeout. Streams the peer is still processing
+ * run to completion, new streams are rejected, and the connection shuts down once the last
+ * surviving stream finishes. */
+static void s_process_graceful_goaway(struct aws_h2_connection *connection, uint32_t last_stream_id) {
+    connection->thread_data.goaway_received = true;
+    connection->thread_data.goaway_last_stream_id = last_stream_id;
+
+    { /* BEGIN CRITICAL SECTION */
+        s_h2_connection_lock_synced_data(connection);
+        if (!connection->synced_data.new_stream_error_code) {
+            connection->synced_data.new_stream_error_code = AWS_ERROR_HTTP_GOAWAY_RECEIVED;
+        }
+        s_h2_connection_unlock_synced_data(connection);
+    } /* END CRITICAL SECTION */
+
+    /* Tell anyone pooling this connection (ex: connection manager) to stop vending it now */
+    aws_http_connection_signal_draining(&connection->base);
+
+    /* Pull in streams the user created but we haven't activated yet, so the scan below sees them */
+    if (s_move_pending_streams(connection)) {
+        s_shutdown_due_to_error(connection, aws_last_error());
+        return;
+    }
+
+    /* Complete every stream the peer will never process */
+    bool completed_stream;
+    do {
+        completed_stream = false;
+        for (struct aws_hash_iter iter = aws_hash_iter_begin(&connection->thread_data.active_streams);
+             !aws_hash_iter_done(&iter);
+             aws_hash_iter_next(&iter)) {
+
+            struct aws_h2_stream *stream = iter.element.value;
+            if (stream->id > last_stream_id) {
+                /* s_stream_complete mutates the map, so restart iteration after each hit */
+                s_stream_complete(connection, stream, AWS_ERROR_HTTP_GOAWAY_RECEIVED);
+                completed_stream = true;
+                break;
+            }
+        }
+    } while (completed_stream);
+
+    s_shutdown_if_goaway_drained(connection);
+}
+
+/* Handle a frame addressed to the connection itself (stream id 0) */
+static int s_handle_connection_frame(struct aws_h2_connection *connection) {
+    struct aws_h2_frame_decoder *decoder = &connection->thread_data.frame_decoder;
+
+    switch (decoder->header.type) {
+        case AWS_H2_FRAME_T_SETTINGS: {
+            struct aws_h2_frame_settings frame;
+            if (aws_h2_frame_settings_decode(&frame, decoder)) {
+                return AWS_OP_ERR;
+            }
+
+            if (frame.ack) {
+                CONNECTION_LOG(DEBUG, &connection->base, "Peer acknowledged our SETTINGS.");
+            } else {
+                struct aws_hash_element *elem = NULL;
+                aws_hash_table_find(&frame.settings, (void *)(size_t)AWS_H2_SETTINGS_MAX_FRAME_SIZE, &elem);
+                if (elem) {
+                    connection->thread_data.remote_max_frame_size = (uint32_t)(size_t)elem->value;
+                    CONNECTION_LOGF(
+                        DEBUG,
+                        &connection->base,
+                        "Peer SETTINGS_MAX_FRAME_SIZE is %" PRIu32 ".",
+                        connection->thread_data.remote_max_frame_size);
+                }
+                /* #TODO honor SETTINGS_INITIAL_WINDOW_SIZE once flow-control windows are wired up */
+
+                connection->thread_data.settings_ack_pending = true;
+                s_try_schedule_outgoing_frames_task(connection);
+            }
+
+            aws_h2_frame_settings_clean_up(&frame);
+            return AWS_OP_SUCCESS;
+        }
+
+        case AWS_H2_FRAME_T_PING: {
+            struct aws_h2_frame_ping frame;
+            if (aws_h2_frame_ping_decode(&frame, decoder)) {
+                return AWS_OP_ERR;
+            }
+
+            if (frame.ack) {
+                if (connection->thread_data.bdp_ping_in_flight &&
+                    memcmp(frame.opaque_data.ptr, connection->thread_data.bdp_ping_payload, AWS_H2_PING_DATA_SIZE) ==
+                        0) {
+                    s_complete_bdp_sample(connection);
+                } else if (
+                    connection->thread_data.keepalive_ping_in_flight &&
+                    memcmp(
+                        frame.opaque_data.ptr,
+                        connection->thread_data.keepalive_ping_payload,
+                        AWS_H2_PING_DATA_SIZE) == 0) {
+                    connection->thread_data.keepalive_ping_in_flight = false;
+
+                    uint64_t now_ns = 0;
+                    if (aws_channel_current_clock_time(connection->base.channel_slot->channel, &now_ns) ==
+                        AWS_OP_SUCCESS) {
+                        const uint64_t send_time_ns = connection->thread_data.keepalive_ping_send_time_ns;
+                        s_record_rtt_sample(connection, now_ns > send_time_ns ? now_ns - send_time_ns : 0);
+                    }
+                    CONNECTION_LOG(TRACE, &connection->base, "Keepalive PING acknowledged.");
+                } else {
+                    CONNECTION_LOG(TRACE, &connection->base, "Ignoring PING ack we have no record of sending.");
+                }
+            } else {
+                /* Echo the peer's opaque data back in an ack [RFC-7540 6.7].
+                 * The frame codec guarantees opaque_data is exactly AWS_H2_PING_DATA_SIZE bytes. */
+                memcpy(connection->thread_data.ping_ack_payload, frame.opaque_data.ptr, AWS_H2_PING_DATA_SIZE);
+                connection->thread_data.ping_ack_pending = true;
+                s_try_schedule_outgoing_frames_task(connection);
+            }
+
+            aws_h2_frame_ping_clean_up(&frame);
+            return AWS_OP_SUCCESS;
+        }
+
+        case AWS_H2_FRAME_T_GOAWAY: {
+            struct aws_h2_frame_goaway frame;
+            if (aws_h2_frame_goaway_decode(&frame, decoder)) {
+                return AWS_OP_ERR;
+            }
+
+            CONNECTION_LOGF(
+                INFO,
+                &connection->base,
+                "Peer sent GOAWAY, error code %" PRIu32 ", last stream id %" PRIu32 ".",
+                (uint32_t)frame.error_code,
+                frame.last_stream_id);
+
+            const bool is_graceful = frame.error_code == AWS_H2_ERR_NO_ERROR;
+            const uint32_t last_stream_id = frame.last_stream_id;
+
+            aws_h2_frame_goaway_clean_up(&frame);
+
+            if (is_graceful) {
+                s_process_graceful_goaway(connection, last_stream_id);
+            } else {
+                /* A GOAWAY carrying an error is fatal to every stream multiplexed on the connection */
+                s_stop(
+                    connection,
+                    false /*stop_reading*/,
+                    false /*stop_writing*/,
+                    true /*schedule_shutdown*/,
+                    AWS_ERROR_HTTP_PROTOCOL_ERROR);
+            }
+            return AWS_OP_SUCCESS;
+        }
+
+        case AWS_H2_FRAME_T_WINDOW_UPDATE: {
+            struct aws_h2_frame_window_update frame;
+            if (aws_h2_frame_window_update_decode(&frame, decoder)) {
+                return AWS_OP_ERR;
+            }
+
+            /* #TODO track the connection-level send window */
+            CONNECTION_LOGF(
+                TRACE,
+                &connection->base,
+                "Ignoring connection WINDOW_UPDATE of %" PRIu32 ".",
+                frame.window_size_increment);
+
+            aws_h2_frame_window_update_clean_up(&frame);
+            return AWS_OP_SUCCESS;
+        }
+
+        default:
+            CONNECTION_LOGF(
+                TRACE,
+                &connection->base,
+                "Ignoring connection-level frame of type %s.",
+                aws_h2_frame_type_to_str(decoder->header.type));
+            return AWS_OP_SUCCESS;
+    }
+}
+
+/* A header-block frame arrived for a stream we don't know. It must still run through HPACK
+ * to keep the decompression state synchronized with the peer [RFC-7541 2.2]. */
+static int s_consume_unknown_header_block_frame(struct aws_h2_connection *connection) {
+    struct aws_h2_frame_decoder *decoder = &connection->thread_data.frame_decoder;
+
+    switch (decoder->header.type) {
+        case AWS_H2_FRAME_T_HEADERS: {
+            struct aws_h2_frame_headers frame;
+            if (aws_h2_frame_headers_decode(&frame, decoder)) {
+                return AWS_OP_ERR;
+            }
+            aws_h2_frame_headers_clean_up(&frame);
+            return AWS_OP_SUCCESS;
+        }
+        case AWS_H2_FRAME_T_PUSH_PROMISE: {
+            struct aws_h2_frame_push_promise frame;
+            if (aws_h2_frame_push_promise_decode(&frame, decoder)) {
+                return AWS_OP_ERR;
+            }
+            aws_h2_frame_push_promise_clean_up(&frame);
+            return AWS_OP_SUCCESS;
+        }
+        case AWS_H2_FRAME_T_CONTINUATION: {
+            struct aws_h2_frame_continuation frame;
+            if (aws_h2_frame_continuation_decode(&frame, decoder)) {
+                return AWS_OP_ERR;
+            }
+            aws_h2_frame_continuation_clean_up(&frame);
+            return AWS_OP_SUCCESS;
+        }
+        default:
+            /* Payload was already consumed by the frame decoder, nothing more to do */
+            return AWS_OP_SUCCESS;
+    }
+}
+
+/* Route one fully-decoded frame header+payload (sitting in the frame decoder) to its stream */
+static int s_dispatch_frame(struct aws_h2_connection *connection) {
+    struct aws_h2_frame_decoder *decoder = &connection->thread_data.frame_decoder;
+    const uint32_t stream_id = decoder->header.stream_id;
+
+    if (stream_id == 0) {
+        return s_handle_connection_frame(connection);
+    }
+
+    struct aws_hash_element *elem = NULL;
+    aws_hash_table_find(&connection->thread_data.active_streams, (void *)(size_t)stream_id, &elem);
+    struct aws_h2_stream *stream = elem ? elem->value : NULL;
+
+    if (decoder->header.type == AWS_H2_FRAME_T_DATA) {
+        /* DATA consumes our advertised windows whether or not we know the stream */
+        if (s_account_incoming_data(connection, stream, decoder->payload.len)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    if (!elem) {
+        CONNECTION_LOGF(
+            TRACE,
+            &connection->base,
+            "Received %s frame for unknown stream %" PRIu32 ", ignoring.",
+            aws_h2_frame_type_to_str(decoder->header.type),
+            stream_id);
+
+        return s_consume_unknown_header_block_frame(connection);
+    }
+
+    if (aws_h2_stream_handle_frame(stream, decoder)) {
+        return AWS_OP_ERR;
+    }
+
+    if (stream->thread_data.state == AWS_H2_STREAM_STATE_CLOSED) {
+        s_stream_complete(connection, stream, stream->thread_data.completion_error_code);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Reads the 24-bit payload length from the first 3 bytes of a frame prefix */
+static size_t s_peek_frame_payload_len(const uint8_t *prefix) {
+    return ((size_t)prefix[0] << 16) | ((size_t)prefix[1] << 8) | (size_t)prefix[2];
+}
+
+static int s_handler_process_read_message(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_io_message *message) {
+
+    struct aws_h2_connection *connection = handler->impl;
+
+    const size_t incoming_message_size = message->message_data.len;
+    connection->base.bytes_read += incoming_message_size;
+
+    CONNECTION_LOGF(TRACE, &connection->base, "Begin processing message of size %zu.", incoming_message_size);
+
+    /* An active connection is one worth probing; first read (or write) arms the keepalive */
+    s_arm_keepalive_task(connection);
+
+    struct aws_byte_cursor message_cursor = aws_byte_cursor_from_buf(&message->message_data);
+    struct aws_byte_buf *assembly = &connection->thread_data.frame_assembly_buf;
+
+    while (message_cursor.len > 0) {
+        if (connection->thread_data.is_reading_stopped) {
+            CONNECTION_LOG(ERROR, &connection->base, "Cannot process message because connection is shutting down.");
+            aws_raise_error(AWS_ERROR_HTTP_CONNECTION_CLOSED);
+            goto shutdown;
+        }
+
+        if (connection->base.server_data) {
+            /* #TODO server-side h2 (read client preface magic, accept streams) */
+            CONNECTION_LOG(ERROR, &connection->base, "Server-side HTTP/2 is not supported yet.");
+            aws_raise_error(AWS_ERROR_UNIMPLEMENTED);
+            goto shutdown;
+        }
+
+        /* The frame codec consumes exactly one whole contiguous frame at a time, so a frame that
+         * was split across io messages is first reassembled in frame_assembly_buf. */
+        if (assembly->len > 0) {
+            /* Finish buffering the frame prefix so we can learn the payload length */
+            if (assembly->len < FRAME_PREFIX_SIZE) {
+                size_t needed = FRAME_PREFIX_SIZE - assembly->len;
+                size_t to_copy = needed < message_cursor.len ? needed : message_cursor.len;
+                aws_byte_buf_write(assembly, message_cursor.ptr, to_copy);
+                aws_byte_cursor_advance(&message_cursor, to_copy);
+                if (assembly->len < FRAME_PREFIX_SIZE) {
+                    break;
+                }
+            }
+
+            const size_t total = FRAME_PREFIX_SIZE + s_peek_frame_payload_len(assembly->buffer);
+            if (total > assembly->capacity) {
+                CONNECTION_LOGF(
+                    ERROR,
+                    &connection->base,
+                    "Peer sent frame of size %zu, larger than the advertised SETTINGS_MAX_FRAME_SIZE.",
+                    total - FRAME_PREFIX_SIZE);
+                aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
+                goto shutdown;
+            }
+
+            size_t needed = total - assembly->len;
+            size_t to_copy = needed < message_cursor.len ? needed : message_cursor.len;
+            aws_byte_buf_write(assembly, message_cursor.ptr, to_copy);
+            aws_byte_cursor_advance(&message_cursor, to_copy);
+            if (assembly->len < total) {
+                break;
+            }
+
+            struct aws_byte_cursor frame_cursor = aws_byte_cursor_from_buf(assembly);
+            if (aws_h2_frame_decoder_begin(&connection->thread_data.frame_decoder, &frame_cursor)) {
+                goto shutdown;
+            }
+            assembly->len = 0;
+
+            if (s_dispatch_frame(connection)) {
+                goto shutdown;
+            }
+
+            continue;
+        }
+
+        /* Not even a whole frame prefix available: start buffering */
+        if (message_cursor.len < FRAME_PREFIX_SIZE) {
+            aws_byte_buf_write(assembly, message_cursor.ptr, message_cursor.len);
+            aws_byte_cursor_advance(&message_cursor, message_cursor.len);
+            break;
+        }
+
+        const size_t total = FRAME_PREFIX_SIZE + s_peek_frame_payload_len(message_cursor.ptr);
+        if (total > assembly->capacity) {
+            CONNECTION_LOGF(
+                ERROR,
+                &connection->base,
+                "Peer sent frame of size %zu, larger than the advertised SETTINGS_MAX_FRAME_SIZE.",
+                total - FRAME_PREFIX_SIZE);
+            aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
+            goto shutdown;
+        }
+
+        if (message_cursor.len < total) {
+            /* Frame straddles into the next message; buffer what we have */
+            aws_byte_buf_write(assembly, message_cursor.ptr, message_cursor.len);
+            aws_byte_cursor_advance(&message_cursor, message_cursor.len);
+            break;
+        }
+
+        /* Fast path: whole frame is sitting in the io message, decode it in place */
+        if (aws_h2_frame_decoder_begin(&connection->thread_data.frame_decoder, &message_cursor)) {
+            goto shutdown;
+        }
+
+        if (s_dispatch_frame(connection)) {
+            goto shutdown;
+        }
+    }
+
+    CONNECTION_LOG(TRACE, &connection->base, "Done processing message.");
+
+    /* Increment read window */
+    if (aws_channel_slot_increment_read_window(slot, incoming_message_size)) {
+        CONNECTION_LOGF(
+            ERROR,
+            &connection->base,
+            "Failed to increment read window, error %d (%s). Closing connection.",
+            aws_last_error(),
+            aws_error_name(aws_last_error()));
+        goto shutdown;
+    }
+
+    aws_mem_release(message->allocator, message);
+    return AWS_OP_SUCCESS;
+
+shutdown:
+    aws_mem_release(message->allocator, message);
+    s_shutdown_due_to_error(connection, aws_last_error());
+    return AWS_OP_SUCCESS;
+}
+
+static int s_handler_process_write_message(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    struct aws_io_message *message) {
+
+    (void)slot;
+    (void)message;
+    struct aws_h2_connection *connection = handler->impl;
+
+    /* The h2 handler terminates the channel; nothing upstream should be sending us write messages */
+    CONNECTION_LOG(ERROR, &connection->base, "Unexpected write message, no handler should be upstream of this one.");
+    return aws_raise_error(AWS_ERROR_INVALID_STATE);
+}
+
+static int s_handler_increment_read_window(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    size_t size) {
+
+    struct aws_h2_connection *connection = handler->impl;
+
+    CONNECTION_LOGF(TRACE, &connection->base, "Read window incremented by %zu.", size);
+
+    aws_channel_slot_increment_read_window(slot, size);
+    return AWS_OP_SUCCESS;
+}
+
+static int s_handler_shutdown(
+    struct aws_channel_handler *handler,
+    struct aws_channel_slot *slot,
+    enum aws_channel_direction dir,
+    int error_code,
+    bool free_scarce_resources_immediately) {
+
+    (void)free_scarce_resources_immediately;
+    struct aws_h2_connection *connection = handler->impl;
+
+    CONNECTION_LOGF(
+        TRACE,
+        &connection->base,
+        "Channel shutting down in %s direction with error code %d (%s).",
+        (dir == AWS_CHANNEL_DIR_READ) ? "read" : "write",
+        error_code,
+        aws_error_name(error_code));
+
+    if (dir == AWS_CHANNEL_DIR_READ) {
+        /* This call ensures that no further streams will be created. */
+        s_stop(connection, true /*stop_reading*/, false /*stop_writing*/, false /*schedule_shutdown*/, error_code);
+    } else /* dir == AWS_CHANNEL_DIR_WRITE */ {
+        s_stop(connection, false /*stop_reading*/, true /*stop_writing*/, false /*schedule_shutdown*/, error_code);
+
+        /* Mark all active and pending streams as complete. */
+        int stream_error_code = error_code == AWS_ERROR_SUCCESS ? AWS_ERROR_HTTP_CONNECTION_CLOSED : error_code;
+
+        while (aws_hash_table_get_entry_count(&connection->thread_data.active_streams) > 0) {
+            struct aws_hash_iter iter = aws_hash_iter_begin(&connection->thread_data.active_streams);
+            s_stream_complete(connection, iter.element.value, stream_error_code);
+        }
+
+        /* It's OK to access synced_data.pending_stream_list without holding the lock because
+         * no more streams can be added after s_stop() has been invoked. */
+        while (!aws_linked_list_empty(&connection->synced_data.pending_stream_list)) {
+            struct aws_linked_list_node *node = aws_linked_list_pop_front(&connection->synced_data.pending_stream_list);
+            s_stream_complete(connection, AWS_CONTAINER_OF(node, struct aws_h2_stream, node), stream_error_code);
+        }
+    }
+
+    aws_channel_slot_on_handler_shutdown_complete(slot, dir, error_code, free_scarce_resources_immediately);
+    return AWS_OP_SUCCESS;
+}
+
+static size_t s_handler_initial_window_size(struct aws_channel_handler *handler) {
+    struct aws_h2_connection *connection = handler->impl;
+    return connection->base.initial_window_size;
+}
+
+static size_t s_handler_message_overhead(struct aws_channel_handler *handler) {
+    (void)handler;
+    return 0;
+}
+
+static void s_handler_destroy(struct aws_channel_handler *handler) {
+    struct aws_h2_connection *connection = handler->impl;
+
+    CONNECTION_LOG(TRACE, &connection->base, "Destroying connection.");
+
+    AWS_ASSERT(aws_hash_table_get_entry_count(&connection->thread_data.active_streams) == 0);
+    AWS_ASSERT(aws_linked_list_empty(&connection->thread_data.outgoing_streams));
+    AWS_ASSERT(aws_linked_list_empty(&connection->synced_data.pending_stream_list));
+
+    aws_array_list_clean_up(&connection->thread_data.pending_window_updates);
+    aws_byte_buf_clean_up(&connection->thread_data.encode_scratch_buf);
+    aws_byte_buf_clean_up(&connection->thread_data.frame_assembly_buf);
+    aws_hash_table_clean_up(&connection->thread_data.active_streams);
+    aws_h2_frame_encoder_clean_up(&connection->thread_data.frame_encoder);
+    aws_h2_frame_decoder_clean_up(&connection->thread_data.frame_decoder);
+    aws_http_stream_pool_clean_up(&connection->base.stream_pool);
+    aws_mutex_clean_up(&connection->synced_data.lock);
+    aws_mem_release(connection->base.alloc, connection);
+}
@@ -17,6 +17,7 @@
 
 #include <aws/http/private/h2_frames.h>
 #include <aws/http/private/hpack.h>
+#include <aws/http/private/tracing.h>
 
 #include <aws/common/string.h>
 #include <aws/io/logging.h>
@@ -37,6 +38,12 @@ static const uint32_t s_31_bit_mask = UINT32_MAX >> 1;
 /* The size of each id: value pair in a settings frame */
 static const uint8_t s_setting_block_size = sizeof(uint16_t) + sizeof(uint32_t);
 
+/* Length (3) + type (1) + flags (1) + stream id (4). RFC-7540 4.1 */
+static const size_t s_frame_prefix_size = 9;
+
+/* #TODO handle the SETTINGS_MAX_FRAME_SIZE setting */
+static const uint32_t s_max_frame_size = 16384;
+
 #define DECODER_LOGF(level, decoder, text, ...)                                                                        \
     AWS_LOGF_##level(AWS_LS_HTTP_CONNECTION, "id=%p " text, (decoder)->logging_id, __VA_ARGS__)
 #define DECODER_LOG(level, decoder, text) DECODER_LOGF(level, decoder, "%s", text)
@@ -196,6 +203,56 @@ void aws_h2_decoder_destroy(struct aws_h2_decoder *decoder) {
     aws_mem_release(decoder->alloc, decoder);
 }
 
+/* Load 8 bytes in network order, regardless of host byte-order or alignment.
+ * Compilers reduce this to a single load (plus a byte-swap on little-endian targets). */
+static uint64_t s_load_8_bytes_be(const uint8_t *src) {
+    return ((uint64_t)src[0] << 56) | ((uint64_t)src[1] << 48) | ((uint64_t)src[2] << 40) | ((uint64_t)src[3] << 32) |
+           ((uint64_t)src[4] << 24) | ((uint64_t)src[5] << 16) | ((uint64_t)src[6] << 8) | (uint64_t)src[7];
+}
+
+/* Consume complete, unpadded DATA frames straight off the front of `data`.
+ *
+ * On a bulk download DATA is nearly all of the traffic, so rather than stepping the resumable
+ * state machine through each header byte-range, parse the whole 9-byte frame prefix branchlessly
+ * from one 8-byte load plus shifts and hand the payload cursor to the body callback in a single
+ * call. Only runs between frames (length state, empty scratch). Anything that isn't a
+ * fully-buffered unpadded DATA frame — including frames that would fail validation — is left
+ * untouched for the state machine, which re-reads the prefix from `data`. */
+static void s_decode_data_frames_fast(struct aws_h2_decoder *decoder, struct aws_byte_cursor *data) {
+
+    while (data->len >= s_frame_prefix_size) {
+        const uint64_t prefix = s_load_8_bytes_be(data->ptr);
+        const uint32_t payload_len = (uint32_t)(prefix >> 40);
+        const uint8_t frame_type = (uint8_t)(prefix >> 32);
+        const uint8_t flags = (uint8_t)(prefix >> 24);
+        const uint32_t stream_id = ((((uint32_t)prefix & 0x00FFFFFF) << 8) | data->ptr[8]) & s_31_bit_mask;
+
+        /* The flags test mirrors the header states' padding/priority transitions, so both paths
+         * classify a frame identically */
+        if (frame_type != AWS_H2_FRAME_T_DATA || (flags & (AWS_H2_FRAME_F_PADDED | AWS_H2_FRAME_T_PRIORITY)) ||
+            payload_len > s_max_frame_size || data->len - s_frame_prefix_size < payload_len) {
+            return;
+        }
+
+        aws_byte_cursor_advance(data, s_frame_prefix_size);
+        struct aws_byte_cursor body_to_pass = aws_byte_cursor_advance(data, payload_len);
+
+        DECODER_LOGF(
+            TRACE,
+            decoder,
+            "Fast-path decoded DATA frame (stream id=%" PRIu32 " payload len=%" PRIu32 " flags=%" PRIu8 ")",
+            stream_id,
+            payload_len,
+            flags);
+
+        AWS_HTTP_TRACE4(h2_frame_decode, decoder->logging_id, AWS_H2_FRAME_T_DATA, stream_id, payload_len);
+
+        if (decoder->vtable.on_data) {
+            decoder->vtable.on_data(stream_id, &body_to_pass, decoder->userdata);
+        }
+    }
+}
+
 int aws_h2_decode(struct aws_h2_decoder *decoder, struct aws_byte_cursor *data) {
     AWS_PRECONDITION(decoder);
     AWS_PRECONDITION(data);
@@ -205,6 +262,14 @@ int aws_h2_decode(struct aws_h2_decoder *decoder, struct aws_byte_cursor *data)
     int err = AWS_OP_SUCCESS;
 
     while (data->len) {
+        /* Between frames, complete unpadded DATA frames skip the state machine entirely */
+        if (decoder->state.fn == s_state_fn_length && !decoder->scratch.len) {
+            s_decode_data_frames_fast(decoder, data);
+            if (!data->len) {
+                break;
+            }
+        }
+
         const uint32_t bytes_required = decoder->state.bytes_required;
         if (!decoder->scratch.len && data->len >= bytes_required) {
             /* Easy case, there is no scratch and we have enough data, so just send it to the state */
@@ -305,14 +370,12 @@ static int s_state_fn_length(struct aws_h2_decoder *decoder, struct aws_byte_cur
     /* Assert top byte isn't set */
     AWS_FATAL_ASSERT((payload_len & 0xFF000000) == 0);
 
-    /* #TODO handle the SETTINGS_MAX_FRAME_SIZE setting */
-    static const uint32_t MAX_FRAME_SIZE = 16384;
-    if (payload_len > MAX_FRAME_SIZE) {
+    if (payload_len > s_max_frame_size) {
         DECODER_LOGF(
             ERROR,
             decoder,
             "Decoder's max frame size is %" PRIu32 ", but frame of size %" PRIu32 " was received.",
-            MAX_FRAME_SIZE,
+            s_max_frame_size,
             payload_len);
         return aws_raise_error(AWS_ERROR_HTTP_INVALID_FRAME_SIZE);
     }
@@ -379,6 +442,17 @@ static int s_state_fn_stream_id(struct aws_h2_decoder *decoder, struct aws_byte_
         decoder->frame_in_progress.payload_len,
         decoder->frame_in_progress.flags);
 
+    AWS_HTTP_TRACE4(
+        h2_frame_decode,
+        decoder->logging_id,
+        frame_type,
+        decoder->frame_in_progress.stream_id,
+        decoder->frame_in_progress.payload_len);
+
+    if (frame_type == AWS_H2_FRAME_T_HEADERS) {
+        DECODER_CALL_VTABLE_STREAM(decoder, on_headers);
+    }
+
     if (decoder->frame_in_progress.flags & AWS_H2_FRAME_F_PADDED) {
 
         /* #TODO: Validate that this frame type may have a padding block */
@@ -520,8 +594,41 @@ static int s_state_fn_frame_data(struct aws_h2_decoder *decoder, struct aws_byte
 
     return AWS_OP_SUCCESS;
 }
+/* Run a header-block fragment through the streaming HPACK decoder, firing on_header for every
+ * field that completes. The HPACK context carries partial-integer/string state, so the fragment
+ * may end anywhere — including mid-field at a HEADERS/CONTINUATION boundary. */
+static int s_process_header_block_fragment(struct aws_h2_decoder *decoder, struct aws_byte_cursor *input) {
+
+    const uint32_t remaining_length = decoder->frame_in_progress.payload_len;
+
+    const size_t fragment_len = input->len < remaining_length ? input->len : remaining_length;
+    struct aws_byte_cursor fragment = aws_byte_cursor_advance(input, fragment_len);
+    decoder->frame_in_progress.payload_len -= (uint32_t)fragment.len;
+
+    while (fragment.len) {
+        struct aws_hpack_decode_result result;
+        if (aws_hpack_decode(decoder->hpack, &fragment, &result)) {
+            DECODER_LOGF(
+                ERROR,
+                decoder,
+                "Error decoding header-block fragment: %s",
+                aws_error_name(aws_last_error()));
+            return AWS_OP_ERR;
+        }
+
+        if (result.type == AWS_HPACK_DECODE_T_HEADER_FIELD) {
+            DECODER_CALL_VTABLE_STREAM_ARGS(decoder, on_header, &result.header_field);
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
 static int s_state_fn_frame_headers(struct aws_h2_decoder *decoder, struct aws_byte_cursor *input) {
-    (void)input;
+
+    if (s_process_header_block_fragment(decoder, input)) {
+        return AWS_OP_ERR;
+    }
 
     /* Read padding and/or finish frame */
     if (decoder->frame_in_progress.payload_len == 0) {
@@ -537,7 +644,7 @@ static int s_state_fn_frame_headers(struct aws_h2_decoder *decoder, struct aws_b
         }
     }
 
-    return aws_raise_error(AWS_ERROR_UNIMPLEMENTED);
+    return AWS_OP_SUCCESS;
 }
 static int s_state_fn_frame_priority(struct aws_h2_decoder *decoder, struct aws_byte_cursor *input) {
     (void)input;
@@ -718,18 +825,21 @@ static int s_state_fn_frame_window_update(struct aws_h2_decoder *decoder, struct
     return AWS_OP_SUCCESS;
 }
 static int s_state_fn_frame_continuation(struct aws_h2_decoder *decoder, struct aws_byte_cursor *input) {
-    (void)input;
 
-    /* #TODO Handle the header block */
+    if (s_process_header_block_fragment(decoder, input)) {
+        return AWS_OP_ERR;
+    }
 
     if (decoder->frame_in_progress.payload_len == 0) {
 
         if (decoder->frame_in_progress.flags & AWS_H2_FRAME_F_END_HEADERS) {
             DECODER_CALL_VTABLE_STREAM(decoder, on_end_headers);
         }
+
+        s_decoder_reset_state(decoder);
     }
 
-    return aws_raise_error(AWS_ERROR_UNIMPLEMENTED);
+    return AWS_OP_SUCCESS;
 }
 
 static int s_state_fn_frame_unknown(struct aws_h2_decoder *decoder, struct aws_byte_cursor *input) {
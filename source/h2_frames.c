@@ -15,6 +15,7 @@
 
 #include <aws/http/private/h2_frames.h>
 #include <aws/http/private/hpack.h>
+#include <aws/http/private/tracing.h>
 
 #include <aws/http/request_response.h>
 
@@ -126,76 +127,37 @@ void aws_h2_frame_header_block_clean_up(struct aws_h2_frame_header_block *header
     aws_array_list_clean_up(&header_block->header_fields);
 }
 
-int aws_h2_frame_header_block_get_encoded_length(
-    const struct aws_h2_frame_header_block *header_block,
-    const struct aws_h2_frame_encoder *encoder,
-    size_t *length) {
-    AWS_PRECONDITION(header_block);
-    AWS_PRECONDITION(encoder);
-    AWS_PRECONDITION(length);
-
-    *length = 0;
-
-    AWS_PRECONDITION(header_block);
-    AWS_PRECONDITION(length);
-
-    const size_t num_headers = aws_array_list_length(&header_block->header_fields);
-    for (size_t i = 0; i < num_headers; ++i) {
-
-        const struct aws_h2_frame_header_field *field = NULL;
-        aws_array_list_get_at_ptr(&header_block->header_fields, (void **)&field, i);
-        AWS_ASSERT(field);
-
-        bool found_value = false;
-        const size_t index = aws_hpack_find_index(encoder->hpack, &field->header, &found_value);
-
-        uint8_t prefix_size;
-        /* If a value was found, this is an indexed header */
-        if (found_value) {
-            prefix_size = 7;
-        } else {
-            /* If not indexed, determine the appropriate flags and prefixes */
-            switch (field->hpack_behavior) {
-                case AWS_H2_HEADER_BEHAVIOR_SAVE:
-                    prefix_size = 6;
-                    break;
-                case AWS_H2_HEADER_BEHAVIOR_NO_SAVE:
-                    prefix_size = 4;
-                    break;
-                case AWS_H2_HEADER_BEHAVIOR_NO_FORWARD_SAVE:
-                    prefix_size = 5;
-                    break;
-                default:
-                    /* Unreachable */
-                    AWS_FATAL_ASSERT(false);
+/* Decide whether one string should be Huffman-coded, honoring the encoder's huffman_mode.
+ * In AUTO mode the Huffman length comes from the coder's per-symbol length table, so the
+ * check is a single pass over the string with no encoding work. */
+static bool s_should_huffman_encode(const struct aws_h2_frame_encoder *encoder, struct aws_byte_cursor str) {
+    switch (encoder->huffman_mode) {
+        case AWS_H2_HUFFMAN_MODE_NEVER:
+            return false;
+        case AWS_H2_HUFFMAN_MODE_ALWAYS:
+            return true;
+        case AWS_H2_HUFFMAN_MODE_AUTO:
+            if (str.len == 0) {
+                return false;
             }
-        }
-
-        /* Write the index if indexed, or 0 to signal literal name */
-        *length += aws_hpack_get_encoded_length_integer(index, prefix_size);
-
-        if (!found_value) {
-            /* If not an indexed header, check if the name needs to be written */
-            if (!index) {
-                *length +=
-                    aws_hpack_get_encoded_length_string(encoder->hpack, field->header.name, encoder->use_huffman);
-            }
-
-            /* Value must be written if the field isn't pure indexed */
-            *length += aws_hpack_get_encoded_length_string(encoder->hpack, field->header.value, encoder->use_huffman);
-        }
+            return aws_hpack_get_encoded_length_string(encoder->hpack, str, true) <
+                   aws_hpack_get_encoded_length_string(encoder->hpack, str, false);
     }
 
-    return AWS_OP_SUCCESS;
+    /* unreachable */
+    AWS_ASSUME(false);
 }
 
 int aws_h2_frame_header_block_encode(
     const struct aws_h2_frame_header_block *header_block,
     struct aws_h2_frame_encoder *encoder,
-    struct aws_byte_buf *output) {
+    size_t *out_length) {
     AWS_PRECONDITION(header_block);
     AWS_PRECONDITION(encoder);
-    AWS_PRECONDITION(output);
+    AWS_PRECONDITION(out_length);
+
+    struct aws_byte_buf *output = &encoder->header_block_scratch;
+    output->len = 0;
 
     const size_t num_headers = aws_array_list_length(&header_block->header_fields);
     for (size_t i = 0; i < num_headers; ++i) {
@@ -204,6 +166,18 @@ int aws_h2_frame_header_block_encode(
         aws_array_list_get_at_ptr(&header_block->header_fields, (void **)&field, i);
         AWS_ASSERT(field);
 
+        /* Grow the scratch buffer to a cheap worst case for this field, so the hpack
+         * primitives below never hit a short buffer: each integer prefix is at most 11
+         * bytes, and a Huffman code is at most 30 bits per input byte (RFC-7541). */
+        size_t strings_len = 0;
+        size_t reservation = 0;
+        int oversized = aws_add_size_checked(field->header.name.len, field->header.value.len, &strings_len);
+        oversized |= aws_mul_size_checked(strings_len, 4, &reservation);
+        oversized |= aws_add_size_checked(reservation, output->len + 3 * 11, &reservation);
+        if (oversized || aws_byte_buf_reserve(output, reservation)) {
+            return AWS_OP_ERR;
+        }
+
         bool found_value = true;
         const size_t index = aws_hpack_find_index(encoder->hpack, &field->header, &found_value);
 
@@ -249,7 +223,8 @@ int aws_h2_frame_header_block_encode(
             /* If not an indexed header, check if the name needs to be written */
             if (!index) {
                 scratch = field->header.name;
-                if (aws_hpack_encode_string(encoder->hpack, &scratch, encoder->use_huffman, output)) {
+                if (aws_hpack_encode_string(
+                        encoder->hpack, &scratch, s_should_huffman_encode(encoder, field->header.name), output)) {
                     return AWS_OP_ERR;
                 }
                 AWS_ASSERT(scratch.len == 0);
@@ -257,7 +232,8 @@ int aws_h2_frame_header_block_encode(
 
             /* Value must be written if the field isn't pure indexed */
             scratch = field->header.value;
-            if (aws_hpack_encode_string(encoder->hpack, &scratch, encoder->use_huffman, output)) {
+            if (aws_hpack_encode_string(
+                    encoder->hpack, &scratch, s_should_huffman_encode(encoder, field->header.value), output)) {
                 return AWS_OP_ERR;
             }
             AWS_ASSERT(scratch.len == 0);
@@ -269,8 +245,22 @@ int aws_h2_frame_header_block_encode(
         }
     }
 
+    *out_length = output->len;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_h2_frame_header_block_write(struct aws_h2_frame_encoder *encoder, struct aws_byte_buf *output) {
+    AWS_PRECONDITION(encoder);
+    AWS_PRECONDITION(output);
+
+    struct aws_byte_cursor block = aws_byte_cursor_from_buf(&encoder->header_block_scratch);
+    if (!aws_byte_buf_write_from_whole_cursor(output, block)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
     return AWS_OP_SUCCESS;
 }
+
 int aws_h2_frame_header_block_decode(
     struct aws_h2_frame_header_block *header_block,
     struct aws_h2_frame_decoder *decoder) {
@@ -390,12 +380,12 @@ int aws_h2_frame_header_block_decode(
 /***********************************************************************************************************************
  * Common Header
  **********************************************************************************************************************/
-static int s_frame_header_encode(
-    struct aws_h2_frame_header *header,
+static int s_frame_header_encode_raw(
+    uint8_t type,
+    uint32_t stream_id,
     size_t length,
     uint8_t flags,
     struct aws_byte_buf *output) {
-    AWS_PRECONDITION(header);
     AWS_PRECONDITION(output);
 
     /* Length must fit in 24 bits */
@@ -410,7 +400,7 @@ static int s_frame_header_encode(
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
     /* Write type */
-    if (!aws_byte_buf_write_u8(output, header->type)) {
+    if (!aws_byte_buf_write_u8(output, type)) {
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
     /* Write flags */
@@ -418,13 +408,26 @@ static int s_frame_header_encode(
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
     /* Write stream id (with reserved first bit) */
-    if (!aws_byte_buf_write_be32(output, header->stream_id & s_31_bit_mask)) {
+    if (!aws_byte_buf_write_be32(output, stream_id & s_31_bit_mask)) {
         return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
     }
 
+    AWS_HTTP_TRACE3(h2_frame_encode, type, stream_id, length);
+
     return AWS_OP_SUCCESS;
 }
 
+static int s_frame_header_encode(
+    struct aws_h2_frame_header *header,
+    size_t length,
+    uint8_t flags,
+    struct aws_byte_buf *output) {
+    AWS_PRECONDITION(header);
+    AWS_PRECONDITION(output);
+
+    return s_frame_header_encode_raw(header->type, header->stream_id, length, flags, output);
+}
+
 /***********************************************************************************************************************
  * Encoder
  **********************************************************************************************************************/
@@ -440,11 +443,17 @@ int aws_h2_frame_encoder_init(struct aws_h2_frame_encoder *encoder, struct aws_a
         return AWS_OP_ERR;
     }
 
+    if (aws_byte_buf_init(&encoder->header_block_scratch, allocator, 128)) {
+        aws_hpack_context_destroy(encoder->hpack);
+        return AWS_OP_ERR;
+    }
+
     return AWS_OP_SUCCESS;
 }
 void aws_h2_frame_encoder_clean_up(struct aws_h2_frame_encoder *encoder) {
     AWS_PRECONDITION(encoder);
 
+    aws_byte_buf_clean_up(&encoder->header_block_scratch);
     aws_hpack_context_destroy(encoder->hpack);
 }
 
@@ -672,9 +681,9 @@ int aws_h2_frame_headers_encode(
 
     const size_t output_init_len = output->len;
 
-    /* Calculate length & flags */
+    /* Stage the header block (single HPACK pass) and get its exact length & flags */
     size_t length = 0;
-    if (aws_h2_frame_header_block_get_encoded_length(&frame->header_block, encoder, &length)) {
+    if (aws_h2_frame_header_block_encode(&frame->header_block, encoder, &length)) {
         goto compression_error;
     }
 
@@ -712,8 +721,8 @@ int aws_h2_frame_headers_encode(
         }
     }
     /* Write data */
-    if (aws_h2_frame_header_block_encode(&frame->header_block, encoder, output)) {
-        goto compression_error;
+    if (aws_h2_frame_header_block_write(encoder, output)) {
+        goto write_error;
     }
     /* Write padding */
     for (size_t i = 0; i < frame->pad_length; ++i) {
@@ -1148,7 +1157,7 @@ int aws_h2_frame_push_promise_encode(
     /* Write header */
     uint8_t flags = 0;
     size_t length = 0;
-    if (aws_h2_frame_header_block_get_encoded_length(&frame->header_block, encoder, &length)) {
+    if (aws_h2_frame_header_block_encode(&frame->header_block, encoder, &length)) {
         goto compression_error;
     }
     length += 4; /* Account for promised stream id */
@@ -1173,8 +1182,8 @@ int aws_h2_frame_push_promise_encode(
     aws_byte_buf_write_be32(output, stream_id_bytes);
 
     /* Write header block fragment */
-    if (aws_h2_frame_header_block_encode(&frame->header_block, encoder, output)) {
-        goto compression_error;
+    if (aws_h2_frame_header_block_write(encoder, output)) {
+        goto write_error;
     }
 
     /* Write padding */
@@ -1589,9 +1598,9 @@ int aws_h2_frame_continuation_encode(
 
     const size_t output_init_len = output->len;
 
-    /* Calculate length & flags */
+    /* Stage the header block (single HPACK pass) and get its exact length & flags */
     size_t length = 0;
-    if (aws_h2_frame_header_block_get_encoded_length(&frame->header_block, encoder, &length)) {
+    if (aws_h2_frame_header_block_encode(&frame->header_block, encoder, &length)) {
         goto compression_error;
     }
 
@@ -1606,8 +1615,8 @@ int aws_h2_frame_continuation_encode(
     }
 
     /* Write the header block */
-    if (aws_h2_frame_header_block_encode(&frame->header_block, encoder, output)) {
-        goto compression_error;
+    if (aws_h2_frame_header_block_write(encoder, output)) {
+        goto write_error;
     }
 
     return AWS_OP_SUCCESS;
@@ -1652,3 +1661,123 @@ compression_error:
     *decoder = decoder_init;
     return aws_raise_error(AWS_H2_ERR_COMPRESSION_ERROR);
 }
+
+/***********************************************************************************************************************
+ * Direct Encoding
+ **********************************************************************************************************************/
+/* The small fixed-layout frames below are hot on busy connections (acks, flow-control updates,
+ * stream resets), so they skip the frame-object pipeline and serialize straight into the
+ * outgoing message buffer. Like the frame-object encoders, the output buffer is rolled back
+ * on failure so a frame that didn't fit can be re-attempted in the next message. */
+
+int aws_h2_frame_ping_encode_direct(bool ack, const uint8_t *opaque_data, struct aws_byte_buf *output) {
+    AWS_PRECONDITION(opaque_data);
+    AWS_PRECONDITION(output);
+
+    const size_t output_init_len = output->len;
+
+    const uint8_t flags = ack ? AWS_H2_FRAME_F_ACK : 0;
+    if (s_frame_header_encode_raw(AWS_H2_FRAME_T_PING, 0, s_frame_ping_length, flags, output)) {
+        goto write_error;
+    }
+
+    if (!aws_byte_buf_write(output, opaque_data, s_frame_ping_length)) {
+        goto write_error;
+    }
+
+    return AWS_OP_SUCCESS;
+
+write_error:
+    output->len = output_init_len;
+    return aws_raise_error(AWS_H2_ERR_FRAME_SIZE_ERROR);
+}
+
+int aws_h2_frame_window_update_encode_direct(
+    uint32_t stream_id,
+    uint32_t window_size_increment,
+    struct aws_byte_buf *output) {
+    AWS_PRECONDITION(output);
+
+    if (window_size_increment & s_u32_top_bit_mask) {
+        return aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
+    }
+
+    const size_t output_init_len = output->len;
+
+    if (s_frame_header_encode_raw(AWS_H2_FRAME_T_WINDOW_UPDATE, stream_id, s_frame_window_update_length, 0, output)) {
+        goto write_error;
+    }
+
+    if (!aws_byte_buf_write_be32(output, window_size_increment)) {
+        goto write_error;
+    }
+
+    return AWS_OP_SUCCESS;
+
+write_error:
+    output->len = output_init_len;
+    return aws_raise_error(AWS_H2_ERR_FRAME_SIZE_ERROR);
+}
+
+int aws_h2_frame_rst_stream_encode_direct(
+    uint32_t stream_id,
+    enum aws_h2_error_codes error_code,
+    struct aws_byte_buf *output) {
+    AWS_PRECONDITION(output);
+
+    if (stream_id == 0) {
+        return aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
+    }
+
+    const size_t output_init_len = output->len;
+
+    if (s_frame_header_encode_raw(AWS_H2_FRAME_T_RST_STREAM, stream_id, s_frame_rst_stream_length, 0, output)) {
+        goto write_error;
+    }
+
+    if (!aws_byte_buf_write_be32(output, error_code)) {
+        goto write_error;
+    }
+
+    return AWS_OP_SUCCESS;
+
+write_error:
+    output->len = output_init_len;
+    return aws_raise_error(AWS_H2_ERR_FRAME_SIZE_ERROR);
+}
+
+int aws_h2_frame_settings_encode_direct(
+    bool ack,
+    const struct aws_h2_frame_setting *settings,
+    size_t num_settings,
+    struct aws_byte_buf *output) {
+    AWS_PRECONDITION(settings || num_settings == 0);
+    AWS_PRECONDITION(output);
+
+    /* An ack carries no payload [RFC-7540 6.5] */
+    if (ack && num_settings > 0) {
+        return aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
+    }
+
+    const size_t output_init_len = output->len;
+
+    const uint8_t flags = ack ? AWS_H2_FRAME_F_ACK : 0;
+    if (s_frame_header_encode_raw(AWS_H2_FRAME_T_SETTINGS, 0, num_settings * 6, flags, output)) {
+        goto write_error;
+    }
+
+    for (size_t i = 0; i < num_settings; ++i) {
+        if (!aws_byte_buf_write_be16(output, settings[i].identifier)) {
+            goto write_error;
+        }
+        if (!aws_byte_buf_write_be32(output, settings[i].value)) {
+            goto write_error;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+
+write_error:
+    output->len = output_init_len;
+    return aws_raise_error(AWS_H2_ERR_FRAME_SIZE_ERROR);
+}
@@ -17,6 +17,7 @@
 
 #include <aws/http/private/h2_connection.h>
 
+#include <aws/common/clock.h>
 #include <aws/io/channel.h>
 #include <aws/io/logging.h>
 
@@ -87,6 +88,16 @@ const char *aws_h2_stream_state_to_str(enum aws_h2_stream_state state) {
 /***********************************************************************************************************************
  * Frame Handling
  **********************************************************************************************************************/
+
+/* Peer is done sending on this stream [RFC-7540 5.1] */
+static void s_h2_stream_received_end_stream(struct aws_h2_stream *stream) {
+    if (stream->thread_data.state == AWS_H2_STREAM_STATE_HALF_CLOSED_LOCAL) {
+        s_h2_stream_set_state(stream, AWS_H2_STREAM_STATE_CLOSED);
+    } else {
+        s_h2_stream_set_state(stream, AWS_H2_STREAM_STATE_HALF_CLOSED_REMOTE);
+    }
+}
+
 static int s_h2_stream_handle_data(struct aws_h2_stream *stream, struct aws_h2_frame_decoder *decoder) {
     AWS_PRECONDITION(decoder->header.type == AWS_H2_FRAME_T_DATA);
 
@@ -96,12 +107,23 @@ static int s_h2_stream_handle_data(struct aws_h2_stream *stream, struct aws_h2_f
     }
 
     /* Call user callback */
-    stream->base.on_incoming_body(&stream->base, &frame.data, stream->base.user_data);
+    if (stream->base.incoming_body_sink) {
+        if (aws_byte_buf_append_dynamic(stream->base.incoming_body_sink, &frame.data)) {
+            STREAM_LOG(ERROR, stream, "Failed to append incoming body to sink buffer");
+            return AWS_OP_ERR;
+        }
+    } else if (stream->base.on_incoming_body) {
+        stream->base.on_incoming_body(&stream->base, &frame.data, stream->base.user_data);
+    }
 
     if (!stream->base.manual_window_management) {
         /* Increment read window */
     }
 
+    if (frame.end_stream) {
+        s_h2_stream_received_end_stream(stream);
+    }
+
     return AWS_OP_SUCCESS;
 }
 static int s_h2_stream_handle_headers(struct aws_h2_stream *stream, struct aws_h2_frame_decoder *decoder) {
@@ -113,19 +135,30 @@ static int s_h2_stream_handle_headers(struct aws_h2_stream *stream, struct aws_h
         return AWS_OP_ERR;
     }
 
-    stream->base.on_incoming_headers(
-        &stream->base,
-        AWS_HTTP_HEADER_BLOCK_MAIN,
-        frame.header_block.header_fields.data,
-        frame.header_block.header_fields.length,
-        stream->base.user_data);
+    if (stream->base.on_incoming_headers) {
+        stream->base.on_incoming_headers(
+            &stream->base,
+            AWS_HTTP_HEADER_BLOCK_MAIN,
+            frame.header_block.header_fields.data,
+            frame.header_block.header_fields.length,
+            stream->base.user_data);
+    }
 
     if (frame.end_headers) {
         STREAM_LOG(DEBUG, stream, "HEADERS frame is self-containing, calling header_block_done");
-        stream->base.on_incoming_header_block_done(&stream->base, false, stream->base.user_data);
+        if (stream->base.on_incoming_header_block_done) {
+            stream->base.on_incoming_header_block_done(&stream->base, false, stream->base.user_data);
+        }
+
+        if (frame.end_stream) {
+            s_h2_stream_received_end_stream(stream);
+        }
     } else {
         STREAM_LOG(DEBUG, stream, "HEADERS frame does not have END_HEADERS set, expecting following CONTINUATION");
         stream->thread_data.expects_continuation = true;
+
+        /* END_STREAM applies once the header block's trailing CONTINUATION frames have arrived */
+        stream->thread_data.pending_received_end_stream = frame.end_stream;
     }
 
     return AWS_OP_SUCCESS;
@@ -153,10 +186,13 @@ static int s_h2_stream_handle_rst_stream(struct aws_h2_stream *stream, struct aw
         return AWS_OP_ERR;
     }
 
-    s_h2_stream_set_state(stream, AWS_H2_STREAM_STATE_CLOSED);
+    STREAM_LOGF(DEBUG, stream, "Peer reset stream with h2 error code %" PRIu32, (uint32_t)frame.error_code);
+
+    /* Record why the stream ended; the connection fires on_complete when it sees the CLOSED state */
+    stream->thread_data.completion_error_code =
+        frame.error_code == AWS_H2_ERR_NO_ERROR ? AWS_ERROR_SUCCESS : AWS_ERROR_HTTP_PROTOCOL_ERROR;
 
-    /* Call user callback stating frame was reset */
-    stream->base.on_complete(&stream->base, frame.error_code, stream->base.user_data);
+    s_h2_stream_set_state(stream, AWS_H2_STREAM_STATE_CLOSED);
 
     return AWS_OP_SUCCESS;
 }
@@ -212,7 +248,14 @@ static int s_h2_stream_handle_continuation(struct aws_h2_stream *stream, struct
     if (frame.end_headers) {
         STREAM_LOG(TRACE, stream, "CONTINUATION frames complete, calling header_block_done");
         stream->thread_data.expects_continuation = false;
-        stream->base.on_incoming_header_block_done(&stream->base, false, stream->base.user_data);
+        if (stream->base.on_incoming_header_block_done) {
+            stream->base.on_incoming_header_block_done(&stream->base, false, stream->base.user_data);
+        }
+
+        if (stream->thread_data.pending_received_end_stream) {
+            stream->thread_data.pending_received_end_stream = false;
+            s_h2_stream_received_end_stream(stream);
+        }
     } else {
         STREAM_LOG(TRACE, stream, "CONTINUATION END_HEADERS not set, expecting CONTINUATION frame next");
         stream->thread_data.expects_continuation = true;
@@ -306,9 +349,20 @@ static int s_h2_stream_state_open(struct aws_h2_stream *stream, struct aws_h2_fr
 
 static int s_h2_stream_state_half_closed_local(struct aws_h2_stream *stream, struct aws_h2_frame_decoder *decoder) {
 
+    /* We're done sending, but the peer may still send us anything [RFC-7540 5.1] */
     const enum aws_h2_frame_type frame_type = decoder->header.type;
     switch (frame_type) {
-            /* #TODO Handle basically every other frame type */
+        case AWS_H2_FRAME_T_DATA:
+            return s_h2_stream_handle_data(stream, decoder);
+
+        case AWS_H2_FRAME_T_HEADERS:
+            return s_h2_stream_handle_headers(stream, decoder);
+
+        case AWS_H2_FRAME_T_PRIORITY:
+            return s_h2_stream_handle_priority(stream, decoder);
+
+        case AWS_H2_FRAME_T_CONTINUATION:
+            return s_h2_stream_handle_continuation(stream, decoder);
 
         case AWS_H2_FRAME_T_WINDOW_UPDATE:
             return s_h2_stream_handle_window_update(stream, decoder);
@@ -380,7 +434,7 @@ struct aws_h2_stream *aws_h2_stream_new(
 
     struct aws_h2_connection *connection = AWS_CONTAINER_OF(client_connection, struct aws_h2_connection, base);
 
-    struct aws_h2_stream *stream = aws_mem_calloc(client_connection->alloc, 1, sizeof(struct aws_h2_stream));
+    struct aws_h2_stream *stream = aws_http_stream_pool_acquire(&client_connection->stream_pool);
     if (!stream) {
         return NULL;
     }
@@ -391,17 +445,44 @@ struct aws_h2_stream *aws_h2_stream_new(
     stream->base.owning_connection = client_connection;
     stream->base.user_data = options->user_data;
     stream->base.on_incoming_headers = options->on_response_headers;
+    stream->base.on_incoming_trailers = options->on_incoming_trailers;
     stream->base.on_incoming_header_block_done = options->on_response_header_block_done;
     stream->base.on_incoming_body = options->on_response_body;
+    stream->base.incoming_body_sink = options->response_body_sink;
     stream->base.on_complete = options->on_complete;
 
     /* Stream refcount starts at 2. 1 for user and 1 for connection to release it's done with the stream */
     aws_atomic_init_int(&stream->base.refcount, 2);
 
+    /* Same clock the channel uses, so the other metric timestamps are comparable */
+    aws_high_res_clock_get_ticks(&stream->base.metrics.activated_timestamp_ns);
+
     /* Init H2 specific stuff */
     *((uint32_t *)&stream->id) = aws_h2_connection_get_next_stream_id(connection);
+    if (stream->id == 0) {
+        /* Connection has run out of stream ids, aws_h2_connection_get_next_stream_id raised the error */
+        aws_http_stream_pool_release(&client_connection->stream_pool, stream);
+        return NULL;
+    }
+
     s_h2_stream_set_state(stream, AWS_H2_STREAM_STATE_IDLE);
 
+    stream->base.client_data = &stream->base.client_or_server_data.client;
+    stream->base.client_data->response_status = AWS_HTTP_STATUS_UNKNOWN;
+
+    /* Keep the request alive until the stream is done encoding it. No copy is made,
+     * headers and body are read straight out of the message from the event-loop thread. */
+    aws_http_message_acquire(options->request);
+    stream->thread_data.request = options->request;
+    stream->thread_data.request_body = aws_http_message_get_body_stream(options->request);
+
+    /* Scheduling weight, clamped to the legal h2 range [RFC-7540 5.3.2] */
+    if (options->stream_weight == 0) {
+        stream->thread_data.weight = AWS_H2_STREAM_DEFAULT_WEIGHT;
+    } else {
+        stream->thread_data.weight = options->stream_weight > 256 ? 256 : options->stream_weight;
+    }
+
     STREAM_LOG(DEBUG, stream, "Created stream");
 
     return stream;
@@ -412,7 +493,29 @@ static void s_stream_destroy(struct aws_http_stream *stream_base) {
 
     STREAM_LOG(DEBUG, stream, "Destroying stream");
 
-    aws_mem_release(stream->base.alloc, stream);
+    aws_http_message_destroy(stream->thread_data.request);
+
+    aws_http_stream_pool_release(&stream->base.owning_connection->stream_pool, stream);
+}
+
+void aws_h2_stream_on_frame_sent(struct aws_h2_stream *stream, enum aws_h2_frame_type type, bool end_stream) {
+    AWS_PRECONDITION(stream);
+
+    if (type == AWS_H2_FRAME_T_HEADERS) {
+        stream->thread_data.sent_headers = true;
+        if (stream->thread_data.state == AWS_H2_STREAM_STATE_IDLE) {
+            s_h2_stream_set_state(stream, AWS_H2_STREAM_STATE_OPEN);
+        }
+    }
+
+    if (end_stream) {
+        stream->thread_data.sent_end_stream = true;
+        if (stream->thread_data.state == AWS_H2_STREAM_STATE_HALF_CLOSED_REMOTE) {
+            s_h2_stream_set_state(stream, AWS_H2_STREAM_STATE_CLOSED);
+        } else {
+            s_h2_stream_set_state(stream, AWS_H2_STREAM_STATE_HALF_CLOSED_LOCAL);
+        }
+    }
 }
 
 int aws_h2_stream_handle_frame(struct aws_h2_stream *stream, struct aws_h2_frame_decoder *decoder) {
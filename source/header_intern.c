@@ -0,0 +1,177 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/header_intern.h>
+
+#include <string.h>
+
+/* clang-format off */
+#define AWS_HTTP_INTERN(STR) \
+    {.name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL(STR)}
+#define AWS_HTTP_INTERN_ENUM(STR, ENUM) \
+    {.name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL(STR), .name_enum = (ENUM)}
+
+/* The header names real workloads see constantly.
+ * `lowercase` and `hash` are filled in at library init.
+ * Entries whose name matters to internal processing also carry its enum. */
+static struct aws_http_interned_header s_interned_headers[] = {
+    AWS_HTTP_INTERN("Accept"),
+    AWS_HTTP_INTERN("Accept-Charset"),
+    AWS_HTTP_INTERN("Accept-Encoding"),
+    AWS_HTTP_INTERN("Accept-Language"),
+    AWS_HTTP_INTERN("Accept-Ranges"),
+    AWS_HTTP_INTERN("Age"),
+    AWS_HTTP_INTERN("Allow"),
+    AWS_HTTP_INTERN("Authorization"),
+    AWS_HTTP_INTERN("Cache-Control"),
+    AWS_HTTP_INTERN_ENUM("Connection", AWS_HTTP_HEADER_CONNECTION),
+    AWS_HTTP_INTERN("Content-Disposition"),
+    AWS_HTTP_INTERN("Content-Encoding"),
+    AWS_HTTP_INTERN("Content-Language"),
+    AWS_HTTP_INTERN_ENUM("Content-Length", AWS_HTTP_HEADER_CONTENT_LENGTH),
+    AWS_HTTP_INTERN("Content-Location"),
+    AWS_HTTP_INTERN("Content-Range"),
+    AWS_HTTP_INTERN("Content-Type"),
+    AWS_HTTP_INTERN("Cookie"),
+    AWS_HTTP_INTERN("Date"),
+    AWS_HTTP_INTERN("ETag"),
+    AWS_HTTP_INTERN_ENUM("Expect", AWS_HTTP_HEADER_EXPECT),
+    AWS_HTTP_INTERN("Expires"),
+    AWS_HTTP_INTERN("From"),
+    AWS_HTTP_INTERN("Host"),
+    AWS_HTTP_INTERN("If-Match"),
+    AWS_HTTP_INTERN("If-Modified-Since"),
+    AWS_HTTP_INTERN("If-None-Match"),
+    AWS_HTTP_INTERN("If-Range"),
+    AWS_HTTP_INTERN("If-Unmodified-Since"),
+    AWS_HTTP_INTERN("Last-Modified"),
+    AWS_HTTP_INTERN("Link"),
+    AWS_HTTP_INTERN("Location"),
+    AWS_HTTP_INTERN("Max-Forwards"),
+    AWS_HTTP_INTERN("Proxy-Authenticate"),
+    AWS_HTTP_INTERN("Proxy-Authorization"),
+    AWS_HTTP_INTERN("Range"),
+    AWS_HTTP_INTERN("Referer"),
+    AWS_HTTP_INTERN("Retry-After"),
+    AWS_HTTP_INTERN("Sec-WebSocket-Accept"),
+    AWS_HTTP_INTERN("Sec-WebSocket-Extensions"),
+    AWS_HTTP_INTERN("Sec-WebSocket-Key"),
+    AWS_HTTP_INTERN("Sec-WebSocket-Protocol"),
+    AWS_HTTP_INTERN("Sec-WebSocket-Version"),
+    AWS_HTTP_INTERN("Server"),
+    AWS_HTTP_INTERN("Set-Cookie"),
+    AWS_HTTP_INTERN("Strict-Transport-Security"),
+    AWS_HTTP_INTERN_ENUM("Transfer-Encoding", AWS_HTTP_HEADER_TRANSFER_ENCODING),
+    AWS_HTTP_INTERN("Upgrade"),
+    AWS_HTTP_INTERN("User-Agent"),
+    AWS_HTTP_INTERN("Vary"),
+    AWS_HTTP_INTERN("Via"),
+    AWS_HTTP_INTERN("WWW-Authenticate"),
+};
+/* clang-format on */
+
+enum {
+    /* Power of 2, keeps the probe table's load factor under 1/2 */
+    PROBE_TABLE_CAPACITY = 128,
+};
+
+/* Open-addressing probe table. Each slot holds an index into s_interned_headers plus 1,
+ * so 0 means "empty slot". Built once at library init, read-only afterwards. */
+static uint8_t s_probe_table[PROBE_TABLE_CAPACITY];
+
+/* One buffer holding the case-folded copy of every interned name */
+static uint8_t *s_lowercase_storage;
+static struct aws_allocator *s_intern_alloc;
+
+uint32_t aws_http_header_name_hash(struct aws_byte_cursor name) {
+    /* FNV-1a over the case-folded name */
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < name.len; ++i) {
+        uint8_t c = name.ptr[i];
+        if (c >= 'A' && c <= 'Z') {
+            c += ('a' - 'A');
+        }
+        hash = (hash ^ c) * 16777619U;
+    }
+    return hash;
+}
+
+void aws_http_header_intern_table_init(struct aws_allocator *alloc) {
+    AWS_FATAL_ASSERT(AWS_ARRAY_SIZE(s_interned_headers) < UINT8_MAX);
+    AWS_FATAL_ASSERT(AWS_ARRAY_SIZE(s_interned_headers) < PROBE_TABLE_CAPACITY / 2);
+
+    size_t total_len = 0;
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(s_interned_headers); ++i) {
+        total_len += s_interned_headers[i].name.len;
+    }
+
+    s_lowercase_storage = aws_mem_acquire(alloc, total_len);
+    AWS_FATAL_ASSERT(s_lowercase_storage);
+    s_intern_alloc = alloc;
+
+    uint8_t *pos = s_lowercase_storage;
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(s_interned_headers); ++i) {
+        struct aws_http_interned_header *entry = &s_interned_headers[i];
+
+        entry->hash = aws_http_header_name_hash(entry->name);
+
+        entry->lowercase.ptr = pos;
+        entry->lowercase.len = entry->name.len;
+        for (size_t c = 0; c < entry->name.len; ++c) {
+            uint8_t ch = entry->name.ptr[c];
+            if (ch >= 'A' && ch <= 'Z') {
+                ch += ('a' - 'A');
+            }
+            *pos++ = ch;
+        }
+
+        size_t slot = entry->hash & (PROBE_TABLE_CAPACITY - 1);
+        while (s_probe_table[slot]) {
+            slot = (slot + 1) & (PROBE_TABLE_CAPACITY - 1);
+        }
+        s_probe_table[slot] = (uint8_t)(i + 1);
+    }
+}
+
+void aws_http_header_intern_table_clean_up(void) {
+    aws_mem_release(s_intern_alloc, s_lowercase_storage);
+    s_lowercase_storage = NULL;
+    s_intern_alloc = NULL;
+    memset(s_probe_table, 0, sizeof(s_probe_table));
+}
+
+const struct aws_http_interned_header *aws_http_header_intern_lookup(struct aws_byte_cursor name) {
+    const uint32_t hash = aws_http_header_name_hash(name);
+
+    size_t slot = hash & (PROBE_TABLE_CAPACITY - 1);
+    while (s_probe_table[slot]) {
+        const struct aws_http_interned_header *entry = &s_interned_headers[s_probe_table[slot] - 1];
+
+        if (entry->hash == hash && entry->name.len == name.len) {
+            /* The spellings seen in practice (lowercase on the h2 wire, conventional
+             * capitalization everywhere else) are confirmed with a single memcmp.
+             * Anything odder falls through to the case-insensitive comparison. */
+            if (memcmp(name.ptr, entry->lowercase.ptr, name.len) == 0 ||
+                memcmp(name.ptr, entry->name.ptr, name.len) == 0 ||
+                aws_byte_cursor_eq_ignore_case(&name, &entry->name)) {
+                return entry;
+            }
+        }
+
+        slot = (slot + 1) & (PROBE_TABLE_CAPACITY - 1);
+    }
+
+    return NULL;
+}
@@ -25,6 +25,152 @@
 
 struct aws_huffman_symbol_coder *hpack_get_coder(void);
 
+/* Defined in the generated hpack_header_static.c */
+size_t hpack_static_table_find(
+    const struct aws_byte_cursor *name,
+    const struct aws_byte_cursor *value,
+    bool *out_found_value);
+
+/* Initial slot count for a dynamic table's backing storage; it doubles on demand up to the
+ * context's max_elements */
+static const size_t s_hpack_dynamic_table_initial_elements = 8;
+
+/* The HPACK code list, used to precompute the fast decoding table below */
+static const struct hpack_huffman_code {
+    uint16_t symbol;
+    uint32_t pattern;
+    uint8_t num_bits;
+} s_huffman_code_list[] = {
+#define HUFFMAN_CODE(psym, pbits_str, pcode, plen) {.symbol = (psym), .pattern = (pcode), .num_bits = (plen)},
+#include <aws/http/private/hpack_huffman_static_table.def>
+#undef HUFFMAN_CODE
+};
+
+/* Multi-bit Huffman decoding table, indexed by the next 8 bits of input.
+ * Codes of 8 bits or fewer (the letters, digits, and common punctuation that dominate header
+ * text) decode with a single lookup per symbol. Entries with num_bits 0 mean the code is
+ * longer than 8 bits; those rare symbols take the bit-tree path instead.
+ * Filled out once by aws_hpack_static_table_init(). */
+static struct hpack_huffman_fast_entry {
+    uint8_t symbol;
+    uint8_t num_bits; /* 0 means "code is longer than 8 bits" */
+} s_huffman_fast_table[256];
+
+static void s_huffman_fast_table_init(void) {
+    AWS_ZERO_ARRAY(s_huffman_fast_table);
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(s_huffman_code_list); ++i) {
+        const struct hpack_huffman_code *code = &s_huffman_code_list[i];
+        if (code->num_bits > 8) {
+            continue;
+        }
+
+        /* Every 8-bit index starting with this code's pattern decodes to this symbol */
+        const uint8_t prefix = (uint8_t)(code->pattern << (8 - code->num_bits));
+        const size_t num_fillers = (size_t)1 << (8 - code->num_bits);
+        for (size_t filler = 0; filler < num_fillers; ++filler) {
+            s_huffman_fast_table[prefix | filler].symbol = (uint8_t)code->symbol;
+            s_huffman_fast_table[prefix | filler].num_bits = code->num_bits;
+        }
+    }
+}
+
+/* Huffman-decode one chunk of a string, consuming 8 bits per step for short codes.
+ * Input bits accumulate MSB-first in a 64-bit window; the next code starts at bit `bit_count - 1`.
+ * When `final` is false the chunk ends mid-string (ex: at a frame boundary): the whole input is
+ * consumed and any bits too short to decode are left in the window for the next chunk.
+ * Only a final chunk may end in EOS padding. */
+static int s_huffman_decode_chunk(
+    uint64_t *window_in_out,
+    size_t *bit_count_in_out,
+    struct aws_byte_cursor *to_decode,
+    struct aws_byte_buf *output,
+    bool final) {
+
+    struct aws_huffman_symbol_coder *coder = hpack_get_coder();
+
+    uint64_t window = *window_in_out;
+    size_t bit_count = *bit_count_in_out;
+
+    while (true) {
+        /* Top up the bit window */
+        while (bit_count <= 56 && to_decode->len) {
+            window = (window << 8) | *to_decode->ptr;
+            aws_byte_cursor_advance(to_decode, 1);
+            bit_count += 8;
+        }
+
+        if (bit_count == 0) {
+            break;
+        }
+
+        /* Mid-string, fewer than 8 bits can't match anything yet; wait for the next chunk.
+         * (The top-up loop guarantees the input is already drained here.) */
+        if (!final && bit_count < 8) {
+            break;
+        }
+
+        /* Look up the next 8 bits; a partial tail is padded out with 1s, which can only
+         * shorten-match codes actually present in the remaining bits */
+        uint8_t index;
+        if (bit_count >= 8) {
+            index = (uint8_t)(window >> (bit_count - 8));
+        } else {
+            index = (uint8_t)((window << (8 - bit_count)) | ((1U << (8 - bit_count)) - 1));
+        }
+
+        const struct hpack_huffman_fast_entry entry = s_huffman_fast_table[index];
+        if (entry.num_bits && entry.num_bits <= bit_count) {
+            if (!aws_byte_buf_write_u8(output, entry.symbol)) {
+                return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+            }
+            bit_count -= entry.num_bits;
+            continue;
+        }
+
+        /* Trailing bits that are all 1s are padding. More than 7 of them would be an
+         * encodable code (or EOS), which the paths below reject. */
+        if (bit_count < 8 && (window & (((uint64_t)1 << bit_count) - 1)) == (((uint64_t)1 << bit_count) - 1)) {
+            break;
+        }
+
+        /* Mid-string, a long code (up to 30 bits) may continue in the next chunk */
+        if (!final && bit_count < 30) {
+            break;
+        }
+
+        /* Long code (9-30 bits): walk the generated code tree on the next 32 bits */
+        uint32_t tree_bits;
+        if (bit_count >= 32) {
+            tree_bits = (uint32_t)(window >> (bit_count - 32));
+        } else {
+            tree_bits = (uint32_t)((window << (32 - bit_count)) | (((uint64_t)1 << (32 - bit_count)) - 1));
+        }
+
+        uint8_t symbol;
+        uint8_t num_bits = coder->decode(tree_bits, &symbol, coder->userdata);
+        if (num_bits == 0 || num_bits > bit_count) {
+            return aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
+        }
+
+        if (!aws_byte_buf_write_u8(output, symbol)) {
+            return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+        }
+        bit_count -= num_bits;
+    }
+
+    *window_in_out = window;
+    *bit_count_in_out = bit_count;
+    return AWS_OP_SUCCESS;
+}
+
+/* Huffman-decode a whole string in one shot */
+static int s_huffman_decode(struct aws_byte_cursor *to_decode, struct aws_byte_buf *output) {
+    uint64_t window = 0;
+    size_t bit_count = 0;
+    return s_huffman_decode_chunk(&window, &bit_count, to_decode, output, true /*final*/);
+}
+
 size_t aws_hpack_get_encoded_length_integer(uint64_t integer, uint8_t prefix_size) {
     const uint8_t cut_bits = 8 - prefix_size;
     const uint8_t prefix_mask = UINT8_MAX >> cut_bits;
@@ -164,21 +310,6 @@ struct aws_http_header s_static_header_table[] = {
 };
 static const size_t s_static_header_table_size = AWS_ARRAY_SIZE(s_static_header_table);
 
-struct aws_byte_cursor s_static_header_table_name_only[] = {
-#define HEADER(_index, _name) [_index] = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL(_name),
-#define HEADER_WITH_VALUE(_index, _name, _value) HEADER(_index, _name)
-
-#include <aws/http/private/hpack_header_static_table.def>
-
-#undef HEADER
-#undef HEADER_WITH_VALUE
-};
-
-/* aws_http_header * -> size_t */
-static struct aws_hash_table s_static_header_reverse_lookup;
-/* aws_byte_cursor * -> size_t */
-static struct aws_hash_table s_static_header_reverse_lookup_name_only;
-
 static uint64_t s_header_hash(const void *key) {
     const struct aws_http_header *header = key;
 
@@ -198,51 +329,47 @@ static bool s_header_eq(const void *a, const void *b) {
 }
 
 void aws_hpack_static_table_init(struct aws_allocator *allocator) {
+    /* Static-table reverse lookup is a generated perfect hash (hpack_header_static.c)
+     * and needs no runtime setup; only the huffman fast table is filled out here. */
+    (void)allocator;
 
-    int result = aws_hash_table_init(
-        &s_static_header_reverse_lookup,
-        allocator,
-        s_static_header_table_size - 1,
-        s_header_hash,
-        s_header_eq,
-        NULL,
-        NULL);
-    AWS_FATAL_ASSERT(AWS_OP_SUCCESS == result);
-
-    result = aws_hash_table_init(
-        &s_static_header_reverse_lookup_name_only,
-        allocator,
-        s_static_header_table_size - 1,
-        aws_hash_byte_cursor_ptr,
-        (aws_hash_callback_eq_fn *)aws_byte_cursor_eq,
-        NULL,
-        NULL);
-    AWS_FATAL_ASSERT(AWS_OP_SUCCESS == result);
-
-    /* Process in reverse so that name_only prefers lower indices */
-    for (size_t i = s_static_header_table_size; i > 0; --i) {
-        /* Thanks, 1-based indexing. Thanks. */
-        const size_t static_index = i - 1;
-
-        result = aws_hash_table_put(
-            &s_static_header_reverse_lookup, &s_static_header_table[static_index], (void *)static_index, NULL);
-        AWS_FATAL_ASSERT(AWS_OP_SUCCESS == result);
-
-        result = aws_hash_table_put(
-            &s_static_header_reverse_lookup_name_only,
-            &s_static_header_table_name_only[static_index],
-            (void *)(static_index),
-            NULL);
-        AWS_FATAL_ASSERT(AWS_OP_SUCCESS == result);
-    }
+    s_huffman_fast_table_init();
 }
 
-void aws_hpack_static_table_clean_up() {
-    aws_hash_table_clean_up(&s_static_header_reverse_lookup);
-    aws_hash_table_clean_up(&s_static_header_reverse_lookup_name_only);
-}
+void aws_hpack_static_table_clean_up() {}
+
+/* Never grow the dynamic table beyond this, no matter what size update the peer sends */
+static const size_t s_hpack_dynamic_table_max_size = 4096;
 
-/* Insertion is backwards, indexing is forwards */
+/* Partially-decoded HPACK prefixed integer, carried across input boundaries */
+struct hpack_progress_integer {
+    enum {
+        HPACK_INTEGER_STATE_INIT = 0,
+        HPACK_INTEGER_STATE_VALUE,
+    } state;
+    uint8_t bit_count;
+};
+
+/* Partially-decoded HPACK string literal, carried across input boundaries */
+struct hpack_progress_string {
+    enum {
+        HPACK_STRING_STATE_INIT = 0,
+        HPACK_STRING_STATE_LENGTH,
+        HPACK_STRING_STATE_VALUE,
+    } state;
+    bool use_huffman;
+    uint64_t length; /* encoded bytes of the string still unread */
+    struct hpack_progress_integer integer;
+
+    /* Bits of a Huffman code cut off by the previous input boundary */
+    uint64_t window;
+    size_t bit_count;
+};
+
+/* The dynamic table is a ring buffer: insertion moves index_0 backwards, indexing walks forwards.
+ * Insert and evict are O(1) pointer moves; encoder-side reverse lookup is O(1) through two hash
+ * tables (name+value, and name-only) that store each entry's absolute ring position, so
+ * aws_hpack_find_index() never scans the table regardless of occupancy. */
 struct aws_hpack_context {
     struct aws_allocator *allocator;
 
@@ -250,7 +377,12 @@ struct aws_hpack_context {
     struct aws_huffman_decoder decoder;
 
     struct {
+        /* Circular buffer of `allocated_elements` slots.  Storage grows geometrically on
+         * demand up to `max_elements` (the logical HPACK cap), so the thousands of
+         * connections whose peers barely use the dynamic table don't each pay for a
+         * max-sized, mostly-empty table. */
         struct aws_http_header *buffer;
+        size_t allocated_elements;
         size_t max_elements;
         size_t num_elements;
         size_t index_0;
@@ -260,6 +392,33 @@ struct aws_hpack_context {
         /* aws_byte_cursor * -> size_t */
         struct aws_hash_table reverse_lookup_name_only;
     } dynamic_table;
+
+    /* In-progress entry state for the streaming aws_hpack_decode() path */
+    struct {
+        enum {
+            HPACK_ENTRY_STATE_BEGIN = 0,
+            HPACK_ENTRY_STATE_INDEXED,
+            HPACK_ENTRY_STATE_LITERAL_INDEX,
+            HPACK_ENTRY_STATE_LITERAL_NAME,
+            HPACK_ENTRY_STATE_LITERAL_VALUE,
+            HPACK_ENTRY_STATE_RESIZE,
+        } state;
+
+        uint8_t prefix_size; /* of the integer currently decoding */
+        bool save;           /* insert the finished field into the dynamic table */
+        uint64_t integer_value;
+        struct hpack_progress_integer integer;
+        struct hpack_progress_string string;
+
+        /* Decoded name+value bytes. Bytes below persistent_len back dynamic-table entries
+         * and must not be overwritten.
+         * #TODO dynamic-table entries should own their bytes; growing this buffer reallocates
+         * out from under them (the whole-frame decoder's header_scratch shares this flaw). */
+        struct aws_byte_buf scratch;
+        size_t persistent_len;
+        size_t entry_start;
+        size_t name_len;
+    } decode;
 };
 
 struct aws_hpack_context *aws_hpack_context_new(struct aws_allocator *allocator, size_t max_dynamic_elements) {
@@ -276,13 +435,20 @@ struct aws_hpack_context *aws_hpack_context_new(struct aws_allocator *allocator,
     aws_huffman_encoder_init(&context->encoder, hpack_coder);
     aws_huffman_decoder_init(&context->decoder, hpack_coder);
 
-    /* Initialize dynamic table */
-    if (max_dynamic_elements) {
-        context->dynamic_table.buffer = aws_mem_calloc(allocator, max_dynamic_elements, sizeof(struct aws_http_header));
+    /* Initialize dynamic table.  Storage starts small and grows with actual use; the hash
+     * tables likewise size themselves as entries arrive. */
+    size_t initial_elements = max_dynamic_elements;
+    if (initial_elements > s_hpack_dynamic_table_initial_elements) {
+        initial_elements = s_hpack_dynamic_table_initial_elements;
+    }
+
+    if (initial_elements) {
+        context->dynamic_table.buffer = aws_mem_calloc(allocator, initial_elements, sizeof(struct aws_http_header));
         if (!context->dynamic_table.buffer) {
             goto dynamic_table_buffer_failed;
         }
     }
+    context->dynamic_table.allocated_elements = initial_elements;
     context->dynamic_table.max_elements = max_dynamic_elements;
     context->dynamic_table.num_elements = 0;
     context->dynamic_table.index_0 = 0;
@@ -290,7 +456,7 @@ struct aws_hpack_context *aws_hpack_context_new(struct aws_allocator *allocator,
     if (aws_hash_table_init(
             &context->dynamic_table.reverse_lookup,
             allocator,
-            max_dynamic_elements,
+            initial_elements,
             s_header_hash,
             s_header_eq,
             NULL,
@@ -301,7 +467,7 @@ struct aws_hpack_context *aws_hpack_context_new(struct aws_allocator *allocator,
     if (aws_hash_table_init(
             &context->dynamic_table.reverse_lookup_name_only,
             allocator,
-            max_dynamic_elements,
+            initial_elements,
             aws_hash_byte_cursor_ptr,
             (aws_hash_callback_eq_fn *)aws_byte_cursor_eq,
             NULL,
@@ -309,8 +475,15 @@ struct aws_hpack_context *aws_hpack_context_new(struct aws_allocator *allocator,
         goto name_only_failed;
     }
 
+    if (aws_byte_buf_init(&context->decode.scratch, allocator, 512)) {
+        goto decode_scratch_failed;
+    }
+
     return context;
 
+decode_scratch_failed:
+    aws_hash_table_clean_up(&context->dynamic_table.reverse_lookup_name_only);
+
 name_only_failed:
     aws_hash_table_clean_up(&context->dynamic_table.reverse_lookup);
 
@@ -334,6 +507,7 @@ void aws_hpack_context_destroy(struct aws_hpack_context *context) {
     }
     aws_hash_table_clean_up(&context->dynamic_table.reverse_lookup);
     aws_hash_table_clean_up(&context->dynamic_table.reverse_lookup_name_only);
+    aws_byte_buf_clean_up(&context->decode.scratch);
     aws_mem_release(context->allocator, context);
 }
 
@@ -352,7 +526,7 @@ const struct aws_http_header *aws_hpack_get_header(const struct aws_hpack_contex
     index -= s_static_header_table_size;
     AWS_ASSERT(index < context->dynamic_table.num_elements);
     return &context->dynamic_table
-                .buffer[(context->dynamic_table.index_0 + index) % context->dynamic_table.max_elements];
+                .buffer[(context->dynamic_table.index_0 + index) % context->dynamic_table.allocated_elements];
 }
 
 size_t aws_hpack_find_index(
@@ -362,20 +536,20 @@ size_t aws_hpack_find_index(
 
     *found_value = false;
 
-    /* Check static table */
-    struct aws_hash_element *elem = NULL;
-    aws_hash_table_find(&s_static_header_reverse_lookup, header, &elem);
-    if (elem) {
-        *found_value = ((const struct aws_http_header *)elem->key)->value.len;
-        return (size_t)elem->value;
+    /* Check static table via the generated perfect hash: one hash computation and one
+     * memcmp for a name+value hit, one more of each for a name-only hit */
+    const size_t static_index = hpack_static_table_find(&header->name, &header->value, found_value);
+    if (static_index) {
+        return static_index;
     }
-    /* If not found, check name only table. Don't set found_value, it will be false */
-    aws_hash_table_find(&s_static_header_reverse_lookup_name_only, &header->name, &elem);
-    if (elem) {
-        return (size_t)elem->value;
+
+    /* Check dynamic table. Skip the lookups (and their name hashing) while it's empty,
+     * which is always the case when the peer has shrunk the table to nothing. */
+    if (context->dynamic_table.num_elements == 0) {
+        return 0;
     }
 
-    /* Check dynamic table */
+    struct aws_hash_element *elem = NULL;
     aws_hash_table_find(&context->dynamic_table.reverse_lookup, header, &elem);
     if (elem) {
         /* If an element was found, check if it has a value */
@@ -391,7 +565,7 @@ size_t aws_hpack_find_index(
         if (absolute_index >= context->dynamic_table.index_0) {
             index = absolute_index - context->dynamic_table.index_0;
         } else {
-            index = (context->dynamic_table.max_elements - context->dynamic_table.index_0) + absolute_index;
+            index = (context->dynamic_table.allocated_elements - context->dynamic_table.index_0) + absolute_index;
         }
         /* Need to add the static table size to re-base indicies */
         index += s_static_header_table_size;
@@ -401,6 +575,44 @@ size_t aws_hpack_find_index(
     return 0;
 }
 
+/*
+ * Reallocates the dynamic table's backing storage to `new_allocated` slots, unrolling the
+ * ring so the newest entry lands in slot 0.  The reverse-lookup tables key on pointers into
+ * the storage, so they are rebuilt against the new buffer.
+ */
+static int s_dynamic_table_reallocate(struct aws_hpack_context *context, size_t new_allocated) {
+    AWS_ASSERT(new_allocated >= context->dynamic_table.num_elements);
+
+    struct aws_http_header *new_buffer =
+        aws_mem_calloc(context->allocator, new_allocated, sizeof(struct aws_http_header));
+    if (!new_buffer) {
+        return AWS_OP_ERR;
+    }
+
+    for (size_t i = 0; i < context->dynamic_table.num_elements; ++i) {
+        new_buffer[i] =
+            context->dynamic_table
+                .buffer[(context->dynamic_table.index_0 + i) % context->dynamic_table.allocated_elements];
+    }
+
+    if (context->dynamic_table.buffer) {
+        aws_mem_release(context->allocator, context->dynamic_table.buffer);
+    }
+    context->dynamic_table.buffer = new_buffer;
+    context->dynamic_table.allocated_elements = new_allocated;
+    context->dynamic_table.index_0 = 0;
+
+    aws_hash_table_clear(&context->dynamic_table.reverse_lookup);
+    aws_hash_table_clear(&context->dynamic_table.reverse_lookup_name_only);
+    for (size_t i = 0; i < context->dynamic_table.num_elements; ++i) {
+        aws_hash_table_put(&context->dynamic_table.reverse_lookup, &context->dynamic_table.buffer[i], (void *)i, NULL);
+        aws_hash_table_put(
+            &context->dynamic_table.reverse_lookup_name_only, &context->dynamic_table.buffer[i].name, (void *)i, NULL);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
 int aws_hpack_insert_header(struct aws_hpack_context *context, const struct aws_http_header *header) {
 
     /* Don't move forward if no elements allowed in the dynamic table */
@@ -408,13 +620,27 @@ int aws_hpack_insert_header(struct aws_hpack_context *context, const struct aws_
         return AWS_OP_SUCCESS;
     }
 
+    /* Grow the backing storage if it's full but the logical cap hasn't been reached */
+    if (context->dynamic_table.num_elements == context->dynamic_table.allocated_elements &&
+        context->dynamic_table.allocated_elements < context->dynamic_table.max_elements) {
+
+        size_t new_allocated = context->dynamic_table.allocated_elements * 2;
+        if (new_allocated > context->dynamic_table.max_elements) {
+            new_allocated = context->dynamic_table.max_elements;
+        }
+
+        if (s_dynamic_table_reallocate(context, new_allocated)) {
+            return AWS_OP_ERR;
+        }
+    }
+
     /* Cache state */
     const size_t old_index_0 = context->dynamic_table.index_0;
     bool removed_from_name_table = false;
 
     /* Decrement index 0, wrapping if necessary */
     if (context->dynamic_table.index_0 == 0) {
-        context->dynamic_table.index_0 = context->dynamic_table.max_elements - 1;
+        context->dynamic_table.index_0 = context->dynamic_table.allocated_elements - 1;
     } else {
         context->dynamic_table.index_0--;
     }
@@ -486,68 +712,36 @@ error:
 
 int aws_hpack_resize_dynamic_table(struct aws_hpack_context *context, size_t new_max_elements) {
 
-    /* Clear the old hash tables */
-    aws_hash_table_clear(&context->dynamic_table.reverse_lookup);
-    aws_hash_table_clear(&context->dynamic_table.reverse_lookup_name_only);
-
-    struct aws_http_header *new_buffer = NULL;
-
-    if (AWS_UNLIKELY(!new_max_elements)) {
-        /* If new buffer is of size 0, don't both initializing, just clean up the old one. */
-        goto cleanup_old_buffer;
-    }
-
-    new_buffer = aws_mem_calloc(context->allocator, new_max_elements, sizeof(struct aws_http_header));
-    if (!new_buffer) {
-        return AWS_OP_ERR;
+    /* Drop entries that no longer fit under the new cap (oldest sit at the highest
+     * relative indices; truncating num_elements discards them) */
+    if (context->dynamic_table.num_elements > new_max_elements) {
+        context->dynamic_table.num_elements = new_max_elements;
     }
 
-    /* Don't bother copying data if old buffer was of size 0 */
-    if (AWS_UNLIKELY(context->dynamic_table.max_elements == 0)) {
-        goto reset_dyn_table_state;
+    /* Reallocate the backing storage lazily, like creation: just big enough for what
+     * survives, leaving room to double on demand up to the new cap */
+    size_t new_allocated = context->dynamic_table.num_elements;
+    if (new_allocated < s_hpack_dynamic_table_initial_elements) {
+        new_allocated = s_hpack_dynamic_table_initial_elements;
     }
-
-    /* Copy as much the above block as possible */
-    size_t above_block_size = context->dynamic_table.max_elements - context->dynamic_table.index_0;
-    if (above_block_size > new_max_elements) {
-        above_block_size = new_max_elements;
+    if (new_allocated > new_max_elements) {
+        new_allocated = new_max_elements;
     }
-    memcpy(
-        new_buffer,
-        context->dynamic_table.buffer + context->dynamic_table.index_0,
-        above_block_size * sizeof(struct aws_http_header));
 
-    /* Copy as much of below block as possible */
-    const size_t free_blocks_available = new_max_elements - above_block_size;
-    const size_t old_blocks_to_copy = context->dynamic_table.max_elements - above_block_size;
-    const size_t below_block_size =
-        free_blocks_available > old_blocks_to_copy ? old_blocks_to_copy : free_blocks_available;
-    if (below_block_size) {
-        memcpy(
-            new_buffer + above_block_size,
-            context->dynamic_table.buffer,
-            below_block_size * sizeof(struct aws_http_header));
+    if (new_allocated == 0) {
+        if (context->dynamic_table.buffer) {
+            aws_mem_release(context->allocator, context->dynamic_table.buffer);
+            context->dynamic_table.buffer = NULL;
+        }
+        context->dynamic_table.allocated_elements = 0;
+        context->dynamic_table.index_0 = 0;
+        aws_hash_table_clear(&context->dynamic_table.reverse_lookup);
+        aws_hash_table_clear(&context->dynamic_table.reverse_lookup_name_only);
+    } else if (s_dynamic_table_reallocate(context, new_allocated)) {
+        return AWS_OP_ERR;
     }
 
-    /* Free the old memory */
-cleanup_old_buffer:
-    aws_mem_release(context->allocator, context->dynamic_table.buffer);
-
-    /* Reset state */
-reset_dyn_table_state:
-    if (context->dynamic_table.num_elements > new_max_elements) {
-        context->dynamic_table.num_elements = new_max_elements;
-    }
     context->dynamic_table.max_elements = new_max_elements;
-    context->dynamic_table.index_0 = 0;
-    context->dynamic_table.buffer = new_buffer;
-
-    /* Re-insert all of the reverse lookup elements */
-    for (size_t i = 0; i < context->dynamic_table.num_elements; ++i) {
-        aws_hash_table_put(&context->dynamic_table.reverse_lookup, &context->dynamic_table.buffer[i], (void *)i, NULL);
-        aws_hash_table_put(
-            &context->dynamic_table.reverse_lookup_name_only, &context->dynamic_table.buffer[i].name, (void *)i, NULL);
-    }
 
     return AWS_OP_SUCCESS;
 }
@@ -657,8 +851,7 @@ int aws_hpack_decode_string(
     }
 
     if (use_huffman) {
-        aws_huffman_decoder_reset(&context->decoder);
-        if (aws_huffman_decode(&context->decoder, &value, output)) {
+        if (s_huffman_decode(&value, output)) {
             return AWS_OP_ERR;
         }
     } else {
@@ -669,3 +862,320 @@ int aws_hpack_decode_string(
 
     return AWS_OP_SUCCESS;
 }
+
+/* Resumable variant of aws_hpack_decode_integer(). *value accumulates across calls;
+ * zero the progress struct (and *value) before the first call of a new integer. */
+static int s_decode_integer_resumable(
+    struct aws_byte_cursor *to_decode,
+    uint8_t prefix_size,
+    struct hpack_progress_integer *progress,
+    uint64_t *value,
+    bool *complete) {
+
+    AWS_ASSERT(prefix_size <= 8);
+
+    *complete = false;
+    const uint8_t prefix_mask = UINT8_MAX >> (8 - prefix_size);
+
+    if (progress->state == HPACK_INTEGER_STATE_INIT) {
+        if (!to_decode->len) {
+            return AWS_OP_SUCCESS;
+        }
+
+        uint8_t byte = 0;
+        aws_byte_cursor_read_u8(to_decode, &byte);
+        byte &= prefix_mask;
+        *value = byte;
+
+        if (byte != prefix_mask) {
+            *complete = true;
+            return AWS_OP_SUCCESS;
+        }
+        progress->state = HPACK_INTEGER_STATE_VALUE;
+        progress->bit_count = 0;
+    }
+
+    while (to_decode->len) {
+        if (progress->bit_count > 64 - 7) {
+            return aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+        }
+
+        uint8_t byte = 0;
+        aws_byte_cursor_read_u8(to_decode, &byte);
+
+        const uint64_t new_byte_value = (uint64_t)(byte & 127) << progress->bit_count;
+        if (*value + new_byte_value < *value) {
+            return aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+        }
+        *value += new_byte_value;
+        progress->bit_count += 7;
+
+        if (!(byte & 128)) {
+            *complete = true;
+            return AWS_OP_SUCCESS;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Resumable variant of aws_hpack_decode_string(), appending decoded bytes to `output`
+ * (which must be growable). Zero the progress struct before the first call of a new string. */
+static int s_decode_string_resumable(
+    struct aws_byte_cursor *to_decode,
+    struct hpack_progress_string *progress,
+    struct aws_byte_buf *output,
+    bool *complete) {
+
+    *complete = false;
+
+    if (progress->state == HPACK_STRING_STATE_INIT) {
+        if (!to_decode->len) {
+            return AWS_OP_SUCCESS;
+        }
+        progress->use_huffman = *to_decode->ptr >> 7;
+        progress->state = HPACK_STRING_STATE_LENGTH;
+    }
+
+    if (progress->state == HPACK_STRING_STATE_LENGTH) {
+        bool length_complete = false;
+        if (s_decode_integer_resumable(to_decode, 7, &progress->integer, &progress->length, &length_complete)) {
+            return AWS_OP_ERR;
+        }
+        if (!length_complete) {
+            return AWS_OP_SUCCESS;
+        }
+        if (progress->length > SIZE_MAX) {
+            return aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+        }
+        progress->state = HPACK_STRING_STATE_VALUE;
+    }
+
+    const size_t chunk_len = to_decode->len < progress->length ? to_decode->len : (size_t)progress->length;
+    struct aws_byte_cursor chunk = aws_byte_cursor_advance(to_decode, chunk_len);
+    progress->length -= chunk_len;
+    const bool final = progress->length == 0;
+
+    /* Every Huffman code is at least 5 bits, so a chunk can't expand past 2x (plus carried bits) */
+    const size_t space_needed = progress->use_huffman ? chunk_len * 2 + 16 : chunk_len;
+    if (output->capacity - output->len < space_needed) {
+        if (aws_byte_buf_reserve(output, output->len + space_needed)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    if (progress->use_huffman) {
+        if (s_huffman_decode_chunk(&progress->window, &progress->bit_count, &chunk, output, final)) {
+            return AWS_OP_ERR;
+        }
+    } else {
+        bool succ = aws_byte_buf_write_from_whole_cursor(output, chunk);
+        AWS_ASSERT(succ);
+        (void)succ;
+    }
+
+    *complete = final;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_hpack_decode(
+    struct aws_hpack_context *context,
+    struct aws_byte_cursor *to_decode,
+    struct aws_hpack_decode_result *result) {
+
+    AWS_PRECONDITION(context);
+    AWS_PRECONDITION(to_decode);
+    AWS_PRECONDITION(result);
+
+    while (true) {
+        switch (context->decode.state) {
+            case HPACK_ENTRY_STATE_BEGIN: {
+                if (!to_decode->len) {
+                    goto ongoing;
+                }
+
+                /* Reclaim scratch bytes that no dynamic-table entry references */
+                context->decode.scratch.len = context->decode.persistent_len;
+                context->decode.entry_start = context->decode.scratch.len;
+                context->decode.name_len = 0;
+                context->decode.integer_value = 0;
+                AWS_ZERO_STRUCT(context->decode.integer);
+                AWS_ZERO_STRUCT(context->decode.string);
+
+                /* Classify the entry by its first byte [RFC-7541 6] */
+                const uint8_t first_byte = *to_decode->ptr;
+                if (first_byte & 0x80) {
+                    /* 1xxxxxxx: indexed header field */
+                    context->decode.prefix_size = 7;
+                    context->decode.save = false;
+                    context->decode.state = HPACK_ENTRY_STATE_INDEXED;
+                } else if (first_byte & 0x40) {
+                    /* 01xxxxxx: literal with incremental indexing */
+                    context->decode.prefix_size = 6;
+                    context->decode.save = true;
+                    context->decode.state = HPACK_ENTRY_STATE_LITERAL_INDEX;
+                } else if (first_byte & 0x20) {
+                    /* 001xxxxx: dynamic table size update */
+                    context->decode.prefix_size = 5;
+                    context->decode.state = HPACK_ENTRY_STATE_RESIZE;
+                } else {
+                    /* 0000xxxx / 0001xxxx: literal without indexing / never indexed */
+                    context->decode.prefix_size = 4;
+                    context->decode.save = false;
+                    context->decode.state = HPACK_ENTRY_STATE_LITERAL_INDEX;
+                }
+                break;
+            }
+
+            case HPACK_ENTRY_STATE_INDEXED: {
+                bool complete = false;
+                if (s_decode_integer_resumable(
+                        to_decode,
+                        context->decode.prefix_size,
+                        &context->decode.integer,
+                        &context->decode.integer_value,
+                        &complete)) {
+                    return AWS_OP_ERR;
+                }
+                if (!complete) {
+                    goto ongoing;
+                }
+
+                if (context->decode.integer_value > SIZE_MAX) {
+                    return aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+                }
+                const struct aws_http_header *header =
+                    aws_hpack_get_header(context, (size_t)context->decode.integer_value);
+                if (!header) {
+                    return AWS_OP_ERR;
+                }
+
+                result->type = AWS_HPACK_DECODE_T_HEADER_FIELD;
+                result->header_field = *header;
+                context->decode.state = HPACK_ENTRY_STATE_BEGIN;
+                return AWS_OP_SUCCESS;
+            }
+
+            case HPACK_ENTRY_STATE_LITERAL_INDEX: {
+                bool complete = false;
+                if (s_decode_integer_resumable(
+                        to_decode,
+                        context->decode.prefix_size,
+                        &context->decode.integer,
+                        &context->decode.integer_value,
+                        &complete)) {
+                    return AWS_OP_ERR;
+                }
+                if (!complete) {
+                    goto ongoing;
+                }
+
+                if (context->decode.integer_value == 0) {
+                    /* Name is a literal string */
+                    AWS_ZERO_STRUCT(context->decode.string);
+                    context->decode.state = HPACK_ENTRY_STATE_LITERAL_NAME;
+                    break;
+                }
+
+                if (context->decode.integer_value > SIZE_MAX) {
+                    return aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+                }
+                const struct aws_http_header *header =
+                    aws_hpack_get_header(context, (size_t)context->decode.integer_value);
+                if (!header) {
+                    return AWS_OP_ERR;
+                }
+
+                /* Copy the indexed name into scratch so the finished field is backed uniformly */
+                struct aws_byte_buf *scratch = &context->decode.scratch;
+                if (scratch->capacity - scratch->len < header->name.len) {
+                    if (aws_byte_buf_reserve(scratch, scratch->len + header->name.len)) {
+                        return AWS_OP_ERR;
+                    }
+                }
+                aws_byte_buf_write_from_whole_cursor(scratch, header->name);
+                context->decode.name_len = header->name.len;
+
+                AWS_ZERO_STRUCT(context->decode.string);
+                context->decode.state = HPACK_ENTRY_STATE_LITERAL_VALUE;
+                break;
+            }
+
+            case HPACK_ENTRY_STATE_LITERAL_NAME: {
+                bool complete = false;
+                if (s_decode_string_resumable(to_decode, &context->decode.string, &context->decode.scratch, &complete)) {
+                    return AWS_OP_ERR;
+                }
+                if (!complete) {
+                    goto ongoing;
+                }
+                context->decode.name_len = context->decode.scratch.len - context->decode.entry_start;
+
+                AWS_ZERO_STRUCT(context->decode.string);
+                context->decode.state = HPACK_ENTRY_STATE_LITERAL_VALUE;
+                break;
+            }
+
+            case HPACK_ENTRY_STATE_LITERAL_VALUE: {
+                bool complete = false;
+                if (s_decode_string_resumable(to_decode, &context->decode.string, &context->decode.scratch, &complete)) {
+                    return AWS_OP_ERR;
+                }
+                if (!complete) {
+                    goto ongoing;
+                }
+
+                struct aws_byte_buf *scratch = &context->decode.scratch;
+                const size_t entry_start = context->decode.entry_start;
+                const size_t name_len = context->decode.name_len;
+                struct aws_http_header field = {
+                    .name = aws_byte_cursor_from_array(scratch->buffer + entry_start, name_len),
+                    .value = aws_byte_cursor_from_array(
+                        scratch->buffer + entry_start + name_len, scratch->len - entry_start - name_len),
+                };
+
+                if (context->decode.save) {
+                    if (aws_hpack_insert_header(context, &field)) {
+                        return AWS_OP_ERR;
+                    }
+                    context->decode.persistent_len = scratch->len;
+                }
+
+                result->type = AWS_HPACK_DECODE_T_HEADER_FIELD;
+                result->header_field = field;
+                context->decode.state = HPACK_ENTRY_STATE_BEGIN;
+                return AWS_OP_SUCCESS;
+            }
+
+            case HPACK_ENTRY_STATE_RESIZE: {
+                bool complete = false;
+                if (s_decode_integer_resumable(
+                        to_decode,
+                        context->decode.prefix_size,
+                        &context->decode.integer,
+                        &context->decode.integer_value,
+                        &complete)) {
+                    return AWS_OP_ERR;
+                }
+                if (!complete) {
+                    goto ongoing;
+                }
+
+                if (context->decode.integer_value > s_hpack_dynamic_table_max_size) {
+                    return aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
+                }
+                if (aws_hpack_resize_dynamic_table(context, (size_t)context->decode.integer_value)) {
+                    return AWS_OP_ERR;
+                }
+
+                /* Size updates don't produce a field; keep decoding */
+                context->decode.state = HPACK_ENTRY_STATE_BEGIN;
+                break;
+            }
+        }
+    }
+
+ongoing:
+    result->type = AWS_HPACK_DECODE_T_ONGOING;
+    return AWS_OP_SUCCESS;
+}
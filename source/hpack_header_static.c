@@ -0,0 +1,166 @@
+/*
+ * Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+/* WARNING: THIS FILE WAS AUTOMATICALLY GENERATED BY bin/generate-hpack-static-lookup.py
+ * FROM include/aws/http/private/hpack_header_static_table.def. DO NOT EDIT. */
+/* clang-format off */
+
+#include <aws/common/byte_buf.h>
+
+#include <string.h>
+
+/* Minimal perfect-hash lookup over the HPACK static table [RFC-7541 Appendix A].
+ * An FNV-1a hash of the header's name (continued through the value for name+value pairs)
+ * indexes a slot table sized, at generation time, so that no two table entries share a
+ * slot; a single memcmp then confirms or rejects the one possible candidate. */
+
+struct hpack_static_table_entry {
+    const char *name;
+    uint16_t name_len;
+    const char *value;
+    uint16_t value_len;
+};
+
+static const struct hpack_static_table_entry s_static_entries[62] = {
+    {NULL, 0, NULL, 0}, /* index 0 is unused */
+    {":authority", 10, "", 0},
+    {":method", 7, "GET", 3},
+    {":method", 7, "POST", 4},
+    {":path", 5, "/", 1},
+    {":path", 5, "/index.html", 11},
+    {":scheme", 7, "http", 4},
+    {":scheme", 7, "https", 5},
+    {":status", 7, "200", 3},
+    {":status", 7, "204", 3},
+    {":status", 7, "206", 3},
+    {":status", 7, "304", 3},
+    {":status", 7, "400", 3},
+    {":status", 7, "404", 3},
+    {":status", 7, "500", 3},
+    {"accept-charset", 14, "", 0},
+    {"accept-encoding", 15, "gzip,deflate", 12},
+    {"accept-language", 15, "", 0},
+    {"accept-ranges", 13, "", 0},
+    {"accept", 6, "", 0},
+    {"access-control-allow-origin", 27, "", 0},
+    {"age", 3, "", 0},
+    {"allow", 5, "", 0},
+    {"authorization", 13, "", 0},
+    {"cache-control", 13, "", 0},
+    {"content-disposition", 19, "", 0},
+    {"content-encoding", 16, "", 0},
+    {"content-language", 16, "", 0},
+    {"content-length", 14, "", 0},
+    {"content-location", 16, "", 0},
+    {"content-range", 13, "", 0},
+    {"content-type", 12, "", 0},
+    {"cookie", 6, "", 0},
+    {"date", 4, "", 0},
+    {"etag", 4, "", 0},
+    {"expect", 6, "", 0},
+    {"expires", 7, "", 0},
+    {"from", 4, "", 0},
+    {"host", 4, "", 0},
+    {"if-match", 8, "", 0},
+    {"if-modified-since", 17, "", 0},
+    {"if-none-match", 13, "", 0},
+    {"if-range", 8, "", 0},
+    {"if-unmodified-since", 19, "", 0},
+    {"last-modified", 13, "", 0},
+    {"link", 4, "", 0},
+    {"location", 8, "", 0},
+    {"max-forwards", 12, "", 0},
+    {"proxy-authenticate", 18, "", 0},
+    {"proxy-authorization", 19, "", 0},
+    {"range", 5, "", 0},
+    {"referer", 7, "", 0},
+    {"refresh", 7, "", 0},
+    {"retry-after", 11, "", 0},
+    {"server", 6, "", 0},
+    {"set-cookie", 10, "", 0},
+    {"strict-transport-security", 25, "", 0},
+    {"transfer-encoding", 17, "", 0},
+    {"user-agent", 10, "", 0},
+    {"vary", 4, "", 0},
+    {"via", 3, "", 0},
+    {"www-authenticate", 16, "", 0},
+};
+
+/* hash % table-size -> static table index of the sole entry that can hash there (0 = no entry) */
+static const uint8_t s_name_slot_to_index[281] = {
+    0, 0, 0, 0, 21, 0, 0, 0, 0, 0, 0, 0, 0, 33, 0, 0, 0, 0, 56, 0,
+    0, 45, 0, 41, 0, 36, 0, 0, 0, 0, 0, 52, 59, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 34, 0, 0, 54, 19, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 28, 43,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, 26, 0, 0, 0, 0, 16, 0, 0, 30,
+    0, 0, 0, 0, 0, 48, 0, 0, 0, 0, 23, 0, 0, 0, 0, 61, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 42, 0, 0, 0, 0,
+    0, 0, 32, 0, 0, 0, 0, 20, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 58, 0, 24, 0, 0, 0, 0, 40, 0, 57, 0, 0, 0, 0, 0, 0, 47, 0, 0,
+    0, 0, 22, 31, 0, 0, 0, 60, 0, 0, 0, 0, 49, 0, 0, 25, 0, 0, 0, 0,
+    0, 0, 15, 44, 4, 0, 0, 0, 55, 0, 29, 0, 0, 50, 0, 0, 0, 0, 0, 0,
+    0, 0, 38, 0, 0, 0, 0, 0, 0, 0, 53, 0, 0, 46, 0, 0, 0, 0, 37, 0,
+    8, 0, 17, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 35,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 51, 0, 0, 0, 27, 39, 0, 0, 0, 0,
+    0,
+};
+
+static const uint8_t s_pair_slot_to_index[22] = {
+    0, 0, 0, 0, 6, 0, 5, 10, 0, 9, 3, 12, 16, 8, 2, 13, 11, 4, 0, 7,
+    14, 0,
+};
+
+static uint32_t s_fnv1a(const uint8_t *bytes, size_t len, uint32_t hash) {
+    for (size_t i = 0; i < len; ++i) {
+        hash = (hash ^ bytes[i]) * 0x01000193U;
+    }
+    return hash;
+}
+
+size_t hpack_static_table_find(
+    const struct aws_byte_cursor *name,
+    const struct aws_byte_cursor *value,
+    bool *out_found_value) {
+
+    static const uint8_t s_separator = 0;
+
+    *out_found_value = false;
+
+    const uint32_t name_hash = s_fnv1a(name->ptr, name->len, 0x811C9DC5U);
+
+    /* Exact name+value match first */
+    const uint32_t pair_hash = s_fnv1a(value->ptr, value->len, s_fnv1a(&s_separator, 1, name_hash));
+    uint8_t candidate = s_pair_slot_to_index[pair_hash % 22];
+    if (candidate) {
+        const struct hpack_static_table_entry *entry = &s_static_entries[candidate];
+        if (entry->name_len == name->len && entry->value_len == value->len &&
+            memcmp(entry->name, name->ptr, name->len) == 0 && memcmp(entry->value, value->ptr, value->len) == 0) {
+
+            *out_found_value = true;
+            return candidate;
+        }
+    }
+
+    /* Fall back to the lowest-indexed entry with a matching name */
+    candidate = s_name_slot_to_index[name_hash % 281];
+    if (candidate) {
+        const struct hpack_static_table_entry *entry = &s_static_entries[candidate];
+        if (entry->name_len == name->len && memcmp(entry->name, name->ptr, name->len) == 0) {
+            return candidate;
+        }
+    }
+
+    return 0;
+}
@@ -13,6 +13,7 @@
  * permissions and limitations under the License.
  */
 
+#include <aws/http/private/header_intern.h>
 #include <aws/http/private/hpack.h>
 #include <aws/http/private/http_impl.h>
 
@@ -115,6 +116,24 @@ static struct aws_error_info s_errors[] = {
     AWS_DEFINE_ERROR_INFO_HTTP(
         AWS_ERROR_HTTP_INVALID_FRAME_SIZE,
         "Received frame with an illegal frame size"),
+    AWS_DEFINE_ERROR_INFO_HTTP(
+        AWS_ERROR_HTTP_STREAM_TIMEOUT,
+        "Stream deadline passed before the response arrived"),
+    AWS_DEFINE_ERROR_INFO_HTTP(
+        AWS_ERROR_HTTP_HEADER_LINE_TOO_LARGE,
+        "Incoming line exceeded the configured maximum size"),
+    AWS_DEFINE_ERROR_INFO_HTTP(
+        AWS_ERROR_HTTP_SERVER_BUDGET_EXCEEDED,
+        "Incoming connection rejected because the server's connection budget is exhausted"),
+    AWS_DEFINE_ERROR_INFO_HTTP(
+        AWS_ERROR_HTTP_HOST_POOL_BUDGET_EXCEEDED,
+        "Connection acquisition rejected because every host slot in the pool is in use"),
+    AWS_DEFINE_ERROR_INFO_HTTP(
+        AWS_ERROR_HTTP_PING_TIMEOUT,
+        "Peer did not acknowledge a PING within the configured keepalive timeout"),
+    AWS_DEFINE_ERROR_INFO_HTTP(
+        AWS_ERROR_HTTP_GOAWAY_RECEIVED,
+        "Peer sent GOAWAY and will not process this stream"),
 };
 /* clang-format on */
 
@@ -233,32 +252,20 @@ struct aws_byte_cursor aws_http_version_to_str(enum aws_http_version version) {
 }
 
 /* HEADERS */
-static struct aws_hash_table s_header_str_to_enum;                         /* for string -> enum lookup */
-static struct aws_byte_cursor s_header_enum_to_str[AWS_HTTP_HEADER_COUNT]; /* for enum -> string lookup */
-
 static void s_headers_init(struct aws_allocator *alloc) {
-    s_header_enum_to_str[AWS_HTTP_HEADER_CONNECTION] = aws_byte_cursor_from_c_str("connection");
-    s_header_enum_to_str[AWS_HTTP_HEADER_CONTENT_LENGTH] = aws_byte_cursor_from_c_str("content-length");
-    s_header_enum_to_str[AWS_HTTP_HEADER_EXPECT] = aws_byte_cursor_from_c_str("expect");
-    s_header_enum_to_str[AWS_HTTP_HEADER_TRANSFER_ENCODING] = aws_byte_cursor_from_c_str("transfer-encoding");
-
-    s_init_str_to_enum_hash_table(
-        &s_header_str_to_enum,
-        alloc,
-        s_header_enum_to_str,
-        AWS_HTTP_HEADER_UNKNOWN + 1,
-        AWS_HTTP_HEADER_COUNT,
-        true /* ignore case */);
+    /* The intern table doubles as the string -> enum lookup table:
+     * the entries for names in enum aws_http_header_name carry their enum value. */
+    aws_http_header_intern_table_init(alloc);
 }
 
 static void s_headers_clean_up(void) {
-    aws_hash_table_clean_up(&s_header_str_to_enum);
+    aws_http_header_intern_table_clean_up();
 }
 
 enum aws_http_header_name aws_http_str_to_header_name(struct aws_byte_cursor cursor) {
-    int header = s_find_in_str_to_enum_hash_table(&s_header_str_to_enum, &cursor);
-    if (header >= 0) {
-        return (enum aws_http_header_name)header;
+    const struct aws_http_interned_header *interned = aws_http_header_intern_lookup(cursor);
+    if (interned) {
+        return interned->name_enum;
     }
     return AWS_HTTP_HEADER_UNKNOWN;
 }
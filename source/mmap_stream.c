@@ -0,0 +1,248 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/mmap_stream.h>
+
+#include <aws/io/logging.h>
+#include <aws/io/stream.h>
+
+#ifdef _WIN32
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+struct aws_mmap_input_stream_impl {
+    /* The whole mapped file.  ptr is NULL (and len 0) for an empty file. */
+    struct aws_byte_cursor mapping;
+
+    /* The not-yet-read tail of the mapping */
+    struct aws_byte_cursor remaining;
+
+#ifdef _WIN32
+    HANDLE file_handle;
+    HANDLE mapping_handle;
+#endif
+};
+
+static int s_aws_mmap_input_stream_seek(
+    struct aws_input_stream *stream,
+    aws_off_t offset,
+    enum aws_stream_seek_basis basis) {
+
+    struct aws_mmap_input_stream_impl *impl = stream->impl;
+
+    uint64_t final_offset = 0;
+    switch (basis) {
+        case AWS_SSB_BEGIN:
+            if (offset < 0 || (uint64_t)offset > impl->mapping.len) {
+                return aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
+            }
+            final_offset = (uint64_t)offset;
+            break;
+
+        case AWS_SSB_END:
+            if (offset > 0 || (uint64_t)(-offset) > impl->mapping.len) {
+                return aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
+            }
+            final_offset = impl->mapping.len - (uint64_t)(-offset);
+            break;
+
+        default:
+            return aws_raise_error(AWS_IO_STREAM_INVALID_SEEK_POSITION);
+    }
+
+    impl->remaining = impl->mapping;
+    aws_byte_cursor_advance(&impl->remaining, (size_t)final_offset);
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_aws_mmap_input_stream_read(struct aws_input_stream *stream, struct aws_byte_buf *dest) {
+    struct aws_mmap_input_stream_impl *impl = stream->impl;
+
+    size_t space_available = dest->capacity - dest->len;
+    size_t to_write = impl->remaining.len < space_available ? impl->remaining.len : space_available;
+
+    /* The single userspace copy: page cache straight into the outgoing buffer */
+    struct aws_byte_cursor chunk = aws_byte_cursor_advance(&impl->remaining, to_write);
+    aws_byte_buf_write_from_whole_cursor(dest, chunk);
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_aws_mmap_input_stream_get_status(struct aws_input_stream *stream, struct aws_stream_status *status) {
+    struct aws_mmap_input_stream_impl *impl = stream->impl;
+
+    status->is_valid = true;
+    status->is_end_of_stream = impl->remaining.len == 0;
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_aws_mmap_input_stream_get_length(struct aws_input_stream *stream, int64_t *out_length) {
+    struct aws_mmap_input_stream_impl *impl = stream->impl;
+
+    *out_length = (int64_t)impl->mapping.len;
+
+    return AWS_OP_SUCCESS;
+}
+
+static void s_aws_mmap_input_stream_destroy(struct aws_input_stream *stream) {
+    struct aws_mmap_input_stream_impl *impl = stream->impl;
+
+#ifdef _WIN32
+    if (impl->mapping.ptr != NULL) {
+        UnmapViewOfFile(impl->mapping.ptr);
+    }
+    if (impl->mapping_handle != NULL) {
+        CloseHandle(impl->mapping_handle);
+    }
+    if (impl->file_handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(impl->file_handle);
+    }
+#else
+    if (impl->mapping.ptr != NULL) {
+        munmap(impl->mapping.ptr, impl->mapping.len);
+    }
+#endif
+
+    aws_mem_release(stream->allocator, stream);
+}
+
+static struct aws_input_stream_vtable s_aws_mmap_input_stream_vtable = {
+    .seek = s_aws_mmap_input_stream_seek,
+    .read = s_aws_mmap_input_stream_read,
+    .get_status = s_aws_mmap_input_stream_get_status,
+    .get_length = s_aws_mmap_input_stream_get_length,
+    .destroy = s_aws_mmap_input_stream_destroy,
+};
+
+struct aws_input_stream *aws_http_mmap_input_stream_new(struct aws_allocator *allocator, const char *file_path) {
+    struct aws_input_stream *stream = NULL;
+    struct aws_mmap_input_stream_impl *impl = NULL;
+
+    if (!aws_mem_acquire_many(
+            allocator,
+            2,
+            &stream,
+            sizeof(struct aws_input_stream),
+            &impl,
+            sizeof(struct aws_mmap_input_stream_impl))) {
+        return NULL;
+    }
+
+    AWS_ZERO_STRUCT(*stream);
+    AWS_ZERO_STRUCT(*impl);
+
+    stream->allocator = allocator;
+    stream->impl = impl;
+    stream->vtable = &s_aws_mmap_input_stream_vtable;
+
+#ifdef _WIN32
+    impl->file_handle = CreateFileA(
+        file_path,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        NULL);
+    if (impl->file_handle == INVALID_HANDLE_VALUE) {
+        aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+        goto error;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(impl->file_handle, &file_size)) {
+        aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+        goto error;
+    }
+
+    /* A zero-length file cannot be mapped; leave the cursors empty */
+    if (file_size.QuadPart > 0) {
+        if ((uint64_t)file_size.QuadPart > SIZE_MAX) {
+            aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+            goto error;
+        }
+
+        impl->mapping_handle = CreateFileMappingA(impl->file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (impl->mapping_handle == NULL) {
+            aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+            goto error;
+        }
+
+        void *mapping = MapViewOfFile(impl->mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        if (mapping == NULL) {
+            aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+            goto error;
+        }
+
+        impl->mapping = aws_byte_cursor_from_array(mapping, (size_t)file_size.QuadPart);
+    }
+#else
+    int fd = open(file_path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+        goto error;
+    }
+
+    struct stat file_stats;
+    if (fstat(fd, &file_stats)) {
+        close(fd);
+        aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+        goto error;
+    }
+
+    /* A zero-length file cannot be mapped; leave the cursors empty */
+    if (file_stats.st_size > 0) {
+        if ((uint64_t)file_stats.st_size > SIZE_MAX) {
+            close(fd);
+            aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+            goto error;
+        }
+
+        void *mapping = mmap(NULL, (size_t)file_stats.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+            goto error;
+        }
+
+        /* Uploads walk the file front to back; let the kernel read ahead aggressively */
+        madvise(mapping, (size_t)file_stats.st_size, MADV_SEQUENTIAL);
+
+        impl->mapping = aws_byte_cursor_from_array(mapping, (size_t)file_stats.st_size);
+    }
+
+    /* The mapping persists without the descriptor */
+    close(fd);
+#endif
+
+    impl->remaining = impl->mapping;
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_HTTP_GENERAL, "static: Mapped file '%s' (%zu bytes) for zero-copy body", file_path, impl->mapping.len);
+
+    return stream;
+
+error:
+    AWS_LOGF_ERROR(AWS_LS_HTTP_GENERAL, "static: Failed to map file '%s' for request body", file_path);
+    s_aws_mmap_input_stream_destroy(stream);
+    return NULL;
+}
@@ -18,6 +18,7 @@
 #include <aws/common/array_list.h>
 #include <aws/common/string.h>
 #include <aws/http/private/connection_impl.h>
+#include <aws/http/private/header_intern.h>
 #include <aws/http/private/strutil.h>
 #include <aws/http/server.h>
 #include <aws/io/logging.h>
@@ -29,6 +30,18 @@
 enum {
     /* Initial capacity for the aws_http_message.headers array_list. */
     AWS_HTTP_REQUEST_NUM_RESERVED_HEADERS = 16,
+
+    /* Initial capacity for the aws_http_message.body_segments array_list. */
+    AWS_HTTP_MESSAGE_NUM_RESERVED_BODY_SEGMENTS = 4,
+
+    /* Initial string-storage capacity for an aws_http_headers arena block. */
+    AWS_HTTP_HEADER_BLOCK_MIN_CAPACITY = 512,
+
+    /* Headers with fewer entries than this are looked up by linear scan, no index is built. */
+    AWS_HTTP_HEADER_INDEX_MIN_COUNT = 8,
+
+    /* Initial slot count for the lookup index. Must be a power of 2. */
+    AWS_HTTP_HEADER_INDEX_MIN_CAPACITY = 16,
 };
 
 bool aws_http_header_name_eq(struct aws_byte_cursor name_a, struct aws_byte_cursor name_b) {
@@ -42,16 +55,210 @@ bool aws_http_header_name_eq(struct aws_byte_cursor name_a, struct aws_byte_curs
  * The API has been designed so we can swap out the implementation later if desired.
  *
  * -- String Storage Notes --
- * We use a single allocation to hold the name and value of each aws_http_header.
- * We could optimize storage by using something like a string pool. If we do this, be sure to maintain
- * the address of existing strings when adding new strings (a dynamic aws_byte_buf would not suffice).
+ * Copied names and values are packed into an arena of chained blocks, so building a typical
+ * message costs a handful of allocations instead of one per header, and teardown is one free
+ * per block. Blocks are chained rather than reallocated because the address of existing
+ * strings must not change as headers are added (a dynamic aws_byte_buf would not suffice).
+ * Erasing a header does not reclaim its string storage; that memory is recovered when the
+ * headers are cleared or released. clear() retains the newest (largest) block so a re-used
+ * message doesn't need to grow the arena all over again.
+ *
+ * -- Lookup Index Notes --
+ * Name lookups on larger header sets go through a small open-addressing hash table, keyed
+ * on a case-folded name hash. It is built lazily by the first lookup and topped up when
+ * lookups find headers were appended since, so bulk adds stay cheap. Only the FIRST header
+ * with a given name is indexed, matching the linear scan's first-match behavior. Erasing
+ * or clearing drops the index (indices shift); the next lookup rebuilds it.
  */
+
+struct aws_http_header_block {
+    struct aws_http_header_block *next;
+    size_t capacity;
+    size_t len;
+    /* string storage follows the struct, in the same allocation */
+};
+
+struct aws_http_header_index_entry {
+    uint32_t hash;           /* Case-folded name hash */
+    uint32_t index_plus_one; /* Header's position in array_list, plus 1 so that 0 means "empty slot" */
+};
+
+struct aws_http_header_index {
+    struct aws_http_header_index_entry *entries; /* NULL until the first lookup builds the index */
+    size_t capacity;                             /* Always a power of 2 */
+    size_t num_entries;                          /* Distinct names stored */
+    size_t num_indexed;                          /* Headers [0, num_indexed) are reflected in the table */
+};
+
 struct aws_http_headers {
     struct aws_allocator *alloc;
-    struct aws_array_list array_list; /* Contains aws_http_header */
+    struct aws_array_list array_list;          /* Contains aws_http_header */
+    struct aws_http_header_block *block_list;  /* Head is the block currently being filled */
+    struct aws_http_header_index index;        /* Lazily built name-lookup table */
     struct aws_atomic_var refcount;
 };
 
+static uint8_t *s_header_block_storage(struct aws_http_header_block *block) {
+    return (uint8_t *)(block + 1);
+}
+
+/* Acquire `size` bytes of stable string storage from the arena, growing it if necessary */
+static uint8_t *s_headers_arena_acquire(struct aws_http_headers *headers, size_t size) {
+    struct aws_http_header_block *block = headers->block_list;
+
+    if (!block || (block->capacity - block->len < size)) {
+        /* Each new block doubles capacity, so long messages settle into few allocations */
+        size_t capacity = block ? block->capacity : 0;
+        if (aws_mul_size_checked(capacity, 2, &capacity)) {
+            return NULL;
+        }
+        if (capacity < AWS_HTTP_HEADER_BLOCK_MIN_CAPACITY) {
+            capacity = AWS_HTTP_HEADER_BLOCK_MIN_CAPACITY;
+        }
+        if (capacity < size) {
+            capacity = size;
+        }
+
+        size_t alloc_size;
+        if (aws_add_size_checked(sizeof(struct aws_http_header_block), capacity, &alloc_size)) {
+            return NULL;
+        }
+
+        struct aws_http_header_block *new_block = aws_mem_acquire(headers->alloc, alloc_size);
+        if (!new_block) {
+            return NULL;
+        }
+
+        new_block->next = block;
+        new_block->capacity = capacity;
+        new_block->len = 0;
+
+        headers->block_list = new_block;
+        block = new_block;
+    }
+
+    uint8_t *mem = s_header_block_storage(block) + block->len;
+    block->len += size;
+    return mem;
+}
+
+/* Free arena blocks. If `retain_newest` is set, keep the head block (emptied) for re-use. */
+static void s_headers_arena_reset(struct aws_http_headers *headers, bool retain_newest) {
+    struct aws_http_header_block *block = headers->block_list;
+
+    if (retain_newest && block) {
+        block->len = 0;
+        struct aws_http_header_block *doomed = block->next;
+        block->next = NULL;
+        block = doomed;
+    } else {
+        headers->block_list = NULL;
+    }
+
+    while (block) {
+        struct aws_http_header_block *next = block->next;
+        aws_mem_release(headers->alloc, block);
+        block = next;
+    }
+}
+
+static void s_headers_index_drop(struct aws_http_headers *headers) {
+    if (headers->index.entries) {
+        aws_mem_release(headers->alloc, headers->index.entries);
+    }
+    AWS_ZERO_STRUCT(headers->index);
+}
+
+static struct aws_http_header *s_headers_get_ptr(const struct aws_http_headers *headers, size_t index) {
+    struct aws_http_header *header = NULL;
+    aws_array_list_get_at_ptr(&headers->array_list, (void **)&header, index);
+    AWS_ASSUME(header);
+    return header;
+}
+
+/* Add header at array position `index` to the table, unless its name is already present.
+ * Only the first header with a given name is indexed. Assumes the table has a free slot. */
+static void s_headers_index_insert(struct aws_http_headers *headers, size_t index) {
+    struct aws_http_header *header = s_headers_get_ptr(headers, index);
+    const uint32_t hash = aws_http_header_name_hash(header->name);
+
+    size_t slot = hash & (headers->index.capacity - 1);
+    while (headers->index.entries[slot].index_plus_one) {
+        struct aws_http_header_index_entry *entry = &headers->index.entries[slot];
+        if (entry->hash == hash &&
+            aws_http_header_name_eq(s_headers_get_ptr(headers, entry->index_plus_one - 1)->name, header->name)) {
+            /* An earlier header with this name is already indexed */
+            return;
+        }
+        slot = (slot + 1) & (headers->index.capacity - 1);
+    }
+
+    headers->index.entries[slot].hash = hash;
+    headers->index.entries[slot].index_plus_one = (uint32_t)(index + 1);
+    headers->index.num_entries++;
+}
+
+/* Ensure the index reflects every header currently in the list, (re)building as needed.
+ * Returns false if the index can't be used (allocation failure, or too many headers). */
+static bool s_headers_index_update(struct aws_http_headers *headers) {
+    const size_t count = aws_http_headers_count(headers);
+    if (count >= UINT32_MAX) {
+        return false;
+    }
+
+    /* Rebuild from scratch if the table would exceed a 3/4 load factor */
+    if (headers->index.entries && (count > (headers->index.capacity / 4) * 3)) {
+        s_headers_index_drop(headers);
+    }
+
+    if (!headers->index.entries) {
+        size_t capacity = AWS_HTTP_HEADER_INDEX_MIN_CAPACITY;
+        while (count > (capacity / 4) * 3) {
+            if (aws_mul_size_checked(capacity, 2, &capacity)) {
+                return false;
+            }
+        }
+
+        struct aws_http_header_index_entry *entries =
+            aws_mem_calloc(headers->alloc, capacity, sizeof(struct aws_http_header_index_entry));
+        if (!entries) {
+            return false;
+        }
+
+        headers->index.entries = entries;
+        headers->index.capacity = capacity;
+        headers->index.num_entries = 0;
+        headers->index.num_indexed = 0;
+    }
+
+    /* Top up with headers appended since the last lookup */
+    for (size_t i = headers->index.num_indexed; i < count; ++i) {
+        s_headers_index_insert(headers, i);
+    }
+    headers->index.num_indexed = count;
+
+    return true;
+}
+
+/* Returns pointer to the first header with this name, or NULL if absent */
+static struct aws_http_header *s_headers_index_find(struct aws_http_headers *headers, struct aws_byte_cursor name) {
+    const uint32_t hash = aws_http_header_name_hash(name);
+
+    size_t slot = hash & (headers->index.capacity - 1);
+    while (headers->index.entries[slot].index_plus_one) {
+        struct aws_http_header_index_entry *entry = &headers->index.entries[slot];
+        if (entry->hash == hash) {
+            struct aws_http_header *header = s_headers_get_ptr(headers, entry->index_plus_one - 1);
+            if (aws_http_header_name_eq(header->name, name)) {
+                return header;
+            }
+        }
+        slot = (slot + 1) & (headers->index.capacity - 1);
+    }
+
+    return NULL;
+}
+
 struct aws_http_headers *aws_http_headers_new(struct aws_allocator *allocator) {
     AWS_PRECONDITION(allocator);
 
@@ -84,7 +291,8 @@ void aws_http_headers_release(struct aws_http_headers *headers) {
 
     size_t prev_refcount = aws_atomic_fetch_sub(&headers->refcount, 1);
     if (prev_refcount == 1) {
-        aws_http_headers_clear(headers);
+        s_headers_index_drop(headers);
+        s_headers_arena_reset(headers, false /*retain_newest*/);
         aws_array_list_clean_up(&headers->array_list);
         aws_mem_release(headers->alloc, headers);
     } else {
@@ -97,6 +305,25 @@ void aws_http_headers_acquire(struct aws_http_headers *headers) {
     aws_atomic_fetch_add(&headers->refcount, 1);
 }
 
+/* Common names are interned: return the static cursor instead of the caller's, so the name
+ * bytes need no copy. Only the interned spellings are taken verbatim, so what goes out on the
+ * wire never changes. Sets *out_copy_name if the caller must copy the name into the arena. */
+static struct aws_byte_cursor s_headers_resolve_name(struct aws_byte_cursor name, bool *out_copy_name) {
+    const struct aws_http_interned_header *interned = aws_http_header_intern_lookup(name);
+    if (interned) {
+        if (aws_byte_cursor_eq(&name, &interned->name)) {
+            *out_copy_name = false;
+            return interned->name;
+        }
+        if (aws_byte_cursor_eq(&name, &interned->lowercase)) {
+            *out_copy_name = false;
+            return interned->lowercase;
+        }
+    }
+    *out_copy_name = true;
+    return name;
+}
+
 int aws_http_headers_add(struct aws_http_headers *headers, struct aws_byte_cursor name, struct aws_byte_cursor value) {
     AWS_PRECONDITION(headers);
     AWS_PRECONDITION(aws_byte_cursor_is_valid(&name) && aws_byte_cursor_is_valid(&value));
@@ -105,22 +332,25 @@ int aws_http_headers_add(struct aws_http_headers *headers, struct aws_byte_curso
         return aws_raise_error(AWS_ERROR_HTTP_INVALID_HEADER_NAME);
     }
 
-    size_t total_len;
-    if (aws_add_size_checked(name.len, value.len, &total_len)) {
+    bool copy_name = false;
+    struct aws_http_header header = {s_headers_resolve_name(name, &copy_name), value};
+
+    size_t total_len = value.len;
+    if (copy_name && aws_add_size_checked(name.len, value.len, &total_len)) {
         return AWS_OP_ERR;
     }
 
-    struct aws_http_header header = {name, value};
-
-    /* Store our own copy of the strings.
-     * We put the name and value into the same allocation. */
-    uint8_t *strmem = aws_mem_acquire(headers->alloc, total_len);
+    /* Store our own copy of the strings (minus an interned name).
+     * We put the name and value into the same arena acquisition. */
+    uint8_t *strmem = s_headers_arena_acquire(headers, total_len);
     if (!strmem) {
         return AWS_OP_ERR;
     }
 
     struct aws_byte_buf strbuf = aws_byte_buf_from_empty_array(strmem, total_len);
-    aws_byte_buf_append_and_update(&strbuf, &header.name);
+    if (copy_name) {
+        aws_byte_buf_append_and_update(&strbuf, &header.name);
+    }
     aws_byte_buf_append_and_update(&strbuf, &header.value);
 
     if (aws_array_list_push_back(&headers->array_list, &header)) {
@@ -130,35 +360,26 @@ int aws_http_headers_add(struct aws_http_headers *headers, struct aws_byte_curso
     return AWS_OP_SUCCESS;
 
 error:
-    aws_mem_release(headers->alloc, strmem);
+    /* This was the arena's most recent acquisition, so it can simply be handed back */
+    headers->block_list->len -= total_len;
     return AWS_OP_ERR;
 }
 
 void aws_http_headers_clear(struct aws_http_headers *headers) {
     AWS_PRECONDITION(headers);
 
-    struct aws_http_header *header = NULL;
-    const size_t count = aws_http_headers_count(headers);
-    for (size_t i = 0; i < count; ++i) {
-        aws_array_list_get_at_ptr(&headers->array_list, (void **)&header, i);
-        AWS_ASSUME(header);
-
-        /* Storage for name & value is in the same allocation */
-        aws_mem_release(headers->alloc, header->name.ptr);
-    }
+    /* All string storage lives in the arena. Keep its newest block for re-use. */
+    s_headers_arena_reset(headers, true /*retain_newest*/);
+    s_headers_index_drop(headers);
 
     aws_array_list_clear(&headers->array_list);
 }
 
 /* Does not check index */
 static void s_http_headers_erase_index(struct aws_http_headers *headers, size_t index) {
-    struct aws_http_header *header = NULL;
-    aws_array_list_get_at_ptr(&headers->array_list, (void **)&header, index);
-    AWS_ASSUME(header);
-
-    /* Storage for name & value is in the same allocation */
-    aws_mem_release(headers->alloc, header->name.ptr);
-
+    /* String storage stays in the arena until the headers are cleared or released.
+     * Erasing shifts later indices, so the lookup index is dropped and rebuilt on next use. */
+    s_headers_index_drop(headers);
     aws_array_list_erase(&headers->array_list, index);
 }
 
@@ -232,23 +453,59 @@ int aws_http_headers_add_array(struct aws_http_headers *headers, const struct aw
     AWS_PRECONDITION(headers);
     AWS_PRECONDITION(AWS_MEM_IS_READABLE(array, count));
 
-    const size_t orig_count = aws_http_headers_count(headers);
+    if (count == 0) {
+        return AWS_OP_SUCCESS;
+    }
 
+    /* Pass 1: validate every name and total up the string storage, so all the strings land in
+     * one arena acquisition and all the entries in one array_list reservation. The intern
+     * lookup is deterministic, so repeating it in pass 2 yields the same lengths. */
+    size_t total_len = 0;
     for (size_t i = 0; i < count; ++i) {
-        if (aws_http_headers_add(headers, array[i].name, array[i].value)) {
-            goto error;
+        if (array[i].name.len == 0) {
+            return aws_raise_error(AWS_ERROR_HTTP_INVALID_HEADER_NAME);
+        }
+
+        bool copy_name = false;
+        s_headers_resolve_name(array[i].name, &copy_name);
+
+        if (copy_name && aws_add_size_checked(total_len, array[i].name.len, &total_len)) {
+            return AWS_OP_ERR;
+        }
+        if (aws_add_size_checked(total_len, array[i].value.len, &total_len)) {
+            return AWS_OP_ERR;
         }
     }
 
-    return AWS_OP_SUCCESS;
+    size_t new_count;
+    if (aws_add_size_checked(aws_http_headers_count(headers), count, &new_count)) {
+        return AWS_OP_ERR;
+    }
+    if (aws_array_list_ensure_capacity(&headers->array_list, new_count - 1)) {
+        return AWS_OP_ERR;
+    }
 
-error:
-    /* Erase headers from the end until we're back to our previous state */
-    for (size_t new_count = aws_http_headers_count(headers); new_count > orig_count; --new_count) {
-        s_http_headers_erase_index(headers, new_count - 1);
+    uint8_t *strmem = s_headers_arena_acquire(headers, total_len);
+    if (!strmem) {
+        return AWS_OP_ERR;
     }
 
-    return AWS_OP_ERR;
+    /* Pass 2 cannot fail: entry capacity is reserved and string storage is acquired, so no
+     * partial-add rollback is needed */
+    struct aws_byte_buf strbuf = aws_byte_buf_from_empty_array(strmem, total_len);
+    for (size_t i = 0; i < count; ++i) {
+        bool copy_name = false;
+        struct aws_http_header header = {s_headers_resolve_name(array[i].name, &copy_name), array[i].value};
+
+        if (copy_name) {
+            aws_byte_buf_append_and_update(&strbuf, &header.name);
+        }
+        aws_byte_buf_append_and_update(&strbuf, &header.value);
+
+        aws_array_list_push_back(&headers->array_list, &header);
+    }
+
+    return AWS_OP_SUCCESS;
 }
 
 int aws_http_headers_set(struct aws_http_headers *headers, struct aws_byte_cursor name, struct aws_byte_cursor value) {
@@ -291,8 +548,22 @@ int aws_http_headers_get(
     AWS_PRECONDITION(out_value);
     AWS_PRECONDITION(aws_byte_cursor_is_valid(&name));
 
-    struct aws_http_header *header = NULL;
+    /* Lazily building the index doesn't change the headers' observable state */
+    struct aws_http_headers *mutable_headers = (struct aws_http_headers *)(void *)headers;
+
     const size_t count = aws_http_headers_count(headers);
+    if (count >= AWS_HTTP_HEADER_INDEX_MIN_COUNT && s_headers_index_update(mutable_headers)) {
+        struct aws_http_header *header = s_headers_index_find(mutable_headers, name);
+        if (header) {
+            *out_value = header->value;
+            return AWS_OP_SUCCESS;
+        }
+
+        return aws_raise_error(AWS_ERROR_HTTP_HEADER_NOT_FOUND);
+    }
+
+    /* Small header sets (and allocation failure) use a linear scan */
+    struct aws_http_header *header = NULL;
     for (size_t i = 0; i < count; ++i) {
         aws_array_list_get_at_ptr(&headers->array_list, (void **)&header, i);
         AWS_ASSUME(header);
@@ -310,6 +581,9 @@ struct aws_http_message {
     struct aws_allocator *allocator;
     struct aws_http_headers *headers;
     struct aws_input_stream *body_stream;
+    /* Vectored alternative to body_stream: aws_http_body_segment entries, sent in order.
+     * Initialized lazily by the first aws_http_message_add_body_segment_*() call. */
+    struct aws_array_list body_segments;
     struct aws_atomic_var refcount;
 
     /* Data specific to the request or response subclasses */
@@ -325,8 +599,14 @@ struct aws_http_message {
 
     struct aws_http_message_request_data *request_data;
     struct aws_http_message_response_data *response_data;
+
+    /* True while the headers object is shared with a snapshot (see aws_http_message_snapshot()).
+     * The first mutation through this message copies the headers and clears the flag. */
+    bool headers_cow;
 };
 
+static int s_message_append_body_segment(struct aws_http_message *message, const struct aws_http_body_segment *segment);
+
 static int s_set_string_from_cursor(
     struct aws_string **dst,
     struct aws_byte_cursor cursor,
@@ -435,6 +715,7 @@ void aws_http_message_release(struct aws_http_message *message) {
         }
 
         aws_http_headers_release(message->headers);
+        aws_array_list_clean_up(&message->body_segments);
 
         aws_mem_release(message->allocator, message);
     } else {
@@ -447,6 +728,88 @@ void aws_http_message_acquire(struct aws_http_message *message) {
     aws_atomic_fetch_add(&message->refcount, 1);
 }
 
+/* Give the message a private copy of snapshot-shared headers before a mutation.
+ * No-op unless the headers are marked copy-on-write. */
+static int s_message_unshare_headers(struct aws_http_message *message) {
+    if (!message->headers_cow) {
+        return AWS_OP_SUCCESS;
+    }
+
+    struct aws_http_headers *shared = message->headers;
+    struct aws_http_headers *copy = aws_http_headers_new(message->allocator);
+    if (!copy) {
+        return AWS_OP_ERR;
+    }
+
+    const size_t count = aws_http_headers_count(shared);
+    if (count) {
+        /* The entries are stored contiguously, so the copy is one bulk add */
+        if (aws_http_headers_add_array(copy, shared->array_list.data, count)) {
+            aws_http_headers_release(copy);
+            return AWS_OP_ERR;
+        }
+    }
+
+    aws_http_headers_release(shared);
+    message->headers = copy;
+    message->headers_cow = false;
+    return AWS_OP_SUCCESS;
+}
+
+struct aws_http_message *aws_http_message_snapshot(struct aws_http_message *message) {
+    AWS_PRECONDITION(message);
+
+    struct aws_http_message *snapshot = s_message_new_common(message->allocator, message->headers);
+    if (!snapshot) {
+        return NULL;
+    }
+
+    if (message->request_data) {
+        snapshot->request_data = &snapshot->subclass_data.request;
+
+        if (message->request_data->method &&
+            s_set_string_from_cursor(
+                &snapshot->request_data->method,
+                aws_byte_cursor_from_string(message->request_data->method),
+                snapshot->allocator)) {
+            goto error;
+        }
+        if (message->request_data->path &&
+            s_set_string_from_cursor(
+                &snapshot->request_data->path,
+                aws_byte_cursor_from_string(message->request_data->path),
+                snapshot->allocator)) {
+            goto error;
+        }
+    } else if (message->response_data) {
+        snapshot->response_data = &snapshot->subclass_data.response;
+        snapshot->response_data->status = message->response_data->status;
+    }
+
+    snapshot->body_stream = message->body_stream;
+
+    /* Segments are small value types; the snapshot gets its own copies */
+    const size_t num_segments = aws_http_message_get_body_segment_count(message);
+    for (size_t i = 0; i < num_segments; ++i) {
+        struct aws_http_body_segment segment;
+        aws_array_list_get_at(&message->body_segments, &segment, i);
+        if (s_message_append_body_segment(snapshot, &segment)) {
+            goto error;
+        }
+    }
+
+    /* From here on both sides treat the shared headers as copy-on-write;
+     * whichever message mutates first pays for the copy */
+    message->headers_cow = true;
+    snapshot->headers_cow = true;
+
+    return snapshot;
+
+error:
+    aws_http_message_release(snapshot);
+    return NULL;
+}
+
 bool aws_http_message_is_request(const struct aws_http_message *message) {
     AWS_PRECONDITION(message);
     return message->request_data;
@@ -557,8 +920,78 @@ struct aws_input_stream *aws_http_message_get_body_stream(const struct aws_http_
     return message->body_stream;
 }
 
+static int s_message_append_body_segment(struct aws_http_message *message, const struct aws_http_body_segment *segment) {
+    if (message->body_stream) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_GENERAL,
+            "id=%p: Cannot add body segment, message already has a body stream.",
+            (void *)message);
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    if (!message->body_segments.alloc) {
+        if (aws_array_list_init_dynamic(
+                &message->body_segments,
+                message->allocator,
+                AWS_HTTP_MESSAGE_NUM_RESERVED_BODY_SEGMENTS,
+                sizeof(struct aws_http_body_segment))) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    return aws_array_list_push_back(&message->body_segments, segment);
+}
+
+int aws_http_message_add_body_segment_stream(struct aws_http_message *message, struct aws_input_stream *stream) {
+    AWS_PRECONDITION(message);
+    AWS_PRECONDITION(stream);
+
+    struct aws_http_body_segment segment = {
+        .type = AWS_HTTP_BODY_SEGMENT_STREAM,
+        .stream = stream,
+    };
+    return s_message_append_body_segment(message, &segment);
+}
+
+int aws_http_message_add_body_segment_cursor(struct aws_http_message *message, struct aws_byte_cursor segment_data) {
+    AWS_PRECONDITION(message);
+    AWS_PRECONDITION(aws_byte_cursor_is_valid(&segment_data));
+
+    struct aws_http_body_segment segment = {
+        .type = AWS_HTTP_BODY_SEGMENT_CURSOR,
+        .cursor = segment_data,
+    };
+    return s_message_append_body_segment(message, &segment);
+}
+
+size_t aws_http_message_get_body_segment_count(const struct aws_http_message *message) {
+    AWS_PRECONDITION(message);
+    return message->body_segments.alloc ? aws_array_list_length(&message->body_segments) : 0;
+}
+
+int aws_http_message_get_body_segment(
+    const struct aws_http_message *message,
+    size_t index,
+    struct aws_http_body_segment *out_segment) {
+
+    AWS_PRECONDITION(message);
+    AWS_PRECONDITION(out_segment);
+
+    if (index >= aws_http_message_get_body_segment_count(message)) {
+        return aws_raise_error(AWS_ERROR_INVALID_INDEX);
+    }
+
+    return aws_array_list_get_at(&message->body_segments, out_segment, index);
+}
+
 struct aws_http_headers *aws_http_message_get_headers(struct aws_http_message *message) {
     AWS_PRECONDITION(message);
+
+    /* Handing out a mutable reference counts as a mutation for copy-on-write purposes */
+    if (s_message_unshare_headers(message)) {
+        return NULL;
+    }
+
     return message->headers;
 }
 
@@ -568,6 +1001,9 @@ const struct aws_http_headers *aws_http_message_get_const_headers(const struct a
 }
 
 int aws_http_message_add_header(struct aws_http_message *message, struct aws_http_header header) {
+    if (s_message_unshare_headers(message)) {
+        return AWS_OP_ERR;
+    }
     return aws_http_headers_add(message->headers, header.name, header.value);
 }
 
@@ -576,10 +1012,16 @@ int aws_http_message_add_header_array(
     const struct aws_http_header *headers,
     size_t num_headers) {
 
+    if (s_message_unshare_headers(message)) {
+        return AWS_OP_ERR;
+    }
     return aws_http_headers_add_array(message->headers, headers, num_headers);
 }
 
 int aws_http_message_erase_header(struct aws_http_message *message, size_t index) {
+    if (s_message_unshare_headers(message)) {
+        return AWS_OP_ERR;
+    }
     return aws_http_headers_erase_index(message->headers, index);
 }
 
@@ -612,6 +1054,15 @@ struct aws_http_stream *aws_http_connection_make_request(
         return NULL;
     }
 
+    if (options->response_body_sink && options->on_response_body) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_CONNECTION,
+            "id=%p: Cannot create client request, response_body_sink and on_response_body are mutually exclusive.",
+            (void *)client_connection);
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
     /* Connection owns stream, and must outlive stream */
     aws_http_connection_acquire(client_connection);
 
@@ -674,6 +1125,11 @@ struct aws_http_connection *aws_http_stream_get_connection(const struct aws_http
     return stream->owning_connection;
 }
 
+void aws_http_stream_get_metrics(const struct aws_http_stream *stream, struct aws_http_stream_metrics *out_metrics) {
+    AWS_ASSERT(stream && out_metrics);
+    *out_metrics = stream->metrics;
+}
+
 int aws_http_stream_get_incoming_response_status(const struct aws_http_stream *stream, int *out_status) {
     AWS_ASSERT(stream && stream->client_data);
 
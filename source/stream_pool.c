@@ -0,0 +1,64 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/stream_pool.h>
+
+void aws_http_stream_pool_init(struct aws_http_stream_pool *pool, struct aws_allocator *alloc, size_t object_size) {
+    AWS_ASSERT(object_size > 0);
+
+    pool->alloc = alloc;
+    pool->object_size = object_size;
+    for (size_t i = 0; i < AWS_HTTP_STREAM_POOL_SLOTS; ++i) {
+        aws_atomic_init_ptr(&pool->slots[i], NULL);
+    }
+}
+
+void aws_http_stream_pool_clean_up(struct aws_http_stream_pool *pool) {
+    for (size_t i = 0; i < AWS_HTTP_STREAM_POOL_SLOTS; ++i) {
+        void *object = aws_atomic_load_ptr(&pool->slots[i]);
+        if (object != NULL) {
+            aws_mem_release(pool->alloc, object);
+        }
+        aws_atomic_init_ptr(&pool->slots[i], NULL);
+    }
+}
+
+void *aws_http_stream_pool_acquire(struct aws_http_stream_pool *pool) {
+    for (size_t i = 0; i < AWS_HTTP_STREAM_POOL_SLOTS; ++i) {
+        struct aws_atomic_var *slot = &pool->slots[i];
+        void *object = aws_atomic_load_ptr(slot);
+        if (object != NULL && aws_atomic_compare_exchange_ptr(slot, &object, NULL)) {
+            /* Callers expect calloc semantics */
+            memset(object, 0, pool->object_size);
+            return object;
+        }
+    }
+
+    return aws_mem_calloc(pool->alloc, 1, pool->object_size);
+}
+
+void aws_http_stream_pool_release(struct aws_http_stream_pool *pool, void *object) {
+    AWS_ASSERT(object != NULL);
+
+    for (size_t i = 0; i < AWS_HTTP_STREAM_POOL_SLOTS; ++i) {
+        struct aws_atomic_var *slot = &pool->slots[i];
+        void *expected = NULL;
+        if (aws_atomic_load_ptr(slot) == NULL && aws_atomic_compare_exchange_ptr(slot, &expected, object)) {
+            return;
+        }
+    }
+
+    aws_mem_release(pool->alloc, object);
+}
@@ -14,6 +14,89 @@
  */
 #include <aws/http/private/strutil.h>
 
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#    define AWS_STRUTIL_SIMD_X86 1
+#    include <aws/common/cpuid.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#        define AWS_STRUTIL_SIMD_TARGET_SSE2
+#        define AWS_STRUTIL_SIMD_TARGET_SSE41
+#        define AWS_STRUTIL_SIMD_TARGET_AVX2
+#    else
+#        include <x86intrin.h>
+#        define AWS_STRUTIL_SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+#        define AWS_STRUTIL_SIMD_TARGET_SSE41 __attribute__((target("sse4.1")))
+#        define AWS_STRUTIL_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#    endif
+#endif
+
+/* SWAR (SIMD-within-a-register) helpers for the numeric fast paths below.
+ * Eight characters are loaded into a uint64_t, validated in parallel with bytewise
+ * range checks, and accumulated without per-character branches. */
+
+#define SWAR_ONES 0x0101010101010101ULL
+#define SWAR_MSBS 0x8080808080808080ULL
+
+/* Little-endian load regardless of host byte order (first character in the low byte).
+ * Compilers reduce this to a single load on little-endian targets. */
+static uint64_t s_load_8_chars(const uint8_t *src) {
+    return (uint64_t)src[0] | ((uint64_t)src[1] << 8) | ((uint64_t)src[2] << 16) | ((uint64_t)src[3] << 24) |
+           ((uint64_t)src[4] << 32) | ((uint64_t)src[5] << 40) | ((uint64_t)src[6] << 48) | ((uint64_t)src[7] << 56);
+}
+
+/* Per-byte `>= n` mask. Valid for n < 0x80 and bytes with the high bit clear:
+ * setting each byte's high bit first makes the subtraction borrow-free, so the
+ * high bit survives exactly in the bytes that were >= n. */
+static uint64_t s_swar_ge(uint64_t bytes, uint8_t n) {
+    return ((bytes | SWAR_MSBS) - (SWAR_ONES * n)) & SWAR_MSBS;
+}
+
+static bool s_swar_all_decimal(uint64_t chunk) {
+    if (chunk & SWAR_MSBS) {
+        return false;
+    }
+    return (s_swar_ge(chunk, '0') & ~s_swar_ge(chunk, '9' + 1) & SWAR_MSBS) == SWAR_MSBS;
+}
+
+static bool s_swar_all_hex(uint64_t chunk) {
+    if (chunk & SWAR_MSBS) {
+        return false;
+    }
+    const uint64_t lowercased = chunk | (SWAR_ONES * 0x20);
+    const uint64_t is_digit = s_swar_ge(chunk, '0') & ~s_swar_ge(chunk, '9' + 1);
+    const uint64_t is_alpha = s_swar_ge(lowercased, 'a') & ~s_swar_ge(lowercased, 'f' + 1);
+    return ((is_digit | is_alpha) & SWAR_MSBS) == SWAR_MSBS;
+}
+
+/* Value of 8 validated decimal digits, most significant digit first.
+ * Adjacent digits are merged pairwise: bytes to hundreds, pairs to ten-thousands,
+ * quads to the final value, using one multiply per level. */
+static uint32_t s_swar_parse_eight_decimal(uint64_t chunk) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 0x000F424000000064ULL; /* 100 + (1000000 << 32) */
+    const uint64_t mul2 = 0x0000271000000001ULL; /* 1 + (10000 << 32) */
+
+    chunk -= SWAR_ONES * '0';
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+    return (uint32_t)chunk;
+}
+
+/* Value of 8 validated hex digits, most significant digit first. */
+static uint32_t s_swar_parse_eight_hex(uint64_t chunk) {
+    /* Each byte to its nibble value: a hex letter (either case) has bit 6 set
+     * and its low nibble 9 short of its value; a decimal digit has neither. */
+    const uint64_t nibbles = (chunk & (SWAR_ONES * 0x0F)) + 9 * ((chunk >> 6) & SWAR_ONES);
+
+    /* Fold nibbles into pairs, pairs into quads, then assemble the quads */
+    uint64_t pairs = (nibbles | (nibbles << 12)) & 0xFF00FF00FF00FF00ULL;
+    pairs >>= 8;
+    const uint64_t quads = ((pairs | (pairs << 24)) & 0xFFFF0000FFFF0000ULL) >> 16;
+    return ((uint32_t)quads << 16) | (uint32_t)(quads >> 32);
+}
+
 /* Lookup from '0' -> 0, 'f' -> 0xf, 'F' -> 0xF, etc
  * invalid characters have value 255 */
 /* clang-format off */
@@ -40,14 +123,10 @@ static const uint8_t s_ascii_to_num_table[256] = {
 };
 /* clang-format on */
 
-static int s_read_unsigned(struct aws_byte_cursor cursor, uint64_t *dst, uint8_t base) {
-    uint64_t val = 0;
-    *dst = 0;
-
-    if (cursor.len == 0) {
-        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
-    }
-
+/* Scalar continuation: accumulates the remaining characters onto `val`.
+ * Handles short inputs, trailing characters, and rejection of whatever
+ * byte made a SWAR chunk invalid. */
+static int s_read_unsigned(struct aws_byte_cursor cursor, uint64_t *dst, uint8_t base, uint64_t val) {
     /* read from left to right */
     for (size_t i = 0; i < cursor.len; ++i) {
         const uint8_t c = cursor.ptr[i];
@@ -74,11 +153,61 @@ static int s_read_unsigned(struct aws_byte_cursor cursor, uint64_t *dst, uint8_t
 }
 
 int aws_strutil_read_unsigned_num(struct aws_byte_cursor cursor, uint64_t *dst) {
-    return s_read_unsigned(cursor, dst, 10 /*base*/);
+    *dst = 0;
+
+    if (cursor.len == 0) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    uint64_t val = 0;
+    while (cursor.len >= 8) {
+        const uint64_t chunk = s_load_8_chars(cursor.ptr);
+        if (!s_swar_all_decimal(chunk)) {
+            /* Chunk contains a non-digit; the scalar loop below rejects it */
+            break;
+        }
+
+        if (val > UINT64_MAX / 100000000ULL) {
+            return aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+        }
+        val *= 100000000ULL;
+
+        const uint64_t chunk_val = s_swar_parse_eight_decimal(chunk);
+        if (val > UINT64_MAX - chunk_val) {
+            return aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+        }
+        val += chunk_val;
+
+        aws_byte_cursor_advance(&cursor, 8);
+    }
+
+    return s_read_unsigned(cursor, dst, 10 /*base*/, val);
 }
 
 int aws_strutil_read_unsigned_hex(struct aws_byte_cursor cursor, uint64_t *dst) {
-    return s_read_unsigned(cursor, dst, 16 /*base*/);
+    *dst = 0;
+
+    if (cursor.len == 0) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    uint64_t val = 0;
+    while (cursor.len >= 8) {
+        const uint64_t chunk = s_load_8_chars(cursor.ptr);
+        if (!s_swar_all_hex(chunk)) {
+            /* Chunk contains a non-hex character; the scalar loop below rejects it */
+            break;
+        }
+
+        if (val > UINT64_MAX >> 32) {
+            return aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+        }
+        val = (val << 32) | s_swar_parse_eight_hex(chunk);
+
+        aws_byte_cursor_advance(&cursor, 8);
+    }
+
+    return s_read_unsigned(cursor, dst, 16 /*base*/, val);
 }
 
 static struct aws_byte_cursor s_trim(struct aws_byte_cursor cursor, const bool trim_table[256]) {
@@ -112,3 +241,276 @@ static const bool s_http_whitespace_table[256] = {
 struct aws_byte_cursor aws_strutil_trim_http_whitespace(struct aws_byte_cursor cursor) {
     return s_trim(cursor, s_http_whitespace_table);
 }
+
+/* Byte classifications below come in a scalar flavor (also used for vector tails and
+ * non-x86 builds) and 16/32-byte vector flavors, dispatched through a cached function
+ * pointer the same way the h1 decoder dispatches its CRLF scan. */
+
+/* tchar = "!" / "#" / "$" / "%" / "&" / "'" / "*" / "+" / "-" / "." /
+ *         "^" / "_" / "`" / "|" / "~" / DIGIT / ALPHA
+ * RFC7230 section 3.2.6 Field Value Components */
+/* clang-format off */
+static const bool s_http_token_table[256] = {
+    ['!'] = true, ['#'] = true, ['$'] = true, ['%'] = true, ['&'] = true, ['\''] = true, ['*'] = true,
+    ['+'] = true, ['-'] = true, ['.'] = true, ['^'] = true, ['_'] = true, ['`'] = true, ['|'] = true, ['~'] = true,
+    ['0'] = true, ['1'] = true, ['2'] = true, ['3'] = true, ['4'] = true, ['5'] = true, ['6'] = true, ['7'] = true,
+    ['8'] = true, ['9'] = true,
+    ['a'] = true, ['b'] = true, ['c'] = true, ['d'] = true, ['e'] = true, ['f'] = true, ['g'] = true, ['h'] = true,
+    ['i'] = true, ['j'] = true, ['k'] = true, ['l'] = true, ['m'] = true, ['n'] = true, ['o'] = true, ['p'] = true,
+    ['q'] = true, ['r'] = true, ['s'] = true, ['t'] = true, ['u'] = true, ['v'] = true, ['w'] = true, ['x'] = true,
+    ['y'] = true, ['z'] = true,
+    ['A'] = true, ['B'] = true, ['C'] = true, ['D'] = true, ['E'] = true, ['F'] = true, ['G'] = true, ['H'] = true,
+    ['I'] = true, ['J'] = true, ['K'] = true, ['L'] = true, ['M'] = true, ['N'] = true, ['O'] = true, ['P'] = true,
+    ['Q'] = true, ['R'] = true, ['S'] = true, ['T'] = true, ['U'] = true, ['V'] = true, ['W'] = true, ['X'] = true,
+    ['Y'] = true, ['Z'] = true,
+};
+/* clang-format on */
+
+typedef bool(is_token_fn)(const uint8_t *bytes, size_t len);
+typedef bool(has_uppercase_fn)(const uint8_t *bytes, size_t len);
+typedef void(tolower_fn)(uint8_t *dst, const uint8_t *src, size_t len);
+
+static bool s_is_token_scalar(const uint8_t *bytes, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        if (!s_http_token_table[bytes[i]]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Per-byte `is A-Z` mask (0x80 in matching bytes). Bytes with the high bit set are
+ * masked out explicitly, since s_swar_ge is only valid for ASCII input. */
+static uint64_t s_swar_uppercase_mask(uint64_t chunk) {
+    return s_swar_ge(chunk, 'A') & ~s_swar_ge(chunk, 'Z' + 1) & ~chunk & SWAR_MSBS;
+}
+
+static bool s_has_uppercase_scalar(const uint8_t *bytes, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, bytes + i, 8);
+        if (s_swar_uppercase_mask(chunk)) {
+            return true;
+        }
+    }
+
+    for (; i < len; ++i) {
+        if (bytes[i] >= 'A' && bytes[i] <= 'Z') {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void s_tolower_scalar(uint8_t *dst, const uint8_t *src, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, src + i, 8);
+        /* The uppercase mask is 0x80 per matching byte; shifted down to 0x20, adding it
+         * is a case fold with no cross-byte carries */
+        chunk += s_swar_uppercase_mask(chunk) >> 2;
+        memcpy(dst + i, &chunk, 8);
+    }
+
+    for (; i < len; ++i) {
+        const uint8_t c = src[i];
+        dst[i] = (c >= 'A' && c <= 'Z') ? (uint8_t)(c + ('a' - 'A')) : c;
+    }
+}
+
+#if defined(AWS_STRUTIL_SIMD_X86)
+
+/* Nibble-indexed classification for the token check: a byte is a tchar iff
+ * (lo_lut[c & 0xF] & hi_lut[c >> 4]) != 0, where each bit position stands for one
+ * high nibble. All tchars live in high nibbles 2-7, so bytes >= 0x80 classify as
+ * invalid via the zero rows of hi_lut. */
+
+#    define AWS_STRUTIL_TOKEN_LO_LUT                                                                                   \
+        (char)0xE8, (char)0xFC, (char)0xF8, (char)0xFC, (char)0xFC, (char)0xFC, (char)0xFC, (char)0xFC, (char)0xF8,    \
+            (char)0xF8, (char)0xF4, (char)0x54, (char)0xD0, (char)0x54, (char)0xF4, (char)0x70
+#    define AWS_STRUTIL_TOKEN_HI_LUT                                                                                   \
+        (char)0x01, (char)0x02, (char)0x04, (char)0x08, (char)0x10, (char)0x20, (char)0x40, (char)0x80, 0, 0, 0, 0, 0, \
+            0, 0, 0
+
+AWS_STRUTIL_SIMD_TARGET_SSE41
+static bool s_is_token_sse41(const uint8_t *bytes, size_t len) {
+    const __m128i lo_lut = _mm_setr_epi8(AWS_STRUTIL_TOKEN_LO_LUT);
+    const __m128i hi_lut = _mm_setr_epi8(AWS_STRUTIL_TOKEN_HI_LUT);
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(bytes + i));
+        __m128i lo_bits = _mm_shuffle_epi8(lo_lut, _mm_and_si128(chunk, nibble_mask));
+        __m128i hi_bits = _mm_shuffle_epi8(hi_lut, _mm_and_si128(_mm_srli_epi16(chunk, 4), nibble_mask));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo_bits, hi_bits), _mm_setzero_si128()))) {
+            return false;
+        }
+    }
+
+    return s_is_token_scalar(bytes + i, len - i);
+}
+
+AWS_STRUTIL_SIMD_TARGET_AVX2
+static bool s_is_token_avx2(const uint8_t *bytes, size_t len) {
+    /* _mm256_shuffle_epi8 looks up within each 128-bit lane, so the tables repeat per lane */
+    const __m256i lo_lut = _mm256_setr_epi8(AWS_STRUTIL_TOKEN_LO_LUT, AWS_STRUTIL_TOKEN_LO_LUT);
+    const __m256i hi_lut = _mm256_setr_epi8(AWS_STRUTIL_TOKEN_HI_LUT, AWS_STRUTIL_TOKEN_HI_LUT);
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(bytes + i));
+        __m256i lo_bits = _mm256_shuffle_epi8(lo_lut, _mm256_and_si256(chunk, nibble_mask));
+        __m256i hi_bits = _mm256_shuffle_epi8(hi_lut, _mm256_and_si256(_mm256_srli_epi16(chunk, 4), nibble_mask));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(lo_bits, hi_bits), _mm256_setzero_si256()))) {
+            return false;
+        }
+    }
+
+    return s_is_token_scalar(bytes + i, len - i);
+}
+
+/* Signed compares suffice for the A-Z range check: A-Z are positive,
+ * and bytes >= 0x80 (negative) fail the `> 'A' - 1` test */
+
+AWS_STRUTIL_SIMD_TARGET_SSE2
+static bool s_has_uppercase_sse2(const uint8_t *bytes, size_t len) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(bytes + i));
+        __m128i is_upper =
+            _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), chunk));
+        if (_mm_movemask_epi8(is_upper)) {
+            return true;
+        }
+    }
+
+    return s_has_uppercase_scalar(bytes + i, len - i);
+}
+
+AWS_STRUTIL_SIMD_TARGET_AVX2
+static bool s_has_uppercase_avx2(const uint8_t *bytes, size_t len) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(bytes + i));
+        __m256i is_upper = _mm256_and_si256(
+            _mm256_cmpgt_epi8(chunk, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), chunk));
+        if (_mm256_movemask_epi8(is_upper)) {
+            return true;
+        }
+    }
+
+    return s_has_uppercase_scalar(bytes + i, len - i);
+}
+
+AWS_STRUTIL_SIMD_TARGET_SSE2
+static void s_tolower_sse2(uint8_t *dst, const uint8_t *src, size_t len) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i is_upper =
+            _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), chunk));
+        chunk = _mm_add_epi8(chunk, _mm_and_si128(is_upper, _mm_set1_epi8(0x20)));
+        _mm_storeu_si128((__m128i *)(dst + i), chunk);
+    }
+
+    s_tolower_scalar(dst + i, src + i, len - i);
+}
+
+AWS_STRUTIL_SIMD_TARGET_AVX2
+static void s_tolower_avx2(uint8_t *dst, const uint8_t *src, size_t len) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i is_upper = _mm256_and_si256(
+            _mm256_cmpgt_epi8(chunk, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), chunk));
+        chunk = _mm256_add_epi8(chunk, _mm256_and_si256(is_upper, _mm256_set1_epi8(0x20)));
+        _mm256_storeu_si256((__m256i *)(dst + i), chunk);
+    }
+
+    s_tolower_scalar(dst + i, src + i, len - i);
+}
+
+#endif /* AWS_STRUTIL_SIMD_X86 */
+
+static is_token_fn *s_choose_is_token_fn(void) {
+#if defined(AWS_STRUTIL_SIMD_X86)
+    if (aws_cpu_has_feature(AWS_CPU_FEATURE_AVX2)) {
+        return s_is_token_avx2;
+    }
+    /* The nibble lookup needs pshufb; SSE4.1 is the nearest feature cpuid reports */
+    if (aws_cpu_has_feature(AWS_CPU_FEATURE_SSE_4_1)) {
+        return s_is_token_sse41;
+    }
+#endif
+    return s_is_token_scalar;
+}
+
+static has_uppercase_fn *s_choose_has_uppercase_fn(void) {
+#if defined(AWS_STRUTIL_SIMD_X86)
+    if (aws_cpu_has_feature(AWS_CPU_FEATURE_AVX2)) {
+        return s_has_uppercase_avx2;
+    }
+    /* SSE2 is part of the x86-64 baseline */
+    return s_has_uppercase_sse2;
+#else
+    return s_has_uppercase_scalar;
+#endif
+}
+
+static tolower_fn *s_choose_tolower_fn(void) {
+#if defined(AWS_STRUTIL_SIMD_X86)
+    if (aws_cpu_has_feature(AWS_CPU_FEATURE_AVX2)) {
+        return s_tolower_avx2;
+    }
+    return s_tolower_sse2;
+#else
+    return s_tolower_scalar;
+#endif
+}
+
+bool aws_strutil_is_http_token(struct aws_byte_cursor cursor) {
+    static is_token_fn *s_is_token_impl;
+
+    if (cursor.len == 0) {
+        return false;
+    }
+
+    /* Benign race: several threads may resolve the function pointer simultaneously,
+     * but they all arrive at the same answer. */
+    is_token_fn *impl = s_is_token_impl;
+    if (AWS_UNLIKELY(!impl)) {
+        impl = s_choose_is_token_fn();
+        s_is_token_impl = impl;
+    }
+
+    return impl(cursor.ptr, cursor.len);
+}
+
+bool aws_strutil_ascii_has_uppercase(struct aws_byte_cursor cursor) {
+    static has_uppercase_fn *s_has_uppercase_impl;
+
+    has_uppercase_fn *impl = s_has_uppercase_impl;
+    if (AWS_UNLIKELY(!impl)) {
+        impl = s_choose_has_uppercase_fn();
+        s_has_uppercase_impl = impl;
+    }
+
+    return impl(cursor.ptr, cursor.len);
+}
+
+void aws_strutil_ascii_tolower(uint8_t *dst, const uint8_t *src, size_t len) {
+    static tolower_fn *s_tolower_impl;
+
+    tolower_fn *impl = s_tolower_impl;
+    if (AWS_UNLIKELY(!impl)) {
+        impl = s_choose_tolower_fn();
+        s_tolower_impl = impl;
+    }
+
+    impl(dst, src, len);
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/timing_wheel.h>
+
+int aws_http_timing_wheel_init(
+    struct aws_http_timing_wheel *wheel,
+    struct aws_allocator *alloc,
+    uint64_t tick_ns,
+    size_t num_slots,
+    uint64_t now_ns) {
+
+    AWS_PRECONDITION(wheel);
+    AWS_PRECONDITION(alloc);
+
+    if (tick_ns == 0 || num_slots == 0 || (num_slots & (num_slots - 1)) != 0) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    AWS_ZERO_STRUCT(*wheel);
+
+    wheel->slots = aws_mem_calloc(alloc, num_slots, sizeof(struct aws_linked_list));
+    if (!wheel->slots) {
+        return AWS_OP_ERR;
+    }
+
+    for (size_t i = 0; i < num_slots; ++i) {
+        aws_linked_list_init(&wheel->slots[i]);
+    }
+
+    wheel->alloc = alloc;
+    wheel->num_slots = num_slots;
+    wheel->tick_ns = tick_ns;
+    wheel->current_tick = now_ns / tick_ns;
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_http_timing_wheel_clean_up(struct aws_http_timing_wheel *wheel) {
+    if (!wheel->slots) {
+        return;
+    }
+
+    /* Timers are embedded in their owners; just unhook any that are still armed. */
+    for (size_t i = 0; i < wheel->num_slots; ++i) {
+        while (!aws_linked_list_empty(&wheel->slots[i])) {
+            struct aws_linked_list_node *node = aws_linked_list_pop_front(&wheel->slots[i]);
+            struct aws_http_timing_wheel_timer *timer =
+                AWS_CONTAINER_OF(node, struct aws_http_timing_wheel_timer, node);
+            timer->is_armed = false;
+        }
+    }
+
+    aws_mem_release(wheel->alloc, wheel->slots);
+    AWS_ZERO_STRUCT(*wheel);
+}
+
+void aws_http_timing_wheel_arm(
+    struct aws_http_timing_wheel *wheel,
+    struct aws_http_timing_wheel_timer *timer,
+    uint64_t deadline_ns,
+    aws_http_timing_wheel_on_timeout_fn *fn,
+    void *user_data) {
+
+    AWS_PRECONDITION(fn);
+
+    if (timer->is_armed) {
+        aws_http_timing_wheel_cancel(wheel, timer);
+    }
+
+    timer->deadline_ns = deadline_ns;
+    timer->fn = fn;
+    timer->user_data = user_data;
+    timer->is_armed = true;
+
+    /* Round the deadline up to a whole tick: when that tick's slot is scanned the deadline
+     * has definitely passed, so a timer never has to wait out an extra rotation. */
+    uint64_t deadline_tick = (deadline_ns + wheel->tick_ns - 1) / wheel->tick_ns;
+
+    /* A deadline in a tick the wheel already processed would wait out a whole rotation;
+     * park it in the next tick's slot instead so it fires promptly. */
+    if (deadline_tick <= wheel->current_tick) {
+        deadline_tick = wheel->current_tick + 1;
+    }
+
+    aws_linked_list_push_back(&wheel->slots[deadline_tick & (wheel->num_slots - 1)], &timer->node);
+    ++wheel->armed_count;
+}
+
+void aws_http_timing_wheel_cancel(struct aws_http_timing_wheel *wheel, struct aws_http_timing_wheel_timer *timer) {
+    if (!timer->is_armed) {
+        return;
+    }
+
+    aws_linked_list_remove(&timer->node);
+    timer->is_armed = false;
+
+    AWS_ASSERT(wheel->armed_count > 0);
+    --wheel->armed_count;
+}
+
+void aws_http_timing_wheel_run(struct aws_http_timing_wheel *wheel, uint64_t now_ns) {
+    const uint64_t now_tick = now_ns / wheel->tick_ns;
+    if (now_tick <= wheel->current_tick) {
+        return;
+    }
+
+    /* Collect due timers first, then fire, so callbacks may arm/cancel freely. */
+    struct aws_linked_list fired;
+    aws_linked_list_init(&fired);
+
+    /* If more than a full rotation elapsed, every slot is due for a scan exactly once. */
+    uint64_t ticks_to_scan = now_tick - wheel->current_tick;
+    if (ticks_to_scan > wheel->num_slots) {
+        ticks_to_scan = wheel->num_slots;
+    }
+
+    for (uint64_t i = 1; i <= ticks_to_scan; ++i) {
+        struct aws_linked_list *slot = &wheel->slots[(wheel->current_tick + i) & (wheel->num_slots - 1)];
+
+        struct aws_linked_list_node *node = aws_linked_list_begin(slot);
+        while (node != aws_linked_list_end(slot)) {
+            struct aws_http_timing_wheel_timer *timer =
+                AWS_CONTAINER_OF(node, struct aws_http_timing_wheel_timer, node);
+            node = aws_linked_list_next(node);
+
+            /* Timers from later rotations hash into the same slot; leave those alone. */
+            if (timer->deadline_ns <= now_ns) {
+                aws_linked_list_remove(&timer->node);
+                timer->is_armed = false;
+                --wheel->armed_count;
+                aws_linked_list_push_back(&fired, &timer->node);
+            }
+        }
+    }
+
+    wheel->current_tick = now_tick;
+
+    while (!aws_linked_list_empty(&fired)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&fired);
+        struct aws_http_timing_wheel_timer *timer = AWS_CONTAINER_OF(node, struct aws_http_timing_wheel_timer, node);
+        timer->fn(timer, timer->user_data);
+    }
+}
@@ -51,6 +51,9 @@ enum {
 struct outgoing_frame {
     struct aws_websocket_send_frame_options def;
     struct aws_linked_list_node node;
+
+    /* Link in the cross-thread send queue (see aws_websocket.send_queue) */
+    struct outgoing_frame *send_queue_next;
 };
 
 struct aws_websocket {
@@ -71,6 +74,10 @@ struct aws_websocket {
     struct aws_channel_task waiting_on_payload_stream_task;
     bool is_server;
 
+    /* Result of permessage-deflate negotiation, fixed at handshake time. */
+    bool permessage_deflate_negotiated;
+    struct aws_websocket_permessage_deflate_options permessage_deflate;
+
     /* Data that should only be accessed from the websocket's channel thread. */
     struct {
         struct aws_websocket_encoder encoder;
@@ -120,27 +127,36 @@ struct aws_websocket {
         bool is_midchannel_handler;
     } thread_data;
 
+    /* Cross-thread send queue. Producers push frames with lock-free atomic ops and the channel
+     * thread drains the whole queue per task wake-up, so aws_websocket_send_frame() never takes
+     * the synced_data lock no matter how many threads are feeding the socket. */
+    struct {
+        /* Head of an intrusive MPSC stack (struct outgoing_frame *), most-recently-pushed first.
+         * The channel thread exchanges it for NULL and reverses the chain into send order. */
+        struct aws_atomic_var head;
+
+        /* bool: whether move_synced_data_to_thread_task is scheduled to drain the queue */
+        struct aws_atomic_var is_drain_task_scheduled;
+
+        /* int: AWS_ERROR_SUCCESS while sending is allowed; once writing stops, the error-code
+         * returned by aws_websocket_send_frame() */
+        struct aws_atomic_var send_error_code;
+
+        /* bool: mirrors thread_data.is_midchannel_handler */
+        struct aws_atomic_var is_midchannel_handler;
+    } send_queue;
+
     /* Data that may be touched from any thread (lock must be held). */
     struct {
         struct aws_mutex lock;
 
-        struct aws_linked_list outgoing_frame_list;
-
         /* If non-zero, then increment_read_window_task is scheduled */
         size_t window_increment_size;
 
-        /* Error-code returned by aws_websocket_send_frame() when is_writing_stopped is true */
-        int send_frame_error_code;
-
         /* Use a task to issue a channel shutdown. */
         int shutdown_channel_task_error_code;
         bool is_shutdown_channel_task_scheduled;
 
-        bool is_move_synced_data_to_thread_task_scheduled;
-
-        /* Mirrors variable from thread_data */
-        bool is_midchannel_handler;
-
         /* Whether aws_websocket_release() has been called */
         bool is_released;
     } synced_data;
@@ -288,6 +304,9 @@ struct aws_websocket *aws_websocket_handler_new(const struct aws_websocket_handl
 
     websocket->is_server = options->is_server;
 
+    websocket->permessage_deflate_negotiated = options->permessage_deflate_negotiated;
+    websocket->permessage_deflate = options->permessage_deflate;
+
     aws_channel_task_init(
         &websocket->move_synced_data_to_thread_task,
         s_move_synced_data_to_thread_task,
@@ -311,8 +330,12 @@ struct aws_websocket *aws_websocket_handler_new(const struct aws_websocket_handl
     aws_websocket_encoder_init(&websocket->thread_data.encoder, s_encoder_stream_outgoing_payload, websocket);
 
     aws_websocket_decoder_init(&websocket->thread_data.decoder, s_decoder_on_frame, s_decoder_on_payload, websocket);
+    websocket->thread_data.decoder.validate_utf8 = !options->skip_utf8_validation;
 
-    aws_linked_list_init(&websocket->synced_data.outgoing_frame_list);
+    aws_atomic_init_ptr(&websocket->send_queue.head, NULL);
+    aws_atomic_init_int(&websocket->send_queue.is_drain_task_scheduled, 0);
+    aws_atomic_init_int(&websocket->send_queue.send_error_code, AWS_ERROR_SUCCESS);
+    aws_atomic_init_int(&websocket->send_queue.is_midchannel_handler, 0);
 
     err = aws_mutex_init(&websocket->synced_data.lock);
     if (err) {
@@ -392,6 +415,21 @@ struct aws_channel *aws_websocket_get_channel(const struct aws_websocket *websoc
     return websocket->channel_slot->channel;
 }
 
+bool aws_websocket_get_negotiated_permessage_deflate(
+    const struct aws_websocket *websocket,
+    struct aws_websocket_permessage_deflate_options *out_options) {
+
+    if (out_options) {
+        if (websocket->permessage_deflate_negotiated) {
+            *out_options = websocket->permessage_deflate;
+        } else {
+            AWS_ZERO_STRUCT(*out_options);
+        }
+    }
+
+    return websocket->permessage_deflate_negotiated;
+}
+
 int aws_websocket_convert_to_midchannel_handler(struct aws_websocket *websocket) {
     if (!aws_channel_thread_is_callers_thread(websocket->channel_slot->channel)) {
         AWS_LOGF_ERROR(
@@ -428,7 +466,7 @@ int aws_websocket_convert_to_midchannel_handler(struct aws_websocket *websocket)
     if (websocket->synced_data.is_released) {
         was_released = true;
     } else {
-        websocket->synced_data.is_midchannel_handler = true;
+        aws_atomic_store_int(&websocket->send_queue.is_midchannel_handler, 1);
     }
     s_unlock_synced_data(websocket);
     /* END CRITICAL SECTION */
@@ -492,26 +530,12 @@ static int s_send_frame(
 
     /* Enqueue frame, unless no further sending is allowed. */
     int send_error = 0;
-    bool should_schedule_task = false;
-
-    /* BEGIN CRITICAL SECTION */
-    s_lock_synced_data(websocket);
-
-    if (websocket->synced_data.is_midchannel_handler && from_public_api) {
+    if (from_public_api && aws_atomic_load_int(&websocket->send_queue.is_midchannel_handler)) {
         send_error = AWS_ERROR_HTTP_WEBSOCKET_IS_MIDCHANNEL_HANDLER;
-    } else if (websocket->synced_data.send_frame_error_code) {
-        send_error = websocket->synced_data.send_frame_error_code;
     } else {
-        aws_linked_list_push_back(&websocket->synced_data.outgoing_frame_list, &frame->node);
-        if (!websocket->synced_data.is_move_synced_data_to_thread_task_scheduled) {
-            websocket->synced_data.is_move_synced_data_to_thread_task_scheduled = true;
-            should_schedule_task = true;
-        }
+        send_error = (int)aws_atomic_load_int(&websocket->send_queue.send_error_code);
     }
 
-    s_unlock_synced_data(websocket);
-    /* END CRITICAL SECTION */
-
     if (send_error) {
         AWS_LOGF_ERROR(
             AWS_LS_HTTP_WEBSOCKET,
@@ -524,6 +548,14 @@ static int s_send_frame(
         return aws_raise_error(send_error);
     }
 
+    /* Lock-free push onto the send queue. If writing stopped between the check above and
+     * this push, the drain task still runs (even canceled during channel shutdown) and
+     * completes the frame with an error. */
+    void *expected_head = aws_atomic_load_ptr(&websocket->send_queue.head);
+    do {
+        frame->send_queue_next = expected_head;
+    } while (!aws_atomic_compare_exchange_ptr(&websocket->send_queue.head, &expected_head, frame));
+
     AWS_LOGF_DEBUG(
         AWS_LS_HTTP_WEBSOCKET,
         "id=%p: Enqueuing outgoing frame with opcode=%" PRIu8 "(%s) length=%" PRIu64 " fin=%s priority=%s",
@@ -534,7 +566,7 @@ static int s_send_frame(
         options->fin ? "T" : "F",
         options->high_priority ? "high" : "normal");
 
-    if (should_schedule_task) {
+    if (aws_atomic_exchange_int(&websocket->send_queue.is_drain_task_scheduled, 1) == 0) {
         AWS_LOGF_TRACE(AWS_LS_HTTP_WEBSOCKET, "id=%p: Scheduling synced data task.", (void *)websocket);
         aws_channel_schedule_task_now(websocket->channel_slot->channel, &websocket->move_synced_data_to_thread_task);
     }
@@ -546,33 +578,57 @@ int aws_websocket_send_frame(struct aws_websocket *websocket, const struct aws_w
     return s_send_frame(websocket, options, true);
 }
 
-static void s_move_synced_data_to_thread_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
-    (void)task;
-    if (status != AWS_TASK_STATUS_RUN_READY) {
-        return;
+/* Take the whole chain off the send queue, newest-first. May be called from any thread. */
+static struct outgoing_frame *s_take_send_queue_chain(struct aws_websocket *websocket) {
+    return aws_atomic_exchange_ptr(&websocket->send_queue.head, NULL);
+}
+
+/* Move any frames other threads have pushed onto the send queue into the thread's
+ * prioritized list. Returns true if any frames were moved. */
+static bool s_move_synced_frames_to_thread_list(struct aws_websocket *websocket) {
+    struct outgoing_frame *frame = s_take_send_queue_chain(websocket);
+    if (!frame) {
+        return false;
     }
 
-    struct aws_websocket *websocket = arg;
-    struct aws_linked_list tmp_list;
-    aws_linked_list_init(&tmp_list);
+    /* The chain is newest-first; reverse it back into submission order */
+    struct outgoing_frame *reversed = NULL;
+    while (frame) {
+        struct outgoing_frame *next = frame->send_queue_next;
+        frame->send_queue_next = reversed;
+        reversed = frame;
+        frame = next;
+    }
 
-    /* BEGIN CRITICAL SECTION */
-    s_lock_synced_data(websocket);
+    while (reversed) {
+        struct outgoing_frame *next = reversed->send_queue_next;
+        s_enqueue_prioritized_frame(&websocket->thread_data.outgoing_frame_list, reversed);
+        reversed = next;
+    }
 
-    aws_linked_list_swap_contents(&websocket->synced_data.outgoing_frame_list, &tmp_list);
+    return true;
+}
 
-    websocket->synced_data.is_move_synced_data_to_thread_task_scheduled = false;
+static void s_move_synced_data_to_thread_task(struct aws_channel_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    struct aws_websocket *websocket = arg;
 
-    s_unlock_synced_data(websocket);
-    /* END CRITICAL SECTION */
+    /* Clear the flag before draining, so a producer that pushes mid-drain reschedules us */
+    aws_atomic_store_int(&websocket->send_queue.is_drain_task_scheduled, 0);
 
-    if (!aws_linked_list_empty(&tmp_list)) {
-        do {
-            struct aws_linked_list_node *node = aws_linked_list_pop_front(&tmp_list);
-            struct outgoing_frame *frame = AWS_CONTAINER_OF(node, struct outgoing_frame, node);
-            s_enqueue_prioritized_frame(&websocket->thread_data.outgoing_frame_list, frame);
-        } while (!aws_linked_list_empty(&tmp_list));
+    if (status != AWS_TASK_STATUS_RUN_READY) {
+        /* Channel is shutting down. Nothing can be sent anymore, but frames that raced into the
+         * queue after the handler's own shutdown drain must still be completed and freed. */
+        struct outgoing_frame *frame = s_take_send_queue_chain(websocket);
+        while (frame) {
+            struct outgoing_frame *next = frame->send_queue_next;
+            s_destroy_outgoing_frame(websocket, frame, AWS_ERROR_HTTP_CONNECTION_CLOSED);
+            frame = next;
+        }
+        return;
+    }
 
+    if (s_move_synced_frames_to_thread_list(websocket)) {
         s_try_write_outgoing_frames(websocket);
     }
 }
@@ -649,8 +705,13 @@ static void s_try_write_outgoing_frames(struct aws_websocket *websocket) {
         } else {
             /* We're not in the middle of encoding a frame, so pop off the next one to encode. */
             if (aws_linked_list_empty(&websocket->thread_data.outgoing_frame_list)) {
-                AWS_LOGF_TRACE(AWS_LS_HTTP_WEBSOCKET, "id=%p: No more frames to write.", (void *)websocket);
-                break;
+                /* Before flushing a partly-full message, grab any frames that were enqueued while
+                 * we were encoding (ex: from a payload callback, or another thread mid-burst).
+                 * Small frames batched here skip a whole task wake-up and socket write apiece. */
+                if (!s_move_synced_frames_to_thread_list(websocket)) {
+                    AWS_LOGF_TRACE(AWS_LS_HTTP_WEBSOCKET, "id=%p: No more frames to write.", (void *)websocket);
+                    break;
+                }
             }
 
             struct aws_linked_list_node *node = aws_linked_list_pop_front(&websocket->thread_data.outgoing_frame_list);
@@ -956,13 +1017,7 @@ static void s_stop_writing(struct aws_websocket *websocket, int send_frame_error
         send_frame_error_code,
         aws_error_name(send_frame_error_code));
 
-    /* BEGIN CRITICAL SECTION */
-    s_lock_synced_data(websocket);
-
-    websocket->synced_data.send_frame_error_code = send_frame_error_code;
-
-    s_unlock_synced_data(websocket);
-    /* END CRITICAL SECTION */
+    aws_atomic_store_int(&websocket->send_queue.send_error_code, send_frame_error_code);
 
     websocket->thread_data.is_writing_stopped = true;
 }
@@ -1061,15 +1116,7 @@ static void s_schedule_channel_shutdown(struct aws_websocket *websocket, int err
 }
 
 void aws_websocket_close(struct aws_websocket *websocket, bool free_scarce_resources_immediately) {
-    bool is_midchannel_handler;
-
-    /* BEGIN CRITICAL SECTION */
-    s_lock_synced_data(websocket);
-    is_midchannel_handler = websocket->synced_data.is_midchannel_handler;
-    s_unlock_synced_data(websocket);
-    /* END CRITICAL SECTION */
-
-    if (is_midchannel_handler) {
+    if (aws_atomic_load_int(&websocket->send_queue.is_midchannel_handler)) {
         AWS_LOGF_ERROR(
             AWS_LS_HTTP_WEBSOCKET,
             "id=%p: Ignoring close call, websocket has converted to midchannel handler.",
@@ -1175,17 +1222,9 @@ static void s_finish_shutdown(struct aws_websocket *websocket) {
         websocket->thread_data.current_outgoing_frame = NULL;
     }
 
-    /* BEGIN CRITICAL SECTION */
-    s_lock_synced_data(websocket);
-
-    while (!aws_linked_list_empty(&websocket->synced_data.outgoing_frame_list)) {
-        /* Move frames from synced_data to thread_data, then cancel them together outside critical section */
-        struct aws_linked_list_node *node = aws_linked_list_pop_front(&websocket->synced_data.outgoing_frame_list);
-        aws_linked_list_push_back(&websocket->thread_data.outgoing_frame_list, node);
-    }
-
-    s_unlock_synced_data(websocket);
-    /* END CRITICAL SECTION */
+    /* Grab anything still sitting in the cross-thread send queue, so it's canceled below too.
+     * (Frames that race in after this are handled by the drain task, which runs even canceled.) */
+    s_move_synced_frames_to_thread_list(websocket);
 
     while (!aws_linked_list_empty(&websocket->thread_data.outgoing_frame_list)) {
         struct aws_linked_list_node *node = aws_linked_list_pop_front(&websocket->thread_data.outgoing_frame_list);
@@ -1588,7 +1627,7 @@ void aws_websocket_increment_read_window(struct aws_websocket *websocket, size_t
     /* BEGIN CRITICAL SECTION */
     s_lock_synced_data(websocket);
 
-    if (websocket->synced_data.is_midchannel_handler) {
+    if (aws_atomic_load_int(&websocket->send_queue.is_midchannel_handler)) {
         is_midchannel_handler = true;
     } else if (websocket->synced_data.window_increment_size == 0) {
         should_schedule_task = true;
@@ -16,8 +16,10 @@
 #include <aws/http/private/websocket_impl.h>
 
 #include <aws/common/logging.h>
+#include <aws/common/mutex.h>
 #include <aws/http/connection.h>
 #include <aws/http/private/http_impl.h>
+#include <aws/http/private/strutil.h>
 #include <aws/http/request_response.h>
 #include <aws/io/uri.h>
 
@@ -61,6 +63,7 @@ struct aws_websocket_client_bootstrap {
     struct aws_allocator *alloc;
     size_t initial_window_size;
     bool manual_window_update;
+    bool skip_utf8_validation;
     void *user_data;
     /* Setup callback will be set NULL once it's invoked.
      * This is used to determine whether setup or shutdown should be invoked
@@ -74,6 +77,14 @@ struct aws_websocket_client_bootstrap {
     /* Handshake request data */
     struct aws_http_message *handshake_request;
 
+    /* Extension negotiation (RFC-7692 permessage-deflate).
+     * The offer is fixed at connect time, the negotiated result is filled in
+     * while validating the handshake response. */
+    bool deflate_offered;
+    bool deflate_negotiated;
+    struct aws_websocket_permessage_deflate_options deflate_offer;
+    struct aws_websocket_permessage_deflate_options deflate_negotiated_params;
+
     /* Handshake response data */
     int response_status;
     struct aws_array_list response_headers;
@@ -101,6 +112,68 @@ static int s_ws_bootstrap_on_handshake_response_headers(
     void *user_data);
 static void s_ws_bootstrap_on_handshake_complete(struct aws_http_stream *stream, int error_code, void *user_data);
 
+/* max_window_bits parameters must be a base-2 logarithm in the range 8-15 (RFC-7692 Section 7.1.2).
+ * We additionally allow 0, meaning "parameter not used". */
+static bool s_window_bits_valid(uint8_t window_bits) {
+    return window_bits == 0 || (window_bits >= 8 && window_bits <= 15);
+}
+
+static bool s_write_window_bits(struct aws_byte_buf *buf, uint8_t window_bits) {
+    AWS_ASSERT(window_bits >= 8 && window_bits <= 15);
+
+    if (window_bits < 10) {
+        return aws_byte_buf_write_u8(buf, (uint8_t)('0' + window_bits));
+    }
+
+    return aws_byte_buf_write_u8(buf, '1') && aws_byte_buf_write_u8(buf, (uint8_t)('0' + window_bits - 10));
+}
+
+/* Add a Sec-WebSocket-Extensions header to the handshake request,
+ * offering permessage-deflate with the configured parameters. RFC-7692 Section 7.1 */
+static int s_ws_bootstrap_offer_permessage_deflate(struct aws_websocket_client_bootstrap *ws_bootstrap) {
+    const struct aws_websocket_permessage_deflate_options *offer = &ws_bootstrap->deflate_offer;
+
+    /* Largest possible offer, with every parameter present, is well under 128 bytes */
+    uint8_t value_storage[128];
+    struct aws_byte_buf value_buf = aws_byte_buf_from_empty_array(value_storage, sizeof(value_storage));
+
+    bool wrote_all =
+        aws_byte_buf_write_from_whole_cursor(&value_buf, aws_byte_cursor_from_c_str("permessage-deflate"));
+
+    if (offer->server_no_context_takeover) {
+        wrote_all &= aws_byte_buf_write_from_whole_cursor(
+            &value_buf, aws_byte_cursor_from_c_str("; server_no_context_takeover"));
+    }
+
+    if (offer->client_no_context_takeover) {
+        wrote_all &= aws_byte_buf_write_from_whole_cursor(
+            &value_buf, aws_byte_cursor_from_c_str("; client_no_context_takeover"));
+    }
+
+    if (offer->server_max_window_bits) {
+        wrote_all &=
+            aws_byte_buf_write_from_whole_cursor(&value_buf, aws_byte_cursor_from_c_str("; server_max_window_bits="));
+        wrote_all &= s_write_window_bits(&value_buf, offer->server_max_window_bits);
+    }
+
+    if (offer->client_max_window_bits) {
+        wrote_all &=
+            aws_byte_buf_write_from_whole_cursor(&value_buf, aws_byte_cursor_from_c_str("; client_max_window_bits="));
+        wrote_all &= s_write_window_bits(&value_buf, offer->client_max_window_bits);
+    }
+
+    if (!wrote_all) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    struct aws_http_header offer_header = {
+        .name = aws_byte_cursor_from_c_str("Sec-WebSocket-Extensions"),
+        .value = aws_byte_cursor_from_buf(&value_buf),
+    };
+
+    return aws_http_message_add_header(ws_bootstrap->handshake_request, offer_header);
+}
+
 int aws_websocket_client_connect(const struct aws_websocket_client_connection_options *options) {
     aws_http_fatal_assert_library_initialized();
     AWS_ASSERT(options);
@@ -144,6 +217,16 @@ int aws_websocket_client_connect(const struct aws_websocket_client_connection_op
         return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
     }
 
+    if (options->permessage_deflate &&
+        (!s_window_bits_valid(options->permessage_deflate->server_max_window_bits) ||
+         !s_window_bits_valid(options->permessage_deflate->client_max_window_bits))) {
+
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_WEBSOCKET_SETUP,
+            "id=static: Invalid websocket connection options, permessage-deflate max_window_bits must be 0 or 8-15.");
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
     /* Create bootstrap */
     struct aws_websocket_client_bootstrap *ws_bootstrap =
         aws_mem_calloc(options->allocator, 1, sizeof(struct aws_websocket_client_bootstrap));
@@ -154,6 +237,7 @@ int aws_websocket_client_connect(const struct aws_websocket_client_connection_op
     ws_bootstrap->alloc = options->allocator;
     ws_bootstrap->initial_window_size = options->initial_window_size;
     ws_bootstrap->manual_window_update = options->manual_window_management;
+    ws_bootstrap->skip_utf8_validation = options->skip_utf8_validation;
     ws_bootstrap->user_data = options->user_data;
     ws_bootstrap->websocket_setup_callback = options->on_connection_setup;
     ws_bootstrap->websocket_shutdown_callback = options->on_connection_shutdown;
@@ -163,6 +247,15 @@ int aws_websocket_client_connect(const struct aws_websocket_client_connection_op
     ws_bootstrap->handshake_request = options->handshake_request;
     ws_bootstrap->response_status = AWS_HTTP_STATUS_UNKNOWN;
 
+    if (options->permessage_deflate) {
+        ws_bootstrap->deflate_offered = true;
+        ws_bootstrap->deflate_offer = *options->permessage_deflate;
+
+        if (s_ws_bootstrap_offer_permessage_deflate(ws_bootstrap)) {
+            goto error;
+        }
+    }
+
     /* Pre-allocate space for response headers */
     /* Values are just guesses */
     size_t estimated_response_headers = aws_http_message_get_header_count(ws_bootstrap->handshake_request) + 10;
@@ -444,6 +537,161 @@ error:
     return AWS_OP_ERR;
 }
 
+/* Process one extension entry from the response's Sec-WebSocket-Extensions header.
+ * The server may only accept permessage-deflate, only if it was offered, only once,
+ * and only with parameters compatible with the offer. RFC-7692 Sections 7.1.1 & 7.1.2 */
+static int s_ws_bootstrap_accept_permessage_deflate(
+    struct aws_websocket_client_bootstrap *ws_bootstrap,
+    struct aws_byte_cursor extension) {
+
+    /* First ';'-delimited piece is the extension name, the rest are its parameters */
+    struct aws_byte_cursor split;
+    AWS_ZERO_STRUCT(split);
+    aws_byte_cursor_next_split(&extension, ';', &split);
+    struct aws_byte_cursor extension_name = aws_strutil_trim_http_whitespace(split);
+
+    if (!aws_byte_cursor_eq_c_str_ignore_case(&extension_name, "permessage-deflate")) {
+        goto reject;
+    }
+
+    if (!ws_bootstrap->deflate_offered || ws_bootstrap->deflate_negotiated) {
+        goto reject;
+    }
+
+    /* Start from the offer, then apply the server's parameters.
+     * The server must explicitly agree to the constraints we placed on it. */
+    struct aws_websocket_permessage_deflate_options *negotiated = &ws_bootstrap->deflate_negotiated_params;
+    *negotiated = ws_bootstrap->deflate_offer;
+    bool server_no_context_takeover_acked = false;
+    bool server_max_window_bits_acked = false;
+
+    while (aws_byte_cursor_next_split(&extension, ';', &split)) {
+        struct aws_byte_cursor param = aws_strutil_trim_http_whitespace(split);
+        if (param.len == 0) {
+            continue;
+        }
+
+        /* Split "name=value" parameters. A parameter without '=' has an empty value. */
+        struct aws_byte_cursor param_name = param;
+        struct aws_byte_cursor param_value;
+        AWS_ZERO_STRUCT(param_value);
+        for (size_t i = 0; i < param.len; ++i) {
+            if (param.ptr[i] == '=') {
+                param_name.len = i;
+                param_value.ptr = param.ptr + (i + 1);
+                param_value.len = param.len - (i + 1);
+                param_name = aws_strutil_trim_http_whitespace(param_name);
+                param_value = aws_strutil_trim_http_whitespace(param_value);
+                break;
+            }
+        }
+
+        uint64_t window_bits;
+        if (aws_byte_cursor_eq_c_str_ignore_case(&param_name, "server_no_context_takeover")) {
+            if (param_value.len != 0) {
+                goto reject;
+            }
+            negotiated->server_no_context_takeover = true;
+            server_no_context_takeover_acked = true;
+
+        } else if (aws_byte_cursor_eq_c_str_ignore_case(&param_name, "client_no_context_takeover")) {
+            if (param_value.len != 0) {
+                goto reject;
+            }
+            /* The server may demand this even if we didn't offer it */
+            negotiated->client_no_context_takeover = true;
+
+        } else if (aws_byte_cursor_eq_c_str_ignore_case(&param_name, "server_max_window_bits")) {
+            if (aws_strutil_read_unsigned_num(param_value, &window_bits) || window_bits < 8 || window_bits > 15) {
+                goto reject;
+            }
+            /* A server agreeing to limit its window may pick a lower value than we demanded, never a higher one */
+            if (ws_bootstrap->deflate_offer.server_max_window_bits &&
+                window_bits > ws_bootstrap->deflate_offer.server_max_window_bits) {
+                goto reject;
+            }
+            negotiated->server_max_window_bits = (uint8_t)window_bits;
+            server_max_window_bits_acked = true;
+
+        } else if (aws_byte_cursor_eq_c_str_ignore_case(&param_name, "client_max_window_bits")) {
+            /* The server may only use this parameter if we offered it, and may only lower it */
+            if (!ws_bootstrap->deflate_offer.client_max_window_bits) {
+                goto reject;
+            }
+            if (aws_strutil_read_unsigned_num(param_value, &window_bits) || window_bits < 8 ||
+                window_bits > ws_bootstrap->deflate_offer.client_max_window_bits) {
+                goto reject;
+            }
+            negotiated->client_max_window_bits = (uint8_t)window_bits;
+
+        } else {
+            /* Unknown parameter */
+            goto reject;
+        }
+    }
+
+    /* Constraints that bound the server's memory use are not optional.
+     * If the server didn't acknowledge them, we can't trust it to honor them. */
+    if (ws_bootstrap->deflate_offer.server_no_context_takeover && !server_no_context_takeover_acked) {
+        goto reject;
+    }
+    if (ws_bootstrap->deflate_offer.server_max_window_bits && !server_max_window_bits_acked) {
+        goto reject;
+    }
+
+    ws_bootstrap->deflate_negotiated = true;
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_HTTP_WEBSOCKET_SETUP,
+        "id=%p: Negotiated permessage-deflate: server_no_context_takeover=%d client_no_context_takeover=%d"
+        " server_max_window_bits=%" PRIu8 " client_max_window_bits=%" PRIu8,
+        (void *)ws_bootstrap,
+        negotiated->server_no_context_takeover,
+        negotiated->client_no_context_takeover,
+        negotiated->server_max_window_bits,
+        negotiated->client_max_window_bits);
+
+    return AWS_OP_SUCCESS;
+
+reject:
+    AWS_LOGF_ERROR(
+        AWS_LS_HTTP_WEBSOCKET_SETUP,
+        "id=%p: Rejecting Sec-WebSocket-Extensions response entry '" PRInSTR "'.",
+        (void *)ws_bootstrap,
+        AWS_BYTE_CURSOR_PRI(extension));
+
+    return aws_raise_error(AWS_ERROR_HTTP_WEBSOCKET_UPGRADE_FAILURE);
+}
+
+/* Validate any Sec-WebSocket-Extensions headers in the handshake response. */
+static int s_ws_bootstrap_validate_response_extensions(struct aws_websocket_client_bootstrap *ws_bootstrap) {
+    const size_t num_headers = aws_array_list_length(&ws_bootstrap->response_headers);
+    for (size_t i = 0; i < num_headers; ++i) {
+        struct aws_http_header *header;
+        aws_array_list_get_at_ptr(&ws_bootstrap->response_headers, (void **)&header, i);
+
+        if (!aws_byte_cursor_eq_c_str_ignore_case(&header->name, "sec-websocket-extensions")) {
+            continue;
+        }
+
+        /* Multiple accepted extensions may be listed in one header, separated by commas */
+        struct aws_byte_cursor entry;
+        AWS_ZERO_STRUCT(entry);
+        while (aws_byte_cursor_next_split(&header->value, ',', &entry)) {
+            struct aws_byte_cursor trimmed_entry = aws_strutil_trim_http_whitespace(entry);
+            if (trimmed_entry.len == 0) {
+                continue;
+            }
+
+            if (s_ws_bootstrap_accept_permessage_deflate(ws_bootstrap, trimmed_entry)) {
+                return AWS_OP_ERR;
+            }
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
 static void s_ws_bootstrap_on_handshake_complete(struct aws_http_stream *stream, int error_code, void *user_data) {
     struct aws_websocket_client_bootstrap *ws_bootstrap = user_data;
     struct aws_http_connection *http_connection = s_system_vtable->aws_http_stream_get_connection(stream);
@@ -470,6 +718,10 @@ static void s_ws_bootstrap_on_handshake_complete(struct aws_http_stream *stream,
 
     /* TODO: validate Sec-WebSocket-Accept header */
 
+    if (s_ws_bootstrap_validate_response_extensions(ws_bootstrap)) {
+        goto error;
+    }
+
     /* Insert websocket handler into channel */
     struct aws_channel *channel = s_system_vtable->aws_http_connection_get_channel(http_connection);
     AWS_ASSERT(channel);
@@ -484,6 +736,9 @@ static void s_ws_bootstrap_on_handshake_complete(struct aws_http_stream *stream,
         .on_incoming_frame_complete = ws_bootstrap->websocket_frame_complete_callback,
         .is_server = false,
         .manual_window_update = ws_bootstrap->manual_window_update,
+        .skip_utf8_validation = ws_bootstrap->skip_utf8_validation,
+        .permessage_deflate_negotiated = ws_bootstrap->deflate_negotiated,
+        .permessage_deflate = ws_bootstrap->deflate_negotiated_params,
     };
 
     ws_bootstrap->websocket = s_system_vtable->aws_websocket_handler_new(&ws_options);
@@ -532,3 +787,435 @@ error:
     s_ws_bootstrap_cancel_setup_due_to_err(ws_bootstrap, http_connection, error_code);
     s_system_vtable->aws_http_stream_release(stream);
 }
+
+/* Default for aws_websocket_bulk_client_connection_options.concurrency_window.
+ * Wide enough to keep a multi-loop event loop group busy, narrow enough
+ * not to flood one endpoint with simultaneous TLS handshakes. */
+static const size_t s_default_bulk_concurrency_window = 32;
+
+/**
+ * A bulk connect drives target_count individual websocket connects through the normal
+ * bootstrap above, keeping at most concurrency_window of them in flight. Each connect
+ * sends a copy-on-write snapshot of the shared handshake template with a fresh
+ * Sec-WebSocket-Key patched in, rather than a request built from scratch.
+ * The job collects every connection's setup result and fires the batched callback once,
+ * from whichever thread records the final result (including the caller's thread, if
+ * every connect fails synchronously).
+ */
+struct aws_websocket_bulk_connect_job {
+    struct aws_allocator *alloc;
+    struct aws_client_bootstrap *bootstrap;
+    struct aws_socket_options *socket_options;
+    struct aws_tls_connection_options *tls_options;
+    struct aws_http_proxy_options *proxy_options;
+    struct aws_byte_buf host_storage;
+    uint16_t port;
+    struct aws_http_message *handshake_template;
+    bool has_permessage_deflate;
+    struct aws_websocket_permessage_deflate_options permessage_deflate;
+    size_t initial_window_size;
+    bool manual_window_update;
+    bool skip_utf8_validation;
+    void *user_data;
+    aws_websocket_on_bulk_connection_setup_fn *bulk_setup_callback;
+    aws_websocket_on_connection_shutdown_fn *websocket_shutdown_callback;
+    aws_websocket_on_incoming_frame_begin_fn *websocket_frame_begin_callback;
+    aws_websocket_on_incoming_frame_payload_fn *websocket_frame_payload_callback;
+    aws_websocket_on_incoming_frame_complete_fn *websocket_frame_complete_callback;
+
+    size_t target_count;
+
+    /* One entry per connection, filled in as setups complete. */
+    struct aws_websocket_bulk_connect_result *results;
+
+    /* Individual connects complete on any thread in the event loop group. */
+    struct {
+        struct aws_mutex lock;
+        /* Index of the next connection to launch. Launched-minus-completed never exceeds the window. */
+        size_t next_index;
+        size_t num_completed;
+    } synced_data;
+};
+
+/**
+ * Per-connection state for a bulk connect.
+ * The shutdown callback for a successful connection can fire long after the job itself
+ * is gone, so the slot carries its own copy of everything the shutdown shim needs.
+ */
+struct aws_websocket_bulk_connect_slot {
+    struct aws_allocator *alloc;
+    struct aws_websocket_bulk_connect_job *job;
+    size_t index;
+    struct aws_http_message *handshake_request;
+    aws_websocket_on_connection_shutdown_fn *websocket_shutdown_callback;
+    void *user_data;
+};
+
+static void s_ws_bulk_job_destroy(struct aws_websocket_bulk_connect_job *job) {
+    aws_mutex_clean_up(&job->synced_data.lock);
+    aws_byte_buf_clean_up(&job->host_storage);
+    if (job->results) {
+        aws_mem_release(job->alloc, job->results);
+    }
+    aws_mem_release(job->alloc, job);
+}
+
+/* Build one connection's handshake request: an O(1) snapshot of the shared template,
+ * with a fresh random Sec-WebSocket-Key (RFC-6455 Section 4.1) patched in.
+ * Setting the key takes the snapshot's one-time private header copy via the bulk
+ * add path; nothing is re-validated or re-built per connection. */
+static struct aws_http_message *s_ws_bulk_new_handshake_request(const struct aws_websocket_bulk_connect_job *job) {
+    struct aws_http_message *request = aws_http_message_snapshot(job->handshake_template);
+    if (!request) {
+        return NULL;
+    }
+
+    uint8_t key_storage[AWS_WEBSOCKET_MAX_HANDSHAKE_KEY_LENGTH];
+    struct aws_byte_buf key_buf = aws_byte_buf_from_empty_array(key_storage, sizeof(key_storage));
+    if (aws_websocket_random_handshake_key(&key_buf)) {
+        goto error;
+    }
+
+    struct aws_http_headers *headers = aws_http_message_get_headers(request);
+    if (!headers) {
+        goto error;
+    }
+
+    if (aws_http_headers_set(
+            headers, aws_byte_cursor_from_c_str("Sec-WebSocket-Key"), aws_byte_cursor_from_buf(&key_buf))) {
+        goto error;
+    }
+
+    return request;
+
+error:
+    aws_http_message_destroy(request);
+    return NULL;
+}
+
+/**
+ * Record one connection's setup result.
+ * If it was the batch's last outstanding connection, fire the batched callback and
+ * destroy the job (in which case the job must not be touched again, and false is returned).
+ * Otherwise, if unlaunched connections remain, claim the next one's index into
+ * `out_next_index` and return true; the caller must then launch it.
+ * Claiming inside the same critical section that records the completion is what keeps
+ * the job alive for the caller: an unclaimed index can never complete, so the batch
+ * cannot finish behind our back.
+ */
+static bool s_ws_bulk_job_complete_connection(
+    struct aws_websocket_bulk_connect_job *job,
+    size_t index,
+    struct aws_websocket *websocket,
+    int error_code,
+    int handshake_response_status,
+    size_t *out_next_index) {
+
+    struct aws_websocket_bulk_connect_result *result = &job->results[index];
+    bool all_complete;
+    bool claimed_next = false;
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&job->synced_data.lock);
+
+    result->websocket = websocket;
+    result->error_code = error_code;
+    result->handshake_response_status = handshake_response_status;
+
+    job->synced_data.num_completed++;
+    all_complete = job->synced_data.num_completed == job->target_count;
+
+    if (!all_complete && job->synced_data.next_index < job->target_count) {
+        *out_next_index = job->synced_data.next_index++;
+        claimed_next = true;
+    }
+
+    aws_mutex_unlock(&job->synced_data.lock);
+    /* END CRITICAL SECTION */
+
+    AWS_LOGF_TRACE(
+        AWS_LS_HTTP_WEBSOCKET_SETUP,
+        "id=%p: Bulk connection %zu/%zu complete with error %d (%s).",
+        (void *)job,
+        index + 1,
+        job->target_count,
+        error_code,
+        aws_error_name(error_code));
+
+    if (all_complete) {
+        AWS_LOGF_DEBUG(
+            AWS_LS_HTTP_WEBSOCKET_SETUP,
+            "id=%p: Bulk websocket connect complete, all %zu connections have finished setup.",
+            (void *)job,
+            job->target_count);
+
+        job->bulk_setup_callback(job->results, job->target_count, job->user_data);
+        s_ws_bulk_job_destroy(job);
+    }
+
+    return claimed_next;
+}
+
+/* Shutdown shim for one bulk connection. The job may be long gone by now,
+ * so everything comes from the slot. */
+static void s_ws_bulk_slot_on_shutdown(struct aws_websocket *websocket, int error_code, void *user_data) {
+    struct aws_websocket_bulk_connect_slot *slot = user_data;
+
+    if (slot->websocket_shutdown_callback) {
+        slot->websocket_shutdown_callback(websocket, error_code, slot->user_data);
+    }
+
+    aws_mem_release(slot->alloc, slot);
+}
+
+static void s_ws_bulk_job_launch_connection(struct aws_websocket_bulk_connect_job *job, size_t index);
+
+/* Setup shim for one bulk connection: record the result and launch the next connection,
+ * if the window has room for one. */
+static void s_ws_bulk_slot_on_setup(
+    struct aws_websocket *websocket,
+    int error_code,
+    int handshake_response_status,
+    const struct aws_http_header *handshake_response_header_array,
+    size_t num_handshake_response_headers,
+    void *user_data) {
+
+    (void)handshake_response_header_array;
+    (void)num_handshake_response_headers;
+
+    struct aws_websocket_bulk_connect_slot *slot = user_data;
+    struct aws_websocket_bulk_connect_job *job = slot->job;
+    size_t index = slot->index;
+
+    /* The per-connection handshake request is done its job */
+    aws_http_message_destroy(slot->handshake_request);
+    slot->handshake_request = NULL;
+
+    if (error_code) {
+        /* A connection that failed setup never fires its shutdown callback; the slot is done */
+        aws_mem_release(slot->alloc, slot);
+    } else {
+        /* The slot lives on until shutdown; the job may not, so sever the link */
+        slot->job = NULL;
+    }
+
+    size_t next_index;
+    if (s_ws_bulk_job_complete_connection(
+            job, index, websocket, error_code, handshake_response_status, &next_index)) {
+        s_ws_bulk_job_launch_connection(job, next_index);
+    }
+}
+
+/* Begin one connection of a bulk connect. On failure, no result is recorded;
+ * the caller deals with that. */
+static int s_ws_bulk_try_launch_connection(struct aws_websocket_bulk_connect_job *job, size_t index) {
+    struct aws_websocket_bulk_connect_slot *slot =
+        aws_mem_calloc(job->alloc, 1, sizeof(struct aws_websocket_bulk_connect_slot));
+    if (!slot) {
+        return AWS_OP_ERR;
+    }
+
+    slot->alloc = job->alloc;
+    slot->job = job;
+    slot->index = index;
+    slot->websocket_shutdown_callback = job->websocket_shutdown_callback;
+    slot->user_data = job->user_data;
+
+    slot->handshake_request = s_ws_bulk_new_handshake_request(job);
+    if (!slot->handshake_request) {
+        goto error;
+    }
+
+    struct aws_websocket_client_connection_options options = {
+        .allocator = job->alloc,
+        .bootstrap = job->bootstrap,
+        .socket_options = job->socket_options,
+        .tls_options = job->tls_options,
+        .proxy_options = job->proxy_options,
+        .host = aws_byte_cursor_from_buf(&job->host_storage),
+        .port = job->port,
+        .handshake_request = slot->handshake_request,
+        .permessage_deflate = job->has_permessage_deflate ? &job->permessage_deflate : NULL,
+        .initial_window_size = job->initial_window_size,
+        .user_data = slot,
+        .on_connection_setup = s_ws_bulk_slot_on_setup,
+        .on_connection_shutdown = s_ws_bulk_slot_on_shutdown,
+        .on_incoming_frame_begin = job->websocket_frame_begin_callback,
+        .on_incoming_frame_payload = job->websocket_frame_payload_callback,
+        .on_incoming_frame_complete = job->websocket_frame_complete_callback,
+        .manual_window_management = job->manual_window_update,
+        .skip_utf8_validation = job->skip_utf8_validation,
+    };
+
+    if (aws_websocket_client_connect(&options)) {
+        goto error;
+    }
+
+    /* Success! This connection reports in via s_ws_bulk_slot_on_setup */
+    return AWS_OP_SUCCESS;
+
+error:
+    aws_http_message_destroy(slot->handshake_request);
+    aws_mem_release(slot->alloc, slot);
+    return AWS_OP_ERR;
+}
+
+/* Launch the bulk connection at `index`. A connect that fails synchronously counts as a
+ * completed connection, so on failure this records the result and moves on to the next
+ * unlaunched connection, if the window claims one. */
+static void s_ws_bulk_job_launch_connection(struct aws_websocket_bulk_connect_job *job, size_t index) {
+    bool launching = true;
+    while (launching) {
+        if (s_ws_bulk_try_launch_connection(job, index) == AWS_OP_SUCCESS) {
+            return;
+        }
+
+        int error_code = aws_last_error();
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_WEBSOCKET_SETUP,
+            "id=%p: Failed to launch bulk connection %zu, error %d (%s).",
+            (void *)job,
+            index,
+            error_code,
+            aws_error_name(error_code));
+
+        launching = s_ws_bulk_job_complete_connection(
+            job, index, NULL /*websocket*/, error_code, AWS_HTTP_STATUS_UNKNOWN, &index);
+    }
+}
+
+int aws_websocket_client_connect_bulk(const struct aws_websocket_bulk_client_connection_options *options) {
+    aws_http_fatal_assert_library_initialized();
+    AWS_ASSERT(options);
+
+    /* Validate options. Template problems are caught here, once,
+     * rather than failing every connection in the batch. */
+    if (!options->allocator || !options->bootstrap || !options->socket_options || !options->host.len ||
+        !options->handshake_template || !options->target_count || !options->on_bulk_connection_setup) {
+
+        AWS_LOGF_ERROR(AWS_LS_HTTP_WEBSOCKET_SETUP, "id=static: Missing required bulk websocket connection options.");
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct aws_byte_cursor path;
+    aws_http_message_get_request_path(options->handshake_template, &path);
+    struct aws_byte_cursor method;
+    aws_http_message_get_request_method(options->handshake_template, &method);
+    if (!path.len || aws_http_str_to_method(method) != AWS_HTTP_METHOD_GET) {
+
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_WEBSOCKET_SETUP,
+            "id=static: Websocket handshake template must have a path and method 'GET'.");
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    bool all_frame_callbacks_set = options->on_incoming_frame_begin && options->on_incoming_frame_payload &&
+                                   options->on_incoming_frame_complete;
+
+    bool no_frame_callbacks_set = !options->on_incoming_frame_begin && !options->on_incoming_frame_payload &&
+                                  !options->on_incoming_frame_complete;
+
+    if (!(all_frame_callbacks_set || no_frame_callbacks_set)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_WEBSOCKET_SETUP,
+            "id=static: Invalid bulk websocket connection options,"
+            " either all frame-handling callbacks must be set, or none must be set.");
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (options->permessage_deflate &&
+        (!s_window_bits_valid(options->permessage_deflate->server_max_window_bits) ||
+         !s_window_bits_valid(options->permessage_deflate->client_max_window_bits))) {
+
+        AWS_LOGF_ERROR(
+            AWS_LS_HTTP_WEBSOCKET_SETUP,
+            "id=static: Invalid bulk websocket connection options,"
+            " permessage-deflate max_window_bits must be 0 or 8-15.");
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    /* Create job */
+    struct aws_websocket_bulk_connect_job *job =
+        aws_mem_calloc(options->allocator, 1, sizeof(struct aws_websocket_bulk_connect_job));
+    if (!job) {
+        goto error;
+    }
+
+    job->alloc = options->allocator;
+    job->bootstrap = options->bootstrap;
+    job->socket_options = options->socket_options;
+    job->tls_options = options->tls_options;
+    job->proxy_options = options->proxy_options;
+    job->port = options->port;
+    job->handshake_template = options->handshake_template;
+    job->initial_window_size = options->initial_window_size;
+    job->manual_window_update = options->manual_window_management;
+    job->skip_utf8_validation = options->skip_utf8_validation;
+    job->user_data = options->user_data;
+    job->bulk_setup_callback = options->on_bulk_connection_setup;
+    job->websocket_shutdown_callback = options->on_connection_shutdown;
+    job->websocket_frame_begin_callback = options->on_incoming_frame_begin;
+    job->websocket_frame_payload_callback = options->on_incoming_frame_payload;
+    job->websocket_frame_complete_callback = options->on_incoming_frame_complete;
+    job->target_count = options->target_count;
+
+    if (options->permessage_deflate) {
+        job->has_permessage_deflate = true;
+        job->permessage_deflate = *options->permessage_deflate;
+    }
+
+    if (aws_mutex_init(&job->synced_data.lock)) {
+        goto error;
+    }
+
+    if (aws_byte_buf_init_copy_from_cursor(&job->host_storage, job->alloc, options->host)) {
+        goto error;
+    }
+
+    job->results = aws_mem_calloc(job->alloc, job->target_count, sizeof(struct aws_websocket_bulk_connect_result));
+    if (!job->results) {
+        goto error;
+    }
+
+    for (size_t i = 0; i < job->target_count; ++i) {
+        job->results[i].index = i;
+        job->results[i].handshake_response_status = AWS_HTTP_STATUS_UNKNOWN;
+    }
+
+    size_t concurrency_window = options->concurrency_window ? options->concurrency_window : s_default_bulk_concurrency_window;
+    if (concurrency_window > job->target_count) {
+        concurrency_window = job->target_count;
+    }
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_HTTP_WEBSOCKET_SETUP,
+        "id=%p: Bulk websocket connect begun, %zu connections to " PRInSTR " with a window of %zu.",
+        (void *)job,
+        job->target_count,
+        AWS_BYTE_CURSOR_PRI(options->host),
+        concurrency_window);
+
+    /* Launch the first windowful. Indices are claimed up front; each completion claims
+     * and launches at most one more, so launched-minus-completed never exceeds the window.
+     * The job may be destroyed mid-loop only if every connection has already completed,
+     * which cannot happen while an index claimed here is still unlaunched. */
+    job->synced_data.next_index = concurrency_window;
+
+    for (size_t i = 0; i < concurrency_window; ++i) {
+        s_ws_bulk_job_launch_connection(job, i);
+    }
+
+    return AWS_OP_SUCCESS;
+
+error:
+    AWS_LOGF_ERROR(
+        AWS_LS_HTTP_WEBSOCKET_SETUP,
+        "id=static: Failed to initiate bulk websocket connect, error %d (%s)",
+        aws_last_error(),
+        aws_error_name(aws_last_error()));
+
+    if (job) {
+        s_ws_bulk_job_destroy(job);
+    }
+    return AWS_OP_ERR;
+}
@@ -76,6 +76,13 @@ static int s_state_opcode_byte(struct aws_websocket_decoder *decoder, struct aws
 
         decoder->expecting_continuation_data_frame = !decoder->current_frame.fin;
 
+        /* A new TEXT frame begins a text message whose payload (including that of
+         * any CONTINUATION frames that follow) must be validated as UTF-8. */
+        if (decoder->validate_utf8 && AWS_WEBSOCKET_OPCODE_TEXT == decoder->current_frame.opcode) {
+            decoder->processing_text_message = true;
+            decoder->utf8_bytes_remaining = 0;
+        }
+
     } else {
         /* Control frames themselves MUST NOT be fragmented. */
         if (!decoder->current_frame.fin) {
@@ -87,6 +94,85 @@ static int s_state_opcode_byte(struct aws_websocket_decoder *decoder, struct aws
     return AWS_OP_SUCCESS;
 }
 
+/* Incrementally validate a chunk of a TEXT message as UTF-8 (RFC-3629).
+ * Rejects overlong encodings, surrogates, and codepoints above U+10FFFF.
+ * State is carried in the decoder, so a codepoint may be split across chunks (or frames). */
+static int s_validate_utf8_chunk(struct aws_websocket_decoder *decoder, struct aws_byte_cursor data) {
+    const uint8_t *current_byte = data.ptr;
+    const uint8_t *end_byte = data.ptr + data.len;
+
+    while (current_byte != end_byte) {
+        if (decoder->utf8_bytes_remaining > 0) {
+            uint8_t byte = *current_byte++;
+            if (byte < decoder->utf8_next_byte_min || byte > decoder->utf8_next_byte_max) {
+                return aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
+            }
+            decoder->utf8_next_byte_min = 0x80;
+            decoder->utf8_next_byte_max = 0xBF;
+            decoder->utf8_bytes_remaining--;
+            continue;
+        }
+
+        /* Skip runs of ASCII a word at a time (no byte with the high bit set) */
+        while ((size_t)(end_byte - current_byte) >= sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, current_byte, sizeof(word));
+            if (word & 0x8080808080808080ULL) {
+                break;
+            }
+            current_byte += sizeof(uint64_t);
+        }
+
+        if (current_byte == end_byte) {
+            break;
+        }
+
+        uint8_t byte = *current_byte++;
+        if (byte < 0x80) {
+            continue;
+        }
+
+        if (byte < 0xC2) {
+            /* Unexpected continuation byte, or overlong 2-byte lead (0xC0, 0xC1) */
+            return aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
+        }
+
+        if (byte < 0xE0) {
+            decoder->utf8_bytes_remaining = 1;
+            decoder->utf8_next_byte_min = 0x80;
+            decoder->utf8_next_byte_max = 0xBF;
+        } else if (byte < 0xF0) {
+            decoder->utf8_bytes_remaining = 2;
+            decoder->utf8_next_byte_min = (byte == 0xE0) ? 0xA0 : 0x80; /* reject overlong encodings */
+            decoder->utf8_next_byte_max = (byte == 0xED) ? 0x9F : 0xBF; /* reject surrogates */
+        } else if (byte < 0xF5) {
+            decoder->utf8_bytes_remaining = 3;
+            decoder->utf8_next_byte_min = (byte == 0xF0) ? 0x90 : 0x80; /* reject overlong encodings */
+            decoder->utf8_next_byte_max = (byte == 0xF4) ? 0x8F : 0xBF; /* reject values above U+10FFFF */
+        } else {
+            return aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Called when the last state of a frame completes.
+ * A TEXT message may not end in the middle of a codepoint. */
+static int s_check_utf8_frame_complete(struct aws_websocket_decoder *decoder) {
+    if (decoder->processing_text_message && aws_websocket_is_data_frame(decoder->current_frame.opcode) &&
+        decoder->current_frame.fin) {
+
+        if (decoder->utf8_bytes_remaining != 0) {
+            return aws_raise_error(AWS_ERROR_HTTP_PROTOCOL_ERROR);
+        }
+
+        decoder->processing_text_message = false;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
 /* STATE_LENGTH_BYTE: Decode byte containing length, determine if we need to decode extended length. */
 static int s_state_length_byte(struct aws_websocket_decoder *decoder, struct aws_byte_cursor *data) {
     if (data->len == 0) {
@@ -235,6 +321,10 @@ static int s_state_payload_check(struct aws_websocket_decoder *decoder, struct a
         decoder->state_bytes_processed = 0;
         decoder->state = AWS_WEBSOCKET_DECODER_STATE_PAYLOAD;
     } else {
+        /* An empty FIN frame can still end a text message mid-codepoint */
+        if (s_check_utf8_frame_complete(decoder)) {
+            return AWS_OP_ERR;
+        }
         decoder->state = AWS_WEBSOCKET_DECODER_STATE_DONE;
     }
 
@@ -259,15 +349,46 @@ static int s_state_payload(struct aws_websocket_decoder *decoder, struct aws_byt
     if (decoder->current_frame.masked) {
         uint64_t mask_index = decoder->state_bytes_processed;
 
-        /* Optimization idea: don't do this 1 byte at a time */
         uint8_t *current_byte = payload.ptr;
         uint8_t *end_byte = payload.ptr + payload.len;
+
+        /* XOR byte-by-byte until the position within the masking-key realigns with its start */
+        while (current_byte != end_byte && (mask_index % 4) != 0) {
+            *current_byte++ ^= decoder->current_frame.masking_key[mask_index++ % 4];
+        }
+
+        /* XOR whole words against the masking-key repeated to fill a word.
+         * memcpy of a fixed 8 bytes compiles down to a single unaligned load/store. */
+        if ((size_t)(end_byte - current_byte) >= sizeof(uint64_t)) {
+            uint8_t mask_word_bytes[sizeof(uint64_t)];
+            memcpy(mask_word_bytes, decoder->current_frame.masking_key, 4);
+            memcpy(mask_word_bytes + 4, decoder->current_frame.masking_key, 4);
+            uint64_t mask_word;
+            memcpy(&mask_word, mask_word_bytes, sizeof(mask_word));
+
+            while ((size_t)(end_byte - current_byte) >= sizeof(uint64_t)) {
+                uint64_t payload_word;
+                memcpy(&payload_word, current_byte, sizeof(payload_word));
+                payload_word ^= mask_word;
+                memcpy(current_byte, &payload_word, sizeof(payload_word));
+                current_byte += sizeof(uint64_t);
+            }
+        }
+
+        /* XOR the remaining few bytes (the word loop advanced in multiples of 4, so key alignment is unchanged) */
         while (current_byte != end_byte) {
             *current_byte++ ^= decoder->current_frame.masking_key[mask_index++ % 4];
         }
     }
 
-    /* TODO: validate utf-8 */
+    /* Validate TEXT message payloads as UTF-8 (RFC-6455 Section 8.1).
+     * Control frames may interleave a fragmented message, so only data frames are checked. */
+    if (decoder->processing_text_message && aws_websocket_is_data_frame(decoder->current_frame.opcode)) {
+        if (s_validate_utf8_chunk(decoder, payload)) {
+            return AWS_OP_ERR;
+        }
+    }
+
     /* TODO: validate payload of CLOSE frame */
 
     /* Invoke on_payload() callback to inform user of payload data */
@@ -281,6 +402,9 @@ static int s_state_payload(struct aws_websocket_decoder *decoder, struct aws_byt
 
     /* If all data consumed, proceed to next state. */
     if (decoder->state_bytes_processed == decoder->current_frame.payload_length) {
+        if (s_check_utf8_frame_complete(decoder)) {
+            return AWS_OP_ERR;
+        }
         decoder->state++;
     }
 
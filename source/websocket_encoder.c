@@ -15,8 +15,9 @@
 
 #include <aws/http/private/websocket_encoder.h>
 
+#include <aws/http/private/websocket_mask.h>
+
 /* TODO: encoder logging */
-/* TODO: implement masking function in aws-c-common */
 /* TODO: use nospec advance? */
 
 typedef int(state_fn)(struct aws_websocket_encoder *encoder, struct aws_byte_buf *out_buf);
@@ -213,14 +214,8 @@ static int s_state_payload(struct aws_websocket_encoder *encoder, struct aws_byt
      * RFC-6455 Section 5.3 Client-to-Server Masking
      * Each byte of payload is XOR against a byte of the masking-key */
     if (encoder->frame.masked) {
-        uint64_t mask_index = prev_bytes_processed;
-
-        /* Optimization idea: don't do this 1 byte at a time */
-        uint8_t *current_byte = out_buf->buffer + prev_buf.len;
-        uint8_t *end_byte = out_buf->buffer + out_buf->len;
-        while (current_byte != end_byte) {
-            *current_byte++ ^= encoder->frame.masking_key[mask_index++ % 4];
-        }
+        aws_websocket_mask_apply(
+            out_buf->buffer + prev_buf.len, bytes_written, encoder->frame.masking_key, prev_bytes_processed);
     }
 
     /* If done writing payload, proceed to next state */
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/websocket_mask.h>
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#    define AWS_WEBSOCKET_MASK_X86 1
+#    include <aws/common/cpuid.h>
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#        define AWS_WEBSOCKET_MASK_TARGET_SSE2
+#        define AWS_WEBSOCKET_MASK_TARGET_AVX2
+#    else
+#        include <x86intrin.h>
+#        define AWS_WEBSOCKET_MASK_TARGET_SSE2 __attribute__((target("sse2")))
+#        define AWS_WEBSOCKET_MASK_TARGET_AVX2 __attribute__((target("avx2")))
+#    endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#    define AWS_WEBSOCKET_MASK_NEON 1
+#    include <arm_neon.h>
+#endif
+
+typedef void(mask_fn)(uint8_t *bytes, size_t len, uint32_t key_block);
+
+/* Scalar kernel, also used for the unaligned tail of the vectorized kernels.
+ * XORs 8 bytes at a time against the repeated key pattern before falling back to single bytes. */
+static void s_mask_scalar(uint8_t *bytes, size_t len, uint32_t key_block) {
+    uint64_t key_block8 = ((uint64_t)key_block << 32) | key_block;
+
+    while (len >= 8) {
+        uint64_t chunk;
+        memcpy(&chunk, bytes, 8);
+        chunk ^= key_block8;
+        memcpy(bytes, &chunk, 8);
+        bytes += 8;
+        len -= 8;
+    }
+
+    const uint8_t *key_bytes = (const uint8_t *)&key_block;
+    for (size_t i = 0; i < len; ++i) {
+        bytes[i] ^= key_bytes[i & 0x3];
+    }
+}
+
+#if defined(AWS_WEBSOCKET_MASK_X86)
+
+AWS_WEBSOCKET_MASK_TARGET_SSE2
+static void s_mask_sse2(uint8_t *bytes, size_t len, uint32_t key_block) {
+    __m128i key_vec = _mm_set1_epi32((int)key_block);
+
+    while (len >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)bytes);
+        chunk = _mm_xor_si128(chunk, key_vec);
+        _mm_storeu_si128((__m128i *)bytes, chunk);
+        bytes += 16;
+        len -= 16;
+    }
+
+    s_mask_scalar(bytes, len, key_block);
+}
+
+AWS_WEBSOCKET_MASK_TARGET_AVX2
+static void s_mask_avx2(uint8_t *bytes, size_t len, uint32_t key_block) {
+    __m256i key_vec = _mm256_set1_epi32((int)key_block);
+
+    while (len >= 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)bytes);
+        chunk = _mm256_xor_si256(chunk, key_vec);
+        _mm256_storeu_si256((__m256i *)bytes, chunk);
+        bytes += 32;
+        len -= 32;
+    }
+
+    s_mask_scalar(bytes, len, key_block);
+}
+
+#elif defined(AWS_WEBSOCKET_MASK_NEON)
+
+static void s_mask_neon(uint8_t *bytes, size_t len, uint32_t key_block) {
+    uint32x4_t key_vec = vdupq_n_u32(key_block);
+
+    while (len >= 16) {
+        uint32x4_t chunk = vreinterpretq_u32_u8(vld1q_u8(bytes));
+        chunk = veorq_u32(chunk, key_vec);
+        vst1q_u8(bytes, vreinterpretq_u8_u32(chunk));
+        bytes += 16;
+        len -= 16;
+    }
+
+    s_mask_scalar(bytes, len, key_block);
+}
+
+#endif /* AWS_WEBSOCKET_MASK_NEON */
+
+static mask_fn *s_choose_mask_fn(void) {
+#if defined(AWS_WEBSOCKET_MASK_X86)
+    if (aws_cpu_has_feature(AWS_CPU_FEATURE_AVX2)) {
+        return s_mask_avx2;
+    }
+    /* SSE2 is part of the x86-64 baseline, and universal on 32bit CPUs from this millennium */
+    return s_mask_sse2;
+#elif defined(AWS_WEBSOCKET_MASK_NEON)
+    return s_mask_neon;
+#else
+    return s_mask_scalar;
+#endif
+}
+
+void aws_websocket_mask_apply(uint8_t *bytes, size_t len, const uint8_t masking_key[4], uint64_t phase) {
+    /* Benign race: every thread that initializes this pointer writes the same value */
+    static mask_fn *s_mask_impl;
+    if (!s_mask_impl) {
+        s_mask_impl = s_choose_mask_fn();
+    }
+
+    if (len == 0) {
+        return;
+    }
+
+    /* Rotate the key by the phase, so that the kernels can apply the same
+     * 4-byte pattern from the start of the buffer regardless of where the
+     * previous delivery of this frame's payload left off. */
+    uint8_t rotated_key[4];
+    for (size_t i = 0; i < 4; ++i) {
+        rotated_key[i] = masking_key[(phase + i) & 0x3];
+    }
+
+    /* Kernels take the key as a register-width block in memory byte-order */
+    uint32_t key_block;
+    memcpy(&key_block, rotated_key, 4);
+
+    s_mask_impl(bytes, len, key_block);
+}
@@ -252,7 +252,13 @@ int proxy_tester_create_testing_channel_connection(struct proxy_tester *tester)
     tester->testing_channel->channel_shutdown = s_testing_channel_shutdown_callback;
     tester->testing_channel->channel_shutdown_user_data = tester;
 
-    struct aws_http_connection *connection = aws_http_connection_new_http1_1_client(tester->alloc, SIZE_MAX);
+    struct aws_http_connection *connection = aws_http_connection_new_http1_1_client(
+        tester->alloc,
+        SIZE_MAX,
+        0 /*max_pipelined_requests*/,
+        0 /*window_update_threshold*/,
+        0 /*preferred_write_message_size*/,
+        false /*adaptive_window_management*/);
     ASSERT_NOT_NULL(connection);
 
     connection->user_data = tester->http_bootstrap->user_data;
@@ -46,7 +46,8 @@ enum {
 /* Options for setting up `tester` singleton */
 struct tester_options {
     struct aws_allocator *alloc;
-    bool no_connection; /* don't connect server to client */
+    bool no_connection;   /* don't connect server to client */
+    size_t num_listeners; /* 0 means default (single listener) */
 };
 
 /* Singleton used by tests in this file */
@@ -295,6 +296,7 @@ static int s_tester_init(struct tester *tester, const struct tester_options *opt
     server_options.server_user_data = tester;
     server_options.on_incoming_connection = s_tester_on_server_connection_setup;
     server_options.on_destroy_complete = s_tester_http_server_on_destroy;
+    server_options.num_listeners = options->num_listeners;
 
     tester->server = aws_http_server_new(&server_options);
     ASSERT_NOT_NULL(tester->server);
@@ -368,6 +370,23 @@ static int s_test_server_new_destroy(struct aws_allocator *allocator, void *ctx)
 }
 AWS_TEST_CASE(server_new_destroy, s_test_server_new_destroy);
 
+/* Multi-listener mode on a socket type that can't share the endpoint (local sockets) must
+ * fall back to however many listeners bind, and still set up and shut down cleanly */
+static int s_test_server_new_destroy_multi_listener(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    struct tester_options options = {
+        .alloc = allocator,
+        .no_connection = true,
+        .num_listeners = 4,
+    };
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, &options));
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(server_new_destroy_multi_listener, s_test_server_new_destroy_multi_listener);
+
 void release_all_client_connections(struct tester *tester) {
     for (int i = 0; i < tester->client_connection_num; i++) {
         aws_http_connection_release(tester->client_connections[i]);
@@ -25,6 +25,7 @@
 #include <aws/http/connection.h>
 #include <aws/http/connection_manager.h>
 #include <aws/http/private/connection_manager_system_vtable.h>
+#include <aws/http/request_response.h>
 #include <aws/http/server.h>
 #include <aws/io/channel_bootstrap.h>
 #include <aws/io/event_loop.h>
@@ -36,6 +37,7 @@ enum new_connection_result_type { AWS_NCRT_SUCCESS, AWS_NCRT_ERROR_VIA_CALLBACK,
 struct mock_connection {
     enum new_connection_result_type result;
     bool is_closed_on_release;
+    bool is_draining;
 };
 
 struct cm_tester_options {
@@ -43,6 +45,9 @@ struct cm_tester_options {
     struct aws_http_connection_manager_system_vtable *mock_table;
     struct aws_http_proxy_options *proxy_options;
     size_t max_connections;
+    uint64_t max_connection_idle_in_milliseconds;
+    size_t min_connections;
+    size_t prewarm_headroom;
 };
 
 struct cm_tester {
@@ -76,6 +81,7 @@ struct cm_tester {
     struct aws_atomic_var next_connection_id;
     struct aws_array_list mock_connections;
     aws_http_on_client_connection_shutdown_fn *release_connection_fn;
+    aws_http_on_client_connection_draining_fn *draining_fn;
 };
 
 static struct cm_tester s_tester;
@@ -160,6 +166,9 @@ int s_cm_tester_init(struct cm_tester_options *options) {
         .host = aws_byte_cursor_from_c_str("www.google.com"),
         .port = 80,
         .max_connections = options->max_connections,
+        .max_connection_idle_in_milliseconds = options->max_connection_idle_in_milliseconds,
+        .min_connections = options->min_connections,
+        .prewarm_headroom = options->prewarm_headroom,
         .shutdown_complete_user_data = tester,
         .shutdown_complete_callback = s_cm_tester_on_cm_shutdown_complete,
     };
@@ -528,6 +537,7 @@ static int s_aws_http_connection_manager_create_connection_sync_mock(
 
     ASSERT_SUCCESS(aws_mutex_lock(&tester->lock));
     tester->release_connection_fn = options->on_shutdown;
+    tester->draining_fn = options->on_draining;
     ASSERT_SUCCESS(aws_mutex_unlock(&tester->lock));
 
     /* Verify that any proxy options have been propagated to the connection attempt */
@@ -581,11 +591,33 @@ static bool s_aws_http_connection_manager_is_connection_open_sync_mock(const str
     return !proxy->is_closed_on_release;
 }
 
+static bool s_aws_http_connection_manager_is_connection_draining_sync_mock(
+    const struct aws_http_connection *connection) {
+
+    struct mock_connection *proxy = (struct mock_connection *)(void *)connection;
+
+    return proxy->is_draining;
+}
+
+static void s_aws_http_connection_manager_get_setup_timing_sync_mock(
+    const struct aws_http_connection *connection,
+    struct aws_http_connection_setup_timing *out_timing) {
+
+    (void)connection;
+
+    /* Every mock connect "took" 200ns total, 150ns of which was establishing the channel */
+    out_timing->connect_start_timestamp_ns = 100;
+    out_timing->channel_complete_timestamp_ns = 250;
+    out_timing->setup_complete_timestamp_ns = 300;
+}
+
 static struct aws_http_connection_manager_system_vtable s_synchronous_mocks = {
     .create_connection = s_aws_http_connection_manager_create_connection_sync_mock,
     .release_connection = s_aws_http_connection_manager_release_connection_sync_mock,
     .close_connection = s_aws_http_connection_manager_close_connection_sync_mock,
-    .is_connection_open = s_aws_http_connection_manager_is_connection_open_sync_mock};
+    .is_connection_open = s_aws_http_connection_manager_is_connection_open_sync_mock,
+    .is_connection_draining = s_aws_http_connection_manager_is_connection_draining_sync_mock,
+    .get_connection_setup_timing = s_aws_http_connection_manager_get_setup_timing_sync_mock};
 
 static int s_test_connection_manager_acquire_release_mix_synchronous(struct aws_allocator *allocator, void *ctx) {
     (void)ctx;
@@ -625,6 +657,542 @@ AWS_TEST_CASE(
     test_connection_manager_acquire_release_mix_synchronous,
     s_test_connection_manager_acquire_release_mix_synchronous);
 
+/* A pooled connection whose peer signals draining must be pulled out of the pool, released,
+ * and proactively replaced, so the next acquisition is never handed a doomed connection. */
+static int s_test_connection_manager_draining_connection_replaced(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct cm_tester_options options = {
+        .allocator = allocator, .max_connections = 2, .mock_table = &s_synchronous_mocks};
+
+    ASSERT_SUCCESS(s_cm_tester_init(&options));
+
+    s_add_mock_connections(2, AWS_NCRT_SUCCESS, false);
+
+    /* Vend the first connection, then put it back in the pool */
+    s_acquire_connections(1);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(1));
+
+    struct aws_http_connection *first_connection = NULL;
+    ASSERT_SUCCESS(aws_mutex_lock(&s_tester.lock));
+    aws_array_list_get_at(&s_tester.connections, &first_connection, 0);
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_tester.lock));
+    ASSERT_NOT_NULL(first_connection);
+
+    ASSERT_SUCCESS(s_release_connections(1, false));
+
+    /* Peer signals it's done with the idle connection */
+    struct mock_connection *first_mock = (struct mock_connection *)(void *)first_connection;
+    first_mock->is_draining = true;
+    s_tester.draining_fn(first_connection, s_tester.connection_manager);
+
+    /* The manager must have asked for a replacement connection right away */
+    ASSERT_UINT_EQUALS(2, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    /* The next acquisition must be handed the replacement, never the draining connection */
+    s_acquire_connections(1);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(2));
+
+    struct aws_http_connection *second_connection = NULL;
+    ASSERT_SUCCESS(aws_mutex_lock(&s_tester.lock));
+    aws_array_list_get_at(&s_tester.connections, &second_connection, 0);
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_tester.lock));
+    ASSERT_NOT_NULL(second_connection);
+    ASSERT_TRUE(second_connection != first_connection);
+
+    ASSERT_SUCCESS(s_release_connections(1, false));
+
+    ASSERT_SUCCESS(s_cm_tester_clean_up());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(
+    test_connection_manager_draining_connection_replaced,
+    s_test_connection_manager_draining_connection_replaced);
+
+static int s_test_connection_manager_idle_fast_path_reuse(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct cm_tester_options options = {
+        .allocator = allocator, .max_connections = 5, .mock_table = &s_synchronous_mocks};
+
+    ASSERT_SUCCESS(s_cm_tester_init(&options));
+
+    s_add_mock_connections(1, AWS_NCRT_SUCCESS, false);
+
+    /* With no waiters, repeated acquire/release should vend the same pooled connection
+     * via the lock-free slots and never ask for a second connection. */
+    for (size_t i = 0; i < 10; ++i) {
+        s_acquire_connections(1);
+        ASSERT_SUCCESS(s_wait_on_connection_reply_count(i + 1));
+        ASSERT_SUCCESS(s_release_connections(1, false));
+    }
+
+    ASSERT_TRUE(s_tester.connection_errors == 0);
+    ASSERT_UINT_EQUALS(1, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    ASSERT_SUCCESS(s_cm_tester_clean_up());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(test_connection_manager_idle_fast_path_reuse, s_test_connection_manager_idle_fast_path_reuse);
+
+static int s_test_connection_manager_idle_culling(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct cm_tester_options options = {
+        .allocator = allocator,
+        .max_connections = 5,
+        .max_connection_idle_in_milliseconds = 100,
+        .min_connections = 1,
+        .mock_table = &s_synchronous_mocks,
+    };
+
+    ASSERT_SUCCESS(s_cm_tester_init(&options));
+
+    s_add_mock_connections(5, AWS_NCRT_SUCCESS, false);
+
+    s_acquire_connections(3);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(3));
+    ASSERT_SUCCESS(s_release_connections(3, false));
+
+    /* Long enough for several reaper ticks; all three released connections pass the
+     * 100ms idle deadline, but the floor of one must survive. */
+    aws_thread_current_sleep(500000000);
+
+    s_acquire_connections(3);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(6));
+    ASSERT_SUCCESS(s_release_connections(3, false));
+
+    ASSERT_TRUE(s_tester.connection_errors == 0);
+
+    /* 3 initial connections, then 2 replacements for the culled ones; the floor connection
+     * was vended from the pool without a new connect. */
+    ASSERT_UINT_EQUALS(5, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    ASSERT_SUCCESS(s_cm_tester_clean_up());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(test_connection_manager_idle_culling, s_test_connection_manager_idle_culling);
+
+static int s_test_connection_manager_lifo_vending(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct cm_tester_options options = {
+        .allocator = allocator, .max_connections = 5, .mock_table = &s_synchronous_mocks};
+
+    ASSERT_SUCCESS(s_cm_tester_init(&options));
+
+    s_add_mock_connections(3, AWS_NCRT_SUCCESS, false);
+
+    s_acquire_connections(3);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(3));
+
+    /* s_release_connections pops from the back, so index 0 is the connection released last */
+    struct aws_http_connection *last_released = NULL;
+    ASSERT_SUCCESS(aws_mutex_lock(&s_tester.lock));
+    ASSERT_SUCCESS(aws_array_list_get_at(&s_tester.connections, &last_released, 0));
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_tester.lock));
+
+    ASSERT_SUCCESS(s_release_connections(3, false));
+
+    /* Most recently released connection must be vended first */
+    s_acquire_connections(1);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(4));
+
+    struct aws_http_connection *vended = NULL;
+    ASSERT_SUCCESS(aws_mutex_lock(&s_tester.lock));
+    ASSERT_SUCCESS(aws_array_list_get_at(&s_tester.connections, &vended, 0));
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_tester.lock));
+
+    ASSERT_TRUE(vended == last_released);
+    ASSERT_TRUE(s_tester.connection_errors == 0);
+    ASSERT_UINT_EQUALS(3, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    ASSERT_SUCCESS(s_cm_tester_clean_up());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(test_connection_manager_lifo_vending, s_test_connection_manager_lifo_vending);
+
+static int s_test_connection_manager_prewarm_headroom(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct cm_tester_options options = {
+        .allocator = allocator,
+        .max_connections = 5,
+        .prewarm_headroom = 2,
+        .mock_table = &s_synchronous_mocks,
+    };
+
+    ASSERT_SUCCESS(s_cm_tester_init(&options));
+
+    s_add_mock_connections(5, AWS_NCRT_SUCCESS, false);
+
+    /* A single acquisition under demand pressure should also open one speculative spare */
+    s_acquire_connections(1);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(1));
+    ASSERT_UINT_EQUALS(2, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    /* The next acquisition must be served from the pre-warmed spare, not a new connect */
+    s_acquire_connections(1);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(2));
+    ASSERT_UINT_EQUALS(2, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    ASSERT_TRUE(s_tester.connection_errors == 0);
+
+    ASSERT_SUCCESS(s_release_connections(2, false));
+
+    ASSERT_SUCCESS(s_cm_tester_clean_up());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(test_connection_manager_prewarm_headroom, s_test_connection_manager_prewarm_headroom);
+
+static int s_test_connection_manager_warm_floor(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct cm_tester_options options = {
+        .allocator = allocator,
+        .max_connections = 5,
+        .min_connections = 3,
+        .mock_table = &s_synchronous_mocks,
+    };
+
+    ASSERT_SUCCESS(s_cm_tester_init(&options));
+
+    /* The first three connections die when released; their replacements persist */
+    s_add_mock_connections(3, AWS_NCRT_SUCCESS, true);
+    s_add_mock_connections(3, AWS_NCRT_SUCCESS, false);
+
+    /* First use must bring up the whole floor, not just the one connection demanded */
+    s_acquire_connections(1);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(1));
+    ASSERT_UINT_EQUALS(3, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    /* The rest of the floor is warm; further acquisitions cost no new connects */
+    s_acquire_connections(2);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(3));
+    ASSERT_UINT_EQUALS(3, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    /* Releasing dead connections must replenish the floor immediately */
+    ASSERT_SUCCESS(s_release_connections(3, false));
+    ASSERT_UINT_EQUALS(6, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    /* ...and the replacements satisfy the next wave from the pool */
+    s_acquire_connections(3);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(6));
+    ASSERT_UINT_EQUALS(6, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    ASSERT_TRUE(s_tester.connection_errors == 0);
+
+    ASSERT_SUCCESS(s_release_connections(3, false));
+
+    ASSERT_SUCCESS(s_cm_tester_clean_up());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(test_connection_manager_warm_floor, s_test_connection_manager_warm_floor);
+
+static struct {
+    struct aws_http_connection *connection;
+    int error_code;
+    bool complete;
+    size_t transform_call_count;
+} s_transformed_acquisition_result;
+
+static void s_test_transform_sign(
+    struct aws_http_message *message,
+    void *user_data,
+    aws_http_message_transform_complete_fn *complete_fn,
+    void *complete_ctx) {
+    (void)user_data;
+
+    ++s_transformed_acquisition_result.transform_call_count;
+
+    struct aws_http_header signature = {
+        .name = aws_byte_cursor_from_c_str("Authorization"),
+        .value = aws_byte_cursor_from_c_str("signed"),
+    };
+
+    int error_code = AWS_ERROR_SUCCESS;
+    if (aws_http_message_add_header(message, signature)) {
+        error_code = aws_last_error();
+    }
+
+    complete_fn(message, error_code, complete_ctx);
+}
+
+static void s_test_transform_fail(
+    struct aws_http_message *message,
+    void *user_data,
+    aws_http_message_transform_complete_fn *complete_fn,
+    void *complete_ctx) {
+    (void)user_data;
+
+    ++s_transformed_acquisition_result.transform_call_count;
+
+    complete_fn(message, AWS_ERROR_HTTP_UNKNOWN, complete_ctx);
+}
+
+static void s_on_transformed_acquisition_complete(
+    struct aws_http_connection *connection,
+    struct aws_http_message *message,
+    int error_code,
+    void *user_data) {
+    (void)message;
+    (void)user_data;
+
+    struct cm_tester *tester = &s_tester;
+
+    aws_mutex_lock(&tester->lock);
+    s_transformed_acquisition_result.connection = connection;
+    s_transformed_acquisition_result.error_code = error_code;
+    s_transformed_acquisition_result.complete = true;
+    aws_mutex_unlock(&tester->lock);
+    aws_condition_variable_notify_one(&tester->signal);
+}
+
+static bool s_is_transformed_acquisition_complete(void *context) {
+    (void)context;
+
+    return s_transformed_acquisition_result.complete;
+}
+
+static int s_wait_on_transformed_acquisition(void) {
+    struct cm_tester *tester = &s_tester;
+
+    ASSERT_SUCCESS(aws_mutex_lock(&tester->lock));
+    int signal_error = aws_condition_variable_wait_pred(
+        &tester->signal, &tester->lock, s_is_transformed_acquisition_complete, tester);
+    ASSERT_SUCCESS(aws_mutex_unlock(&tester->lock));
+
+    return signal_error;
+}
+
+static int s_test_connection_manager_transformed_acquisition(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct cm_tester_options options = {
+        .allocator = allocator, .max_connections = 2, .mock_table = &s_synchronous_mocks};
+
+    ASSERT_SUCCESS(s_cm_tester_init(&options));
+
+    s_add_mock_connections(2, AWS_NCRT_SUCCESS, false);
+
+    struct aws_http_message *message = aws_http_message_new_request(allocator);
+    ASSERT_NOT_NULL(message);
+
+    /* Success: callback must fire with both an acquired connection and the signed message */
+    AWS_ZERO_STRUCT(s_transformed_acquisition_result);
+    aws_http_connection_manager_acquire_transformed_connection(
+        s_tester.connection_manager, message, s_test_transform_sign, NULL, s_on_transformed_acquisition_complete, NULL);
+    ASSERT_SUCCESS(s_wait_on_transformed_acquisition());
+
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, s_transformed_acquisition_result.error_code);
+    ASSERT_NOT_NULL(s_transformed_acquisition_result.connection);
+    ASSERT_UINT_EQUALS(1, s_transformed_acquisition_result.transform_call_count);
+
+    struct aws_http_header signature;
+    AWS_ZERO_STRUCT(signature);
+    ASSERT_UINT_EQUALS(1, aws_http_message_get_header_count(message));
+    ASSERT_SUCCESS(aws_http_message_get_header(message, &signature, 0));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&signature.name, "Authorization"));
+
+    ASSERT_SUCCESS(aws_http_connection_manager_release_connection(
+        s_tester.connection_manager, s_transformed_acquisition_result.connection));
+
+    /* Failure: the transform fails after the connection was acquired; the connection must be
+     * returned to the manager rather than stranded */
+    AWS_ZERO_STRUCT(s_transformed_acquisition_result);
+    aws_http_connection_manager_acquire_transformed_connection(
+        s_tester.connection_manager, message, s_test_transform_fail, NULL, s_on_transformed_acquisition_complete, NULL);
+    ASSERT_SUCCESS(s_wait_on_transformed_acquisition());
+
+    ASSERT_INT_EQUALS(AWS_ERROR_HTTP_UNKNOWN, s_transformed_acquisition_result.error_code);
+    ASSERT_NULL(s_transformed_acquisition_result.connection);
+
+    struct aws_http_connection_manager_metrics metrics;
+    AWS_ZERO_STRUCT(metrics);
+    aws_http_connection_manager_fetch_metrics(s_tester.connection_manager, &metrics);
+    ASSERT_UINT_EQUALS(0, metrics.vended_connection_count);
+
+    aws_http_message_destroy(message);
+
+    ASSERT_SUCCESS(s_cm_tester_clean_up());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(test_connection_manager_transformed_acquisition, s_test_connection_manager_transformed_acquisition);
+
+static int s_test_connection_manager_batch_acquire(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct cm_tester_options options = {
+        .allocator = allocator, .max_connections = 10, .mock_table = &s_synchronous_mocks};
+
+    ASSERT_SUCCESS(s_cm_tester_init(&options));
+
+    s_add_mock_connections(6, AWS_NCRT_SUCCESS, false);
+
+    aws_http_connection_manager_acquire_connections(s_tester.connection_manager, 6, s_on_acquire_connection, &s_tester);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(6));
+    ASSERT_TRUE(s_tester.connection_errors == 0);
+    ASSERT_UINT_EQUALS(6, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    ASSERT_SUCCESS(s_release_connections(6, false));
+
+    /* The second batch must be served entirely from the pool, with no new connects */
+    aws_http_connection_manager_acquire_connections(s_tester.connection_manager, 6, s_on_acquire_connection, &s_tester);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(12));
+    ASSERT_TRUE(s_tester.connection_errors == 0);
+    ASSERT_UINT_EQUALS(6, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    ASSERT_SUCCESS(s_release_connections(6, false));
+
+    ASSERT_SUCCESS(s_cm_tester_clean_up());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(test_connection_manager_batch_acquire, s_test_connection_manager_batch_acquire);
+
+static uint64_t s_mock_current_thread_id = 0;
+
+static uint64_t s_aws_http_connection_manager_get_thread_id_sync_mock(void) {
+    return s_mock_current_thread_id;
+}
+
+static struct aws_http_connection_manager_system_vtable s_synchronous_mocks_with_thread_id = {
+    .create_connection = s_aws_http_connection_manager_create_connection_sync_mock,
+    .release_connection = s_aws_http_connection_manager_release_connection_sync_mock,
+    .close_connection = s_aws_http_connection_manager_close_connection_sync_mock,
+    .is_connection_open = s_aws_http_connection_manager_is_connection_open_sync_mock,
+    .get_current_thread_id = s_aws_http_connection_manager_get_thread_id_sync_mock};
+
+static int s_test_connection_manager_affine_vending(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct cm_tester_options options = {
+        .allocator = allocator, .max_connections = 5, .mock_table = &s_synchronous_mocks_with_thread_id};
+
+    ASSERT_SUCCESS(s_cm_tester_init(&options));
+
+    s_add_mock_connections(2, AWS_NCRT_SUCCESS, false);
+
+    /* The synchronous mock invokes the setup callback on the acquiring thread, so each
+     * connection's recorded home is whatever the fake thread id is at acquire time */
+    s_mock_current_thread_id = 1;
+    s_acquire_connections(1);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(1));
+
+    s_mock_current_thread_id = 2;
+    s_acquire_connections(1);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(2));
+
+    struct aws_http_connection *homed_on_thread1 = NULL;
+    struct aws_http_connection *homed_on_thread2 = NULL;
+    ASSERT_SUCCESS(aws_mutex_lock(&s_tester.lock));
+    ASSERT_SUCCESS(aws_array_list_get_at(&s_tester.connections, &homed_on_thread1, 0));
+    ASSERT_SUCCESS(aws_array_list_get_at(&s_tester.connections, &homed_on_thread2, 1));
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_tester.lock));
+
+    ASSERT_SUCCESS(s_release_connections(2, false));
+
+    /* Regardless of release order, each affine acquire must get the connection whose
+     * home matches the calling thread */
+    s_mock_current_thread_id = 1;
+    aws_http_connection_manager_acquire_affine_connection(
+        s_tester.connection_manager, s_on_acquire_connection, &s_tester);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(3));
+
+    s_mock_current_thread_id = 2;
+    aws_http_connection_manager_acquire_affine_connection(
+        s_tester.connection_manager, s_on_acquire_connection, &s_tester);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(4));
+
+    struct aws_http_connection *first_vended = NULL;
+    struct aws_http_connection *second_vended = NULL;
+    ASSERT_SUCCESS(aws_mutex_lock(&s_tester.lock));
+    ASSERT_SUCCESS(aws_array_list_get_at(&s_tester.connections, &first_vended, 0));
+    ASSERT_SUCCESS(aws_array_list_get_at(&s_tester.connections, &second_vended, 1));
+    ASSERT_SUCCESS(aws_mutex_unlock(&s_tester.lock));
+
+    ASSERT_TRUE(first_vended == homed_on_thread1);
+    ASSERT_TRUE(second_vended == homed_on_thread2);
+
+    ASSERT_TRUE(s_tester.connection_errors == 0);
+    ASSERT_UINT_EQUALS(2, aws_atomic_load_int(&s_tester.next_connection_id));
+
+    ASSERT_SUCCESS(s_release_connections(2, false));
+
+    ASSERT_SUCCESS(s_cm_tester_clean_up());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(test_connection_manager_affine_vending, s_test_connection_manager_affine_vending);
+
+static int s_test_connection_manager_metrics(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct cm_tester_options options = {
+        .allocator = allocator, .max_connections = 5, .mock_table = &s_synchronous_mocks};
+
+    ASSERT_SUCCESS(s_cm_tester_init(&options));
+
+    s_add_mock_connections(2, AWS_NCRT_SUCCESS, false);
+
+    s_acquire_connections(2);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(2));
+
+    struct aws_http_connection_manager_metrics metrics;
+    aws_http_connection_manager_fetch_metrics(s_tester.connection_manager, &metrics);
+    ASSERT_UINT_EQUALS(2, metrics.total_acquisition_count);
+    ASSERT_UINT_EQUALS(2, metrics.connect_count);
+    ASSERT_UINT_EQUALS(0, metrics.pool_hit_count);
+    ASSERT_UINT_EQUALS(2, metrics.vended_connection_count);
+    ASSERT_UINT_EQUALS(0, metrics.held_connection_count);
+    ASSERT_UINT_EQUALS(0, metrics.failed_acquisition_count);
+
+    /* Both connects accumulate the mock's fixed setup timing */
+    ASSERT_UINT_EQUALS(2 * 200, metrics.connect_total_time_ns);
+    ASSERT_UINT_EQUALS(2 * 150, metrics.connect_channel_time_ns);
+
+    ASSERT_SUCCESS(s_release_connections(2, false));
+
+    /* Both releases land back in the pool; the next acquire must be a pool hit,
+     * not a new connect */
+    s_acquire_connections(1);
+    ASSERT_SUCCESS(s_wait_on_connection_reply_count(3));
+
+    aws_http_connection_manager_fetch_metrics(s_tester.connection_manager, &metrics);
+    ASSERT_UINT_EQUALS(3, metrics.total_acquisition_count);
+    ASSERT_UINT_EQUALS(2, metrics.connect_count);
+    ASSERT_UINT_EQUALS(1, metrics.pool_hit_count);
+    ASSERT_UINT_EQUALS(1, metrics.vended_connection_count);
+    ASSERT_UINT_EQUALS(1, metrics.held_connection_count);
+
+    /* A pool hit performs no connect, so connect timing is unchanged */
+    ASSERT_UINT_EQUALS(2 * 200, metrics.connect_total_time_ns);
+    ASSERT_UINT_EQUALS(2 * 150, metrics.connect_channel_time_ns);
+
+    /* Every completed acquisition lands in exactly one latency bucket */
+    uint64_t histogram_total = 0;
+    for (size_t i = 0; i < AWS_HTTP_CONNECTION_MANAGER_METRICS_LATENCY_BUCKETS; ++i) {
+        histogram_total += metrics.acquire_latency_buckets[i];
+    }
+    ASSERT_UINT_EQUALS(3, histogram_total);
+
+    ASSERT_TRUE(s_tester.connection_errors == 0);
+
+    ASSERT_SUCCESS(s_release_connections(1, false));
+
+    ASSERT_SUCCESS(s_cm_tester_clean_up());
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(test_connection_manager_metrics, s_test_connection_manager_metrics);
+
 static int s_test_connection_manager_connect_callback_failure(struct aws_allocator *allocator, void *ctx) {
     (void)ctx;
 
@@ -755,3 +1323,205 @@ static int s_test_connection_manager_proxy_acquire_single(struct aws_allocator *
     return AWS_OP_SUCCESS;
 }
 AWS_TEST_CASE(test_connection_manager_proxy_acquire_single, s_test_connection_manager_proxy_acquire_single);
+
+/*
+ * Host pool tests.  These use a dedicated synchronous mock vtable (separate from the
+ * cm_tester machinery above, which is built around a single manager) so that each
+ * per-host manager the pool creates gets correct per-connection shutdown bookkeeping.
+ */
+
+struct host_pool_mock_connection {
+    char host[256];
+    uint16_t port;
+    aws_http_on_client_connection_shutdown_fn *on_shutdown;
+    void *shutdown_user_data;
+    bool released;
+};
+
+struct host_pool_tester {
+    struct aws_mutex lock;
+    struct aws_condition_variable signal;
+
+    struct host_pool_mock_connection mock_connections[16];
+    size_t connections_created;
+
+    struct aws_http_connection *last_connection;
+    int last_error_code;
+    size_t setup_callback_count;
+
+    bool is_pool_shutdown_complete;
+};
+
+static struct host_pool_tester s_host_pool_tester;
+
+static int s_host_pool_create_connection_mock(const struct aws_http_client_connection_options *options) {
+    struct host_pool_tester *tester = &s_host_pool_tester;
+
+    aws_mutex_lock(&tester->lock);
+    AWS_FATAL_ASSERT(tester->connections_created < AWS_ARRAY_SIZE(tester->mock_connections));
+    struct host_pool_mock_connection *connection = &tester->mock_connections[tester->connections_created++];
+
+    size_t host_len = options->host_name.len < sizeof(connection->host) - 1 ? options->host_name.len
+                                                                            : sizeof(connection->host) - 1;
+    memcpy(connection->host, options->host_name.ptr, host_len);
+    connection->host[host_len] = '\0';
+    connection->port = options->port;
+    connection->on_shutdown = options->on_shutdown;
+    connection->shutdown_user_data = options->user_data;
+    aws_mutex_unlock(&tester->lock);
+
+    options->on_setup((struct aws_http_connection *)connection, AWS_ERROR_SUCCESS, options->user_data);
+
+    return AWS_OP_SUCCESS;
+}
+
+static void s_host_pool_release_connection_mock(struct aws_http_connection *connection) {
+    struct host_pool_mock_connection *mock = (struct host_pool_mock_connection *)(void *)connection;
+
+    aws_mutex_lock(&s_host_pool_tester.lock);
+    mock->released = true;
+    aws_mutex_unlock(&s_host_pool_tester.lock);
+
+    mock->on_shutdown(connection, AWS_ERROR_SUCCESS, mock->shutdown_user_data);
+}
+
+static void s_host_pool_close_connection_mock(struct aws_http_connection *connection) {
+    (void)connection;
+}
+
+static bool s_host_pool_is_connection_open_mock(const struct aws_http_connection *connection) {
+    const struct host_pool_mock_connection *mock = (const struct host_pool_mock_connection *)(const void *)connection;
+
+    return !mock->released;
+}
+
+static struct aws_http_connection_manager_system_vtable s_host_pool_mocks = {
+    .create_connection = s_host_pool_create_connection_mock,
+    .release_connection = s_host_pool_release_connection_mock,
+    .close_connection = s_host_pool_close_connection_mock,
+    .is_connection_open = s_host_pool_is_connection_open_mock};
+
+static void s_host_pool_on_connection_setup(struct aws_http_connection *connection, int error_code, void *user_data) {
+    (void)user_data;
+
+    aws_mutex_lock(&s_host_pool_tester.lock);
+    s_host_pool_tester.last_connection = connection;
+    s_host_pool_tester.last_error_code = error_code;
+    ++s_host_pool_tester.setup_callback_count;
+    aws_mutex_unlock(&s_host_pool_tester.lock);
+}
+
+static void s_host_pool_on_shutdown_complete(void *user_data) {
+    (void)user_data;
+
+    aws_mutex_lock(&s_host_pool_tester.lock);
+    s_host_pool_tester.is_pool_shutdown_complete = true;
+    aws_mutex_unlock(&s_host_pool_tester.lock);
+    aws_condition_variable_notify_one(&s_host_pool_tester.signal);
+}
+
+static bool s_host_pool_is_shutdown_complete(void *context) {
+    (void)context;
+
+    return s_host_pool_tester.is_pool_shutdown_complete;
+}
+
+static int s_test_connection_manager_host_pool(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_http_library_init(allocator);
+
+    struct host_pool_tester *tester = &s_host_pool_tester;
+    AWS_ZERO_STRUCT(*tester);
+    ASSERT_SUCCESS(aws_mutex_init(&tester->lock));
+    ASSERT_SUCCESS(aws_condition_variable_init(&tester->signal));
+
+    struct aws_socket_options socket_options;
+    AWS_ZERO_STRUCT(socket_options);
+
+    struct aws_http_host_pool_options options = {
+        .socket_options = &socket_options,
+        .max_total_connections = 4,
+        .max_hosts = 2,
+        .shutdown_complete_callback = s_host_pool_on_shutdown_complete,
+    };
+
+    struct aws_http_host_pool *pool = aws_http_host_pool_new(allocator, &options);
+    ASSERT_NOT_NULL(pool);
+
+    aws_http_host_pool_set_system_vtable(pool, &s_host_pool_mocks);
+
+    /* First acquisition for a host lazily creates its manager */
+    aws_http_host_pool_acquire_connection(
+        pool, aws_byte_cursor_from_c_str("alpha.com"), 80, s_host_pool_on_connection_setup, NULL);
+    ASSERT_UINT_EQUALS(1, tester->setup_callback_count);
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, tester->last_error_code);
+    ASSERT_NOT_NULL(tester->last_connection);
+    ASSERT_STR_EQUALS("alpha.com", tester->mock_connections[0].host);
+    ASSERT_UINT_EQUALS(80, tester->mock_connections[0].port);
+    struct aws_http_connection *alpha_connection = tester->last_connection;
+
+    aws_http_host_pool_acquire_connection(
+        pool, aws_byte_cursor_from_c_str("bravo.com"), 443, s_host_pool_on_connection_setup, NULL);
+    ASSERT_UINT_EQUALS(2, tester->setup_callback_count);
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, tester->last_error_code);
+    ASSERT_STR_EQUALS("bravo.com", tester->mock_connections[1].host);
+    struct aws_http_connection *bravo_connection = tester->last_connection;
+
+    /* Both host slots are pinned by vended connections; a third host must be rejected */
+    aws_http_host_pool_acquire_connection(
+        pool, aws_byte_cursor_from_c_str("charlie.com"), 80, s_host_pool_on_connection_setup, NULL);
+    ASSERT_UINT_EQUALS(3, tester->setup_callback_count);
+    ASSERT_NULL(tester->last_connection);
+    ASSERT_INT_EQUALS(AWS_ERROR_HTTP_HOST_POOL_BUDGET_EXCEEDED, tester->last_error_code);
+
+    /* Returning alpha's connection unpins its slot... */
+    ASSERT_SUCCESS(aws_http_host_pool_release_connection(pool, alpha_connection));
+
+    /* ...so the third host can now evict it.  Alpha's pooled connection is torn down
+     * along with its manager. */
+    aws_http_host_pool_acquire_connection(
+        pool, aws_byte_cursor_from_c_str("charlie.com"), 80, s_host_pool_on_connection_setup, NULL);
+    ASSERT_UINT_EQUALS(4, tester->setup_callback_count);
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, tester->last_error_code);
+    ASSERT_STR_EQUALS("charlie.com", tester->mock_connections[2].host);
+    struct aws_http_connection *charlie_connection = tester->last_connection;
+    ASSERT_TRUE(tester->mock_connections[0].released);
+
+    /* A second acquisition against a cached host reuses its manager (4 / 2 hosts = 2 each) */
+    aws_http_host_pool_acquire_connection(
+        pool, aws_byte_cursor_from_c_str("bravo.com"), 443, s_host_pool_on_connection_setup, NULL);
+    ASSERT_UINT_EQUALS(5, tester->setup_callback_count);
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, tester->last_error_code);
+    ASSERT_STR_EQUALS("bravo.com", tester->mock_connections[3].host);
+    struct aws_http_connection *bravo_connection2 = tester->last_connection;
+
+    /* Releasing a connection the pool doesn't know about is an error */
+    struct host_pool_mock_connection unknown_connection;
+    AWS_ZERO_STRUCT(unknown_connection);
+    ASSERT_FAILS(aws_http_host_pool_release_connection(pool, (struct aws_http_connection *)&unknown_connection));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    ASSERT_SUCCESS(aws_http_host_pool_release_connection(pool, bravo_connection));
+    ASSERT_SUCCESS(aws_http_host_pool_release_connection(pool, bravo_connection2));
+    ASSERT_SUCCESS(aws_http_host_pool_release_connection(pool, charlie_connection));
+
+    aws_http_host_pool_release(pool);
+
+    ASSERT_SUCCESS(aws_mutex_lock(&tester->lock));
+    ASSERT_SUCCESS(
+        aws_condition_variable_wait_pred(&tester->signal, &tester->lock, s_host_pool_is_shutdown_complete, NULL));
+    ASSERT_SUCCESS(aws_mutex_unlock(&tester->lock));
+
+    for (size_t i = 0; i < tester->connections_created; ++i) {
+        ASSERT_TRUE(tester->mock_connections[i].released);
+    }
+
+    aws_condition_variable_clean_up(&tester->signal);
+    aws_mutex_clean_up(&tester->lock);
+
+    aws_http_library_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(test_connection_manager_host_pool, s_test_connection_manager_host_pool);
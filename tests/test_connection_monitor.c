@@ -0,0 +1,145 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/connection_monitor.h>
+
+#include <aws/common/clock.h>
+#include <aws/testing/aws_test_harness.h>
+
+#define TEST_CASE(NAME)                                                                                                \
+    AWS_TEST_CASE(NAME, s_test_##NAME);                                                                                \
+    static int s_test_##NAME(struct aws_allocator *allocator, void *ctx)
+
+static const uint64_t ONE_SEC_NS = AWS_TIMESTAMP_NANOS;
+
+TEST_CASE(connection_monitor_options_validation) {
+    (void)allocator;
+    (void)ctx;
+
+    struct aws_http_connection_monitoring_options options = {
+        .minimum_throughput_bytes_per_second = 1000,
+        .allowable_throughput_failure_interval_seconds = 2,
+    };
+    ASSERT_TRUE(aws_http_connection_monitoring_options_is_valid(&options));
+
+    ASSERT_FALSE(aws_http_connection_monitoring_options_is_valid(NULL));
+
+    options.minimum_throughput_bytes_per_second = 0;
+    ASSERT_FALSE(aws_http_connection_monitoring_options_is_valid(&options));
+
+    options.minimum_throughput_bytes_per_second = 1000;
+    options.allowable_throughput_failure_interval_seconds = 0;
+    ASSERT_FALSE(aws_http_connection_monitoring_options_is_valid(&options));
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Failure seconds accumulate while throughput is low, reset when it recovers,
+ * and cross the allowable interval only after enough consecutive failures. */
+TEST_CASE(connection_monitor_failure_tracking) {
+    (void)allocator;
+    (void)ctx;
+
+    struct aws_http_connection_monitor monitor = {
+        .options =
+            {
+                .minimum_throughput_bytes_per_second = 1000,
+                .allowable_throughput_failure_interval_seconds = 3,
+            },
+    };
+
+    uint64_t total = 5000;
+    ASSERT_FALSE(aws_http_connection_monitor_process_sample(&monitor, total, ONE_SEC_NS, true /*transfer_active*/));
+    ASSERT_UINT_EQUALS(0, monitor.consecutive_throughput_failures);
+
+    /* Two slow seconds: failing, but still within the allowable interval */
+    total += 500;
+    ASSERT_FALSE(aws_http_connection_monitor_process_sample(&monitor, total, ONE_SEC_NS, true));
+    total += 100;
+    ASSERT_FALSE(aws_http_connection_monitor_process_sample(&monitor, total, ONE_SEC_NS, true));
+    ASSERT_UINT_EQUALS(2, monitor.consecutive_throughput_failures);
+
+    /* A healthy second resets the count */
+    total += 4000;
+    ASSERT_FALSE(aws_http_connection_monitor_process_sample(&monitor, total, ONE_SEC_NS, true));
+    ASSERT_UINT_EQUALS(0, monitor.consecutive_throughput_failures);
+
+    /* Three slow seconds in a row cross the interval */
+    total += 100;
+    ASSERT_FALSE(aws_http_connection_monitor_process_sample(&monitor, total, ONE_SEC_NS, true));
+    total += 100;
+    ASSERT_FALSE(aws_http_connection_monitor_process_sample(&monitor, total, ONE_SEC_NS, true));
+    total += 100;
+    ASSERT_TRUE(aws_http_connection_monitor_process_sample(&monitor, total, ONE_SEC_NS, true));
+
+    return AWS_OP_SUCCESS;
+}
+
+/* An idle connection moves no bytes but must never be deemed unhealthy. */
+TEST_CASE(connection_monitor_idle_connection_is_healthy) {
+    (void)allocator;
+    (void)ctx;
+
+    struct aws_http_connection_monitor monitor = {
+        .options =
+            {
+                .minimum_throughput_bytes_per_second = 1000,
+                .allowable_throughput_failure_interval_seconds = 1,
+            },
+    };
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_FALSE(aws_http_connection_monitor_process_sample(&monitor, 0, ONE_SEC_NS, false /*transfer_active*/));
+    }
+    ASSERT_UINT_EQUALS(0, monitor.consecutive_throughput_failures);
+
+    /* Going idle mid-transfer also resets accumulated failures */
+    struct aws_http_connection_monitor monitor2 = {
+        .options =
+            {
+                .minimum_throughput_bytes_per_second = 1000,
+                .allowable_throughput_failure_interval_seconds = 2,
+            },
+    };
+    ASSERT_FALSE(aws_http_connection_monitor_process_sample(&monitor2, 100, ONE_SEC_NS, true));
+    ASSERT_UINT_EQUALS(1, monitor2.consecutive_throughput_failures);
+    ASSERT_FALSE(aws_http_connection_monitor_process_sample(&monitor2, 100, ONE_SEC_NS, false));
+    ASSERT_UINT_EQUALS(0, monitor2.consecutive_throughput_failures);
+
+    return AWS_OP_SUCCESS;
+}
+
+/* The required byte count scales with the actual time between samples. */
+TEST_CASE(connection_monitor_sample_interval_scaling) {
+    (void)allocator;
+    (void)ctx;
+
+    struct aws_http_connection_monitor monitor = {
+        .options =
+            {
+                .minimum_throughput_bytes_per_second = 1000,
+                .allowable_throughput_failure_interval_seconds = 1,
+            },
+    };
+
+    /* 600 bytes over half a second beats the 500-byte requirement */
+    ASSERT_FALSE(aws_http_connection_monitor_process_sample(&monitor, 600, ONE_SEC_NS / 2, true));
+    ASSERT_UINT_EQUALS(0, monitor.consecutive_throughput_failures);
+
+    /* 1500 more bytes over two seconds falls short of the 2000-byte requirement */
+    ASSERT_TRUE(aws_http_connection_monitor_process_sample(&monitor, 600 + 1500, 2 * ONE_SEC_NS, true));
+
+    return AWS_OP_SUCCESS;
+}
@@ -54,7 +54,13 @@ struct tester {
     struct aws_logger logger;
 };
 
-static int s_tester_init(struct tester *tester, struct aws_allocator *alloc) {
+static int s_tester_init_ex(
+    struct tester *tester,
+    struct aws_allocator *alloc,
+    size_t max_pipelined_requests,
+    size_t window_update_threshold,
+    size_t preferred_write_message_size,
+    bool adaptive_window_management) {
     aws_http_library_init(alloc);
 
     AWS_ZERO_STRUCT(*tester);
@@ -70,7 +76,13 @@ static int s_tester_init(struct tester *tester, struct aws_allocator *alloc) {
 
     ASSERT_SUCCESS(testing_channel_init(&tester->testing_channel, alloc));
 
-    tester->connection = aws_http_connection_new_http1_1_client(alloc, SIZE_MAX);
+    tester->connection = aws_http_connection_new_http1_1_client(
+        alloc,
+        SIZE_MAX,
+        max_pipelined_requests,
+        window_update_threshold,
+        preferred_write_message_size,
+        adaptive_window_management);
     ASSERT_NOT_NULL(tester->connection);
 
     struct aws_channel_slot *slot = aws_channel_slot_new(tester->testing_channel.channel);
@@ -86,6 +98,16 @@ static int s_tester_init(struct tester *tester, struct aws_allocator *alloc) {
     return AWS_OP_SUCCESS;
 }
 
+static int s_tester_init(struct tester *tester, struct aws_allocator *alloc) {
+    return s_tester_init_ex(
+        tester,
+        alloc,
+        0 /*max_pipelined_requests*/,
+        0 /*window_update_threshold*/,
+        0 /*preferred_write_message_size*/,
+        false /*adaptive_window_management*/);
+}
+
 static int s_tester_clean_up(struct tester *tester) {
     aws_http_connection_release(tester->connection);
     ASSERT_SUCCESS(testing_channel_clean_up(&tester->testing_channel));
@@ -226,6 +248,57 @@ H1_CLIENT_TEST_CASE(h1_client_request_send_body) {
     return AWS_OP_SUCCESS;
 }
 
+H1_CLIENT_TEST_CASE(h1_client_request_send_chunked_body) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    /* send request with "Transfer-Encoding: chunked" instead of Content-Length */
+    static const struct aws_byte_cursor body = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("write more tests");
+    struct aws_input_stream *body_stream = aws_input_stream_new_from_cursor(allocator, &body);
+
+    struct aws_http_header headers[] = {
+        {
+            .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Transfer-Encoding"),
+            .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("chunked"),
+        },
+    };
+
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    ASSERT_NOT_NULL(request);
+    ASSERT_SUCCESS(aws_http_message_set_request_method(request, aws_byte_cursor_from_c_str("PUT")));
+    ASSERT_SUCCESS(aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/plan.txt")));
+    aws_http_message_add_header_array(request, headers, AWS_ARRAY_SIZE(headers));
+    aws_http_message_set_body_stream(request, body_stream);
+
+    struct aws_http_make_request_options opt = {
+        .self_size = sizeof(opt),
+        .request = request,
+    };
+    struct aws_http_stream *stream = aws_http_connection_make_request(tester.connection, &opt);
+    ASSERT_NOT_NULL(stream);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* check result: 16 byte body framed as one chunk (fixed-width hex size), then last-chunk */
+    const char *expected = "PUT /plan.txt HTTP/1.1\r\n"
+                           "Transfer-Encoding: chunked\r\n"
+                           "\r\n"
+                           "00000010\r\n"
+                           "write more tests\r\n"
+                           "0\r\n"
+                           "\r\n";
+    ASSERT_SUCCESS(testing_channel_check_written_message(&tester.testing_channel, expected));
+
+    /* clean up */
+    aws_input_stream_destroy(body_stream);
+    aws_http_message_destroy(request);
+    aws_http_stream_release(stream);
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
 H1_CLIENT_TEST_CASE(h1_client_request_content_length_0_ok) {
     (void)ctx;
     struct tester tester;
@@ -282,6 +355,65 @@ H1_CLIENT_TEST_CASE(h1_client_request_content_length_0_ok) {
     return AWS_OP_SUCCESS;
 }
 
+/* "Expect: 100-continue" request: the head goes out alone and the body is withheld
+ * until the server's interim 100 response arrives */
+H1_CLIENT_TEST_CASE(h1_client_request_expect_100_continue_waits_for_interim_response) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    static const struct aws_byte_cursor body = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("write more tests!");
+    struct aws_input_stream *body_stream = aws_input_stream_new_from_cursor(allocator, &body);
+
+    struct aws_http_header headers[] = {
+        {
+            .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Content-Length"),
+            .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("17"),
+        },
+        {
+            .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Expect"),
+            .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("100-continue"),
+        },
+    };
+
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    ASSERT_NOT_NULL(request);
+    ASSERT_SUCCESS(aws_http_message_set_request_method(request, aws_byte_cursor_from_c_str("PUT")));
+    ASSERT_SUCCESS(aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/upload.txt")));
+    aws_http_message_add_header_array(request, headers, AWS_ARRAY_SIZE(headers));
+    aws_http_message_set_body_stream(request, body_stream);
+
+    struct aws_http_make_request_options opt = {
+        .self_size = sizeof(opt),
+        .request = request,
+    };
+    struct aws_http_stream *stream = aws_http_connection_make_request(tester.connection, &opt);
+    ASSERT_NOT_NULL(stream);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* Only the head should have been written */
+    const char *expected_head = "PUT /upload.txt HTTP/1.1\r\n"
+                                "Content-Length: 17\r\n"
+                                "Expect: 100-continue\r\n"
+                                "\r\n";
+    ASSERT_SUCCESS(testing_channel_check_written_message(&tester.testing_channel, expected_head));
+
+    /* The interim 100 response releases the body */
+    ASSERT_SUCCESS(testing_channel_send_response_str(&tester.testing_channel, "HTTP/1.1 100 Continue\r\n\r\n"));
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    ASSERT_SUCCESS(testing_channel_check_written_message(&tester.testing_channel, "write more tests!"));
+
+    /* clean up */
+    aws_input_stream_destroy(body_stream);
+    aws_http_message_destroy(request);
+    aws_http_stream_release(stream);
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
 /* For checking outgoing data across multiple aws_io_messages */
 struct cross_message_checker {
     struct aws_byte_buf expected;
@@ -405,6 +537,86 @@ H1_CLIENT_TEST_CASE(h1_client_request_send_large_body) {
     return AWS_OP_SUCCESS;
 }
 
+/* A small preferred_write_message_size should cap the size of outgoing aws_io_messages. */
+H1_CLIENT_TEST_CASE(h1_client_request_send_preferred_write_message_size) {
+    (void)ctx;
+    const size_t preferred_size = 1024;
+
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init_ex(
+        &tester,
+        allocator,
+        0 /*max_pipelined_requests*/,
+        0 /*window_update_threshold*/,
+        preferred_size,
+        false /*adaptive_window_management*/));
+
+    /* send request whose body spans many preferred-size messages */
+    size_t body_len = 16 * 1024;
+    struct aws_byte_buf body_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&body_buf, allocator, body_len));
+    while (body_buf.len < body_len) {
+        int r = rand();
+        aws_byte_buf_write_be32(&body_buf, (uint32_t)r);
+    }
+
+    const struct aws_byte_cursor body = aws_byte_cursor_from_buf(&body_buf);
+    struct aws_input_stream *body_stream = aws_input_stream_new_from_cursor(allocator, &body);
+
+    char content_length_value[100];
+    snprintf(content_length_value, sizeof(content_length_value), "%zu", body_len);
+    struct aws_http_header headers[] = {
+        {
+            .name = aws_byte_cursor_from_c_str("Content-Length"),
+            .value = aws_byte_cursor_from_c_str(content_length_value),
+        },
+    };
+
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    ASSERT_NOT_NULL(request);
+    ASSERT_SUCCESS(aws_http_message_set_request_method(request, aws_byte_cursor_from_c_str("PUT")));
+    ASSERT_SUCCESS(aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/small-messages.txt")));
+    aws_http_message_add_header_array(request, headers, AWS_ARRAY_SIZE(headers));
+    aws_http_message_set_body_stream(request, body_stream);
+
+    struct aws_http_make_request_options opt = {
+        .self_size = sizeof(opt),
+        .request = request,
+    };
+    struct aws_http_stream *stream = aws_http_connection_make_request(tester.connection, &opt);
+    ASSERT_NOT_NULL(stream);
+
+    /* check result */
+    const char *expected_head_fmt = "PUT /small-messages.txt HTTP/1.1\r\n"
+                                    "Content-Length: %zu\r\n"
+                                    "\r\n";
+    char expected_head[1024];
+    int expected_head_len = snprintf(expected_head, sizeof(expected_head), expected_head_fmt, body_len);
+
+    struct aws_byte_buf expected_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&expected_buf, allocator, body_len + expected_head_len));
+    ASSERT_TRUE(aws_byte_buf_write(&expected_buf, (uint8_t *)expected_head, expected_head_len));
+    ASSERT_TRUE(aws_byte_buf_write_from_whole_buffer(&expected_buf, body_buf));
+
+    size_t num_io_messages;
+    ASSERT_SUCCESS(s_check_multiple_messages(&tester, aws_byte_cursor_from_buf(&expected_buf), &num_io_messages));
+
+    /* Each message is at most preferred_size bytes, so the data must have spanned at least this many of them.
+     * With the default 16KB messages it would all fit in 2. */
+    ASSERT_TRUE(num_io_messages >= expected_buf.len / preferred_size);
+
+    /* clean up */
+    aws_input_stream_destroy(body_stream);
+    aws_http_message_destroy(request);
+    aws_http_stream_release(stream);
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+
+    aws_byte_buf_clean_up(&body_buf);
+    aws_byte_buf_clean_up(&expected_buf);
+    return AWS_OP_SUCCESS;
+}
+
 /* Send a request whose headers don't fit in a single aws_io_message */
 H1_CLIENT_TEST_CASE(h1_client_request_send_large_head) {
     (void)ctx;
@@ -521,12 +733,17 @@ struct response_tester {
     struct aws_http_header info_headers[100];
     size_t num_info_headers;
 
+    /* trailing headers of a chunked message */
+    struct aws_http_header trailer_headers[100];
+    size_t num_trailers;
+
     struct aws_byte_cursor body;
 
     /* All cursors in response_tester point into here */
     struct aws_byte_buf storage;
 
     size_t on_response_headers_cb_count;
+    size_t on_incoming_trailers_cb_count;
     size_t on_response_header_block_done_cb_count;
     size_t on_response_body_cb_count;
     size_t on_complete_cb_count;
@@ -555,9 +772,14 @@ static int s_response_tester_on_headers(
 
     struct aws_byte_buf *storage = &response->storage;
     const struct aws_http_header *in_header = header_array;
-    struct aws_http_header *my_header = header_block == AWS_HTTP_HEADER_BLOCK_INFORMATIONAL
-                                            ? response->info_headers + response->num_info_headers
-                                            : response->headers + response->num_headers;
+    struct aws_http_header *my_header;
+    if (header_block == AWS_HTTP_HEADER_BLOCK_INFORMATIONAL) {
+        my_header = response->info_headers + response->num_info_headers;
+    } else if (header_block == AWS_HTTP_HEADER_BLOCK_TRAILING) {
+        my_header = response->trailer_headers + response->num_trailers;
+    } else {
+        my_header = response->headers + response->num_headers;
+    }
     for (size_t i = 0; i < num_headers; ++i) {
         /* copy-by-value, then update cursors to point into permanent storage */
         *my_header = *in_header;
@@ -573,6 +795,8 @@ static int s_response_tester_on_headers(
     }
     if (header_block == AWS_HTTP_HEADER_BLOCK_INFORMATIONAL) {
         response->num_info_headers += num_headers;
+    } else if (header_block == AWS_HTTP_HEADER_BLOCK_TRAILING) {
+        response->num_trailers += num_headers;
     } else if (header_block == AWS_HTTP_HEADER_BLOCK_MAIN) {
         response->num_headers += num_headers;
     }
@@ -580,6 +804,21 @@ static int s_response_tester_on_headers(
     return AWS_OP_SUCCESS;
 }
 
+static int s_response_tester_on_trailers(
+    struct aws_http_stream *stream,
+    enum aws_http_header_block header_block,
+    const struct aws_http_header *header_array,
+    size_t num_headers,
+    void *user_data) {
+
+    struct response_tester *response = user_data;
+    AWS_FATAL_ASSERT(header_block == AWS_HTTP_HEADER_BLOCK_TRAILING);
+    response->on_incoming_trailers_cb_count++;
+
+    /* Reuse the header-recording logic, trailers land in trailer_headers */
+    return s_response_tester_on_headers(stream, header_block, header_array, num_headers, user_data);
+}
+
 static int s_response_tester_on_header_block_done(
     struct aws_http_stream *stream,
     enum aws_http_header_block header_block,
@@ -711,6 +950,227 @@ H1_CLIENT_TEST_CASE(h1_client_response_get_1liner) {
     return AWS_OP_SUCCESS;
 }
 
+/* If a final response arrives before the interim 100, the withheld body is never sent.
+ * The request is then shorter than its declared framing, so the connection must not be reused. */
+H1_CLIENT_TEST_CASE(h1_client_request_expect_100_continue_aborts_on_final_response) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    static const struct aws_byte_cursor body = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("write more tests!");
+    struct aws_input_stream *body_stream = aws_input_stream_new_from_cursor(allocator, &body);
+
+    struct aws_http_header headers[] = {
+        {
+            .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Content-Length"),
+            .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("17"),
+        },
+        {
+            .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Expect"),
+            .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("100-continue"),
+        },
+    };
+
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    ASSERT_NOT_NULL(request);
+    ASSERT_SUCCESS(aws_http_message_set_request_method(request, aws_byte_cursor_from_c_str("PUT")));
+    ASSERT_SUCCESS(aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/upload.txt")));
+    aws_http_message_add_header_array(request, headers, AWS_ARRAY_SIZE(headers));
+    aws_http_message_set_body_stream(request, body_stream);
+
+    struct response_tester response;
+    ASSERT_SUCCESS(s_response_tester_init(&response, &tester, request));
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* Only the head should have been written */
+    const char *expected_head = "PUT /upload.txt HTTP/1.1\r\n"
+                                "Content-Length: 17\r\n"
+                                "Expect: 100-continue\r\n"
+                                "\r\n";
+    ASSERT_SUCCESS(testing_channel_check_written_message(&tester.testing_channel, expected_head));
+
+    /* The server rejects the request without asking for the body */
+    ASSERT_SUCCESS(testing_channel_send_response_str(&tester.testing_channel, "HTTP/1.1 403 Forbidden\r\n\r\n"));
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* The stream completes without the body ever being sent */
+    ASSERT_TRUE(response.on_complete_cb_count == 1);
+    ASSERT_TRUE(response.on_complete_error_code == AWS_ERROR_SUCCESS);
+    ASSERT_TRUE(response.status == 403);
+    ASSERT_TRUE(aws_linked_list_empty(testing_channel_get_written_message_queue(&tester.testing_channel)));
+
+    /* The truncated request poisons the connection for further use */
+    ASSERT_FALSE(aws_http_connection_is_open(tester.connection));
+
+    /* clean up */
+    aws_input_stream_destroy(body_stream);
+    aws_http_message_destroy(request);
+    ASSERT_SUCCESS(s_response_tester_clean_up(&response));
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+static void s_on_complete_record_error_code(struct aws_http_stream *stream, int error_code, void *user_data) {
+    (void)stream;
+    int *error_code_storage = user_data;
+    *error_code_storage = error_code;
+}
+
+/* Check that a response body lands directly in the user's sink buffer, with no body callback wired */
+H1_CLIENT_TEST_CASE(h1_client_response_body_sink) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    struct aws_http_message *request = s_new_default_get_request(allocator);
+
+    struct aws_byte_buf sink;
+    ASSERT_SUCCESS(aws_byte_buf_init(&sink, allocator, 4)); /* small, so appending must grow it */
+
+    int completion_error_code = -1;
+
+    struct aws_http_make_request_options opt = {
+        .self_size = sizeof(struct aws_http_make_request_options),
+        .request = request,
+        .response_body_sink = &sink,
+        .on_complete = s_on_complete_record_error_code,
+        .user_data = &completion_error_code,
+    };
+
+    /* setting both sink and body callback is invalid */
+    struct aws_http_make_request_options bad_opt = opt;
+    bad_opt.on_response_body = s_response_tester_on_body;
+    ASSERT_NULL(aws_http_connection_make_request(tester.connection, &bad_opt));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    struct aws_http_stream *stream = aws_http_connection_make_request(tester.connection, &opt);
+    ASSERT_NOT_NULL(stream);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    aws_http_message_destroy(request);
+
+    /* send response in multiple aws_io_message deliveries to exercise repeated appends */
+    ASSERT_SUCCESS(testing_channel_send_response_str(
+        &tester.testing_channel, "HTTP/1.1 200 OK\r\nContent-Length: 9\r\n\r\nCall "));
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+    ASSERT_SUCCESS(testing_channel_send_response_str(&tester.testing_channel, "Momo"));
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* check result */
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, completion_error_code);
+    ASSERT_BIN_ARRAYS_EQUALS("Call Momo", 9, sink.buffer, sink.len);
+
+    /* clean up */
+    aws_http_stream_release(stream);
+    aws_byte_buf_clean_up(&sink);
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* Check that lifecycle timestamps are recorded as the stream progresses */
+H1_CLIENT_TEST_CASE(h1_client_stream_metrics) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    struct aws_http_message *request = s_new_default_get_request(allocator);
+
+    struct response_tester response;
+    ASSERT_SUCCESS(s_response_tester_init(&response, &tester, request));
+
+    /* nothing sent or received yet; only activation should be stamped */
+    struct aws_http_stream_metrics metrics;
+    aws_http_stream_get_metrics(response.stream, &metrics);
+    ASSERT_TRUE(metrics.activated_timestamp_ns != 0);
+    ASSERT_UINT_EQUALS(0, metrics.send_start_timestamp_ns);
+    ASSERT_UINT_EQUALS(0, metrics.receive_start_timestamp_ns);
+    ASSERT_UINT_EQUALS(0, metrics.complete_timestamp_ns);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+    aws_http_message_destroy(request);
+
+    /* request sent, but no response yet */
+    aws_http_stream_get_metrics(response.stream, &metrics);
+    ASSERT_TRUE(metrics.send_start_timestamp_ns != 0);
+    ASSERT_TRUE(metrics.send_end_timestamp_ns >= metrics.send_start_timestamp_ns);
+    ASSERT_UINT_EQUALS(0, metrics.receive_start_timestamp_ns);
+    ASSERT_UINT_EQUALS(0, metrics.complete_timestamp_ns);
+
+    ASSERT_SUCCESS(testing_channel_send_response_str(&tester.testing_channel, "HTTP/1.1 204 No Content\r\n\r\n"));
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    ASSERT_TRUE(response.on_complete_cb_count == 1);
+
+    aws_http_stream_get_metrics(response.stream, &metrics);
+    ASSERT_TRUE(metrics.receive_start_timestamp_ns >= metrics.send_start_timestamp_ns);
+    ASSERT_TRUE(metrics.complete_timestamp_ns >= metrics.receive_start_timestamp_ns);
+
+    /* clean up */
+    ASSERT_SUCCESS(s_response_tester_clean_up(&response));
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* Check that max_pipelined_requests stops further requests from being sent
+ * until earlier responses complete */
+H1_CLIENT_TEST_CASE(h1_client_request_pipeline_depth_limited) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init_ex(
+        &tester,
+        allocator,
+        1 /*max_pipelined_requests*/,
+        0 /*window_update_threshold*/,
+        0 /*preferred_write_size*/,
+        false /*adaptive_window_management*/));
+
+    /* queue 2 requests up front */
+    struct aws_http_message *request = s_new_default_get_request(allocator);
+
+    struct response_tester responses[2];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(responses); ++i) {
+        ASSERT_SUCCESS(s_response_tester_init(&responses[i], &tester, request));
+    }
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* Ensure the request can be destroyed after request is sent */
+    aws_http_message_destroy(request);
+
+    /* with a limit of 1 outstanding response, only the 1st request should have been written */
+    const char *expected = "GET / HTTP/1.1\r\n"
+                           "\r\n";
+    ASSERT_SUCCESS(testing_channel_check_written_message(&tester.testing_channel, expected));
+
+    /* completing the 1st response frees up the pipeline, so the 2nd request should go out */
+    ASSERT_SUCCESS(testing_channel_send_response_str(&tester.testing_channel, "HTTP/1.1 204 No Content\r\n\r\n"));
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    ASSERT_TRUE(responses[0].on_complete_cb_count == 1);
+    ASSERT_TRUE(responses[0].on_complete_error_code == AWS_ERROR_SUCCESS);
+    ASSERT_TRUE(responses[1].on_complete_cb_count == 0);
+    ASSERT_SUCCESS(testing_channel_check_written_message(&tester.testing_channel, expected));
+
+    ASSERT_SUCCESS(testing_channel_send_response_str(&tester.testing_channel, "HTTP/1.1 204 No Content\r\n\r\n"));
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    ASSERT_TRUE(responses[1].on_complete_cb_count == 1);
+    ASSERT_TRUE(responses[1].on_complete_error_code == AWS_ERROR_SUCCESS);
+
+    /* clean up */
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(responses); ++i) {
+        ASSERT_SUCCESS(s_response_tester_clean_up(&responses[i]));
+    }
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
 static int s_check_header(
     struct response_tester *response,
     size_t i,
@@ -810,6 +1270,82 @@ H1_CLIENT_TEST_CASE(h1_client_response_get_body) {
     return AWS_OP_SUCCESS;
 }
 
+static int s_test_response_trailers(struct aws_allocator *allocator, bool use_dedicated_callback) {
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    /* send request */
+    struct aws_http_message *request = s_new_default_get_request(allocator);
+
+    struct aws_http_make_request_options opt;
+    AWS_ZERO_STRUCT(opt);
+    if (use_dedicated_callback) {
+        opt.on_incoming_trailers = s_response_tester_on_trailers;
+    }
+
+    struct response_tester response;
+    ASSERT_SUCCESS(s_response_tester_init_ex(&response, &tester, request, &opt, NULL));
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* Ensure the request can be destroyed after request is sent */
+    aws_http_message_destroy(request);
+
+    /* send chunked response with trailing fields */
+    ASSERT_SUCCESS(testing_channel_send_response_str(
+        &tester.testing_channel,
+        "HTTP/1.1 200 OK\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "3\r\n"
+        "two\r\n"
+        "7\r\n"
+        " chunks\r\n"
+        "0\r\n"
+        "x-amz-checksum-crc32: AAAAAA==\r\n"
+        "Expires: Wed, 21 Oct 2015 07:28:00 GMT\r\n"
+        "\r\n"));
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* check result */
+    ASSERT_TRUE(response.on_complete_cb_count == 1);
+    ASSERT_TRUE(response.on_complete_error_code == AWS_ERROR_SUCCESS);
+    ASSERT_TRUE(response.status == 200);
+    ASSERT_TRUE(response.num_headers == 1);
+    ASSERT_SUCCESS(s_check_header(&response, 0, "Transfer-Encoding", "chunked", false));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&response.body, "two chunks"));
+
+    /* trailers are streamed field-by-field, so the callback fires once per field */
+    if (use_dedicated_callback) {
+        ASSERT_TRUE(response.on_incoming_trailers_cb_count == 2);
+    } else {
+        ASSERT_TRUE(response.on_incoming_trailers_cb_count == 0);
+    }
+
+    ASSERT_TRUE(response.num_trailers == 2);
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str_ignore_case(&response.trailer_headers[0].name, "x-amz-checksum-crc32"));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&response.trailer_headers[0].value, "AAAAAA=="));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str_ignore_case(&response.trailer_headers[1].name, "Expires"));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&response.trailer_headers[1].value, "Wed, 21 Oct 2015 07:28:00 GMT"));
+
+    /* clean up */
+    ASSERT_SUCCESS(s_response_tester_clean_up(&response));
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+H1_CLIENT_TEST_CASE(h1_client_response_trailers_via_dedicated_callback) {
+    (void)ctx;
+    return s_test_response_trailers(allocator, true /*use_dedicated_callback*/);
+}
+
+/* Without on_incoming_trailers, trailers arrive at on_response_headers with the TRAILING block type */
+H1_CLIENT_TEST_CASE(h1_client_response_trailers_fallback_to_headers_callback) {
+    (void)ctx;
+    return s_test_response_trailers(allocator, false /*use_dedicated_callback*/);
+}
+
 static int s_test_expected_no_body_response(struct aws_allocator *allocator, int status_int, bool head_request) {
 
     struct tester tester;
@@ -1273,6 +1809,41 @@ H1_CLIENT_TEST_CASE(h1_client_response_close_header_ends_connection) {
     return AWS_OP_SUCCESS;
 }
 
+/* A response with the "Connection: close" header should mark the connection as draining
+ * as soon as the header is decoded, so a pool can stop vending it before shutdown. */
+H1_CLIENT_TEST_CASE(h1_client_response_close_header_marks_draining) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    /* send request */
+    struct aws_http_message *request = s_new_default_get_request(allocator);
+
+    struct response_tester response;
+    ASSERT_SUCCESS(s_response_tester_init(&response, &tester, request));
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+    aws_http_message_destroy(request);
+
+    ASSERT_FALSE(aws_http_connection_is_draining(tester.connection));
+
+    /* send response */
+    ASSERT_SUCCESS(testing_channel_send_response_str(
+        &tester.testing_channel,
+        "HTTP/1.1 200 OK\r\n"
+        "Connection: close\r\n"
+        "\r\n"));
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    ASSERT_TRUE(aws_http_connection_is_draining(tester.connection));
+
+    /* clean up */
+    ASSERT_SUCCESS(s_response_tester_clean_up(&response));
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
 /* A request with the "Connection: close" header should result in the connection shutting down
  * after the stream completes. */
 H1_CLIENT_TEST_CASE(h1_client_request_close_header_ends_connection) {
@@ -1621,6 +2192,107 @@ H1_CLIENT_TEST_CASE(h1_client_window_manual_update_off_thread) {
     return s_window_update(allocator, false);
 }
 
+/* With a window-update threshold configured, an off-thread update that reaches the threshold
+ * should still result in the full amount being applied to the channel window. */
+H1_CLIENT_TEST_CASE(h1_client_window_coalesced_update_off_thread) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init_ex(
+        &tester,
+        allocator,
+        0 /*max_pipelined_requests*/,
+        6 /*window_update_threshold*/,
+        0 /*preferred_write_size*/,
+        false /*adaptive_window_management*/));
+
+    /* send request */
+    struct aws_http_message *request = s_new_default_get_request(allocator);
+
+    struct response_tester response;
+    ASSERT_SUCCESS(s_response_tester_init(&response, &tester, request));
+    response.stop_auto_window_update = true;
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* Ensure the request can be destroyed after request is sent */
+    aws_http_message_destroy(request);
+
+    /* send response */
+    const char *response_str = "HTTP/1.1 200 OK\r\n"
+                               "Content-Length: 9\r\n"
+                               "\r\n"
+                               "Call Momo";
+    ASSERT_SUCCESS(testing_channel_send_response_str(&tester.testing_channel, response_str));
+
+    /* drain the task queue, in case there's an update window task in there from the headers */
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* An update of 9 crosses the threshold of 6, so the update task should run promptly
+     * and apply the whole pending amount. */
+    testing_channel_set_is_on_users_thread(&tester.testing_channel, false);
+    aws_http_stream_update_window(response.stream, 9);
+    testing_channel_set_is_on_users_thread(&tester.testing_channel, true);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    size_t window_update = testing_channel_last_window_update(&tester.testing_channel);
+    ASSERT_INT_EQUALS(9, window_update);
+
+    /* clean up */
+    ASSERT_SUCCESS(s_response_tester_clean_up(&response));
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* With adaptive window management enabled, manual window updates still reach the channel.
+ * The first credit carries no rate measurement yet, so it must pass through unshaped. */
+H1_CLIENT_TEST_CASE(h1_client_window_adaptive_update_passes_through) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init_ex(
+        &tester,
+        allocator,
+        0 /*max_pipelined_requests*/,
+        0 /*window_update_threshold*/,
+        0 /*preferred_write_size*/,
+        true /*adaptive_window_management*/));
+
+    /* send request */
+    struct aws_http_message *request = s_new_default_get_request(allocator);
+    struct aws_http_make_request_options opt_override = {.manual_window_management = true};
+
+    struct response_tester response;
+    ASSERT_SUCCESS(s_response_tester_init_ex(&response, &tester, request, &opt_override, NULL));
+    response.stop_auto_window_update = true;
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* Ensure the request can be destroyed after request is sent */
+    aws_http_message_destroy(request);
+
+    /* send response */
+    const char *response_str = "HTTP/1.1 200 OK\r\n"
+                               "Content-Length: 9\r\n"
+                               "\r\n"
+                               "Call Momo";
+    ASSERT_SUCCESS(testing_channel_send_response_str(&tester.testing_channel, response_str));
+
+    /* drain the task queue, in case there's an update window task in there from the headers */
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    aws_http_stream_update_window(response.stream, 9);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    size_t window_update = testing_channel_last_window_update(&tester.testing_channel);
+    ASSERT_INT_EQUALS(9, window_update);
+
+    /* clean up */
+    ASSERT_SUCCESS(s_response_tester_clean_up(&response));
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
 static void s_on_complete(struct aws_http_stream *stream, int error_code, void *user_data) {
     (void)stream;
     int *completion_error_code = user_data;
@@ -2382,6 +3054,48 @@ installation_failed:
     return AWS_OP_SUCCESS;
 }
 
+/* The convert API enters passthrough mode without an Upgrade stream (ex: CONNECT tunnels),
+ * after which data must flow through the handler untouched in both directions. */
+H1_CLIENT_TEST_CASE(h1_client_midchannel_via_convert_api) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    ASSERT_SUCCESS(testing_channel_install_downstream_handler(&tester.testing_channel, SIZE_MAX));
+    ASSERT_SUCCESS(aws_http_connection_convert_to_midchannel_handler(tester.connection));
+
+    /* Converting twice is an error */
+    ASSERT_ERROR(AWS_ERROR_INVALID_STATE, aws_http_connection_convert_to_midchannel_handler(tester.connection));
+
+    /* New streams must be rejected */
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    ASSERT_NOT_NULL(request);
+    ASSERT_SUCCESS(aws_http_message_set_request_method(request, aws_http_method_get));
+    ASSERT_SUCCESS(aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/")));
+
+    struct aws_http_make_request_options options = {
+        .self_size = sizeof(options),
+        .request = request,
+    };
+    ASSERT_NULL(aws_http_connection_make_request(tester.connection, &options));
+    aws_http_message_destroy(request);
+
+    /* Read direction: raw bytes pass through to the downstream handler */
+    const char *read_str = "inmyprotocolhttpisjustamemory";
+    ASSERT_SUCCESS(testing_channel_readpush(&tester.testing_channel, read_str));
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+    ASSERT_SUCCESS(testing_channel_check_midchannel_read_messages(&tester.testing_channel, allocator, read_str));
+
+    /* Write direction: raw bytes pass through toward the socket */
+    const char *write_str = "inmyprotocolthereisnoparsing";
+    testing_channel_writepush(&tester.testing_channel, write_str);
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+    ASSERT_SUCCESS(testing_channel_check_written_messages(&tester.testing_channel, allocator, write_str));
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
 H1_CLIENT_TEST_CASE(h1_client_switching_protocols_fails_pending_requests) {
     (void)ctx;
     struct tester tester;
@@ -138,6 +138,7 @@ static void s_common_decoder_setup(
 
     params->alloc = allocator;
     params->scratch_space_initial_size = scratch_space_size;
+    params->max_scratch_size = 0;
     params->is_decoding_requests = type;
     params->user_data = user_data;
     params->vtable.on_header = s_on_header_stub;
@@ -268,6 +269,48 @@ static int s_h1_test_overflow_scratch_space(struct aws_allocator *allocator, voi
     return AWS_OP_SUCCESS;
 }
 
+AWS_TEST_CASE(h1_test_header_line_too_large, s_h1_test_header_line_too_large);
+static int s_h1_test_header_line_too_large(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_test_init(allocator);
+
+    struct aws_byte_cursor msg = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL(
+        "GET / HTTP/1.1\r\n"
+        "x-big-header: 0123456789012345678901234567890123456789012345678901234567890123456789\r\n"
+        "\r\n");
+
+    struct aws_h1_decoder_params params;
+    s_common_decoder_setup(allocator, 16, &params, s_request, NULL);
+    params.max_scratch_size = 64;
+    struct aws_h1_decoder *decoder = aws_h1_decoder_new(&params);
+
+    ASSERT_ERROR(AWS_ERROR_HTTP_HEADER_LINE_TOO_LARGE, aws_h1_decode(decoder, &msg));
+
+    /* The same message split across deliveries must breach the limit too, since the partial
+     * line accumulates in scratch */
+    struct aws_h1_decoder_params split_params;
+    s_common_decoder_setup(allocator, 16, &split_params, s_request, NULL);
+    split_params.max_scratch_size = 64;
+    struct aws_h1_decoder *split_decoder = aws_h1_decoder_new(&split_params);
+
+    msg = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL(
+        "GET / HTTP/1.1\r\n"
+        "x-big-header: 0123456789012345678901234567890123456789012345678901234567890123456789\r\n"
+        "\r\n");
+    int err = AWS_OP_SUCCESS;
+    while (msg.len && !err) {
+        struct aws_byte_cursor chunk = aws_byte_cursor_advance(&msg, 1);
+        err = aws_h1_decode(split_decoder, &chunk);
+    }
+    ASSERT_TRUE(err != AWS_OP_SUCCESS);
+    ASSERT_INT_EQUALS(AWS_ERROR_HTTP_HEADER_LINE_TOO_LARGE, aws_last_error());
+
+    aws_h1_decoder_destroy(decoder);
+    aws_h1_decoder_destroy(split_decoder);
+    s_test_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
 struct s_header_params {
     int index;
     int max_index;
@@ -343,6 +386,85 @@ static int s_h1_test_receive_response_headers(struct aws_allocator *allocator, v
     return AWS_OP_SUCCESS;
 }
 
+struct s_header_value_params {
+    int index;
+    int max_index;
+    int first_error;
+    const char **header_names;
+    const char **header_values;
+};
+
+static int s_got_header_and_value(const struct aws_http_decoded_header *header, void *user_data) {
+    struct s_header_value_params *params = (struct s_header_value_params *)user_data;
+    if (params->index < params->max_index) {
+        if (params->first_error == AWS_OP_SUCCESS) {
+            if (!aws_byte_cursor_eq_c_str(&header->name_data, params->header_names[params->index]) ||
+                !aws_byte_cursor_eq_c_str(&header->value_data, params->header_values[params->index])) {
+                params->first_error = AWS_OP_ERR;
+            }
+        }
+        params->index++;
+    } else {
+        return aws_raise_error(AWS_ERROR_UNKNOWN);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Long header lines (wider than one SIMD stride) with extra colons in the value,
+ * delivered both whole and one byte at a time, should split on the first colon */
+AWS_TEST_CASE(h1_test_receive_long_headers_split_on_first_colon, s_h1_test_receive_long_headers_split_on_first_colon);
+static int s_h1_test_receive_long_headers_split_on_first_colon(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_test_init(allocator);
+    const struct aws_byte_cursor original_msg = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL(
+        "GET / HTTP/1.1\r\n"
+        "Host: amazon.com\r\n"
+        "x-amz-id-2: kLmNoPqRsTuVwXyZ0123456789AbCdEfGhIjKlMnOpQrStUvWxYz0123456789aBcDeF=\r\n"
+        "Last-Modified: Fri, 01 Mar 2019 17:18:55 GMT\r\n"
+        "\r\n");
+
+    const char *header_names[] = {"Host", "x-amz-id-2", "Last-Modified"};
+    const char *header_values[] = {
+        "amazon.com",
+        "kLmNoPqRsTuVwXyZ0123456789AbCdEfGhIjKlMnOpQrStUvWxYz0123456789aBcDeF=",
+        "Fri, 01 Mar 2019 17:18:55 GMT",
+    };
+
+    /* Decode the message whole, then again one byte at a time */
+    for (int pass = 0; pass < 2; ++pass) {
+        struct aws_h1_decoder_params params;
+        struct s_header_value_params header_params;
+        s_common_decoder_setup(allocator, 1024, &params, s_request, &header_params);
+
+        header_params.index = 0;
+        header_params.max_index = AWS_ARRAY_SIZE(header_names);
+        header_params.first_error = AWS_OP_SUCCESS;
+        header_params.header_names = header_names;
+        header_params.header_values = header_values;
+
+        params.vtable.on_header = s_got_header_and_value;
+        struct aws_h1_decoder *decoder = aws_h1_decoder_new(&params);
+
+        struct aws_byte_cursor msg = original_msg;
+        if (pass == 0) {
+            ASSERT_SUCCESS(aws_h1_decode(decoder, &msg));
+        } else {
+            for (size_t i = 0; i < original_msg.len; ++i) {
+                struct aws_byte_cursor chunk = aws_byte_cursor_advance(&msg, 1);
+                ASSERT_SUCCESS(aws_h1_decode(decoder, &chunk));
+            }
+        }
+        ASSERT_SUCCESS(header_params.first_error);
+        ASSERT_INT_EQUALS(header_params.max_index, header_params.index);
+
+        aws_h1_decoder_destroy(decoder);
+    }
+
+    s_test_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
 AWS_TEST_CASE(h1_test_get_transfer_encoding_flags, s_h1_test_get_transfer_encoding_flags);
 static int s_h1_test_get_transfer_encoding_flags(struct aws_allocator *allocator, void *ctx) {
     (void)ctx;
@@ -817,3 +939,111 @@ static int s_h1_test_ignore_chunk_extensions(struct aws_allocator *allocator, vo
     s_test_clean_up();
     return AWS_OP_SUCCESS;
 }
+
+/* Records, for each decoded header, whether its cursors alias the caller's input buffer,
+ * plus a copy of the data for verifying correctness afterwards. */
+struct header_borrow_data {
+    const uint8_t *input_begin;
+    const uint8_t *input_end;
+    size_t num_headers;
+    size_t num_borrowed;
+    uint8_t storage[1024];
+    size_t storage_len;
+    struct aws_byte_cursor names[16];
+    struct aws_byte_cursor values[16];
+};
+
+static bool s_cursor_within(const struct aws_byte_cursor *cursor, const uint8_t *begin, const uint8_t *end) {
+    return cursor->ptr >= begin && cursor->ptr + cursor->len <= end;
+}
+
+static int s_on_header_record_borrow(const struct aws_http_decoded_header *header, void *user_data) {
+    struct header_borrow_data *data = (struct header_borrow_data *)user_data;
+    AWS_ASSERT(data->num_headers < AWS_ARRAY_SIZE(data->names));
+    AWS_ASSERT(data->storage_len + header->name_data.len + header->value_data.len <= sizeof(data->storage));
+
+    if (s_cursor_within(&header->name_data, data->input_begin, data->input_end) &&
+        s_cursor_within(&header->value_data, data->input_begin, data->input_end)) {
+        data->num_borrowed++;
+    }
+
+    uint8_t *name_dst = data->storage + data->storage_len;
+    memcpy(name_dst, header->name_data.ptr, header->name_data.len);
+    data->names[data->num_headers] = aws_byte_cursor_from_array(name_dst, header->name_data.len);
+    data->storage_len += header->name_data.len;
+
+    uint8_t *value_dst = data->storage + data->storage_len;
+    memcpy(value_dst, header->value_data.ptr, header->value_data.len);
+    data->values[data->num_headers] = aws_byte_cursor_from_array(value_dst, header->value_data.len);
+    data->storage_len += header->value_data.len;
+
+    data->num_headers++;
+    return AWS_OP_SUCCESS;
+}
+
+static int s_check_borrowed_headers(const struct header_borrow_data *data) {
+    ASSERT_UINT_EQUALS(2, data->num_headers);
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&data->names[0], "Host"));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&data->values[0], "amazon.com"));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&data->names[1], "Accept-Language"));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&data->values[1], "fr"));
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(h1_test_header_cursors_borrow_input_buffer, s_h1_test_header_cursors_borrow_input_buffer);
+static int s_h1_test_header_cursors_borrow_input_buffer(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_test_init(allocator);
+    struct aws_byte_cursor msg = s_typical_request;
+
+    struct header_borrow_data data;
+    AWS_ZERO_STRUCT(data);
+    data.input_begin = msg.ptr;
+    data.input_end = msg.ptr + msg.len;
+
+    struct aws_h1_decoder_params params;
+    s_common_decoder_setup(allocator, 1024, &params, s_request, &data);
+    params.vtable.on_header = s_on_header_record_borrow;
+    struct aws_h1_decoder *decoder = aws_h1_decoder_new(&params);
+
+    ASSERT_SUCCESS(aws_h1_decode(decoder, &msg));
+
+    /* Headers that arrive whole must be delivered as cursors into the input buffer, not copies */
+    ASSERT_SUCCESS(s_check_borrowed_headers(&data));
+    ASSERT_UINT_EQUALS(2, data.num_borrowed);
+
+    aws_h1_decoder_destroy(decoder);
+    s_test_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(h1_test_header_cursors_copied_when_straddling, s_h1_test_header_cursors_copied_when_straddling);
+static int s_h1_test_header_cursors_copied_when_straddling(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+    s_test_init(allocator);
+    struct aws_byte_cursor msg = s_typical_request;
+
+    struct header_borrow_data data;
+    AWS_ZERO_STRUCT(data);
+    data.input_begin = msg.ptr;
+    data.input_end = msg.ptr + msg.len;
+
+    struct aws_h1_decoder_params params;
+    s_common_decoder_setup(allocator, 1024, &params, s_request, &data);
+    params.vtable.on_header = s_on_header_record_borrow;
+    struct aws_h1_decoder *decoder = aws_h1_decoder_new(&params);
+
+    /* One byte per decode call: every header straddles calls, so every header must be
+     * assembled in scratch and delivered from there rather than from the input buffer */
+    for (size_t i = 0; i < msg.len; ++i) {
+        struct aws_byte_cursor chunk = aws_byte_cursor_advance(&msg, 1);
+        ASSERT_SUCCESS(aws_h1_decode(decoder, &chunk));
+    }
+
+    ASSERT_SUCCESS(s_check_borrowed_headers(&data));
+    ASSERT_UINT_EQUALS(0, data.num_borrowed);
+
+    aws_h1_decoder_destroy(decoder);
+    s_test_clean_up();
+    return AWS_OP_SUCCESS;
+}
@@ -0,0 +1,458 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/h1_encoder.h>
+
+#include <aws/io/stream.h>
+#include <aws/testing/aws_test_harness.h>
+
+#define TEST_CASE(NAME)                                                                                                \
+    AWS_TEST_CASE(NAME, s_test_##NAME);                                                                                \
+    static int s_test_##NAME(struct aws_allocator *allocator, void *ctx)
+
+/* Run an encoder message to completion and capture the full wire bytes */
+static int s_encode_message(
+    struct aws_allocator *allocator,
+    struct aws_h1_encoder_message *message,
+    struct aws_byte_buf *out_buf) {
+
+    struct aws_h1_encoder encoder;
+    aws_h1_encoder_init(&encoder, allocator);
+
+    ASSERT_SUCCESS(aws_h1_encoder_start_message(&encoder, message, NULL));
+    while (aws_h1_encoder_is_message_in_progress(&encoder)) {
+        ASSERT_SUCCESS(aws_h1_encoder_process(&encoder, out_buf));
+    }
+
+    aws_h1_encoder_clean_up(&encoder);
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_http_message *s_new_template_request(struct aws_allocator *allocator) {
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    if (!request) {
+        return NULL;
+    }
+
+    aws_http_message_set_request_method(request, aws_byte_cursor_from_c_str("GET"));
+    aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/index.html"));
+
+    struct aws_http_header headers[] = {
+        {.name = aws_byte_cursor_from_c_str("Host"), .value = aws_byte_cursor_from_c_str("example.com")},
+        {.name = aws_byte_cursor_from_c_str("x-amz-date"), .value = aws_byte_cursor_from_c_str("PLACEHOLDER")},
+        {.name = aws_byte_cursor_from_c_str("Accept"), .value = aws_byte_cursor_from_c_str("*/*")},
+        {.name = aws_byte_cursor_from_c_str("Authorization"), .value = aws_byte_cursor_from_c_str("PLACEHOLDER")},
+    };
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(headers); ++i) {
+        aws_http_message_add_header(request, headers[i]);
+    }
+
+    return request;
+}
+
+TEST_CASE(h1_encoder_template_patches_variable_headers) {
+    (void)ctx;
+
+    struct aws_http_message *request = s_new_template_request(allocator);
+    ASSERT_NOT_NULL(request);
+
+    struct aws_byte_cursor variable_names[] = {
+        aws_byte_cursor_from_c_str("x-amz-date"),
+        aws_byte_cursor_from_c_str("authorization"), /* matching is case-insensitive */
+    };
+
+    struct aws_h1_encoder_message_template message_template;
+    ASSERT_SUCCESS(aws_h1_encoder_message_template_init_from_request(
+        &message_template, allocator, request, variable_names, AWS_ARRAY_SIZE(variable_names)));
+
+    /* The template can outlive the message it was built from */
+    aws_http_message_destroy(request);
+
+    /* Values are supplied in the order the headers appear in the request */
+    struct aws_byte_cursor variable_values[] = {
+        aws_byte_cursor_from_c_str("20190201T000000Z"),
+        aws_byte_cursor_from_c_str("AWS4-HMAC-SHA256 Credential=AKID/20190201"),
+    };
+
+    struct aws_h1_encoder_message message;
+    ASSERT_SUCCESS(aws_h1_encoder_message_init_from_template(
+        &message, allocator, &message_template, variable_values, AWS_ARRAY_SIZE(variable_values), NULL));
+
+    struct aws_byte_buf out_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&out_buf, allocator, 1024));
+    ASSERT_SUCCESS(s_encode_message(allocator, &message, &out_buf));
+
+    const char *expected = "GET /index.html HTTP/1.1\r\n"
+                           "Host: example.com\r\n"
+                           "x-amz-date: 20190201T000000Z\r\n"
+                           "Accept: */*\r\n"
+                           "Authorization: AWS4-HMAC-SHA256 Credential=AKID/20190201\r\n"
+                           "\r\n";
+    ASSERT_BIN_ARRAYS_EQUALS(expected, strlen(expected), out_buf.buffer, out_buf.len);
+
+    aws_byte_buf_clean_up(&out_buf);
+    aws_h1_encoder_message_clean_up(&message);
+
+    /* A second instantiation from the same template must work identically */
+    struct aws_byte_cursor second_values[] = {
+        aws_byte_cursor_from_c_str("20190202T000000Z"),
+        aws_byte_cursor_from_c_str("AWS4-HMAC-SHA256 Credential=AKID/20190202"),
+    };
+
+    ASSERT_SUCCESS(aws_h1_encoder_message_init_from_template(
+        &message, allocator, &message_template, second_values, AWS_ARRAY_SIZE(second_values), NULL));
+
+    ASSERT_SUCCESS(aws_byte_buf_init(&out_buf, allocator, 1024));
+    ASSERT_SUCCESS(s_encode_message(allocator, &message, &out_buf));
+
+    const char *second_expected = "GET /index.html HTTP/1.1\r\n"
+                                  "Host: example.com\r\n"
+                                  "x-amz-date: 20190202T000000Z\r\n"
+                                  "Accept: */*\r\n"
+                                  "Authorization: AWS4-HMAC-SHA256 Credential=AKID/20190202\r\n"
+                                  "\r\n";
+    ASSERT_BIN_ARRAYS_EQUALS(second_expected, strlen(second_expected), out_buf.buffer, out_buf.len);
+
+    aws_byte_buf_clean_up(&out_buf);
+    aws_h1_encoder_message_clean_up(&message);
+    aws_h1_encoder_message_template_clean_up(&message_template);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(h1_encoder_template_variable_content_length) {
+    (void)ctx;
+
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    ASSERT_NOT_NULL(request);
+
+    aws_http_message_set_request_method(request, aws_byte_cursor_from_c_str("PUT"));
+    aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/upload"));
+
+    struct aws_http_header headers[] = {
+        {.name = aws_byte_cursor_from_c_str("Host"), .value = aws_byte_cursor_from_c_str("example.com")},
+        {.name = aws_byte_cursor_from_c_str("Content-Length"), .value = aws_byte_cursor_from_c_str("0")},
+    };
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(headers); ++i) {
+        aws_http_message_add_header(request, headers[i]);
+    }
+
+    struct aws_byte_cursor variable_names[] = {aws_byte_cursor_from_c_str("Content-Length")};
+
+    struct aws_h1_encoder_message_template message_template;
+    ASSERT_SUCCESS(
+        aws_h1_encoder_message_template_init_from_request(&message_template, allocator, request, variable_names, 1));
+
+    aws_http_message_destroy(request);
+
+    struct aws_byte_cursor body_cursor = aws_byte_cursor_from_c_str("hello");
+    struct aws_input_stream *body = aws_input_stream_new_from_cursor(allocator, &body_cursor);
+    ASSERT_NOT_NULL(body);
+
+    struct aws_byte_cursor variable_values[] = {aws_byte_cursor_from_c_str("5")};
+
+    struct aws_h1_encoder_message message;
+    ASSERT_SUCCESS(
+        aws_h1_encoder_message_init_from_template(&message, allocator, &message_template, variable_values, 1, body));
+
+    struct aws_byte_buf out_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&out_buf, allocator, 1024));
+    ASSERT_SUCCESS(s_encode_message(allocator, &message, &out_buf));
+
+    const char *expected = "PUT /upload HTTP/1.1\r\n"
+                           "Host: example.com\r\n"
+                           "Content-Length: 5\r\n"
+                           "\r\n"
+                           "hello";
+    ASSERT_BIN_ARRAYS_EQUALS(expected, strlen(expected), out_buf.buffer, out_buf.len);
+
+    aws_byte_buf_clean_up(&out_buf);
+    aws_h1_encoder_message_clean_up(&message);
+    aws_input_stream_destroy(body);
+    aws_h1_encoder_message_template_clean_up(&message_template);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(h1_encoder_template_errors) {
+    (void)ctx;
+
+    struct aws_http_message *request = s_new_template_request(allocator);
+    ASSERT_NOT_NULL(request);
+
+    /* A variable name that matches no request header is an error */
+    struct aws_byte_cursor missing_name[] = {aws_byte_cursor_from_c_str("x-amz-security-token")};
+
+    struct aws_h1_encoder_message_template message_template;
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_h1_encoder_message_template_init_from_request(&message_template, allocator, request, missing_name, 1));
+
+    /* Supplying the wrong number of values is an error */
+    struct aws_byte_cursor variable_names[] = {aws_byte_cursor_from_c_str("x-amz-date")};
+    ASSERT_SUCCESS(
+        aws_h1_encoder_message_template_init_from_request(&message_template, allocator, request, variable_names, 1));
+
+    struct aws_h1_encoder_message message;
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_h1_encoder_message_init_from_template(&message, allocator, &message_template, NULL, 0, NULL));
+
+    aws_h1_encoder_message_template_clean_up(&message_template);
+    aws_http_message_destroy(request);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(h1_encoder_request_head_caller_storage) {
+    (void)ctx;
+
+    struct aws_http_message *request = s_new_template_request(allocator);
+    ASSERT_NOT_NULL(request);
+
+    const char *expected = "GET /index.html HTTP/1.1\r\n"
+                           "Host: example.com\r\n"
+                           "x-amz-date: PLACEHOLDER\r\n"
+                           "Accept: */*\r\n"
+                           "Authorization: PLACEHOLDER\r\n"
+                           "\r\n";
+
+    /* Storage large enough for the head must be used in place of a fresh allocation */
+    uint8_t storage_array[512];
+    struct aws_byte_buf head_storage = aws_byte_buf_from_empty_array(storage_array, sizeof(storage_array));
+
+    struct aws_h1_encoder_message message;
+    ASSERT_SUCCESS(aws_h1_encoder_message_init_from_request(&message, allocator, request, &head_storage));
+    ASSERT_PTR_EQUALS(storage_array, message.outgoing_head_buf.buffer);
+
+    struct aws_byte_buf out_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&out_buf, allocator, 1024));
+    ASSERT_SUCCESS(s_encode_message(allocator, &message, &out_buf));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, strlen(expected), out_buf.buffer, out_buf.len);
+    aws_byte_buf_clean_up(&out_buf);
+
+    /* clean_up must not try to free the caller's storage */
+    aws_h1_encoder_message_clean_up(&message);
+
+    /* Storage too small for the head must fall back to a heap buffer */
+    uint8_t tiny_array[4];
+    struct aws_byte_buf tiny_storage = aws_byte_buf_from_empty_array(tiny_array, sizeof(tiny_array));
+
+    ASSERT_SUCCESS(aws_h1_encoder_message_init_from_request(&message, allocator, request, &tiny_storage));
+    ASSERT_TRUE(message.outgoing_head_buf.buffer != tiny_array);
+    ASSERT_BIN_ARRAYS_EQUALS(expected, strlen(expected), message.outgoing_head_buf.buffer, message.outgoing_head_buf.len);
+    aws_h1_encoder_message_clean_up(&message);
+
+    /* NULL storage behaves as before */
+    ASSERT_SUCCESS(aws_h1_encoder_message_init_from_request(&message, allocator, request, NULL));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, strlen(expected), message.outgoing_head_buf.buffer, message.outgoing_head_buf.len);
+    aws_h1_encoder_message_clean_up(&message);
+
+    aws_http_message_destroy(request);
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Build a PUT request whose body is assembled from three segments:
+ * borrowed prefix + streamed payload + borrowed trailer */
+static struct aws_http_message *s_new_vectored_request(
+    struct aws_allocator *allocator,
+    struct aws_input_stream *payload,
+    const char *content_length) {
+
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    if (!request) {
+        return NULL;
+    }
+
+    aws_http_message_set_request_method(request, aws_byte_cursor_from_c_str("PUT"));
+    aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/upload"));
+
+    struct aws_http_header headers[] = {
+        {.name = aws_byte_cursor_from_c_str("Host"), .value = aws_byte_cursor_from_c_str("example.com")},
+        {.name = aws_byte_cursor_from_c_str("Content-Length"), .value = aws_byte_cursor_from_c_str(content_length)},
+    };
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(headers); ++i) {
+        aws_http_message_add_header(request, headers[i]);
+    }
+
+    aws_http_message_add_body_segment_cursor(request, aws_byte_cursor_from_c_str("HEAD-"));
+    aws_http_message_add_body_segment_stream(request, payload);
+    aws_http_message_add_body_segment_cursor(request, aws_byte_cursor_from_c_str("-CRC32"));
+
+    return request;
+}
+
+TEST_CASE(h1_encoder_vectored_body) {
+    (void)ctx;
+
+    struct aws_byte_cursor payload_cursor = aws_byte_cursor_from_c_str("payload data");
+    struct aws_input_stream *payload = aws_input_stream_new_from_cursor(allocator, &payload_cursor);
+    ASSERT_NOT_NULL(payload);
+
+    struct aws_http_message *request = s_new_vectored_request(allocator, payload, "23");
+    ASSERT_NOT_NULL(request);
+
+    /* Segments and a plain body stream are mutually exclusive */
+    struct aws_http_message *stream_request = aws_http_message_new_request(allocator);
+    ASSERT_NOT_NULL(stream_request);
+    aws_http_message_set_body_stream(stream_request, payload);
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_STATE,
+        aws_http_message_add_body_segment_cursor(stream_request, aws_byte_cursor_from_c_str("HEAD-")));
+    aws_http_message_destroy(stream_request);
+
+    ASSERT_UINT_EQUALS(3, aws_http_message_get_body_segment_count(request));
+
+    struct aws_h1_encoder_message message;
+    ASSERT_SUCCESS(aws_h1_encoder_message_init_from_request(&message, allocator, request, NULL));
+
+    /* Encode through tiny output buffers, so segment boundaries land mid-message */
+    struct aws_h1_encoder encoder;
+    aws_h1_encoder_init(&encoder, allocator);
+    ASSERT_SUCCESS(aws_h1_encoder_start_message(&encoder, &message, NULL));
+
+    struct aws_byte_buf out_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&out_buf, allocator, 1024));
+
+    while (aws_h1_encoder_is_message_in_progress(&encoder)) {
+        uint8_t storage[16];
+        struct aws_byte_buf small_buf = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+        ASSERT_SUCCESS(aws_h1_encoder_process(&encoder, &small_buf));
+        ASSERT_TRUE(aws_byte_buf_write(&out_buf, small_buf.buffer, small_buf.len));
+    }
+    aws_h1_encoder_clean_up(&encoder);
+
+    const char *expected = "PUT /upload HTTP/1.1\r\n"
+                           "Host: example.com\r\n"
+                           "Content-Length: 23\r\n"
+                           "\r\n"
+                           "HEAD-payload data-CRC32";
+    ASSERT_BIN_ARRAYS_EQUALS(expected, strlen(expected), out_buf.buffer, out_buf.len);
+
+    aws_byte_buf_clean_up(&out_buf);
+    aws_h1_encoder_message_clean_up(&message);
+    aws_http_message_destroy(request);
+    aws_input_stream_destroy(payload);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(h1_encoder_vectored_body_length_checked) {
+    (void)ctx;
+
+    struct aws_byte_cursor payload_cursor = aws_byte_cursor_from_c_str("payload data");
+    struct aws_input_stream *payload = aws_input_stream_new_from_cursor(allocator, &payload_cursor);
+    ASSERT_NOT_NULL(payload);
+
+    /* Body is 23 bytes, so a larger Content-Length must fail once the segments run dry */
+    struct aws_http_message *request = s_new_vectored_request(allocator, payload, "99");
+    ASSERT_NOT_NULL(request);
+
+    struct aws_h1_encoder_message message;
+    ASSERT_SUCCESS(aws_h1_encoder_message_init_from_request(&message, allocator, request, NULL));
+
+    struct aws_h1_encoder encoder;
+    aws_h1_encoder_init(&encoder, allocator);
+    ASSERT_SUCCESS(aws_h1_encoder_start_message(&encoder, &message, NULL));
+
+    struct aws_byte_buf out_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&out_buf, allocator, 1024));
+
+    int err = AWS_OP_SUCCESS;
+    while (aws_h1_encoder_is_message_in_progress(&encoder)) {
+        err = aws_h1_encoder_process(&encoder, &out_buf);
+        if (err) {
+            break;
+        }
+    }
+    ASSERT_ERROR(AWS_ERROR_HTTP_OUTGOING_STREAM_LENGTH_INCORRECT, err);
+
+    aws_h1_encoder_clean_up(&encoder);
+    aws_byte_buf_clean_up(&out_buf);
+    aws_h1_encoder_message_clean_up(&message);
+    aws_http_message_destroy(request);
+    aws_input_stream_destroy(payload);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(h1_encoder_response_line_cache_matches_formatting) {
+    (void)ctx;
+
+    /* 200 takes the pre-rendered response-line path, 201 takes the formatted path;
+     * both must produce the same shape of wire bytes */
+    const int statuses[] = {200, 201, 404, 500, 302};
+    const char *expected[] = {
+        "HTTP/1.1 200 OK\r\nServer: unit-test\r\n\r\n",
+        "HTTP/1.1 201 Created\r\nServer: unit-test\r\n\r\n",
+        "HTTP/1.1 404 Not Found\r\nServer: unit-test\r\n\r\n",
+        "HTTP/1.1 500 Internal Server Error\r\nServer: unit-test\r\n\r\n",
+        "HTTP/1.1 302 Found\r\nServer: unit-test\r\n\r\n",
+    };
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(statuses); ++i) {
+        struct aws_http_message *response = aws_http_message_new_response(allocator);
+        ASSERT_NOT_NULL(response);
+        ASSERT_SUCCESS(aws_http_message_set_response_status(response, statuses[i]));
+
+        struct aws_http_header server_header = {
+            .name = aws_byte_cursor_from_c_str("Server"),
+            .value = aws_byte_cursor_from_c_str("unit-test"),
+        };
+        ASSERT_SUCCESS(aws_http_message_add_header(response, server_header));
+
+        struct aws_h1_encoder_message message;
+        ASSERT_SUCCESS(
+            aws_h1_encoder_message_init_from_response(&message, allocator, response, true /*body_headers_ignored*/));
+
+        struct aws_byte_buf out_buf;
+        ASSERT_SUCCESS(aws_byte_buf_init(&out_buf, allocator, 256));
+        ASSERT_SUCCESS(s_encode_message(allocator, &message, &out_buf));
+
+        ASSERT_BIN_ARRAYS_EQUALS(expected[i], strlen(expected[i]), out_buf.buffer, out_buf.len);
+
+        aws_byte_buf_clean_up(&out_buf);
+        aws_h1_encoder_message_clean_up(&message);
+        aws_http_message_destroy(response);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(h1_encoder_cached_date) {
+    (void)ctx;
+    (void)allocator;
+
+    struct aws_byte_cursor date_a;
+    ASSERT_SUCCESS(aws_h1_encoder_cached_date(&date_a));
+
+    /* RFC1123 dates are fixed-width: "Tue, 15 Nov 1994 08:12:31 GMT" */
+    ASSERT_UINT_EQUALS(29, date_a.len);
+    ASSERT_TRUE(date_a.ptr[3] == ',' && date_a.ptr[4] == ' ');
+    struct aws_byte_cursor gmt_suffix = aws_byte_cursor_from_c_str(" GMT");
+    struct aws_byte_cursor date_a_end = date_a;
+    aws_byte_cursor_advance(&date_a_end, date_a.len - gmt_suffix.len);
+    ASSERT_TRUE(aws_byte_cursor_eq(&date_a_end, &gmt_suffix));
+
+    /* A second call within the same second must hand back the identical cached bytes */
+    struct aws_byte_cursor date_b;
+    ASSERT_SUCCESS(aws_h1_encoder_cached_date(&date_b));
+    if (date_b.ptr == date_a.ptr) {
+        ASSERT_TRUE(aws_byte_cursor_eq(&date_a, &date_b));
+    }
+
+    return AWS_OP_SUCCESS;
+}
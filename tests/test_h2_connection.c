@@ -0,0 +1,741 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/h2_connection.h>
+#include <aws/http/private/h2_frames.h>
+#include <aws/http/request_response.h>
+
+#include <aws/common/thread.h>
+#include <aws/io/logging.h>
+#include <aws/io/stream.h>
+#include <aws/testing/io_testing_channel.h>
+
+#if _MSC_VER
+#    pragma warning(disable : 4204) /* non-constant aggregate initializer */
+#endif
+
+#define H2_CONNECTION_TEST_CASE(NAME)                                                                                  \
+    AWS_TEST_CASE(NAME, s_test_##NAME);                                                                                \
+    static int s_test_##NAME(struct aws_allocator *allocator, void *ctx)
+
+static const struct aws_byte_cursor s_preface_magic =
+    AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n");
+
+struct tester {
+    struct aws_allocator *alloc;
+    struct testing_channel testing_channel;
+    struct aws_http_connection *connection;
+    struct aws_logger logger;
+};
+
+static int s_tester_init_ex(
+    struct tester *tester,
+    struct aws_allocator *alloc,
+    uint64_t ping_period_ms,
+    uint64_t ping_timeout_ms) {
+    aws_http_library_init(alloc);
+
+    AWS_ZERO_STRUCT(*tester);
+
+    tester->alloc = alloc;
+
+    struct aws_logger_standard_options logger_options = {
+        .level = AWS_LOG_LEVEL_TRACE,
+        .file = stderr,
+    };
+    ASSERT_SUCCESS(aws_logger_init_standard(&tester->logger, tester->alloc, &logger_options));
+    aws_logger_set(&tester->logger);
+
+    ASSERT_SUCCESS(testing_channel_init(&tester->testing_channel, alloc));
+
+    tester->connection = aws_http_connection_new_http2_client(alloc, SIZE_MAX, ping_period_ms, ping_timeout_ms);
+    ASSERT_NOT_NULL(tester->connection);
+
+    struct aws_channel_slot *slot = aws_channel_slot_new(tester->testing_channel.channel);
+    ASSERT_NOT_NULL(slot);
+    tester->connection->channel_slot = slot;
+    ASSERT_SUCCESS(aws_channel_slot_insert_end(tester->testing_channel.channel, slot));
+    ASSERT_SUCCESS(aws_channel_slot_set_handler(slot, &tester->connection->channel_handler));
+
+    aws_channel_acquire_hold(tester->testing_channel.channel);
+
+    testing_channel_drain_queued_tasks(&tester->testing_channel);
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_tester_init(struct tester *tester, struct aws_allocator *alloc) {
+    return s_tester_init_ex(tester, alloc, 0 /*ping_period_ms*/, 0 /*ping_timeout_ms*/);
+}
+
+static int s_tester_clean_up(struct tester *tester) {
+    aws_http_connection_release(tester->connection);
+    ASSERT_SUCCESS(testing_channel_clean_up(&tester->testing_channel));
+    aws_http_library_clean_up();
+    aws_logger_clean_up(&tester->logger);
+    return AWS_OP_SUCCESS;
+}
+
+/* Pop every written aws_io_message and concatenate the bytes */
+static int s_collect_written_bytes(struct tester *tester, struct aws_byte_buf *out) {
+    ASSERT_SUCCESS(aws_byte_buf_init(out, tester->alloc, 1024));
+
+    struct aws_linked_list *msgs = testing_channel_get_written_message_queue(&tester->testing_channel);
+    while (!aws_linked_list_empty(msgs)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(msgs);
+        struct aws_io_message *msg = AWS_CONTAINER_OF(node, struct aws_io_message, queueing_handle);
+
+        struct aws_byte_cursor msg_cursor = aws_byte_cursor_from_buf(&msg->message_data);
+        if (out->capacity - out->len < msg_cursor.len) {
+            ASSERT_SUCCESS(aws_byte_buf_reserve(out, out->len + msg_cursor.len));
+        }
+        ASSERT_TRUE(aws_byte_buf_write_from_whole_cursor(out, msg_cursor));
+
+        aws_mem_release(msg->allocator, msg);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* Reads the 9-byte frame prefix at the cursor and steps over the whole frame */
+static int s_next_frame(
+    struct aws_byte_cursor *wire,
+    uint8_t *out_type,
+    uint8_t *out_flags,
+    uint32_t *out_stream_id,
+    size_t *out_payload_len) {
+
+    ASSERT_TRUE(wire->len >= 9);
+    size_t payload_len = ((size_t)wire->ptr[0] << 16) | ((size_t)wire->ptr[1] << 8) | (size_t)wire->ptr[2];
+    *out_type = wire->ptr[3];
+    *out_flags = wire->ptr[4];
+    *out_stream_id = ((uint32_t)(wire->ptr[5] & 0x7F) << 24) | ((uint32_t)wire->ptr[6] << 16) |
+                     ((uint32_t)wire->ptr[7] << 8) | (uint32_t)wire->ptr[8];
+    if (out_payload_len) {
+        *out_payload_len = payload_len;
+    }
+
+    ASSERT_TRUE(wire->len >= 9 + payload_len);
+    aws_byte_cursor_advance(wire, 9 + payload_len);
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_http_message *s_new_default_get_request(struct aws_allocator *allocator) {
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    AWS_FATAL_ASSERT(request);
+    AWS_FATAL_ASSERT(AWS_OP_SUCCESS == aws_http_message_set_request_method(request, aws_http_method_get));
+    AWS_FATAL_ASSERT(AWS_OP_SUCCESS == aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/")));
+
+    struct aws_http_header host = {
+        .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Host"),
+        .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("example.com"),
+    };
+    AWS_FATAL_ASSERT(AWS_OP_SUCCESS == aws_http_message_add_header(request, host));
+
+    return request;
+}
+
+/* Check that we can set up and tear down the `tester` used by all other tests in this file */
+H2_CONNECTION_TEST_CASE(h2_client_sanity_check) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* The first bytes on the wire must be the preface magic and a SETTINGS frame,
+ * followed by the request's HEADERS frame [RFC-7540 3.5] */
+H2_CONNECTION_TEST_CASE(h2_client_request_sends_preface_and_headers) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    struct aws_http_make_request_options opt = {
+        .self_size = sizeof(opt),
+        .request = s_new_default_get_request(allocator),
+    };
+    struct aws_http_stream *stream = aws_http_connection_make_request(tester.connection, &opt);
+    ASSERT_NOT_NULL(stream);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    struct aws_byte_buf written;
+    ASSERT_SUCCESS(s_collect_written_bytes(&tester, &written));
+    struct aws_byte_cursor wire = aws_byte_cursor_from_buf(&written);
+
+    /* Preface magic */
+    ASSERT_TRUE(wire.len >= s_preface_magic.len);
+    struct aws_byte_cursor magic = aws_byte_cursor_advance(&wire, s_preface_magic.len);
+    ASSERT_TRUE(aws_byte_cursor_eq(&magic, &s_preface_magic));
+
+    uint8_t type;
+    uint8_t flags;
+    uint32_t stream_id;
+
+    /* Our initial SETTINGS */
+    ASSERT_SUCCESS(s_next_frame(&wire, &type, &flags, &stream_id, NULL));
+    ASSERT_UINT_EQUALS(AWS_H2_FRAME_T_SETTINGS, type);
+    ASSERT_UINT_EQUALS(0, stream_id);
+
+    /* The request's HEADERS frame: self-contained, and END_STREAM since a GET has no body */
+    ASSERT_SUCCESS(s_next_frame(&wire, &type, &flags, &stream_id, NULL));
+    ASSERT_UINT_EQUALS(AWS_H2_FRAME_T_HEADERS, type);
+    ASSERT_UINT_EQUALS(1, stream_id);
+    ASSERT_UINT_EQUALS(AWS_H2_FRAME_F_END_STREAM, flags & AWS_H2_FRAME_F_END_STREAM);
+    ASSERT_UINT_EQUALS(AWS_H2_FRAME_F_END_HEADERS, flags & AWS_H2_FRAME_F_END_HEADERS);
+
+    ASSERT_UINT_EQUALS(0, wire.len);
+
+    aws_byte_buf_clean_up(&written);
+    aws_http_message_destroy(opt.request);
+    aws_http_stream_release(stream);
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+struct response_tester {
+    size_t num_header_blocks_done;
+    size_t on_complete_count;
+    int on_complete_error_code;
+};
+
+static void s_on_header_block_done(struct aws_http_stream *stream, bool has_body, void *user_data) {
+    (void)stream;
+    (void)has_body;
+    struct response_tester *response = user_data;
+    response->num_header_blocks_done++;
+}
+
+static void s_on_complete(struct aws_http_stream *stream, int error_code, void *user_data) {
+    (void)stream;
+    struct response_tester *response = user_data;
+    response->on_complete_count++;
+    response->on_complete_error_code = error_code;
+}
+
+/* Push a server response HEADERS frame (END_HEADERS | END_STREAM) into the channel,
+ * it must be routed to the stream and complete it successfully */
+H2_CONNECTION_TEST_CASE(h2_client_response_completes_stream) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    struct response_tester response;
+    AWS_ZERO_STRUCT(response);
+
+    struct aws_http_make_request_options opt = {
+        .self_size = sizeof(opt),
+        .request = s_new_default_get_request(allocator),
+        .user_data = &response,
+        .on_response_header_block_done = s_on_header_block_done,
+        .on_complete = s_on_complete,
+    };
+    struct aws_http_stream *stream = aws_http_connection_make_request(tester.connection, &opt);
+    ASSERT_NOT_NULL(stream);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* Encode a response HEADERS frame for stream 1. The test encoder's HPACK context is
+     * independent of the connection's decoder context, both start from an empty dynamic table. */
+    struct aws_h2_frame_encoder encoder;
+    ASSERT_SUCCESS(aws_h2_frame_encoder_init(&encoder, allocator));
+
+    struct aws_h2_frame_headers response_frame;
+    ASSERT_SUCCESS(aws_h2_frame_headers_init(&response_frame, allocator));
+    response_frame.header.stream_id = 1;
+    response_frame.end_headers = true;
+    response_frame.end_stream = true;
+
+    struct aws_h2_frame_header_field status_field = {
+        .header =
+            {
+                .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL(":status"),
+                .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("200"),
+            },
+    };
+    ASSERT_SUCCESS(aws_array_list_push_back(&response_frame.header_block.header_fields, &status_field));
+
+    struct aws_byte_buf response_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&response_buf, allocator, 1024));
+    ASSERT_SUCCESS(aws_h2_frame_headers_encode(&response_frame, &encoder, &response_buf));
+    aws_h2_frame_headers_clean_up(&response_frame);
+    aws_h2_frame_encoder_clean_up(&encoder);
+
+    struct aws_io_message *msg = aws_channel_acquire_message_from_pool(
+        tester.testing_channel.channel, AWS_IO_MESSAGE_APPLICATION_DATA, response_buf.len);
+    ASSERT_NOT_NULL(msg);
+    ASSERT_TRUE(aws_byte_buf_write_from_whole_cursor(&msg->message_data, aws_byte_cursor_from_buf(&response_buf)));
+    ASSERT_SUCCESS(testing_channel_push_read_message(&tester.testing_channel, msg));
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* Stream must have received its header block and completed cleanly */
+    ASSERT_UINT_EQUALS(1, response.num_header_blocks_done);
+    ASSERT_UINT_EQUALS(1, response.on_complete_count);
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, response.on_complete_error_code);
+
+    aws_byte_buf_clean_up(&response_buf);
+    aws_http_message_destroy(opt.request);
+    aws_http_stream_release(stream);
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* After receiving enough DATA to consume half its advertised windows, the connection must
+ * replenish them with WINDOW_UPDATE frames, and must send a PING to sample the RTT for
+ * window auto-tuning. */
+H2_CONNECTION_TEST_CASE(h2_client_replenishes_flow_control_windows) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    struct aws_http_make_request_options opt = {
+        .self_size = sizeof(opt),
+        .request = s_new_default_get_request(allocator),
+    };
+    struct aws_http_stream *stream = aws_http_connection_make_request(tester.connection, &opt);
+    ASSERT_NOT_NULL(stream);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* Flush the preface and request frames, they're not under test here */
+    struct aws_byte_buf written;
+    ASSERT_SUCCESS(s_collect_written_bytes(&tester, &written));
+    aws_byte_buf_clean_up(&written);
+
+    struct aws_h2_frame_encoder encoder;
+    ASSERT_SUCCESS(aws_h2_frame_encoder_init(&encoder, allocator));
+
+    /* Response HEADERS, then DATA totalling more than half the 65535-byte initial window */
+    struct aws_h2_frame_headers response_frame;
+    ASSERT_SUCCESS(aws_h2_frame_headers_init(&response_frame, allocator));
+    response_frame.header.stream_id = 1;
+    response_frame.end_headers = true;
+
+    struct aws_h2_frame_header_field status_field = {
+        .header =
+            {
+                .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL(":status"),
+                .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("200"),
+            },
+    };
+    ASSERT_SUCCESS(aws_array_list_push_back(&response_frame.header_block.header_fields, &status_field));
+
+    struct aws_byte_buf frame_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&frame_buf, allocator, 16384));
+    ASSERT_SUCCESS(aws_h2_frame_headers_encode(&response_frame, &encoder, &frame_buf));
+    aws_h2_frame_headers_clean_up(&response_frame);
+
+    struct aws_io_message *msg = aws_channel_acquire_message_from_pool(
+        tester.testing_channel.channel, AWS_IO_MESSAGE_APPLICATION_DATA, frame_buf.len);
+    ASSERT_NOT_NULL(msg);
+    ASSERT_TRUE(aws_byte_buf_write_from_whole_cursor(&msg->message_data, aws_byte_cursor_from_buf(&frame_buf)));
+    ASSERT_SUCCESS(testing_channel_push_read_message(&tester.testing_channel, msg));
+
+    enum { DATA_FRAME_SIZE = 12000, NUM_DATA_FRAMES = 3 };
+    struct aws_byte_buf data_payload;
+    ASSERT_SUCCESS(aws_byte_buf_init(&data_payload, allocator, DATA_FRAME_SIZE));
+    memset(data_payload.buffer, 'z', DATA_FRAME_SIZE);
+    data_payload.len = DATA_FRAME_SIZE;
+
+    for (int i = 0; i < NUM_DATA_FRAMES; ++i) {
+        struct aws_h2_frame_data data_frame;
+        ASSERT_SUCCESS(aws_h2_frame_data_init(&data_frame, allocator));
+        data_frame.header.stream_id = 1;
+        data_frame.data = aws_byte_cursor_from_buf(&data_payload);
+
+        frame_buf.len = 0;
+        ASSERT_SUCCESS(aws_h2_frame_data_encode(&data_frame, &encoder, &frame_buf));
+        aws_h2_frame_data_clean_up(&data_frame);
+
+        msg = aws_channel_acquire_message_from_pool(
+            tester.testing_channel.channel, AWS_IO_MESSAGE_APPLICATION_DATA, frame_buf.len);
+        ASSERT_NOT_NULL(msg);
+        ASSERT_TRUE(aws_byte_buf_write_from_whole_cursor(&msg->message_data, aws_byte_cursor_from_buf(&frame_buf)));
+        ASSERT_SUCCESS(testing_channel_push_read_message(&tester.testing_channel, msg));
+    }
+
+    aws_h2_frame_encoder_clean_up(&encoder);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    ASSERT_SUCCESS(s_collect_written_bytes(&tester, &written));
+    struct aws_byte_cursor wire = aws_byte_cursor_from_buf(&written);
+
+    bool saw_connection_window_update = false;
+    bool saw_stream_window_update = false;
+    bool saw_rtt_ping = false;
+    while (wire.len > 0) {
+        uint8_t type;
+        uint8_t flags;
+        uint32_t stream_id;
+        ASSERT_SUCCESS(s_next_frame(&wire, &type, &flags, &stream_id, NULL));
+        if (type == AWS_H2_FRAME_T_WINDOW_UPDATE && stream_id == 0) {
+            saw_connection_window_update = true;
+        } else if (type == AWS_H2_FRAME_T_WINDOW_UPDATE && stream_id == 1) {
+            saw_stream_window_update = true;
+        } else if (type == AWS_H2_FRAME_T_PING && !(flags & AWS_H2_FRAME_F_ACK)) {
+            saw_rtt_ping = true;
+        }
+    }
+
+    ASSERT_TRUE(saw_connection_window_update);
+    ASSERT_TRUE(saw_stream_window_update);
+    ASSERT_TRUE(saw_rtt_ping);
+
+    /* No RTT sample has completed, so the stats should still show the initial target */
+    struct aws_http2_window_stats stats;
+    aws_h2_connection_get_window_stats(tester.connection, &stats);
+    ASSERT_UINT_EQUALS(65535, stats.window_target);
+
+    aws_byte_buf_clean_up(&data_payload);
+    aws_byte_buf_clean_up(&frame_buf);
+    aws_byte_buf_clean_up(&written);
+    aws_http_message_destroy(opt.request);
+    aws_http_stream_release(stream);
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_http_message *s_new_put_request(struct aws_allocator *allocator, struct aws_input_stream *body) {
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    AWS_FATAL_ASSERT(request);
+    AWS_FATAL_ASSERT(AWS_OP_SUCCESS == aws_http_message_set_request_method(request, aws_byte_cursor_from_c_str("PUT")));
+    AWS_FATAL_ASSERT(AWS_OP_SUCCESS == aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/")));
+
+    struct aws_http_header host = {
+        .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Host"),
+        .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("example.com"),
+    };
+    AWS_FATAL_ASSERT(AWS_OP_SUCCESS == aws_http_message_add_header(request, host));
+    aws_http_message_set_body_stream(request, body);
+
+    return request;
+}
+
+/* Two streams upload concurrently with an 8x weight difference. After one scheduler pass,
+ * the heavy stream must have sent proportionally more DATA bytes than the light one. */
+H2_CONNECTION_TEST_CASE(h2_client_data_scheduler_respects_weights) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    /* Bodies big enough that neither stream can finish in a single pass */
+    enum { BODY_SIZE = 16384 };
+    struct aws_byte_buf body_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&body_buf, allocator, BODY_SIZE));
+    memset(body_buf.buffer, 'z', BODY_SIZE);
+    body_buf.len = BODY_SIZE;
+    struct aws_byte_cursor body_cursor = aws_byte_cursor_from_buf(&body_buf);
+
+    struct aws_input_stream *body_light = aws_input_stream_new_from_cursor(allocator, &body_cursor);
+    ASSERT_NOT_NULL(body_light);
+    struct aws_input_stream *body_heavy = aws_input_stream_new_from_cursor(allocator, &body_cursor);
+    ASSERT_NOT_NULL(body_heavy);
+
+    struct aws_http_make_request_options opt_light = {
+        .self_size = sizeof(opt_light),
+        .request = s_new_put_request(allocator, body_light),
+        .stream_weight = 8,
+    };
+    struct aws_http_stream *stream_light = aws_http_connection_make_request(tester.connection, &opt_light);
+    ASSERT_NOT_NULL(stream_light);
+
+    struct aws_http_make_request_options opt_heavy = {
+        .self_size = sizeof(opt_heavy),
+        .request = s_new_put_request(allocator, body_heavy),
+        .stream_weight = 64,
+    };
+    struct aws_http_stream *stream_heavy = aws_http_connection_make_request(tester.connection, &opt_heavy);
+    ASSERT_NOT_NULL(stream_heavy);
+
+    /* First tick sends the preface and both HEADERS frames, second tick is the first DATA pass */
+    testing_channel_run_currently_queued_tasks(&tester.testing_channel);
+    testing_channel_run_currently_queued_tasks(&tester.testing_channel);
+
+    struct aws_byte_buf written;
+    ASSERT_SUCCESS(s_collect_written_bytes(&tester, &written));
+    struct aws_byte_cursor wire = aws_byte_cursor_from_buf(&written);
+
+    ASSERT_TRUE(wire.len >= s_preface_magic.len);
+    aws_byte_cursor_advance(&wire, s_preface_magic.len);
+
+    /* Streams are created in order, so the light stream is id 1 and the heavy stream id 3 */
+    size_t data_bytes_light = 0;
+    size_t data_bytes_heavy = 0;
+    while (wire.len > 0) {
+        uint8_t type;
+        uint8_t flags;
+        uint32_t stream_id;
+        size_t payload_len;
+        ASSERT_SUCCESS(s_next_frame(&wire, &type, &flags, &stream_id, &payload_len));
+        if (type == AWS_H2_FRAME_T_DATA) {
+            if (stream_id == 1) {
+                data_bytes_light += payload_len;
+            } else if (stream_id == 3) {
+                data_bytes_heavy += payload_len;
+            }
+        }
+    }
+
+    /* The 8x weight ratio should show up in the byte counts. Assert a conservative 4x so the
+     * test doesn't depend on the scheduler's exact quantum. */
+    ASSERT_TRUE(data_bytes_light > 0);
+    ASSERT_TRUE(data_bytes_heavy >= 4 * data_bytes_light);
+
+    aws_http_message_destroy(opt_light.request);
+    aws_http_message_destroy(opt_heavy.request);
+    aws_input_stream_destroy(body_light);
+    aws_input_stream_destroy(body_heavy);
+    aws_http_stream_release(stream_light);
+    aws_http_stream_release(stream_heavy);
+    aws_byte_buf_clean_up(&body_buf);
+    aws_byte_buf_clean_up(&written);
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* After the keepalive period passes on an active connection, a PING probe must go out;
+ * acking it must populate the smoothed-RTT estimate. */
+H2_CONNECTION_TEST_CASE(h2_client_keepalive_ping_and_rtt) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init_ex(&tester, allocator, 20 /*ping_period_ms*/, 1000 /*ping_timeout_ms*/));
+
+    /* Activity arms the keepalive */
+    struct aws_http_make_request_options opt = {
+        .self_size = sizeof(opt),
+        .request = s_new_default_get_request(allocator),
+    };
+    struct aws_http_stream *stream = aws_http_connection_make_request(tester.connection, &opt);
+    ASSERT_NOT_NULL(stream);
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* Flush the preface and request frames, they're not under test here */
+    struct aws_byte_buf written;
+    ASSERT_SUCCESS(s_collect_written_bytes(&tester, &written));
+    aws_byte_buf_clean_up(&written);
+
+    /* Let the period elapse, then scan for the probe */
+    uint8_t ping_payload[AWS_H2_PING_DATA_SIZE];
+    bool saw_keepalive_ping = false;
+    for (size_t attempt = 0; attempt < 10 && !saw_keepalive_ping; ++attempt) {
+        aws_thread_current_sleep(25 * 1000 * 1000); /* 25ms */
+        testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+        ASSERT_SUCCESS(s_collect_written_bytes(&tester, &written));
+        struct aws_byte_cursor wire = aws_byte_cursor_from_buf(&written);
+        while (wire.len > 0) {
+            struct aws_byte_cursor frame_start = wire;
+            uint8_t type;
+            uint8_t flags;
+            uint32_t stream_id;
+            size_t payload_len;
+            ASSERT_SUCCESS(s_next_frame(&wire, &type, &flags, &stream_id, &payload_len));
+            if (type == AWS_H2_FRAME_T_PING && !(flags & AWS_H2_FRAME_F_ACK)) {
+                ASSERT_UINT_EQUALS(AWS_H2_PING_DATA_SIZE, payload_len);
+                memcpy(ping_payload, frame_start.ptr + 9, AWS_H2_PING_DATA_SIZE);
+                saw_keepalive_ping = true;
+            }
+        }
+        aws_byte_buf_clean_up(&written);
+    }
+    ASSERT_TRUE(saw_keepalive_ping);
+
+    /* Ack the probe; the round-trip must show up as a smoothed RTT sample */
+    struct aws_byte_buf ack_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&ack_buf, allocator, 32));
+    ASSERT_SUCCESS(aws_h2_frame_ping_encode_direct(true /*ack*/, ping_payload, &ack_buf));
+
+    struct aws_io_message *msg = aws_channel_acquire_message_from_pool(
+        tester.testing_channel.channel, AWS_IO_MESSAGE_APPLICATION_DATA, ack_buf.len);
+    ASSERT_NOT_NULL(msg);
+    ASSERT_TRUE(aws_byte_buf_write_from_whole_cursor(&msg->message_data, aws_byte_cursor_from_buf(&ack_buf)));
+    ASSERT_SUCCESS(testing_channel_push_read_message(&tester.testing_channel, msg));
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    struct aws_http2_window_stats stats;
+    aws_h2_connection_get_window_stats(tester.connection, &stats);
+    ASSERT_TRUE(stats.rtt_ns > 0);
+
+    /* An answered probe must not kill the connection */
+    ASSERT_TRUE(aws_http_connection_is_open(tester.connection));
+
+    aws_byte_buf_clean_up(&ack_buf);
+    aws_http_message_destroy(opt.request);
+    aws_http_stream_release(stream);
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* A probe that's never acked must close the connection, so the connection manager
+ * evicts it instead of vending a dead connection. */
+H2_CONNECTION_TEST_CASE(h2_client_keepalive_timeout_closes_connection) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init_ex(&tester, allocator, 10 /*ping_period_ms*/, 20 /*ping_timeout_ms*/));
+
+    /* Activity arms the keepalive; the "server" never acks the resulting probe */
+    struct aws_http_make_request_options opt = {
+        .self_size = sizeof(opt),
+        .request = s_new_default_get_request(allocator),
+    };
+    struct aws_http_stream *stream = aws_http_connection_make_request(tester.connection, &opt);
+    ASSERT_NOT_NULL(stream);
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    for (size_t attempt = 0; attempt < 50 && aws_http_connection_is_open(tester.connection); ++attempt) {
+        aws_thread_current_sleep(15 * 1000 * 1000); /* 15ms */
+        testing_channel_drain_queued_tasks(&tester.testing_channel);
+    }
+
+    ASSERT_FALSE(aws_http_connection_is_open(tester.connection));
+
+    aws_http_message_destroy(opt.request);
+    aws_http_stream_release(stream);
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* A graceful GOAWAY (NO_ERROR) must drain the connection instead of dropping in-flight work:
+ * streams above last_stream_id fail immediately with AWS_ERROR_HTTP_GOAWAY_RECEIVED, streams at
+ * or below it run to completion, new streams are rejected, and the connection shuts down cleanly
+ * once the last surviving stream finishes. */
+H2_CONNECTION_TEST_CASE(h2_client_goaway_drains_gracefully) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    /* Two requests in flight: stream 1 and stream 3 */
+    struct response_tester response1;
+    AWS_ZERO_STRUCT(response1);
+    struct aws_http_make_request_options opt1 = {
+        .self_size = sizeof(opt1),
+        .request = s_new_default_get_request(allocator),
+        .user_data = &response1,
+        .on_complete = s_on_complete,
+    };
+    struct aws_http_stream *stream1 = aws_http_connection_make_request(tester.connection, &opt1);
+    ASSERT_NOT_NULL(stream1);
+
+    struct response_tester response3;
+    AWS_ZERO_STRUCT(response3);
+    struct aws_http_make_request_options opt3 = {
+        .self_size = sizeof(opt3),
+        .request = s_new_default_get_request(allocator),
+        .user_data = &response3,
+        .on_complete = s_on_complete,
+    };
+    struct aws_http_stream *stream3 = aws_http_connection_make_request(tester.connection, &opt3);
+    ASSERT_NOT_NULL(stream3);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+    ASSERT_FALSE(aws_http_connection_is_draining(tester.connection));
+
+    /* Server says goodbye, having processed nothing past stream 1 */
+    struct aws_h2_frame_encoder encoder;
+    ASSERT_SUCCESS(aws_h2_frame_encoder_init(&encoder, allocator));
+
+    struct aws_h2_frame_goaway goaway;
+    ASSERT_SUCCESS(aws_h2_frame_goaway_init(&goaway, allocator));
+    goaway.last_stream_id = 1;
+    goaway.error_code = AWS_H2_ERR_NO_ERROR;
+
+    struct aws_byte_buf goaway_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&goaway_buf, allocator, 64));
+    ASSERT_SUCCESS(aws_h2_frame_goaway_encode(&goaway, &encoder, &goaway_buf));
+    aws_h2_frame_goaway_clean_up(&goaway);
+
+    struct aws_io_message *goaway_msg = aws_channel_acquire_message_from_pool(
+        tester.testing_channel.channel, AWS_IO_MESSAGE_APPLICATION_DATA, goaway_buf.len);
+    ASSERT_NOT_NULL(goaway_msg);
+    ASSERT_TRUE(aws_byte_buf_write_from_whole_cursor(&goaway_msg->message_data, aws_byte_cursor_from_buf(&goaway_buf)));
+    ASSERT_SUCCESS(testing_channel_push_read_message(&tester.testing_channel, goaway_msg));
+    aws_byte_buf_clean_up(&goaway_buf);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    /* Stream 3 was never processed by the peer, it must fail immediately so the caller can retry */
+    ASSERT_UINT_EQUALS(1, response3.on_complete_count);
+    ASSERT_INT_EQUALS(AWS_ERROR_HTTP_GOAWAY_RECEIVED, response3.on_complete_error_code);
+
+    /* Stream 1 is still being processed, so the connection lingers, draining */
+    ASSERT_UINT_EQUALS(0, response1.on_complete_count);
+    ASSERT_TRUE(aws_http_connection_is_open(tester.connection));
+    ASSERT_TRUE(aws_http_connection_is_draining(tester.connection));
+
+    /* New streams must be rejected */
+    struct aws_http_make_request_options opt_rejected = {
+        .self_size = sizeof(opt_rejected),
+        .request = s_new_default_get_request(allocator),
+    };
+    ASSERT_NULL(aws_http_connection_make_request(tester.connection, &opt_rejected));
+    ASSERT_INT_EQUALS(AWS_ERROR_HTTP_GOAWAY_RECEIVED, aws_last_error());
+    aws_http_message_destroy(opt_rejected.request);
+
+    /* Finish stream 1 with a response; the connection should then shut down cleanly */
+    struct aws_h2_frame_headers response_frame;
+    ASSERT_SUCCESS(aws_h2_frame_headers_init(&response_frame, allocator));
+    response_frame.header.stream_id = 1;
+    response_frame.end_headers = true;
+    response_frame.end_stream = true;
+
+    struct aws_h2_frame_header_field status_field = {
+        .header =
+            {
+                .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL(":status"),
+                .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("200"),
+            },
+    };
+    ASSERT_SUCCESS(aws_array_list_push_back(&response_frame.header_block.header_fields, &status_field));
+
+    struct aws_byte_buf response_buf;
+    ASSERT_SUCCESS(aws_byte_buf_init(&response_buf, allocator, 1024));
+    ASSERT_SUCCESS(aws_h2_frame_headers_encode(&response_frame, &encoder, &response_buf));
+    aws_h2_frame_headers_clean_up(&response_frame);
+    aws_h2_frame_encoder_clean_up(&encoder);
+
+    struct aws_io_message *response_msg = aws_channel_acquire_message_from_pool(
+        tester.testing_channel.channel, AWS_IO_MESSAGE_APPLICATION_DATA, response_buf.len);
+    ASSERT_NOT_NULL(response_msg);
+    ASSERT_TRUE(
+        aws_byte_buf_write_from_whole_cursor(&response_msg->message_data, aws_byte_cursor_from_buf(&response_buf)));
+    ASSERT_SUCCESS(testing_channel_push_read_message(&tester.testing_channel, response_msg));
+    aws_byte_buf_clean_up(&response_buf);
+
+    testing_channel_drain_queued_tasks(&tester.testing_channel);
+
+    ASSERT_UINT_EQUALS(1, response1.on_complete_count);
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, response1.on_complete_error_code);
+
+    ASSERT_TRUE(testing_channel_is_shutdown_completed(&tester.testing_channel));
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, testing_channel_get_shutdown_error_code(&tester.testing_channel));
+
+    aws_http_message_destroy(opt1.request);
+    aws_http_message_destroy(opt3.request);
+    aws_http_stream_release(stream1);
+    aws_http_stream_release(stream3);
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
@@ -582,3 +582,60 @@ static int s_test_continuation_init(struct frame_test_fixture *fixture) {
     return AWS_OP_SUCCESS;
 }
 FRAME_TEST(CONTINUATION, continuation, &s_test_continuation_init, NULL, NULL)
+
+/*****************************************************************************/
+/* Direct encoding                                                           */
+
+/* The direct encoders write multiple small frames back-to-back into one buffer with no
+ * frame objects; check the wire bytes against hand-built expected output. */
+static int s_test_h2_frame_direct_encode(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_byte_buf output;
+    ASSERT_SUCCESS(aws_byte_buf_init(&output, allocator, S_BUFFER_SIZE));
+
+    static const uint8_t s_ping_data[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+    const struct aws_h2_frame_setting settings[] = {
+        {.identifier = AWS_H2_SETTINGS_ENABLE_PUSH, .value = 0},
+        {.identifier = AWS_H2_SETTINGS_INITIAL_WINDOW_SIZE, .value = 0x00010000},
+    };
+
+    ASSERT_SUCCESS(aws_h2_frame_settings_encode_direct(true /*ack*/, NULL, 0, &output));
+    ASSERT_SUCCESS(aws_h2_frame_ping_encode_direct(true /*ack*/, s_ping_data, &output));
+    ASSERT_SUCCESS(aws_h2_frame_window_update_encode_direct(1 /*stream_id*/, 0x0123, &output));
+    ASSERT_SUCCESS(aws_h2_frame_rst_stream_encode_direct(1 /*stream_id*/, AWS_H2_ERR_CANCEL, &output));
+    ASSERT_SUCCESS(aws_h2_frame_settings_encode_direct(false /*ack*/, settings, AWS_ARRAY_SIZE(settings), &output));
+
+    /* clang-format off */
+    uint8_t expected[] = {
+        /* SETTINGS ack */
+        0x00, 0x00, 0x00, AWS_H2_FRAME_T_SETTINGS, AWS_H2_FRAME_F_ACK, 0x00, 0x00, 0x00, 0x00,
+        /* PING ack */
+        0x00, 0x00, 0x08, AWS_H2_FRAME_T_PING, AWS_H2_FRAME_F_ACK, 0x00, 0x00, 0x00, 0x00,
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+        /* WINDOW_UPDATE, stream 1 */
+        0x00, 0x00, 0x04, AWS_H2_FRAME_T_WINDOW_UPDATE, 0x00, 0x00, 0x00, 0x00, 0x01,
+        0x00, 0x00, 0x01, 0x23,
+        /* RST_STREAM, stream 1 */
+        0x00, 0x00, 0x04, AWS_H2_FRAME_T_RST_STREAM, 0x00, 0x00, 0x00, 0x00, 0x01,
+        0x00, 0x00, 0x00, AWS_H2_ERR_CANCEL,
+        /* SETTINGS with two entries */
+        0x00, 0x00, 0x0C, AWS_H2_FRAME_T_SETTINGS, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, AWS_H2_SETTINGS_ENABLE_PUSH, 0x00, 0x00, 0x00, 0x00,
+        0x00, AWS_H2_SETTINGS_INITIAL_WINDOW_SIZE, 0x00, 0x01, 0x00, 0x00,
+    };
+    /* clang-format on */
+
+    ASSERT_BIN_ARRAYS_EQUALS(expected, sizeof(expected), output.buffer, output.len);
+
+    /* A frame that doesn't fit must restore the buffer and raise */
+    const size_t len_before = output.len;
+    output.capacity = output.len + 4;
+    ASSERT_FAILS(aws_h2_frame_window_update_encode_direct(1, 0x0123, &output));
+    ASSERT_UINT_EQUALS(len_before, output.len);
+
+    output.capacity = S_BUFFER_SIZE;
+    aws_byte_buf_clean_up(&output);
+    return AWS_OP_SUCCESS;
+}
+AWS_TEST_CASE(h2_frame_direct_encode, s_test_h2_frame_direct_encode)
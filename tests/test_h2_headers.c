@@ -106,8 +106,12 @@ static int s_header_test_run(struct aws_allocator *allocator, void *ctx) {
     struct aws_byte_buf output_buffer;
     ASSERT_SUCCESS(aws_byte_buf_init(&output_buffer, allocator, S_BUFFER_SIZE));
 
-    /* Encode the header */
-    ASSERT_SUCCESS(aws_h2_frame_header_block_encode(&fixture->headers, &fixture->encoder, &output_buffer));
+    /* Encode the header (staged in a single pass, then written out; the reported
+     * length must match the staged bytes exactly) */
+    size_t encoded_length = 0;
+    ASSERT_SUCCESS(aws_h2_frame_header_block_encode(&fixture->headers, &fixture->encoder, &encoded_length));
+    ASSERT_SUCCESS(aws_h2_frame_header_block_write(&fixture->encoder, &output_buffer));
+    ASSERT_UINT_EQUALS(encoded_length, output_buffer.len);
 
     /* Compare the buffers */
     ASSERT_BIN_ARRAYS_EQUALS(fixture->buffer.buffer, fixture->buffer.len, output_buffer.buffer, output_buffer.len);
@@ -285,7 +289,7 @@ HEADER_TEST(ex_3_1, s_test_ex_3_1_init, NULL);
 
 static int s_test_ex_4_1_init(struct header_test_fixture *fixture) {
 
-    fixture->encoder.use_huffman = true;
+    fixture->encoder.huffman_mode = AWS_H2_HUFFMAN_MODE_ALWAYS;
 
     DEFINE_STATIC_HEADER(header_method, ":method", "GET", SAVE);
     DEFINE_STATIC_HEADER(header_scheme, ":scheme", "http", SAVE);
@@ -348,7 +352,7 @@ HEADER_TEST(ex_5_1, s_test_ex_5_1_init, NULL);
 
 static int s_test_ex_6_1_init(struct header_test_fixture *fixture) {
 
-    fixture->encoder.use_huffman = true;
+    fixture->encoder.huffman_mode = AWS_H2_HUFFMAN_MODE_ALWAYS;
 
     DEFINE_STATIC_HEADER(header_status, ":status", "302", SAVE);
     DEFINE_STATIC_HEADER(header_cache_control, "cache-control", "private", SAVE);
@@ -370,3 +374,30 @@ static int s_test_ex_6_1_init(struct header_test_fixture *fixture) {
     return AWS_OP_SUCCESS;
 }
 HEADER_TEST(ex_6_1, s_test_ex_6_1_init, NULL);
+
+/* AUTO mode decides per string: "www.example.com" shrinks under Huffman (15 -> 12 bytes)
+ * so it's coded, while "####" would grow (4 -> 6 bytes: '#' is a 12-bit symbol) and
+ * stays raw. */
+static int s_test_auto_huffman_init(struct header_test_fixture *fixture) {
+
+    fixture->encoder.huffman_mode = AWS_H2_HUFFMAN_MODE_AUTO;
+
+    DEFINE_STATIC_HEADER(header_authority, ":authority", "www.example.com", SAVE);
+    DEFINE_STATIC_HEADER(header_raw, "a", "####", NO_SAVE);
+
+    aws_array_list_push_back(&fixture->headers.header_fields, &header_authority);
+    aws_array_list_push_back(&fixture->headers.header_fields, &header_raw);
+
+    /* clang-format off */
+    static const uint8_t encoded[] = {
+        /* :authority, Huffman-coded value (RFC-7541 C.4.1) */
+        0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff,
+        /* literal without indexing, raw name and value */
+        0x00, 0x01, 'a', 0x04, '#', '#', '#', '#',
+    };
+    /* clang-format on */
+    aws_byte_buf_write(&fixture->buffer, encoded, sizeof(encoded));
+
+    return AWS_OP_SUCCESS;
+}
+HEADER_TEST(auto_huffman, s_test_auto_huffman_init, NULL);
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/header_intern.h>
+
+#include <aws/http/request_response.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+#define TEST_CASE(NAME)                                                                                                \
+    AWS_TEST_CASE(NAME, s_test_##NAME);                                                                                \
+    static int s_test_##NAME(struct aws_allocator *allocator, void *ctx)
+
+TEST_CASE(header_intern_lookup) {
+    (void)ctx;
+    aws_http_library_init(allocator);
+
+    /* Every capitalization of a common name resolves to the same entry */
+    const struct aws_http_interned_header *conventional =
+        aws_http_header_intern_lookup(aws_byte_cursor_from_c_str("Content-Length"));
+    ASSERT_NOT_NULL(conventional);
+
+    ASSERT_PTR_EQUALS(conventional, aws_http_header_intern_lookup(aws_byte_cursor_from_c_str("content-length")));
+    ASSERT_PTR_EQUALS(conventional, aws_http_header_intern_lookup(aws_byte_cursor_from_c_str("CONTENT-LENGTH")));
+    ASSERT_PTR_EQUALS(conventional, aws_http_header_intern_lookup(aws_byte_cursor_from_c_str("cOnTeNt-LeNgTh")));
+
+    /* Both stored forms have the expected bytes and an identical case-folded hash */
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&conventional->name, "Content-Length"));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&conventional->lowercase, "content-length"));
+    ASSERT_UINT_EQUALS(conventional->hash, aws_http_header_name_hash(conventional->lowercase));
+
+    /* Uncommon names are not interned */
+    ASSERT_NULL(aws_http_header_intern_lookup(aws_byte_cursor_from_c_str("X-Amz-Made-Up-Header")));
+    ASSERT_NULL(aws_http_header_intern_lookup(aws_byte_cursor_from_c_str("")));
+
+    /* Same length and similar spelling as an interned name must still miss */
+    ASSERT_NULL(aws_http_header_intern_lookup(aws_byte_cursor_from_c_str("Content-Lengtx")));
+
+    aws_http_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(header_intern_str_to_header_name) {
+    (void)ctx;
+    aws_http_library_init(allocator);
+
+    /* The names internal processing cares about carry their enum */
+    ASSERT_INT_EQUALS(
+        AWS_HTTP_HEADER_CONNECTION, aws_http_str_to_header_name(aws_byte_cursor_from_c_str("Connection")));
+    ASSERT_INT_EQUALS(
+        AWS_HTTP_HEADER_CONTENT_LENGTH, aws_http_str_to_header_name(aws_byte_cursor_from_c_str("content-LENGTH")));
+    ASSERT_INT_EQUALS(AWS_HTTP_HEADER_EXPECT, aws_http_str_to_header_name(aws_byte_cursor_from_c_str("expect")));
+    ASSERT_INT_EQUALS(
+        AWS_HTTP_HEADER_TRANSFER_ENCODING,
+        aws_http_str_to_header_name(aws_byte_cursor_from_c_str("Transfer-Encoding")));
+
+    /* Interned, but not meaningful to internal processing */
+    ASSERT_INT_EQUALS(AWS_HTTP_HEADER_UNKNOWN, aws_http_str_to_header_name(aws_byte_cursor_from_c_str("Host")));
+
+    /* Not interned at all */
+    ASSERT_INT_EQUALS(AWS_HTTP_HEADER_UNKNOWN, aws_http_str_to_header_name(aws_byte_cursor_from_c_str("Moustache")));
+
+    aws_http_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(header_intern_headers_add_stores_pointer) {
+    (void)ctx;
+    aws_http_library_init(allocator);
+
+    struct aws_http_headers *headers = aws_http_headers_new(allocator);
+    ASSERT_NOT_NULL(headers);
+
+    char conventional_src[] = "Content-Length";
+    char lowercase_src[] = "content-length";
+    char uncommon_src[] = "X-Custom-Name";
+    ASSERT_SUCCESS(
+        aws_http_headers_add(headers, aws_byte_cursor_from_c_str(conventional_src), aws_byte_cursor_from_c_str("1")));
+    ASSERT_SUCCESS(
+        aws_http_headers_add(headers, aws_byte_cursor_from_c_str(lowercase_src), aws_byte_cursor_from_c_str("2")));
+    ASSERT_SUCCESS(
+        aws_http_headers_add(headers, aws_byte_cursor_from_c_str(uncommon_src), aws_byte_cursor_from_c_str("3")));
+
+    /* Mutilate the original strings to be sure headers aren't referencing their memory */
+    conventional_src[0] = 'z';
+    lowercase_src[0] = 'z';
+    uncommon_src[0] = 'z';
+
+    const struct aws_http_interned_header *interned =
+        aws_http_header_intern_lookup(aws_byte_cursor_from_c_str("Content-Length"));
+    ASSERT_NOT_NULL(interned);
+
+    /* Interned spellings are stored as pointers into the global table, not copies */
+    struct aws_http_header header;
+    ASSERT_SUCCESS(aws_http_headers_get_index(headers, 0, &header));
+    ASSERT_PTR_EQUALS(interned->name.ptr, header.name.ptr);
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&header.value, "1"));
+
+    ASSERT_SUCCESS(aws_http_headers_get_index(headers, 1, &header));
+    ASSERT_PTR_EQUALS(interned->lowercase.ptr, header.name.ptr);
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&header.value, "2"));
+
+    /* Uncommon names still get their own copy */
+    ASSERT_SUCCESS(aws_http_headers_get_index(headers, 2, &header));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&header.name, "X-Custom-Name"));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&header.value, "3"));
+
+    /* Lookups work the same on interned and copied names */
+    struct aws_byte_cursor value;
+    ASSERT_SUCCESS(aws_http_headers_get(headers, aws_byte_cursor_from_c_str("CONTENT-LENGTH"), &value));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&value, "1"));
+    ASSERT_SUCCESS(aws_http_headers_get(headers, aws_byte_cursor_from_c_str("x-custom-name"), &value));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&value, "3"));
+
+    aws_http_headers_release(headers);
+    aws_http_library_clean_up();
+    return AWS_OP_SUCCESS;
+}
@@ -19,6 +19,8 @@
 
 #include <aws/http/request_response.h>
 
+#include <stdio.h>
+
 AWS_TEST_CASE(hpack_encode_integer, test_hpack_encode_integer)
 static int test_hpack_encode_integer(struct aws_allocator *allocator, void *ctx) {
     (void)allocator;
@@ -366,3 +368,231 @@ static int test_hpack_dynamic_table_get(struct aws_allocator *allocator, void *c
     aws_hpack_static_table_clean_up();
     return AWS_OP_SUCCESS;
 }
+
+AWS_TEST_CASE(hpack_string_round_trip, test_hpack_string_round_trip)
+static int test_hpack_string_round_trip(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_hpack_static_table_init(allocator);
+    struct aws_hpack_context *context = aws_hpack_context_new(allocator, 0);
+
+    const char *test_strings[] = {
+        /* Common header text: short codes only */
+        "www.example.com",
+        "no-cache",
+        "max-age=31536000, public",
+        /* Rare characters that use codes longer than 8 bits */
+        "custom\\\"value\\\" with <brackets> & {braces}",
+        "\x01\x02\xfe\xff",
+        /* Long value, exercises the bit window refill */
+        "kLmNoPqRsTuVwXyZ0123456789AbCdEfGhIjKlMnOpQrStUvWxYz0123456789aBcDeF=kLmNoPqRsTuVwXyZ",
+    };
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(test_strings); ++i) {
+        struct aws_byte_cursor original = aws_byte_cursor_from_c_str(test_strings[i]);
+
+        for (int huffman = 0; huffman < 2; ++huffman) {
+            uint8_t encode_storage[512];
+            struct aws_byte_buf encode_buf = aws_byte_buf_from_empty_array(encode_storage, sizeof(encode_storage));
+
+            struct aws_byte_cursor to_encode = original;
+            ASSERT_SUCCESS(aws_hpack_encode_string(context, &to_encode, huffman != 0, &encode_buf));
+            ASSERT_UINT_EQUALS(
+                encode_buf.len, aws_hpack_get_encoded_length_string(context, original, huffman != 0));
+
+            uint8_t decode_storage[512];
+            struct aws_byte_buf decode_buf = aws_byte_buf_from_empty_array(decode_storage, sizeof(decode_storage));
+
+            struct aws_byte_cursor to_decode = aws_byte_cursor_from_buf(&encode_buf);
+            ASSERT_SUCCESS(aws_hpack_decode_string(context, &to_decode, &decode_buf));
+            ASSERT_UINT_EQUALS(0, to_decode.len);
+            ASSERT_TRUE(aws_byte_cursor_eq_byte_buf(&original, &decode_buf));
+        }
+    }
+
+    aws_hpack_context_destroy(context);
+    aws_hpack_static_table_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(hpack_dynamic_table_wrap_around, test_hpack_dynamic_table_wrap_around)
+static int test_hpack_dynamic_table_wrap_around(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_hpack_static_table_init(allocator);
+
+    /* Insert several times the table's capacity, so the ring's index_0 wraps repeatedly,
+     * and check that find/get stay consistent and evicted entries stop resolving */
+    enum { max_elements = 4, num_inserts = 20 };
+    struct aws_hpack_context *context = aws_hpack_context_new(allocator, max_elements);
+
+    char name_storage[num_inserts][16];
+    char value_storage[num_inserts][16];
+    struct aws_http_header headers[num_inserts];
+
+    bool found_value = false;
+
+    for (size_t i = 0; i < num_inserts; ++i) {
+        snprintf(name_storage[i], sizeof(name_storage[i]), "name-%zu", i);
+        snprintf(value_storage[i], sizeof(value_storage[i]), "value-%zu", i);
+        headers[i].name = aws_byte_cursor_from_c_str(name_storage[i]);
+        headers[i].value = aws_byte_cursor_from_c_str(value_storage[i]);
+
+        ASSERT_SUCCESS(aws_hpack_insert_header(context, &headers[i]));
+
+        /* The newest min(i+1, max) insertions should be present, newest first */
+        size_t num_present = i + 1 < max_elements ? i + 1 : max_elements;
+        for (size_t age = 0; age < num_present; ++age) {
+            const struct aws_http_header *expected = &headers[i - age];
+
+            ASSERT_UINT_EQUALS(62 + age, aws_hpack_find_index(context, expected, &found_value));
+            ASSERT_TRUE(found_value);
+
+            const struct aws_http_header *found = aws_hpack_get_header(context, 62 + age);
+            ASSERT_NOT_NULL(found);
+            ASSERT_TRUE(aws_byte_cursor_eq(&expected->name, &found->name));
+            ASSERT_TRUE(aws_byte_cursor_eq(&expected->value, &found->value));
+        }
+
+        /* Anything older should have been evicted */
+        if (i >= max_elements) {
+            ASSERT_UINT_EQUALS(0, aws_hpack_find_index(context, &headers[i - max_elements], &found_value));
+            ASSERT_NULL(aws_hpack_get_header(context, 62 + max_elements));
+        }
+    }
+
+    aws_hpack_context_destroy(context);
+    aws_hpack_static_table_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(hpack_dynamic_table_lazy_growth, test_hpack_dynamic_table_lazy_growth)
+static int test_hpack_dynamic_table_lazy_growth(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_hpack_static_table_init(allocator);
+
+    /* The backing storage starts smaller than max_elements and doubles on demand, so insert
+     * past several growth boundaries and check that entries survive each reallocation */
+    enum { max_elements = 32, num_inserts = 40 };
+    struct aws_hpack_context *context = aws_hpack_context_new(allocator, max_elements);
+
+    char name_storage[num_inserts][16];
+    char value_storage[num_inserts][16];
+    struct aws_http_header headers[num_inserts];
+
+    bool found_value = false;
+
+    for (size_t i = 0; i < num_inserts; ++i) {
+        snprintf(name_storage[i], sizeof(name_storage[i]), "name-%zu", i);
+        snprintf(value_storage[i], sizeof(value_storage[i]), "value-%zu", i);
+        headers[i].name = aws_byte_cursor_from_c_str(name_storage[i]);
+        headers[i].value = aws_byte_cursor_from_c_str(value_storage[i]);
+
+        ASSERT_SUCCESS(aws_hpack_insert_header(context, &headers[i]));
+
+        size_t num_present = i + 1 < max_elements ? i + 1 : max_elements;
+        for (size_t age = 0; age < num_present; ++age) {
+            const struct aws_http_header *expected = &headers[i - age];
+
+            ASSERT_UINT_EQUALS(62 + age, aws_hpack_find_index(context, expected, &found_value));
+            ASSERT_TRUE(found_value);
+
+            const struct aws_http_header *found = aws_hpack_get_header(context, 62 + age);
+            ASSERT_NOT_NULL(found);
+            ASSERT_TRUE(aws_byte_cursor_eq(&expected->name, &found->name));
+            ASSERT_TRUE(aws_byte_cursor_eq(&expected->value, &found->value));
+        }
+    }
+
+    /* Shrinking the cap should release the grown storage and keep only the newest entries */
+    ASSERT_SUCCESS(aws_hpack_resize_dynamic_table(context, 2));
+    ASSERT_UINT_EQUALS(62, aws_hpack_find_index(context, &headers[num_inserts - 1], &found_value));
+    ASSERT_TRUE(found_value);
+    ASSERT_UINT_EQUALS(63, aws_hpack_find_index(context, &headers[num_inserts - 2], &found_value));
+    ASSERT_TRUE(found_value);
+    ASSERT_NULL(aws_hpack_get_header(context, 64));
+    ASSERT_UINT_EQUALS(0, aws_hpack_find_index(context, &headers[num_inserts - 3], &found_value));
+
+    aws_hpack_context_destroy(context);
+    aws_hpack_static_table_clean_up();
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(hpack_decode_streaming, test_hpack_decode_streaming)
+static int test_hpack_decode_streaming(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    aws_hpack_static_table_init(allocator);
+    struct aws_hpack_context *context = aws_hpack_context_new(allocator, 10);
+    ASSERT_NOT_NULL(context);
+
+    struct expected_field {
+        const char *name;
+        const char *value;
+    };
+
+    /* First and second Huffman-coded requests of RFC-7541 C.4. The second request resolves
+     * :authority through the dynamic-table entry the first request inserted, proving that
+     * entries decoded incrementally survive across header blocks. */
+    uint8_t block_1[] = {
+        0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff};
+    const struct expected_field expected_1[] = {
+        {":method", "GET"},
+        {":scheme", "http"},
+        {":path", "/"},
+        {":authority", "www.example.com"},
+    };
+
+    uint8_t block_2[] = {0x82, 0x86, 0x84, 0xbe, 0x58, 0x86, 0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf};
+    const struct expected_field expected_2[] = {
+        {":method", "GET"},
+        {":scheme", "http"},
+        {":path", "/"},
+        {":authority", "www.example.com"},
+        {"cache-control", "no-cache"},
+    };
+
+    struct {
+        const uint8_t *block;
+        size_t block_len;
+        const struct expected_field *expected;
+        size_t num_expected;
+    } test_cases[] = {
+        {block_1, AWS_ARRAY_SIZE(block_1), expected_1, AWS_ARRAY_SIZE(expected_1)},
+        {block_2, AWS_ARRAY_SIZE(block_2), expected_2, AWS_ARRAY_SIZE(expected_2)},
+    };
+
+    for (size_t case_i = 0; case_i < AWS_ARRAY_SIZE(test_cases); ++case_i) {
+        size_t num_decoded = 0;
+
+        /* Feed one byte at a time: every partial integer, string, and Huffman code must
+         * carry across the boundary */
+        for (size_t i = 0; i < test_cases[case_i].block_len; ++i) {
+            struct aws_byte_cursor one_byte = aws_byte_cursor_from_array(&test_cases[case_i].block[i], 1);
+
+            while (one_byte.len) {
+                struct aws_hpack_decode_result result;
+                ASSERT_SUCCESS(aws_hpack_decode(context, &one_byte, &result));
+
+                if (result.type == AWS_HPACK_DECODE_T_HEADER_FIELD) {
+                    ASSERT_TRUE(num_decoded < test_cases[case_i].num_expected);
+
+                    const struct expected_field *expected = &test_cases[case_i].expected[num_decoded];
+                    struct aws_byte_cursor expected_name = aws_byte_cursor_from_c_str(expected->name);
+                    struct aws_byte_cursor expected_value = aws_byte_cursor_from_c_str(expected->value);
+                    ASSERT_TRUE(aws_byte_cursor_eq(&expected_name, &result.header_field.name));
+                    ASSERT_TRUE(aws_byte_cursor_eq(&expected_value, &result.header_field.value));
+
+                    ++num_decoded;
+                }
+            }
+        }
+
+        ASSERT_UINT_EQUALS(test_cases[case_i].num_expected, num_decoded);
+    }
+
+    aws_hpack_context_destroy(context);
+    aws_hpack_static_table_clean_up();
+    return AWS_OP_SUCCESS;
+}
@@ -197,6 +197,50 @@ TEST_CASE(headers_add_array) {
     return AWS_OP_SUCCESS;
 }
 
+TEST_CASE(headers_add_array_bulk) {
+    (void)ctx;
+    struct aws_http_headers *headers = aws_http_headers_new(allocator);
+    ASSERT_NOT_NULL(headers);
+
+    /* Large enough to exceed the initial entry reservation and arena block, mixing interned
+     * names (Host, Accept) with names that must be copied */
+    enum { num_headers = 40 };
+    char name_storage[num_headers][32];
+    char value_storage[num_headers][64];
+    struct aws_http_header src_headers[num_headers];
+
+    for (size_t i = 0; i < num_headers; ++i) {
+        if (i % 4 == 0) {
+            snprintf(name_storage[i], sizeof(name_storage[i]), "%s", i % 8 ? "Host" : "Accept");
+        } else {
+            snprintf(name_storage[i], sizeof(name_storage[i]), "x-custom-header-%zu", i);
+        }
+        snprintf(value_storage[i], sizeof(value_storage[i]), "value-%zu-padding-padding-padding", i);
+        src_headers[i] = s_make_header(name_storage[i], value_storage[i]);
+    }
+
+    ASSERT_SUCCESS(aws_http_headers_add_array(headers, src_headers, num_headers));
+    ASSERT_UINT_EQUALS(num_headers, aws_http_headers_count(headers));
+
+    for (size_t i = 0; i < num_headers; ++i) {
+        struct aws_http_header get;
+        ASSERT_SUCCESS(aws_http_headers_get_index(headers, i, &get));
+        ASSERT_SUCCESS(s_check_headers_eq(src_headers[i], get));
+    }
+
+    /* An invalid name anywhere in the array fails the whole add, leaving headers untouched */
+    const struct aws_http_header bad_headers[] = {
+        s_make_header("ok-name", "ok-value"),
+        s_make_header("", "value-with-empty-name"),
+    };
+    ASSERT_ERROR(
+        AWS_ERROR_HTTP_INVALID_HEADER_NAME, aws_http_headers_add_array(headers, bad_headers, AWS_ARRAY_SIZE(bad_headers)));
+    ASSERT_UINT_EQUALS(num_headers, aws_http_headers_count(headers));
+
+    aws_http_headers_release(headers);
+    return AWS_OP_SUCCESS;
+}
+
 TEST_CASE(headers_set) {
     (void)ctx;
     struct aws_http_headers *headers = aws_http_headers_new(allocator);
@@ -332,6 +376,102 @@ TEST_CASE(headers_clear) {
     return AWS_OP_SUCCESS;
 }
 
+TEST_CASE(headers_arena_string_stability) {
+    (void)ctx;
+    struct aws_http_headers *headers = aws_http_headers_new(allocator);
+    ASSERT_NOT_NULL(headers);
+
+    /* Add enough headers to force the backing arena through several growth blocks,
+     * and assert that previously returned name/value cursors keep their addresses. */
+    enum { count = 100 };
+    char name_storage[count][32];
+    char value_storage[count][64];
+
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(name_storage[i], sizeof(name_storage[i]), "x-amz-meta-%zu", i);
+        snprintf(value_storage[i], sizeof(value_storage[i]), "value-%zu-abcdefghijklmnopqrstuvwxyz", i);
+        ASSERT_SUCCESS(aws_http_headers_add(
+            headers, aws_byte_cursor_from_c_str(name_storage[i]), aws_byte_cursor_from_c_str(value_storage[i])));
+    }
+
+    struct aws_http_header first;
+    ASSERT_SUCCESS(aws_http_headers_get_index(headers, 0, &first));
+    const uint8_t *first_name_ptr = first.name.ptr;
+
+    for (size_t i = count; i < count * 2; ++i) {
+        char name[32];
+        snprintf(name, sizeof(name), "x-amz-meta-%zu", i);
+        ASSERT_SUCCESS(
+            aws_http_headers_add(headers, aws_byte_cursor_from_c_str(name), aws_byte_cursor_from_c_str("v")));
+    }
+
+    ASSERT_SUCCESS(aws_http_headers_get_index(headers, 0, &first));
+    ASSERT_PTR_EQUALS(first_name_ptr, first.name.ptr);
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&first.name, name_storage[0]));
+    ASSERT_TRUE(aws_byte_cursor_eq_c_str(&first.value, value_storage[0]));
+
+    /* Clearing must allow full re-use */
+    aws_http_headers_clear(headers);
+    ASSERT_UINT_EQUALS(0, aws_http_headers_count(headers));
+    ASSERT_SUCCESS(
+        aws_http_headers_add(headers, aws_byte_cursor_from_c_str("Host"), aws_byte_cursor_from_c_str("example.com")));
+    ASSERT_UINT_EQUALS(1, aws_http_headers_count(headers));
+
+    aws_http_headers_release(headers);
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(headers_hashed_lookup) {
+    (void)ctx;
+    struct aws_http_headers *headers = aws_http_headers_new(allocator);
+    ASSERT_NOT_NULL(headers);
+
+    /* Add enough headers that lookups go through the hash index rather than a linear scan */
+    enum { count = 40 };
+    char name_storage[count][32];
+    char value_storage[count][32];
+
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(name_storage[i], sizeof(name_storage[i]), "X-Test-%zu", i);
+        snprintf(value_storage[i], sizeof(value_storage[i]), "value-%zu", i);
+        ASSERT_SUCCESS(aws_http_headers_add(
+            headers, aws_byte_cursor_from_c_str(name_storage[i]), aws_byte_cursor_from_c_str(value_storage[i])));
+    }
+
+    /* Duplicate name, get must keep returning the first occurrence */
+    ASSERT_SUCCESS(
+        aws_http_headers_add(headers, aws_byte_cursor_from_c_str("X-TEST-0"), aws_byte_cursor_from_c_str("dupe")));
+
+    struct aws_byte_cursor get;
+    for (size_t i = 0; i < count; ++i) {
+        char lookup_name[32];
+        snprintf(lookup_name, sizeof(lookup_name), "x-test-%zu", i); /* ignore case */
+        ASSERT_SUCCESS(aws_http_headers_get(headers, aws_byte_cursor_from_c_str(lookup_name), &get));
+        ASSERT_SUCCESS(s_check_value_eq(get, value_storage[i]));
+    }
+
+    ASSERT_ERROR(
+        AWS_ERROR_HTTP_HEADER_NOT_FOUND, aws_http_headers_get(headers, aws_byte_cursor_from_c_str("X-Absent"), &get));
+
+    /* Headers added after a lookup must be found by later lookups */
+    ASSERT_SUCCESS(
+        aws_http_headers_add(headers, aws_byte_cursor_from_c_str("X-Late"), aws_byte_cursor_from_c_str("late")));
+    ASSERT_SUCCESS(aws_http_headers_get(headers, aws_byte_cursor_from_c_str("x-late"), &get));
+    ASSERT_SUCCESS(s_check_value_eq(get, "late"));
+
+    /* Erasing shifts indices, lookups must still be correct afterwards */
+    ASSERT_SUCCESS(aws_http_headers_erase(headers, aws_byte_cursor_from_c_str("X-Test-3")));
+    ASSERT_ERROR(
+        AWS_ERROR_HTTP_HEADER_NOT_FOUND, aws_http_headers_get(headers, aws_byte_cursor_from_c_str("X-Test-3"), &get));
+    ASSERT_SUCCESS(aws_http_headers_get(headers, aws_byte_cursor_from_c_str("X-Test-39"), &get));
+    ASSERT_SUCCESS(s_check_value_eq(get, value_storage[39]));
+    ASSERT_SUCCESS(aws_http_headers_get(headers, aws_byte_cursor_from_c_str("X-Test-0"), &get));
+    ASSERT_SUCCESS(s_check_value_eq(get, value_storage[0]));
+
+    aws_http_headers_release(headers);
+    return AWS_OP_SUCCESS;
+}
+
 TEST_CASE(message_refcounts) {
     (void)ctx;
     struct aws_http_message *message = aws_http_message_new_request(allocator);
@@ -377,6 +517,61 @@ TEST_CASE(message_with_existing_headers) {
     return AWS_OP_SUCCESS;
 }
 
+TEST_CASE(message_snapshot) {
+    (void)ctx;
+    struct aws_http_message *request = aws_http_message_new_request(allocator);
+    ASSERT_NOT_NULL(request);
+
+    ASSERT_SUCCESS(aws_http_message_set_request_method(request, aws_byte_cursor_from_c_str("PUT")));
+    ASSERT_SUCCESS(aws_http_message_set_request_path(request, aws_byte_cursor_from_c_str("/upload")));
+
+    const struct aws_http_header src_headers[] = {
+        s_make_header("Host", "example.com"),
+        s_make_header("x-amz-meta-tag", "original"),
+    };
+    ASSERT_SUCCESS(aws_http_message_add_header_array(request, src_headers, AWS_ARRAY_SIZE(src_headers)));
+
+    struct aws_http_message *snapshot = aws_http_message_snapshot(request);
+    ASSERT_NOT_NULL(snapshot);
+    ASSERT_TRUE(aws_http_message_is_request(snapshot));
+
+    struct aws_byte_cursor get;
+    ASSERT_SUCCESS(aws_http_message_get_request_method(snapshot, &get));
+    ASSERT_SUCCESS(s_check_value_eq(get, "PUT"));
+    ASSERT_SUCCESS(aws_http_message_get_request_path(snapshot, &get));
+    ASSERT_SUCCESS(s_check_value_eq(get, "/upload"));
+    ASSERT_UINT_EQUALS(2, aws_http_message_get_header_count(snapshot));
+
+    /* The headers object is shared until someone mutates */
+    ASSERT_PTR_EQUALS(aws_http_message_get_const_headers(request), aws_http_message_get_const_headers(snapshot));
+
+    /* Mutating the original must not be visible through the snapshot */
+    struct aws_http_header extra = s_make_header("x-extra", "added-after-snapshot");
+    ASSERT_SUCCESS(aws_http_message_add_header(request, extra));
+    ASSERT_UINT_EQUALS(3, aws_http_message_get_header_count(request));
+    ASSERT_UINT_EQUALS(2, aws_http_message_get_header_count(snapshot));
+    ASSERT_FAILS(aws_http_headers_get(
+        aws_http_message_get_headers(snapshot), aws_byte_cursor_from_c_str("x-extra"), &get));
+
+    /* And vice versa */
+    ASSERT_SUCCESS(aws_http_headers_set(
+        aws_http_message_get_headers(snapshot),
+        aws_byte_cursor_from_c_str("x-amz-meta-tag"),
+        aws_byte_cursor_from_c_str("hedged")));
+    ASSERT_SUCCESS(aws_http_headers_get(
+        aws_http_message_get_headers(request), aws_byte_cursor_from_c_str("x-amz-meta-tag"), &get));
+    ASSERT_SUCCESS(s_check_value_eq(get, "original"));
+
+    /* The snapshot must outlive the original */
+    aws_http_message_release(request);
+    ASSERT_SUCCESS(aws_http_headers_get(
+        aws_http_message_get_headers(snapshot), aws_byte_cursor_from_c_str("Host"), &get));
+    ASSERT_SUCCESS(s_check_value_eq(get, "example.com"));
+
+    aws_http_message_release(snapshot);
+    return AWS_OP_SUCCESS;
+}
+
 /* Do every operation that involves allocating some memory */
 int s_message_handles_oom_attempt(struct aws_http_message *request) {
     ASSERT_NOT_NULL(request);
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/mmap_stream.h>
+
+#include <aws/io/stream.h>
+#include <aws/testing/aws_test_harness.h>
+
+#include <stdio.h>
+
+#define TEST_CASE(NAME)                                                                                                \
+    AWS_TEST_CASE(NAME, s_test_##NAME);                                                                                \
+    static int s_test_##NAME(struct aws_allocator *allocator, void *ctx)
+
+static int s_write_test_file(const char *path, const uint8_t *data, size_t len) {
+    FILE *file = fopen(path, "wb");
+    ASSERT_NOT_NULL(file);
+    if (len > 0) {
+        ASSERT_UINT_EQUALS(len, fwrite(data, 1, len, file));
+    }
+    fclose(file);
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(mmap_stream_reads_file) {
+    (void)ctx;
+
+    const char *path = "mmap_stream_test_data.bin";
+
+    /* Big enough to span several read buffers */
+    const size_t data_len = 100 * 1000;
+    uint8_t *data = aws_mem_acquire(allocator, data_len);
+    ASSERT_NOT_NULL(data);
+    for (size_t i = 0; i < data_len; ++i) {
+        data[i] = (uint8_t)(i * 31 + 7);
+    }
+    ASSERT_SUCCESS(s_write_test_file(path, data, data_len));
+
+    struct aws_input_stream *stream = aws_http_mmap_input_stream_new(allocator, path);
+    ASSERT_NOT_NULL(stream);
+
+    int64_t length = 0;
+    ASSERT_SUCCESS(aws_input_stream_get_length(stream, &length));
+    ASSERT_UINT_EQUALS(data_len, (size_t)length);
+
+    /* Stream the whole file through an encoder-sized buffer */
+    struct aws_byte_buf accumulator;
+    ASSERT_SUCCESS(aws_byte_buf_init(&accumulator, allocator, data_len));
+
+    struct aws_stream_status status = {.is_valid = true, .is_end_of_stream = false};
+    while (!status.is_end_of_stream) {
+        uint8_t chunk_storage[4096];
+        struct aws_byte_buf chunk = aws_byte_buf_from_empty_array(chunk_storage, sizeof(chunk_storage));
+
+        ASSERT_SUCCESS(aws_input_stream_read(stream, &chunk));
+        ASSERT_TRUE(aws_byte_buf_write(&accumulator, chunk.buffer, chunk.len));
+
+        ASSERT_SUCCESS(aws_input_stream_get_status(stream, &status));
+        ASSERT_TRUE(status.is_valid);
+    }
+
+    ASSERT_BIN_ARRAYS_EQUALS(data, data_len, accumulator.buffer, accumulator.len);
+
+    /* Seeking back to the start allows the stream to be reused for a retry */
+    ASSERT_SUCCESS(aws_input_stream_seek(stream, 0, AWS_SSB_BEGIN));
+    ASSERT_SUCCESS(aws_input_stream_get_status(stream, &status));
+    ASSERT_FALSE(status.is_end_of_stream);
+
+    uint8_t head_storage[16];
+    struct aws_byte_buf head = aws_byte_buf_from_empty_array(head_storage, sizeof(head_storage));
+    ASSERT_SUCCESS(aws_input_stream_read(stream, &head));
+    ASSERT_BIN_ARRAYS_EQUALS(data, sizeof(head_storage), head.buffer, head.len);
+
+    aws_byte_buf_clean_up(&accumulator);
+    aws_mem_release(allocator, data);
+    aws_input_stream_destroy(stream);
+    remove(path);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(mmap_stream_empty_file) {
+    (void)ctx;
+
+    const char *path = "mmap_stream_test_empty.bin";
+    ASSERT_SUCCESS(s_write_test_file(path, NULL, 0));
+
+    struct aws_input_stream *stream = aws_http_mmap_input_stream_new(allocator, path);
+    ASSERT_NOT_NULL(stream);
+
+    int64_t length = 99;
+    ASSERT_SUCCESS(aws_input_stream_get_length(stream, &length));
+    ASSERT_UINT_EQUALS(0, (size_t)length);
+
+    struct aws_stream_status status;
+    AWS_ZERO_STRUCT(status);
+    ASSERT_SUCCESS(aws_input_stream_get_status(stream, &status));
+    ASSERT_TRUE(status.is_valid);
+    ASSERT_TRUE(status.is_end_of_stream);
+
+    aws_input_stream_destroy(stream);
+    remove(path);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(mmap_stream_missing_file) {
+    (void)ctx;
+
+    struct aws_input_stream *stream =
+        aws_http_mmap_input_stream_new(allocator, "mmap_stream_test_no_such_file.bin");
+    ASSERT_NULL(stream);
+
+    return AWS_OP_SUCCESS;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/stream_pool.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+#define TEST_CASE(NAME)                                                                                                \
+    AWS_TEST_CASE(NAME, s_test_##NAME);                                                                                \
+    static int s_test_##NAME(struct aws_allocator *allocator, void *ctx)
+
+enum { OBJECT_SIZE = 64 };
+
+TEST_CASE(stream_pool_recycles_allocations) {
+    (void)ctx;
+
+    struct aws_http_stream_pool pool;
+    aws_http_stream_pool_init(&pool, allocator, OBJECT_SIZE);
+
+    uint8_t *first = aws_http_stream_pool_acquire(&pool);
+    ASSERT_NOT_NULL(first);
+
+    /* Dirty the object, then hand it back */
+    memset(first, 0xFF, OBJECT_SIZE);
+    aws_http_stream_pool_release(&pool, first);
+
+    /* The next acquire must reuse the parked allocation, scrubbed back to zero */
+    uint8_t *second = aws_http_stream_pool_acquire(&pool);
+    ASSERT_PTR_EQUALS(first, second);
+    for (size_t i = 0; i < OBJECT_SIZE; ++i) {
+        ASSERT_UINT_EQUALS(0, second[i]);
+    }
+
+    aws_http_stream_pool_release(&pool, second);
+    aws_http_stream_pool_clean_up(&pool);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(stream_pool_overflow_falls_back_to_allocator) {
+    (void)ctx;
+
+    struct aws_http_stream_pool pool;
+    aws_http_stream_pool_init(&pool, allocator, OBJECT_SIZE);
+
+    /* More live objects than the pool has slots */
+    void *objects[AWS_HTTP_STREAM_POOL_SLOTS + 4];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(objects); ++i) {
+        objects[i] = aws_http_stream_pool_acquire(&pool);
+        ASSERT_NOT_NULL(objects[i]);
+        for (size_t j = 0; j < i; ++j) {
+            ASSERT_FALSE(objects[i] == objects[j]);
+        }
+    }
+
+    /* Releasing them all fills every slot and frees the overflow outright */
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(objects); ++i) {
+        aws_http_stream_pool_release(&pool, objects[i]);
+    }
+
+    /* A full drain hands back each parked slot exactly once before hitting the allocator again */
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(objects); ++i) {
+        objects[i] = aws_http_stream_pool_acquire(&pool);
+        ASSERT_NOT_NULL(objects[i]);
+    }
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(objects); ++i) {
+        aws_http_stream_pool_release(&pool, objects[i]);
+    }
+
+    /* clean_up releases whatever is still parked; mem_tracer in the harness catches leaks */
+    aws_http_stream_pool_clean_up(&pool);
+
+    return AWS_OP_SUCCESS;
+}
@@ -113,6 +113,65 @@ static int s_strutil_read_unsigned_hex(struct aws_allocator *allocator, void *ct
     return 0;
 }
 
+/* Inputs of 8+ characters take the SWAR (8 characters at a time) fast path.
+ * Exercise the chunk boundaries and mid-chunk rejection. */
+AWS_TEST_CASE(strutil_read_unsigned_swar_boundaries, s_strutil_read_unsigned_swar_boundaries);
+static int s_strutil_read_unsigned_swar_boundaries(struct aws_allocator *allocator, void *ctx) {
+    (void)allocator;
+    (void)ctx;
+
+    uint64_t val;
+
+    /* exactly one chunk */
+    ASSERT_SUCCESS(aws_strutil_read_unsigned_num(aws_byte_cursor_from_c_str("12345678"), &val));
+    ASSERT_UINT_EQUALS(12345678, val);
+
+    /* two chunks */
+    ASSERT_SUCCESS(aws_strutil_read_unsigned_num(aws_byte_cursor_from_c_str("1234567890123456"), &val));
+    ASSERT_UINT_EQUALS(1234567890123456, val);
+
+    /* chunk plus scalar tail */
+    ASSERT_SUCCESS(aws_strutil_read_unsigned_num(aws_byte_cursor_from_c_str("123456789"), &val));
+    ASSERT_UINT_EQUALS(123456789, val);
+
+    /* invalid character in the first chunk, the second chunk, and the tail */
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_strutil_read_unsigned_num(aws_byte_cursor_from_c_str("123x5678"), &val));
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT, aws_strutil_read_unsigned_num(aws_byte_cursor_from_c_str("12345678901x3456"), &val));
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT, aws_strutil_read_unsigned_num(aws_byte_cursor_from_c_str("12345678x"), &val));
+
+    /* hex: exactly one chunk, mixed case */
+    ASSERT_SUCCESS(aws_strutil_read_unsigned_hex(aws_byte_cursor_from_c_str("DeadBeef"), &val));
+    ASSERT_UINT_EQUALS(0xDEADBEEF, val);
+
+    /* hex: two chunks */
+    ASSERT_SUCCESS(aws_strutil_read_unsigned_hex(aws_byte_cursor_from_c_str("0123456789abcdef"), &val));
+    ASSERT_UINT_EQUALS(0x0123456789abcdefULL, val);
+
+    /* hex: chunk plus scalar tail */
+    ASSERT_SUCCESS(aws_strutil_read_unsigned_hex(aws_byte_cursor_from_c_str("deadbeef1"), &val));
+    ASSERT_UINT_EQUALS(0xdeadbeef1ULL, val);
+
+    /* hex: characters bracketing the valid ranges must be rejected in a chunk.
+     * ('/' and ':' bracket the digits; '`' and 'g' bracket the letters) */
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_strutil_read_unsigned_hex(aws_byte_cursor_from_c_str("dead/eef"), &val));
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_strutil_read_unsigned_hex(aws_byte_cursor_from_c_str("dead:eef"), &val));
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_strutil_read_unsigned_hex(aws_byte_cursor_from_c_str("dead`eef"), &val));
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_strutil_read_unsigned_hex(aws_byte_cursor_from_c_str("deadgeef"), &val));
+
+    /* bytes with the high bit set must be rejected */
+    uint8_t high_bit[8] = {'1', '2', '3', 0xB1, '5', '6', '7', '8'};
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_strutil_read_unsigned_num(aws_byte_cursor_from_array(high_bit, sizeof(high_bit)), &val));
+    ASSERT_ERROR(
+        AWS_ERROR_INVALID_ARGUMENT,
+        aws_strutil_read_unsigned_hex(aws_byte_cursor_from_array(high_bit, sizeof(high_bit)), &val));
+
+    return 0;
+}
+
 AWS_TEST_CASE(strutil_trim_http_whitespace, s_strutil_trim_http_whitespace);
 static int s_strutil_trim_http_whitespace(struct aws_allocator *allocator, void *ctx) {
     (void)allocator;
@@ -145,5 +204,87 @@ static int s_strutil_trim_http_whitespace(struct aws_allocator *allocator, void
         ASSERT_TRUE(aws_byte_cursor_eq(&expected, &trimmed));
     }
 
+    return 0;
+}
+
+AWS_TEST_CASE(strutil_is_http_token, s_strutil_is_http_token);
+static int s_strutil_is_http_token(struct aws_allocator *allocator, void *ctx) {
+    (void)allocator;
+    (void)ctx;
+
+    /* every tchar, in one token long enough to hit the vector paths */
+    ASSERT_TRUE(aws_strutil_is_http_token(
+        aws_byte_cursor_from_c_str("!#$%&'*+-.^_`|~0123456789"
+                                   "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ")));
+
+    /* typical header names */
+    ASSERT_TRUE(aws_strutil_is_http_token(aws_byte_cursor_from_c_str("Content-Length")));
+    ASSERT_TRUE(aws_strutil_is_http_token(aws_byte_cursor_from_c_str("a")));
+
+    /* empty is not a token */
+    ASSERT_FALSE(aws_strutil_is_http_token(aws_byte_cursor_from_c_str("")));
+
+    /* every separator must be rejected.
+     * RFC7230 3.2.6: DQUOTE and "(),/:;<=>?@[\]{}" */
+    const char *separators = "\"(),/:;<=>?@[\\]{}";
+    for (const char *c = separators; *c; ++c) {
+        char name[4] = {'a', *c, 'b', '\0'};
+        ASSERT_FALSE(aws_strutil_is_http_token(aws_byte_cursor_from_c_str(name)));
+    }
+
+    /* whitespace and control characters */
+    ASSERT_FALSE(aws_strutil_is_http_token(aws_byte_cursor_from_c_str("a b")));
+    ASSERT_FALSE(aws_strutil_is_http_token(aws_byte_cursor_from_c_str("a\tb")));
+    uint8_t with_nul[3] = {'a', 0x00, 'b'};
+    ASSERT_FALSE(aws_strutil_is_http_token(aws_byte_cursor_from_array(with_nul, sizeof(with_nul))));
+
+    /* bytes with the high bit set, in every stride: tail, 16-byte, and 32-byte chunks */
+    for (size_t len = 1; len <= 40; ++len) {
+        uint8_t name[40];
+        memset(name, 'x', len);
+        ASSERT_TRUE(aws_strutil_is_http_token(aws_byte_cursor_from_array(name, len)));
+        name[len - 1] = 0xE9;
+        ASSERT_FALSE(aws_strutil_is_http_token(aws_byte_cursor_from_array(name, len)));
+    }
+
+    return 0;
+}
+
+AWS_TEST_CASE(strutil_ascii_lowercase, s_strutil_ascii_lowercase);
+static int s_strutil_ascii_lowercase(struct aws_allocator *allocator, void *ctx) {
+    (void)allocator;
+    (void)ctx;
+
+    ASSERT_FALSE(aws_strutil_ascii_has_uppercase(aws_byte_cursor_from_c_str("")));
+    ASSERT_FALSE(aws_strutil_ascii_has_uppercase(aws_byte_cursor_from_c_str("content-length")));
+    ASSERT_TRUE(aws_strutil_ascii_has_uppercase(aws_byte_cursor_from_c_str("Content-Length")));
+
+    /* non-ASCII bytes are not uppercase ('A' + 0x80 must not sneak past the vector compare) */
+    uint8_t high_bit[2] = {0xC1, 0xE9};
+    ASSERT_FALSE(aws_strutil_ascii_has_uppercase(aws_byte_cursor_from_array(high_bit, sizeof(high_bit))));
+
+    /* fold every length from tail-only up through the 32-byte stride; characters bracketing
+     * A-Z ('@' and '[') and high-bit bytes must pass through unchanged */
+    for (size_t len = 1; len <= 40; ++len) {
+        uint8_t input[40];
+        uint8_t expected[40];
+        for (size_t i = 0; i < len; ++i) {
+            static const uint8_t pattern[] = {'A', 'Z', 'a', 'z', '@', '[', '-', 0xC1};
+            input[i] = pattern[i % AWS_ARRAY_SIZE(pattern)];
+            expected[i] = (input[i] >= 'A' && input[i] <= 'Z') ? (uint8_t)(input[i] + ('a' - 'A')) : input[i];
+        }
+
+        uint8_t output[40];
+        aws_strutil_ascii_tolower(output, input, len);
+        ASSERT_BIN_ARRAYS_EQUALS(expected, len, output, len);
+
+        ASSERT_TRUE(aws_strutil_ascii_has_uppercase(aws_byte_cursor_from_array(input, len)));
+
+        /* folding in place works too */
+        aws_strutil_ascii_tolower(input, input, len);
+        ASSERT_BIN_ARRAYS_EQUALS(expected, len, input, len);
+        ASSERT_FALSE(aws_strutil_ascii_has_uppercase(aws_byte_cursor_from_array(input, len)));
+    }
+
     return 0;
 }
\ No newline at end of file
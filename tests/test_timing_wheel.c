@@ -0,0 +1,187 @@
+/*
+ * Copyright 2010-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <aws/http/private/timing_wheel.h>
+
+#include <aws/testing/aws_test_harness.h>
+
+#define TEST_CASE(NAME)                                                                                                \
+    AWS_TEST_CASE(NAME, s_test_##NAME);                                                                                \
+    static int s_test_##NAME(struct aws_allocator *allocator, void *ctx)
+
+enum {
+    TICK_NS = 100,
+    NUM_SLOTS = 8,
+};
+
+struct fired_recorder {
+    int count;
+    uint64_t last_deadline;
+};
+
+static void s_record_fired(struct aws_http_timing_wheel_timer *timer, void *user_data) {
+    struct fired_recorder *recorder = user_data;
+    recorder->count++;
+    recorder->last_deadline = timer->deadline_ns;
+}
+
+TEST_CASE(timing_wheel_fires_at_deadline) {
+    (void)ctx;
+
+    struct aws_http_timing_wheel wheel;
+    ASSERT_SUCCESS(aws_http_timing_wheel_init(&wheel, allocator, TICK_NS, NUM_SLOTS, 0 /*now*/));
+
+    struct fired_recorder recorder = {0};
+    struct aws_http_timing_wheel_timer timer = {0};
+
+    aws_http_timing_wheel_arm(&wheel, &timer, 350, s_record_fired, &recorder);
+    ASSERT_TRUE(timer.is_armed);
+    ASSERT_UINT_EQUALS(1, wheel.armed_count);
+
+    /* Not due yet */
+    aws_http_timing_wheel_run(&wheel, 300);
+    ASSERT_INT_EQUALS(0, recorder.count);
+    ASSERT_TRUE(timer.is_armed);
+
+    /* Due now */
+    aws_http_timing_wheel_run(&wheel, 400);
+    ASSERT_INT_EQUALS(1, recorder.count);
+    ASSERT_UINT_EQUALS(350, recorder.last_deadline);
+    ASSERT_FALSE(timer.is_armed);
+    ASSERT_UINT_EQUALS(0, wheel.armed_count);
+
+    /* Does not fire again */
+    aws_http_timing_wheel_run(&wheel, 10000);
+    ASSERT_INT_EQUALS(1, recorder.count);
+
+    aws_http_timing_wheel_clean_up(&wheel);
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(timing_wheel_cancel_prevents_firing) {
+    (void)ctx;
+
+    struct aws_http_timing_wheel wheel;
+    ASSERT_SUCCESS(aws_http_timing_wheel_init(&wheel, allocator, TICK_NS, NUM_SLOTS, 0 /*now*/));
+
+    struct fired_recorder recorder = {0};
+    struct aws_http_timing_wheel_timer timer = {0};
+
+    aws_http_timing_wheel_arm(&wheel, &timer, 200, s_record_fired, &recorder);
+    aws_http_timing_wheel_cancel(&wheel, &timer);
+    ASSERT_FALSE(timer.is_armed);
+    ASSERT_UINT_EQUALS(0, wheel.armed_count);
+
+    /* Canceling twice is harmless */
+    aws_http_timing_wheel_cancel(&wheel, &timer);
+
+    aws_http_timing_wheel_run(&wheel, 1000);
+    ASSERT_INT_EQUALS(0, recorder.count);
+
+    aws_http_timing_wheel_clean_up(&wheel);
+    return AWS_OP_SUCCESS;
+}
+
+/* A deadline more than a full rotation away hashes into a slot the wheel
+ * passes earlier; it must not fire until its own deadline comes around. */
+TEST_CASE(timing_wheel_deadline_beyond_one_rotation) {
+    (void)ctx;
+
+    struct aws_http_timing_wheel wheel;
+    ASSERT_SUCCESS(aws_http_timing_wheel_init(&wheel, allocator, TICK_NS, NUM_SLOTS, 0 /*now*/));
+
+    struct fired_recorder recorder = {0};
+    struct aws_http_timing_wheel_timer timer = {0};
+
+    /* Rotation is NUM_SLOTS * TICK_NS = 800ns; deadline two rotations out */
+    aws_http_timing_wheel_arm(&wheel, &timer, 1650, s_record_fired, &recorder);
+
+    /* Tick through the first rotation one tick at a time; slot 1650/100 % 8 gets scanned but must not fire */
+    for (uint64_t now = TICK_NS; now <= 1600; now += TICK_NS) {
+        aws_http_timing_wheel_run(&wheel, now);
+        ASSERT_INT_EQUALS(0, recorder.count);
+    }
+
+    aws_http_timing_wheel_run(&wheel, 1700);
+    ASSERT_INT_EQUALS(1, recorder.count);
+
+    aws_http_timing_wheel_clean_up(&wheel);
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(timing_wheel_multiple_timers) {
+    (void)ctx;
+
+    struct aws_http_timing_wheel wheel;
+    ASSERT_SUCCESS(aws_http_timing_wheel_init(&wheel, allocator, TICK_NS, NUM_SLOTS, 0 /*now*/));
+
+    struct fired_recorder recorder = {0};
+
+    enum { COUNT = 20 };
+    struct aws_http_timing_wheel_timer timers[COUNT];
+    AWS_ZERO_ARRAY(timers);
+
+    for (uint64_t i = 0; i < COUNT; ++i) {
+        aws_http_timing_wheel_arm(&wheel, &timers[i], 100 + i * 77, s_record_fired, &recorder);
+    }
+    ASSERT_UINT_EQUALS(COUNT, wheel.armed_count);
+
+    /* Cancel every third timer */
+    int canceled = 0;
+    for (size_t i = 0; i < COUNT; i += 3) {
+        aws_http_timing_wheel_cancel(&wheel, &timers[i]);
+        ++canceled;
+    }
+
+    /* Advance past every deadline, in several steps */
+    aws_http_timing_wheel_run(&wheel, 500);
+    aws_http_timing_wheel_run(&wheel, 1200);
+    aws_http_timing_wheel_run(&wheel, 3000);
+
+    ASSERT_INT_EQUALS(COUNT - canceled, recorder.count);
+    ASSERT_UINT_EQUALS(0, wheel.armed_count);
+
+    aws_http_timing_wheel_clean_up(&wheel);
+    return AWS_OP_SUCCESS;
+}
+
+/* Re-arming moves the deadline; arming with a deadline in the past fires on the next run */
+TEST_CASE(timing_wheel_rearm_and_past_deadline) {
+    (void)ctx;
+
+    struct aws_http_timing_wheel wheel;
+    ASSERT_SUCCESS(aws_http_timing_wheel_init(&wheel, allocator, TICK_NS, NUM_SLOTS, 0 /*now*/));
+
+    struct fired_recorder recorder = {0};
+    struct aws_http_timing_wheel_timer timer = {0};
+
+    aws_http_timing_wheel_arm(&wheel, &timer, 200, s_record_fired, &recorder);
+    aws_http_timing_wheel_arm(&wheel, &timer, 600, s_record_fired, &recorder);
+    ASSERT_UINT_EQUALS(1, wheel.armed_count);
+
+    aws_http_timing_wheel_run(&wheel, 300);
+    ASSERT_INT_EQUALS(0, recorder.count);
+
+    aws_http_timing_wheel_run(&wheel, 600);
+    ASSERT_INT_EQUALS(1, recorder.count);
+
+    /* Arm with a deadline that already passed; the next tick picks it up */
+    aws_http_timing_wheel_arm(&wheel, &timer, 100, s_record_fired, &recorder);
+    aws_http_timing_wheel_run(&wheel, 700);
+    ASSERT_INT_EQUALS(2, recorder.count);
+
+    aws_http_timing_wheel_clean_up(&wheel);
+    return AWS_OP_SUCCESS;
+}
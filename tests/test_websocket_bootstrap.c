@@ -90,6 +90,7 @@ static struct tester {
     struct aws_http_message *handshake_request;
     const struct aws_http_header *handshake_response_headers;
     size_t num_handshake_response_headers;
+    const struct aws_websocket_permessage_deflate_options *permessage_deflate;
 
     /* State */
     struct aws_logger logger;
@@ -110,6 +111,8 @@ static struct tester {
     void *http_stream_user_data;
 
     bool websocket_new_called_successfully;
+    bool websocket_new_permessage_deflate_negotiated;
+    struct aws_websocket_permessage_deflate_options websocket_new_permessage_deflate;
 
     bool http_stream_release_called;
 
@@ -330,6 +333,8 @@ static struct aws_websocket *s_mock_websocket_handler_new(const struct aws_webso
     }
 
     s_tester.websocket_new_called_successfully = true;
+    s_tester.websocket_new_permessage_deflate_negotiated = options->permessage_deflate_negotiated;
+    s_tester.websocket_new_permessage_deflate = options->permessage_deflate;
     return s_mock_websocket;
 }
 
@@ -397,6 +402,7 @@ static int s_drive_websocket_connect(int *out_error_code) {
         .socket_options = (void *)"socket options",
         .host = host,
         .handshake_request = s_tester.handshake_request,
+        .permessage_deflate = s_tester.permessage_deflate,
         .user_data = &s_tester,
         .on_connection_setup = s_on_websocket_setup,
         .on_connection_shutdown = s_on_websocket_shutdown,
@@ -623,6 +629,461 @@ TEST_CASE(websocket_boot_fail_because_oom) {
     return AWS_OP_SUCCESS;
 }
 
+/* Response headers for a server that accepts a permessage-deflate offer with some parameters. */
+static const struct aws_http_header s_handshake_response_headers_accepting_deflate[] = {
+    {
+        .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Upgrade"),
+        .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("websocket"),
+    },
+    {
+        .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Connection"),
+        .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Upgrade"),
+    },
+    {
+        .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Sec-WebSocket-Accept"),
+        .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("s3pPLMBiTxaQ9kYGzzhZRbK+xOo="),
+    },
+    {
+        .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Sec-WebSocket-Extensions"),
+        .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL(
+            "permessage-deflate; server_no_context_takeover; server_max_window_bits=10"),
+    },
+};
+
+/* Test that a server's permessage-deflate acceptance is validated and recorded. */
+TEST_CASE(websocket_boot_negotiate_permessage_deflate) {
+    (void)ctx;
+
+    struct aws_websocket_permessage_deflate_options deflate_options = {
+        .server_no_context_takeover = true,
+        .server_max_window_bits = 10,
+        .client_max_window_bits = 12,
+    };
+    s_tester.permessage_deflate = &deflate_options;
+    s_tester.handshake_response_headers = s_handshake_response_headers_accepting_deflate;
+    s_tester.num_handshake_response_headers = AWS_ARRAY_SIZE(s_handshake_response_headers_accepting_deflate);
+    ASSERT_SUCCESS(s_tester_init(allocator));
+
+    int websocket_connect_error_code;
+    ASSERT_SUCCESS(s_drive_websocket_connect(&websocket_connect_error_code));
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, websocket_connect_error_code);
+
+    /* Negotiated parameters should have been passed to the websocket handler */
+    ASSERT_TRUE(s_tester.websocket_new_permessage_deflate_negotiated);
+    ASSERT_TRUE(s_tester.websocket_new_permessage_deflate.server_no_context_takeover);
+    ASSERT_FALSE(s_tester.websocket_new_permessage_deflate.client_no_context_takeover);
+    ASSERT_UINT_EQUALS(10, s_tester.websocket_new_permessage_deflate.server_max_window_bits);
+
+    /* Server said nothing about client_max_window_bits, so the offered value stands */
+    ASSERT_UINT_EQUALS(12, s_tester.websocket_new_permessage_deflate.client_max_window_bits);
+
+    ASSERT_SUCCESS(s_tester_clean_up());
+    return AWS_OP_SUCCESS;
+}
+
+/* Response headers for a server that grants permessage-deflate without it being offered. */
+static const struct aws_http_header s_handshake_response_headers_unoffered_deflate[] = {
+    {
+        .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Upgrade"),
+        .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("websocket"),
+    },
+    {
+        .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Connection"),
+        .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Upgrade"),
+    },
+    {
+        .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Sec-WebSocket-Accept"),
+        .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("s3pPLMBiTxaQ9kYGzzhZRbK+xOo="),
+    },
+    {
+        .name = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("Sec-WebSocket-Extensions"),
+        .value = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("permessage-deflate"),
+    },
+};
+
+/* Test that the handshake fails if the server grants an extension we never offered. */
+TEST_CASE(websocket_boot_reject_unoffered_extension) {
+    (void)ctx;
+
+    s_tester.handshake_response_headers = s_handshake_response_headers_unoffered_deflate;
+    s_tester.num_handshake_response_headers = AWS_ARRAY_SIZE(s_handshake_response_headers_unoffered_deflate);
+    ASSERT_SUCCESS(s_tester_init(allocator));
+
+    int websocket_connect_error_code;
+    ASSERT_SUCCESS(s_drive_websocket_connect(&websocket_connect_error_code));
+    ASSERT_INT_EQUALS(AWS_ERROR_HTTP_WEBSOCKET_UPGRADE_FAILURE, websocket_connect_error_code);
+    ASSERT_FALSE(s_tester.websocket_new_called_successfully);
+
+    ASSERT_SUCCESS(s_tester_clean_up());
+    return AWS_OP_SUCCESS;
+}
+
+/* Test that out-of-range max_window_bits values are rejected up front. */
+TEST_CASE(websocket_boot_reject_invalid_window_bits) {
+    (void)ctx;
+
+    struct aws_websocket_permessage_deflate_options deflate_options = {
+        .server_max_window_bits = 7,
+    };
+    s_tester.permessage_deflate = &deflate_options;
+    ASSERT_SUCCESS(s_tester_init(allocator));
+
+    int websocket_connect_error_code;
+    ASSERT_SUCCESS(s_drive_websocket_connect(&websocket_connect_error_code));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, websocket_connect_error_code);
+
+    ASSERT_SUCCESS(s_tester_clean_up());
+    return AWS_OP_SUCCESS;
+}
+
+/* --- Bulk connect tests --------------------------------------------------------------------- */
+
+/* The mocks above only support one connection at a time, so bulk connects get their own set,
+ * tracking each connection of the batch in launch order. Fake objects are identified by the
+ * address of a per-connection identity byte. */
+
+#define BULK_MAX_CONNECTIONS 8
+
+struct bulk_mock_connection {
+    /* Addresses of these serve as the fake objects handed to the bootstrap */
+    char http_connection_identity;
+    char stream_identity;
+    char channel_identity;
+    char websocket_identity;
+
+    bool connect_called;
+    aws_http_on_client_connection_setup_fn *http_setup_callback;
+    aws_http_on_client_connection_shutdown_fn *http_shutdown_callback;
+    void *http_connect_user_data;
+
+    bool request_made;
+    struct aws_byte_buf sec_websocket_key;
+    aws_http_on_incoming_headers_fn *stream_on_response_headers;
+    aws_http_on_stream_complete_fn *stream_on_complete;
+    void *stream_user_data;
+
+    int response_status;
+    bool http_connection_close_called;
+    bool http_connection_released;
+    bool stream_released;
+};
+
+static struct bulk_tester {
+    struct aws_allocator *alloc;
+    struct aws_http_message *handshake_template;
+
+    /* 1-based ordinal of the aws_http_client_connect() call to fail synchronously, 0 for none */
+    size_t fail_connect_at;
+
+    size_t num_connections;
+    struct bulk_mock_connection connections[BULK_MAX_CONNECTIONS];
+
+    bool batch_callback_invoked;
+    size_t batch_num_results;
+    struct aws_websocket_bulk_connect_result batch_results[BULK_MAX_CONNECTIONS];
+
+    size_t num_shutdown_callbacks;
+} s_bulk_tester;
+
+static int s_bulk_mock_http_client_connect(const struct aws_http_client_connection_options *options) {
+    AWS_FATAL_ASSERT(options);
+    AWS_FATAL_ASSERT(s_bulk_tester.num_connections < BULK_MAX_CONNECTIONS);
+
+    struct bulk_mock_connection *conn = &s_bulk_tester.connections[s_bulk_tester.num_connections++];
+
+    if (s_bulk_tester.fail_connect_at == s_bulk_tester.num_connections) {
+        return aws_raise_error(BOOT_STEP_HTTP_CONNECT);
+    }
+
+    conn->connect_called = true;
+    conn->http_setup_callback = options->on_setup;
+    conn->http_shutdown_callback = options->on_shutdown;
+    conn->http_connect_user_data = options->user_data;
+    return AWS_OP_SUCCESS;
+}
+
+static struct bulk_mock_connection *s_bulk_conn_from_connection(struct aws_http_connection *connection) {
+    return AWS_CONTAINER_OF((char *)connection, struct bulk_mock_connection, http_connection_identity);
+}
+
+static struct bulk_mock_connection *s_bulk_conn_from_stream(const struct aws_http_stream *stream) {
+    return AWS_CONTAINER_OF((char *)stream, struct bulk_mock_connection, stream_identity);
+}
+
+static void s_bulk_mock_http_connection_release(struct aws_http_connection *connection) {
+    struct bulk_mock_connection *conn = s_bulk_conn_from_connection(connection);
+    AWS_FATAL_ASSERT(!conn->http_connection_released);
+    conn->http_connection_released = true;
+}
+
+static void s_bulk_mock_http_connection_close(struct aws_http_connection *connection) {
+    s_bulk_conn_from_connection(connection)->http_connection_close_called = true;
+}
+
+static struct aws_channel *s_bulk_mock_http_connection_get_channel(struct aws_http_connection *connection) {
+    return (struct aws_channel *)&s_bulk_conn_from_connection(connection)->channel_identity;
+}
+
+static struct aws_http_stream *s_bulk_mock_http_connection_make_request(
+    struct aws_http_connection *client_connection,
+    const struct aws_http_make_request_options *options) {
+
+    struct bulk_mock_connection *conn = s_bulk_conn_from_connection(client_connection);
+    AWS_FATAL_ASSERT(!conn->request_made);
+
+    /* Each connection must send the template's headers with a unique Sec-WebSocket-Key patched in */
+    AWS_FATAL_ASSERT(
+        aws_http_message_get_header_count(options->request) ==
+        aws_http_message_get_header_count(s_bulk_tester.handshake_template));
+
+    struct aws_byte_cursor key_name = aws_byte_cursor_from_c_str("Sec-WebSocket-Key");
+    struct aws_byte_cursor key;
+    AWS_FATAL_ASSERT(!aws_http_headers_get(aws_http_message_get_const_headers(options->request), key_name, &key));
+
+    struct aws_byte_cursor template_key;
+    AWS_FATAL_ASSERT(!aws_http_headers_get(
+        aws_http_message_get_const_headers(s_bulk_tester.handshake_template), key_name, &template_key));
+    AWS_FATAL_ASSERT(!aws_byte_cursor_eq(&key, &template_key));
+
+    for (size_t i = 0; i < s_bulk_tester.num_connections; ++i) {
+        struct bulk_mock_connection *other = &s_bulk_tester.connections[i];
+        if (other != conn && other->sec_websocket_key.len) {
+            struct aws_byte_cursor other_key = aws_byte_cursor_from_buf(&other->sec_websocket_key);
+            AWS_FATAL_ASSERT(!aws_byte_cursor_eq(&key, &other_key));
+        }
+    }
+    AWS_FATAL_ASSERT(!aws_byte_buf_init_copy_from_cursor(&conn->sec_websocket_key, s_bulk_tester.alloc, key));
+
+    conn->request_made = true;
+    conn->stream_on_response_headers = options->on_response_headers;
+    conn->stream_on_complete = options->on_complete;
+    conn->stream_user_data = options->user_data;
+    return (struct aws_http_stream *)&conn->stream_identity;
+}
+
+static void s_bulk_mock_http_stream_release(struct aws_http_stream *stream) {
+    struct bulk_mock_connection *conn = s_bulk_conn_from_stream(stream);
+    AWS_FATAL_ASSERT(!conn->stream_released);
+    conn->stream_released = true;
+}
+
+static struct aws_http_connection *s_bulk_mock_http_stream_get_connection(const struct aws_http_stream *stream) {
+    return (struct aws_http_connection *)&s_bulk_conn_from_stream(stream)->http_connection_identity;
+}
+
+static int s_bulk_mock_http_stream_get_incoming_response_status(const struct aws_http_stream *stream, int *out_status) {
+    *out_status = s_bulk_conn_from_stream(stream)->response_status;
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_websocket *s_bulk_mock_websocket_handler_new(const struct aws_websocket_handler_options *options) {
+    struct bulk_mock_connection *conn =
+        AWS_CONTAINER_OF((char *)options->channel, struct bulk_mock_connection, channel_identity);
+    return (struct aws_websocket *)&conn->websocket_identity;
+}
+
+static const struct aws_websocket_client_bootstrap_system_vtable s_bulk_mock_system_vtable = {
+    .aws_http_client_connect = s_bulk_mock_http_client_connect,
+    .aws_http_connection_release = s_bulk_mock_http_connection_release,
+    .aws_http_connection_close = s_bulk_mock_http_connection_close,
+    .aws_http_connection_get_channel = s_bulk_mock_http_connection_get_channel,
+    .aws_http_connection_make_request = s_bulk_mock_http_connection_make_request,
+    .aws_http_stream_release = s_bulk_mock_http_stream_release,
+    .aws_http_stream_get_connection = s_bulk_mock_http_stream_get_connection,
+    .aws_http_stream_get_incoming_response_status = s_bulk_mock_http_stream_get_incoming_response_status,
+    .aws_websocket_handler_new = s_bulk_mock_websocket_handler_new,
+};
+
+static void s_bulk_on_connection_setup(
+    const struct aws_websocket_bulk_connect_result *result_array,
+    size_t num_results,
+    void *user_data) {
+
+    AWS_FATAL_ASSERT(user_data == &s_bulk_tester);
+    AWS_FATAL_ASSERT(!s_bulk_tester.batch_callback_invoked); /* fires exactly once */
+    AWS_FATAL_ASSERT(num_results <= BULK_MAX_CONNECTIONS);
+
+    s_bulk_tester.batch_callback_invoked = true;
+    s_bulk_tester.batch_num_results = num_results;
+    memcpy(s_bulk_tester.batch_results, result_array, num_results * sizeof(struct aws_websocket_bulk_connect_result));
+}
+
+static void s_bulk_on_connection_shutdown(struct aws_websocket *websocket, int error_code, void *user_data) {
+    (void)websocket;
+    (void)error_code;
+    AWS_FATAL_ASSERT(user_data == &s_bulk_tester);
+    s_bulk_tester.num_shutdown_callbacks++;
+}
+
+static int s_bulk_tester_init(struct aws_allocator *alloc) {
+    ASSERT_SUCCESS(s_tester_init(alloc));
+    aws_websocket_client_bootstrap_set_system_vtable(&s_bulk_mock_system_vtable);
+
+    s_bulk_tester.alloc = alloc;
+
+    static struct aws_byte_cursor path = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("/");
+    static const struct aws_byte_cursor host = AWS_BYTE_CUR_INIT_FROM_STRING_LITERAL("server.example.com");
+    s_bulk_tester.handshake_template = aws_http_message_new_websocket_handshake_request(alloc, path, host);
+    ASSERT_NOT_NULL(s_bulk_tester.handshake_template);
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_bulk_tester_clean_up(void) {
+    aws_http_message_destroy(s_bulk_tester.handshake_template);
+    for (size_t i = 0; i < s_bulk_tester.num_connections; ++i) {
+        aws_byte_buf_clean_up(&s_bulk_tester.connections[i].sec_websocket_key);
+    }
+    AWS_ZERO_STRUCT(s_bulk_tester);
+    return s_tester_clean_up();
+}
+
+/* Drive one mock connection through its handshake. The response status determines whether
+ * setup succeeds; on failure, the bootstrap's close-then-shutdown dance is played out too. */
+static int s_bulk_drive_connection(size_t i, int response_status) {
+    struct bulk_mock_connection *conn = &s_bulk_tester.connections[i];
+    ASSERT_TRUE(conn->connect_called);
+
+    conn->response_status = response_status;
+    struct aws_http_connection *connection = (struct aws_http_connection *)&conn->http_connection_identity;
+    struct aws_http_stream *stream = (struct aws_http_stream *)&conn->stream_identity;
+
+    conn->http_setup_callback(connection, AWS_ERROR_SUCCESS, conn->http_connect_user_data);
+    ASSERT_TRUE(conn->request_made);
+
+    conn->stream_on_response_headers(
+        stream,
+        AWS_HTTP_HEADER_BLOCK_MAIN,
+        s_handshake_response_headers,
+        AWS_ARRAY_SIZE(s_handshake_response_headers),
+        conn->stream_user_data);
+
+    conn->stream_on_complete(stream, AWS_ERROR_SUCCESS, conn->stream_user_data);
+
+    if (conn->http_connection_close_called) {
+        /* Setup went wrong; finishing HTTP shutdown lets the bootstrap report the failure */
+        conn->http_shutdown_callback(connection, AWS_ERROR_SUCCESS, conn->http_connect_user_data);
+    }
+
+    ASSERT_TRUE(conn->stream_released);
+    return AWS_OP_SUCCESS;
+}
+
+/* Shut down one successfully-established mock connection, so its bootstrap wraps up */
+static int s_bulk_drive_connection_shutdown(size_t i) {
+    struct bulk_mock_connection *conn = &s_bulk_tester.connections[i];
+    struct aws_http_connection *connection = (struct aws_http_connection *)&conn->http_connection_identity;
+
+    conn->http_shutdown_callback(connection, AWS_ERROR_SUCCESS, conn->http_connect_user_data);
+    ASSERT_TRUE(conn->http_connection_released);
+    return AWS_OP_SUCCESS;
+}
+
+/* Test that a bulk connect respects its concurrency window, gives each connection a unique
+ * Sec-WebSocket-Key, and reports every result through one batched callback. */
+TEST_CASE(websocket_boot_bulk_golden_path) {
+    (void)ctx;
+    ASSERT_SUCCESS(s_bulk_tester_init(allocator));
+
+    struct aws_websocket_bulk_client_connection_options options = {
+        .allocator = allocator,
+        .bootstrap = (void *)"client channel bootstrap",
+        .socket_options = (void *)"socket options",
+        .host = aws_byte_cursor_from_c_str("server.example.com"),
+        .handshake_template = s_bulk_tester.handshake_template,
+        .target_count = 4,
+        .concurrency_window = 2,
+        .user_data = &s_bulk_tester,
+        .on_bulk_connection_setup = s_bulk_on_connection_setup,
+        .on_connection_shutdown = s_bulk_on_connection_shutdown,
+    };
+
+    ASSERT_SUCCESS(aws_websocket_client_connect_bulk(&options));
+
+    /* Only a windowful may be in flight */
+    ASSERT_UINT_EQUALS(2, s_bulk_tester.num_connections);
+
+    /* Each completion launches the next connection */
+    ASSERT_SUCCESS(s_bulk_drive_connection(0, 101));
+    ASSERT_UINT_EQUALS(3, s_bulk_tester.num_connections);
+    ASSERT_FALSE(s_bulk_tester.batch_callback_invoked);
+
+    ASSERT_SUCCESS(s_bulk_drive_connection(1, 101));
+    ASSERT_UINT_EQUALS(4, s_bulk_tester.num_connections);
+
+    ASSERT_SUCCESS(s_bulk_drive_connection(2, 101));
+    ASSERT_SUCCESS(s_bulk_drive_connection(3, 101));
+
+    /* All results arrive in one batch, in index order */
+    ASSERT_TRUE(s_bulk_tester.batch_callback_invoked);
+    ASSERT_UINT_EQUALS(4, s_bulk_tester.batch_num_results);
+    for (size_t i = 0; i < 4; ++i) {
+        const struct aws_websocket_bulk_connect_result *result = &s_bulk_tester.batch_results[i];
+        ASSERT_UINT_EQUALS(i, result->index);
+        ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, result->error_code);
+        ASSERT_INT_EQUALS(101, result->handshake_response_status);
+        ASSERT_PTR_EQUALS(&s_bulk_tester.connections[i].websocket_identity, result->websocket);
+    }
+
+    /* Shut the connections down; each fires the shared shutdown callback */
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_SUCCESS(s_bulk_drive_connection_shutdown(i));
+    }
+    ASSERT_UINT_EQUALS(4, s_bulk_tester.num_shutdown_callbacks);
+
+    ASSERT_SUCCESS(s_bulk_tester_clean_up());
+    return AWS_OP_SUCCESS;
+}
+
+/* Test that individual failures are reported in the batch without aborting it. */
+TEST_CASE(websocket_boot_bulk_tolerates_failures) {
+    (void)ctx;
+    ASSERT_SUCCESS(s_bulk_tester_init(allocator));
+
+    /* The very first aws_http_client_connect() call fails synchronously */
+    s_bulk_tester.fail_connect_at = 1;
+
+    struct aws_websocket_bulk_client_connection_options options = {
+        .allocator = allocator,
+        .bootstrap = (void *)"client channel bootstrap",
+        .socket_options = (void *)"socket options",
+        .host = aws_byte_cursor_from_c_str("server.example.com"),
+        .handshake_template = s_bulk_tester.handshake_template,
+        .target_count = 3,
+        .concurrency_window = 3,
+        .user_data = &s_bulk_tester,
+        .on_bulk_connection_setup = s_bulk_on_connection_setup,
+        .on_connection_shutdown = s_bulk_on_connection_shutdown,
+    };
+
+    ASSERT_SUCCESS(aws_websocket_client_connect_bulk(&options));
+    ASSERT_UINT_EQUALS(3, s_bulk_tester.num_connections);
+
+    /* Second connection succeeds, third is refused by the server */
+    ASSERT_SUCCESS(s_bulk_drive_connection(1, 101));
+    ASSERT_SUCCESS(s_bulk_drive_connection(2, 403));
+
+    ASSERT_TRUE(s_bulk_tester.batch_callback_invoked);
+    ASSERT_UINT_EQUALS(3, s_bulk_tester.batch_num_results);
+
+    ASSERT_INT_EQUALS(BOOT_STEP_HTTP_CONNECT, s_bulk_tester.batch_results[0].error_code);
+    ASSERT_NULL(s_bulk_tester.batch_results[0].websocket);
+
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, s_bulk_tester.batch_results[1].error_code);
+    ASSERT_NOT_NULL(s_bulk_tester.batch_results[1].websocket);
+
+    ASSERT_INT_EQUALS(AWS_ERROR_HTTP_WEBSOCKET_UPGRADE_FAILURE, s_bulk_tester.batch_results[2].error_code);
+    ASSERT_INT_EQUALS(403, s_bulk_tester.batch_results[2].handshake_response_status);
+    ASSERT_NULL(s_bulk_tester.batch_results[2].websocket);
+
+    /* Only the successful connection ever fires the shutdown callback */
+    ASSERT_SUCCESS(s_bulk_drive_connection_shutdown(1));
+    ASSERT_UINT_EQUALS(1, s_bulk_tester.num_shutdown_callbacks);
+
+    ASSERT_SUCCESS(s_bulk_tester_clean_up());
+    return AWS_OP_SUCCESS;
+}
+
 /* Check that AWS_WEBSOCKET_MAX_HANDSHAKE_KEY_LENGTH is sufficiently large */
 TEST_CASE(websocket_handshake_key_max_length) {
     (void)allocator;
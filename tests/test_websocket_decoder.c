@@ -326,6 +326,169 @@ DECODER_TEST_CASE(websocket_decoder_masking) {
     return AWS_OP_SUCCESS;
 }
 
+/* Test unmasking a payload long enough to exercise the word-at-a-time XOR path,
+ * delivered in odd-sized chunks so every masking-key alignment is hit. */
+DECODER_TEST_CASE(websocket_decoder_masking_long_payload) {
+    (void)ctx;
+    struct decoder_tester tester;
+    ASSERT_SUCCESS(s_decoder_tester_init(&tester, allocator));
+
+    const char *expected_payload = "The quick brown fox jumps over the lazy dog";
+    const size_t payload_length = strlen(expected_payload);
+    const uint8_t masking_key[4] = {0x37, 0xfa, 0x21, 0x3d};
+
+    uint8_t input[2 + 4 + 64];
+    input[0] = 0x82; /* fin | rsv1 | rsv2 | rsv3 | 4bit opcode */
+    input[1] = 0x80 | (uint8_t)payload_length; /* mask | 7bit payload len */
+    memcpy(input + 2, masking_key, 4);
+    for (size_t i = 0; i < payload_length; ++i) {
+        input[6 + i] = (uint8_t)expected_payload[i] ^ masking_key[i % 4];
+    }
+    const size_t input_length = 6 + payload_length;
+
+    struct aws_websocket_frame expected_frame = {
+        .fin = true,
+        .opcode = 2,
+        .masked = true,
+        .masking_key = {0x37, 0xfa, 0x21, 0x3d},
+        .payload_length = payload_length,
+    };
+
+    /* Decode the whole frame in one call */
+    bool frame_complete;
+    struct aws_byte_cursor input_cursor = aws_byte_cursor_from_array(input, input_length);
+    ASSERT_SUCCESS(aws_websocket_decoder_process(&tester.decoder, &input_cursor, &frame_complete));
+
+    ASSERT_TRUE(frame_complete);
+    ASSERT_SUCCESS(s_compare_frame(&expected_frame, &tester.frame));
+    ASSERT_TRUE(aws_byte_buf_eq_c_str(&tester.payload, expected_payload));
+
+    /* Decode again in chunks of every possible size, so the payload state resumes at every key alignment */
+    for (size_t chunk_size = 1; chunk_size < input_length; ++chunk_size) {
+        s_decoder_tester_reset(&tester);
+
+        /* Chunking modifies the input in place (unmasking), so rebuild the masked payload */
+        for (size_t i = 0; i < payload_length; ++i) {
+            input[6 + i] = (uint8_t)expected_payload[i] ^ masking_key[i % 4];
+        }
+
+        for (size_t progress = 0; progress < input_length; progress += chunk_size) {
+            size_t remaining = input_length - progress;
+            struct aws_byte_cursor chunk_cursor =
+                aws_byte_cursor_from_array(input + progress, remaining < chunk_size ? remaining : chunk_size);
+            ASSERT_SUCCESS(aws_websocket_decoder_process(&tester.decoder, &chunk_cursor, &frame_complete));
+            ASSERT_UINT_EQUALS(0, chunk_cursor.len);
+        }
+
+        ASSERT_TRUE(frame_complete);
+        ASSERT_SUCCESS(s_compare_frame(&expected_frame, &tester.frame));
+        ASSERT_TRUE(aws_byte_buf_eq_c_str(&tester.payload, expected_payload));
+    }
+
+    ASSERT_SUCCESS(s_decoder_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* Test UTF-8 validation of a fragmented TEXT message, with a codepoint split across frames,
+ * a control frame (whose payload is not text) interleaved, and input fed 1 byte at a time. */
+DECODER_TEST_CASE(websocket_decoder_utf8_text) {
+    (void)ctx;
+    struct decoder_tester tester;
+    ASSERT_SUCCESS(s_decoder_tester_init(&tester, allocator));
+    tester.decoder.validate_utf8 = true;
+
+    uint8_t input[] = {
+        /* TEXT frame, fin=0, payload ends in the middle of a 4-byte codepoint */
+        0x01,
+        0x08,
+        'H',
+        0xC3,
+        0xA9, /* U+00E9 */
+        'l',
+        'l',
+        'o',
+        0xF0,
+        0x9F, /* first half of U+1F600 */
+        /* PING frame, payload is not UTF-8 and must not be validated */
+        0x89,
+        0x02,
+        0xFF,
+        0x00,
+        /* CONTINUATION frame, fin=1, completes the codepoint */
+        0x80,
+        0x03,
+        0x98,
+        0x80, /* second half of U+1F600 */
+        '!',
+    };
+
+    bool frame_complete;
+    for (size_t i = 0; i < sizeof(input); ++i) {
+        struct aws_byte_cursor input_cursor = aws_byte_cursor_from_array(input + i, 1);
+        ASSERT_SUCCESS(aws_websocket_decoder_process(&tester.decoder, &input_cursor, &frame_complete));
+        ASSERT_UINT_EQUALS(0, input_cursor.len);
+    }
+    ASSERT_TRUE(frame_complete);
+
+    /* All payloads (including the PING's) should have been delivered untouched */
+    const uint8_t expected_payload[] = {'H', 0xC3, 0xA9, 'l', 'l', 'o', 0xF0, 0x9F, 0xFF, 0x00, 0x98, 0x80, '!'};
+    ASSERT_BIN_ARRAYS_EQUALS(expected_payload, sizeof(expected_payload), tester.payload.buffer, tester.payload.len);
+
+    ASSERT_SUCCESS(s_decoder_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* Test that invalid UTF-8 in a TEXT message fails the decoder */
+DECODER_TEST_CASE(websocket_decoder_utf8_text_invalid) {
+    (void)ctx;
+    struct decoder_tester tester;
+    ASSERT_SUCCESS(s_decoder_tester_init(&tester, allocator));
+
+    struct invalid_utf8_test {
+        const char *name;
+        uint8_t input[8];
+        size_t input_length;
+    };
+
+    struct invalid_utf8_test tests[] = {
+        {.name = "surrogate", .input = {0x81, 0x03, 0xED, 0xA0, 0x80}, .input_length = 5},
+        {.name = "overlong", .input = {0x81, 0x02, 0xC0, 0xAF}, .input_length = 4},
+        {.name = "message ends mid-codepoint", .input = {0x81, 0x01, 0xC3}, .input_length = 3},
+        {.name = "illegal byte", .input = {0x81, 0x01, 0xFF}, .input_length = 3},
+        {.name = "codepoint above U+10FFFF", .input = {0x81, 0x04, 0xF4, 0x90, 0x80, 0x80}, .input_length = 6},
+    };
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tests); ++i) {
+        s_decoder_tester_reset(&tester);
+        tester.decoder.validate_utf8 = true;
+
+        bool frame_complete;
+        struct aws_byte_cursor input_cursor = aws_byte_cursor_from_array(tests[i].input, tests[i].input_length);
+        ASSERT_FAILS(aws_websocket_decoder_process(&tester.decoder, &input_cursor, &frame_complete), tests[i].name);
+        ASSERT_INT_EQUALS(AWS_ERROR_HTTP_PROTOCOL_ERROR, aws_last_error());
+    }
+
+    ASSERT_SUCCESS(s_decoder_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* Test that UTF-8 validation can be left disabled for trusted peers */
+DECODER_TEST_CASE(websocket_decoder_utf8_validation_disabled) {
+    (void)ctx;
+    struct decoder_tester tester;
+    ASSERT_SUCCESS(s_decoder_tester_init(&tester, allocator));
+
+    uint8_t input[] = {0x81, 0x03, 0xED, 0xA0, 0x80};
+
+    bool frame_complete;
+    struct aws_byte_cursor input_cursor = aws_byte_cursor_from_array(input, sizeof(input));
+    ASSERT_SUCCESS(aws_websocket_decoder_process(&tester.decoder, &input_cursor, &frame_complete));
+    ASSERT_TRUE(frame_complete);
+
+    ASSERT_SUCCESS(s_decoder_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
 /* Test a data frame which uses the 2 byte extended-length encoding */
 DECODER_TEST_CASE(websocket_decoder_extended_length_2byte) {
     (void)ctx;
@@ -14,6 +14,7 @@
  */
 
 #include <aws/http/private/websocket_encoder.h>
+#include <aws/http/private/websocket_mask.h>
 
 #include <aws/io/logging.h>
 #include <aws/testing/aws_test_harness.h>
@@ -264,6 +265,51 @@ ENCODER_TEST_CASE(websocket_encoder_masking) {
     return AWS_OP_SUCCESS;
 }
 
+ENCODER_TEST_CASE(websocket_encoder_masking_key_phase) {
+    (void)ctx;
+    (void)allocator;
+
+    /* Check the vectorized masking kernel against a reference byte-at-a-time implementation,
+     * across lengths that exercise the head/bulk/tail split and every key phase. */
+    const uint8_t masking_key[4] = {0x37, 0xfa, 0x21, 0x3d};
+
+    uint8_t expected[131];
+    uint8_t actual[131];
+
+    for (size_t len = 0; len <= sizeof(actual); ++len) {
+        for (uint64_t phase = 0; phase < 4; ++phase) {
+            for (size_t i = 0; i < len; ++i) {
+                uint8_t byte = (uint8_t)(i * 7 + 1);
+                actual[i] = byte;
+                expected[i] = byte ^ masking_key[(phase + i) % 4];
+            }
+
+            aws_websocket_mask_apply(actual, len, masking_key, phase);
+            ASSERT_BIN_ARRAYS_EQUALS(expected, len, actual, len);
+        }
+    }
+
+    /* Check that masking in arbitrary-sized pieces matches masking all at once */
+    uint8_t whole[100];
+    uint8_t pieces[100];
+    for (size_t i = 0; i < sizeof(whole); ++i) {
+        whole[i] = pieces[i] = (uint8_t)(i * 13 + 5);
+    }
+
+    aws_websocket_mask_apply(whole, sizeof(whole), masking_key, 0 /*phase*/);
+
+    size_t piece_sizes[] = {1, 2, 3, 17, 32, 45};
+    uint64_t progress = 0;
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(piece_sizes); ++i) {
+        aws_websocket_mask_apply(pieces + progress, piece_sizes[i], masking_key, progress);
+        progress += piece_sizes[i];
+    }
+    ASSERT_UINT_EQUALS(sizeof(pieces), progress);
+    ASSERT_BIN_ARRAYS_EQUALS(whole, sizeof(whole), pieces, sizeof(pieces));
+
+    return AWS_OP_SUCCESS;
+}
+
 ENCODER_TEST_CASE(websocket_encoder_extended_length) {
     (void)ctx;
     struct encoder_tester tester;
@@ -93,6 +93,9 @@ struct send_tester {
     size_t bytes_per_tick; /* Don't send more than N bytes per tick */
     size_t send_wrong_payload_amount;
 
+    /* If set, send this frame from within the first payload callback */
+    struct send_tester *send_on_first_payload;
+
     /* Everything below this line is auto-configured */
     struct tester *owner;
 
@@ -532,6 +535,8 @@ static int s_install_downstream_handler(struct tester *tester, size_t initial_wi
     return AWS_OP_SUCCESS;
 }
 
+static int s_send_frame(struct tester *tester, struct send_tester *send_tester);
+
 static bool s_on_stream_outgoing_payload(
     struct aws_websocket *websocket,
     struct aws_byte_buf *out_buf,
@@ -540,6 +545,12 @@ static bool s_on_stream_outgoing_payload(
     struct send_tester *send_tester = user_data;
     AWS_FATAL_ASSERT(websocket == send_tester->owner->websocket);
 
+    if (send_tester->send_on_first_payload) {
+        struct send_tester *chained = send_tester->send_on_first_payload;
+        send_tester->send_on_first_payload = NULL;
+        AWS_FATAL_ASSERT(s_send_frame(send_tester->owner, chained) == AWS_OP_SUCCESS);
+    }
+
     /* If user wants frame to break websocket, write an extra byte */
     if (send_tester->send_wrong_payload_amount && (send_tester->on_payload_count == 0)) {
         aws_byte_buf_write_u8(out_buf, 'X');
@@ -750,6 +761,85 @@ TEST_CASE(websocket_handler_send_multiple_frames) {
     return AWS_OP_SUCCESS;
 }
 
+/* A burst of frames pushed from off the channel thread goes through the lock-free send
+ * queue; the drain must restore submission order. */
+TEST_CASE(websocket_handler_send_multiple_frames_off_thread) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    struct send_tester sending[] = {
+        {
+            .payload = aws_byte_cursor_from_c_str("One for the master,"),
+            .def = {.opcode = AWS_WEBSOCKET_OPCODE_TEXT, .fin = true},
+        },
+        {
+            .payload = aws_byte_cursor_from_c_str("one for the dame,"),
+            .def = {.opcode = AWS_WEBSOCKET_OPCODE_TEXT, .fin = true},
+        },
+        {
+            .payload = aws_byte_cursor_from_c_str("one for the little boy who lives down the lane."),
+            .def = {.opcode = AWS_WEBSOCKET_OPCODE_TEXT, .fin = true},
+        },
+    };
+
+    testing_channel_set_is_on_users_thread(&tester.testing_channel, false);
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(sending); ++i) {
+        ASSERT_SUCCESS(s_send_frame(&tester, &sending[i]));
+    }
+
+    testing_channel_set_is_on_users_thread(&tester.testing_channel, true);
+    ASSERT_SUCCESS(s_drain_written_messages(&tester));
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(sending); ++i) {
+        ASSERT_SUCCESS(s_check_written_message(&sending[i], i));
+    }
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
+/* A frame enqueued while the outgoing task is already encoding (here: from within another
+ * frame's payload callback) should ride along in the same aws_io_message instead of paying
+ * its own task wake-up and socket write. */
+TEST_CASE(websocket_handler_send_frames_batch_into_one_io_msg) {
+    (void)ctx;
+    struct tester tester;
+    ASSERT_SUCCESS(s_tester_init(&tester, allocator));
+
+    struct send_tester send_chained = {
+        .payload = aws_byte_cursor_from_c_str("Humpty Dumpty sat on a wall."),
+        .def =
+            {
+                .opcode = AWS_WEBSOCKET_OPCODE_TEXT,
+                .fin = true,
+            },
+    };
+
+    struct send_tester send = {
+        .payload = aws_byte_cursor_from_c_str("Humpty Dumpty had a great fall."),
+        .def =
+            {
+                .opcode = AWS_WEBSOCKET_OPCODE_TEXT,
+                .fin = true,
+            },
+        .send_on_first_payload = &send_chained,
+    };
+
+    ASSERT_SUCCESS(s_send_frame(&tester, &send));
+    ASSERT_SUCCESS(s_drain_written_messages(&tester));
+
+    ASSERT_UINT_EQUALS(2, tester.num_written_frames);
+    ASSERT_SUCCESS(s_check_written_message(&send, 0));
+    ASSERT_SUCCESS(s_check_written_message(&send_chained, 1));
+
+    /* Both frames fit easily, so they must have traveled in a single message */
+    ASSERT_UINT_EQUALS(1, tester.num_written_io_messages);
+
+    ASSERT_SUCCESS(s_tester_clean_up(&tester));
+    return AWS_OP_SUCCESS;
+}
+
 TEST_CASE(websocket_handler_send_huge_frame) {
     (void)ctx;
     struct tester tester;